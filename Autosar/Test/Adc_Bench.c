@@ -0,0 +1,286 @@
+/*
+* File: Adc_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the ADC driver against the register model of HostSim.c. The
+* simulated inputs return the channel in bits 8..11 and a count of the conversions made in bits
+* 0..7, so a lost, repeated or reordered result breaks the sequence found in the buffers.
+*   - Software conversion: a baseline starts every conversion of PC2 and polls EOC, as the
+*     acquisition loop did, at the fastest sampling time.
+*   - ADC_GROUP_SENSORS: three channels converted into a circular buffer by ADC1 and its DMA, read
+*     with Adc_ReadGroup and Adc_GetStreamLastPointer from a 1 ms main loop. A stopped DMA stream
+*     then forces an overrun, which the driver has to recover from.
+*   - ADC_GROUP_CAPTURE: PC2 converted by the three ADCs in triple interleaved mode; every half of
+*     the circular buffer is checked in the notifications while the DMA fills the other one.
+*   - ADC_GROUP_SUPPLY: a linear buffer filled once, then read.
+*
+*   adc_bench
+*/
+
+#include "Adc.h"
+#include <stdio.h>
+
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_POLLED_SAMPLES    20000u      /* Conversions of the software baseline */
+#define BENCH_SENSORS_MS        20u         /* Run time of ADC_GROUP_SENSORS */
+#define BENCH_CAPTURE_MS        10u         /* Run time of ADC_GROUP_CAPTURE */
+/* ADC clock set by ADC_CLOCK_PRESCALER: PCLK2 (84 MHz) divided by 2, 4, 6 or 8 */
+#define BENCH_ADC_CLOCK_MHZ     (42.0 / (double)(((ADC_CLOCK_PRESCALER) >> 16) + 1u))
+/* Rate required from the interleaved capture: a sample every 6 ADC clocks, the delay being 5 */
+#define BENCH_MIN_CAPTURE_MSPS  (BENCH_ADC_CLOCK_MHZ / 6.0)
+
+static Adc_ValueGroupType Bench_SensorsBuffer[ADC_SENSORS_SAMPLES * 3u];
+static Adc_ValueGroupType Bench_SupplyBuffer[ADC_SUPPLY_SAMPLES];
+static uint32_t Bench_CaptureWords[ADC_CAPTURE_SAMPLES / 2u];   /* 4-byte aligned for the word DMA */
+#define Bench_CaptureBuffer ((Adc_ValueGroupType*)Bench_CaptureWords)
+
+static uint32_t Bench_Conversions;      /* Calls of the simulated input */
+
+/* Checked by the capture notifications */
+static uint32_t Bench_CaptureSamples;
+static uint32_t Bench_CaptureErrors;
+static uint32_t Bench_CaptureHalves;
+static int32_t Bench_CaptureLast = -1;
+
+static uint16_t Bench_Signal(uint32_t Channel, uint64_t Cycle)
+{
+    (void)Cycle;
+    return (uint16_t)((Channel << 8) | (Bench_Conversions++ & 0xFFu));
+}
+
+/* Core cycles used by the CPU since a snapshot: register accesses and interrupt entries */
+static uint64_t Bench_CpuCycles(uint64_t regs0, uint64_t irqs0)
+{
+    return (HostSim_RegAccesses - regs0) * HostSim_BusCycles + (HostSim_IrqCount - irqs0) * HostSim_IrqCycles;
+}
+
+/* Checks that the results of a half of the capture buffer continue the sequence */
+static void Bench_CheckCapture(const Adc_ValueGroupType* samples, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if ((samples[i] >> 8) != ADC_Channel_12 ||
+            (Bench_CaptureLast >= 0 && (samples[i] & 0xFFu) != ((uint32_t)(Bench_CaptureLast + 1) & 0xFFu))) {
+            Bench_CaptureErrors++;
+        }
+        Bench_CaptureLast = samples[i] & 0xFFu;
+    }
+    Bench_CaptureSamples += count;
+    Bench_CaptureHalves++;
+}
+
+void AdcCapture_HalfNotification(void)
+{
+    Bench_CheckCapture(Bench_CaptureBuffer, ADC_CAPTURE_SAMPLES / 2u);
+}
+
+void AdcCapture_FullNotification(void)
+{
+    Bench_CheckCapture(Bench_CaptureBuffer + ADC_CAPTURE_SAMPLES / 2u, ADC_CAPTURE_SAMPLES / 2u);
+}
+
+/* Software-started conversions of PC2 on ADC1, polled one by one */
+static double Bench_Polled(void)
+{
+    ADC_CommonInitTypeDef ADC_CommonInitStruct;
+    ADC_InitTypeDef ADC_InitStruct;
+    uint64_t cycles0;
+    uint32_t errors = 0;
+
+    HostSim_Reset();
+    ADC_CommonInitStruct.ADC_Mode = ADC_Mode_Independent;
+    ADC_CommonInitStruct.ADC_Prescaler = ADC_CLOCK_PRESCALER;
+    ADC_CommonInitStruct.ADC_DMAAccessMode = ADC_DMAAccessMode_Disabled;
+    ADC_CommonInitStruct.ADC_TwoSamplingDelay = ADC_TwoSamplingDelay_5Cycles;
+    ADC_CommonInit(&ADC_CommonInitStruct);
+    ADC_InitStruct.ADC_Resolution = ADC_Resolution_12b;
+    ADC_InitStruct.ADC_ScanConvMode = DISABLE;
+    ADC_InitStruct.ADC_ContinuousConvMode = DISABLE;
+    ADC_InitStruct.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_None;
+    ADC_InitStruct.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T1_CC1;
+    ADC_InitStruct.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStruct.ADC_NbrOfConversion = 1;
+    ADC_Init(ADC1, &ADC_InitStruct);
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_12, 1, ADC_SampleTime_3Cycles);
+    ADC_Cmd(ADC1, ENABLE);
+
+    Bench_Conversions = 0;
+    cycles0 = HostSim_Cycles;
+    for (uint32_t i = 0; i < BENCH_POLLED_SAMPLES; i++) {
+        ADC_SoftwareStartConv(ADC1);
+        while (ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC) == RESET) {
+        }
+        errors += ((ADC_GetConversionValue(ADC1) & 0xFFu) != (i & 0xFFu));
+    }
+    double msps = (double)BENCH_POLLED_SAMPLES * HOSTSIM_CORE_CLOCK_HZ / (double)(HostSim_Cycles - cycles0) / 1e6;
+    printf("software start + EOC poll:  %5.2f Msample/s  CPU 100%%%s\n", msps, errors ? "  FAILED" : "");
+    return errors ? 0.0 : msps;
+}
+
+/* Checks that the rounds before the last one continue the sequence backwards */
+static uint32_t Bench_CheckSensors(const Adc_ValueGroupType* last, uint32_t valid)
+{
+    static const Adc_ChannelType channels[3] = { ADC_Channel_10, ADC_Channel_11, ADC_Channel_1 };
+    uint32_t round = (uint32_t)(last - Bench_SensorsBuffer) / 3u;
+    uint32_t next = 0;
+    uint32_t errors = 0;
+
+    for (uint32_t n = 0; n < valid; n++) {
+        const Adc_ValueGroupType* values = &Bench_SensorsBuffer[round * 3u];
+        for (int32_t i = 2; i >= 0; i--) {
+            errors += ((values[i] >> 8) != channels[i]);
+            errors += (n != 0 || i != 2) && ((values[i] & 0xFFu) != ((next - 1u) & 0xFFu));
+            next = values[i] & 0xFFu;
+        }
+        round = (round == 0) ? ADC_SENSORS_SAMPLES - 1u : round - 1u;
+    }
+    return errors;
+}
+
+/* ADC_GROUP_SENSORS read from a 1 ms main loop, then an overrun */
+static uint32_t Bench_Sensors(void)
+{
+    Adc_ValueGroupType values[3];
+    Adc_ValueGroupType* last = NULL;
+    Adc_GroupStatsType stats;
+    uint64_t cycles0, regs0, irqs0, conv0;
+    uint32_t errors = 0, reads = 0, valid = 0;
+
+    HostSim_Reset();
+    Adc_Init(NULL);
+    errors += (Adc_SetupResultBuffer(ADC_GROUP_SENSORS, Bench_SensorsBuffer) != E_OK);
+    errors += (Adc_GetGroupStatus(ADC_GROUP_SENSORS) != ADC_IDLE);
+    errors += (Adc_ReadGroup(ADC_GROUP_SENSORS, values) != E_NOT_OK);
+
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    irqs0 = HostSim_IrqCount;
+    conv0 = HostSim_AdcStats[0].conversions;
+    errors += (Adc_StartGroupConversion(ADC_GROUP_SENSORS) != E_OK);
+    /* Interleaved capture needs ADC1 too */
+    errors += (Adc_StartGroupConversion(ADC_GROUP_CAPTURE) != E_NOT_OK);
+    for (uint32_t ms = 0; ms < BENCH_SENSORS_MS; ms++) {
+        HostSim_Idle(BENCH_MS);
+        errors += (Adc_GetGroupStatus(ADC_GROUP_SENSORS) != ADC_STREAM_COMPLETED);
+        if (Adc_ReadGroup(ADC_GROUP_SENSORS, values) == E_OK) {
+            reads++;
+            errors += ((values[0] >> 8) != ADC_Channel_10 || (values[1] >> 8) != ADC_Channel_11 ||
+                       (values[2] >> 8) != ADC_Channel_1);
+            errors += (((values[0] + 1u) & 0xFFu) != (values[1] & 0xFFu));
+        }
+        errors += (Adc_GetGroupStatus(ADC_GROUP_SENSORS) == ADC_STREAM_COMPLETED);
+    }
+    HostSim_Idle(BENCH_MS / 10u);
+    errors += (Adc_GetGroupStatus(ADC_GROUP_SENSORS) == ADC_BUSY);
+    valid = Adc_GetStreamLastPointer(ADC_GROUP_SENSORS, &last);
+    errors += (valid != ADC_SENSORS_SAMPLES - 1u || last == NULL || Bench_CheckSensors(last, valid) != 0);
+
+    double elapsed = (double)(HostSim_Cycles - cycles0);
+    double msps = (double)(HostSim_AdcStats[0].conversions - conv0) * HOSTSIM_CORE_CLOCK_HZ / elapsed / 1e6;
+    Adc_GetGroupStats(ADC_GROUP_SENSORS, &stats);
+    errors += (reads != BENCH_SENSORS_MS || stats.overruns != 0 || HostSim_AdcStats[0].overruns != 0);
+    printf("sensors, 3 ch, 56 cycles:   %5.2f Msample/s  CPU %5.2f%%  %u buffers, %u interrupts%s\n",
+           msps, 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / elapsed, (unsigned)stats.fullTransfers,
+           (unsigned)(HostSim_IrqCount - irqs0), errors ? "  FAILED" : "");
+
+    /* A stream stopped behind the driver's back: the next result is lost, the group restarts */
+    DMA_Cmd(DMA2_Stream4, DISABLE);
+    HostSim_Idle(BENCH_MS);
+    Adc_GetGroupStats(ADC_GROUP_SENSORS, &stats);
+    errors += (stats.overruns != 1 || Adc_GetGroupStatus(ADC_GROUP_SENSORS) == ADC_IDLE);
+    valid = Adc_GetStreamLastPointer(ADC_GROUP_SENSORS, &last);
+    errors += (valid == 0 || Bench_CheckSensors(last, valid) != 0);
+    errors += (Adc_StopGroupConversion(ADC_GROUP_SENSORS) != E_OK || Adc_GetGroupStatus(ADC_GROUP_SENSORS) != ADC_IDLE);
+    errors += (Adc_StopGroupConversion(ADC_GROUP_SENSORS) != E_NOT_OK);
+    printf("overrun recovery:           %s\n", errors ? "FAILED" : "restarted, sequence intact");
+    return errors;
+}
+
+/* ADC_GROUP_CAPTURE in triple interleaved mode */
+static uint32_t Bench_Capture(double polled)
+{
+    Adc_GroupStatsType stats;
+    uint64_t cycles0, regs0, irqs0, conv0 = 0, conv1 = 0;
+    uint32_t errors = 0;
+
+    HostSim_Reset();
+    Adc_Init(NULL);
+    Bench_CaptureSamples = 0;
+    Bench_CaptureErrors = 0;
+    Bench_CaptureHalves = 0;
+    Bench_CaptureLast = -1;
+    errors += (Adc_SetupResultBuffer(ADC_GROUP_CAPTURE, Bench_CaptureBuffer) != E_OK);
+    errors += (Adc_SetupResultBuffer(ADC_GROUP_SUPPLY, Bench_SupplyBuffer) != E_OK);
+    Adc_EnableGroupNotification(ADC_GROUP_CAPTURE);
+
+    for (uint32_t i = 0; i < HOSTSIM_NUM_ADC; i++) {
+        conv0 += HostSim_AdcStats[i].conversions;
+    }
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    irqs0 = HostSim_IrqCount;
+    errors += (Adc_StartGroupConversion(ADC_GROUP_CAPTURE) != E_OK);
+    errors += (Adc_StartGroupConversion(ADC_GROUP_SUPPLY) != E_NOT_OK);
+    HostSim_Idle(BENCH_CAPTURE_MS * BENCH_MS);
+    double elapsed = (double)(HostSim_Cycles - cycles0);
+    errors += (Adc_StopGroupConversion(ADC_GROUP_CAPTURE) != E_OK);
+
+    for (uint32_t i = 0; i < HOSTSIM_NUM_ADC; i++) {
+        conv1 += HostSim_AdcStats[i].conversions;
+        errors += (HostSim_AdcStats[i].overruns != 0);
+        /* The three ADCs take equal turns */
+        errors += (HostSim_AdcStats[i].conversions * HOSTSIM_NUM_ADC + HOSTSIM_NUM_ADC < conv1 - conv0);
+    }
+    double msps = (double)(conv1 - conv0) * HOSTSIM_CORE_CLOCK_HZ / elapsed / 1e6;
+    Adc_GetGroupStats(ADC_GROUP_CAPTURE, &stats);
+    errors += (Bench_CaptureErrors != 0 || stats.overruns != 0 || Bench_CaptureHalves < 2u);
+    errors += (stats.halfTransfers + stats.fullTransfers != Bench_CaptureHalves);
+    errors += (msps < BENCH_MIN_CAPTURE_MSPS);
+    printf("capture, triple interleaved: %5.2f Msample/s  CPU %5.2f%%  %u samples checked, %.1f x software%s\n",
+           msps, 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / elapsed, (unsigned)Bench_CaptureSamples,
+           polled > 0.0 ? msps / polled : 0.0, errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* ADC_GROUP_SUPPLY: linear buffer, stops by itself once full */
+static uint32_t Bench_Supply(void)
+{
+    Adc_ValueGroupType value;
+    Adc_ValueGroupType* last = NULL;
+    uint32_t errors = 0;
+    uint32_t ms = 0;
+
+    HostSim_Reset();
+    Adc_Init(NULL);
+    errors += (Adc_SetupResultBuffer(ADC_GROUP_SUPPLY, Bench_SupplyBuffer) != E_OK);
+    Bench_Conversions = 0;
+    errors += (Adc_StartGroupConversion(ADC_GROUP_SUPPLY) != E_OK);
+    while (Adc_GetGroupStatus(ADC_GROUP_SUPPLY) != ADC_STREAM_COMPLETED && ms++ < 10u) {
+        HostSim_Idle(BENCH_MS / 10u);
+    }
+    HostSim_Idle(BENCH_MS);
+    errors += (HostSim_AdcStats[1].overruns != 0 || Adc_GetGroupStatus(ADC_GROUP_SUPPLY) != ADC_STREAM_COMPLETED);
+    errors += (Adc_GetStreamLastPointer(ADC_GROUP_SUPPLY, &last) != ADC_SUPPLY_SAMPLES ||
+               last != &Bench_SupplyBuffer[ADC_SUPPLY_SAMPLES - 1u]);
+    errors += (Adc_GetGroupStatus(ADC_GROUP_SUPPLY) != ADC_IDLE || Adc_ReadGroup(ADC_GROUP_SUPPLY, &value) != E_NOT_OK);
+    for (uint32_t i = 0; i < ADC_SUPPLY_SAMPLES; i++) {
+        errors += (Bench_SupplyBuffer[i] != ((ADC_Channel_13 << 8) | i));
+    }
+    /* The unit has been freed for the next block */
+    errors += (Adc_StartGroupConversion(ADC_GROUP_SUPPLY) != E_OK);
+    printf("supply, linear buffer:      %s\n", errors ? "FAILED" : "filled once, stopped, read");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+    double polled;
+
+    HostSim_AdcSignal = Bench_Signal;
+    polled = Bench_Polled();
+    failed += (polled == 0.0);
+    failed += Bench_Sensors();
+    failed += Bench_Capture(polled);
+    failed += Bench_Supply();
+    return failed ? 1 : 0;
+}
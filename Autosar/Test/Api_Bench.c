@@ -0,0 +1,294 @@
+/*
+* File: Api_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of every Dio and Spi API. Each API is called many times against the
+* register model of HostSim.c and reported with its calls per second and time per call on the
+* host, and with the peripheral register accesses and modelled bus cycles (register accesses,
+* interrupts and waits for the peripherals; CPU instructions are not modelled) it costs on the
+* STM32F407. Regressions of either show up without a board. Only the call
+* itself is measured: the set-up a call needs (a pending sequence to cancel, a driver to
+* deinitialize, ...) runs outside the measurement. Calls cheaper than the clock used to time them
+* are timed in batches of BENCH_BATCH, with their results stored to Bench_Sink and a compiler
+* barrier after each one, so none of them is merged, hoisted or dropped.
+*/
+
+#include "Dio.h"
+#include "Spi.h"
+#include "SchM.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_CALLS         100000u
+#define BENCH_BATCH         64u         /* Calls per timed section of BENCH_TIMED_BATCH */
+
+/* Pins driven by the Dio measurements */
+#define BENCH_PORT          DIO_PORT_D
+#define BENCH_CHANNEL       DIO_CHANNEL(DIO_PORT_D, 12)
+#define BENCH_GROUP_MASK    0xF000u
+
+static const Dio_ChannelGroupType Bench_Group = { BENCH_PORT, BENCH_GROUP_MASK };
+
+/* Totals of the timed sections of the current measurement */
+static uint64_t Bench_Cycles;
+static uint64_t Bench_Regs;
+static uint64_t Bench_HostNs;
+static uint64_t Bench_Calls;
+static uint64_t Bench_Sections;
+static uint64_t Bench_OverheadNs;       /* Cost of BENCH_CALLS empty timed sections */
+static volatile uint32_t Bench_Sink;
+
+static uint16_t Bench_EbTx[2][SPI_EXT_ADC_MAX_LENGTH];
+static uint16_t Bench_EbRx[2][SPI_EXT_ADC_MAX_LENGTH];
+static uint8_t Bench_GatewayTx[13];        /* One record of the PduR gateway */
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Keeps the compiler from moving memory accesses, and the calls making them, across this point */
+#define BENCH_BARRIER()     __asm__ __volatile__("" ::: "memory")
+
+/* Measures a timed section of count calls, adding its modelled and host cost to the totals */
+#define BENCH_SECTION(count, calls) \
+    do { \
+        uint64_t cycles0 = HostSim_Cycles; \
+        uint64_t regs0 = HostSim_RegAccesses; \
+        uint64_t ns0 = Bench_HostNow(); \
+        calls; \
+        Bench_HostNs += Bench_HostNow() - ns0; \
+        Bench_Cycles += HostSim_Cycles - cycles0; \
+        Bench_Regs += HostSim_RegAccesses - regs0; \
+        Bench_Calls += (count); \
+        Bench_Sections++; \
+    } while (0)
+
+/* Measures one call */
+#define BENCH_TIMED(call)   BENCH_SECTION(1u, call)
+
+/* Measures BENCH_BATCH calls of an API without side effects on the following calls */
+#define BENCH_TIMED_BATCH(call) \
+    BENCH_SECTION(BENCH_BATCH, for (uint32_t n = 0; n < BENCH_BATCH; n++) { call; BENCH_BARRIER(); })
+
+/* Runs the remaining jobs to completion outside the measurement, sleeping like Spi_SyncTransmit
+   while SPI2 (SPI_DMA_MODE in Spi_Cfg.c) moves its frames */
+static void Bench_Drain(void)
+{
+    SchM_StateType state;
+
+    while (Spi_GetStatus() == SPI_BUSY) {
+        Spi_MainFunction_Handling();
+        SchM_Enter(state);
+        if (Spi_GetStatus() == SPI_BUSY) {
+            SchM_WaitForInterrupt();
+        }
+        SchM_Exit(state);
+    }
+}
+
+/* Model and driver state every measurement starts from */
+static void Bench_Setup(void)
+{
+    HostSim_Reset();
+    HostSim_Gpio[BENCH_PORT].regs.MODER = 0x55555555u;     /* All pins of the port are outputs */
+    Spi_Init(NULL);
+    Spi_SetupEB(SPI_CHANNEL_EXT_ADC, (const Spi_DataBufferType*)Bench_EbTx[0], (Spi_DataBufferType*)Bench_EbRx[0], 8);
+    Spi_SetupEB(SPI_CHANNEL_GATEWAY, Bench_GatewayTx, NULL, sizeof(Bench_GatewayTx));
+}
+
+static void Bench_Run(const char* name, void (*step)(uint32_t))
+{
+    Bench_Setup();
+    Bench_Cycles = 0;
+    Bench_Regs = 0;
+    Bench_HostNs = 0;
+    Bench_Calls = 0;
+    Bench_Sections = 0;
+    for (uint32_t i = 0; i < BENCH_CALLS; i++) {
+        step(i);
+    }
+    Bench_Drain();
+
+    double overheadNs = (double)Bench_OverheadNs / BENCH_CALLS * (double)Bench_Sections;
+    double hostNs = ((double)Bench_HostNs - overheadNs) / (double)Bench_Calls;
+    if (hostNs < 0.1) {
+        hostNs = 0.1;   /* Below the resolution of the measurement */
+    }
+    printf("%-32s %12.0f calls/s %8.1f ns/call (host) %9.1f bus cycles/call %6.1f reg/call (modelled)\n",
+           name, 1e9 / hostNs, hostNs, (double)Bench_Cycles / (double)Bench_Calls, (double)Bench_Regs / (double)Bench_Calls);
+}
+
+/* Dio */
+
+static void Bench_DioReadChannel(uint32_t i)           { (void)i; BENCH_TIMED(Bench_Sink = Dio_ReadChannel(BENCH_CHANNEL)); }
+static void Bench_DioWriteChannel(uint32_t i)          { BENCH_TIMED(Dio_WriteChannel(BENCH_CHANNEL, (Dio_LevelType)(i & 1u))); }
+static void Bench_DioFlipChannel(uint32_t i)           { (void)i; BENCH_TIMED(Bench_Sink = Dio_FlipChannel(BENCH_CHANNEL)); }
+static void Bench_DioReadChannelGroup(uint32_t i)      { (void)i; BENCH_TIMED(Bench_Sink = Dio_ReadChannelGroup(&Bench_Group)); }
+static void Bench_DioWriteChannelGroup(uint32_t i)     { BENCH_TIMED(Dio_WriteChannelGroup(&Bench_Group, (Dio_PortLevelType)(i << 12))); }
+static void Bench_DioReadPort(uint32_t i)              { (void)i; BENCH_TIMED(Bench_Sink = Dio_ReadPort(BENCH_PORT)); }
+static void Bench_DioWritePort(uint32_t i)             { BENCH_TIMED(Dio_WritePort(BENCH_PORT, (Dio_PortLevelType)i)); }
+static void Bench_DioMaskedWritePort(uint32_t i)       { BENCH_TIMED(Dio_MaskedWritePort(BENCH_PORT, (Dio_PortLevelType)i, BENCH_GROUP_MASK)); }
+static void Bench_DioFlipChannels(uint32_t i)          { (void)i; BENCH_TIMED(Bench_Sink = Dio_FlipChannels(BENCH_PORT, BENCH_GROUP_MASK)); }
+static void Bench_DioWriteChannelInline(uint32_t i)    { BENCH_TIMED(Dio_WriteChannelInline(BENCH_CHANNEL, (Dio_LevelType)(i & 1u))); }
+static void Bench_DioReadChannelInline(uint32_t i)     { (void)i; BENCH_TIMED(Bench_Sink = Dio_ReadChannelInline(BENCH_CHANNEL)); }
+static void Bench_DioFlipChannelInline(uint32_t i)     { (void)i; BENCH_TIMED(Bench_Sink = Dio_FlipChannelInline(BENCH_CHANNEL)); }
+static void Bench_DioChannelHigh(uint32_t i)           { (void)i; BENCH_TIMED(DIO_CHANNEL_HIGH(BENCH_CHANNEL)); }
+
+static void Bench_DioGetVersionInfo(uint32_t i)
+{
+    Std_VersionInfoType info;
+    (void)i;
+    BENCH_TIMED_BATCH(Dio_GetVersionInfo(&info); Bench_Sink = info.vendorID + info.moduleID + info.sw_major_version +
+                                                             info.sw_minor_version + info.sw_patch_version);
+}
+
+/* Spi */
+
+static void Bench_SpiInit(uint32_t i)                  { (void)i; BENCH_TIMED(Spi_Init(NULL)); }
+static void Bench_SpiGetStatus(uint32_t i)             { (void)i; BENCH_TIMED_BATCH(Bench_Sink = Spi_GetStatus()); }
+static void Bench_SpiGetHWUnitStatus(uint32_t i)       { BENCH_TIMED_BATCH(Bench_Sink = Spi_GetHWUnitStatus((Spi_HWUnitType)((i + n) % NUM_OF_SPI_HW_UNITS))); }
+static void Bench_SpiGetJobResult(uint32_t i)          { BENCH_TIMED_BATCH(Bench_Sink = Spi_GetJobResult((Spi_JobType)((i + n) % SPI_MAX_JOB))); }
+static void Bench_SpiGetSequenceResult(uint32_t i)     { BENCH_TIMED_BATCH(Bench_Sink = Spi_GetSequenceResult((Spi_SequenceType)((i + n) % SPI_MAX_SEQUENCE))); }
+static void Bench_SpiMainFunctionIdle(uint32_t i)      { (void)i; BENCH_TIMED_BATCH(Spi_MainFunction_Handling()); }
+static void Bench_SpiResetHWUnitStats(uint32_t i)      { BENCH_TIMED(Spi_ResetHWUnitStats((Spi_HWUnitType)(i % NUM_OF_SPI_HW_UNITS))); }
+
+static void Bench_SpiDeInit(uint32_t i)
+{
+    (void)i;
+    BENCH_TIMED(Spi_DeInit());
+    Spi_Init(NULL);
+}
+
+static void Bench_SpiWriteIB(uint32_t i)
+{
+    Spi_DataBufferType data[2] = { (Spi_DataBufferType)i, 0x00 };
+    BENCH_TIMED(Spi_WriteIB(SPI_CHANNEL_EEPROM_STATUS, data));
+}
+
+static void Bench_SpiReadIB(uint32_t i)
+{
+    Spi_DataBufferType data[6];
+    (void)i;
+    BENCH_TIMED_BATCH(Bench_Sink = Spi_ReadIB(SPI_CHANNEL_ACCEL_DATA, data) + data[0]);
+}
+
+static void Bench_SpiSetupEB(uint32_t i)
+{
+    BENCH_TIMED(Spi_SetupEB(SPI_CHANNEL_EXT_ADC, (const Spi_DataBufferType*)Bench_EbTx[i & 1u],
+                            (Spi_DataBufferType*)Bench_EbRx[i & 1u], 8));
+}
+
+static void Bench_SpiSetupEBPingPong(uint32_t i)
+{
+    const Spi_DataBufferType* const src[2] = { (const Spi_DataBufferType*)Bench_EbTx[0], (const Spi_DataBufferType*)Bench_EbTx[1] };
+    Spi_DataBufferType* const dst[2] = { (Spi_DataBufferType*)Bench_EbRx[0], (Spi_DataBufferType*)Bench_EbRx[1] };
+    (void)i;
+    BENCH_TIMED(Spi_SetupEBPingPong(SPI_CHANNEL_EXT_ADC, src, dst, SPI_EXT_ADC_MAX_LENGTH));
+}
+
+static void Bench_SpiGetEBBuffers(uint32_t i)
+{
+    const Spi_DataBufferType* src;
+    Spi_DataBufferType* dst;
+    (void)i;
+    BENCH_TIMED_BATCH(Bench_Sink = Spi_GetEBBuffers(SPI_CHANNEL_EXT_ADC, &src, &dst) +
+                                   (uint32_t)(uintptr_t)src + (uint32_t)(uintptr_t)dst);
+}
+
+static void Bench_SpiAsyncTransmit(uint32_t i)
+{
+    BENCH_TIMED(Spi_AsyncTransmit((Spi_SequenceType)(i % SPI_MAX_SEQUENCE)));
+    Bench_Drain();
+}
+
+static void Bench_SpiMainFunctionBusy(uint32_t i)
+{
+    if (Spi_GetStatus() != SPI_BUSY) {
+        Spi_AsyncTransmit((Spi_SequenceType)(i % SPI_MAX_SEQUENCE));
+    }
+    BENCH_TIMED(Spi_MainFunction_Handling());
+}
+
+static void Bench_SpiSyncTransmit(uint32_t i)
+{
+    BENCH_TIMED(Spi_SyncTransmit((Spi_SequenceType)(i % SPI_MAX_SEQUENCE)));
+}
+
+static void Bench_SpiCancel(uint32_t i)
+{
+    /* The EEPROM job waits behind the accelerometer job on SPI1 */
+    (void)i;
+    Spi_AsyncTransmit(SPI_SEQ_IMU);
+    Spi_AsyncTransmit(SPI_SEQ_EEPROM);
+    BENCH_TIMED(Spi_Cancel(SPI_SEQ_EEPROM));
+    Bench_Drain();
+}
+
+static void Bench_SpiSetAsyncMode(uint32_t i)
+{
+    static const Spi_AsyncModeType mode[3] = { SPI_INTERRUPT_MODE, SPI_DMA_MODE, SPI_POLLING_MODE };
+    BENCH_TIMED(Spi_SetAsyncMode(SPI_HWUnit_0, mode[i % 3u]));
+}
+
+static void Bench_SpiGetHWUnitStats(uint32_t i)
+{
+    Spi_HWUnitStatsType stats;
+    BENCH_TIMED_BATCH(Bench_Sink = Spi_GetHWUnitStats((Spi_HWUnitType)((i + n) % NUM_OF_SPI_HW_UNITS), &stats) + stats.jobs);
+}
+
+static void Bench_Empty(uint32_t i)
+{
+    (void)i;
+    BENCH_TIMED((void)0);
+}
+
+int main(void)
+{
+    /* Host cost of the measurement itself, subtracted from every result */
+    Bench_Setup();
+    Bench_HostNs = 0;
+    for (uint32_t i = 0; i < BENCH_CALLS; i++) {
+        Bench_Empty(i);
+    }
+    Bench_OverheadNs = Bench_HostNs;
+
+    printf("Dio and Spi API cost, %u calls each, %u cycles per register access\n", BENCH_CALLS, HostSim_BusCycles);
+    Bench_Run("Dio_ReadChannel", Bench_DioReadChannel);
+    Bench_Run("Dio_WriteChannel", Bench_DioWriteChannel);
+    Bench_Run("Dio_FlipChannel", Bench_DioFlipChannel);
+    Bench_Run("Dio_ReadChannelGroup", Bench_DioReadChannelGroup);
+    Bench_Run("Dio_WriteChannelGroup", Bench_DioWriteChannelGroup);
+    Bench_Run("Dio_ReadPort", Bench_DioReadPort);
+    Bench_Run("Dio_WritePort", Bench_DioWritePort);
+    Bench_Run("Dio_MaskedWritePort", Bench_DioMaskedWritePort);
+    Bench_Run("Dio_FlipChannels", Bench_DioFlipChannels);
+    Bench_Run("Dio_GetVersionInfo", Bench_DioGetVersionInfo);
+    Bench_Run("Dio_ReadChannelInline", Bench_DioReadChannelInline);
+    Bench_Run("Dio_WriteChannelInline", Bench_DioWriteChannelInline);
+    Bench_Run("Dio_FlipChannelInline", Bench_DioFlipChannelInline);
+    Bench_Run("DIO_CHANNEL_HIGH", Bench_DioChannelHigh);
+
+    Bench_Run("Spi_Init", Bench_SpiInit);
+    Bench_Run("Spi_DeInit", Bench_SpiDeInit);
+    Bench_Run("Spi_WriteIB", Bench_SpiWriteIB);
+    Bench_Run("Spi_ReadIB", Bench_SpiReadIB);
+    Bench_Run("Spi_SetupEB", Bench_SpiSetupEB);
+    Bench_Run("Spi_SetupEBPingPong", Bench_SpiSetupEBPingPong);
+    Bench_Run("Spi_GetEBBuffers", Bench_SpiGetEBBuffers);
+    Bench_Run("Spi_AsyncTransmit", Bench_SpiAsyncTransmit);
+    Bench_Run("Spi_GetStatus", Bench_SpiGetStatus);
+    Bench_Run("Spi_GetHWUnitStatus", Bench_SpiGetHWUnitStatus);
+    Bench_Run("Spi_GetJobResult", Bench_SpiGetJobResult);
+    Bench_Run("Spi_GetSequenceResult", Bench_SpiGetSequenceResult);
+    Bench_Run("Spi_SyncTransmit", Bench_SpiSyncTransmit);
+    Bench_Run("Spi_Cancel", Bench_SpiCancel);
+    Bench_Run("Spi_SetAsyncMode", Bench_SpiSetAsyncMode);
+    Bench_Run("Spi_MainFunction_Handling idle", Bench_SpiMainFunctionIdle);
+    Bench_Run("Spi_MainFunction_Handling busy", Bench_SpiMainFunctionBusy);
+    Bench_Run("Spi_GetHWUnitStats", Bench_SpiGetHWUnitStats);
+    Bench_Run("Spi_ResetHWUnitStats", Bench_SpiResetHWUnitStats);
+    return 0;
+}
@@ -0,0 +1,437 @@
+/*
+* File: CanTp_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the CAN transport layer with a tester on CAN1 (1 Mbit/s) that
+* answers every frame of the ECU within 20 us, as a flashing tool does. Messages of 4095 bytes.
+*   - Transmission: a main-function transport layer, writing one consecutive frame per 1 ms main
+*     function, against CanTp with the flow control frames of the tester BS 0 / STmin 0, BS 8 /
+*     STmin 0, STmin 500 us and STmin 1 ms. The gap between consecutive frames is checked against
+*     STmin.
+*   - Reception: the block size of the ECU, 0 or CANTP_DIAG_BS, with the CAN main functions every
+*     GPT_COM_CYCLE_MS (1 ms), the rate of the ECU, and every 10 ms. The tester sends the
+*     consecutive frames of a block back to back.
+*
+*   cantp_bench
+*/
+
+#include "PduR.h"
+#include "CanTp.h"
+#include "Gpt.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_CAN1              0u          /* Index of CAN1 in the model */
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_US                (HOSTSIM_CORE_CLOCK_HZ / 1000000u)
+#define BENCH_ECU_PERIOD        (GPT_COM_CYCLE_MS * BENCH_MS)  /* CAN main functions on the ECU */
+#define BENCH_STEP              (20u * BENCH_US)    /* Reaction time of the tester */
+#define BENCH_TIMEOUT           (5000u * BENCH_MS)
+#define BENCH_LENGTH            4095u
+#define BENCH_CF_COUNT          ((BENCH_LENGTH - 6u + 6u) / 7u)    /* After a first frame of 6 bytes */
+#define BENCH_MAX_FRAMES        1024u
+#define BENCH_FRAME_BITS        111u        /* Standard frame with 8 data bytes, without stuff bits */
+#define BENCH_IMAGE             (512u * 1024u)  /* Flash image of the extrapolation */
+#define BENCH_TESTER_ID         0x7E0u
+#define BENCH_ECU_ID            0x7E8u
+#define BENCH_PADDING           0xCCu
+
+/* Transmission of the main-function transport layer or of CanTp */
+#define BENCH_POLLED            0u
+#define BENCH_CANTP             1u
+
+static HostSim_CanFrameType Bench_NodeFrames[BENCH_MAX_FRAMES];
+static HostSim_CanFrameType Bench_Capture[BENCH_MAX_FRAMES];
+static uint32_t Bench_FrameCycles;          /* One frame on CAN1 */
+
+static uint8_t Bench_Message[BENCH_LENGTH];
+static uint8_t Bench_Buffer[BENCH_LENGTH];  /* Message received by the ECU or the tester */
+
+/* Tester */
+static struct {
+    uint32_t seen;                          /* Frames of the ECU handled */
+    uint8_t bs;                             /* Flow control frames sent when receiving */
+    uint8_t stMin;
+    uint32_t received;                      /* Bytes of the message of the ECU */
+    uint32_t length;
+    uint8_t sn;
+    uint8_t blockLeft;
+    uint32_t errors;                        /* Frames of the ECU out of sequence or altered */
+    uint32_t flowControls;
+    uint64_t lastCfEnd;                     /* End of the last consecutive frame of the block, 0 if none */
+    uint64_t minGap;                        /* Shortest gap between consecutive frames of a block */
+    uint64_t end;                           /* End of the last frame of the message */
+    uint32_t sent;                          /* Bytes of the message to the ECU written to the bus */
+    uint8_t txSn;
+} Bench_Tester;
+
+/* Upper layer of CanTp */
+static int Bench_RxResult;                  /* -1 until the indication */
+static int Bench_TxResult;
+static uint64_t Bench_RxEnd;
+
+/* Main-function transport layer */
+static struct {
+    uint32_t offset;
+    uint8_t sn;
+    uint8_t waitFc;
+    uint8_t bs;
+    uint8_t blockLeft;
+} Bench_Polled;
+
+static void Bench_TesterWrite(const uint8_t* Frame)
+{
+    HostSim_CanFrameType* frame = &Bench_NodeFrames[HostSim_CanNode[BENCH_CAN1].count];
+
+    frame->at = HostSim_Cycles;
+    frame->id = BENCH_TESTER_ID;
+    frame->dlc = 8;
+    memcpy(frame->data, Frame, 8);
+    HostSim_CanNode[BENCH_CAN1].count++;
+}
+
+static void Bench_TesterFlowControl(uint8_t Status, uint8_t Bs, uint8_t StMin)
+{
+    uint8_t frame[8];
+
+    memset(frame, BENCH_PADDING, sizeof(frame));
+    frame[0] = 0x30u | Status;
+    frame[1] = Bs;
+    frame[2] = StMin;
+    Bench_TesterWrite(frame);
+    Bench_Tester.flowControls++;
+    Bench_Tester.lastCfEnd = 0;
+}
+
+/* Consecutive frames of the tester up to the end of the block or of the message */
+static void Bench_TesterBlock(uint8_t Bs)
+{
+    uint32_t count = 0;
+
+    while (Bench_Tester.sent < BENCH_LENGTH && (Bs == 0 || count < Bs)) {
+        uint8_t frame[8];
+        uint32_t n = BENCH_LENGTH - Bench_Tester.sent;
+        if (n > 7u) {
+            n = 7u;
+        }
+        memset(frame, BENCH_PADDING, sizeof(frame));
+        frame[0] = 0x20u | Bench_Tester.txSn;
+        memcpy(&frame[1], &Bench_Message[Bench_Tester.sent], n);
+        Bench_TesterWrite(frame);
+        Bench_Tester.sent += n;
+        Bench_Tester.txSn = (Bench_Tester.txSn + 1u) & 0x0Fu;
+        count++;
+    }
+}
+
+/* Tester: answers the frames of the ECU captured since the last call */
+static void Bench_TesterPoll(void)
+{
+    while (Bench_Tester.seen < HostSim_CanCapture[BENCH_CAN1].length) {
+        const HostSim_CanFrameType* frame = &Bench_Capture[Bench_Tester.seen++];
+        const uint8_t* data = frame->data;
+        uint32_t n;
+
+        if (frame->id != BENCH_ECU_ID || frame->dlc != 8u) {
+            Bench_Tester.errors++;
+            continue;
+        }
+        switch (data[0] & 0xF0u) {
+        case 0x10u:
+            Bench_Tester.length = ((uint32_t)(data[0] & 0x0Fu) << 8) | data[1];
+            memcpy(Bench_Buffer, &data[2], 6);
+            Bench_Tester.received = 6;
+            Bench_Tester.sn = 1;
+            Bench_Tester.blockLeft = Bench_Tester.bs;
+            Bench_TesterFlowControl(0, Bench_Tester.bs, Bench_Tester.stMin);
+            break;
+        case 0x20u:
+            if ((data[0] & 0x0Fu) != Bench_Tester.sn || Bench_Tester.received >= Bench_Tester.length) {
+                Bench_Tester.errors++;
+                break;
+            }
+            if (Bench_Tester.lastCfEnd != 0 &&
+                frame->at - Bench_FrameCycles - Bench_Tester.lastCfEnd < Bench_Tester.minGap) {
+                Bench_Tester.minGap = frame->at - Bench_FrameCycles - Bench_Tester.lastCfEnd;
+            }
+            Bench_Tester.lastCfEnd = frame->at;
+            n = Bench_Tester.length - Bench_Tester.received;
+            if (n > 7u) {
+                n = 7u;
+            }
+            memcpy(&Bench_Buffer[Bench_Tester.received], &data[1], n);
+            Bench_Tester.received += n;
+            Bench_Tester.sn = (Bench_Tester.sn + 1u) & 0x0Fu;
+            if (Bench_Tester.received == Bench_Tester.length) {
+                Bench_Tester.end = frame->at;
+            } else if (Bench_Tester.bs != 0 && --Bench_Tester.blockLeft == 0) {
+                Bench_Tester.blockLeft = Bench_Tester.bs;
+                Bench_TesterFlowControl(0, Bench_Tester.bs, Bench_Tester.stMin);
+            }
+            break;
+        case 0x30u:
+            if ((data[0] & 0x0Fu) == 0u) {
+                Bench_TesterBlock(data[1]);
+            }
+            break;
+        default:
+            Bench_Tester.errors++;
+            break;
+        }
+    }
+}
+
+/* Upper layer of CanTp */
+static uint8_t* Bench_StartOfReception(CanTp_ConnectionType Connection, PduLengthType Length)
+{
+    return (Connection == CANTP_DIAG_PHYSICAL && Length <= sizeof(Bench_Buffer)) ? Bench_Buffer : NULL;
+}
+
+static void Bench_RxIndication(CanTp_ConnectionType Connection, Std_ReturnType Result)
+{
+    (void)Connection;
+    Bench_RxResult = Result;
+    Bench_RxEnd = HostSim_Cycles;
+}
+
+static void Bench_TxConfirmation(CanTp_ConnectionType Connection, Std_ReturnType Result)
+{
+    (void)Connection;
+    Bench_TxResult = Result;
+}
+
+static const CanTp_ConfigType Bench_TpConfig = { Bench_StartOfReception, Bench_RxIndication, Bench_TxConfirmation };
+
+/* Main-function transport layer: the flow control frames of the tester, then one consecutive
+   frame per main function */
+static void Bench_PolledIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr)
+{
+    (void)Hrh;
+    (void)RxPdu;
+    if (CanId == BENCH_TESTER_ID && CanDlc >= 3u && CanSduPtr[0] == 0x30u && Bench_Polled.waitFc) {
+        Bench_Polled.waitFc = 0;
+        Bench_Polled.bs = CanSduPtr[1];
+        Bench_Polled.blockLeft = CanSduPtr[1];
+    }
+}
+
+static const Can_ConfigType Bench_PolledConfig = { Bench_PolledIndication, NULL, NULL };
+
+static Can_ReturnType Bench_PolledWrite(const uint8_t* Frame)
+{
+    Can_PduType pdu;
+
+    pdu.swPduHandle = 0;
+    pdu.length = 8;
+    pdu.id = BENCH_ECU_ID;
+    pdu.sdu = Frame;
+    return Can_Write(CAN_HTH_CAN1, &pdu);
+}
+
+static void Bench_PolledStart(void)
+{
+    uint8_t frame[8];
+
+    frame[0] = 0x10u | (uint8_t)(BENCH_LENGTH >> 8);
+    frame[1] = (uint8_t)BENCH_LENGTH;
+    memcpy(&frame[2], Bench_Message, 6);
+    (void)Bench_PolledWrite(frame);
+    Bench_Polled.offset = 6;
+    Bench_Polled.sn = 1;
+    Bench_Polled.waitFc = 1;
+}
+
+static void Bench_PolledMainFunction(void)
+{
+    uint8_t frame[8];
+    uint32_t n = BENCH_LENGTH - Bench_Polled.offset;
+
+    if (Bench_Polled.waitFc || n == 0) {
+        return;
+    }
+    if (n > 7u) {
+        n = 7u;
+    }
+    memset(frame, BENCH_PADDING, sizeof(frame));
+    frame[0] = 0x20u | Bench_Polled.sn;
+    memcpy(&frame[1], &Bench_Message[Bench_Polled.offset], n);
+    if (Bench_PolledWrite(frame) != CAN_OK) {
+        return;
+    }
+    Bench_Polled.offset += n;
+    Bench_Polled.sn = (Bench_Polled.sn + 1u) & 0x0Fu;
+    if (Bench_Polled.bs != 0 && --Bench_Polled.blockLeft == 0) {
+        Bench_Polled.waitFc = 1;
+    }
+}
+
+/* Restarts the model and the drivers; CanTp stops its timers before Gpt_Init forgets them */
+static void Bench_Start(const Can_ConfigType* CanConfig)
+{
+    const Can_ControllerConfigType* cfg = &Can_ControllerConfig[CAN_CONTROLLER_1];
+
+    CanTp_DeInit();
+    HostSim_Reset();
+    memset(&Bench_Tester, 0, sizeof(Bench_Tester));
+    Bench_Tester.minGap = UINT64_MAX;
+    Bench_Tester.txSn = 1;
+    Bench_RxResult = -1;
+    Bench_TxResult = -1;
+    memset(&Bench_Polled, 0, sizeof(Bench_Polled));
+    memset(Bench_Buffer, 0, sizeof(Bench_Buffer));
+    HostSim_CanNode[BENCH_CAN1].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN1].count = 0;
+    HostSim_CanCapture[BENCH_CAN1].buffer = Bench_Capture;
+    HostSim_CanCapture[BENCH_CAN1].size = BENCH_MAX_FRAMES;
+    /* A quantum lasts prescaler APB1 clocks of 4 core cycles; bs1 and bs2 hold the quanta less one */
+    Bench_FrameCycles = BENCH_FRAME_BITS * cfg->prescaler * (3u + cfg->bs1 + cfg->bs2) * 4u;
+
+    Gpt_Init(NULL);
+    Can_Init(CanConfig);
+    PduR_Init();
+    CanTp_Init(&Bench_TpConfig);
+    (void)Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START);
+}
+
+/* End of a transmission: the tester has the message and, with CanTp, the confirmation came */
+static int Bench_TxDone(void)
+{
+    return Bench_Tester.end != 0 && (Bench_TxResult != -1 || Bench_Polled.offset == BENCH_LENGTH);
+}
+
+static int Bench_RxDone(void)
+{
+    return Bench_RxResult != -1;
+}
+
+/* Runs the tester and the CAN main functions every Period until Done or the timeout */
+static void Bench_Loop(uint32_t Period, uint8_t Polled, int (*Done)(void))
+{
+    uint64_t start = HostSim_Cycles;
+    uint64_t nextMain = start + Period;
+
+    while (!Done() && HostSim_Cycles - start < BENCH_TIMEOUT) {
+        HostSim_Idle(BENCH_STEP);
+        Bench_TesterPoll();
+        if (HostSim_Cycles >= nextMain) {
+            nextMain += Period;
+            if (Polled) {
+                Bench_PolledMainFunction();
+            }
+            Can_MainFunction_Write();
+            Can_MainFunction_Read();
+        }
+    }
+}
+
+/* Transmission of a message to the tester; returns 0 if it arrives intact and STmin is kept */
+static uint32_t Bench_Transmit(uint8_t Mode, uint8_t Bs, uint8_t StMin, const char* name)
+{
+    uint64_t start;
+    uint64_t cycles;
+    uint64_t minStMin;
+    uint32_t errors = 0;
+    CanTp_StatsType stats;
+    double rate;
+
+    Bench_Start(Mode == BENCH_POLLED ? &Bench_PolledConfig : NULL);
+    Bench_Tester.bs = Bs;
+    Bench_Tester.stMin = StMin;
+    start = HostSim_Cycles;
+    if (Mode == BENCH_POLLED) {
+        Bench_PolledStart();
+    } else if (CanTp_Transmit(CANTP_DIAG_PHYSICAL, Bench_Message, BENCH_LENGTH) != E_OK) {
+        printf("%-22s CanTp_Transmit refused\n", name);
+        return 1;
+    }
+    Bench_Loop(BENCH_ECU_PERIOD, Mode == BENCH_POLLED, Bench_TxDone);
+    (void)CanTp_GetStats(&stats);
+
+    if (Bench_Tester.end == 0 || Bench_Tester.received != BENCH_LENGTH ||
+        memcmp(Bench_Buffer, Bench_Message, BENCH_LENGTH) != 0 || Bench_Tester.errors != 0 ||
+        (Mode == BENCH_CANTP && Bench_TxResult != E_OK)) {
+        printf("%-22s incomplete: %u of %u bytes, %u errors  FAILED\n", name, (unsigned)Bench_Tester.received,
+               (unsigned)BENCH_LENGTH, (unsigned)Bench_Tester.errors);
+        return 1;
+    }
+    /* STmin as the tester asked: 0x00..0x7F in ms, 0xF1..0xF9 in hundreds of us */
+    minStMin = (StMin <= 0x7Fu) ? (uint64_t)StMin * BENCH_MS : (uint64_t)(StMin - 0xF0u) * 100u * BENCH_US;
+    if (Bench_Tester.minGap < minStMin) {
+        errors++;
+    }
+    cycles = Bench_Tester.end - start;
+    rate = (double)BENCH_LENGTH * HOSTSIM_CORE_CLOCK_HZ / cycles / 1000.0;
+    printf("%-22s %7.1f ms, %5.1f kB/s, bus %5.1f %%, gap min %6.1f us (STmin %5.1f us), 512 kB in %5.1f s",
+           name, (double)cycles / BENCH_MS, rate, 100.0 * HostSim_CanStats[BENCH_CAN1].busyCycles / cycles,
+           (double)Bench_Tester.minGap / BENCH_US, (double)minStMin / BENCH_US, BENCH_IMAGE / rate / 1000.0);
+    if (Mode == BENCH_CANTP) {
+        printf(", CF by confirmation %u, by timer %u", (unsigned)stats.cfByConfirmation, (unsigned)stats.cfByTimer);
+    }
+    printf("%s\n", errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* Reception of a message from the tester; returns 0 unless a run expected to pass failed */
+static uint32_t Bench_Receive(uint8_t Bs, uint32_t Period, uint8_t MustPass, const char* name)
+{
+    uint64_t start;
+    uint8_t frame[8];
+    CanTp_StatsType stats;
+    Can_ControllerStatsType can;
+    uint32_t lost;
+    uint8_t intact;
+
+    Bench_Start(NULL);
+    if (CanTp_ChangeParameter(CANTP_DIAG_PHYSICAL, CANTP_PARAM_BS, Bs) != E_OK) {
+        printf("%-22s CanTp_ChangeParameter refused  FAILED\n", name);
+        return 1;
+    }
+    start = HostSim_Cycles;
+    frame[0] = 0x10u | (uint8_t)(BENCH_LENGTH >> 8);
+    frame[1] = (uint8_t)BENCH_LENGTH;
+    memcpy(&frame[2], Bench_Message, 6);
+    Bench_TesterWrite(frame);
+    Bench_Tester.sent = 6;
+    Bench_Loop(Period, 0, Bench_RxDone);
+    (void)CanTp_GetStats(&stats);
+    (void)Can_GetControllerStats(CAN_CONTROLLER_1, &can);
+    lost = (uint32_t)HostSim_CanStats[BENCH_CAN1].rxLost + can.rxQueueFull;
+
+    intact = (Bench_RxResult == E_OK && memcmp(Bench_Buffer, Bench_Message, BENCH_LENGTH) == 0);
+    if (intact) {
+        double ms = (double)(Bench_RxEnd - start) / BENCH_MS;
+        printf("%-22s %7.1f ms, %5.1f kB/s, %2u flow control frames, %3u frames lost",
+               name, ms, BENCH_LENGTH / ms, (unsigned)stats.flowControls, (unsigned)lost);
+    } else {
+        printf("%-22s aborted (%s) after %u of %u consecutive frames sent, %3u frames lost", name,
+               Bench_RxResult == -1 ? "no indication" : "sequence error",
+               (unsigned)(HostSim_CanNode[BENCH_CAN1].sent - 1u), (unsigned)BENCH_CF_COUNT,
+               (unsigned)lost);
+    }
+    printf("%s\n", (MustPass && !intact) ? "  FAILED" : "");
+    return (MustPass && !intact) ? 1u : 0u;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < BENCH_LENGTH; i++) {
+        Bench_Message[i] = (uint8_t)(i * 31u + 7u);
+    }
+
+    printf("transmission of %u bytes to a tester on CAN1 at 1 Mbit/s:\n", (unsigned)BENCH_LENGTH);
+    failed += Bench_Transmit(BENCH_POLLED, 0, 0, "main function 1 ms:");
+    failed += Bench_Transmit(BENCH_CANTP, 0, 0, "CanTp BS 0 STmin 0:");
+    failed += Bench_Transmit(BENCH_CANTP, 8, 0, "CanTp BS 8 STmin 0:");
+    failed += Bench_Transmit(BENCH_CANTP, 0, 0xF5u, "CanTp STmin 500 us:");
+    failed += Bench_Transmit(BENCH_CANTP, 0, 1, "CanTp STmin 1 ms:");
+
+    printf("reception of %u bytes from the tester, consecutive frames back to back:\n", (unsigned)BENCH_LENGTH);
+    failed += Bench_Receive(0, BENCH_ECU_PERIOD, 1, "BS 0, main 1 ms:");
+    failed += Bench_Receive(CANTP_DIAG_BS, BENCH_ECU_PERIOD, 1, "BS 24, main 1 ms:");
+    failed += Bench_Receive(0, 10u * BENCH_MS, 0, "BS 0, main 10 ms:");
+    failed += Bench_Receive(CANTP_DIAG_BS, 10u * BENCH_MS, 1, "BS 24, main 10 ms:");
+    CanTp_DeInit();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,568 @@
+/*
+* File: Can_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the CAN driver against the register model of HostSim.c.
+*   - Reception at full bus load, 1 Mbit/s: a baseline polls the RX FIFOs with CAN_MessagePending
+*     and CAN_Receive from a 1 ms main loop, as the gateways did; the driver drains them from its
+*     interrupts and indicates the frames from Can_MainFunction_Read every 1 and 5 ms.
+*   - Filtering at full bus load, 500 kbit/s: J1939 traffic of which a fifth is in CAN_RX_PDUS.
+*     The baseline programs the former banks, accepting every frame; the driver programs the banks
+*     generated by Can_FilterGen.c. Every listed frame has to be indicated, and only those.
+*   - Priority inversion: three low priority frames fill the mailboxes while another node keeps
+*     the bus busy with medium priority traffic, then an urgent frame is written. The baseline
+*     queues frames in write order and hands them to CAN_Transmit; the driver aborts a mailbox.
+*   - Stress: random writes of eight identifiers against random traffic of the other node; every
+*     frame has to be confirmed once and the frames of one identifier have to leave in order.
+*   - Bus-off: the controller is stopped, notified and restarted.
+*
+*   can_bench
+*/
+
+#include "Can.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CAN               0u          /* Index of CAN1 in the model */
+#define BENCH_FILTER_CAN        1u          /* Index of CAN2 in the model */
+#define BENCH_FILTER_FRAMES     10000u      /* Frames of the filtering test */
+#define BENCH_FILTER_WANTED     5u          /* One frame in this many is in CAN_RX_PDUS */
+#define BENCH_NUM_FIFOS         2u
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_RX_FRAMES         20000u      /* Frames sent back to back by the other node */
+#define BENCH_INVERSION_NODE    300u        /* Medium priority frames of the inversion test */
+#define BENCH_STRESS_WRITES     5000u       /* Frames written by the stress test */
+#define BENCH_STRESS_NODE       4000u       /* Frames of the other node during the stress test */
+#define BENCH_STRESS_IDS        8u
+
+static HostSim_CanFrameType Bench_NodeFrames[BENCH_RX_FRAMES];
+static HostSim_CanFrameType Bench_Capture[BENCH_STRESS_WRITES + 16u];
+
+/* Reception check: frames indicated, in increasing order per hardware object */
+static uint32_t Bench_RxCount;
+static uint32_t Bench_RxErrors;
+static int64_t Bench_RxLast[CAN_NUM_HRH];
+
+/* Filtering check: frames indicated, listed or not, and listed frames indicated by another
+   hardware object than their own while the generated banks are used */
+static uint8_t Bench_FilterOwnHrh;
+static uint32_t Bench_FilterWanted;
+static uint32_t Bench_FilterOther;
+static uint32_t Bench_FilterErrors;
+
+/* Transmission check: confirmations per handle */
+static uint8_t Bench_Confirmed[BENCH_STRESS_WRITES];
+static uint32_t Bench_ConfirmErrors;
+static uint8_t Bench_BusOffSeen;
+
+static const Can_IdType Bench_StressId[BENCH_STRESS_IDS] = {
+    0x010, 0x123, 0x124, 0x3FF, 0x700, 0x7FF, CAN_ID_EXTENDED | 0x00012345u, CAN_ID_EXTENDED | 0x1ABCDEF0u,
+};
+
+static uint32_t Bench_Random = 0x12345678u;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t Bench_Get32(const uint8_t* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void Bench_Put32(uint8_t* data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+#define BENCH_RX_PDU(name, hrh, id)     { (hrh), (id) },
+
+/* Received identifiers of the configuration */
+static const struct {
+    uint8_t hrh;
+    Can_IdType id;
+} Bench_RxPdus[CAN_NUM_RX_PDUS] = {
+    CAN_RX_PDUS(BENCH_RX_PDU)
+};
+
+static Can_IdType Bench_Can1Ids[BENCH_NUM_FIFOS][CAN_NUM_RX_PDUS];
+static uint32_t Bench_NumCan1Ids[BENCH_NUM_FIFOS];
+
+/* Hardware object of a listed identifier of CAN2, CAN_NUM_HRH if the identifier is not listed */
+static uint8_t Bench_Can2Hrh(Can_IdType Id)
+{
+    for (uint32_t i = 0; i < CAN_NUM_RX_PDUS; i++) {
+        if (Bench_RxPdus[i].id == Id && Bench_RxPdus[i].hrh >= CAN_HRH_CAN2_FIFO0) {
+            return Bench_RxPdus[i].hrh;
+        }
+    }
+    return CAN_NUM_HRH;
+}
+
+/* Identifier of frame Seq of the reception test: the FIFOs of CAN1 alternate, each frame takes
+   one of the identifiers listed for its FIFO */
+static uint32_t Bench_RxId(uint32_t Seq)
+{
+    uint32_t fifo = Seq & 1u;
+    return Bench_Can1Ids[fifo][(Seq / 2u * 37u) % Bench_NumCan1Ids[fifo]];
+}
+
+static void Bench_RxIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr)
+{
+    uint32_t seq = Bench_Get32(CanSduPtr);
+
+    (void)RxPdu;
+    if (Hrh >= CAN_NUM_HRH || CanDlc != 8u || CanId != Bench_RxId(seq) || (int64_t)seq <= Bench_RxLast[Hrh]) {
+        Bench_RxErrors++;
+        return;
+    }
+    Bench_RxLast[Hrh] = seq;
+    Bench_RxCount++;
+}
+
+static void Bench_TxConfirmation(PduIdType CanTxPduId)
+{
+    if (CanTxPduId >= BENCH_STRESS_WRITES || Bench_Confirmed[CanTxPduId]++ != 0) {
+        Bench_ConfirmErrors++;
+    }
+}
+
+static void Bench_BusOff(uint8_t Controller)
+{
+    Bench_BusOffSeen = (uint8_t)(Controller == CAN_CONTROLLER_1);
+}
+
+static const Can_ConfigType Bench_Config = { Bench_RxIndication, Bench_TxConfirmation, Bench_BusOff };
+
+static void Bench_FilterIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr)
+{
+    uint8_t hrh = Bench_Can2Hrh(CanId);
+
+    (void)CanDlc;
+    (void)CanSduPtr;
+    if (hrh == CAN_NUM_HRH) {
+        Bench_FilterOther++;
+    } else if (hrh == Hrh && (RxPdu >= CAN_NUM_RX_PDUS || Bench_RxPdus[RxPdu].id != CanId)) {
+        Bench_FilterErrors++;   /* Listed on this hardware object, so the driver has to find it */
+    } else if (hrh == Hrh || !Bench_FilterOwnHrh) {
+        Bench_FilterWanted++;
+    } else {
+        Bench_FilterErrors++;
+    }
+}
+
+static const Can_ConfigType Bench_FilterConfig = { Bench_FilterIndication, NULL, NULL };
+
+/* Resets the model and the checks, starts CAN1 */
+static void Bench_Start(void)
+{
+    HostSim_Reset();
+    Bench_RxCount = 0;
+    Bench_RxErrors = 0;
+    for (uint32_t i = 0; i < CAN_NUM_HRH; i++) {
+        Bench_RxLast[i] = -1;
+    }
+    memset(Bench_Confirmed, 0, sizeof(Bench_Confirmed));
+    Bench_ConfirmErrors = 0;
+    HostSim_CanCapture[BENCH_CAN].buffer = Bench_Capture;
+    HostSim_CanCapture[BENCH_CAN].size = sizeof(Bench_Capture) / sizeof(Bench_Capture[0]);
+    Can_Init(&Bench_Config);
+    (void)Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START);
+}
+
+static void Bench_MainFunctions(void)
+{
+    Can_MainFunction_Write();
+    Can_MainFunction_Read();
+    Can_MainFunction_BusOff();
+}
+
+/* Frames of the reception test, all due at once */
+static void Bench_RxTraffic(void)
+{
+    for (uint32_t i = 0; i < BENCH_RX_FRAMES; i++) {
+        Bench_NodeFrames[i].at = 0;
+        Bench_NodeFrames[i].id = Bench_RxId(i);
+        Bench_NodeFrames[i].dlc = 8;
+        Bench_Put32(&Bench_NodeFrames[i].data[0], i);
+        Bench_Put32(&Bench_NodeFrames[i].data[4], ~i);
+    }
+    HostSim_CanNode[BENCH_CAN].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN].count = BENCH_RX_FRAMES;
+}
+
+static uint8_t Bench_NodeDone(void)
+{
+    return HostSim_CanNode[BENCH_CAN].sent == HostSim_CanNode[BENCH_CAN].count;
+}
+
+/* Baseline reception: both FIFOs polled every millisecond */
+static void Bench_RxPolled(void)
+{
+    CanRxMsg msg;
+
+    Bench_RxTraffic();
+    Bench_Start();
+    Can_DisableControllerInterrupts(CAN_CONTROLLER_1);
+    while (!Bench_NodeDone() || CAN_MessagePending(CAN1, CAN_FIFO0) || CAN_MessagePending(CAN1, CAN_FIFO1)) {
+        HostSim_Idle(BENCH_MS);
+        for (uint8_t fifo = CAN_FIFO0; fifo <= CAN_FIFO1; fifo++) {
+            while (CAN_MessagePending(CAN1, fifo) != 0) {
+                CAN_Receive(CAN1, fifo, &msg);
+                Bench_RxIndication((Can_HwHandleType)(CAN_HRH_CAN1_FIFO0 + fifo), CAN_NUM_RX_PDUS, msg.StdId, msg.DLC, msg.Data);
+            }
+        }
+    }
+    printf("polled 1 ms:        %5u of %u frames received, %5u lost in the FIFOs, %u errors\n",
+           (unsigned)Bench_RxCount, (unsigned)BENCH_RX_FRAMES, (unsigned)HostSim_CanStats[BENCH_CAN].rxLost,
+           (unsigned)Bench_RxErrors);
+}
+
+/* Driver reception: interrupts fill the queues, Can_MainFunction_Read runs every Period cycles */
+static uint32_t Bench_RxDriver(uint32_t Period, const char* name)
+{
+    Can_ControllerStatsType stats;
+    uint64_t regs0;
+
+    Bench_RxTraffic();
+    Bench_Start();
+    regs0 = HostSim_RegAccesses;
+    do {
+        HostSim_Idle(Period);
+        Bench_MainFunctions();
+        (void)Can_GetControllerStats(CAN_CONTROLLER_1, &stats);
+    } while (!Bench_NodeDone() || Bench_RxCount + Bench_RxErrors + stats.rxQueueFull < HostSim_CanStats[BENCH_CAN].rxFrames);
+    printf("%-19s %5u of %u frames indicated, %5u lost (FIFO %u, queue %u), %u errors, %.2f irq/frame, %.1f reg/frame\n",
+           name, (unsigned)Bench_RxCount, (unsigned)BENCH_RX_FRAMES,
+           (unsigned)(HostSim_CanStats[BENCH_CAN].rxLost + stats.rxQueueFull),
+           (unsigned)HostSim_CanStats[BENCH_CAN].rxLost, (unsigned)stats.rxQueueFull, (unsigned)Bench_RxErrors,
+           (double)stats.interrupts / BENCH_RX_FRAMES, (double)(HostSim_RegAccesses - regs0) / BENCH_RX_FRAMES);
+    return (Bench_RxCount == BENCH_RX_FRAMES && Bench_RxErrors == 0) ? 0u : 1u;
+}
+
+/* J1939 traffic of the filtering test, all due at once; returns the number of listed frames */
+static uint32_t Bench_FilterTraffic(void)
+{
+    uint32_t listed[CAN_NUM_RX_PDUS];
+    uint32_t numListed = 0;
+    uint32_t wanted = 0;
+
+    for (uint32_t i = 0; i < CAN_NUM_RX_PDUS; i++) {
+        if (Bench_RxPdus[i].hrh >= CAN_HRH_CAN2_FIFO0) {
+            listed[numListed++] = Bench_RxPdus[i].id;
+        }
+    }
+    for (uint32_t i = 0; i < BENCH_FILTER_FRAMES; i++) {
+        uint32_t id;
+
+        if (Bench_Rand() % BENCH_FILTER_WANTED == 0) {
+            id = listed[Bench_Rand() % numListed];
+            wanted++;
+        } else {
+            // A listed parameter group from another source address, or any PDU2 parameter group at
+            // priority 3 or 6
+            do {
+                if (Bench_Rand() & 1u) {
+                    id = (listed[Bench_Rand() % numListed] & ~0xFFu) | (Bench_Rand() & 0xFFu);
+                } else {
+                    id = CAN_ID_EXTENDED | ((Bench_Rand() & 1u) ? 0x0C000000u : 0x18000000u) |
+                         ((0xF000u + Bench_Rand() % 0x1000u) << 8) | (Bench_Rand() & 0xFFu);
+                }
+            } while (Bench_Can2Hrh(id) != CAN_NUM_HRH);
+        }
+        Bench_NodeFrames[i].at = 0;
+        Bench_NodeFrames[i].id = id;
+        Bench_NodeFrames[i].dlc = 8;
+        Bench_Put32(&Bench_NodeFrames[i].data[0], i);
+        Bench_Put32(&Bench_NodeFrames[i].data[4], ~i);
+    }
+    HostSim_CanNode[BENCH_FILTER_CAN].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_FILTER_CAN].count = BENCH_FILTER_FRAMES;
+    return wanted;
+}
+
+/* Banks of CAN2 before the filter compiler: standard frames into FIFO 0, extended into FIFO 1 */
+static void Bench_AcceptAll(void)
+{
+    CAN_FilterInitTypeDef filter = { 0 };
+
+    for (uint8_t bank = CAN_SLAVE_START_BANK; bank < CAN_NUM_FILTER_BANKS; bank++) {
+        filter.CAN_FilterNumber = bank;
+        filter.CAN_FilterActivation = DISABLE;
+        CAN_FilterInit(&filter);
+    }
+    filter.CAN_FilterMode = CAN_FilterMode_IdMask;
+    filter.CAN_FilterScale = CAN_FilterScale_32bit;
+    filter.CAN_FilterMaskIdLow = CAN_Id_Extended;
+    filter.CAN_FilterActivation = ENABLE;
+    filter.CAN_FilterNumber = CAN_SLAVE_START_BANK;
+    filter.CAN_FilterFIFOAssignment = CAN_Filter_FIFO0;
+    CAN_FilterInit(&filter);
+    filter.CAN_FilterNumber = CAN_SLAVE_START_BANK + 1u;
+    filter.CAN_FilterIdLow = CAN_Id_Extended;
+    filter.CAN_FilterFIFOAssignment = CAN_Filter_FIFO1;
+    CAN_FilterInit(&filter);
+}
+
+/* Filtering: CAN2 with every frame accepted, or with the generated banks */
+static uint32_t Bench_Filter(uint8_t AcceptAll, const char* name)
+{
+    Can_ControllerStatsType stats;
+    uint32_t wanted;
+    uint64_t regs0;
+    uint64_t irq0;
+
+    wanted = Bench_FilterTraffic();
+    HostSim_Reset();
+    Bench_FilterOwnHrh = !AcceptAll;
+    Bench_FilterWanted = 0;
+    Bench_FilterOther = 0;
+    Bench_FilterErrors = 0;
+    Can_Init(&Bench_FilterConfig);
+    if (AcceptAll) {
+        Bench_AcceptAll();
+    }
+    (void)Can_SetControllerMode(CAN_CONTROLLER_2, CAN_T_START);
+    regs0 = HostSim_RegAccesses;
+    irq0 = HostSim_IrqCount;
+    while (HostSim_CanNode[BENCH_FILTER_CAN].sent < BENCH_FILTER_FRAMES) {
+        HostSim_Idle(BENCH_MS);
+        Bench_MainFunctions();
+    }
+    HostSim_Idle(BENCH_MS);
+    Bench_MainFunctions();
+    (void)Can_GetControllerStats(CAN_CONTROLLER_2, &stats);
+    printf("%-19s %5u frames to the CPU, %5u irq, %6u reg, %4u of %u listed indicated, %4u others indicated, "
+           "%u rejected by the table\n",
+           name, (unsigned)HostSim_CanStats[BENCH_FILTER_CAN].rxFrames, (unsigned)(HostSim_IrqCount - irq0),
+           (unsigned)(HostSim_RegAccesses - regs0), (unsigned)Bench_FilterWanted, (unsigned)wanted,
+           (unsigned)Bench_FilterOther, (unsigned)stats.rxRejected);
+    return (Bench_FilterWanted == wanted && Bench_FilterErrors == 0 && HostSim_CanStats[BENCH_FILTER_CAN].rxLost == 0 &&
+            (AcceptAll || Bench_FilterOther == 0)) ? 0u : 1u;
+}
+
+/* Medium priority traffic of the other node for the inversion test, from cycle 1000 */
+static void Bench_InversionTraffic(void)
+{
+    for (uint32_t i = 0; i < BENCH_INVERSION_NODE; i++) {
+        Bench_NodeFrames[i].at = 1000;
+        Bench_NodeFrames[i].id = 0x100;
+        Bench_NodeFrames[i].dlc = 8;
+        memset(Bench_NodeFrames[i].data, 0x55, 8);
+    }
+    HostSim_CanNode[BENCH_CAN].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN].count = BENCH_INVERSION_NODE;
+}
+
+/* Cycle at which the frame with an identifier left the bus, 0 if it did not */
+static uint64_t Bench_SentAt(uint32_t Id)
+{
+    for (uint32_t i = 0; i < HostSim_CanCapture[BENCH_CAN].length; i++) {
+        if (Bench_Capture[i].id == Id) {
+            return Bench_Capture[i].at;
+        }
+    }
+    return 0;
+}
+
+/* Baseline transmission: a software FIFO served by CAN_Transmit every 10 us */
+static uint64_t Bench_InversionFifo(void)
+{
+    static const uint32_t ids[4] = { 0x700, 0x701, 0x702, 0x010 };
+    uint32_t next = 0;
+    uint64_t written;
+
+    Bench_InversionTraffic();
+    Bench_Start();
+    Can_DisableControllerInterrupts(CAN_CONTROLLER_1);
+    HostSim_Idle(2000);
+    written = HostSim_Cycles;
+    while (Bench_SentAt(0x010) == 0 && HostSim_Cycles < written + 100u * BENCH_MS) {
+        while (next < 4u) {
+            CanTxMsg msg = { ids[next], 0, CAN_Id_Standard, CAN_RTR_Data, 8, { 0 } };
+            if (CAN_Transmit(CAN1, &msg) == CAN_TxStatus_NoMailBox) {
+                break;
+            }
+            next++;
+        }
+        HostSim_Idle(BENCH_MS / 100u);
+    }
+    return Bench_SentAt(0x010) ? Bench_SentAt(0x010) - written : 0;
+}
+
+/* Driver transmission: the urgent frame takes the mailbox of the least urgent one */
+static uint64_t Bench_InversionDriver(void)
+{
+    static const uint32_t ids[4] = { 0x700, 0x701, 0x702, 0x010 };
+    static const uint8_t data[8] = { 0 };
+    uint64_t written;
+
+    Bench_InversionTraffic();
+    Bench_Start();
+    HostSim_Idle(2000);
+    written = HostSim_Cycles;
+    for (uint32_t i = 0; i < 4u; i++) {
+        Can_PduType pdu = { (PduIdType)i, 8, ids[i], data };
+        (void)Can_Write(CAN_HTH_CAN1, &pdu);
+    }
+    while (Bench_SentAt(0x010) == 0 && HostSim_Cycles < written + 100u * BENCH_MS) {
+        HostSim_Idle(BENCH_MS / 100u);
+        Bench_MainFunctions();
+    }
+    return Bench_SentAt(0x010) ? Bench_SentAt(0x010) - written : 0;
+}
+
+/* Stress: random writes against random traffic; checks confirmation and per-identifier order */
+static uint32_t Bench_Stress(void)
+{
+    Can_ControllerStatsType stats;
+    uint32_t nextSeq[BENCH_STRESS_IDS] = { 0 };
+    int64_t lastSeq[BENCH_STRESS_IDS];
+    uint32_t written = 0, busy = 0, orderErrors = 0, missing = 0;
+    uint64_t writeNs = 0, writeRegs = 0, at = 0;
+    uint64_t nextMain = BENCH_MS;
+    uint8_t data[8];
+    uint32_t pending = Bench_Rand() % BENCH_STRESS_IDS;
+
+    for (uint32_t i = 0; i < BENCH_STRESS_NODE; i++) {
+        at += Bench_Rand() % (300u * BENCH_MS / 1000u);
+        Bench_NodeFrames[i].at = at;
+        Bench_NodeFrames[i].id = 0x080u + Bench_Rand() % 0x780u;
+        Bench_NodeFrames[i].dlc = (uint8_t)(Bench_Rand() % 9u);
+        memset(Bench_NodeFrames[i].data, 0xAA, 8);
+    }
+    HostSim_CanNode[BENCH_CAN].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN].count = BENCH_STRESS_NODE;
+    Bench_Start();
+
+    while (written < BENCH_STRESS_WRITES) {
+        uint32_t burst = 1u + Bench_Rand() % 6u;
+
+        for (uint32_t b = 0; b < burst && written < BENCH_STRESS_WRITES; b++) {
+            Can_PduType pdu = { (PduIdType)written, 8, Bench_StressId[pending], data };
+            uint64_t r = HostSim_RegAccesses;
+            uint64_t ns;
+            Can_ReturnType ret;
+
+            Bench_Put32(&data[0], nextSeq[pending]);
+            Bench_Put32(&data[4], pending);
+            ns = Bench_HostNow();
+            ret = Can_Write(CAN_HTH_CAN1, &pdu);
+            if (ret != CAN_OK) {
+                busy++;
+                break;
+            }
+            writeNs += Bench_HostNow() - ns;
+            writeRegs += HostSim_RegAccesses - r;
+            nextSeq[pending]++;
+            written++;
+            pending = Bench_Rand() % BENCH_STRESS_IDS;
+        }
+        HostSim_Idle(Bench_Rand() % 20000u);
+        if (HostSim_Cycles >= nextMain) {
+            Bench_MainFunctions();
+            nextMain += BENCH_MS;
+        }
+    }
+    for (uint32_t ms = 0; ms < 100u; ms++) {
+        HostSim_Idle(BENCH_MS);
+        Bench_MainFunctions();
+    }
+
+    for (uint32_t i = 0; i < BENCH_STRESS_IDS; i++) {
+        lastSeq[i] = -1;
+    }
+    for (uint32_t i = 0; i < HostSim_CanCapture[BENCH_CAN].length; i++) {
+        uint32_t idx = Bench_Get32(&Bench_Capture[i].data[4]);
+        uint32_t seq = Bench_Get32(&Bench_Capture[i].data[0]);
+        if (idx >= BENCH_STRESS_IDS || (int64_t)seq != lastSeq[idx] + 1) {
+            orderErrors++;
+        } else {
+            lastSeq[idx] = seq;
+        }
+    }
+    for (uint32_t i = 0; i < BENCH_STRESS_WRITES; i++) {
+        missing += (Bench_Confirmed[i] == 0);
+    }
+    (void)Can_GetControllerStats(CAN_CONTROLLER_1, &stats);
+    printf("stress:             %u frames, %u sent, %u unconfirmed, %u order errors, %u confirmation errors, "
+           "%u aborts, %u busy\n",
+           (unsigned)written, (unsigned)HostSim_CanCapture[BENCH_CAN].length, (unsigned)missing,
+           (unsigned)orderErrors, (unsigned)Bench_ConfirmErrors, (unsigned)stats.txAborts, (unsigned)busy);
+    printf("Can_Write:          %.1f reg/frame, %.1f ns/frame (host)\n",
+           (double)writeRegs / written, (double)writeNs / written);
+    return (missing == 0 && orderErrors == 0 && Bench_ConfirmErrors == 0 &&
+            HostSim_CanCapture[BENCH_CAN].length == BENCH_STRESS_WRITES) ? 0u : 1u;
+}
+
+/* Bus-off: stopped and notified by Can_MainFunction_BusOff, then restarted */
+static uint32_t Bench_BusOffRecovery(void)
+{
+    static const uint8_t data[8] = { 0 };
+    Can_PduType pdu = { 0, 8, 0x123, data };
+    Can_ControllerStateType state;
+    uint32_t failed = 0;
+
+    HostSim_CanNode[BENCH_CAN].count = 0;
+    Bench_Start();
+    Bench_BusOffSeen = 0;
+    HostSim_CanBusOff(BENCH_CAN);
+    Bench_MainFunctions();
+    (void)Can_GetControllerMode(CAN_CONTROLLER_1, &state);
+    failed += (state != CAN_CS_STOPPED || !Bench_BusOffSeen || Can_Write(CAN_HTH_CAN1, &pdu) != CAN_NOT_OK);
+    failed += (Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START) != E_OK || Can_Write(CAN_HTH_CAN1, &pdu) != CAN_OK);
+    HostSim_Idle(BENCH_MS);
+    Bench_MainFunctions();
+    failed += (Bench_Confirmed[0] != 1u);
+    printf("bus-off:            %s\n", failed ? "FAILED" : "stopped, notified, restarted and sent");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+    uint64_t fifo, driver;
+
+    for (uint32_t i = 0; i < CAN_NUM_RX_PDUS; i++) {
+        uint8_t hrh = Bench_RxPdus[i].hrh;
+        if (hrh <= CAN_HRH_CAN1_FIFO1) {
+            uint32_t fifo = hrh - CAN_HRH_CAN1_FIFO0;
+            Bench_Can1Ids[fifo][Bench_NumCan1Ids[fifo]++] = Bench_RxPdus[i].id;
+        }
+    }
+
+    printf("reception at full bus load, 1 Mbit/s, 8-byte frames:\n");
+    Bench_RxPolled();
+    failed += Bench_RxDriver(BENCH_MS, "Can driver 1 ms:");
+    failed += Bench_RxDriver(5u * BENCH_MS, "Can driver 5 ms:");
+
+    printf("filtering at full bus load, 500 kbit/s, %u J1939 frames:\n", (unsigned)BENCH_FILTER_FRAMES);
+    failed += Bench_Filter(1, "accept all:");
+    failed += Bench_Filter(0, "compiled filters:");
+
+    fifo = Bench_InversionFifo();
+    driver = Bench_InversionDriver();
+    printf("urgent frame behind 3 low priority mailboxes, bus busy with medium priority traffic:\n");
+    printf("FIFO + CAN_Transmit: %8.1f us\nCan_Write:           %8.1f us\n",
+           (double)fifo * 1e6 / HOSTSIM_CORE_CLOCK_HZ, (double)driver * 1e6 / HOSTSIM_CORE_CLOCK_HZ);
+    failed += (driver == 0 || driver > 3u * BENCH_MS / 10u);
+
+    failed += Bench_Stress();
+    failed += Bench_BusOffRecovery();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,490 @@
+/*
+* File: Can_FilterGen.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Filter compiler of the CAN driver. Packs the identifiers of CAN_RX_PDUS (Can_Cfg.h)
+* into the fewest filter banks of each controller and writes them as Can_Filter_Cfg.c:
+*   - identifiers that differ in a few bits are merged into one mask, as long as the mask accepts
+*     no identifier outside the list;
+*   - the remaining identifiers are packed four per bank (standard, 16-bit list) or two per bank
+*     (extended, 32-bit list), masks two per bank (standard) or one per bank (extended);
+*   - while a controller still needs more banks than it owns, the two entries whose merge lets
+*     through the fewest foreign identifiers are merged. The receive hardware objects with such
+*     masks get the sorted identifier table checked by the receive interrupt.
+* The identifiers of each receive hardware object also go into a hash table with at least twice as
+* many slots, next to the frame of CAN_RX_PDUS they belong to. Its multiplier is searched until no
+* two identifiers share a slot, so the receive interrupt gets from a received identifier to its
+* frame with one multiplication and one comparison.
+* A mask never accepts an identifier listed for another hardware object of the controller, so each
+* frame lands in the FIFO it is configured for.
+*
+*   can_filtergen [Can_Filter_Cfg.c]    (standard output by default, statistics on standard error)
+*/
+
+#include "Can.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GEN_MAX_ENTRIES     CAN_NUM_RX_PDUS
+#define GEN_MAX_BANKS       CAN_NUM_FILTER_BANKS
+#define GEN_MAX_SLOTS       (4u * CAN_NUM_RX_PDUS)  /* Slots of all hash tables */
+#define GEN_HASH_TRIES      100000u                 /* Multipliers tried per table size */
+
+/* Received identifier of the configuration */
+typedef struct {
+    const char* name;
+    uint8_t hrh;
+    Can_IdType id;
+} Gen_PduType;
+
+#define GEN_PDU(name, hrh, id)  { #name, (hrh), (id) },
+
+static const Gen_PduType Gen_Pdus[CAN_NUM_RX_PDUS] = {
+    CAN_RX_PDUS(GEN_PDU)
+};
+
+static const char* const Gen_HrhNames[CAN_NUM_HRH] = {
+    "CAN_HRH_CAN1_FIFO0", "CAN_HRH_CAN1_FIFO1", "CAN_HRH_CAN2_FIFO0", "CAN_HRH_CAN2_FIFO1"
+};
+
+static const char* const Gen_ControllerNames[CAN_NUM_CONTROLLERS] = {
+    "CAN_CONTROLLER_1", "CAN_CONTROLLER_2"
+};
+
+/* Filter entry: accepts the identifiers with (identifier & mask) == id */
+typedef struct {
+    uint8_t hrh;
+    uint8_t ext;
+    uint32_t id;
+    uint32_t mask;
+} Gen_EntryType;
+
+/* Generated bank, with a comment listing its entries */
+typedef struct {
+    uint8_t controller;
+    uint8_t fifo;
+    uint8_t mode;
+    uint8_t scale;
+    uint32_t fr1;
+    uint32_t fr2;
+    char comment[96];
+} Gen_BankType;
+
+static Gen_EntryType Gen_Entries[GEN_MAX_ENTRIES];
+static uint32_t Gen_NumEntries;
+static Gen_BankType Gen_Banks[GEN_MAX_BANKS];
+static uint32_t Gen_NumBanks;
+
+static uint8_t Gen_Controller(uint8_t hrh)
+{
+    return (uint8_t)(hrh / 2u);
+}
+
+static uint32_t Gen_FullMask(uint8_t ext)
+{
+    return ext ? CAN_ID_EXTENDED_MASK : CAN_ID_STANDARD_MASK;
+}
+
+static uint8_t Gen_Covers(const Gen_EntryType* e, const Gen_PduType* pdu)
+{
+    uint8_t ext = (pdu->id & CAN_ID_EXTENDED) != 0;
+    uint32_t id = pdu->id & Gen_FullMask(ext);
+    return ext == e->ext && ((id ^ e->id) & e->mask) == 0;
+}
+
+/* Identifiers accepted by an entry beyond the list, or -1 if it accepts an identifier listed for
+   another hardware object of the controller */
+static int64_t Gen_Extra(const Gen_EntryType* e)
+{
+    uint32_t free = Gen_FullMask(e->ext) & ~e->mask;
+    int64_t accepted = (int64_t)1 << __builtin_popcount(free);
+
+    for (uint32_t p = 0; p < CAN_NUM_RX_PDUS; p++) {
+        const Gen_PduType* pdu = &Gen_Pdus[p];
+        if (Gen_Controller(pdu->hrh) != Gen_Controller(e->hrh) || !Gen_Covers(e, pdu)) {
+            continue;
+        }
+        if (pdu->hrh != e->hrh) {
+            return -1;
+        }
+        accepted--;
+    }
+    return accepted;
+}
+
+static Gen_EntryType Gen_Merge(const Gen_EntryType* a, const Gen_EntryType* b)
+{
+    Gen_EntryType m = *a;
+    m.mask = a->mask & b->mask & ~(a->id ^ b->id);
+    m.id = a->id & m.mask;
+    return m;
+}
+
+/* Replaces entries a and b by m and drops the entries m accepts entirely */
+static void Gen_Replace(uint32_t a, uint32_t b, const Gen_EntryType* m)
+{
+    uint32_t n = 0;
+
+    Gen_Entries[a] = *m;
+    for (uint32_t i = 0; i < Gen_NumEntries; i++) {
+        const Gen_EntryType* e = &Gen_Entries[i];
+        uint8_t inside = i != a && e->hrh == m->hrh && e->ext == m->ext &&
+                         (e->mask & m->mask) == m->mask && ((e->id ^ m->id) & m->mask) == 0;
+        if (i != b && !inside) {
+            Gen_Entries[n++] = *e;
+        }
+    }
+    Gen_NumEntries = n;
+}
+
+/* Entries of a hardware object by kind: standard list, standard mask, extended list, extended mask */
+static void Gen_Count(uint8_t hrh, uint32_t count[4])
+{
+    memset(count, 0, 4u * sizeof(count[0]));
+    for (uint32_t i = 0; i < Gen_NumEntries; i++) {
+        const Gen_EntryType* e = &Gen_Entries[i];
+        if (e->hrh == hrh) {
+            count[e->ext * 2u + (e->mask != Gen_FullMask(e->ext))]++;
+        }
+    }
+}
+
+/* Standard identifiers moved from the lists into the free half of a 16-bit mask bank */
+static uint32_t Gen_Borrowed(const uint32_t count[4])
+{
+    return ((count[1] & 1u) != 0 && (count[0] & 3u) == 1u) ? 1u : 0u;
+}
+
+static uint32_t Gen_HrhBanks(uint8_t hrh)
+{
+    uint32_t count[4];
+    uint32_t borrowed;
+
+    Gen_Count(hrh, count);
+    borrowed = Gen_Borrowed(count);
+    return (count[0] - borrowed + 3u) / 4u + (count[1] + borrowed + 1u) / 2u + (count[2] + 1u) / 2u + count[3];
+}
+
+static uint32_t Gen_ControllerBanks(uint8_t controller)
+{
+    return Gen_HrhBanks((uint8_t)(controller * 2u)) + Gen_HrhBanks((uint8_t)(controller * 2u + 1u));
+}
+
+/* Best merge of two entries of a controller (of any controller with CAN_NUM_CONTROLLERS), in
+   identifiers accepted beyond those the two entries already accept; -1 if there is none */
+static int64_t Gen_BestMerge(uint8_t controller, uint32_t* bestA, uint32_t* bestB, Gen_EntryType* best)
+{
+    int64_t bestCost = -1;
+
+    for (uint32_t a = 0; a < Gen_NumEntries; a++) {
+        const Gen_EntryType* ea = &Gen_Entries[a];
+        if (controller < CAN_NUM_CONTROLLERS && Gen_Controller(ea->hrh) != controller) {
+            continue;
+        }
+        for (uint32_t b = a + 1u; b < Gen_NumEntries; b++) {
+            const Gen_EntryType* eb = &Gen_Entries[b];
+            Gen_EntryType m;
+            int64_t extra;
+            int64_t cost;
+
+            if (eb->hrh != ea->hrh || eb->ext != ea->ext) {
+                continue;
+            }
+            m = Gen_Merge(ea, eb);
+            if ((extra = Gen_Extra(&m)) < 0) {
+                continue;
+            }
+            cost = extra - Gen_Extra(ea) - Gen_Extra(eb);
+            if (cost < 0) {
+                cost = 0;
+            }
+            if (bestCost < 0 || cost < bestCost) {
+                bestCost = cost;
+                *bestA = a;
+                *bestB = b;
+                *best = m;
+            }
+        }
+    }
+    return bestCost;
+}
+
+static uint16_t Gen_Half(uint32_t id)
+{
+    return (uint16_t)(id << 5);         /* STID in bits 15-5, RTR, IDE and EXID[17:15] clear */
+}
+
+static void Gen_AddBank(uint8_t hrh, uint8_t mode, uint8_t scale, uint32_t fr1, uint32_t fr2, const char* comment)
+{
+    Gen_BankType* bank = &Gen_Banks[Gen_NumBanks++];
+
+    bank->controller = Gen_Controller(hrh);
+    bank->fifo = (uint8_t)(hrh % 2u);
+    bank->mode = mode;
+    bank->scale = scale;
+    bank->fr1 = fr1;
+    bank->fr2 = fr2;
+    snprintf(bank->comment, sizeof(bank->comment), "%s", comment);
+}
+
+/* Lays out the entries of a hardware object into banks; a partly used bank repeats its last entry */
+static void Gen_Layout(uint8_t hrh)
+{
+    const Gen_EntryType* group[4][GEN_MAX_ENTRIES];
+    uint32_t count[4] = { 0, 0, 0, 0 };
+    char comment[96];
+
+    for (uint32_t i = 0; i < Gen_NumEntries; i++) {
+        const Gen_EntryType* e = &Gen_Entries[i];
+        if (e->hrh == hrh) {
+            uint32_t kind = e->ext * 2u + (e->mask != Gen_FullMask(e->ext));
+            group[kind][count[kind]++] = e;
+        }
+    }
+    if (Gen_Borrowed(count)) {
+        group[1][count[1]++] = group[0][--count[0]];
+    }
+
+    for (uint32_t i = 0; i < count[2]; i += 2u) {
+        const Gen_EntryType* e0 = group[2][i];
+        const Gen_EntryType* e1 = group[2][(i + 1u < count[2]) ? i + 1u : i];
+        snprintf(comment, sizeof(comment), "0x%08X 0x%08X", (unsigned)e0->id, (unsigned)e1->id);
+        Gen_AddBank(hrh, CAN_FilterMode_IdList, CAN_FilterScale_32bit,
+                    (e0->id << 3) | CAN_Id_Extended, (e1->id << 3) | CAN_Id_Extended, comment);
+    }
+    for (uint32_t i = 0; i < count[3]; i++) {
+        const Gen_EntryType* e = group[3][i];
+        snprintf(comment, sizeof(comment), "0x%08X/0x%08X", (unsigned)e->id, (unsigned)e->mask);
+        Gen_AddBank(hrh, CAN_FilterMode_IdMask, CAN_FilterScale_32bit,
+                    (e->id << 3) | CAN_Id_Extended, (e->mask << 3) | CAN_Id_Extended | CAN_RTR_Remote, comment);
+    }
+    for (uint32_t i = 0; i < count[0]; i += 4u) {
+        uint16_t half[4];
+        int length = 0;
+        for (uint32_t k = 0; k < 4u; k++) {
+            const Gen_EntryType* e = group[0][(i + k < count[0]) ? i + k : count[0] - 1u];
+            half[k] = Gen_Half(e->id);
+            length += snprintf(comment + length, sizeof(comment) - (size_t)length, "%s0x%03X", k ? " " : "", (unsigned)e->id);
+        }
+        Gen_AddBank(hrh, CAN_FilterMode_IdList, CAN_FilterScale_16bit,
+                    ((uint32_t)half[1] << 16) | half[0], ((uint32_t)half[3] << 16) | half[2], comment);
+    }
+    for (uint32_t i = 0; i < count[1]; i += 2u) {
+        const Gen_EntryType* e0 = group[1][i];
+        const Gen_EntryType* e1 = group[1][(i + 1u < count[1]) ? i + 1u : i];
+        /* RTR and IDE compared: standard data frames only */
+        uint32_t m0 = (uint32_t)Gen_Half(e0->mask) | 0x18u;
+        uint32_t m1 = (uint32_t)Gen_Half(e1->mask) | 0x18u;
+        snprintf(comment, sizeof(comment), "0x%03X/0x%03X 0x%03X/0x%03X",
+                 (unsigned)e0->id, (unsigned)e0->mask, (unsigned)e1->id, (unsigned)e1->mask);
+        Gen_AddBank(hrh, CAN_FilterMode_IdMask, CAN_FilterScale_16bit,
+                    (m0 << 16) | Gen_Half(e0->id), (m1 << 16) | Gen_Half(e1->id), comment);
+    }
+}
+
+/* Slot of an identifier in a hash table of 2^bits slots */
+static uint32_t Gen_Slot(Can_IdType id, uint32_t multiplier, uint32_t bits)
+{
+    return (uint32_t)(id * multiplier) >> (32u - bits);
+}
+
+/* Smallest table and first multiplier placing the identifiers of a hardware object in distinct
+   slots, -1 if none fits into GEN_MAX_SLOTS; the multipliers come from a fixed sequence, so the
+   output is reproducible */
+static int Gen_Hash(const uint32_t* pdus, uint32_t count, uint32_t* bits, uint32_t* multiplier)
+{
+    uint32_t x = 0x9E3779B9u;
+
+    *bits = 1;
+    while ((1u << *bits) < 2u * count) {
+        (*bits)++;
+    }
+    for (; (1u << *bits) <= GEN_MAX_SLOTS; (*bits)++) {
+        for (uint32_t t = 0; t < GEN_HASH_TRIES; t++) {
+            uint8_t used[GEN_MAX_SLOTS] = { 0 };
+            uint32_t i;
+
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            *multiplier = x | 1u;
+            for (i = 0; i < count; i++) {
+                uint32_t slot = Gen_Slot(Gen_Pdus[pdus[i]].id, *multiplier, *bits);
+                if (used[slot]++) {
+                    break;
+                }
+            }
+            if (i == count) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Orders frames of CAN_RX_PDUS by identifier */
+static int Gen_ComparePdus(const void* a, const void* b)
+{
+    Can_IdType x = Gen_Pdus[*(const uint32_t*)a].id;
+    Can_IdType y = Gen_Pdus[*(const uint32_t*)b].id;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv)
+{
+    static const uint8_t budget[CAN_NUM_CONTROLLERS] = {
+        CAN_SLAVE_START_BANK, CAN_NUM_FILTER_BANKS - CAN_SLAVE_START_BANK
+    };
+    int64_t extra[CAN_NUM_HRH] = { 0 };
+    uint32_t first[CAN_NUM_HRH];
+    uint32_t count[CAN_NUM_HRH];
+    uint32_t bits[CAN_NUM_HRH];
+    uint32_t multiplier[CAN_NUM_HRH];
+    uint32_t total = 0;
+    FILE* out = stdout;
+    uint32_t a;
+    uint32_t b;
+    Gen_EntryType m;
+
+    /* One exact entry per identifier */
+    for (uint32_t p = 0; p < CAN_NUM_RX_PDUS; p++) {
+        const Gen_PduType* pdu = &Gen_Pdus[p];
+        uint8_t ext = (pdu->id & CAN_ID_EXTENDED) != 0;
+
+        if (pdu->hrh >= CAN_NUM_HRH || (pdu->id & ~(CAN_ID_EXTENDED | Gen_FullMask(ext))) != 0) {
+            fprintf(stderr, "can_filtergen: %s: invalid hardware object or identifier\n", pdu->name);
+            return 1;
+        }
+        for (uint32_t q = 0; q < p; q++) {
+            if (Gen_Pdus[q].id == pdu->id && Gen_Controller(Gen_Pdus[q].hrh) == Gen_Controller(pdu->hrh)) {
+                fprintf(stderr, "can_filtergen: %s: identifier already used by %s\n", pdu->name, Gen_Pdus[q].name);
+                return 1;
+            }
+        }
+        Gen_Entries[Gen_NumEntries].hrh = pdu->hrh;
+        Gen_Entries[Gen_NumEntries].ext = ext;
+        Gen_Entries[Gen_NumEntries].id = pdu->id & Gen_FullMask(ext);
+        Gen_Entries[Gen_NumEntries].mask = Gen_FullMask(ext);
+        Gen_NumEntries++;
+    }
+
+    /* Exact merges never cost a bank */
+    while (Gen_BestMerge(CAN_NUM_CONTROLLERS, &a, &b, &m) == 0 && Gen_Extra(&m) == 0) {
+        Gen_Replace(a, b, &m);
+    }
+
+    /* Lossy merges until each controller fits into its banks */
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        while (Gen_ControllerBanks(ctrl) > budget[ctrl]) {
+            if (Gen_BestMerge(ctrl, &a, &b, &m) < 0) {
+                fprintf(stderr, "can_filtergen: %s: identifiers do not fit into %u filter banks\n",
+                        Gen_ControllerNames[ctrl], (unsigned)budget[ctrl]);
+                return 1;
+            }
+            Gen_Replace(a, b, &m);
+        }
+    }
+
+    for (uint32_t i = 0; i < Gen_NumEntries; i++) {
+        extra[Gen_Entries[i].hrh] += Gen_Extra(&Gen_Entries[i]);
+    }
+    for (uint8_t hrh = 0; hrh < CAN_NUM_HRH; hrh++) {
+        Gen_Layout(hrh);
+    }
+
+    if (argc > 1 && (out = fopen(argv[1], "w")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/*\n"
+                 "* File: Can_Filter_Cfg.c\n"
+                 "* Author: Tran Nhat Thai\n"
+                 "* Date: 29/02/2024\n"
+                 "* Description: Filter banks of the CAN driver, generated by Test/Can_FilterGen.c from CAN_RX_PDUS in\n"
+                 "* Can_Cfg.h. Do not edit: run \"make -C Test filters\" instead.\n"
+                 "*/\n\n"
+                 "#include \"Can.h\"\n\n");
+
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        uint32_t ids = 0;
+        int64_t more = extra[ctrl * 2u] + extra[ctrl * 2u + 1u];
+        for (uint32_t p = 0; p < CAN_NUM_RX_PDUS; p++) {
+            ids += Gen_Controller(Gen_Pdus[p].hrh) == ctrl;
+        }
+        fprintf(out, "// %s: %u of %u banks for %u identifiers", Gen_ControllerNames[ctrl],
+                (unsigned)Gen_ControllerBanks(ctrl), (unsigned)budget[ctrl], (unsigned)ids);
+        if (more == 0) {
+            fprintf(out, ", no other identifier accepted\n");
+        } else {
+            fprintf(out, ", %lld other identifiers accepted by masks\n", (long long)more);
+        }
+        fprintf(stderr, "%s: %u of %u banks, %u identifiers, %lld accepted beyond the list\n", Gen_ControllerNames[ctrl],
+                (unsigned)Gen_ControllerBanks(ctrl), (unsigned)budget[ctrl], (unsigned)ids, (long long)more);
+    }
+
+    fprintf(out, "const Can_FilterBankConfigType Can_FilterBankConfig[] = {\n"
+                 "    /* controller, fifo, mode, scale, fr1, fr2 */\n");
+    for (uint32_t i = 0; i < Gen_NumBanks; i++) {
+        const Gen_BankType* bank = &Gen_Banks[i];
+        fprintf(out, "    { %s, CAN_FIFO%u, %s, %s, 0x%08Xu, 0x%08Xu },   /* %s */\n",
+                Gen_ControllerNames[bank->controller], (unsigned)bank->fifo,
+                (bank->mode == CAN_FilterMode_IdList) ? "CAN_FilterMode_IdList" : "CAN_FilterMode_IdMask",
+                (bank->scale == CAN_FilterScale_32bit) ? "CAN_FilterScale_32bit" : "CAN_FilterScale_16bit",
+                (unsigned)bank->fr1, (unsigned)bank->fr2, bank->comment);
+    }
+    fprintf(out, "};\n\n"
+                 "const uint8_t Can_FilterBankCount = sizeof(Can_FilterBankConfig) / sizeof(Can_FilterBankConfig[0]);\n\n");
+
+    fprintf(out, "const Can_RxSlotType Can_RxSlotTable[] = {\n"
+                 "    /* id, pdu */\n");
+    for (uint8_t hrh = 0; hrh < CAN_NUM_HRH; hrh++) {
+        uint32_t pdus[CAN_NUM_RX_PDUS];
+        int32_t slots[GEN_MAX_SLOTS];
+
+        count[hrh] = 0;
+        for (uint32_t p = 0; p < CAN_NUM_RX_PDUS; p++) {
+            if (Gen_Pdus[p].hrh == hrh) {
+                pdus[count[hrh]++] = p;
+            }
+        }
+        qsort(pdus, count[hrh], sizeof(pdus[0]), Gen_ComparePdus);
+        if (Gen_Hash(pdus, count[hrh], &bits[hrh], &multiplier[hrh]) < 0 || total + (1u << bits[hrh]) > GEN_MAX_SLOTS) {
+            fprintf(stderr, "can_filtergen: %s: hash tables larger than %u slots\n", Gen_HrhNames[hrh], GEN_MAX_SLOTS);
+            return 1;
+        }
+        for (uint32_t slot = 0; slot < (1u << bits[hrh]); slot++) {
+            slots[slot] = -1;
+        }
+        for (uint32_t i = 0; i < count[hrh]; i++) {
+            slots[Gen_Slot(Gen_Pdus[pdus[i]].id, multiplier[hrh], bits[hrh])] = (int32_t)pdus[i];
+        }
+        first[hrh] = total;
+        fprintf(out, "    /* %s */\n", Gen_HrhNames[hrh]);
+        for (uint32_t slot = 0; slot < (1u << bits[hrh]); slot++) {
+            if (slots[slot] < 0) {
+                fprintf(out, "    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },\n");
+            } else {
+                fprintf(out, "    { 0x%08Xu, %s },\n", (unsigned)Gen_Pdus[slots[slot]].id, Gen_Pdus[slots[slot]].name);
+            }
+        }
+        total += 1u << bits[hrh];
+        fprintf(stderr, "%s: %u identifiers in %u hash slots\n", Gen_HrhNames[hrh], (unsigned)count[hrh],
+                1u << bits[hrh]);
+    }
+    fprintf(out, "};\n\n"
+                 "const Can_RxHashType Can_RxHash[CAN_NUM_HRH] = {\n"
+                 "    /* first, shift, check, multiplier */\n");
+    for (uint8_t hrh = 0; hrh < CAN_NUM_HRH; hrh++) {
+        fprintf(out, "    { %u, %u, %u, 0x%08Xu },   /* %s: %u identifiers in %u slots */\n", (unsigned)first[hrh],
+                (unsigned)(32u - bits[hrh]), (unsigned)(extra[hrh] != 0), (unsigned)multiplier[hrh],
+                Gen_HrhNames[hrh], (unsigned)count[hrh], 1u << bits[hrh]);
+    }
+    fprintf(out, "};\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,364 @@
+/*
+* File: Com_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the COM module.
+*   - Layout: random values and dirty bitmaps packed by the generated functions and by a generic
+*     bit walker, which follows the byte order of each signal bit by bit from the configuration
+*     tables; random frames unpacked by both. The results have to be identical.
+*   - Speed: host time per I-PDU of the bit walker and of the generated functions, packing every
+*     signal and only the one signal that changed, and unpacking.
+*   - CAN: frames of the other nodes received through the CAN driver and PduR, and read with
+*     Com_ReceiveSignal; signals sent with Com_SendSignal, captured on the bus with their update bits.
+*
+*   com_bench
+*/
+
+#include "Com.h"
+#include "PduR.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ROUNDS            100000u     /* Random layouts checked */
+#define BENCH_LOOPS             200000u     /* Calls timed per I-PDU and function */
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_TX_CALLS          20u         /* Calls of Com_MainFunctionTx in the CAN test */
+
+/* Layout of a signal, from Com_Cfg.h */
+typedef struct {
+    uint8_t ipdu;
+    uint8_t type;
+    uint16_t start;
+    uint8_t length;
+    uint8_t endian;
+    uint16_t update;
+} Bench_SignalType;
+
+#define BENCH_SIGNAL(name, ipdu, type, start, length, endian, update) \
+    { (ipdu), (type), (start), (length), (endian), (update) },
+
+static const Bench_SignalType Bench_RxSignals[COM_NUM_RX_SIGNALS] = { COM_RX_SIGNALS(BENCH_SIGNAL) };
+static const Bench_SignalType Bench_TxSignals[COM_NUM_TX_SIGNALS] = { COM_TX_SIGNALS(BENCH_SIGNAL) };
+
+static uint32_t Bench_Random = 0x3C6EF372u;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Generic bit walker: bit of the frame holding the next value bit, from the most significant one */
+static uint32_t Bench_WalkNext(const Bench_SignalType* s, uint32_t Pos)
+{
+    if (s->endian == COM_LITTLE_ENDIAN) {
+        return Pos - 1u;
+    }
+    return (Pos % 8u == 0) ? Pos + 15u : Pos - 1u;
+}
+
+/* Most significant bit of a signal in the frame */
+static uint32_t Bench_WalkMsb(const Bench_SignalType* s)
+{
+    uint32_t pos = s->start;
+
+    if (s->endian == COM_LITTLE_ENDIAN) {
+        return pos + s->length - 1u;
+    }
+    return pos;
+}
+
+static void Bench_WalkPack(uint8_t Ipdu, uint8_t* Data, const uint32_t* Values, uint32_t Dirty)
+{
+    uint32_t k = 0;
+
+    for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+        const Bench_SignalType* s = &Bench_TxSignals[i];
+        if (s->ipdu != Ipdu) {
+            continue;
+        }
+        if (s->update != COM_NO_UPDATE_BIT) {
+            Data[s->update / 8u] &= (uint8_t)~(1u << (s->update % 8u));
+        }
+        if (Dirty & (1u << k++)) {
+            uint32_t pos = Bench_WalkMsb(s);
+            for (int32_t bit = s->length - 1; bit >= 0; bit--) {
+                uint8_t mask = (uint8_t)(1u << (pos % 8u));
+                if ((Values[i] >> bit) & 1u) {
+                    Data[pos / 8u] |= mask;
+                } else {
+                    Data[pos / 8u] &= (uint8_t)~mask;
+                }
+                pos = Bench_WalkNext(s, pos);
+            }
+            if (s->update != COM_NO_UPDATE_BIT) {
+                Data[s->update / 8u] |= (uint8_t)(1u << (s->update % 8u));
+            }
+        }
+    }
+}
+
+static void Bench_WalkUnpack(uint8_t Ipdu, const uint8_t* Data, uint32_t* Values)
+{
+    for (uint32_t i = 0; i < COM_NUM_RX_SIGNALS; i++) {
+        const Bench_SignalType* s = &Bench_RxSignals[i];
+        uint32_t value = 0;
+        uint32_t pos;
+
+        if (s->ipdu != Ipdu ||
+            (s->update != COM_NO_UPDATE_BIT && !(Data[s->update / 8u] & (1u << (s->update % 8u))))) {
+            continue;
+        }
+        pos = Bench_WalkMsb(s);
+        for (uint32_t bit = 0; bit < s->length; bit++) {
+            value = (value << 1) | ((Data[pos / 8u] >> (pos % 8u)) & 1u);
+            pos = Bench_WalkNext(s, pos);
+        }
+        if (s->type >= COM_SINT8 && s->length < 32u && (value >> (s->length - 1u)) != 0) {
+            value |= ~0u << s->length;
+        }
+        Values[i] = value;
+    }
+}
+
+/* Signals of an I-PDU as a dirty bitmap */
+static uint32_t Bench_AllDirty(uint8_t Ipdu)
+{
+    uint32_t dirty = 0;
+    for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+        if (Bench_TxSignals[i].ipdu == Ipdu) {
+            dirty |= Com_TxSignalMask[i];
+        }
+    }
+    return dirty;
+}
+
+static uint32_t Bench_Layout(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t values[COM_NUM_TX_SIGNALS];
+        uint32_t expected[COM_NUM_RX_SIGNALS];
+        uint32_t unpacked[COM_NUM_RX_SIGNALS];
+        uint8_t a[8];
+        uint8_t b[8];
+
+        for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+            values[i] = Bench_Rand();
+        }
+        for (uint8_t ipdu = 0; ipdu < COM_NUM_TX_IPDUS; ipdu++) {
+            uint32_t dirty = Bench_Rand();
+            for (uint32_t j = 0; j < 8u; j++) {
+                a[j] = b[j] = (uint8_t)Bench_Rand();
+            }
+            Com_PackFunctions[ipdu](a, values, dirty);
+            Bench_WalkPack(ipdu, b, values, dirty);
+            errors += (memcmp(a, b, sizeof(a)) != 0);
+        }
+        for (uint8_t ipdu = 0; ipdu < COM_NUM_RX_IPDUS; ipdu++) {
+            for (uint32_t j = 0; j < 8u; j++) {
+                a[j] = (uint8_t)Bench_Rand();
+            }
+            for (uint32_t i = 0; i < COM_NUM_RX_SIGNALS; i++) {
+                expected[i] = unpacked[i] = Bench_Rand();
+            }
+            Com_UnpackFunctions[ipdu](a, unpacked);
+            Bench_WalkUnpack(ipdu, a, expected);
+            errors += (memcmp(expected, unpacked, sizeof(unpacked)) != 0);
+        }
+    }
+    printf("layout:       %u rounds of %u sent and %u received I-PDUs, %u errors\n", (unsigned)BENCH_ROUNDS,
+           (unsigned)COM_NUM_TX_IPDUS, (unsigned)COM_NUM_RX_IPDUS, (unsigned)errors);
+    return errors;
+}
+
+static void Bench_Speed(void)
+{
+    static uint32_t values[COM_NUM_RX_SIGNALS + COM_NUM_TX_SIGNALS];
+    static uint8_t data[8];
+    uint64_t walkPack = 0, genPack = 0, genOne = 0, walkUnpack = 0, genUnpack = 0;
+    uint64_t t0;
+
+    for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        values[i] = Bench_Rand();
+    }
+    for (uint8_t ipdu = 0; ipdu < COM_NUM_TX_IPDUS; ipdu++) {
+        uint32_t all = Bench_AllDirty(ipdu);
+        t0 = Bench_HostNow();
+        for (uint32_t n = 0; n < BENCH_LOOPS; n++) {
+            values[0] = n;
+            Bench_WalkPack(ipdu, data, values, all);
+        }
+        walkPack += Bench_HostNow() - t0;
+        t0 = Bench_HostNow();
+        for (uint32_t n = 0; n < BENCH_LOOPS; n++) {
+            values[0] = n;
+            Com_PackFunctions[ipdu](data, values, all);
+        }
+        genPack += Bench_HostNow() - t0;
+        t0 = Bench_HostNow();
+        for (uint32_t n = 0; n < BENCH_LOOPS; n++) {
+            values[0] = n;
+            Com_PackFunctions[ipdu](data, values, all & (0u - all));
+        }
+        genOne += Bench_HostNow() - t0;
+    }
+    for (uint8_t ipdu = 0; ipdu < COM_NUM_RX_IPDUS; ipdu++) {
+        t0 = Bench_HostNow();
+        for (uint32_t n = 0; n < BENCH_LOOPS; n++) {
+            data[0] = (uint8_t)n;
+            Bench_WalkUnpack(ipdu, data, values);
+        }
+        walkUnpack += Bench_HostNow() - t0;
+        t0 = Bench_HostNow();
+        for (uint32_t n = 0; n < BENCH_LOOPS; n++) {
+            data[0] = (uint8_t)n;
+            Com_UnpackFunctions[ipdu](data, values);
+        }
+        genUnpack += Bench_HostNow() - t0;
+    }
+    printf("pack:         bit walker %6.1f ns, generated %5.1f ns, one dirty signal %5.1f ns per I-PDU (host)\n",
+           (double)walkPack / (BENCH_LOOPS * COM_NUM_TX_IPDUS), (double)genPack / (BENCH_LOOPS * COM_NUM_TX_IPDUS),
+           (double)genOne / (BENCH_LOOPS * COM_NUM_TX_IPDUS));
+    printf("unpack:       bit walker %6.1f ns, generated %5.1f ns per I-PDU (host)\n",
+           (double)walkUnpack / (BENCH_LOOPS * COM_NUM_RX_IPDUS), (double)genUnpack / (BENCH_LOOPS * COM_NUM_RX_IPDUS));
+}
+
+/* Frames of the other nodes */
+static HostSim_CanFrameType Bench_Can1Frames[] = {
+    { 0, 0x010, 8, { 0x34, 0x12, 0x01, 0, 0, 0, 0, 0xA5 } },       /* Brake: 0x1234, pedal, 5, 10 */
+    { 0, 0x020, 8, { 0xFF, 0x38, 0x80, 0x7C, 0x01, 0, 0, 0 } },    /* Steering: -200, -2041 updated, 12 */
+    { 0, 0x2A0, 2, { 0x73, 0x01 } },                                /* Gear: 3 updated, 7 not */
+    { 0, 0x2B4, 8, { 1, 2, 3, 4, 5, 6, 7, 8 } },                    /* Not received by COM */
+    { 0, 0x010, 4, { 0xFF, 0xFF, 0, 0 } },                          /* Brake, too short: ignored */
+    { 0, 0x3E8, 7, { 0x78, 0x56, 0x34, 0x12, 0x03, 0x02, 0x01 } },  /* Odometer */
+};
+
+static HostSim_CanFrameType Bench_Can2Frames[] = {
+    { 0, HOSTSIM_CAN_EXTENDED | 0x0CF00400u, 8, { 0xF3, 0x7D, 0x82, 0x40, 0x1F, 0x00, 0x0A, 0x7E } },
+};
+
+static HostSim_CanFrameType Bench_Capture[2][64];
+
+static uint32_t Bench_Receive(Com_SignalIdType Signal)
+{
+    static const uint8_t sizes[] = { 1, 1, 2, 4, 1, 2, 4 };
+    uint8_t size = sizes[Com_RxSignalConfig[Signal].type];
+    uint32_t value = 0;
+
+    (void)Com_ReceiveSignal(Signal, &value);
+    /* Sign extended from the size of the type */
+    if (Com_RxSignalConfig[Signal].type >= COM_SINT8 && size < 4u && (value >> (8u * size - 1u)) != 0) {
+        value |= ~0u << (8u * size);
+    }
+    return value;
+}
+
+static uint32_t Bench_Can(void)
+{
+    uint32_t errors = 0;
+    uint8_t b8;
+    uint16_t b16;
+    uint32_t b32;
+
+    HostSim_Reset();
+    memset(Bench_Capture, 0, sizeof(Bench_Capture));
+    for (uint32_t c = 0; c < 2u; c++) {
+        HostSim_CanCapture[c].buffer = Bench_Capture[c];
+        HostSim_CanCapture[c].size = 64u;
+    }
+    HostSim_CanNode[0].frames = Bench_Can1Frames;
+    HostSim_CanNode[0].count = sizeof(Bench_Can1Frames) / sizeof(Bench_Can1Frames[0]);
+    HostSim_CanNode[1].frames = Bench_Can2Frames;
+    HostSim_CanNode[1].count = sizeof(Bench_Can2Frames) / sizeof(Bench_Can2Frames[0]);
+
+    errors += (Com_SendSignal(COM_SIG_ECU_STATE, &b8) != COM_SERVICE_NOT_AVAILABLE);
+    Can_Init(NULL);
+    Com_Init();
+    PduR_Init();
+    (void)Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START);
+    (void)Can_SetControllerMode(CAN_CONTROLLER_2, CAN_T_START);
+    errors += (Com_SendSignal(COM_NUM_TX_SIGNALS, &b8) != E_NOT_OK) + (Com_ReceiveSignal(COM_NUM_RX_SIGNALS, &b8) != E_NOT_OK);
+
+    /* Reception */
+    for (uint32_t ms = 0; ms < 10u; ms++) {
+        Can_MainFunction_Read();
+        HostSim_Idle(BENCH_MS);
+    }
+    Can_MainFunction_Read();
+    errors += (Bench_Receive(COM_SIG_BRAKE_PRESSURE) != 0x1234u) + (Bench_Receive(COM_SIG_BRAKE_PEDAL) != 1u);
+    errors += (Bench_Receive(COM_SIG_BRAKE_COUNTER) != 5u) + (Bench_Receive(COM_SIG_BRAKE_CHECKSUM) != 10u);
+    errors += (Bench_Receive(COM_SIG_STEERING_ANGLE) != (uint32_t)-200) + (Bench_Receive(COM_SIG_STEERING_RATE) != (uint32_t)-2041);
+    errors += (Bench_Receive(COM_SIG_STEERING_STATUS) != 12u);
+    errors += (Bench_Receive(COM_SIG_GEAR_POSITION) != 3u) + (Bench_Receive(COM_SIG_GEAR_TARGET) != 0);
+    errors += (Bench_Receive(COM_SIG_ODOMETER) != 0x12345678u) + (Bench_Receive(COM_SIG_TRIP) != 0x010203u);
+    errors += (Bench_Receive(COM_SIG_ENGINE_TORQUE_MODE) != 3u) + (Bench_Receive(COM_SIG_ENGINE_SPEED) != 0x1F40u);
+    errors += (Bench_Receive(COM_SIG_ENGINE_DEMAND_TORQUE) != 0x7Eu) + (Bench_Receive(COM_SIG_STARTER_MODE) != 0x0Au);
+
+    /* Transmission: the ADC frame once, the status frame every 10 calls, TSC1 every call */
+    b16 = 0x0ABC;
+    errors += (Com_SendSignal(COM_SIG_EXT_ADC_1, &b16) != E_OK);
+    b32 = 0x00123456u;
+    errors += (Com_SendSignal(COM_SIG_ECU_BOOT_COUNT, &b32) != E_OK);
+    b8 = 0xF6;      /* -10 */
+    errors += (Com_SendSignal(COM_SIG_ECU_TEMPERATURE, &b8) != E_OK);
+    b16 = 1500u * 8u;
+    errors += (Com_SendSignal(COM_SIG_TSC1_REQUESTED_SPEED, &b16) != E_OK);
+    for (uint32_t call = 0; call < BENCH_TX_CALLS; call++) {
+        Com_MainFunctionTx();
+        for (uint32_t ms = 0; ms < 5u; ms++) {
+            Can_MainFunction_Write();
+            HostSim_Idle(BENCH_MS);
+        }
+        if (call == 12u) {
+            b16 = 0x0ABC;   /* Unchanged: not sent again */
+            (void)Com_SendSignal(COM_SIG_EXT_ADC_1, &b16);
+        }
+    }
+
+    uint32_t adc = 0, status = 0, tsc1 = 0;
+    for (uint32_t i = 0; i < HostSim_CanCapture[0].length; i++) {
+        const HostSim_CanFrameType* f = &Bench_Capture[0][i];
+        if (f->id == 0x123u) {
+            errors += (f->dlc != 6u || f->data[2] != 0xBCu || f->data[3] != 0x0Au);
+            adc++;
+        } else if (f->id == 0x124u) {
+            /* Boot count big endian in bytes 4..6, its update bit in the first frame only */
+            errors += (f->dlc != 8u || f->data[3] != 0xF6u || f->data[4] != 0x12u || f->data[5] != 0x34u || f->data[6] != 0x56u);
+            errors += ((f->data[7] & 0x80u) != (status == 0 ? 0x80u : 0));
+            status++;
+        }
+    }
+    for (uint32_t i = 0; i < HostSim_CanCapture[1].length; i++) {
+        const HostSim_CanFrameType* f = &Bench_Capture[1][i];
+        errors += (f->id != (HOSTSIM_CAN_EXTENDED | 0x0C000017u) || f->data[1] != 0xE0u || f->data[2] != 0x2Eu);
+        tsc1++;
+    }
+    errors += (adc != 1u) + (status != BENCH_TX_CALLS / 10u) + (tsc1 != BENCH_TX_CALLS);
+    printf("CAN:          %u signals received, %u ADC, %u status and %u TSC1 frames sent in %u calls, %u errors\n",
+           (unsigned)COM_NUM_RX_SIGNALS, (unsigned)adc, (unsigned)status, (unsigned)tsc1, (unsigned)BENCH_TX_CALLS,
+           (unsigned)errors);
+    Com_DeInit();
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    errors += Bench_Layout();
+    Bench_Speed();
+    errors += Bench_Can();
+    return errors ? 1 : 0;
+}
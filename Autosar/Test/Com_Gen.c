@@ -0,0 +1,315 @@
+/*
+* File: Com_Gen.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Signal compiler of the COM module. Lays the signals of COM_RX_SIGNALS and
+* COM_TX_SIGNALS (Com_Cfg.h) out bit by bit, checks that they fit into their I-PDU without
+* overlapping, and writes one pack function per sent I-PDU and one unpack function per received
+* I-PDU as Com_Pack_Cfg.c:
+*   - a signal is split into the bytes it covers; in each byte it occupies contiguous bits at a
+*     fixed shift from the value, so a byte costs one shift and one mask, both constants;
+*   - a byte covered entirely is stored or loaded without a mask, which leaves byte-aligned
+*     signals as plain byte moves the compiler can merge;
+*   - the byte order and sign extension are resolved here, not at run time.
+* It also writes the dirty bit of each sent signal.
+*
+*   com_gen [Com_Pack_Cfg.c]    (standard output by default)
+*/
+
+#include "Com.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GEN_MAX_SIGNALS     32u         /* Per I-PDU, the width of the dirty bitmap */
+#define GEN_MAX_IPDUS       (COM_NUM_RX_IPDUS + COM_NUM_TX_IPDUS)
+
+typedef struct {
+    const char* name;
+    uint8_t ipdu;
+    uint8_t type;
+    uint16_t start;
+    uint8_t length;
+    uint8_t endian;
+    uint16_t update;
+} Gen_SignalType;
+
+typedef struct {
+    const char* name;
+    uint8_t length;
+} Gen_IpduType;
+
+/* Bits of a signal within one byte: value bit (byte bit + shift) for each bit of mask */
+typedef struct {
+    uint8_t byte;
+    uint8_t mask;
+    int8_t shift;
+} Gen_SegmentType;
+
+#define GEN_SIGNAL(name, ipdu, type, start, length, endian, update) \
+    { #name, (ipdu), (type), (start), (length), (endian), (update) },
+#define GEN_RX_IPDU(name, length)                   { #name, (length) },
+#define GEN_TX_IPDU(name, hth, id, length, period)  { #name, (length) },
+
+static const Gen_SignalType Gen_RxSignals[COM_NUM_RX_SIGNALS] = { COM_RX_SIGNALS(GEN_SIGNAL) };
+static const Gen_SignalType Gen_TxSignals[COM_NUM_TX_SIGNALS] = { COM_TX_SIGNALS(GEN_SIGNAL) };
+static const Gen_IpduType Gen_RxIpdus[COM_NUM_RX_IPDUS] = { COM_RX_IPDUS(GEN_RX_IPDU) };
+static const Gen_IpduType Gen_TxIpdus[COM_NUM_TX_IPDUS] = { COM_TX_IPDUS(GEN_TX_IPDU) };
+
+/* Bit of the I-PDU holding value bit Bit of a signal */
+static uint32_t Gen_Position(const Gen_SignalType* s, uint32_t Bit)
+{
+    uint32_t pos = s->start;
+
+    if (s->endian == COM_LITTLE_ENDIAN) {
+        return pos + Bit;
+    }
+    /* From the most significant bit down, on to bit 7 of the next byte */
+    for (uint32_t k = s->length - 1u; k > Bit; k--) {
+        pos = (pos % 8u == 0) ? pos + 15u : pos - 1u;
+    }
+    return pos;
+}
+
+/* Splits a signal into bytes, in order of the value bits; returns the number of segments */
+static uint32_t Gen_Segments(const Gen_SignalType* s, Gen_SegmentType* seg)
+{
+    uint32_t n = 0;
+
+    for (uint32_t bit = 0; bit < s->length; bit++) {
+        uint32_t pos = Gen_Position(s, bit);
+        uint32_t i;
+        for (i = 0; i < n && seg[i].byte != pos / 8u; i++) {
+        }
+        if (i == n) {
+            seg[n].byte = (uint8_t)(pos / 8u);
+            seg[n].mask = 0;
+            seg[n].shift = (int8_t)((int32_t)bit - (int32_t)(pos % 8u));
+            n++;
+        }
+        seg[i].mask |= (uint8_t)(1u << (pos % 8u));
+    }
+    return n;
+}
+
+static uint32_t Gen_TypeBits(uint8_t type)
+{
+    static const uint8_t bits[] = { 1, 8, 16, 32, 8, 16, 32 };
+    return (type < sizeof(bits)) ? bits[type] : 0;
+}
+
+/* Checks the signals of one direction; returns 0 if they are valid */
+static int Gen_Check(const Gen_SignalType* signals, uint32_t numSignals, const Gen_IpduType* ipdus, uint32_t numIpdus)
+{
+    uint64_t used[GEN_MAX_IPDUS] = { 0 };
+    uint32_t count[GEN_MAX_IPDUS] = { 0 };
+
+    for (uint32_t i = 0; i < numIpdus; i++) {
+        if (ipdus[i].length == 0 || ipdus[i].length > 8u) {
+            fprintf(stderr, "com_gen: %s: length not within 1 to 8 bytes\n", ipdus[i].name);
+            return 1;
+        }
+    }
+    for (uint32_t i = 0; i < numSignals; i++) {
+        const Gen_SignalType* s = &signals[i];
+        uint64_t bits = 0;
+
+        if (s->ipdu >= numIpdus || s->length == 0 || s->length > Gen_TypeBits(s->type) || s->endian > COM_BIG_ENDIAN ||
+            s->start >= 64u) {
+            fprintf(stderr, "com_gen: %s: invalid I-PDU, type, length, byte order or start bit\n", s->name);
+            return 1;
+        }
+        if (++count[s->ipdu] > GEN_MAX_SIGNALS) {
+            fprintf(stderr, "com_gen: %s: more than %u signals in %s\n", s->name, (unsigned)GEN_MAX_SIGNALS,
+                    ipdus[s->ipdu].name);
+            return 1;
+        }
+        for (uint32_t bit = 0; bit < s->length; bit++) {
+            uint32_t pos = Gen_Position(s, bit);
+            if (pos >= 8u * ipdus[s->ipdu].length) {
+                fprintf(stderr, "com_gen: %s: bit %u outside of %s\n", s->name, (unsigned)pos, ipdus[s->ipdu].name);
+                return 1;
+            }
+            bits |= (uint64_t)1 << pos;
+        }
+        if (s->update != COM_NO_UPDATE_BIT) {
+            if (s->update >= 8u * ipdus[s->ipdu].length) {
+                fprintf(stderr, "com_gen: %s: update bit outside of %s\n", s->name, ipdus[s->ipdu].name);
+                return 1;
+            }
+            bits |= (uint64_t)1 << s->update;
+        }
+        if (used[s->ipdu] & bits) {
+            fprintf(stderr, "com_gen: %s: overlaps another signal of %s\n", s->name, ipdus[s->ipdu].name);
+            return 1;
+        }
+        used[s->ipdu] |= bits;
+    }
+    return 0;
+}
+
+/* Name of an I-PDU without the prefix of its direction */
+static const char* Gen_Short(const char* name)
+{
+    const char* p = strstr(name, "_IPDU_");
+    return p ? p + 6 : name;
+}
+
+static void Gen_Shift(FILE* out, const char* value, int32_t shift)
+{
+    if (shift > 0) {
+        fprintf(out, "(%s >> %d)", value, (int)shift);
+    } else if (shift < 0) {
+        fprintf(out, "(%s << %d)", value, (int)-shift);
+    } else {
+        fprintf(out, "%s", value);
+    }
+}
+
+static void Gen_Pack(FILE* out, uint32_t ipdu)
+{
+    Gen_SegmentType seg[8];
+    uint8_t updates[8] = { 0 };
+    uint32_t k = 0;
+
+    for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+        if (Gen_TxSignals[i].ipdu == ipdu && Gen_TxSignals[i].update != COM_NO_UPDATE_BIT) {
+            updates[Gen_TxSignals[i].update / 8u] |= (uint8_t)(1u << (Gen_TxSignals[i].update % 8u));
+        }
+    }
+
+    fprintf(out, "static void Com_Pack_%s(uint8_t* Data, const uint32_t* Values, uint32_t Dirty) {\n", Gen_Short(Gen_TxIpdus[ipdu].name));
+    for (uint32_t b = 0; b < 8u; b++) {
+        if (updates[b] != 0) {
+            fprintf(out, "    Data[%u] &= 0x%02Xu;\n", (unsigned)b, (unsigned)(uint8_t)~updates[b]);
+        }
+    }
+    for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+        const Gen_SignalType* s = &Gen_TxSignals[i];
+        uint32_t n;
+
+        if (s->ipdu != ipdu) {
+            continue;
+        }
+        n = Gen_Segments(s, seg);
+        fprintf(out, "    if (Dirty & 0x%Xu) {\n"
+                     "        uint32_t v = Values[%s];\n", (unsigned)(1u << k), s->name);
+        for (uint32_t j = 0; j < n; j++) {
+            if (seg[j].mask == 0xFFu) {
+                fprintf(out, "        Data[%u] = (uint8_t)", (unsigned)seg[j].byte);
+                Gen_Shift(out, "v", seg[j].shift);
+                fprintf(out, ";\n");
+            } else {
+                fprintf(out, "        Data[%u] = (uint8_t)((Data[%u] & 0x%02Xu) | (", (unsigned)seg[j].byte,
+                        (unsigned)seg[j].byte, (unsigned)(uint8_t)~seg[j].mask);
+                Gen_Shift(out, "v", seg[j].shift);
+                fprintf(out, " & 0x%02Xu));\n", (unsigned)seg[j].mask);
+            }
+        }
+        if (s->update != COM_NO_UPDATE_BIT) {
+            fprintf(out, "        Data[%u] |= 0x%02Xu;\n", (unsigned)(s->update / 8u), (unsigned)(1u << (s->update % 8u)));
+        }
+        fprintf(out, "    }\n");
+        k++;
+    }
+    fprintf(out, "}\n\n");
+}
+
+static void Gen_Unpack(FILE* out, uint32_t ipdu)
+{
+    Gen_SegmentType seg[8];
+
+    fprintf(out, "static void Com_Unpack_%s(const uint8_t* Data, uint32_t* Values) {\n", Gen_Short(Gen_RxIpdus[ipdu].name));
+    for (uint32_t i = 0; i < COM_NUM_RX_SIGNALS; i++) {
+        const Gen_SignalType* s = &Gen_RxSignals[i];
+        const char* indent = "    ";
+        uint8_t sign = (s->type >= COM_SINT8) && s->length < 32u;
+        uint32_t n;
+
+        if (s->ipdu != ipdu) {
+            continue;
+        }
+        if (s->update != COM_NO_UPDATE_BIT) {
+            fprintf(out, "    if (Data[%u] & 0x%02Xu) {\n", (unsigned)(s->update / 8u), (unsigned)(1u << (s->update % 8u)));
+            indent = "        ";
+        }
+        n = Gen_Segments(s, seg);
+        fprintf(out, "%sValues[%s] = %s", indent, s->name, sign ? "((" : "");
+        for (uint32_t j = 0; j < n; j++) {
+            char byte[40];
+            if (seg[j].mask == 0xFFu) {
+                snprintf(byte, sizeof(byte), "(uint32_t)Data[%u]", (unsigned)seg[j].byte);
+            } else {
+                snprintf(byte, sizeof(byte), "(uint32_t)(Data[%u] & 0x%02Xu)", (unsigned)seg[j].byte, (unsigned)seg[j].mask);
+            }
+            fprintf(out, "%s", j ? " | " : "");
+            /* Shifted the other way: byte bit to value bit */
+            Gen_Shift(out, byte, -seg[j].shift);
+        }
+        if (sign) {
+            fprintf(out, ") ^ 0x%Xu) - 0x%Xu", (unsigned)(1u << (s->length - 1u)), (unsigned)(1u << (s->length - 1u)));
+        }
+        fprintf(out, ";\n");
+        if (s->update != COM_NO_UPDATE_BIT) {
+            fprintf(out, "    }\n");
+        }
+    }
+    fprintf(out, "}\n\n");
+}
+
+int main(int argc, char** argv)
+{
+    FILE* out = stdout;
+
+    if (Gen_Check(Gen_RxSignals, COM_NUM_RX_SIGNALS, Gen_RxIpdus, COM_NUM_RX_IPDUS) != 0 ||
+        Gen_Check(Gen_TxSignals, COM_NUM_TX_SIGNALS, Gen_TxIpdus, COM_NUM_TX_IPDUS) != 0) {
+        return 1;
+    }
+
+    if (argc > 1 && (out = fopen(argv[1], "w")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/*\n"
+                 "* File: Com_Pack_Cfg.c\n"
+                 "* Author: Tran Nhat Thai\n"
+                 "* Date: 29/02/2024\n"
+                 "* Description: Pack and unpack functions of the COM module, generated by Test/Com_Gen.c from the signal\n"
+                 "* lists of Com_Cfg.h. Do not edit: run \"make -C Test com\" instead.\n"
+                 "*/\n\n"
+                 "#include \"Com.h\"\n\n");
+
+    for (uint32_t i = 0; i < COM_NUM_TX_IPDUS; i++) {
+        Gen_Pack(out, i);
+    }
+    for (uint32_t i = 0; i < COM_NUM_RX_IPDUS; i++) {
+        Gen_Unpack(out, i);
+    }
+
+    fprintf(out, "const Com_PackFunctionType Com_PackFunctions[COM_NUM_TX_IPDUS] = {\n");
+    for (uint32_t i = 0; i < COM_NUM_TX_IPDUS; i++) {
+        fprintf(out, "    Com_Pack_%s,\n", Gen_Short(Gen_TxIpdus[i].name));
+    }
+    fprintf(out, "};\n\n"
+                 "const Com_UnpackFunctionType Com_UnpackFunctions[COM_NUM_RX_IPDUS] = {\n");
+    for (uint32_t i = 0; i < COM_NUM_RX_IPDUS; i++) {
+        fprintf(out, "    Com_Unpack_%s,\n", Gen_Short(Gen_RxIpdus[i].name));
+    }
+    fprintf(out, "};\n\n"
+                 "// Bit of each sent signal in the dirty bitmap of its I-PDU\n"
+                 "const uint32_t Com_TxSignalMask[COM_NUM_TX_SIGNALS] = {\n");
+    for (uint32_t i = 0; i < COM_NUM_TX_SIGNALS; i++) {
+        uint32_t k = 0;
+        for (uint32_t j = 0; j < i; j++) {
+            k += Gen_TxSignals[j].ipdu == Gen_TxSignals[i].ipdu;
+        }
+        fprintf(out, "    0x%08Xu,   /* %s */\n", (unsigned)(1u << k), Gen_TxSignals[i].name);
+    }
+    fprintf(out, "};\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
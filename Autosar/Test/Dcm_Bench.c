@@ -0,0 +1,513 @@
+/*
+* File: Dcm_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the DCM module with a tester on CAN1 (1 Mbit/s) that answers every
+* frame of the ECU within 20 us and sends the next request as soon as a response arrives, as a
+* flashing tool does. The main functions of the CAN, FLS, FEE, NVM and DCM modules run every
+* GPT_COM_CYCLE_MS (1 ms), as on the ECU.
+*   - WriteDataByIdentifier of the calibration, read back, and the NVM block written.
+*   - Negative responses: unsupported service, physical and functional, and TransferData without
+*     a download.
+*   - Download of a 128 kB image into sector 5 with blocks of DCM_MAX_BLOCK_LENGTH, one buffer
+*     (each block programmed before its response) against two (the next block received while the
+*     previous one is programmed): time, throughput and response pending sent. The flash is
+*     compared with the image. RequestDownload is answered by a response pending, then by its
+*     positive response once the download area is erased.
+*   - A block failing on a write-protected sector while a FEE write waits behind it in the FLS
+*     queue: the download fails, the FEE write does not.
+*
+*   dcm_bench
+*/
+
+#include "PduR.h"
+#include "Dcm.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_CAN1              0u          /* Index of CAN1 in the model */
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_US                (HOSTSIM_CORE_CLOCK_HZ / 1000000u)
+#define BENCH_ECU_PERIOD        (GPT_COM_CYCLE_MS * BENCH_MS)  /* Main functions on the ECU */
+#define BENCH_STEP              (20u * BENCH_US)    /* Reaction time of the tester */
+#define BENCH_TIMEOUT           (5000u * BENCH_MS)  /* Of one request */
+#define BENCH_SILENCE           (100u * BENCH_MS)   /* Wait of a request without response */
+#define BENCH_MAX_FRAMES        32768u
+#define BENCH_IMAGE             DCM_DOWNLOAD_SIZE
+#define BENCH_PHYSICAL_ID       0x7E0u
+#define BENCH_FUNCTIONAL_ID     0x7DFu
+#define BENCH_ECU_ID            0x7E8u
+#define BENCH_PADDING           0xCCu
+
+/* RAM blocks of NvM_Cfg.c; the boot counter and the calibration are data identifiers */
+uint32_t App_BootCount;
+uint8_t App_Calibration[64];
+uint8_t App_Dtc[128];
+
+static HostSim_CanFrameType Bench_NodeFrames[BENCH_MAX_FRAMES];
+static HostSim_CanFrameType Bench_Capture[BENCH_MAX_FRAMES];
+
+static uint8_t Bench_Image[BENCH_IMAGE];
+static uint8_t Bench_Request[DCM_MAX_BLOCK_LENGTH];
+
+/* Tester */
+static struct {
+    uint32_t seen;                          /* Frames of the ECU handled */
+    const uint8_t* request;
+    uint32_t length;
+    uint32_t sent;                          /* Bytes of the request written to the bus */
+    uint8_t txSn;
+    uint8_t waitFc;                         /* Flow control frame of the ECU awaited */
+    uint8_t response[DCM_MAX_RESPONSE_LENGTH];
+    uint32_t responseLength;
+    uint32_t received;
+    uint8_t rxSn;
+    uint8_t done;                           /* Final response received, or request refused */
+    uint32_t pending;                       /* Response pending received */
+    uint32_t refused;                       /* Overflow flow control frames of the ECU */
+    uint32_t errors;                        /* Frames of the ECU out of sequence or unexpected */
+} Bench_Tester;
+
+static uint64_t Bench_NextMain;             /* Next period of the main loop */
+
+/* Notifications of Fls_Cfg.c, Fee_Cfg.c and NvM_Cfg.c */
+void FlsJob_EndNotification(uint8_t User)
+{
+}
+
+void FlsJob_ErrorNotification(uint8_t User)
+{
+}
+
+void FeeJob_EndNotification(void)
+{
+}
+
+void FeeJob_ErrorNotification(void)
+{
+}
+
+void NvMJob_MultiBlockNotification(void)
+{
+}
+
+static void Bench_TesterWrite(uint32_t Id, const uint8_t* Frame)
+{
+    HostSim_CanFrameType* frame = &Bench_NodeFrames[HostSim_CanNode[BENCH_CAN1].count];
+
+    frame->at = HostSim_Cycles;
+    frame->id = Id;
+    frame->dlc = 8;
+    memcpy(frame->data, Frame, 8);
+    HostSim_CanNode[BENCH_CAN1].count++;
+}
+
+/* Consecutive frames of the request up to the end of the block or of the request */
+static void Bench_TesterBlock(uint8_t Bs)
+{
+    uint32_t count = 0;
+
+    while (Bench_Tester.sent < Bench_Tester.length && (Bs == 0 || count < Bs)) {
+        uint8_t frame[8];
+        uint32_t n = Bench_Tester.length - Bench_Tester.sent;
+        if (n > 7u) {
+            n = 7u;
+        }
+        memset(frame, BENCH_PADDING, sizeof(frame));
+        frame[0] = 0x20u | Bench_Tester.txSn;
+        memcpy(&frame[1], &Bench_Tester.request[Bench_Tester.sent], n);
+        Bench_TesterWrite(BENCH_PHYSICAL_ID, frame);
+        Bench_Tester.sent += n;
+        Bench_Tester.txSn = (Bench_Tester.txSn + 1u) & 0x0Fu;
+        count++;
+    }
+    Bench_Tester.waitFc = (Bench_Tester.sent < Bench_Tester.length);
+}
+
+/* A response complete: a response pending keeps the tester waiting for the final one */
+static void Bench_TesterResponse(void)
+{
+    if (Bench_Tester.responseLength == 3u && Bench_Tester.response[0] == 0x7Fu && Bench_Tester.response[2] == 0x78u) {
+        Bench_Tester.pending++;
+    } else {
+        Bench_Tester.done = 1;
+    }
+}
+
+/* Tester: answers the frames of the ECU captured since the last call */
+static void Bench_TesterPoll(void)
+{
+    while (Bench_Tester.seen < HostSim_CanCapture[BENCH_CAN1].length) {
+        const HostSim_CanFrameType* frame = &Bench_Capture[Bench_Tester.seen++];
+        const uint8_t* data = frame->data;
+        uint8_t fc[8];
+        uint32_t n;
+
+        if (frame->id != BENCH_ECU_ID || frame->dlc != 8u) {
+            Bench_Tester.errors++;
+            continue;
+        }
+        switch (data[0] & 0xF0u) {
+        case 0x00u:
+            Bench_Tester.responseLength = data[0] & 0x0Fu;
+            memcpy(Bench_Tester.response, &data[1], 7);
+            Bench_TesterResponse();
+            break;
+        case 0x10u:
+            Bench_Tester.responseLength = ((uint32_t)(data[0] & 0x0Fu) << 8) | data[1];
+            if (Bench_Tester.responseLength > sizeof(Bench_Tester.response)) {
+                Bench_Tester.errors++;
+                Bench_Tester.responseLength = 0;
+                break;
+            }
+            memcpy(Bench_Tester.response, &data[2], 6);
+            Bench_Tester.received = 6;
+            Bench_Tester.rxSn = 1;
+            memset(fc, BENCH_PADDING, sizeof(fc));
+            fc[0] = 0x30u;
+            fc[1] = 0;
+            fc[2] = 0;
+            Bench_TesterWrite(BENCH_PHYSICAL_ID, fc);
+            break;
+        case 0x20u:
+            if ((data[0] & 0x0Fu) != Bench_Tester.rxSn || Bench_Tester.received >= Bench_Tester.responseLength) {
+                Bench_Tester.errors++;
+                break;
+            }
+            n = Bench_Tester.responseLength - Bench_Tester.received;
+            if (n > 7u) {
+                n = 7u;
+            }
+            memcpy(&Bench_Tester.response[Bench_Tester.received], &data[1], n);
+            Bench_Tester.received += n;
+            Bench_Tester.rxSn = (Bench_Tester.rxSn + 1u) & 0x0Fu;
+            if (Bench_Tester.received == Bench_Tester.responseLength) {
+                Bench_TesterResponse();
+            }
+            break;
+        case 0x30u:
+            if (!Bench_Tester.waitFc) {
+                Bench_Tester.errors++;
+            } else if ((data[0] & 0x0Fu) == 0u) {
+                /* The ECU asks for STmin 0 */
+                Bench_TesterBlock(data[1]);
+            } else if ((data[0] & 0x0Fu) == 2u) {
+                Bench_Tester.waitFc = 0;
+                Bench_Tester.refused++;
+                Bench_Tester.done = 1;
+            }
+            break;
+        default:
+            Bench_Tester.errors++;
+            break;
+        }
+    }
+}
+
+/* Starts a request of the tester */
+static void Bench_TesterRequest(uint32_t Id, const uint8_t* Request, uint32_t Length)
+{
+    uint8_t frame[8];
+
+    Bench_Tester.request = Request;
+    Bench_Tester.length = Length;
+    Bench_Tester.responseLength = 0;
+    Bench_Tester.done = 0;
+    memset(frame, BENCH_PADDING, sizeof(frame));
+    if (Length <= 7u) {
+        frame[0] = (uint8_t)Length;
+        memcpy(&frame[1], Request, Length);
+        Bench_Tester.sent = Length;
+        Bench_Tester.waitFc = 0;
+    } else {
+        frame[0] = 0x10u | (uint8_t)(Length >> 8);
+        frame[1] = (uint8_t)Length;
+        memcpy(&frame[2], Request, 6);
+        Bench_Tester.sent = 6;
+        Bench_Tester.txSn = 1;
+        Bench_Tester.waitFc = 1;
+    }
+    Bench_TesterWrite(Id, frame);
+}
+
+/* Main functions of one period of the main loop */
+static void Bench_MainFunctions(void)
+{
+    Can_MainFunction_Write();
+    Can_MainFunction_Read();
+    Fls_MainFunction();
+    Fee_MainFunction();
+    NvM_MainFunction();
+    Dcm_MainFunction();
+}
+
+/* One reaction time of the tester, and the main loop when its period is due */
+static void Bench_Step(void)
+{
+    HostSim_Idle(BENCH_STEP);
+    Bench_TesterPoll();
+    if (HostSim_Cycles >= Bench_NextMain) {
+        Bench_NextMain = HostSim_Cycles + BENCH_ECU_PERIOD;
+        Bench_MainFunctions();
+    }
+}
+
+/* Runs the tester and the main loop until the final response or Timeout; returns 1 if it came */
+static uint8_t Bench_Run(uint64_t Timeout)
+{
+    uint64_t start = HostSim_Cycles;
+
+    while (!Bench_Tester.done && HostSim_Cycles - start < Timeout) {
+        Bench_Step();
+    }
+    return Bench_Tester.done;
+}
+
+/* Physical request; returns 0 if the response is Expected */
+static uint32_t Bench_Exchange(const uint8_t* Request, uint32_t Length, const uint8_t* Expected,
+                               uint32_t ExpectedLength, const char* name)
+{
+    Bench_TesterRequest(BENCH_PHYSICAL_ID, Request, Length);
+    if (!Bench_Run(BENCH_TIMEOUT) || Bench_Tester.refused != 0 || Bench_Tester.responseLength != ExpectedLength ||
+        memcmp(Bench_Tester.response, Expected, ExpectedLength) != 0) {
+        printf("%-32s response of %u bytes %02X %02X %02X  FAILED\n", name, (unsigned)Bench_Tester.responseLength,
+               Bench_Tester.response[0], Bench_Tester.response[1], Bench_Tester.response[2]);
+        return 1;
+    }
+    printf("%-32s %02X %02X %02X\n", name, Bench_Tester.response[0], Bench_Tester.response[1],
+           ExpectedLength > 2u ? Bench_Tester.response[2] : 0u);
+    return 0;
+}
+
+/* Restarts the model and the modules; CanTp and the DCM module stop their timers before Gpt_Init
+   forgets them */
+static void Bench_Start(const Dcm_ConfigType* DcmConfig)
+{
+    CanTp_DeInit();
+    Dcm_DeInit();
+    HostSim_Reset();
+    memset(&Bench_Tester, 0, sizeof(Bench_Tester));
+    Bench_NextMain = 0;
+    HostSim_CanNode[BENCH_CAN1].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN1].count = 0;
+    HostSim_CanCapture[BENCH_CAN1].buffer = Bench_Capture;
+    HostSim_CanCapture[BENCH_CAN1].size = BENCH_MAX_FRAMES;
+
+    Gpt_Init(NULL);
+    Can_Init(NULL);
+    PduR_Init();
+    CanTp_Init(&Dcm_CanTpConfig);
+    Dcm_Init(DcmConfig);
+    Fls_Init(NULL);
+    Fee_Init(NULL);
+    NvM_Init(NULL);
+    (void)Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START);
+}
+
+/* Data identifiers and negative responses */
+static uint32_t Bench_Services(void)
+{
+    static const uint8_t readBoot[] = { 0x22u, 0x01u, 0x00u };
+    static const uint8_t bootResponse[] = { 0x62u, 0x01u, 0x00u, 0x2Au, 0x00u, 0x00u, 0x00u };
+    static const uint8_t readCalibration[] = { 0x22u, 0x01u, 0x01u };
+    static const uint8_t writeResponse[] = { 0x6Eu, 0x01u, 0x01u };
+    static const uint8_t writeBoot[] = { 0x2Eu, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u };
+    static const uint8_t outOfRange[] = { 0x7Fu, 0x2Eu, 0x31u };
+    static const uint8_t session[] = { 0x10u, 0x02u };
+    static const uint8_t notSupported[] = { 0x7Fu, 0x10u, 0x11u };
+    static const uint8_t transfer[] = { 0x36u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u };
+    static const uint8_t sequence[] = { 0x7Fu, 0x36u, 0x24u };
+    uint8_t write[3u + sizeof(App_Calibration)] = { 0x2Eu, 0x01u, 0x01u };
+    uint8_t readResponse[3u + sizeof(App_Calibration)] = { 0x62u, 0x01u, 0x01u };
+    NvM_RequestResultType result = NVM_REQ_PENDING;
+    uint32_t failed = 0;
+
+    Bench_Start(NULL);
+    App_BootCount = 42u;
+    for (uint32_t i = 0; i < sizeof(App_Calibration); i++) {
+        write[3u + i] = (uint8_t)(i * 7u + 3u);
+        readResponse[3u + i] = write[3u + i];
+    }
+    failed += Bench_Exchange(readBoot, sizeof(readBoot), bootResponse, sizeof(bootResponse), "read boot count:");
+    failed += Bench_Exchange(write, sizeof(write), writeResponse, sizeof(writeResponse), "write calibration:");
+    failed += Bench_Exchange(readCalibration, sizeof(readCalibration), readResponse, sizeof(readResponse),
+                             "read calibration:");
+    failed += Bench_Exchange(writeBoot, sizeof(writeBoot), outOfRange, sizeof(outOfRange), "write boot count:");
+    failed += Bench_Exchange(session, sizeof(session), notSupported, sizeof(notSupported), "session, physical:");
+    failed += Bench_Exchange(transfer, sizeof(transfer), sequence, sizeof(sequence), "transfer without download:");
+
+    /* A functional request of an unsupported service is not answered */
+    Bench_TesterRequest(BENCH_FUNCTIONAL_ID, session, sizeof(session));
+    if (Bench_Run(BENCH_SILENCE)) {
+        printf("%-32s answered  FAILED\n", "session, functional:");
+        failed++;
+    } else {
+        printf("%-32s no response\n", "session, functional:");
+    }
+
+    /* The calibration reaches the NVM */
+    for (uint64_t start = HostSim_Cycles; HostSim_Cycles - start < BENCH_TIMEOUT; HostSim_Idle(BENCH_ECU_PERIOD)) {
+        Bench_MainFunctions();
+        NvM_GetErrorStatus(NVM_BLOCK_CALIBRATION, &result);
+        if (result != NVM_REQ_PENDING) {
+            break;
+        }
+    }
+    printf("%-32s %s\n", "calibration block written:", result == NVM_REQ_OK ? "yes" : "no  FAILED");
+    failed += (result != NVM_REQ_OK);
+    failed += (Bench_Tester.errors != 0);
+    return failed;
+}
+
+/* Download of the image with Buffers buffers; returns 0 if the flash holds it */
+static uint32_t Bench_Download(uint8_t Buffers, const char* name)
+{
+    static const uint8_t exitResponse[] = { 0x77u };
+    Dcm_ConfigType config = Dcm_Config;
+    uint32_t address = FLASH_BASE + DCM_DOWNLOAD_ADDRESS;
+    uint8_t download[11] = { 0x34u, 0x00u, 0x44u,
+                             (uint8_t)(address >> 24), (uint8_t)(address >> 16), (uint8_t)(address >> 8), (uint8_t)address,
+                             (uint8_t)(BENCH_IMAGE >> 24), (uint8_t)(BENCH_IMAGE >> 16), (uint8_t)(BENCH_IMAGE >> 8),
+                             (uint8_t)BENCH_IMAGE };
+    uint8_t exitRequest[1] = { 0x37u };
+    uint32_t blockData;
+    uint32_t offset = 0;
+    uint8_t bsc = 1;
+    uint64_t start;
+    uint64_t cycles;
+    Dcm_StatsType stats;
+    uint8_t intact;
+
+    config.buffers = Buffers;
+    Bench_Start(&config);
+    memset(HostSim_FlashMemory + DCM_DOWNLOAD_ADDRESS, 0, BENCH_IMAGE);
+    start = HostSim_Cycles;
+
+    Bench_TesterRequest(BENCH_PHYSICAL_ID, download, sizeof(download));
+    if (!Bench_Run(BENCH_TIMEOUT) || Bench_Tester.responseLength != 4u || Bench_Tester.response[0] != 0x74u) {
+        printf("%-22s RequestDownload refused  FAILED\n", name);
+        return 1;
+    }
+    /* The CPU stalls during the erase: announced by a response pending, answered once it ended */
+    if (Bench_Tester.pending == 0 || HostSim_FlashMemory[DCM_DOWNLOAD_ADDRESS + BENCH_IMAGE - 1u] != 0xFFu) {
+        printf("%-22s RequestDownload answered before the erase  FAILED\n", name);
+        return 1;
+    }
+    blockData = (((uint32_t)Bench_Tester.response[2] << 8) | Bench_Tester.response[3]) - 2u;
+    while (offset < BENCH_IMAGE) {
+        uint32_t n = BENCH_IMAGE - offset;
+        if (n > blockData) {
+            n = blockData;
+        }
+        Bench_Request[0] = 0x36u;
+        Bench_Request[1] = bsc;
+        memcpy(&Bench_Request[2], &Bench_Image[offset], n);
+        Bench_TesterRequest(BENCH_PHYSICAL_ID, Bench_Request, n + 2u);
+        if (!Bench_Run(BENCH_TIMEOUT) || Bench_Tester.responseLength != 2u || Bench_Tester.response[0] != 0x76u ||
+            Bench_Tester.response[1] != bsc) {
+            printf("%-22s TransferData %u refused  FAILED\n", name, (unsigned)bsc);
+            return 1;
+        }
+        offset += n;
+        bsc++;
+    }
+    Bench_TesterRequest(BENCH_PHYSICAL_ID, exitRequest, sizeof(exitRequest));
+    if (!Bench_Run(BENCH_TIMEOUT) || Bench_Tester.responseLength != 1u ||
+        memcmp(Bench_Tester.response, exitResponse, sizeof(exitResponse)) != 0) {
+        printf("%-22s RequestTransferExit refused  FAILED\n", name);
+        return 1;
+    }
+    cycles = HostSim_Cycles - start;
+    (void)Dcm_GetStats(&stats);
+
+    intact = (memcmp(HostSim_FlashMemory + DCM_DOWNLOAD_ADDRESS, Bench_Image, BENCH_IMAGE) == 0);
+    printf("%-22s %7.1f ms, %5.1f kB/s, %2u blocks, %3u response pending, flash busy %4.1f %%%s\n", name,
+           (double)cycles / BENCH_MS, (double)BENCH_IMAGE * HOSTSIM_CORE_CLOCK_HZ / cycles / 1000.0,
+           (unsigned)stats.blocks, (unsigned)Bench_Tester.pending,
+           100.0 * HostSim_FlashStats.busyCycles / cycles,
+           (intact && Bench_Tester.errors == 0 && stats.programmingFailures == 0) ? "" : "  FAILED");
+    return (intact && Bench_Tester.errors == 0 && stats.programmingFailures == 0) ? 0u : 1u;
+}
+
+/* A block failing while a FEE write is queued behind it in the FLS driver: the download ends with
+   GeneralProgrammingFailure and the block is not counted, while the NVM block is still written */
+static uint32_t Bench_FailedBlock(void)
+{
+    static const uint8_t failure[] = { 0x7Fu, 0x36u, 0x72u };
+    Dcm_ConfigType config = Dcm_Config;
+    uint32_t address = FLASH_BASE + DCM_DOWNLOAD_ADDRESS;
+    uint8_t download[11] = { 0x34u, 0x00u, 0x44u,
+                             (uint8_t)(address >> 24), (uint8_t)(address >> 16), (uint8_t)(address >> 8), (uint8_t)address,
+                             (uint8_t)(BENCH_IMAGE >> 24), (uint8_t)(BENCH_IMAGE >> 16), (uint8_t)(BENCH_IMAGE >> 8),
+                             (uint8_t)BENCH_IMAGE };
+    NvM_RequestResultType result = NVM_REQ_PENDING;
+    uint32_t blockData = DCM_MAX_BLOCK_LENGTH - 2u;
+    uint8_t interleaved = 0;
+    uint8_t answered = 1;
+    Dcm_StatsType stats;
+    uint32_t errors;
+
+    /* One buffer: the response of a block waits for its programming */
+    config.buffers = 1;
+    Bench_Start(&config);
+    Bench_TesterRequest(BENCH_PHYSICAL_ID, download, sizeof(download));
+    answered &= Bench_Run(BENCH_TIMEOUT);
+    for (uint8_t bsc = 1; bsc <= 3u && answered; bsc++) {
+        Bench_Request[0] = 0x36u;
+        Bench_Request[1] = bsc;
+        memcpy(&Bench_Request[2], &Bench_Image[(bsc - 1u) * blockData], blockData);
+        Bench_TesterRequest(BENCH_PHYSICAL_ID, Bench_Request, blockData + 2u);
+        if (bsc == 3u) {
+            /* The block programming, the calibration queued behind it, then the sector protected */
+            while (!Bench_Tester.done && Fls_GetPendingJobs(FLS_USER_DCM) == 0) {
+                Bench_Step();
+            }
+            (void)NvM_WriteBlock(NVM_BLOCK_CALIBRATION, NULL);
+            while (Fls_GetPendingJobs(FLS_USER_DCM) != 0 && Fls_GetPendingJobs(FLS_USER_FEE) == 0) {
+                Bench_Step();
+            }
+            interleaved = (Fls_GetPendingJobs(FLS_USER_DCM) != 0 && Fls_GetPendingJobs(FLS_USER_FEE) != 0);
+            HostSim_FlashRegs.OPTCR &= ~(FLASH_OPTCR_nWRP_0 << 5u);
+        }
+        answered &= Bench_Run(BENCH_TIMEOUT);
+    }
+    for (uint64_t start = HostSim_Cycles; HostSim_Cycles - start < BENCH_TIMEOUT; HostSim_Idle(BENCH_ECU_PERIOD)) {
+        Bench_MainFunctions();
+        NvM_GetErrorStatus(NVM_BLOCK_CALIBRATION, &result);
+        if (result != NVM_REQ_PENDING) {
+            break;
+        }
+    }
+    (void)Dcm_GetStats(&stats);
+
+    errors = (!answered || !interleaved || Bench_Tester.responseLength != sizeof(failure) ||
+              memcmp(Bench_Tester.response, failure, sizeof(failure)) != 0);
+    errors += (result != NVM_REQ_OK || stats.blocks != 2u || stats.programmingFailures != 1u || Bench_Tester.errors != 0);
+    errors += (memcmp(HostSim_FlashMemory + DCM_DOWNLOAD_ADDRESS, Bench_Image, 2u * blockData) != 0);
+    printf("%-22s %02X %02X %02X, FEE write %s, %u blocks programmed, %u failed%s\n", "failed block 3:",
+           Bench_Tester.response[0], Bench_Tester.response[1], Bench_Tester.response[2],
+           (result == NVM_REQ_OK) ? "done" : "lost", (unsigned)stats.blocks, (unsigned)stats.programmingFailures,
+           errors ? "  FAILED" : "");
+    return errors ? 1u : 0u;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < BENCH_IMAGE; i++) {
+        Bench_Image[i] = (uint8_t)(i * 13u + (i >> 9));
+    }
+
+    printf("services of the tester on CAN1 at 1 Mbit/s:\n");
+    failed += Bench_Services();
+
+    printf("download of %u kB into sector 5, blocks of %u bytes:\n", (unsigned)(BENCH_IMAGE / 1024u),
+           (unsigned)DCM_MAX_BLOCK_LENGTH);
+    failed += Bench_Download(1, "one buffer:");
+    failed += Bench_Download(DCM_NUM_BUFFERS, "two buffers:");
+    failed += Bench_FailedBlock();
+    CanTp_DeInit();
+    Dcm_DeInit();
+    return failed ? 1 : 0;
+}
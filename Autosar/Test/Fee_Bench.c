@@ -0,0 +1,419 @@
+/*
+* File: Fee_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the FEE module over the FLS driver and the flash model of HostSim.c,
+* with 32 blocks of 8 to 256 bytes.
+*   - Endurance: 12000 writes of random blocks, each run to its end, the sectors of the log being
+*     collected and erased several times; the latency of the writes, the longest Fee_MainFunction
+*     and the content of all blocks, one of them invalidated early.
+*   - Reset: Fee_Init rebuilds the index from the log; the content is checked again. A read through
+*     the index is compared with a scan of the log for the latest record of the block.
+*   - Power loss: records cut in their header or their data by a reset, and a sector whose erase was
+*     cut, found by Fee_Init.
+*   - Shared queue: a download of a second FLS user holds three or all four jobs of the queue while
+*     the first record of a blank log is written; no erased gap is left for Fee_Init.
+*   - Jobs: argument checks, a second job while one is pending, a cancel and a wrong configuration.
+*
+*   fee_bench
+*/
+
+#include "Fee.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_TICK              (BENCH_MS / 10u)    /* Period of the main loop: 100 us */
+#define BENCH_BLOCKS            32u
+#define BENCH_WRITES            12000u
+#define BENCH_INVALIDATED       5u                  /* Block invalidated early and never written again */
+
+static Fee_BlockType Bench_Blocks[BENCH_BLOCKS];
+static Fee_ConfigType Bench_Config = { Bench_Blocks, BENCH_BLOCKS, NULL, NULL };
+
+/* Expected content of the blocks, size 0 if invalid */
+static uint8_t Bench_Shadow[BENCH_BLOCKS][FEE_MAX_BLOCK_SIZE];
+static uint16_t Bench_ShadowSize[BENCH_BLOCKS];
+static uint8_t Bench_Data[FEE_MAX_BLOCK_SIZE];
+static uint8_t Bench_Read[FEE_MAX_BLOCK_SIZE];
+
+/* Notifications of Fls_Cfg.c and Fee_Cfg.c */
+void FlsJob_EndNotification(uint8_t User)
+{
+}
+
+void FlsJob_ErrorNotification(uint8_t User)
+{
+}
+
+void FeeJob_EndNotification(void)
+{
+}
+
+void FeeJob_ErrorNotification(void)
+{
+}
+
+static uint32_t Bench_Random = 0x13579BDFu;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t Bench_LongestCall;      /* Host ns of the longest Fee_MainFunction */
+
+/* One period of the main loop */
+static void Bench_Tick(void)
+{
+    Fls_MainFunction();
+    uint64_t t0 = Bench_HostNow();
+    Fee_MainFunction();
+    uint64_t t = Bench_HostNow() - t0;
+    if (t > Bench_LongestCall) {
+        Bench_LongestCall = t;
+    }
+    HostSim_Idle(BENCH_TICK);
+}
+
+/* Runs the main loop until the job of the user ends; returns its result */
+static MemIf_JobResultType Bench_Wait(void)
+{
+    while (Fee_GetStatus() == MEMIF_BUSY) {
+        Bench_Tick();
+    }
+    return Fee_GetJobResult();
+}
+
+/* Runs the main loop until the module is idle */
+static void Bench_Settle(void)
+{
+    while (Fee_GetStatus() != MEMIF_IDLE) {
+        Bench_Tick();
+    }
+}
+
+/* Simulated reset: the flash keeps its content */
+static void Bench_Reboot(void)
+{
+    HostSim_Reset();
+    Fls_Init(NULL);
+    Fee_Init(&Bench_Config);
+}
+
+static uint32_t Bench_WriteBlock(uint32_t Block)
+{
+    for (uint32_t i = 0; i < Bench_Blocks[Block].blockSize; i++) {
+        Bench_Data[i] = (uint8_t)Bench_Rand();
+    }
+    if (Fee_Write(Bench_Blocks[Block].blockNumber, Bench_Data) != E_OK || Bench_Wait() != MEMIF_JOB_OK) {
+        return 1;
+    }
+    memcpy(Bench_Shadow[Block], Bench_Data, Bench_Blocks[Block].blockSize);
+    Bench_ShadowSize[Block] = Bench_Blocks[Block].blockSize;
+    return 0;
+}
+
+/* Reads a block and compares it with the expected content */
+static uint32_t Bench_CheckBlock(uint32_t Block)
+{
+    memset(Bench_Read, 0, sizeof(Bench_Read));
+    if (Fee_Read(Bench_Blocks[Block].blockNumber, 0, Bench_Read, Bench_Blocks[Block].blockSize) != E_OK) {
+        return 1;
+    }
+    MemIf_JobResultType result = Bench_Wait();
+    if (Bench_ShadowSize[Block] == 0) {
+        return result != MEMIF_BLOCK_INVALID;
+    }
+    return result != MEMIF_JOB_OK || memcmp(Bench_Read, Bench_Shadow[Block], Bench_ShadowSize[Block]) != 0;
+}
+
+static uint32_t Bench_CheckAll(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        errors += Bench_CheckBlock(i);
+    }
+    return errors;
+}
+
+/* The ad-hoc lookup: scans all sectors from the oldest one for the latest valid record of a block.
+   Returns the headers examined; *Record receives the address of the record, 0 if none */
+static uint32_t Bench_ScanLookup(uint16_t BlockNumber, uint32_t* Record)
+{
+    uint32_t sequence[FEE_NUM_SECTORS];
+    uint32_t headers = 0;
+    uint32_t last = 0;
+
+    *Record = 0;
+    for (uint32_t i = 0; i < FEE_NUM_SECTORS; i++) {
+        memcpy(&sequence[i], &HostSim_FlashMemory[Fee_SectorList[i].address + 4u], 4);
+    }
+    for (uint32_t n = 0; n < FEE_NUM_SECTORS; n++) {
+        /* Next sector in order of sequence */
+        uint32_t s = FEE_NUM_SECTORS;
+        for (uint32_t i = 0; i < FEE_NUM_SECTORS; i++) {
+            if (sequence[i] != 0xFFFFFFFFu && (n == 0 || sequence[i] > last) && (s == FEE_NUM_SECTORS || sequence[i] < sequence[s])) {
+                s = i;
+            }
+        }
+        if (s == FEE_NUM_SECTORS) {
+            break;
+        }
+        last = sequence[s];
+        for (uint32_t offset = 8; offset + 8u <= Fee_SectorList[s].size;) {
+            uint16_t header[4];
+            memcpy(header, &HostSim_FlashMemory[Fee_SectorList[s].address + offset], 8);
+            headers++;
+            if (header[0] == 0xFFFFu && header[1] == 0xFFFFu && header[2] == 0xFFFFu && header[3] == 0xFFFFu) {
+                break;
+            }
+            if (header[3] != (uint16_t)~(header[0] ^ header[1] ^ header[2])) {
+                offset += 8u;
+                continue;
+            }
+            if (header[0] == BlockNumber) {
+                *Record = Fee_SectorList[s].address + offset;
+            }
+            offset += 8u + (header[1] + 3u) / 4u * 4u;
+        }
+    }
+    return headers;
+}
+
+/* Writes random blocks through several collections of the log */
+static uint32_t Bench_Endurance(void)
+{
+    uint64_t latencySum = 0, latencyMax = 0;
+    uint32_t slow = 0;
+    uint32_t errors = 0;
+
+    memset(HostSim_FlashMemory, 0xFF, sizeof(HostSim_FlashMemory));
+    Bench_Reboot();
+    errors += (Fee_GetStatus() != MEMIF_IDLE);
+    Bench_LongestCall = 0;
+    for (uint32_t n = 0; n < BENCH_WRITES; n++) {
+        uint32_t block = Bench_Rand() % BENCH_BLOCKS;
+        if (n == 100) {
+            errors += (Fee_InvalidateBlock(Bench_Blocks[BENCH_INVALIDATED].blockNumber) != E_OK || Bench_Wait() != MEMIF_JOB_OK);
+            Bench_ShadowSize[BENCH_INVALIDATED] = 0;
+        }
+        if (n >= 100 && block == BENCH_INVALIDATED) {
+            block++;
+        }
+        uint64_t start = HostSim_Cycles;
+        errors += Bench_WriteBlock(block);
+        uint64_t latency = HostSim_Cycles - start;
+        latencySum += latency;
+        if (latency > latencyMax) {
+            latencyMax = latency;
+        }
+        slow += (latency > 10u * BENCH_MS);
+        if (n % 500u == 499u) {
+            errors += Bench_CheckBlock(Bench_Rand() % BENCH_BLOCKS);
+        }
+    }
+    Bench_Settle();
+    errors += Bench_CheckAll();
+    printf("endurance:     %u writes, %u erases, %u units, write latency mean %.2f ms max %.1f ms, %u over 10 ms, "
+           "longest Fee_MainFunction %.1f us (host), %u errors\n",
+           (unsigned)BENCH_WRITES, (unsigned)HostSim_FlashStats.erases, (unsigned)HostSim_FlashStats.programs,
+           (double)latencySum / BENCH_WRITES / BENCH_MS, (double)latencyMax / BENCH_MS, (unsigned)slow,
+           Bench_LongestCall / 1000.0, (unsigned)errors);
+    return errors;
+}
+
+/* Rebuilds the index after a reset and compares the reads with a scan of the log */
+static uint32_t Bench_Reset(void)
+{
+    uint32_t errors = 0;
+    uint64_t host = 0, scanHost = 0;
+    uint64_t headers = 0;
+    uint32_t record;
+
+    uint64_t t0 = Bench_HostNow();
+    Bench_Reboot();
+    uint64_t initNs = Bench_HostNow() - t0;
+    errors += (Fee_GetStatus() == MEMIF_UNINIT);
+    errors += Bench_CheckAll();
+
+    for (uint32_t n = 0; n < 1000u; n++) {
+        uint32_t block = Bench_Rand() % BENCH_BLOCKS;
+        if (block == BENCH_INVALIDATED) {
+            continue;
+        }
+        t0 = Bench_HostNow();
+        errors += (Fee_Read(Bench_Blocks[block].blockNumber, 0, Bench_Read, Bench_Blocks[block].blockSize) != E_OK);
+        while (Fee_GetStatus() == MEMIF_BUSY) {
+            Fls_MainFunction();
+            Fee_MainFunction();
+        }
+        host += Bench_HostNow() - t0;
+        errors += (memcmp(Bench_Read, Bench_Shadow[block], Bench_Blocks[block].blockSize) != 0);
+
+        t0 = Bench_HostNow();
+        headers += Bench_ScanLookup(Bench_Blocks[block].blockNumber, &record);
+        memcpy(Bench_Read, &HostSim_FlashMemory[record + 8u], Bench_Blocks[block].blockSize);
+        scanHost += Bench_HostNow() - t0;
+        errors += (record == 0 || memcmp(Bench_Read, Bench_Shadow[block], Bench_Blocks[block].blockSize) != 0);
+    }
+    printf("reset:         Fee_Init %.1f us (host), read by index %.2f us, by scan %.2f us and %.0f headers (host), "
+           "%u errors\n", initNs / 1000.0, host / 1000.0 / 1000.0, scanHost / 1000.0 / 1000.0,
+           (double)headers / 1000.0, (unsigned)errors);
+    return errors;
+}
+
+/* Runs a write until the flash has programmed a number of units, then resets the device */
+static void Bench_CutWrite(uint32_t Block, uint32_t Units)
+{
+    for (uint32_t i = 0; i < Bench_Blocks[Block].blockSize; i++) {
+        Bench_Data[i] = (uint8_t)Bench_Rand();
+    }
+    Fee_Write(Bench_Blocks[Block].blockNumber, Bench_Data);
+    uint32_t target = HostSim_FlashStats.programs + Units;
+    while (HostSim_FlashStats.programs < target) {
+        Fls_MainFunction();
+        Fee_MainFunction();
+        HostSim_Idle(100u);
+    }
+    Bench_Reboot();
+}
+
+static uint32_t Bench_PowerLoss(void)
+{
+    uint32_t errors = 0;
+    uint32_t block = 20u;
+
+    /* Data cut after the header and one word */
+    Bench_CutWrite(block, 3u);
+    errors += Bench_CheckAll();
+    errors += Bench_WriteBlock(block) + Bench_CheckBlock(block);
+
+    /* Header cut after its first word */
+    Bench_CutWrite(block, 1u);
+    errors += Bench_CheckAll();
+    errors += Bench_WriteBlock(block) + Bench_WriteBlock(block + 1u);
+    Bench_Reboot();
+    errors += Bench_CheckAll();
+
+    /* Erase of a sector cut by a reset: it has no header but is not erased */
+    Bench_Settle();
+    uint32_t sector = FEE_NUM_SECTORS;
+    for (uint32_t i = 0; i < FEE_NUM_SECTORS; i++) {
+        if (HostSim_FlashMemory[Fee_SectorList[i].address] == 0xFF) {
+            sector = i;
+        }
+    }
+    errors += (sector == FEE_NUM_SECTORS);
+    if (sector != FEE_NUM_SECTORS) {
+        HostSim_FlashMemory[Fee_SectorList[sector].address + 0x1000u] = 0x5A;
+        Bench_Reboot();
+        errors += (Fee_GetStatus() != MEMIF_BUSY_INTERNAL);
+        uint32_t erases = HostSim_FlashStats.erases;
+        Bench_Settle();
+        errors += (HostSim_FlashStats.erases != erases + 1u);
+        errors += (HostSim_FlashMemory[Fee_SectorList[sector].address + 0x1000u] != 0xFF);
+        errors += Bench_CheckAll();
+    }
+    printf("power loss:    %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+/* Queues a download of the second user of the FLS driver: the erase of sector 5, then writes */
+static uint32_t Bench_Download(uint32_t Jobs)
+{
+    uint32_t errors = (Fls_Erase(FLS_USER_DCM, 0x20000u, 0x20000u) != E_OK);
+
+    for (uint32_t i = 1; i < Jobs; i++) {
+        errors += (Fls_Write(FLS_USER_DCM, 0x20000u + i * 64u, Bench_Data, 64u) != E_OK);
+    }
+    return errors;
+}
+
+static uint32_t Bench_SharedQueue(void)
+{
+    uint32_t errors = 0;
+
+    /* Blank log: the first record queues the header of its sector too */
+    Bench_Settle();
+    for (uint32_t i = 0; i < FEE_NUM_SECTORS; i++) {
+        memset(&HostSim_FlashMemory[Fee_SectorList[i].address], 0xFF, Fee_SectorList[i].size);
+    }
+    memset(Bench_ShadowSize, 0, sizeof(Bench_ShadowSize));
+    Bench_Reboot();
+
+    errors += Bench_Download(3u);
+    errors += Bench_WriteBlock(0);
+    errors += Bench_Download(FLS_JOB_QUEUE_SIZE) + Bench_WriteBlock(1u);
+    while (Fls_GetPendingJobs(FLS_USER_DCM) != 0) {
+        Bench_Tick();
+    }
+    errors += (Fls_GetJobResult(FLS_USER_DCM) != MEMIF_JOB_OK);
+    errors += (HostSim_FlashMemory[Fee_SectorList[0].address + 8u] == 0xFF);
+    Bench_Reboot();
+    errors += Bench_CheckAll();
+    printf("shared queue:  %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+static uint32_t Bench_Jobs(void)
+{
+    Fee_BlockType blocks[2] = { { 1u, 16u }, { 1u, 32u } };
+    Fee_ConfigType config = { blocks, 2u, NULL, NULL };
+    uint16_t number = Bench_Blocks[0].blockNumber;
+    uint32_t errors = 0;
+
+    Bench_Settle();
+    errors += (Fee_Read(0x7777u, 0, Bench_Read, 4) != E_NOT_OK);
+    errors += (Fee_Write(0x7777u, Bench_Data) != E_NOT_OK);
+    errors += (Fee_Read(number, 1u, Bench_Read, Bench_Blocks[0].blockSize) != E_NOT_OK);
+    errors += (Fee_Read(number, 0, NULL, 4) != E_NOT_OK);
+    errors += (Fee_Write(number, NULL) != E_NOT_OK);
+
+    /* One job at a time */
+    errors += (Fee_Read(number, 0, Bench_Read, 4) != E_OK);
+    errors += (Fee_Write(number, Bench_Data) != E_NOT_OK);
+    errors += (Fee_GetStatus() != MEMIF_BUSY || Fee_GetJobResult() != MEMIF_JOB_PENDING);
+    errors += (Bench_Wait() != MEMIF_JOB_OK);
+
+    /* Cancel before the job starts: the block keeps its content */
+    errors += (Fee_Write(number, Bench_Data) != E_OK);
+    Fee_Cancel();
+    errors += (Fee_GetJobResult() != MEMIF_JOB_CANCELED || Fee_GetStatus() != MEMIF_IDLE);
+    Bench_Settle();
+    errors += Bench_CheckBlock(0);
+
+    /* Block configured twice */
+    Fee_Init(&config);
+    errors += (Fee_GetStatus() != MEMIF_UNINIT || Fee_Read(1u, 0, Bench_Read, 4) != E_NOT_OK);
+    printf("jobs:          %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        Bench_Blocks[i].blockNumber = (uint16_t)(0x100u + i * 7u);
+        Bench_Blocks[i].blockSize = (uint16_t)(8u + (i * 37u) % (FEE_MAX_BLOCK_SIZE - 7u));
+    }
+    errors += Bench_Endurance();
+    errors += Bench_Reset();
+    errors += Bench_PowerLoss();
+    errors += Bench_SharedQueue();
+    errors += Bench_Jobs();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+* File: Fls_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the FLS driver against the flash model of HostSim.c. Each run
+* erases the three sectors of Fls_SectorList and programs 64 KB into the first one, the last
+* quarter of the data being 0xFF, while a main loop runs every millisecond.
+*   - Library: FLASH_EraseSector and FLASH_ProgramWord, which poll the flash: the loop stops for
+*     the whole of each operation.
+*   - Fls at x32 and x64, with the end-of-operation interrupt, then from Fls_MainFunction alone:
+*     the longest call of Fls_MainFunction, the CPU used and the duration of the jobs. The data and
+*     the erased sectors are compared with the expected content.
+*   - Jobs: argument checks, a full queue, a failed compare dropping the jobs after it, a cancel
+*     during an erase and an unsupported supply range.
+*
+*   fls_bench
+*/
+
+#include "Fls.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_DATA_SIZE         0x10000u    /* Bytes programmed, the last quarter left erased */
+#define BENCH_USER              FLS_USER_FEE    /* User of the jobs */
+#define BENCH_OTHER_USER        FLS_USER_DCM    /* User of a job among them */
+#define BENCH_MAX_CALL          (BENCH_MS / 20u)    /* Longest Fls_MainFunction accepted: 50 us */
+#define BENCH_MAX_POLL          (BENCH_MS * 3u / 10u)   /* Without interrupt, FLS_MAX_WRITE programmed: 300 us */
+
+static uint8_t Bench_Data[BENCH_DATA_SIZE];
+static uint8_t Bench_Read[BENCH_DATA_SIZE];
+
+/* Notifications of Fls_Cfg.c */
+static uint32_t Bench_EndCount;
+static uint32_t Bench_ErrorCount;
+static uint8_t Bench_ErrorUser;
+
+void FlsJob_EndNotification(uint8_t User)
+{
+    Bench_EndCount++;
+}
+
+void FlsJob_ErrorNotification(uint8_t User)
+{
+    Bench_ErrorUser = User;
+    Bench_ErrorCount++;
+}
+
+static uint32_t Bench_Random = 0x2468ACE1u;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+/* Core cycles used by the CPU since a snapshot: register accesses and interrupt entries */
+static uint64_t Bench_CpuCycles(uint64_t regs0, uint64_t irqs0)
+{
+    return (HostSim_RegAccesses - regs0) * HostSim_BusCycles + (HostSim_IrqCount - irqs0) * HostSim_IrqCycles;
+}
+
+/* Fresh device with random content in the sectors of the driver */
+static void Bench_Start(void)
+{
+    HostSim_Reset();
+    for (uint32_t i = 0; i < FLS_NUM_SECTORS; i++) {
+        for (uint32_t j = 0; j < Fls_SectorList[i].size; j++) {
+            HostSim_FlashMemory[Fls_SectorList[i].address + j] = (uint8_t)Bench_Rand();
+        }
+    }
+    Bench_EndCount = 0;
+    Bench_ErrorCount = 0;
+}
+
+/* Checks the content left by a run: the data at the start of the first sector, 0xFF elsewhere */
+static uint32_t Bench_Verify(void)
+{
+    uint32_t errors = (memcmp(&HostSim_FlashMemory[Fls_SectorList[0].address], Bench_Data, BENCH_DATA_SIZE) != 0);
+
+    for (uint32_t i = 0; i < FLS_NUM_SECTORS; i++) {
+        uint32_t from = (i == 0) ? BENCH_DATA_SIZE : 0;
+        for (uint32_t j = from; j < Fls_SectorList[i].size; j++) {
+            errors += (HostSim_FlashMemory[Fls_SectorList[i].address + j] != 0xFF);
+        }
+    }
+    return errors;
+}
+
+static void Bench_Print(const char* name, uint64_t cycles, uint64_t longest, double cpu, uint32_t errors)
+{
+    printf("%-20s %7.1f ms total, longest call %9.1f us, CPU %6.3f%%, %5u units, %u errors\n", name,
+           (double)cycles / BENCH_MS, (double)longest * 1000.0 / BENCH_MS, cpu,
+           (unsigned)HostSim_FlashStats.programs, (unsigned)errors);
+}
+
+/* The library: each call returns at the end of its operation */
+static uint32_t Bench_Library(void)
+{
+    static const uint16_t sectors[FLS_NUM_SECTORS] = { FLASH_Sector_5, FLASH_Sector_6, FLASH_Sector_7 };
+    uint64_t longest = 0;
+    uint32_t errors = 0;
+
+    Bench_Start();
+    uint64_t cycles0 = HostSim_Cycles, regs0 = HostSim_RegAccesses, irqs0 = HostSim_IrqCount;
+    FLASH_Unlock();
+    for (uint32_t i = 0; i < FLS_NUM_SECTORS; i++) {
+        uint64_t start = HostSim_Cycles;
+        errors += (FLASH_EraseSector(sectors[i], VoltageRange_3) != FLASH_COMPLETE);
+        if (HostSim_Cycles - start > longest) {
+            longest = HostSim_Cycles - start;
+        }
+    }
+    for (uint32_t offset = 0; offset < BENCH_DATA_SIZE; offset += 4u) {
+        uint32_t word;
+        memcpy(&word, &Bench_Data[offset], 4);
+        errors += (FLASH_ProgramWord(FLASH_BASE + Fls_SectorList[0].address + offset, word) != FLASH_COMPLETE);
+    }
+    FLASH_Lock();
+    uint64_t cycles = HostSim_Cycles - cycles0;
+    errors += Bench_Verify();
+    Bench_Print("library x32:", cycles, longest, 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)cycles, errors);
+    return errors;
+}
+
+/* The driver with a configuration, Fls_MainFunction called every millisecond */
+static uint32_t Bench_Driver(const char* name, uint8_t VoltageRange, uint8_t UseInterrupt)
+{
+    Fls_ConfigType config = Fls_Config;
+    uint64_t longest = 0;
+    uint32_t errors = 0;
+
+    config.voltageRange = VoltageRange;
+    config.useInterrupt = UseInterrupt;
+    Bench_Start();
+    Fls_Init(&config);
+    uint64_t cycles0 = HostSim_Cycles, regs0 = HostSim_RegAccesses, irqs0 = HostSim_IrqCount;
+    errors += (Fls_Erase(BENCH_USER, Fls_SectorList[0].address, FLS_NUM_SECTORS * Fls_SectorList[0].size) != E_OK);
+    errors += (Fls_Write(BENCH_USER, Fls_SectorList[0].address, Bench_Data, BENCH_DATA_SIZE) != E_OK);
+    errors += (Fls_Compare(BENCH_USER, Fls_SectorList[0].address, Bench_Data, BENCH_DATA_SIZE) != E_OK);
+    errors += (Fls_Read(BENCH_USER, Fls_SectorList[0].address, Bench_Read, BENCH_DATA_SIZE) != E_OK);
+    errors += (Fls_GetStatus() != MEMIF_BUSY || Fls_GetJobResult(BENCH_USER) != MEMIF_JOB_PENDING);
+    while (Fls_GetStatus() == MEMIF_BUSY) {
+        uint64_t start = HostSim_Cycles;
+        Fls_MainFunction();
+        if (HostSim_Cycles - start > longest) {
+            longest = HostSim_Cycles - start;
+        }
+        HostSim_Idle(BENCH_MS - (uint32_t)((HostSim_Cycles - cycles0) % BENCH_MS));
+    }
+    uint64_t cycles = HostSim_Cycles - cycles0;
+    double cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)cycles;
+    errors += (Fls_GetJobResult(BENCH_USER) != MEMIF_JOB_OK || Bench_EndCount != 4u || Bench_ErrorCount != 0);
+    errors += Bench_Verify() + (memcmp(Bench_Read, Bench_Data, BENCH_DATA_SIZE) != 0);
+    errors += (longest > (UseInterrupt ? BENCH_MAX_CALL : BENCH_MAX_POLL)) + (HostSim_FlashStats.stallCycles != 0);
+    /* The erased quarter of the data is skipped */
+    errors += (HostSim_FlashStats.programs != BENCH_DATA_SIZE * 3u / 4u / Fls_GetPageSize());
+    errors += ((HostSim_FlashRegs.CR & FLASH_CR_LOCK) == 0);
+    Bench_Print(name, cycles, longest, cpu, errors);
+    return errors;
+}
+
+/* Checks of the job API */
+static uint32_t Bench_Jobs(void)
+{
+    Fls_ConfigType config = Fls_Config;
+    Fls_AddressType base = Fls_SectorList[0].address;
+    Fls_LengthType size = Fls_SectorList[0].size;
+    uint32_t errors = 0;
+
+    Bench_Start();
+    Fls_Init(NULL);
+    /* Erases cover whole configured sectors, writes whole units */
+    errors += (Fls_Erase(BENCH_USER, base + 4u, size) != E_NOT_OK);
+    errors += (Fls_Erase(BENCH_USER, base, size - 4u) != E_NOT_OK);
+    errors += (Fls_Erase(BENCH_USER, base - size, size) != E_NOT_OK);
+    errors += (Fls_Erase(BENCH_USER, base, 0) != E_NOT_OK);
+    errors += (Fls_Write(BENCH_USER, base + 2u, Bench_Data, 8) != E_NOT_OK);
+    errors += (Fls_Write(BENCH_USER, base, Bench_Data, 6) != E_NOT_OK);
+    errors += (Fls_Write(BENCH_USER, base, NULL, 8) != E_NOT_OK);
+    errors += (Fls_Read(BENCH_USER, base + FLS_NUM_SECTORS * size - 4u, Bench_Read, 8) != E_NOT_OK);
+    errors += (Fls_GetStatus() != MEMIF_IDLE);
+
+    /* A full queue; a failed compare drops the jobs of its user after it, not the read of the other user */
+    errors += (Fls_Erase(BENCH_USER, base, size) != E_OK);
+    errors += (Fls_Write(BENCH_USER, base, Bench_Data, 256) != E_OK);
+    memcpy(Bench_Read, Bench_Data, 256);
+    Bench_Read[255] ^= 1u;
+    errors += (Fls_Compare(BENCH_USER, base, Bench_Read, 256) != E_OK);
+    errors += (Fls_Read(BENCH_OTHER_USER, base, &Bench_Read[256], 256) != E_OK);
+    errors += (Fls_Read(BENCH_USER, base, &Bench_Read[512], 256) != E_NOT_OK);
+    memset(&Bench_Read[256], 0, 256);
+    while (Fls_GetStatus() == MEMIF_BUSY) {
+        Fls_MainFunction();
+        HostSim_Idle(BENCH_MS);
+    }
+    errors += (Fls_GetJobResult(BENCH_USER) != MEMIF_BLOCK_INCONSISTENT || Fls_GetJobResult(BENCH_OTHER_USER) != MEMIF_JOB_OK);
+    errors += (Bench_EndCount != 3u || Bench_ErrorCount != 1u || Bench_ErrorUser != BENCH_USER);
+    errors += (memcmp(&Bench_Read[256], Bench_Data, 256) != 0 || memcmp(&HostSim_FlashMemory[base], Bench_Data, 256) != 0);
+
+    /* A cancel during an erase: the next job waits for its end */
+    errors += (Fls_Erase(BENCH_USER, base + size, size) != E_OK);
+    Fls_MainFunction();
+    HostSim_Idle(100u * BENCH_MS);
+    Fls_Cancel(BENCH_USER);
+    errors += (Fls_GetJobResult(BENCH_USER) != MEMIF_JOB_CANCELED || Fls_GetStatus() != MEMIF_IDLE);
+    errors += (Fls_Write(BENCH_USER, base + size, Bench_Data, 8) != E_OK);
+    while (Fls_GetStatus() == MEMIF_BUSY) {
+        Fls_MainFunction();
+        HostSim_Idle(BENCH_MS);
+    }
+    errors += (Fls_GetJobResult(BENCH_USER) != MEMIF_JOB_OK || memcmp(&HostSim_FlashMemory[base + size], Bench_Data, 8) != 0);
+    errors += (HostSim_FlashStats.erases != 2u || HostSim_FlashStats.stallCycles != 0);
+
+    /* Bytes and half words are not supported */
+    config.voltageRange = VoltageRange_2;
+    Fls_Init(&config);
+    errors += (Fls_GetStatus() != MEMIF_UNINIT || Fls_Write(BENCH_USER, base, Bench_Data, 8) != E_NOT_OK);
+    printf("jobs:                %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < BENCH_DATA_SIZE; i++) {
+        Bench_Data[i] = (i < BENCH_DATA_SIZE * 3u / 4u) ? (uint8_t)Bench_Rand() : 0xFF;
+    }
+    errors += Bench_Library();
+    errors += Bench_Driver("Fls x32 interrupt:", VoltageRange_3, 1);
+    errors += Bench_Driver("Fls x64 interrupt:", VoltageRange_4, 1);
+    errors += Bench_Driver("Fls x32 main:", VoltageRange_3, 0);
+    errors += Bench_Driver("Fls x64 main:", VoltageRange_4, 0);
+    errors += Bench_Jobs();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,316 @@
+/*
+* File: Gpt_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the GPT driver against the timer model of HostSim.c.
+*   - Delay: the busy loop of main.c against Gpt_Delay, which sleeps until the compare interrupt.
+*   - Timers: thousands of one-shot software timers with durations from 1 us to 1 s, a quarter of
+*     them stopped again; each callback checks it is not early and records how late it is. The
+*     cost of a start is compared with the insertion into a sorted list.
+*   - Periodic: a thousand periodic timers run for one second; each must expire once per period.
+*   - Channels: the AUTOSAR channel API in one-shot and continuous mode.
+*
+*   gpt_bench
+*/
+
+#include "Gpt.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_TICKS_PER_US      (GPT_TICKS_PER_MS / 1000u)
+#define BENCH_MAX_TIMERS        8192u
+#define BENCH_MAX_DURATION      1000000u    /* Ticks, 1 s */
+#define BENCH_MAX_LATE          50u         /* Ticks a callback may run after its expiry */
+#define BENCH_PERIODIC_TIMERS   1000u
+#define BENCH_MAX_CPU           2.0         /* Percent of the core used by the periodic timers */
+
+static Gpt_TimerType Bench_Timers[BENCH_MAX_TIMERS];
+static uint32_t Bench_Expiry[BENCH_MAX_TIMERS];     /* Counter value at which a timer is due */
+static uint32_t Bench_Fired[BENCH_MAX_TIMERS];      /* Expiries seen by the callback */
+static uint32_t Bench_Period[BENCH_MAX_TIMERS];
+static uint8_t Bench_Stopped[BENCH_MAX_TIMERS];     /* Stopped before its expiry */
+static uint32_t Bench_Early;
+static uint32_t Bench_MaxLate;
+static uint32_t Bench_Expired;
+
+/* Sorted list, the usual structure of a software timer module, for comparison */
+typedef struct Bench_ListTag {
+    struct Bench_ListTag* next;
+    uint32_t expiry;
+} Bench_ListType;
+static Bench_ListType Bench_ListNodes[BENCH_MAX_TIMERS];
+
+static uint32_t Bench_Random = 0x2468ACE1u;
+
+/* Notifications of the channels of Bench_Channels */
+static uint32_t Bench_LedCount;
+static uint32_t Bench_MainCount;
+
+static void Gpt_Notification_Led(void)
+{
+    Bench_LedCount++;
+}
+
+static void Gpt_Notification_MainCycle(void)
+{
+    Bench_MainCount++;
+}
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Core cycles used by the CPU since a snapshot: register accesses and interrupt entries */
+static uint64_t Bench_CpuCycles(uint64_t regs0, uint64_t irqs0)
+{
+    return (HostSim_RegAccesses - regs0) * HostSim_BusCycles + (HostSim_IrqCount - irqs0) * HostSim_IrqCycles;
+}
+
+static uint32_t Bench_Counter(void)
+{
+    uint32_t now = 0;
+    Gpt_GetPredefTimerValue(&now);
+    return now;
+}
+
+/* Durations spread evenly over the powers of two up to 1 s */
+static uint32_t Bench_Duration(void)
+{
+    uint32_t bits = 1u + Bench_Rand() % 20u;
+    uint32_t value = 1u + Bench_Rand() % (1u << bits);
+    return (value > BENCH_MAX_DURATION) ? BENCH_MAX_DURATION : value;
+}
+
+static void Bench_Callback(void* Context)
+{
+    uint32_t i = (uint32_t)(uintptr_t)Context;
+    uint32_t now = Bench_Counter();
+    int32_t late = (int32_t)(now - Bench_Expiry[i]);
+
+    if (late < 0) {
+        Bench_Early++;
+    } else if ((uint32_t)late > Bench_MaxLate) {
+        Bench_MaxLate = (uint32_t)late;
+    }
+    Bench_Fired[i]++;
+    Bench_Expired++;
+    Bench_Expiry[i] += Bench_Period[i];
+}
+
+static void Bench_Start(void)
+{
+    HostSim_Reset();
+    Gpt_Init(NULL);
+    memset(Bench_Timers, 0, sizeof(Bench_Timers));
+    memset(Bench_Stopped, 0, sizeof(Bench_Stopped));
+    Bench_Early = 0;
+    Bench_MaxLate = 0;
+    Bench_Expired = 0;
+}
+
+/* Busy loop of main.c against Gpt_Delay, 10 ms each */
+static uint32_t Bench_Delay(void)
+{
+    uint64_t cycles0, regs0, irqs0;
+    uint32_t errors = 0;
+
+    Bench_Start();
+    cycles0 = HostSim_Cycles;
+    uint32_t start = Bench_Counter();
+    while (Bench_Counter() - start < GPT_MS(10)) {
+    }
+    printf("busy loop 10 ms:      CPU 100%%, %u register reads\n",
+           (unsigned)(HostSim_RegAccesses));
+
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    irqs0 = HostSim_IrqCount;
+    start = Bench_Counter();
+    Gpt_Delay(GPT_MS(10));
+    uint32_t waited = Bench_Counter() - start;
+    double cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    errors += (waited < GPT_MS(10) || waited > GPT_MS(10) + BENCH_MAX_LATE);
+    printf("Gpt_Delay 10 ms:      CPU %5.3f%%, %u irq, woke %u us after the deadline%s\n",
+           cpu, (unsigned)(HostSim_IrqCount - irqs0), (unsigned)((waited - GPT_MS(10)) / BENCH_TICKS_PER_US),
+           errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* Ns per insertion into a sorted list of Count timers with the durations of the wheel test */
+static double Bench_SortedList(uint32_t Count)
+{
+    Bench_ListType* head = NULL;
+    uint64_t t0 = Bench_HostNow();
+
+    for (uint32_t i = 0; i < Count; i++) {
+        Bench_ListType** link = &head;
+        Bench_ListNodes[i].expiry = Bench_Expiry[i];
+        while (*link != NULL && (int32_t)((*link)->expiry - Bench_ListNodes[i].expiry) <= 0) {
+            link = &(*link)->next;
+        }
+        Bench_ListNodes[i].next = *link;
+        *link = &Bench_ListNodes[i];
+    }
+    return (double)(Bench_HostNow() - t0) / Count;
+}
+
+/* Count one-shot timers, every fourth one stopped unless it has expired, run until the others have
+   expired */
+static uint32_t Bench_OneShot(uint32_t Count)
+{
+    Gpt_StatsType stats;
+    uint32_t errors = 0, stopped = 0;
+
+    Bench_Start();
+    uint64_t regs0 = HostSim_RegAccesses;
+    uint64_t host = 0;
+    for (uint32_t i = 0; i < Count; i++) {
+        uint32_t value = Bench_Duration();
+        Bench_Expiry[i] = Bench_Counter() + value;
+        Bench_Fired[i] = 0;
+        Bench_Period[i] = 0;
+        uint64_t t0 = Bench_HostNow();
+        errors += (Gpt_TimerStart(&Bench_Timers[i], value, 0, Bench_Callback, (void*)(uintptr_t)i) != E_OK);
+        host += Bench_HostNow() - t0;
+    }
+    double startRegs = (double)(HostSim_RegAccesses - regs0) / Count - 1.0;    /* Less Bench_Counter */
+    double startNs = (double)host / Count;
+
+    host = 0;
+    for (uint32_t i = 0; i < Count; i += 4) {
+        if (!Gpt_TimerIsRunning(&Bench_Timers[i])) {
+            continue;
+        }
+        uint64_t t0 = Bench_HostNow();
+        Gpt_TimerStop(&Bench_Timers[i]);
+        host += Bench_HostNow() - t0;
+        Bench_Stopped[i] = 1;
+        stopped++;
+    }
+    double stopNs = (double)host / stopped;
+
+    for (uint32_t ms = 0; ms <= BENCH_MAX_DURATION / GPT_MS(1) + 1u && Bench_Expired < Count - stopped; ms++) {
+        HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u);
+    }
+    for (uint32_t i = 0; i < Count; i++) {
+        errors += (Bench_Fired[i] != (Bench_Stopped[i] ? 0u : 1u));
+        errors += (Gpt_TimerIsRunning(&Bench_Timers[i]) != 0);
+    }
+    Gpt_GetStats(&stats);
+    errors += (Bench_Early != 0 || Bench_MaxLate > BENCH_MAX_LATE);
+    double listNs = Bench_SortedList(Count);
+    printf("%5u one-shot timers: start %5.1f ns %4.1f reg, stop %5.1f ns (host), sorted list insert %7.1f ns, "
+           "%u irq for %u expiries, %u cascades, max %u us late%s\n",
+           (unsigned)Count, startNs, startRegs, stopNs, listNs, (unsigned)stats.interrupts,
+           (unsigned)stats.expirations, (unsigned)stats.cascades, (unsigned)(Bench_MaxLate / BENCH_TICKS_PER_US),
+           errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* Periodic timers with periods of 1 to 100 ms for one second */
+static uint32_t Bench_Periodic(void)
+{
+    Gpt_StatsType stats;
+    uint32_t errors = 0;
+
+    Bench_Start();
+    for (uint32_t i = 0; i < BENCH_PERIODIC_TIMERS; i++) {
+        Bench_Period[i] = GPT_MS(1u + Bench_Rand() % 100u);
+        Bench_Expiry[i] = Bench_Counter() + Bench_Period[i];
+        Bench_Fired[i] = 0;
+        errors += (Gpt_TimerStart(&Bench_Timers[i], Bench_Period[i], Bench_Period[i], Bench_Callback,
+                                  (void*)(uintptr_t)i) != E_OK);
+    }
+    uint32_t start = Bench_Counter();
+    uint64_t cycles0 = HostSim_Cycles, regs0 = HostSim_RegAccesses, irqs0 = HostSim_IrqCount;
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ);
+    uint32_t elapsed = Bench_Counter() - start;
+    double cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    for (uint32_t i = 0; i < BENCH_PERIODIC_TIMERS; i++) {
+        /* Started up to a few ticks before the measured second */
+        uint32_t expected = elapsed / Bench_Period[i];
+        errors += (Bench_Fired[i] < expected || Bench_Fired[i] > expected + 1u);
+        Gpt_TimerStop(&Bench_Timers[i]);
+    }
+    Gpt_GetStats(&stats);
+    errors += (Bench_Early != 0 || Bench_MaxLate > BENCH_MAX_LATE || cpu > BENCH_MAX_CPU);
+    printf("%5u periodic timers: %u expiries in 1 s, %u irq, CPU %4.2f%%, max %u us late%s\n",
+           (unsigned)BENCH_PERIODIC_TIMERS, (unsigned)Bench_Expired, (unsigned)(HostSim_IrqCount - irqs0), cpu,
+           (unsigned)(Bench_MaxLate / BENCH_TICKS_PER_US), errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* One-shot and continuous channels with their notifications */
+static uint32_t Bench_Channels(void)
+{
+    static const Gpt_ChannelConfigType config[GPT_MAX_CHANNEL] = {
+        { GPT_CH_MODE_ONESHOT, Gpt_Notification_Led },
+        { GPT_CH_MODE_CONTINUOUS, Gpt_Notification_MainCycle },
+    };
+    uint32_t errors = 0;
+
+    HostSim_Reset();
+    Gpt_Init(config);
+    Bench_LedCount = 0;
+    Bench_MainCount = 0;
+    errors += (Gpt_GetTimeElapsed(0) != 0 || Gpt_GetTimeRemaining(0) != 0);
+    errors += (Gpt_StartTimer(0, GPT_MS(5)) != E_OK || Gpt_StartTimer(1, GPT_MS(1)) != E_OK);
+    errors += (Gpt_StartTimer(1, GPT_MS(1)) != E_NOT_OK);
+    errors += (Gpt_StartTimer(0, 0) != E_NOT_OK || Gpt_StartTimer(GPT_MAX_CHANNEL, 1) != E_NOT_OK);
+    Gpt_EnableNotification(0);
+    Gpt_EnableNotification(1);
+
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u * 2u + HOSTSIM_CORE_CLOCK_HZ / 2000u);   /* 2.5 ms */
+    Gpt_ValueType elapsed = Gpt_GetTimeElapsed(0);
+    Gpt_ValueType remaining = Gpt_GetTimeRemaining(0);
+    errors += (elapsed + remaining != GPT_MS(5) || elapsed < GPT_MS(2) || elapsed > GPT_MS(3));
+    elapsed = Gpt_GetTimeElapsed(1);
+    errors += (elapsed < GPT_MS(1) / 2u - BENCH_MAX_LATE || elapsed > GPT_MS(1) / 2u + BENCH_MAX_LATE);
+
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u * 5u);
+    errors += (Bench_LedCount != 1 || Gpt_GetTimeElapsed(0) != GPT_MS(5) || Gpt_GetTimeRemaining(0) != 0);
+    errors += (Bench_MainCount != 7);
+
+    /* The continuous channel keeps running without its notification */
+    Gpt_DisableNotification(1);
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u * 3u);
+    errors += (Bench_MainCount != 7 || Gpt_GetTimeRemaining(1) == 0);
+    errors += (Gpt_StopTimer(1) != E_OK || Gpt_StopTimer(1) != E_NOT_OK || Gpt_StopTimer(0) != E_NOT_OK);
+    elapsed = Gpt_GetTimeElapsed(1);
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u * 3u);
+    errors += (Gpt_GetTimeElapsed(1) != elapsed || elapsed > GPT_MS(1) || Gpt_GetTimeRemaining(1) != 0);
+
+    /* A one-shot channel restarts after its expiry */
+    errors += (Gpt_StartTimer(0, GPT_MS(1)) != E_OK);
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ / 1000u * 2u);
+    errors += (Bench_LedCount != 2);
+    printf("channels:             one-shot %u, continuous %u notifications%s\n", (unsigned)Bench_LedCount,
+           (unsigned)Bench_MainCount, errors ? "  FAILED" : "");
+    return errors;
+}
+
+int main(void)
+{
+    static const uint32_t counts[] = { 64, 1024, BENCH_MAX_TIMERS };
+    uint32_t errors = 0;
+
+    errors += Bench_Delay();
+    for (uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        errors += Bench_OneShot(counts[i]);
+    }
+    errors += Bench_Periodic();
+    errors += Bench_Channels();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,3379 @@
+/*
+* File: HostSim.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host implementation of the StdPeriph SPI, USART, DMA, CAN, ADC, RCC and NVIC functions used by
+* the drivers, and of the GPIO registers. Each SPI unit is modelled with a TX buffer, a shift register
+* and an RX buffer: a frame takes (data bits x baud rate divider x core/APB clock ratio) core
+* cycles, MISO is looped back to MOSI, and TXE/RXNE/BSY follow their events after the delays of
+* HostSim_SpiTiming. A USART transmitter shifts a frame in (frame bits x BRR x core/APB clock
+* ratio) core cycles and hands the bytes to HostSim_UsartCapture; in LIN mode it also sends breaks of
+* 13 bits and a delimiter, its receiver hears the bus, and a slave of HostSim_LinNode answers the
+* headers. DMA streams serve the SPI and USART requests of RM0090 without CPU cost. A CAN controller shares its bus with one other
+* node: frames take (frame bits x bit time) core cycles, the three TX mailboxes and the node compete
+* by identifier, received frames go through the filter banks into 3-deep FIFOs. An ADC converts
+* its regular sequence in ((sampling time + 12) x ADC prescaler x 2) core cycles, the inputs are read
+* from HostSim_AdcSignal, and in triple interleaved mode the three ADCs take turns on one channel
+* with pairs of results packed into CDR. DMA streams also serve the ADC requests and run in circular
+* mode with half-transfer flags. TIM1..TIM5 count up by one every (PSC + 1) timer clocks, TIM1 at the
+* core clock and TIM2..TIM5 at half of it, wrap at ARR and raise the compare and update flags on the
+* way; each update event loads the preloaded compare values and serves the DMA burst of the timer,
+* the stream writing DMAR into the registers selected by DCR. The flash interface programs a unit of
+* PSIZE bytes in 16 us and erases a sector in the typical time of DS8626 for its size and PSIZE; a
+* store into the memory during an operation stalls the CPU until it ends. GPIO outputs read back on IDR, the other pins read HostSim_GpioInput. The modelled clock advances by
+* HostSim_BusCycles on every CPU register access, by HostSim_IrqCycles on every interrupt and jumps
+* to the next flag change while the CPU sleeps.
+*/
+
+#include "HostSim.h"
+#include <stddef.h>
+#include <string.h>
+
+HostSim_GpioBlockType HostSim_Gpio[HOSTSIM_NUM_GPIO];
+SPI_TypeDef HostSim_SpiRegs[HOSTSIM_NUM_SPI];
+USART_TypeDef HostSim_UsartRegs[HOSTSIM_NUM_USART];
+DMA_TypeDef HostSim_DmaRegs[HOSTSIM_NUM_DMA];
+DMA_Stream_TypeDef HostSim_DmaStreams[HOSTSIM_NUM_DMA][HOSTSIM_NUM_STREAMS];
+DWT_Type HostSim_Dwt;
+CoreDebug_Type HostSim_CoreDebug;
+uint64_t HostSim_Cycles;
+uint32_t HostSim_BusCycles = 4;
+uint32_t HostSim_IrqCycles = 24;
+uint64_t HostSim_RegAccesses;
+uint64_t HostSim_IrqCount;
+HostSim_SpiStatsType HostSim_SpiStats[HOSTSIM_NUM_SPI];
+HostSim_GpioStatsType HostSim_GpioStats[HOSTSIM_NUM_GPIO];
+uint16_t HostSim_GpioInput[HOSTSIM_NUM_GPIO];
+HostSim_SpiTimingType HostSim_SpiTiming;
+HostSim_UsartStatsType HostSim_UsartStats[HOSTSIM_NUM_USART];
+HostSim_UsartCaptureType HostSim_UsartCapture[HOSTSIM_NUM_USART];
+HostSim_LinNodeType HostSim_LinNode[HOSTSIM_NUM_USART];
+CAN_TypeDef HostSim_CanRegs[HOSTSIM_NUM_CAN];
+HostSim_CanStatsType HostSim_CanStats[HOSTSIM_NUM_CAN];
+HostSim_CanNodeType HostSim_CanNode[HOSTSIM_NUM_CAN];
+HostSim_CanCaptureType HostSim_CanCapture[HOSTSIM_NUM_CAN];
+ADC_TypeDef HostSim_AdcRegs[HOSTSIM_NUM_ADC];
+ADC_Common_TypeDef HostSim_AdcCommon;
+HostSim_AdcStatsType HostSim_AdcStats[HOSTSIM_NUM_ADC];
+HostSim_AdcSignalType HostSim_AdcSignal;
+TIM_TypeDef HostSim_TimRegs[HOSTSIM_NUM_TIM];
+HostSim_TimStatsType HostSim_TimStats[HOSTSIM_NUM_TIM];
+HostSim_TimCaptureType HostSim_TimCapture[HOSTSIM_NUM_TIM];
+HostSim_TimInputType HostSim_TimInput;
+FLASH_TypeDef HostSim_FlashRegs;
+uint8_t HostSim_FlashMemory[HOSTSIM_FLASH_SIZE];
+HostSim_FlashStatsType HostSim_FlashStats;
+
+#define HOSTSIM_NO_EVENT        UINT64_MAX
+#define HOSTSIM_NUM_IRQS        96
+#define HOSTSIM_DMA_FLAG_TE     0x08u
+#define HOSTSIM_DMA_FLAG_HT     0x10u
+#define HOSTSIM_DMA_FLAG_TC     0x20u
+#define HOSTSIM_DMA_HIGH_ISR    0x20000000u
+#define HOSTSIM_DMA_FLAG_MASK   0x0F7D0F7Du
+#define HOSTSIM_USART_SR_RESET  (USART_FLAG_TXE | USART_FLAG_TC)
+
+/* Internal state of a simulated SPI unit */
+typedef struct {
+    uint8_t shifting;           /* A frame is in the shift register */
+    uint8_t txFull;             /* A frame waits in the TX buffer */
+    uint16_t txData;            /* Content of the TX buffer */
+    uint16_t shiftData;         /* Content of the shift register */
+    uint16_t rxData;            /* Content of the RX buffer */
+    uint64_t shiftEnd;          /* Cycle at which the frame in the shift register is complete */
+    uint8_t rxPending;          /* A received frame waits for RXNE */
+    uint8_t txePending;         /* TXE waits to be set */
+    uint16_t rxPendingData;     /* Frame reported by the next RXNE */
+    uint64_t rxneAt;            /* Cycle at which RXNE is set for the pending frame */
+    uint64_t txeAt;             /* Cycle at which the pending TXE is set */
+    uint64_t bsyClearAt;        /* Cycle at which BSY clears once the unit is idle */
+} HostSim_SpiUnitType;
+
+static HostSim_SpiUnitType HostSim_SpiUnit[HOSTSIM_NUM_SPI];
+
+/* Core clock / APB clock: SPI1 is on APB2 (84 MHz), SPI2 and SPI3 on APB1 (42 MHz) */
+static const uint8_t HostSim_ApbRatio[HOSTSIM_NUM_SPI] = { 2, 4, 4 };
+
+/* DMA requests of the SPI units: stream index (controller * 8 + stream) and channel */
+static const uint8_t HostSim_SpiRxStream[HOSTSIM_NUM_SPI] = { 8, 3, 0 };
+static const uint8_t HostSim_SpiTxStream[HOSTSIM_NUM_SPI] = { 11, 4, 5 };
+static const uint8_t HostSim_SpiDmaChannel[HOSTSIM_NUM_SPI] = { 3, 0, 0 };
+
+/* Internal state of a simulated USART and of the LIN slave on its bus */
+typedef struct {
+    uint8_t shifting;           /* A frame is in the shift register */
+    uint8_t shiftBreak;         /* That frame is a break */
+    uint8_t txFull;             /* A frame waits in the TX data register */
+    uint16_t txData;            /* Content of the TX data register */
+    uint16_t shiftData;         /* Content of the shift register */
+    uint64_t shiftStart;        /* Cycle at which the frame in the shift register started */
+    uint64_t shiftEnd;          /* Cycle at which the frame in the shift register is complete */
+    uint16_t rxData;            /* Content of the RX data register */
+    uint8_t linState;           /* Slave: 0 idle, 1 break seen, 2 sync seen */
+    uint64_t linBreakAt;        /* Slave: start of the break of the header */
+    uint8_t linId;              /* Slave: frame answered */
+    uint8_t linSent;            /* Slave: bytes of the response sent, linSending while some are left */
+    uint8_t linSending;
+    uint64_t linNextAt;         /* Slave: end of the next byte of the response */
+} HostSim_UsartUnitType;
+
+static HostSim_UsartUnitType HostSim_UsartUnit[HOSTSIM_NUM_USART];
+
+/* Core clock / APB clock: USART1 is on APB2, USART2, USART3 and UART5 on APB1 */
+static const uint8_t HostSim_UsartApbRatio[HOSTSIM_NUM_USART] = { 2, 4, 4, 4 };
+
+/* DMA requests of the USARTs, TX and RX streams, all on channel 4 */
+static const uint8_t HostSim_UsartTxStream[HOSTSIM_NUM_USART] = { 15, 6, 3, 7 };
+static const uint8_t HostSim_UsartRxStream[HOSTSIM_NUM_USART] = { 10, 5, 1, 0 };
+#define HOSTSIM_USART_DMA_CHANNEL   4u
+
+#define HOSTSIM_LIN_BREAK_BITS      14u     /* 13 dominant bits and the delimiter */
+#define HOSTSIM_LIN_SYNC            0x55u
+#define HOSTSIM_USART_SR_RX_ERRORS  (USART_FLAG_ORE | USART_FLAG_NE | USART_FLAG_FE | USART_FLAG_PE)
+
+/* Frame in the layout of a CAN mailbox: identifier, length and FMI, data */
+typedef struct {
+    uint32_t ir;
+    uint32_t dtr;
+    uint32_t dlr;
+    uint32_t dhr;
+} HostSim_CanMsgType;
+
+#define HOSTSIM_CAN_MAILBOXES   3u
+#define HOSTSIM_CAN_FIFO_DEPTH  3u
+#define HOSTSIM_CAN_NODE        0xFFu   /* Sender of a frame of the other node */
+#define HOSTSIM_CAN_FMR_RESET   0x2A1C0E01u
+#define HOSTSIM_CAN_FMR_CAN2SB  0x00003F00u     /* Start bank of CAN2 in CAN_FMR */
+
+/* Internal state of a simulated CAN controller and its bus */
+typedef struct {
+    uint8_t busy;               /* A frame is on the bus */
+    uint8_t sender;             /* Mailbox of the frame on the bus, HOSTSIM_CAN_NODE */
+    uint64_t frameEnd;          /* Cycle at which the frame on the bus is complete */
+    HostSim_CanMsgType busMsg;  /* Frame on the bus */
+    uint32_t txOrder[HOSTSIM_CAN_MAILBOXES];    /* Request order of the mailboxes, for TXFP */
+    uint32_t nextOrder;
+    HostSim_CanMsgType fifo[2][HOSTSIM_CAN_FIFO_DEPTH];
+    uint8_t fifoCount[2];
+} HostSim_CanUnitType;
+
+static HostSim_CanUnitType HostSim_CanUnit[HOSTSIM_NUM_CAN];
+
+/* Internal state of a simulated ADC. In triple interleaved mode the conversions of the three ADCs
+   are sequenced by the state of ADC1. */
+typedef struct {
+    uint8_t converting;         /* A conversion is in progress */
+    uint8_t rank;               /* Position of that conversion in the regular sequence */
+    uint8_t drFull;             /* DR (CDR in triple mode) holds a result not read yet */
+    uint8_t dmaDone;            /* Last DMA transfer made with DDS clear: no more requests */
+    uint8_t pairFull;           /* Triple mode: a result waits for the next one to fill CDR */
+    uint16_t pair;              /* That result */
+    uint32_t sample;            /* Triple mode: conversions since the start */
+    uint64_t sampleAt;          /* Cycle at which the input of the conversion is sampled */
+    uint64_t convEnd;           /* Cycle at which the conversion is complete */
+} HostSim_AdcUnitType;
+
+static HostSim_AdcUnitType HostSim_AdcUnit[HOSTSIM_NUM_ADC];
+
+#define HOSTSIM_ADC_TRIPLE_INTERL   0x17u       /* CCR MULTI of the triple interleaved mode */
+#define HOSTSIM_ADC_CONV_CYCLES     12u         /* ADC clocks of a 12-bit conversion after sampling */
+
+/* Sampling times of SMPRx in ADC clocks */
+static const uint16_t HostSim_AdcSmpCycles[8] = { 3, 15, 28, 56, 84, 112, 144, 480 };
+
+/* DMA requests of the ADCs: both streams of each on DMA2, and the channel */
+static const uint8_t HostSim_AdcStream[HOSTSIM_NUM_ADC][2] = { { 8, 12 }, { 10, 11 }, { 8, 9 } };
+static const uint8_t HostSim_AdcDmaChannel[HOSTSIM_NUM_ADC] = { 0, 1, 2 };
+
+/* Internal state of a simulated timer. CNT holds the count at tick "ticks" of the prescaled clock;
+   the model brings it up to date whenever the clock has moved on. */
+typedef struct {
+    uint64_t base;              /* Cycle of tick 0 of the prescaled clock */
+    uint64_t ticks;             /* Ticks counted into CNT */
+    uint32_t compare[4];        /* Compare values in force, loaded at update events when preloaded */
+    uint64_t edgeAt[4];         /* Cycle of the next edge of TI1..TI4, UINT64_MAX if none is expected */
+    uint8_t edgeLevel[4];       /* Level of TI1..TI4 after that edge */
+    uint8_t watched;            /* Bit n set once TIn+1 is captured and its edges are asked for */
+} HostSim_TimUnitType;
+
+static HostSim_TimUnitType HostSim_TimUnit[HOSTSIM_NUM_TIM];
+
+#define HOSTSIM_TIM_SR_CC_MASK      (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)
+#define HOSTSIM_TIM_NO_INPUT        4u          /* Input of a channel that captures none */
+#define HOSTSIM_TIM_NO_STREAM       0xFFu       /* Request without a DMA stream */
+#define HOSTSIM_TIM_TS_TI1FP1       5u          /* SMCR TS of the filtered inputs TI1 and TI2 */
+#define HOSTSIM_TIM_TS_TI2FP2       6u
+#define HOSTSIM_TIM_SMS_RESET       4u          /* SMCR SMS of the reset slave mode */
+
+/* Timer number n of TIMn */
+static const uint8_t HostSim_TimNumber[HOSTSIM_NUM_TIM] = { 1, 2, 3, 4, 5, 8 };
+/* Core clock / timer clock: TIM1 and TIM8 run at twice the 84 MHz of APB2, the others at twice the
+   42 MHz of APB1 */
+static const uint8_t HostSim_TimClockRatio[HOSTSIM_NUM_TIM] = { 1, 2, 2, 2, 2, 1 };
+/* TIM2 and TIM5 have 32-bit counters */
+static const uint8_t HostSim_TimWide[HOSTSIM_NUM_TIM] = { 0, 1, 0, 0, 1, 0 };
+/* TIM1 and TIM8 have a repetition counter and gated outputs */
+static const uint8_t HostSim_TimAdvanced[HOSTSIM_NUM_TIM] = { 1, 0, 0, 0, 0, 1 };
+
+/* Update and compare interrupts, on separate lines for TIM1 and TIM8 only */
+static const uint8_t HostSim_TimUpIRQn[HOSTSIM_NUM_TIM] = {
+    TIM1_UP_TIM10_IRQn, TIM2_IRQn, TIM3_IRQn, TIM4_IRQn, TIM5_IRQn, TIM8_UP_TIM13_IRQn
+};
+static const uint8_t HostSim_TimCcIRQn[HOSTSIM_NUM_TIM] = {
+    TIM1_CC_IRQn, TIM2_IRQn, TIM3_IRQn, TIM4_IRQn, TIM5_IRQn, TIM8_CC_IRQn
+};
+
+/* DMA requests of RM0090, as stream numbers of HostSim_DmaStreams: the update events (DMA2 stream 5
+   for TIM1, DMA1 streams 1, 2, 6, 0 for TIM2..TIM5, DMA2 stream 1 for TIM8), the capture/compare
+   channels and the trigger. All the requests of a timer use one channel. */
+static const uint8_t HostSim_TimUpStream[HOSTSIM_NUM_TIM] = { 13, 1, 2, 6, 0, 9 };
+static const uint8_t HostSim_TimCcStream[HOSTSIM_NUM_TIM][4] = {
+    { 9, 10, 14, 12 }, { 5, 6, 1, 7 }, { 4, 5, 7, 2 }, { 0, 3, 7, HOSTSIM_TIM_NO_STREAM }, { 2, 4, 0, 1 }, { 10, 11, 12, 15 }
+};
+static const uint8_t HostSim_TimTrgStream[HOSTSIM_NUM_TIM] = {
+    12, HOSTSIM_TIM_NO_STREAM, 4, HOSTSIM_TIM_NO_STREAM, 1, 15
+};
+static const uint8_t HostSim_TimDmaChannel[HOSTSIM_NUM_TIM] = { 6, 3, 5, 2, 6, 7 };
+
+/* Internal state of the flash interface */
+typedef struct {
+    uint8_t keyStep;            /* KEY1 written, KEY2 expected */
+    uint8_t busy;               /* An operation is in progress */
+    uint8_t erase;              /* That operation is a sector erase */
+    uint8_t latched;            /* x64: the first word of a double word is written */
+    uint32_t offset;            /* Offset of the unit programmed or of the sector erased */
+    uint32_t size;              /* Bytes of that unit or sector */
+    uint8_t data[8];            /* Unit being programmed */
+    uint64_t startAt;
+    uint64_t endAt;             /* Cycle at which the operation is complete */
+} HostSim_FlashUnitType;
+
+static HostSim_FlashUnitType HostSim_FlashUnit;
+static uint8_t HostSim_FlashErased;         /* The memory has been erased by a first HostSim_Reset */
+
+#define HOSTSIM_FLASH_SECTORS       8u
+#define HOSTSIM_FLASH_PROGRAM_US    16u     /* Programming time of a unit, whatever PSIZE */
+#define HOSTSIM_FLASH_ERRORS        (FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+#define HOSTSIM_FLASH_SR_W1C        (FLASH_FLAG_EOP | FLASH_FLAG_OPERR | HOSTSIM_FLASH_ERRORS)
+
+/* Typical sector erase times of DS8626 in ms, by PSIZE (x8, x16, x32, x64 with VPP) for the
+   sectors of 16, 64 and 128 KB */
+static const uint16_t HostSim_FlashEraseMs[4][3] = {
+    { 400, 1200, 2000 }, { 300, 700, 1300 }, { 250, 550, 1000 }, { 230, 490, 875 }
+};
+
+/* Bytes moved by each stream since it was enabled */
+static uint32_t HostSim_DmaPos[HOSTSIM_NUM_DMA * HOSTSIM_NUM_STREAMS];
+/* Elements of the transfer, reloaded into NDTR by a circular stream */
+static uint32_t HostSim_DmaLength[HOSTSIM_NUM_DMA * HOSTSIM_NUM_STREAMS];
+
+/* Interrupt controller */
+static uint8_t HostSim_IrqEnabled[HOSTSIM_NUM_IRQS];
+static uint32_t HostSim_IrqMasked;
+static uint8_t HostSim_InIsr;
+
+/* Handlers defined by the drivers; the others stay NULL */
+#define HOSTSIM_WEAK_HANDLER(name) extern void name(void) __attribute__((weak))
+HOSTSIM_WEAK_HANDLER(DMA1_Stream0_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream2_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream3_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream4_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream5_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream6_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA1_Stream7_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream0_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream2_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream3_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream4_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream5_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream6_IRQHandler);
+HOSTSIM_WEAK_HANDLER(DMA2_Stream7_IRQHandler);
+HOSTSIM_WEAK_HANDLER(SPI1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(SPI2_IRQHandler);
+HOSTSIM_WEAK_HANDLER(SPI3_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN1_TX_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN1_RX0_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN1_RX1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN2_TX_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN2_RX0_IRQHandler);
+HOSTSIM_WEAK_HANDLER(CAN2_RX1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(ADC_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM1_UP_TIM10_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM1_CC_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM2_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM3_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM4_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM5_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM8_UP_TIM13_IRQHandler);
+HOSTSIM_WEAK_HANDLER(TIM8_CC_IRQHandler);
+HOSTSIM_WEAK_HANDLER(FLASH_IRQHandler);
+HOSTSIM_WEAK_HANDLER(USART1_IRQHandler);
+HOSTSIM_WEAK_HANDLER(USART2_IRQHandler);
+HOSTSIM_WEAK_HANDLER(USART3_IRQHandler);
+HOSTSIM_WEAK_HANDLER(UART5_IRQHandler);
+
+static void (* const HostSim_DmaHandler[HOSTSIM_NUM_DMA * HOSTSIM_NUM_STREAMS])(void) = {
+    DMA1_Stream0_IRQHandler, DMA1_Stream1_IRQHandler, DMA1_Stream2_IRQHandler, DMA1_Stream3_IRQHandler,
+    DMA1_Stream4_IRQHandler, DMA1_Stream5_IRQHandler, DMA1_Stream6_IRQHandler, DMA1_Stream7_IRQHandler,
+    DMA2_Stream0_IRQHandler, DMA2_Stream1_IRQHandler, DMA2_Stream2_IRQHandler, DMA2_Stream3_IRQHandler,
+    DMA2_Stream4_IRQHandler, DMA2_Stream5_IRQHandler, DMA2_Stream6_IRQHandler, DMA2_Stream7_IRQHandler,
+};
+
+static const uint8_t HostSim_DmaIRQn[HOSTSIM_NUM_DMA * HOSTSIM_NUM_STREAMS] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+};
+
+static void (* const HostSim_SpiHandler[HOSTSIM_NUM_SPI])(void) = {
+    SPI1_IRQHandler, SPI2_IRQHandler, SPI3_IRQHandler,
+};
+
+static const uint8_t HostSim_SpiIRQn[HOSTSIM_NUM_SPI] = { SPI1_IRQn, SPI2_IRQn, SPI3_IRQn };
+
+/* CAN interrupts: TX, RX0, RX1, with their enable bits in CAN_IER */
+static void (* const HostSim_CanHandler[HOSTSIM_NUM_CAN][3])(void) = {
+    { CAN1_TX_IRQHandler, CAN1_RX0_IRQHandler, CAN1_RX1_IRQHandler },
+    { CAN2_TX_IRQHandler, CAN2_RX0_IRQHandler, CAN2_RX1_IRQHandler },
+};
+
+static const uint8_t HostSim_CanIRQn[HOSTSIM_NUM_CAN][3] = {
+    { CAN1_TX_IRQn, CAN1_RX0_IRQn, CAN1_RX1_IRQn },
+    { CAN2_TX_IRQn, CAN2_RX0_IRQn, CAN2_RX1_IRQn },
+};
+
+static void (* const HostSim_TimUpHandler[HOSTSIM_NUM_TIM])(void) = {
+    TIM1_UP_TIM10_IRQHandler, TIM2_IRQHandler, TIM3_IRQHandler, TIM4_IRQHandler, TIM5_IRQHandler,
+    TIM8_UP_TIM13_IRQHandler
+};
+
+static void (* const HostSim_TimCcHandler[HOSTSIM_NUM_TIM])(void) = {
+    TIM1_CC_IRQHandler, TIM2_IRQHandler, TIM3_IRQHandler, TIM4_IRQHandler, TIM5_IRQHandler,
+    TIM8_CC_IRQHandler
+};
+
+static void (* const HostSim_UsartHandler[HOSTSIM_NUM_USART])(void) = {
+    USART1_IRQHandler, USART2_IRQHandler, USART3_IRQHandler, UART5_IRQHandler,
+};
+
+static const uint8_t HostSim_UsartIRQn[HOSTSIM_NUM_USART] = { USART1_IRQn, USART2_IRQn, USART3_IRQn, UART5_IRQn };
+
+/* Position of the flags of stream 0..3 / 4..7 in LISR / HISR */
+static const uint8_t HostSim_DmaFlagShift[4] = { 0, 6, 16, 22 };
+
+static void HostSim_Run(uint64_t Target);
+
+static uint32_t HostSim_SpiIndex(SPI_TypeDef* SPIx)
+{
+    return (uint32_t)(SPIx - HostSim_SpiRegs);
+}
+
+static uint32_t HostSim_UsartIndex(USART_TypeDef* USARTx)
+{
+    return (uint32_t)(USARTx - HostSim_UsartRegs);
+}
+
+static uint32_t HostSim_StreamIndex(DMA_Stream_TypeDef* stream)
+{
+    return (uint32_t)(stream - &HostSim_DmaStreams[0][0]);
+}
+
+static DMA_Stream_TypeDef* HostSim_Stream(uint32_t streamIdx)
+{
+    return &HostSim_DmaStreams[0][0] + streamIdx;
+}
+
+/* ISR register of the controller holding the flags of a stream */
+static volatile uint32_t* HostSim_DmaIsr(uint32_t streamIdx)
+{
+    DMA_TypeDef* dma = &HostSim_DmaRegs[streamIdx / HOSTSIM_NUM_STREAMS];
+    return ((streamIdx % HOSTSIM_NUM_STREAMS) < 4) ? &dma->LISR : &dma->HISR;
+}
+
+static uint32_t HostSim_DmaFlag(uint32_t streamIdx, uint32_t flag)
+{
+    return flag << HostSim_DmaFlagShift[streamIdx % 4];
+}
+
+static uint32_t HostSim_FrameCycles(uint32_t idx)
+{
+    uint32_t bits = (HostSim_SpiRegs[idx].CR1 & SPI_DataSize_16b) ? 16u : 8u;
+    uint32_t divider = 2u << ((HostSim_SpiRegs[idx].CR1 >> 3) & 0x7u);
+    return bits * divider * HostSim_ApbRatio[idx];
+}
+
+/* Charges one CPU register access to the modelled clock */
+static void HostSim_Access(void)
+{
+    HostSim_RegAccesses++;
+    HostSim_Run(HostSim_Cycles + HostSim_BusCycles);
+}
+
+/* Charges the register accesses of a library function */
+static void HostSim_Accesses(uint32_t Count)
+{
+    while (Count-- != 0) {
+        HostSim_Access();
+    }
+}
+
+/* Loads a frame into the transmitter, as a write of DR does */
+static void HostSim_SpiPush(uint32_t idx, uint16_t data)
+{
+    HostSim_SpiUnitType* unit = &HostSim_SpiUnit[idx];
+
+    if ((HostSim_SpiRegs[idx].CR1 & SPI_CR1_SPE) == 0) {
+        return;
+    }
+    if (!unit->shifting && !unit->txePending) {
+        unit->shiftData = data;
+        unit->shifting = 1;
+        unit->shiftEnd = HostSim_Cycles + HostSim_FrameCycles(idx);
+        if (HostSim_SpiTiming.txe != 0) {
+            /* The frame passes through the TX buffer */
+            HostSim_SpiRegs[idx].SR &= (uint16_t)~SPI_I2S_FLAG_TXE;
+            unit->txePending = 1;
+            unit->txeAt = HostSim_Cycles + HostSim_SpiTiming.txe;
+        }
+    } else {
+        /* Data written while TXE is clear overwrites the TX buffer, as on the device */
+        unit->txData = data;
+        unit->txFull = 1;
+        HostSim_SpiRegs[idx].SR &= (uint16_t)~SPI_I2S_FLAG_TXE;
+    }
+}
+
+/* Stream serving a peripheral request on a channel, NULL if the stream does not serve it now */
+static DMA_Stream_TypeDef* HostSim_DmaRequest(uint32_t streamIdx, uint32_t channel)
+{
+    DMA_Stream_TypeDef* stream = HostSim_Stream(streamIdx);
+
+    if ((stream->CR & DMA_SxCR_EN) == 0 || ((stream->CR & DMA_SxCR_CHSEL) >> 25) != channel || stream->NDTR == 0) {
+        return NULL;
+    }
+    return stream;
+}
+
+/* Stream serving a request of an SPI unit, NULL if the request is not served */
+static DMA_Stream_TypeDef* HostSim_SpiDmaStream(uint32_t idx, uint32_t streamIdx, uint16_t request)
+{
+    if ((HostSim_SpiRegs[idx].CR2 & request) == 0) {
+        return NULL;
+    }
+    return HostSim_DmaRequest(streamIdx, HostSim_SpiDmaChannel[idx]);
+}
+
+/* Size in bytes of the memory elements of a stream */
+static uint32_t HostSim_DmaSize(uint32_t streamIdx)
+{
+    return 1u << ((HostSim_Stream(streamIdx)->CR & DMA_SxCR_MSIZE) >> 13);
+}
+
+/* Address of the next memory element of a stream */
+static uint8_t* HostSim_DmaMemory(uint32_t streamIdx)
+{
+    DMA_Stream_TypeDef* stream = HostSim_Stream(streamIdx);
+    uint8_t* base = (uint8_t*)(uintptr_t)stream->M0AR;
+    return (stream->CR & DMA_SxCR_MINC) ? base + HostSim_DmaPos[streamIdx] * HostSim_DmaSize(streamIdx) : base;
+}
+
+/* Counts one element moved by a stream and ends the transfer after the last one, or starts it
+   again in circular mode; returns 1 after the last element */
+static uint8_t HostSim_DmaStep(uint32_t streamIdx)
+{
+    DMA_Stream_TypeDef* stream = HostSim_Stream(streamIdx);
+    uint32_t length = HostSim_DmaLength[streamIdx];
+
+    HostSim_DmaPos[streamIdx]++;
+    stream->NDTR--;
+    if (stream->NDTR == length - length / 2u) {
+        *HostSim_DmaIsr(streamIdx) |= HostSim_DmaFlag(streamIdx, HOSTSIM_DMA_FLAG_HT);
+    }
+    if (stream->NDTR != 0) {
+        return 0;
+    }
+    *HostSim_DmaIsr(streamIdx) |= HostSim_DmaFlag(streamIdx, HOSTSIM_DMA_FLAG_TC);
+    if (stream->CR & DMA_SxCR_CIRC) {
+        stream->NDTR = length;
+        HostSim_DmaPos[streamIdx] = 0;
+    } else {
+        stream->CR &= ~DMA_SxCR_EN;
+    }
+    return 1;
+}
+
+/* Brings a unit and its DMA streams up to date with the modelled clock */
+static void HostSim_SpiUpdate(uint32_t idx)
+{
+    SPI_TypeDef* regs = &HostSim_SpiRegs[idx];
+    HostSim_SpiUnitType* unit = &HostSim_SpiUnit[idx];
+
+    for (;;) {
+        DMA_Stream_TypeDef* stream;
+
+        if (unit->shifting && HostSim_Cycles >= unit->shiftEnd) {
+            uint64_t end = unit->shiftEnd;
+
+            unit->rxPendingData = unit->shiftData;
+            unit->rxPending = 1;
+            unit->rxneAt = end + HostSim_SpiTiming.rxne;
+            HostSim_SpiStats[idx].frames++;
+            unit->shifting = 0;
+
+            if (unit->txFull && !unit->txePending) {
+                unit->shiftData = unit->txData;
+                unit->txFull = 0;
+                unit->shifting = 1;
+                unit->shiftEnd = end + HostSim_FrameCycles(idx);
+                unit->txePending = 1;
+                unit->txeAt = end + HostSim_SpiTiming.txe;
+            } else {
+                unit->bsyClearAt = end + HostSim_SpiTiming.bsy;
+            }
+        } else if (unit->rxPending && HostSim_Cycles >= unit->rxneAt) {
+            if (regs->SR & SPI_I2S_FLAG_RXNE) {
+                regs->SR |= SPI_I2S_FLAG_OVR;
+                HostSim_SpiStats[idx].overruns++;
+            }
+            unit->rxData = unit->rxPendingData;
+            unit->rxPending = 0;
+            regs->SR |= SPI_I2S_FLAG_RXNE;
+        } else if (unit->txePending && HostSim_Cycles >= unit->txeAt) {
+            unit->txePending = 0;
+            if (unit->txFull && !unit->shifting) {
+                /* The frame written meanwhile follows the current one */
+                unit->shiftData = unit->txData;
+                unit->txFull = 0;
+                unit->shifting = 1;
+                unit->shiftEnd = HostSim_Cycles + HostSim_FrameCycles(idx);
+                unit->txePending = (HostSim_SpiTiming.txe != 0);
+                unit->txeAt = HostSim_Cycles + HostSim_SpiTiming.txe;
+            }
+            if (!unit->txePending && !unit->txFull) {
+                regs->SR |= SPI_I2S_FLAG_TXE;
+            }
+        } else if ((regs->SR & SPI_I2S_FLAG_RXNE) &&
+                   (stream = HostSim_SpiDmaStream(idx, HostSim_SpiRxStream[idx], SPI_I2S_DMAReq_Rx)) != NULL) {
+            memcpy(HostSim_DmaMemory(HostSim_SpiRxStream[idx]), &unit->rxData, HostSim_DmaSize(HostSim_SpiRxStream[idx]));
+            regs->SR &= (uint16_t)~SPI_I2S_FLAG_RXNE;
+            HostSim_DmaStep(HostSim_SpiRxStream[idx]);
+        } else if ((regs->SR & SPI_I2S_FLAG_TXE) && (regs->CR1 & SPI_CR1_SPE) &&
+                   (stream = HostSim_SpiDmaStream(idx, HostSim_SpiTxStream[idx], SPI_I2S_DMAReq_Tx)) != NULL) {
+            uint16_t data = 0;
+            memcpy(&data, HostSim_DmaMemory(HostSim_SpiTxStream[idx]), HostSim_DmaSize(HostSim_SpiTxStream[idx]));
+            HostSim_SpiPush(idx, data);
+            HostSim_DmaStep(HostSim_SpiTxStream[idx]);
+        } else {
+            break;
+        }
+    }
+    if (unit->shifting || unit->txFull || unit->txePending || HostSim_Cycles < unit->bsyClearAt) {
+        regs->SR |= SPI_I2S_FLAG_BSY;
+    } else {
+        regs->SR &= (uint16_t)~SPI_I2S_FLAG_BSY;
+    }
+}
+
+static uint32_t HostSim_UsartFrameCycles(uint32_t idx)
+{
+    const USART_TypeDef* regs = &HostSim_UsartRegs[idx];
+    uint32_t bits = 1u + ((regs->CR1 & USART_CR1_M) ? 9u : 8u) + (((regs->CR2 & USART_CR2_STOP) == USART_StopBits_2) ? 2u : 1u);
+    return bits * regs->BRR * HostSim_UsartApbRatio[idx];
+}
+
+/* A break lasts 13 bits and its delimiter in LIN mode, a frame of zeros and a stop bit otherwise */
+static uint32_t HostSim_UsartBreakCycles(uint32_t idx)
+{
+    const USART_TypeDef* regs = &HostSim_UsartRegs[idx];
+
+    if (regs->CR2 & USART_CR2_LINEN) {
+        return HOSTSIM_LIN_BREAK_BITS * regs->BRR * HostSim_UsartApbRatio[idx];
+    }
+    return HostSim_UsartFrameCycles(idx);
+}
+
+/* Starts shifting out a frame, or a break if SBK is set */
+static void HostSim_UsartShift(uint32_t idx, uint64_t at, uint16_t data)
+{
+    HostSim_UsartUnitType* unit = &HostSim_UsartUnit[idx];
+
+    unit->shifting = 1;
+    unit->shiftStart = at;
+    unit->shiftBreak = (HostSim_UsartRegs[idx].CR1 & USART_CR1_SBK) != 0;
+    unit->shiftData = unit->shiftBreak ? 0u : data;
+    unit->shiftEnd = at + (unit->shiftBreak ? HostSim_UsartBreakCycles(idx) : HostSim_UsartFrameCycles(idx));
+}
+
+/* Loads a frame into the transmitter, as a write of DR does */
+static void HostSim_UsartPush(uint32_t idx, uint16_t data)
+{
+    USART_TypeDef* regs = &HostSim_UsartRegs[idx];
+    HostSim_UsartUnitType* unit = &HostSim_UsartUnit[idx];
+
+    if ((regs->CR1 & (USART_CR1_UE | USART_CR1_TE)) != (USART_CR1_UE | USART_CR1_TE)) {
+        return;
+    }
+    regs->SR &= (uint16_t)~USART_FLAG_TC;
+    if (!unit->shifting) {
+        HostSim_UsartShift(idx, HostSim_Cycles, data);
+        if (unit->shiftBreak) {
+            /* The data follows the break */
+            unit->txData = data;
+            unit->txFull = 1;
+            regs->SR &= (uint16_t)~USART_FLAG_TXE;
+        }
+    } else {
+        unit->txData = data;
+        unit->txFull = 1;
+        regs->SR &= (uint16_t)~USART_FLAG_TXE;
+    }
+}
+
+/* A frame, or a break, reaches the receiver: a break is received as a zero with FE, and sets LBD
+   in LIN mode */
+static void HostSim_UsartReceive(uint32_t idx, uint16_t data, uint8_t isBreak)
+{
+    USART_TypeDef* regs = &HostSim_UsartRegs[idx];
+
+    if ((regs->CR1 & (USART_CR1_UE | USART_CR1_RE)) != (USART_CR1_UE | USART_CR1_RE)) {
+        return;
+    }
+    HostSim_UsartStats[idx].rxBytes++;
+    if (isBreak && (regs->CR2 & USART_CR2_LINEN)) {
+        regs->SR |= USART_FLAG_LBD;
+    }
+    if (regs->SR & USART_FLAG_RXNE) {
+        regs->SR |= USART_FLAG_ORE;
+        HostSim_UsartStats[idx].overruns++;
+        return;
+    }
+    HostSim_UsartUnit[idx].rxData = data;
+    regs->SR |= USART_FLAG_RXNE | (isBreak ? USART_FLAG_FE : 0u);
+}
+
+/* Parity bits of a LIN identifier in bits 6 and 7 */
+static uint8_t HostSim_LinPid(uint8_t id)
+{
+    uint8_t p0 = (id ^ (id >> 1) ^ (id >> 2) ^ (id >> 4)) & 1u;
+    uint8_t p1 = (uint8_t)(~((id >> 1) ^ (id >> 3) ^ (id >> 4) ^ (id >> 5)) & 1u);
+    return (uint8_t)(id | (p0 << 6) | (p1 << 7));
+}
+
+/* The LIN slave follows a frame sent by the USART: break, sync, then the protected identifier */
+static void HostSim_LinSlave(uint32_t idx, uint16_t data, uint8_t isBreak, uint64_t start, uint64_t end)
+{
+    HostSim_UsartUnitType* unit = &HostSim_UsartUnit[idx];
+    HostSim_LinNodeType* node = &HostSim_LinNode[idx];
+
+    if (isBreak) {
+        unit->linState = 1;
+        unit->linBreakAt = start;
+        unit->linSending = 0;
+    } else if (unit->linState == 1) {
+        unit->linState = (data == HOSTSIM_LIN_SYNC) ? 2u : 0u;
+    } else if (unit->linState == 2) {
+        uint8_t id = (uint8_t)(data & 0x3Fu);
+        unit->linState = 0;
+        if (HostSim_LinPid(id) != (uint8_t)data) {
+            return;
+        }
+        if (node->headers != NULL && node->count < node->size) {
+            node->headers[node->count].at = unit->linBreakAt;
+            node->headers[node->count].pid = (uint8_t)data;
+        }
+        node->count++;
+        if (node->length[id] != 0) {
+            uint32_t bit = HostSim_UsartRegs[idx].BRR * HostSim_UsartApbRatio[idx];
+            unit->linId = id;
+            unit->linSent = 0;
+            unit->linSending = 1;
+            unit->linNextAt = end + (uint64_t)node->responseSpace * bit + HostSim_UsartFrameCycles(idx);
+            node->responses++;
+        }
+    }
+}
+
+/* Brings a USART, its DMA streams and its LIN slave up to date with the modelled clock */
+static void HostSim_UsartUpdate(uint32_t idx)
+{
+    USART_TypeDef* regs = &HostSim_UsartRegs[idx];
+    HostSim_UsartUnitType* unit = &HostSim_UsartUnit[idx];
+    HostSim_UsartCaptureType* capture = &HostSim_UsartCapture[idx];
+    uint32_t streamIdx = HostSim_UsartTxStream[idx];
+    uint32_t rxStreamIdx = HostSim_UsartRxStream[idx];
+    uint8_t lin = (regs->CR2 & USART_CR2_LINEN) != 0;
+
+    for (;;) {
+        if (unit->shifting && HostSim_Cycles >= unit->shiftEnd) {
+            uint64_t end = unit->shiftEnd;
+            uint8_t isBreak = unit->shiftBreak;
+
+            if (isBreak) {
+                /* SBK clears at the end of the break */
+                regs->CR1 &= (uint16_t)~USART_CR1_SBK;
+                HostSim_UsartStats[idx].breaks++;
+            } else {
+                if (capture->buffer != NULL && capture->length < capture->size) {
+                    capture->buffer[capture->length++] = (uint8_t)unit->shiftData;
+                }
+                HostSim_UsartStats[idx].bytes++;
+            }
+            HostSim_UsartStats[idx].busyCycles += end - unit->shiftStart;
+            unit->shifting = 0;
+            if (lin) {
+                HostSim_UsartReceive(idx, unit->shiftData, isBreak);
+                HostSim_LinSlave(idx, unit->shiftData, isBreak, unit->shiftStart, end);
+            }
+            if (regs->CR1 & USART_CR1_SBK) {
+                HostSim_UsartShift(idx, end, 0);
+            } else if (unit->txFull) {
+                unit->txFull = 0;
+                HostSim_UsartShift(idx, end, unit->txData);
+                regs->SR |= USART_FLAG_TXE;
+            } else {
+                regs->SR |= USART_FLAG_TC;
+            }
+        } else if (unit->linSending && HostSim_Cycles >= unit->linNextAt) {
+            const HostSim_LinNodeType* node = &HostSim_LinNode[idx];
+            HostSim_UsartReceive(idx, node->response[unit->linId][unit->linSent++], 0);
+            unit->linSending = (unit->linSent < node->length[unit->linId]);
+            unit->linNextAt += HostSim_UsartFrameCycles(idx);
+        } else if ((regs->SR & USART_FLAG_RXNE) && (regs->CR3 & USART_DMAReq_Rx) &&
+                   HostSim_DmaRequest(rxStreamIdx, HOSTSIM_USART_DMA_CHANNEL) != NULL) {
+            *HostSim_DmaMemory(rxStreamIdx) = (uint8_t)unit->rxData;
+            regs->SR &= (uint16_t)~USART_FLAG_RXNE;
+            HostSim_DmaStep(rxStreamIdx);
+        } else if ((regs->SR & USART_FLAG_TXE) && (regs->CR3 & USART_DMAReq_Tx) &&
+                   HostSim_DmaRequest(streamIdx, HOSTSIM_USART_DMA_CHANNEL) != NULL) {
+            uint8_t data = *HostSim_DmaMemory(streamIdx);
+            HostSim_UsartPush(idx, data);
+            HostSim_DmaStep(streamIdx);
+        } else {
+            break;
+        }
+    }
+}
+
+/* Bus arbitration priority of a frame in the layout of CAN_TIxR, the lowest value wins: base
+   identifier, then RTR (standard) or SRR, IDE, identifier extension and RTR (extended) */
+static uint32_t HostSim_CanKey(uint32_t ir)
+{
+    uint32_t key = ir & CAN_TI0R_STID;
+    if (ir & CAN_TI0R_IDE) {
+        return key | (3u << 19) | ((ir & CAN_TI0R_EXID) >> 2) | ((ir & CAN_TI0R_RTR) >> 1);
+    }
+    return key | ((ir & CAN_TI0R_RTR) << 19);
+}
+
+/* Core cycles of one bit time: (BRP + 1) x (3 + TS1 + TS2) quanta of the 42 MHz APB1 clock */
+static uint32_t HostSim_CanBitCycles(uint32_t idx)
+{
+    uint32_t btr = HostSim_CanRegs[idx].BTR;
+    uint32_t quanta = 3u + ((btr & CAN_BTR_TS1) >> 16) + ((btr & CAN_BTR_TS2) >> 20);
+    return ((btr & CAN_BTR_BRP) + 1u) * quanta * 4u;
+}
+
+/* Bits of a data frame without stuffing, intermission included */
+static uint32_t HostSim_CanFrameBits(const HostSim_CanMsgType* msg)
+{
+    uint32_t dlc = msg->dtr & 0xFu;
+    uint32_t bits = (msg->ir & CAN_TI0R_IDE) ? 67u : 47u;
+    if ((msg->ir & CAN_TI0R_RTR) == 0) {
+        bits += 8u * ((dlc > 8u) ? 8u : dlc);
+    }
+    return bits;
+}
+
+static HostSim_CanMsgType HostSim_CanFromFrame(const HostSim_CanFrameType* frame)
+{
+    HostSim_CanMsgType msg;
+
+    if (frame->id & HOSTSIM_CAN_EXTENDED) {
+        msg.ir = ((frame->id & 0x1FFFFFFFu) << 3) | CAN_TI0R_IDE;
+    } else {
+        msg.ir = (frame->id & 0x7FFu) << 21;
+    }
+    msg.dtr = frame->dlc & 0xFu;
+    memcpy(&msg.dlr, &frame->data[0], 4);
+    memcpy(&msg.dhr, &frame->data[4], 4);
+    return msg;
+}
+
+static HostSim_CanFrameType HostSim_CanToFrame(const HostSim_CanMsgType* msg)
+{
+    HostSim_CanFrameType frame;
+
+    frame.at = 0;
+    frame.id = (msg->ir & CAN_TI0R_IDE) ? (((msg->ir >> 3) & 0x1FFFFFFFu) | HOSTSIM_CAN_EXTENDED) : (msg->ir >> 21);
+    frame.dlc = (uint8_t)(msg->dtr & 0xFu);
+    memcpy(&frame.data[0], &msg->dlr, 4);
+    memcpy(&frame.data[4], &msg->dhr, 4);
+    return frame;
+}
+
+/* The controller takes part in bus traffic: normal mode, not bus-off */
+static uint8_t HostSim_CanOnBus(uint32_t idx)
+{
+    const CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    return (regs->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) == 0 && (regs->ESR & CAN_ESR_BOFF) == 0;
+}
+
+/* Filter accepting an identifier word (CAN_RIxR layout) on a controller, with the priority rules
+   of RM0090: 32-bit before 16-bit, identifier list before mask, then the lowest filter number.
+   Returns 0 if the frame is rejected. */
+static uint8_t HostSim_CanFilter(uint32_t idx, uint32_t ir, uint8_t* fifo, uint8_t* fmi)
+{
+    const CAN_TypeDef* f = &HostSim_CanRegs[0];
+    uint32_t slave = (f->FMR & HOSTSIM_CAN_FMR_CAN2SB) >> 8;
+    uint32_t first = (idx == 0) ? 0 : slave;
+    uint32_t end = (idx == 0) ? slave : 28u;
+    uint32_t word = ir & ~1u;
+    uint32_t half = ((ir >> 21) << 5) | ((ir & CAN_RI0R_RTR) << 3) | ((ir & CAN_RI0R_IDE) << 1) | ((ir >> 18) & 0x7u);
+    uint8_t number[2] = { 0, 0 };
+    int32_t best = -1;
+
+    if (f->FMR & CAN_FMR_FINIT) {
+        return 0;
+    }
+    for (uint32_t bank = first; bank < end && bank < 28u; bank++) {
+        uint32_t bit = 1u << bank;
+        uint8_t target = (f->FFA1R & bit) ? 1u : 0u;
+        uint8_t scale32 = (f->FS1R & bit) != 0;
+        uint8_t list = (f->FM1R & bit) != 0;
+        uint32_t fr1 = f->sFilterRegister[bank].FR1;
+        uint32_t fr2 = f->sFilterRegister[bank].FR2;
+        int32_t match = -1;
+
+        if (f->FA1R & bit) {
+            if (scale32 && list) {
+                match = (((word ^ fr1) & ~1u) == 0) ? 0 : (((word ^ fr2) & ~1u) == 0) ? 1 : -1;
+            } else if (scale32) {
+                match = (((word ^ fr1) & fr2 & ~1u) == 0) ? 0 : -1;
+            } else if (list) {
+                uint32_t ids[4] = { fr1 & 0xFFFFu, fr1 >> 16, fr2 & 0xFFFFu, fr2 >> 16 };
+                for (int32_t k = 3; k >= 0; k--) {
+                    if (half == ids[k]) {
+                        match = k;
+                    }
+                }
+            } else {
+                match = (((half ^ fr1) & (fr1 >> 16) & 0xFFFFu) == 0) ? 0 :
+                        (((half ^ fr2) & (fr2 >> 16) & 0xFFFFu) == 0) ? 1 : -1;
+            }
+        }
+        if (match >= 0 && (int32_t)(scale32 * 2 + list) > best) {
+            best = scale32 * 2 + list;
+            *fifo = target;
+            *fmi = (uint8_t)(number[target] + match);
+        }
+        number[target] = (uint8_t)(number[target] + (scale32 ? (list ? 2u : 1u) : (list ? 4u : 2u)));
+    }
+    return best >= 0;
+}
+
+/* Shows the output mailbox and the level of an RX FIFO in the registers */
+static void HostSim_CanFifoRegs(uint32_t idx, uint32_t fifo)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+    volatile uint32_t* rfr = &regs->RF0R + fifo;
+    uint8_t count = unit->fifoCount[fifo];
+
+    *rfr = (*rfr & CAN_RF0R_FOVR0) | count | ((count == HOSTSIM_CAN_FIFO_DEPTH) ? CAN_RF0R_FULL0 : 0u);
+    if (count != 0) {
+        regs->sFIFOMailBox[fifo].RIR = unit->fifo[fifo][0].ir;
+        regs->sFIFOMailBox[fifo].RDTR = unit->fifo[fifo][0].dtr;
+        regs->sFIFOMailBox[fifo].RDLR = unit->fifo[fifo][0].dlr;
+        regs->sFIFOMailBox[fifo].RDHR = unit->fifo[fifo][0].dhr;
+    }
+}
+
+/* Receives a frame of the bus into the FIFO selected by the filters */
+static void HostSim_CanReceive(uint32_t idx, HostSim_CanMsgType msg)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+    uint8_t fifo;
+    uint8_t fmi;
+    uint32_t slot;
+
+    if (!HostSim_CanFilter(idx, msg.ir, &fifo, &fmi)) {
+        return;
+    }
+    if (unit->fifoCount[fifo] == HOSTSIM_CAN_FIFO_DEPTH) {
+        *(&regs->RF0R + fifo) |= CAN_RF0R_FOVR0;
+        HostSim_CanStats[idx].rxLost++;
+        if (regs->MCR & CAN_MCR_RFLM) {
+            return;
+        }
+        /* Without FIFO lock the last frame is overwritten */
+        slot = HOSTSIM_CAN_FIFO_DEPTH - 1u;
+    } else {
+        slot = unit->fifoCount[fifo]++;
+    }
+    msg.ir &= ~1u;
+    msg.dtr = (msg.dtr & 0xFu) | ((uint32_t)fmi << 8);
+    unit->fifo[fifo][slot] = msg;
+    HostSim_CanStats[idx].rxFrames++;
+    HostSim_CanFifoRegs(idx, fifo);
+}
+
+/* Releases the output mailbox of an RX FIFO, as RFOM does */
+static void HostSim_CanRelease(uint32_t idx, uint32_t fifo)
+{
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+
+    if (unit->fifoCount[fifo] == 0) {
+        return;
+    }
+    unit->fifoCount[fifo]--;
+    memmove(&unit->fifo[fifo][0], &unit->fifo[fifo][1], unit->fifoCount[fifo] * sizeof(HostSim_CanMsgType));
+    HostSim_CanFifoRegs(idx, fifo);
+}
+
+/* Aborts a pending mailbox, as ABRQ does; a frame already on the bus completes normally */
+static void HostSim_CanAbort(uint32_t idx, uint32_t mbx)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+
+    if ((regs->sTxMailBox[mbx].TIR & CAN_TI0R_TXRQ) == 0 || (unit->busy && unit->sender == mbx)) {
+        return;
+    }
+    regs->sTxMailBox[mbx].TIR &= ~CAN_TI0R_TXRQ;
+    regs->TSR = (regs->TSR & ~(CAN_TSR_TXOK0 << (8u * mbx))) | (CAN_TSR_RQCP0 << (8u * mbx)) | (CAN_TSR_TME0 << mbx);
+}
+
+/* Pending mailbox the controller sends next, HOSTSIM_CAN_NODE if none: by identifier, or by
+   request order when TXFP is set */
+static uint8_t HostSim_CanNextMailbox(uint32_t idx)
+{
+    const CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    const HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+    uint8_t best = HOSTSIM_CAN_NODE;
+
+    for (uint8_t mbx = 0; mbx < HOSTSIM_CAN_MAILBOXES; mbx++) {
+        if ((regs->sTxMailBox[mbx].TIR & CAN_TI0R_TXRQ) == 0) {
+            continue;
+        }
+        if (best == HOSTSIM_CAN_NODE ||
+            ((regs->MCR & CAN_MCR_TXFP) ? (int32_t)(unit->txOrder[mbx] - unit->txOrder[best]) < 0
+                                        : HostSim_CanKey(regs->sTxMailBox[mbx].TIR) < HostSim_CanKey(regs->sTxMailBox[best].TIR))) {
+            best = mbx;
+        }
+    }
+    return best;
+}
+
+/* Starts the next frame on an idle bus; returns 0 if no frame is ready */
+static uint8_t HostSim_CanStart(uint32_t idx)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+    HostSim_CanNodeType* node = &HostSim_CanNode[idx];
+    uint8_t mbx = HostSim_CanOnBus(idx) ? HostSim_CanNextMailbox(idx) : HOSTSIM_CAN_NODE;
+    uint8_t nodeReady = node->frames != NULL && node->sent < node->count && node->frames[node->sent].at <= HostSim_Cycles;
+    HostSim_CanMsgType nodeMsg;
+
+    if (nodeReady) {
+        nodeMsg = HostSim_CanFromFrame(&node->frames[node->sent]);
+    }
+    if (mbx != HOSTSIM_CAN_NODE &&
+        (!nodeReady || HostSim_CanKey(regs->sTxMailBox[mbx].TIR) <= HostSim_CanKey(nodeMsg.ir))) {
+        unit->sender = mbx;
+        unit->busMsg.ir = regs->sTxMailBox[mbx].TIR & ~CAN_TI0R_TXRQ;
+        unit->busMsg.dtr = regs->sTxMailBox[mbx].TDTR;
+        unit->busMsg.dlr = regs->sTxMailBox[mbx].TDLR;
+        unit->busMsg.dhr = regs->sTxMailBox[mbx].TDHR;
+    } else if (nodeReady) {
+        unit->sender = HOSTSIM_CAN_NODE;
+        unit->busMsg = nodeMsg;
+    } else {
+        return 0;
+    }
+    unit->busy = 1;
+    unit->frameEnd = HostSim_Cycles + (uint64_t)HostSim_CanFrameBits(&unit->busMsg) * HostSim_CanBitCycles(idx);
+    HostSim_CanStats[idx].busyCycles += unit->frameEnd - HostSim_Cycles;
+    return 1;
+}
+
+/* Brings a CAN controller and its bus up to date with the modelled clock */
+static void HostSim_CanUpdate(uint32_t idx)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    HostSim_CanUnitType* unit = &HostSim_CanUnit[idx];
+
+    for (;;) {
+        if (unit->busy) {
+            if (HostSim_Cycles < unit->frameEnd) {
+                break;
+            }
+            unit->busy = 0;
+            if (unit->sender != HOSTSIM_CAN_NODE) {
+                uint32_t mbx = unit->sender;
+                HostSim_CanCaptureType* capture = &HostSim_CanCapture[idx];
+
+                regs->sTxMailBox[mbx].TIR &= ~CAN_TI0R_TXRQ;
+                regs->TSR |= ((CAN_TSR_RQCP0 | CAN_TSR_TXOK0) << (8u * mbx)) | (CAN_TSR_TME0 << mbx);
+                HostSim_CanStats[idx].txFrames++;
+                if (capture->buffer != NULL && capture->length < capture->size) {
+                    capture->buffer[capture->length] = HostSim_CanToFrame(&unit->busMsg);
+                    capture->buffer[capture->length++].at = unit->frameEnd;
+                }
+                if (regs->BTR & CAN_BTR_LBKM) {
+                    HostSim_CanReceive(idx, unit->busMsg);
+                }
+            } else {
+                HostSim_CanNode[idx].sent++;
+                if (HostSim_CanOnBus(idx) && (regs->BTR & CAN_BTR_LBKM) == 0) {
+                    HostSim_CanReceive(idx, unit->busMsg);
+                }
+            }
+        } else if (!HostSim_CanStart(idx)) {
+            break;
+        }
+    }
+}
+
+/* Register write with the side effects of the CAN controller */
+static void HostSim_CanWrite(uint32_t idx, volatile uint32_t* Reg, uint32_t Value)
+{
+    CAN_TypeDef* regs = &HostSim_CanRegs[idx];
+    uint32_t offset = (uint32_t)((uintptr_t)Reg - (uintptr_t)regs);
+    uint32_t mbxOffset = offset - (uint32_t)offsetof(CAN_TypeDef, sTxMailBox);
+    uint32_t mbx = mbxOffset / sizeof(CAN_TxMailBox_TypeDef);
+
+    if (Reg == &regs->TSR) {
+        for (uint32_t n = 0; n < HOSTSIM_CAN_MAILBOXES; n++) {
+            if (Value & (CAN_TSR_RQCP0 << (8u * n))) {
+                /* Clears RQCP, TXOK, ALST and TERR */
+                regs->TSR &= ~(0xFu << (8u * n));
+            }
+            if (Value & (CAN_TSR_ABRQ0 << (8u * n))) {
+                HostSim_CanAbort(idx, n);
+            }
+        }
+    } else if (Reg == &regs->RF0R || Reg == &regs->RF1R) {
+        uint32_t fifo = (Reg == &regs->RF1R);
+        *Reg &= ~(Value & (CAN_RF0R_FOVR0 | CAN_RF0R_FULL0));
+        if (Value & CAN_RF0R_RFOM0) {
+            HostSim_CanRelease(idx, fifo);
+        }
+        HostSim_CanFifoRegs(idx, fifo);
+    } else if (mbx < HOSTSIM_CAN_MAILBOXES && (mbxOffset % sizeof(CAN_TxMailBox_TypeDef)) == 0) {
+        /* TIR: a request is taken only by an empty mailbox */
+        if ((regs->TSR & (CAN_TSR_TME0 << mbx)) == 0) {
+            return;
+        }
+        *Reg = Value;
+        if (Value & CAN_TI0R_TXRQ) {
+            regs->TSR &= ~(CAN_TSR_TME0 << mbx);
+            HostSim_CanUnit[idx].txOrder[mbx] = HostSim_CanUnit[idx].nextOrder++;
+            HostSim_CanUpdate(idx);
+        }
+    } else {
+        *Reg = Value;
+    }
+}
+
+/* Core cycles of one ADC clock: ADCCLK is PCLK2 (half the core clock) divided by 2, 4, 6 or 8 */
+static uint32_t HostSim_AdcClock(void)
+{
+    return 4u * (((HostSim_AdcCommon.CCR & ADC_CCR_ADCPRE) >> 16) + 1u);
+}
+
+/* Channel of a rank of the regular sequence */
+static uint32_t HostSim_AdcChannel(const ADC_TypeDef* regs, uint32_t rank)
+{
+    if (rank < 6) {
+        return (regs->SQR3 >> (5u * rank)) & 0x1Fu;
+    } else if (rank < 12) {
+        return (regs->SQR2 >> (5u * (rank - 6))) & 0x1Fu;
+    }
+    return (regs->SQR1 >> (5u * (rank - 12))) & 0x1Fu;
+}
+
+/* Core cycles from the start of sampling to the end of a conversion */
+static uint32_t HostSim_AdcConvCycles(const ADC_TypeDef* regs, uint32_t channel)
+{
+    uint32_t smp = (channel < 10) ? (regs->SMPR2 >> (3u * channel)) : (regs->SMPR1 >> (3u * (channel - 10)));
+    return (HostSim_AdcSmpCycles[smp & 0x7u] + HOSTSIM_ADC_CONV_CYCLES) * HostSim_AdcClock();
+}
+
+static uint8_t HostSim_AdcTriple(void)
+{
+    return (HostSim_AdcCommon.CCR & ADC_CCR_MULTI) == HOSTSIM_ADC_TRIPLE_INTERL;
+}
+
+/* Interval between the sampling instants of two ADCs in triple interleaved mode: the sampling
+   delay of CCR, stretched so that each ADC has finished its conversion when its turn comes back */
+static uint32_t HostSim_AdcInterleave(void)
+{
+    uint32_t delay = (((HostSim_AdcCommon.CCR & ADC_CCR_DELAY) >> 8) + 5u) * HostSim_AdcClock();
+    uint32_t conv = HostSim_AdcConvCycles(&HostSim_AdcRegs[0], HostSim_AdcChannel(&HostSim_AdcRegs[0], 0));
+    return (delay * 3u >= conv) ? delay : (conv + 2u) / 3u;
+}
+
+/* Starts the regular sequence of an ADC, or the triple interleaved sequence from ADC1 */
+static void HostSim_AdcStart(uint32_t idx)
+{
+    HostSim_AdcUnitType* unit = &HostSim_AdcUnit[idx];
+    ADC_TypeDef* regs = &HostSim_AdcRegs[idx];
+
+    regs->CR2 &= ~ADC_CR2_SWSTART;
+    if ((regs->CR2 & ADC_CR2_ADON) == 0 || unit->converting || (HostSim_AdcTriple() && idx != 0)) {
+        return;
+    }
+    regs->SR |= ADC_SR_STRT;
+    unit->converting = 1;
+    unit->rank = 0;
+    unit->sample = 0;
+    unit->pairFull = 0;
+    unit->sampleAt = HostSim_Cycles;
+    unit->convEnd = HostSim_Cycles + HostSim_AdcConvCycles(regs, HostSim_AdcChannel(regs, 0));
+}
+
+/* Stores a result into DR, or into CDR once a pair is complete in triple mode */
+static void HostSim_AdcStore(uint32_t idx, uint16_t value)
+{
+    HostSim_AdcUnitType* unit = &HostSim_AdcUnit[0];
+    ADC_TypeDef* regs = &HostSim_AdcRegs[idx];
+    uint8_t detect;
+
+    regs->DR = value;
+    regs->SR |= ADC_SR_EOC;
+    HostSim_AdcStats[idx].conversions++;
+    if (HostSim_AdcTriple()) {
+        if (!unit->pairFull) {
+            unit->pair = value;
+            unit->pairFull = 1;
+            return;
+        }
+        unit->pairFull = 0;
+        HostSim_AdcCommon.CDR = unit->pair | ((uint32_t)value << 16);
+        regs = &HostSim_AdcRegs[0];
+        detect = (HostSim_AdcCommon.CCR & ADC_CCR_DMA) != 0;
+    } else {
+        unit = &HostSim_AdcUnit[idx];
+        detect = (regs->CR2 & (ADC_CR2_DMA | ADC_CR2_EOCS)) != 0;
+    }
+    /* Overruns are detected while the DMA takes the results, until its last transfer with DDS clear */
+    if (unit->drFull && detect && !unit->dmaDone) {
+        regs->SR |= ADC_SR_OVR;
+        HostSim_AdcStats[idx].overruns++;
+    }
+    unit->drFull = 1;
+}
+
+/* Completes the conversion in progress and starts the next one of the sequence */
+static void HostSim_AdcComplete(uint32_t idx)
+{
+    HostSim_AdcUnitType* unit = &HostSim_AdcUnit[idx];
+    ADC_TypeDef* regs = &HostSim_AdcRegs[idx];
+    uint32_t length = ((regs->SQR1 & ADC_SQR1_L) >> 20) + 1u;
+    uint64_t end = unit->convEnd;
+
+    if (HostSim_AdcTriple() && idx == 0) {
+        /* ADC1, ADC2 and ADC3 in turn, each on the first rank of its own sequence */
+        uint32_t adc = unit->sample % HOSTSIM_NUM_ADC;
+        uint32_t channel = HostSim_AdcChannel(&HostSim_AdcRegs[adc], 0);
+        uint32_t interval = HostSim_AdcInterleave();
+
+        HostSim_AdcStore(adc, HostSim_AdcSignal ? (HostSim_AdcSignal(channel, unit->sampleAt) & 0xFFFu) : 0);
+        unit->sample++;
+        if ((regs->CR2 & ADC_CR2_CONT) == 0 && unit->sample == HOSTSIM_NUM_ADC) {
+            unit->converting = 0;
+            return;
+        }
+        adc = unit->sample % HOSTSIM_NUM_ADC;
+        unit->sampleAt += interval;
+        unit->convEnd = unit->sampleAt +
+                        HostSim_AdcConvCycles(&HostSim_AdcRegs[adc], HostSim_AdcChannel(&HostSim_AdcRegs[adc], 0));
+        return;
+    }
+
+    uint32_t channel = HostSim_AdcChannel(regs, unit->rank);
+    HostSim_AdcStore(idx, HostSim_AdcSignal ? (HostSim_AdcSignal(channel, unit->sampleAt) & 0xFFFu) : 0);
+    unit->rank++;
+    if (unit->rank >= length || (regs->CR1 & ADC_CR1_SCAN) == 0) {
+        unit->rank = 0;
+        if ((regs->CR2 & ADC_CR2_CONT) == 0) {
+            unit->converting = 0;
+            return;
+        }
+    }
+    unit->sampleAt = end;
+    unit->convEnd = end + HostSim_AdcConvCycles(regs, HostSim_AdcChannel(regs, unit->rank));
+}
+
+/* Index of the stream serving the DMA request of an ADC, -1 if the request is not served */
+static int32_t HostSim_AdcDmaStream(uint32_t idx)
+{
+    const ADC_TypeDef* regs = &HostSim_AdcRegs[idx];
+    const HostSim_AdcUnitType* unit = &HostSim_AdcUnit[idx];
+    uint8_t enabled = HostSim_AdcTriple() ? (HostSim_AdcCommon.CCR & ADC_CCR_DMA) != 0 : (regs->CR2 & ADC_CR2_DMA) != 0;
+
+    if (!enabled || !unit->drFull || unit->dmaDone || (regs->SR & ADC_SR_OVR)) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        if (HostSim_DmaRequest(HostSim_AdcStream[idx][i], HostSim_AdcDmaChannel[idx]) != NULL) {
+            return HostSim_AdcStream[idx][i];
+        }
+    }
+    return -1;
+}
+
+/* Brings an ADC and its DMA stream up to date with the modelled clock */
+static void HostSim_AdcUpdate(uint32_t idx)
+{
+    HostSim_AdcUnitType* unit = &HostSim_AdcUnit[idx];
+    ADC_TypeDef* regs = &HostSim_AdcRegs[idx];
+    int32_t streamIdx;
+
+    for (;;) {
+        if (unit->converting && HostSim_Cycles >= unit->convEnd) {
+            HostSim_AdcComplete(idx);
+        } else if ((streamIdx = HostSim_AdcDmaStream(idx)) >= 0) {
+            uint32_t data = HostSim_AdcTriple() ? HostSim_AdcCommon.CDR : regs->DR;
+            uint32_t dds = HostSim_AdcTriple() ? (HostSim_AdcCommon.CCR & ADC_CCR_DDS) : (regs->CR2 & ADC_CR2_DDS);
+
+            memcpy(HostSim_DmaMemory((uint32_t)streamIdx), &data, HostSim_DmaSize((uint32_t)streamIdx));
+            unit->drFull = 0;
+            regs->SR &= ~ADC_SR_EOC;
+            if (HostSim_DmaStep((uint32_t)streamIdx) && dds == 0) {
+                unit->dmaDone = 1;
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+/* Core cycles per tick of the prescaled timer clock */
+static uint32_t HostSim_TimTickCycles(uint32_t idx)
+{
+    return HostSim_TimClockRatio[idx] * ((uint32_t)HostSim_TimRegs[idx].PSC + 1u);
+}
+
+/* Compare value in force on channel ch: a preloaded CCRx only takes effect at the next update event */
+static uint32_t HostSim_TimCompare(uint32_t idx, uint32_t ch)
+{
+    const TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    uint16_t ccmr = (ch < 2) ? regs->CCMR1 : regs->CCMR2;
+
+    if (ccmr & (TIM_CCMR1_OC1PE << (8u * (ch % 2u)))) {
+        return HostSim_TimUnit[idx].compare[ch];
+    }
+    return (&regs->CCR1)[ch];
+}
+
+/* Ticks until the counter next reaches Value, 1 to ARR + 1; UINT64_MAX if it never does */
+static uint64_t HostSim_TimDistance(const TIM_TypeDef* regs, uint32_t Value)
+{
+    uint64_t period = (uint64_t)regs->ARR + 1u;
+
+    if (Value > regs->ARR) {
+        return UINT64_MAX;
+    }
+    uint64_t dist = ((uint64_t)Value + period - regs->CNT) % period;
+    return (dist == 0) ? period : dist;
+}
+
+/* Restarts the prescaled clock at the current cycle, as a write of PSC through an update does */
+static void HostSim_TimRebase(uint32_t idx)
+{
+    HostSim_TimUnit[idx].base = HostSim_Cycles;
+    HostSim_TimUnit[idx].ticks = 0;
+}
+
+/* Input TI1..TI4 (0..3) captured by channel ch: CCxS maps it on its own input or on the other input
+   of its pair; HOSTSIM_TIM_NO_INPUT for an output compare channel or TRC */
+static uint32_t HostSim_TimInputOf(const TIM_TypeDef* regs, uint32_t ch)
+{
+    uint16_t ccmr = (ch < 2) ? regs->CCMR1 : regs->CCMR2;
+    uint32_t selection = (ccmr >> (8u * (ch % 2u))) & TIM_CCMR1_CC1S;
+
+    if (selection == TIM_ICSelection_DirectTI) {
+        return ch;
+    }
+    if (selection == TIM_ICSelection_IndirectTI) {
+        return ch ^ 1u;
+    }
+    return HOSTSIM_TIM_NO_INPUT;
+}
+
+/* Channel ch runs in output compare mode */
+static uint8_t HostSim_TimOutput(const TIM_TypeDef* regs, uint32_t ch)
+{
+    uint16_t ccmr = (ch < 2) ? regs->CCMR1 : regs->CCMR2;
+
+    return ((ccmr >> (8u * (ch % 2u))) & TIM_CCMR1_CC1S) == 0;
+}
+
+/* An edge to Level matches the polarity CCxP/CCxNP of channel ch: rising, falling or both */
+static uint8_t HostSim_TimPolarityMatch(const TIM_TypeDef* regs, uint32_t ch, uint8_t Level)
+{
+    uint16_t polarity = (uint16_t)((regs->CCER >> (4u * ch)) & (TIM_CCER_CC1P | TIM_CCER_CC1NP));
+
+    if (polarity == (TIM_CCER_CC1P | TIM_CCER_CC1NP)) {
+        return 1;
+    }
+    return ((polarity & TIM_CCER_CC1P) != 0) == (Level == 0);
+}
+
+/* Asks for the edges of input TIx of a timer from the current cycle on, once */
+static void HostSim_TimWatch(uint32_t idx, uint32_t input)
+{
+    HostSim_TimUnitType* unit = &HostSim_TimUnit[idx];
+
+    if (input >= HOSTSIM_TIM_NO_INPUT || (unit->watched & (1u << input))) {
+        return;
+    }
+    unit->watched |= (uint8_t)(1u << input);
+    unit->edgeAt[input] = (HostSim_TimInput != NULL) ?
+        HostSim_TimInput(HostSim_TimNumber[idx], input, HostSim_Cycles, &unit->edgeLevel[input]) : UINT64_MAX;
+}
+
+/* Input of a timer with the earliest next edge, HOSTSIM_TIM_NO_INPUT if no edge is expected */
+static uint32_t HostSim_TimNextInput(uint32_t idx)
+{
+    const HostSim_TimUnitType* unit = &HostSim_TimUnit[idx];
+    uint32_t next = HOSTSIM_TIM_NO_INPUT;
+
+    for (uint32_t input = 0; input < 4; input++) {
+        if ((unit->watched & (1u << input)) && unit->edgeAt[input] != UINT64_MAX &&
+            (next == HOSTSIM_TIM_NO_INPUT || unit->edgeAt[input] < unit->edgeAt[next])) {
+            next = input;
+        }
+    }
+    return next;
+}
+
+/* Serves a DMA request of a timer on a stream: DBL + 1 transfers of a burst when the stream
+   addresses DMAR, each to or from the next register from DBA on, or one transfer with the address of
+   the stream. Reading a capture register clears its flag, as a read by the CPU does. */
+static void HostSim_TimDmaRequest(uint32_t idx, uint32_t streamIdx)
+{
+    TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    uint32_t base = regs->DCR & TIM_DCR_DBA;
+    uint32_t length = ((regs->DCR & TIM_DCR_DBL) >> 8) + 1u;
+    DMA_Stream_TypeDef* stream;
+
+    if (streamIdx == HOSTSIM_TIM_NO_STREAM) {
+        return;
+    }
+    for (uint32_t i = 0; i < length && (stream = HostSim_DmaRequest(streamIdx, HostSim_TimDmaChannel[idx])) != NULL; i++) {
+        volatile uint32_t* target = (volatile uint32_t*)(uintptr_t)stream->PAR;
+        uint32_t value = 0;
+
+        if (target == (volatile uint32_t*)&regs->DMAR) {
+            if (base + i >= sizeof(TIM_TypeDef) / sizeof(uint32_t)) {
+                break;
+            }
+            target = (volatile uint32_t*)regs + base + i;
+        } else if (length > 1u) {
+            length = 1;
+        }
+        if ((stream->CR & DMA_SxCR_DIR) == DMA_DIR_MemoryToPeripheral) {
+            memcpy(&value, HostSim_DmaMemory(streamIdx), HostSim_DmaSize(streamIdx));
+            *target = value;
+            HostSim_TimStats[idx].dmaWrites++;
+        } else {
+            value = *target;
+            memcpy(HostSim_DmaMemory(streamIdx), &value, HostSim_DmaSize(streamIdx));
+            for (uint32_t ch = 0; ch < 4; ch++) {
+                if (target == &(&regs->CCR1)[ch] && !HostSim_TimOutput(regs, ch)) {
+                    regs->SR &= (uint16_t)~(TIM_SR_CC1IF << ch);
+                }
+            }
+            HostSim_TimStats[idx].dmaReads++;
+        }
+        HostSim_DmaStep(streamIdx);
+    }
+}
+
+/* Update event of a timer at a cycle: raises UIF, loads the preloaded compare values and requests
+   the DMA when UDE is set */
+static void HostSim_TimUpdateEvent(uint32_t idx, uint64_t at)
+{
+    TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    HostSim_TimUnitType* unit = &HostSim_TimUnit[idx];
+    HostSim_TimCaptureType* capture = &HostSim_TimCapture[idx];
+
+    regs->SR |= TIM_SR_UIF;
+    HostSim_TimStats[idx].updates++;
+    for (uint32_t ch = 0; ch < 4; ch++) {
+        unit->compare[ch] = (&regs->CCR1)[ch];
+    }
+    if (capture->buffer != NULL && capture->length < capture->size) {
+        HostSim_TimUpdateType* record = &capture->buffer[capture->length++];
+        record->at = at;
+        for (uint32_t ch = 0; ch < 4; ch++) {
+            record->compare[ch] = HostSim_TimCompare(idx, ch);
+        }
+    }
+    if (regs->DIER & TIM_DIER_UDE) {
+        HostSim_TimDmaRequest(idx, HostSim_TimUpStream[idx]);
+    }
+}
+
+/* Brings CNT up to a cycle, period by period, raising the compare flags passed on the way and
+   running the update events unless UDIS is set */
+static void HostSim_TimAdvance(uint32_t idx, uint64_t Cycle)
+{
+    TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    HostSim_TimUnitType* unit = &HostSim_TimUnit[idx];
+
+    if (Cycle < unit->base) {
+        return;
+    }
+    uint64_t now = (Cycle - unit->base) / HostSim_TimTickCycles(idx);
+    while (unit->ticks < now) {
+        uint64_t toUpdate = (uint64_t)regs->ARR + 1u - regs->CNT;
+        uint64_t step = (now - unit->ticks < toUpdate) ? now - unit->ticks : toUpdate;
+
+        for (uint32_t ch = 0; ch < 4; ch++) {
+            if (HostSim_TimOutput(regs, ch) && HostSim_TimDistance(regs, HostSim_TimCompare(idx, ch)) <= step) {
+                regs->SR |= (uint16_t)(TIM_SR_CC1IF << ch);
+            }
+        }
+        unit->ticks += step;
+        if (step < toUpdate) {
+            regs->CNT += (uint32_t)step;
+            break;
+        }
+        regs->CNT = 0;
+        if ((regs->CR1 & TIM_CR1_UDIS) == 0) {
+            HostSim_TimUpdateEvent(idx, unit->base + unit->ticks * HostSim_TimTickCycles(idx));
+        }
+    }
+}
+
+/* Edge of input TIx of a running timer at a cycle, CNT being up to date: the enabled channels mapped
+   on the input whose polarity matches capture CNT and request the DMA when CCxDE is set; then, when
+   the input is the trigger of the slave mode controller, TIF is raised, the reset mode clears the
+   counter and the prescaler with an update event, and the DMA is requested when TDE is set */
+static void HostSim_TimEdge(uint32_t idx, uint32_t input, uint8_t Level, uint64_t at)
+{
+    TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    uint32_t trigger = (regs->SMCR & TIM_SMCR_TS) >> 4;
+
+    for (uint32_t ch = 0; ch < 4; ch++) {
+        if (HostSim_TimInputOf(regs, ch) != input || (regs->CCER & (TIM_CCER_CC1E << (4u * ch))) == 0 ||
+            !HostSim_TimPolarityMatch(regs, ch, Level)) {
+            continue;
+        }
+        if (regs->SR & (TIM_SR_CC1IF << ch)) {
+            regs->SR |= (uint16_t)(TIM_SR_CC1OF << ch);
+            HostSim_TimStats[idx].overcaptures++;
+        }
+        (&regs->CCR1)[ch] = regs->CNT;
+        regs->SR |= (uint16_t)(TIM_SR_CC1IF << ch);
+        HostSim_TimStats[idx].captures++;
+        if (regs->DIER & (TIM_DIER_CC1DE << ch)) {
+            HostSim_TimDmaRequest(idx, HostSim_TimCcStream[idx][ch]);
+        }
+    }
+    /* TI1FP1 and TI2FP2 take the polarity of channels 1 and 2 */
+    if (!((trigger == HOSTSIM_TIM_TS_TI1FP1 && input == 0) || (trigger == HOSTSIM_TIM_TS_TI2FP2 && input == 1)) ||
+        !HostSim_TimPolarityMatch(regs, input, Level)) {
+        return;
+    }
+    regs->SR |= TIM_SR_TIF;
+    if ((regs->SMCR & TIM_SMCR_SMS) == HOSTSIM_TIM_SMS_RESET) {
+        regs->CNT = 0;
+        HostSim_TimUnit[idx].base = at;
+        HostSim_TimUnit[idx].ticks = 0;
+        if ((regs->CR1 & TIM_CR1_UDIS) == 0) {
+            HostSim_TimUpdateEvent(idx, at);
+        }
+    }
+    if (regs->DIER & TIM_DIER_TDE) {
+        HostSim_TimDmaRequest(idx, HostSim_TimTrgStream[idx]);
+    }
+}
+
+/* Brings a timer up to the current cycle, edge by edge of its captured inputs. The edges met while
+   the counter is stopped are dropped. */
+static void HostSim_TimUpdate(uint32_t idx)
+{
+    TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    HostSim_TimUnitType* unit = &HostSim_TimUnit[idx];
+    uint32_t input;
+
+    while ((input = HostSim_TimNextInput(idx)) != HOSTSIM_TIM_NO_INPUT && unit->edgeAt[input] <= HostSim_Cycles) {
+        uint64_t at = unit->edgeAt[input];
+        uint8_t level = unit->edgeLevel[input];
+
+        unit->edgeAt[input] = (HostSim_TimInput != NULL) ?
+            HostSim_TimInput(HostSim_TimNumber[idx], input, at, &unit->edgeLevel[input]) : UINT64_MAX;
+        if (regs->CR1 & TIM_CR1_CEN) {
+            HostSim_TimAdvance(idx, at);
+            HostSim_TimEdge(idx, input, level, at);
+        }
+    }
+    if (regs->CR1 & TIM_CR1_CEN) {
+        HostSim_TimAdvance(idx, HostSim_Cycles);
+    }
+}
+
+/* Cycle of the next flag change of a timer whose interrupt is enabled, of its next update event
+   when that requests the DMA, or of the next edge of a captured input; HOSTSIM_NO_EVENT if none */
+static uint64_t HostSim_TimNextEvent(uint32_t idx)
+{
+    const TIM_TypeDef* regs = &HostSim_TimRegs[idx];
+    uint64_t dist = UINT64_MAX;
+    uint64_t next = HOSTSIM_NO_EVENT;
+    uint32_t input = HostSim_TimNextInput(idx);
+
+    if ((regs->CR1 & TIM_CR1_CEN) == 0) {
+        return HOSTSIM_NO_EVENT;
+    }
+    for (uint32_t ch = 0; ch < 4; ch++) {
+        if (!HostSim_TimOutput(regs, ch)) {
+            continue;
+        }
+        uint64_t d = HostSim_TimDistance(regs, HostSim_TimCompare(idx, ch));
+        if ((regs->DIER & (TIM_DIER_CC1IE << ch)) && d < dist) {
+            dist = d;
+        }
+    }
+    if ((regs->DIER & (TIM_DIER_UIE | TIM_DIER_UDE)) && (uint64_t)regs->ARR + 1u - regs->CNT < dist) {
+        dist = (uint64_t)regs->ARR + 1u - regs->CNT;
+    }
+    if (dist != UINT64_MAX) {
+        next = HostSim_TimUnit[idx].base + (HostSim_TimUnit[idx].ticks + dist) * HostSim_TimTickCycles(idx);
+    }
+    if (input != HOSTSIM_TIM_NO_INPUT && HostSim_TimUnit[idx].edgeAt[input] < next) {
+        next = HostSim_TimUnit[idx].edgeAt[input];
+    }
+    return next;
+}
+
+/* Offset of flash sector Snb, and its size */
+static uint32_t HostSim_FlashSector(uint32_t Snb, uint32_t* SizePtr)
+{
+    if (Snb < 4u) {
+        *SizePtr = 0x4000u;
+        return Snb * 0x4000u;
+    }
+    if (Snb == 4u) {
+        *SizePtr = 0x10000u;
+        return 0x10000u;
+    }
+    *SizePtr = 0x20000u;
+    return (Snb - 4u) * 0x20000u;
+}
+
+/* Sector holding an offset */
+static uint32_t HostSim_FlashSectorOf(uint32_t Offset)
+{
+    if (Offset < 0x10000u) {
+        return Offset / 0x4000u;
+    }
+    return (Offset < 0x20000u) ? 4u : 4u + Offset / 0x20000u;
+}
+
+/* Sector write protected by its nWRP bit of OPTCR cleared */
+static uint8_t HostSim_FlashProtected(uint32_t Sector)
+{
+    return (HostSim_FlashRegs.OPTCR & (FLASH_OPTCR_nWRP_0 << Sector)) == 0;
+}
+
+/* Rejects an operation: the error flag, and OPERR when the error interrupt is enabled */
+static void HostSim_FlashError(uint32_t flag)
+{
+    HostSim_FlashRegs.SR |= flag;
+    if (HostSim_FlashRegs.CR & FLASH_IT_ERR) {
+        HostSim_FlashRegs.SR |= FLASH_FLAG_OPERR;
+    }
+}
+
+/* Starts an erase, or the programming of the unit in data */
+static void HostSim_FlashStart(uint8_t erase, uint32_t offset, uint32_t size, uint64_t cycles)
+{
+    HostSim_FlashUnitType* unit = &HostSim_FlashUnit;
+
+    unit->busy = 1;
+    unit->erase = erase;
+    unit->offset = offset;
+    unit->size = size;
+    unit->startAt = HostSim_Cycles;
+    unit->endAt = HostSim_Cycles + cycles;
+    HostSim_FlashRegs.SR |= FLASH_FLAG_BSY;
+}
+
+/* Completes the operation in progress once the clock has reached its end: an erase sets the
+   sector to 0xFF, programming can only clear bits */
+static void HostSim_FlashUpdate(void)
+{
+    HostSim_FlashUnitType* unit = &HostSim_FlashUnit;
+
+    if (!unit->busy || HostSim_Cycles < unit->endAt) {
+        return;
+    }
+    if (unit->erase) {
+        memset(&HostSim_FlashMemory[unit->offset], 0xFF, unit->size);
+        HostSim_FlashStats.erases++;
+    } else {
+        for (uint32_t i = 0; i < unit->size; i++) {
+            HostSim_FlashMemory[unit->offset + i] &= unit->data[i];
+        }
+        HostSim_FlashStats.programs++;
+    }
+    HostSim_FlashStats.busyCycles += unit->endAt - unit->startAt;
+    unit->busy = 0;
+    HostSim_FlashRegs.SR &= ~FLASH_FLAG_BSY;
+    HostSim_FlashRegs.CR &= ~FLASH_CR_STRT;
+    if (HostSim_FlashRegs.CR & FLASH_IT_EOP) {
+        HostSim_FlashRegs.SR |= FLASH_FLAG_EOP;
+    }
+}
+
+/* Holds the CPU on a flash access until the operation in progress ends: the bus stalls, so no
+   interrupt is taken meanwhile */
+static void HostSim_FlashStall(void)
+{
+    if (HostSim_FlashUnit.busy) {
+        uint64_t from = HostSim_Cycles;
+        uint32_t masked = HostSim_IrqMasked;
+        HostSim_IrqMasked = 1;
+        HostSim_Run(HostSim_FlashUnit.endAt);
+        HostSim_IrqMasked = masked;
+        HostSim_FlashStats.stallCycles += HostSim_Cycles - from;
+    }
+}
+
+/* Write of CR: STRT with SER starts the erase of sector SNB */
+static void HostSim_FlashWriteCr(uint32_t Value)
+{
+    FLASH_TypeDef* regs = &HostSim_FlashRegs;
+    uint32_t psize = (Value & FLASH_CR_PSIZE) >> 8;
+    uint32_t snb = (Value & FLASH_CR_SNB) >> 3;
+    uint32_t size;
+
+    if (regs->CR & FLASH_CR_LOCK) {
+        return;
+    }
+    if (Value & FLASH_CR_STRT) {
+        HostSim_FlashStall();
+    }
+    regs->CR = Value;
+    if (!(Value & FLASH_CR_STRT)) {
+        return;
+    }
+    if (!(Value & FLASH_CR_SER) || snb >= HOSTSIM_FLASH_SECTORS) {
+        regs->CR &= ~FLASH_CR_STRT;
+        HostSim_FlashError(FLASH_FLAG_PGSERR);
+        return;
+    }
+    if (HostSim_FlashProtected(snb)) {
+        regs->CR &= ~FLASH_CR_STRT;
+        HostSim_FlashError(FLASH_FLAG_WRPERR);
+        return;
+    }
+    uint32_t offset = HostSim_FlashSector(snb, &size);
+    uint32_t kind = (size == 0x4000u) ? 0u : (size == 0x10000u) ? 1u : 2u;
+    HostSim_FlashStart(1, offset, size, (uint64_t)HostSim_FlashEraseMs[psize][kind] * (HOSTSIM_CORE_CLOCK_HZ / 1000u));
+}
+
+/* Store of a word into the memory: with PG set, programs it at x32, or the double word it
+   completes at x64 */
+static void HostSim_FlashStore(uint32_t Offset, uint32_t Value)
+{
+    FLASH_TypeDef* regs = &HostSim_FlashRegs;
+    HostSim_FlashUnitType* unit = &HostSim_FlashUnit;
+    uint32_t psize = (regs->CR & FLASH_CR_PSIZE) >> 8;
+    uint64_t cycles = (uint64_t)HOSTSIM_FLASH_PROGRAM_US * (HOSTSIM_CORE_CLOCK_HZ / 1000000u);
+
+    HostSim_FlashStall();
+    if ((regs->CR & FLASH_CR_LOCK) || !(regs->CR & FLASH_CR_PG)) {
+        HostSim_FlashError(FLASH_FLAG_PGSERR);
+    } else if (psize < 2u) {
+        HostSim_FlashError(FLASH_FLAG_PGPERR);
+    } else if (HostSim_FlashProtected(HostSim_FlashSectorOf(Offset))) {
+        unit->latched = 0;
+        HostSim_FlashError(FLASH_FLAG_WRPERR);
+    } else if (psize == 2u) {
+        if (Offset % 4u != 0) {
+            HostSim_FlashError(FLASH_FLAG_PGAERR);
+            return;
+        }
+        memcpy(unit->data, &Value, 4);
+        HostSim_FlashStart(0, Offset, 4, cycles);
+    } else if (!unit->latched) {
+        if (Offset % 8u != 0) {
+            HostSim_FlashError(FLASH_FLAG_PGAERR);
+            return;
+        }
+        memcpy(unit->data, &Value, 4);
+        unit->offset = Offset;
+        unit->latched = 1;
+    } else {
+        unit->latched = 0;
+        if (Offset != unit->offset + 4u) {
+            HostSim_FlashError(FLASH_FLAG_PGAERR);
+            return;
+        }
+        memcpy(&unit->data[4], &Value, 4);
+        HostSim_FlashStart(0, unit->offset, 8, cycles);
+    }
+}
+
+/* Handler of an interrupt whose enabled flag is set and whose line is enabled, NULL if none */
+static void (*HostSim_PendingIrq(void))(void)
+{
+    for (uint32_t s = 0; s < HOSTSIM_NUM_DMA * HOSTSIM_NUM_STREAMS; s++) {
+        uint32_t flags = *HostSim_DmaIsr(s) >> HostSim_DmaFlagShift[s % 4];
+        uint32_t cr = HostSim_Stream(s)->CR;
+        if (HostSim_IrqEnabled[HostSim_DmaIRQn[s]] && HostSim_DmaHandler[s] != NULL &&
+            (((cr & DMA_SxCR_TCIE) && (flags & HOSTSIM_DMA_FLAG_TC)) ||
+             ((cr & DMA_SxCR_HTIE) && (flags & HOSTSIM_DMA_FLAG_HT)) ||
+             ((cr & DMA_SxCR_TEIE) && (flags & HOSTSIM_DMA_FLAG_TE)))) {
+            return HostSim_DmaHandler[s];
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_SPI; i++) {
+        uint16_t cr2 = HostSim_SpiRegs[i].CR2;
+        uint16_t sr = HostSim_SpiRegs[i].SR;
+        if (HostSim_IrqEnabled[HostSim_SpiIRQn[i]] && HostSim_SpiHandler[i] != NULL &&
+            (((cr2 & SPI_CR2_TXEIE) && (sr & SPI_I2S_FLAG_TXE)) ||
+             ((cr2 & SPI_CR2_RXNEIE) && (sr & SPI_I2S_FLAG_RXNE)))) {
+            return HostSim_SpiHandler[i];
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_CAN; i++) {
+        const CAN_TypeDef* regs = &HostSim_CanRegs[i];
+        uint8_t raised[3] = {
+            (regs->IER & CAN_IER_TMEIE) && (regs->TSR & (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2)),
+            (regs->IER & CAN_IER_FMPIE0) && (regs->RF0R & CAN_RF0R_FMP0),
+            (regs->IER & CAN_IER_FMPIE1) && (regs->RF1R & CAN_RF1R_FMP1),
+        };
+        for (uint32_t line = 0; line < 3; line++) {
+            if (raised[line] && HostSim_IrqEnabled[HostSim_CanIRQn[i][line]] && HostSim_CanHandler[i][line] != NULL) {
+                return HostSim_CanHandler[i][line];
+            }
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_ADC; i++) {
+        const ADC_TypeDef* regs = &HostSim_AdcRegs[i];
+        if (HostSim_IrqEnabled[ADC_IRQn] && ADC_IRQHandler != NULL &&
+            (((regs->CR1 & ADC_CR1_OVRIE) && (regs->SR & ADC_SR_OVR)) ||
+             ((regs->CR1 & ADC_CR1_EOCIE) && (regs->SR & ADC_SR_EOC)))) {
+            return ADC_IRQHandler;
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_USART; i++) {
+        const USART_TypeDef* regs = &HostSim_UsartRegs[i];
+        if (HostSim_IrqEnabled[HostSim_UsartIRQn[i]] && HostSim_UsartHandler[i] != NULL &&
+            (((regs->CR2 & USART_CR2_LBDIE) && (regs->SR & USART_FLAG_LBD)) ||
+             ((regs->CR1 & USART_CR1_RXNEIE) && (regs->SR & (USART_FLAG_RXNE | USART_FLAG_ORE))) ||
+             ((regs->CR1 & USART_CR1_TCIE) && (regs->SR & USART_FLAG_TC)) ||
+             ((regs->CR1 & USART_CR1_TXEIE) && (regs->SR & USART_FLAG_TXE)))) {
+            return HostSim_UsartHandler[i];
+        }
+    }
+    if (HostSim_IrqEnabled[FLASH_IRQn] && FLASH_IRQHandler != NULL &&
+        (((HostSim_FlashRegs.CR & FLASH_IT_EOP) && (HostSim_FlashRegs.SR & FLASH_FLAG_EOP)) ||
+         ((HostSim_FlashRegs.CR & FLASH_IT_ERR) && (HostSim_FlashRegs.SR & FLASH_FLAG_OPERR)))) {
+        return FLASH_IRQHandler;
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_TIM; i++) {
+        uint16_t raised = HostSim_TimRegs[i].DIER & HostSim_TimRegs[i].SR;
+        if ((raised & TIM_DIER_UIE) && HostSim_IrqEnabled[HostSim_TimUpIRQn[i]] && HostSim_TimUpHandler[i] != NULL) {
+            return HostSim_TimUpHandler[i];
+        }
+        if ((raised & HOSTSIM_TIM_SR_CC_MASK) && HostSim_IrqEnabled[HostSim_TimCcIRQn[i]] && HostSim_TimCcHandler[i] != NULL) {
+            return HostSim_TimCcHandler[i];
+        }
+    }
+    return NULL;
+}
+
+/* Enters one interrupt handler, charging the exception entry and exit */
+static void HostSim_EnterIrq(void (*handler)(void))
+{
+    HostSim_InIsr = 1;
+    HostSim_IrqCount++;
+    HostSim_Run(HostSim_Cycles + HostSim_IrqCycles / 2);
+    handler();
+    HostSim_Run(HostSim_Cycles + HostSim_IrqCycles - HostSim_IrqCycles / 2);
+    HostSim_InIsr = 0;
+}
+
+/* Runs the pending interrupt handlers when interrupts are not masked */
+static void HostSim_Dispatch(void)
+{
+    void (*handler)(void);
+
+    if (HostSim_IrqMasked || HostSim_InIsr) {
+        return;
+    }
+    while ((handler = HostSim_PendingIrq()) != NULL) {
+        HostSim_EnterIrq(handler);
+    }
+}
+
+static uint64_t HostSim_NextEvent(void)
+{
+    uint64_t next = HOSTSIM_NO_EVENT;
+    for (uint32_t i = 0; i < HOSTSIM_NUM_SPI; i++) {
+        const HostSim_SpiUnitType* unit = &HostSim_SpiUnit[i];
+        if (unit->shifting && unit->shiftEnd < next) {
+            next = unit->shiftEnd;
+        }
+        if (unit->rxPending && unit->rxneAt < next) {
+            next = unit->rxneAt;
+        }
+        if (unit->txePending && unit->txeAt < next) {
+            next = unit->txeAt;
+        }
+        if (unit->bsyClearAt > HostSim_Cycles && unit->bsyClearAt < next) {
+            next = unit->bsyClearAt;
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_USART; i++) {
+        if (HostSim_UsartUnit[i].shifting && HostSim_UsartUnit[i].shiftEnd < next) {
+            next = HostSim_UsartUnit[i].shiftEnd;
+        }
+        if (HostSim_UsartUnit[i].linSending && HostSim_UsartUnit[i].linNextAt < next) {
+            next = HostSim_UsartUnit[i].linNextAt;
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_CAN; i++) {
+        const HostSim_CanNodeType* node = &HostSim_CanNode[i];
+        if (HostSim_CanUnit[i].busy) {
+            if (HostSim_CanUnit[i].frameEnd < next) {
+                next = HostSim_CanUnit[i].frameEnd;
+            }
+        } else if (node->frames != NULL && node->sent < node->count && node->frames[node->sent].at < next) {
+            next = node->frames[node->sent].at;
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_ADC; i++) {
+        if (HostSim_AdcUnit[i].converting && HostSim_AdcUnit[i].convEnd < next) {
+            next = HostSim_AdcUnit[i].convEnd;
+        }
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_TIM; i++) {
+        uint64_t at = HostSim_TimNextEvent(i);
+        if (at < next) {
+            next = at;
+        }
+    }
+    if (HostSim_FlashUnit.busy && HostSim_FlashUnit.endAt < next) {
+        next = HostSim_FlashUnit.endAt;
+    }
+    return next;
+}
+
+static void HostSim_Service(void)
+{
+    for (uint32_t i = 0; i < HOSTSIM_NUM_SPI; i++) {
+        HostSim_SpiUpdate(i);
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_USART; i++) {
+        HostSim_UsartUpdate(i);
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_CAN; i++) {
+        HostSim_CanUpdate(i);
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_ADC; i++) {
+        HostSim_AdcUpdate(i);
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_TIM; i++) {
+        HostSim_TimUpdate(i);
+    }
+    HostSim_FlashUpdate();
+}
+
+/* Advances the modelled clock to Target, processing every frame end on the way */
+static void HostSim_Run(uint64_t Target)
+{
+    uint64_t next;
+
+    while ((next = HostSim_NextEvent()) <= Target) {
+        if (next > HostSim_Cycles) {
+            HostSim_Cycles = next;
+            HostSim_Dwt.CYCCNT = (uint32_t)HostSim_Cycles;
+        }
+        HostSim_Service();
+        HostSim_Dispatch();
+    }
+    if (Target > HostSim_Cycles) {
+        HostSim_Cycles = Target;
+    }
+    HostSim_Dwt.CYCCNT = (uint32_t)HostSim_Cycles;
+    HostSim_Service();
+    HostSim_Dispatch();
+}
+
+void HostSim_Reset(void)
+{
+    memset(HostSim_Gpio, 0, sizeof(HostSim_Gpio));
+    memset(HostSim_GpioStats, 0, sizeof(HostSim_GpioStats));
+    memset(HostSim_GpioInput, 0, sizeof(HostSim_GpioInput));
+    memset(HostSim_SpiRegs, 0, sizeof(HostSim_SpiRegs));
+    memset(HostSim_SpiUnit, 0, sizeof(HostSim_SpiUnit));
+    memset(HostSim_SpiStats, 0, sizeof(HostSim_SpiStats));
+    memset(HostSim_UsartRegs, 0, sizeof(HostSim_UsartRegs));
+    memset(HostSim_UsartUnit, 0, sizeof(HostSim_UsartUnit));
+    memset(HostSim_UsartStats, 0, sizeof(HostSim_UsartStats));
+    memset(HostSim_DmaRegs, 0, sizeof(HostSim_DmaRegs));
+    memset(HostSim_DmaStreams, 0, sizeof(HostSim_DmaStreams));
+    memset(HostSim_DmaPos, 0, sizeof(HostSim_DmaPos));
+    memset(HostSim_DmaLength, 0, sizeof(HostSim_DmaLength));
+    memset(HostSim_CanRegs, 0, sizeof(HostSim_CanRegs));
+    memset(HostSim_CanUnit, 0, sizeof(HostSim_CanUnit));
+    memset(HostSim_CanStats, 0, sizeof(HostSim_CanStats));
+    memset(HostSim_AdcRegs, 0, sizeof(HostSim_AdcRegs));
+    memset(&HostSim_AdcCommon, 0, sizeof(HostSim_AdcCommon));
+    memset(HostSim_AdcUnit, 0, sizeof(HostSim_AdcUnit));
+    memset(HostSim_AdcStats, 0, sizeof(HostSim_AdcStats));
+    memset(HostSim_TimRegs, 0, sizeof(HostSim_TimRegs));
+    memset(HostSim_TimUnit, 0, sizeof(HostSim_TimUnit));
+    memset(HostSim_TimStats, 0, sizeof(HostSim_TimStats));
+    memset(&HostSim_FlashRegs, 0, sizeof(HostSim_FlashRegs));
+    memset(&HostSim_FlashUnit, 0, sizeof(HostSim_FlashUnit));
+    memset(&HostSim_FlashStats, 0, sizeof(HostSim_FlashStats));
+    memset(HostSim_IrqEnabled, 0, sizeof(HostSim_IrqEnabled));
+    memset(&HostSim_Dwt, 0, sizeof(HostSim_Dwt));
+    memset(&HostSim_CoreDebug, 0, sizeof(HostSim_CoreDebug));
+    HostSim_Cycles = 0;
+    HostSim_RegAccesses = 0;
+    HostSim_IrqCount = 0;
+    HostSim_IrqMasked = 0;
+    for (uint32_t i = 0; i < HOSTSIM_NUM_SPI; i++) {
+        HostSim_SpiRegs[i].SR = SPI_I2S_FLAG_TXE;
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_USART; i++) {
+        HostSim_UsartRegs[i].SR = HOSTSIM_USART_SR_RESET;
+        HostSim_UsartCapture[i].length = 0;
+        HostSim_LinNode[i].count = 0;
+        HostSim_LinNode[i].responses = 0;
+    }
+    for (uint32_t i = 0; i < HOSTSIM_NUM_CAN; i++) {
+        HostSim_CanRegs[i].TSR = CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2;
+        HostSim_CanNode[i].sent = 0;
+        HostSim_CanCapture[i].length = 0;
+    }
+    HostSim_CanRegs[0].FMR = HOSTSIM_CAN_FMR_RESET;
+    for (uint32_t i = 0; i < HOSTSIM_NUM_TIM; i++) {
+        HostSim_TimRegs[i].ARR = HostSim_TimWide[i] ? 0xFFFFFFFFu : 0xFFFFu;
+        HostSim_TimCapture[i].length = 0;
+    }
+    HostSim_FlashRegs.CR = FLASH_CR_LOCK;
+    HostSim_FlashRegs.OPTCR = FLASH_OPTCR_nWRP | FLASH_OPTCR_OPTLOCK;
+    if (!HostSim_FlashErased) {
+        memset(HostSim_FlashMemory, 0xFF, sizeof(HostSim_FlashMemory));
+        HostSim_FlashErased = 1;
+    }
+}
+
+void HostSim_Idle(uint32_t Cycles)
+{
+    HostSim_Run(HostSim_Cycles + Cycles);
+}
+
+uint32_t HostSim_DisableIrq(void)
+{
+    uint32_t state = HostSim_IrqMasked;
+    HostSim_IrqMasked = 1;
+    return state;
+}
+
+void HostSim_RestoreIrq(uint32_t State)
+{
+    HostSim_IrqMasked = State;
+    HostSim_Dispatch();
+}
+
+void HostSim_WaitForInterrupt(void)
+{
+    uint64_t next;
+
+    /* Jump from frame end to frame end until an interrupt is pending */
+    while (HostSim_PendingIrq() == NULL) {
+        next = HostSim_NextEvent();
+        if (next == HOSTSIM_NO_EVENT) {
+            /* Nothing left that could wake the core */
+            HostSim_Run(HostSim_Cycles + HostSim_BusCycles);
+            return;
+        }
+        HostSim_Run(next);
+    }
+}
+
+uint8_t HostSim_SpiInjectIrq(uint32_t Idx)
+{
+    if (Idx >= HOSTSIM_NUM_SPI || HostSim_SpiHandler[Idx] == NULL || HostSim_IrqMasked || HostSim_InIsr) {
+        return 0;
+    }
+    HostSim_EnterIrq(HostSim_SpiHandler[Idx]);
+    HostSim_Dispatch();
+    return 1;
+}
+
+/* GPIO port holding a register, HOSTSIM_NUM_GPIO for a register of another peripheral */
+static uint32_t HostSim_GpioPort(volatile uint32_t* Reg, uint32_t* offset)
+{
+    uintptr_t addr = (uintptr_t)Reg;
+    uintptr_t base = (uintptr_t)HostSim_Gpio;
+
+    if (addr < base || addr >= base + sizeof(HostSim_Gpio)) {
+        return HOSTSIM_NUM_GPIO;
+    }
+    *offset = (uint32_t)((addr - base) % HOSTSIM_GPIO_STRIDE);
+    return (uint32_t)((addr - base) / HOSTSIM_GPIO_STRIDE);
+}
+
+/* Pins of a port configured as general purpose outputs (MODER = 01) */
+static uint16_t HostSim_GpioOutputs(const GPIO_TypeDef* gpio)
+{
+    uint16_t outputs = 0;
+    for (uint32_t pin = 0; pin < 16; pin++) {
+        if (((gpio->MODER >> (pin * 2)) & 0x3u) == 0x1u) {
+            outputs |= (uint16_t)(1u << pin);
+        }
+    }
+    return outputs;
+}
+
+/* Drives the output latch of a port, counting the pin changes */
+static void HostSim_GpioDrive(uint32_t port, uint32_t odr)
+{
+    GPIO_TypeDef* gpio = &HostSim_Gpio[port].regs;
+    uint32_t changed = (gpio->ODR ^ odr) & 0xFFFFu;
+
+    gpio->ODR = odr & 0xFFFFu;
+    HostSim_GpioStats[port].writes++;
+    HostSim_GpioStats[port].edges += (uint64_t)__builtin_popcount(changed);
+}
+
+/* Offset of a word of the flash memory, HOSTSIM_FLASH_SIZE for another address */
+static uint32_t HostSim_FlashOffset(volatile uint32_t* Reg)
+{
+    uintptr_t addr = (uintptr_t)Reg;
+    uintptr_t base = (uintptr_t)HostSim_FlashMemory;
+
+    if (addr < base || addr >= base + HOSTSIM_FLASH_SIZE) {
+        return HOSTSIM_FLASH_SIZE;
+    }
+    return (uint32_t)(addr - base);
+}
+
+uint32_t HostSim_ReadReg(volatile uint32_t* Reg)
+{
+    uint32_t offset;
+    uint32_t port = HostSim_GpioPort(Reg, &offset);
+
+    HostSim_Access();
+    if (HostSim_FlashOffset(Reg) < HOSTSIM_FLASH_SIZE) {
+        HostSim_FlashStall();
+    }
+    if (port < HOSTSIM_NUM_GPIO && offset == offsetof(GPIO_TypeDef, IDR)) {
+        GPIO_TypeDef* gpio = &HostSim_Gpio[port].regs;
+        uint16_t outputs = HostSim_GpioOutputs(gpio);
+        gpio->IDR = (gpio->ODR & outputs) | (HostSim_GpioInput[port] & (uint16_t)~outputs);
+    }
+    return *Reg;
+}
+
+/* CAN controller holding a register, HOSTSIM_NUM_CAN for a register of another peripheral */
+static uint32_t HostSim_CanOf(volatile uint32_t* Reg)
+{
+    uintptr_t addr = (uintptr_t)Reg;
+    uintptr_t base = (uintptr_t)HostSim_CanRegs;
+
+    if (addr < base || addr >= base + sizeof(HostSim_CanRegs)) {
+        return HOSTSIM_NUM_CAN;
+    }
+    return (uint32_t)((addr - base) / sizeof(CAN_TypeDef));
+}
+
+void HostSim_WriteReg(volatile uint32_t* Reg, uint32_t Value)
+{
+    uint32_t offset = 0;
+    uint32_t port = HostSim_GpioPort(Reg, &offset);
+    uint32_t can = HostSim_CanOf(Reg);
+    uint32_t flash = HostSim_FlashOffset(Reg);
+
+    HostSim_Access();
+    if (can < HOSTSIM_NUM_CAN) {
+        HostSim_CanWrite(can, Reg, Value);
+    } else if (flash < HOSTSIM_FLASH_SIZE) {
+        HostSim_FlashStore(flash, Value);
+    } else if (Reg == &HostSim_FlashRegs.CR) {
+        HostSim_FlashWriteCr(Value);
+    } else if (Reg == &HostSim_FlashRegs.SR) {
+        HostSim_FlashRegs.SR &= ~(Value & HOSTSIM_FLASH_SR_W1C);
+    } else if (Reg == &HostSim_FlashRegs.KEYR) {
+        /* KEY1 then KEY2 clears LOCK; any other write leaves it set */
+        uint8_t step = HostSim_FlashUnit.keyStep;
+        HostSim_FlashUnit.keyStep = (step == 0 && Value == FLASH_KEY1);
+        if (step == 1 && Value == FLASH_KEY2) {
+            HostSim_FlashRegs.CR &= ~FLASH_CR_LOCK;
+        }
+    } else if (port >= HOSTSIM_NUM_GPIO) {
+        *Reg = Value;
+    } else if (offset == offsetof(GPIO_TypeDef, BSRR)) {
+        /* Set bits win over reset bits of the same pin */
+        uint32_t odr = HostSim_Gpio[port].regs.ODR;
+        HostSim_GpioDrive(port, (odr & ~(Value >> 16)) | (Value & 0xFFFFu));
+    } else if (offset == offsetof(GPIO_TypeDef, ODR)) {
+        HostSim_GpioDrive(port, Value);
+    } else if (offset != offsetof(GPIO_TypeDef, IDR)) {
+        *Reg = Value;
+    }
+}
+
+/* StdPeriph RCC */
+
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState)
+{
+    (void)RCC_AHB1Periph;
+    (void)NewState;
+    HostSim_Access();
+}
+
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+    (void)RCC_APB1Periph;
+    (void)NewState;
+    HostSim_Access();
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+    (void)RCC_APB2Periph;
+    (void)NewState;
+    HostSim_Access();
+}
+
+/* StdPeriph NVIC */
+
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct)
+{
+    HostSim_IrqEnabled[NVIC_InitStruct->NVIC_IRQChannel] = (NVIC_InitStruct->NVIC_IRQChannelCmd != DISABLE);
+    HostSim_Access();
+}
+
+/* StdPeriph SPI */
+
+void SPI_I2S_DeInit(SPI_TypeDef* SPIx)
+{
+    uint32_t idx = HostSim_SpiIndex(SPIx);
+    memset(SPIx, 0, sizeof(*SPIx));
+    memset(&HostSim_SpiUnit[idx], 0, sizeof(HostSim_SpiUnit[idx]));
+    SPIx->SR = SPI_I2S_FLAG_TXE;
+    HostSim_Access();
+}
+
+void SPI_Init(SPI_TypeDef* SPIx, SPI_InitTypeDef* SPI_InitStruct)
+{
+    HostSim_Access();
+    SPIx->CR1 = (uint16_t)(SPI_InitStruct->SPI_Direction | SPI_InitStruct->SPI_Mode |
+                           SPI_InitStruct->SPI_DataSize | SPI_InitStruct->SPI_CPOL |
+                           SPI_InitStruct->SPI_CPHA | SPI_InitStruct->SPI_NSS |
+                           SPI_InitStruct->SPI_BaudRatePrescaler | SPI_InitStruct->SPI_FirstBit);
+    SPIx->CRCPR = SPI_InitStruct->SPI_CRCPolynomial;
+}
+
+void SPI_Cmd(SPI_TypeDef* SPIx, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        SPIx->CR1 |= SPI_CR1_SPE;
+    } else {
+        SPIx->CR1 &= (uint16_t)~SPI_CR1_SPE;
+    }
+    HostSim_Access();
+}
+
+void SPI_DataSizeConfig(SPI_TypeDef* SPIx, uint16_t SPI_DataSize)
+{
+    SPIx->CR1 = (uint16_t)((SPIx->CR1 & ~SPI_DataSize_16b) | SPI_DataSize);
+    HostSim_Access();
+}
+
+void SPI_I2S_DMACmd(SPI_TypeDef* SPIx, uint16_t SPI_I2S_DMAReq, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        SPIx->CR2 |= SPI_I2S_DMAReq;
+    } else {
+        SPIx->CR2 &= (uint16_t)~SPI_I2S_DMAReq;
+    }
+    HostSim_Access();
+}
+
+void SPI_I2S_ITConfig(SPI_TypeDef* SPIx, uint8_t SPI_I2S_IT, FunctionalState NewState)
+{
+    uint16_t itmask = (uint16_t)(1u << (SPI_I2S_IT >> 4));
+    if (NewState != DISABLE) {
+        SPIx->CR2 |= itmask;
+    } else {
+        SPIx->CR2 &= (uint16_t)~itmask;
+    }
+    HostSim_Access();
+}
+
+void SPI_I2S_SendData(SPI_TypeDef* SPIx, uint16_t Data)
+{
+    HostSim_SpiPush(HostSim_SpiIndex(SPIx), Data);
+    HostSim_Access();
+}
+
+uint16_t SPI_I2S_ReceiveData(SPI_TypeDef* SPIx)
+{
+    uint32_t idx = HostSim_SpiIndex(SPIx);
+    uint16_t data = HostSim_SpiUnit[idx].rxData;
+
+    SPIx->SR &= (uint16_t)~SPI_I2S_FLAG_RXNE;
+    HostSim_Access();
+    return data;
+}
+
+FlagStatus SPI_I2S_GetFlagStatus(SPI_TypeDef* SPIx, uint16_t SPI_I2S_FLAG)
+{
+    HostSim_Access();
+    return (SPIx->SR & SPI_I2S_FLAG) ? SET : RESET;
+}
+
+/* StdPeriph USART */
+
+void USART_DeInit(USART_TypeDef* USARTx)
+{
+    uint32_t idx = HostSim_UsartIndex(USARTx);
+    memset(USARTx, 0, sizeof(*USARTx));
+    memset(&HostSim_UsartUnit[idx], 0, sizeof(HostSim_UsartUnit[idx]));
+    USARTx->SR = HOSTSIM_USART_SR_RESET;
+    HostSim_Access();
+}
+
+void USART_Init(USART_TypeDef* USARTx, USART_InitTypeDef* USART_InitStruct)
+{
+    uint32_t idx = HostSim_UsartIndex(USARTx);
+    uint32_t apbclock = HOSTSIM_CORE_CLOCK_HZ / HostSim_UsartApbRatio[idx];
+
+    HostSim_Access();
+    USARTx->CR1 = (uint16_t)((USARTx->CR1 & USART_CR1_UE) | USART_InitStruct->USART_WordLength |
+                             USART_InitStruct->USART_Parity | USART_InitStruct->USART_Mode);
+    USARTx->CR2 = USART_InitStruct->USART_StopBits;
+    USARTx->CR3 = (uint16_t)((USARTx->CR3 & (USART_CR3_DMAT | USART_CR3_DMAR)) | USART_InitStruct->USART_HardwareFlowControl);
+    /* Oversampling by 16: BRR is the APB clock divided by the baud rate */
+    USARTx->BRR = (uint16_t)((apbclock + USART_InitStruct->USART_BaudRate / 2u) / USART_InitStruct->USART_BaudRate);
+}
+
+void USART_Cmd(USART_TypeDef* USARTx, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        USARTx->CR1 |= USART_CR1_UE;
+    } else {
+        USARTx->CR1 &= (uint16_t)~USART_CR1_UE;
+    }
+    HostSim_Access();
+}
+
+void USART_DMACmd(USART_TypeDef* USARTx, uint16_t USART_DMAReq, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        USARTx->CR3 |= USART_DMAReq;
+    } else {
+        USARTx->CR3 &= (uint16_t)~USART_DMAReq;
+    }
+    HostSim_Access();
+}
+
+void USART_SendData(USART_TypeDef* USARTx, uint16_t Data)
+{
+    HostSim_UsartPush(HostSim_UsartIndex(USARTx), Data);
+    HostSim_Access();
+}
+
+/* Reading DR clears RXNE and, after the read of SR, the error flags */
+uint16_t USART_ReceiveData(USART_TypeDef* USARTx)
+{
+    HostSim_Access();
+    USARTx->SR &= (uint16_t)~(USART_FLAG_RXNE | HOSTSIM_USART_SR_RX_ERRORS);
+    return HostSim_UsartUnit[HostSim_UsartIndex(USARTx)].rxData;
+}
+
+void USART_SendBreak(USART_TypeDef* USARTx)
+{
+    uint32_t idx = HostSim_UsartIndex(USARTx);
+
+    HostSim_Access();
+    USARTx->CR1 |= USART_CR1_SBK;
+    if ((USARTx->CR1 & (USART_CR1_UE | USART_CR1_TE)) == (USART_CR1_UE | USART_CR1_TE) &&
+        !HostSim_UsartUnit[idx].shifting) {
+        HostSim_UsartShift(idx, HostSim_Cycles, 0);
+    }
+}
+
+void USART_LINCmd(USART_TypeDef* USARTx, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        USARTx->CR2 |= USART_CR2_LINEN;
+    } else {
+        USARTx->CR2 &= (uint16_t)~USART_CR2_LINEN;
+    }
+    HostSim_Access();
+}
+
+void USART_LINBreakDetectLengthConfig(USART_TypeDef* USARTx, uint16_t USART_LINBreakDetectLength)
+{
+    USARTx->CR2 = (uint16_t)((USARTx->CR2 & ~USART_CR2_LBDL) | USART_LINBreakDetectLength);
+    HostSim_Access();
+}
+
+/* USART_IT_x: register (1 CR1, 2 CR2, 3 CR3) in bits 5..7 and bit of the enable in bits 0..4, bit
+   of the flag in SR in bits 8..15 */
+static volatile uint16_t* HostSim_UsartItReg(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+    uint32_t reg = (USART_IT & 0xFFu) >> 5;
+    return (reg == 1u) ? &USARTx->CR1 : (reg == 2u) ? &USARTx->CR2 : &USARTx->CR3;
+}
+
+void USART_ITConfig(USART_TypeDef* USARTx, uint16_t USART_IT, FunctionalState NewState)
+{
+    volatile uint16_t* reg = HostSim_UsartItReg(USARTx, USART_IT);
+    uint16_t mask = (uint16_t)(1u << (USART_IT & 0x1Fu));
+
+    if (NewState != DISABLE) {
+        *reg |= mask;
+    } else {
+        *reg &= (uint16_t)~mask;
+    }
+    HostSim_Access();
+}
+
+ITStatus USART_GetITStatus(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+    HostSim_Accesses(2);
+    return ((*HostSim_UsartItReg(USARTx, USART_IT) & (1u << (USART_IT & 0x1Fu))) &&
+            (USARTx->SR & (1u << (USART_IT >> 8)))) ? SET : RESET;
+}
+
+void USART_ClearITPendingBit(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+    USARTx->SR &= (uint16_t)~(1u << (USART_IT >> 8));
+    HostSim_Access();
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef* USARTx, uint16_t USART_FLAG)
+{
+    HostSim_Access();
+    return (USARTx->SR & USART_FLAG) ? SET : RESET;
+}
+
+void USART_ClearFlag(USART_TypeDef* USARTx, uint16_t USART_FLAG)
+{
+    USARTx->SR &= (uint16_t)~USART_FLAG;
+    HostSim_Access();
+}
+
+/* StdPeriph DMA */
+
+void DMA_DeInit(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+    uint32_t s = HostSim_StreamIndex(DMAy_Streamx);
+    memset(DMAy_Streamx, 0, sizeof(*DMAy_Streamx));
+    *HostSim_DmaIsr(s) &= ~HostSim_DmaFlag(s, 0x3Du);
+    HostSim_Access();
+}
+
+void DMA_Init(DMA_Stream_TypeDef* DMAy_Streamx, DMA_InitTypeDef* DMA_InitStruct)
+{
+    DMAy_Streamx->CR = DMA_InitStruct->DMA_Channel | DMA_InitStruct->DMA_DIR |
+                       DMA_InitStruct->DMA_PeripheralInc | DMA_InitStruct->DMA_MemoryInc |
+                       DMA_InitStruct->DMA_PeripheralDataSize | DMA_InitStruct->DMA_MemoryDataSize |
+                       DMA_InitStruct->DMA_Mode | DMA_InitStruct->DMA_Priority |
+                       DMA_InitStruct->DMA_MemoryBurst | DMA_InitStruct->DMA_PeripheralBurst;
+    DMAy_Streamx->FCR = DMA_InitStruct->DMA_FIFOMode | DMA_InitStruct->DMA_FIFOThreshold;
+    DMAy_Streamx->NDTR = DMA_InitStruct->DMA_BufferSize;
+    DMAy_Streamx->PAR = DMA_InitStruct->DMA_PeripheralBaseAddr;
+    DMAy_Streamx->M0AR = DMA_InitStruct->DMA_Memory0BaseAddr;
+    HostSim_Access();
+}
+
+void DMA_Cmd(DMA_Stream_TypeDef* DMAy_Streamx, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        HostSim_DmaPos[HostSim_StreamIndex(DMAy_Streamx)] = 0;
+        HostSim_DmaLength[HostSim_StreamIndex(DMAy_Streamx)] = DMAy_Streamx->NDTR;
+        DMAy_Streamx->CR |= DMA_SxCR_EN;
+    } else {
+        DMAy_Streamx->CR &= ~DMA_SxCR_EN;
+    }
+    HostSim_Access();
+}
+
+FunctionalState DMA_GetCmdStatus(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+    HostSim_Access();
+    return (DMAy_Streamx->CR & DMA_SxCR_EN) ? ENABLE : DISABLE;
+}
+
+void DMA_ITConfig(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_IT, FunctionalState NewState)
+{
+    uint32_t bits = DMA_IT & (DMA_IT_TC | DMA_IT_HT | DMA_IT_TE | DMA_IT_DME);
+    if (NewState != DISABLE) {
+        DMAy_Streamx->CR |= bits;
+    } else {
+        DMAy_Streamx->CR &= ~bits;
+    }
+    HostSim_Access();
+}
+
+void DMA_MemoryTargetConfig(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t MemoryBaseAddr, uint32_t DMA_MemoryTarget)
+{
+    if (DMA_MemoryTarget != DMA_Memory_0) {
+        DMAy_Streamx->M1AR = MemoryBaseAddr;
+    } else {
+        DMAy_Streamx->M0AR = MemoryBaseAddr;
+    }
+    HostSim_Access();
+}
+
+void DMA_SetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx, uint16_t Counter)
+{
+    DMAy_Streamx->NDTR = Counter;
+    HostSim_Access();
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+    HostSim_Access();
+    return (uint16_t)DMAy_Streamx->NDTR;
+}
+
+FlagStatus DMA_GetFlagStatus(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_FLAG)
+{
+    DMA_TypeDef* dma = &HostSim_DmaRegs[HostSim_StreamIndex(DMAy_Streamx) / HOSTSIM_NUM_STREAMS];
+    uint32_t isr;
+
+    HostSim_Access();
+    isr = (DMA_FLAG & HOSTSIM_DMA_HIGH_ISR) ? dma->HISR : dma->LISR;
+    return (isr & DMA_FLAG & HOSTSIM_DMA_FLAG_MASK) ? SET : RESET;
+}
+
+void DMA_ClearFlag(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_FLAG)
+{
+    DMA_TypeDef* dma = &HostSim_DmaRegs[HostSim_StreamIndex(DMAy_Streamx) / HOSTSIM_NUM_STREAMS];
+
+    if (DMA_FLAG & HOSTSIM_DMA_HIGH_ISR) {
+        dma->HISR &= ~(DMA_FLAG & HOSTSIM_DMA_FLAG_MASK);
+    } else {
+        dma->LISR &= ~(DMA_FLAG & HOSTSIM_DMA_FLAG_MASK);
+    }
+    HostSim_Access();
+}
+
+/* StdPeriph CAN. Each function is charged the register accesses the library makes. */
+
+static uint32_t HostSim_CanIndex(CAN_TypeDef* CANx)
+{
+    return (uint32_t)(CANx - HostSim_CanRegs);
+}
+
+void CAN_DeInit(CAN_TypeDef* CANx)
+{
+    uint32_t idx = HostSim_CanIndex(CANx);
+
+    /* The reset of CAN1 also clears the filter banks shared with CAN2 */
+    memset(CANx, 0, (idx == 0) ? sizeof(*CANx) : offsetof(CAN_TypeDef, FMR));
+    memset(&HostSim_CanUnit[idx], 0, sizeof(HostSim_CanUnit[idx]));
+    CANx->MCR = CAN_MCR_SLEEP | 0x00010000u;
+    CANx->MSR = CAN_MSR_SLAK;
+    CANx->TSR = CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2;
+    CANx->BTR = 0x01230000u;
+    if (idx == 0) {
+        CANx->FMR = HOSTSIM_CAN_FMR_RESET;
+    }
+    HostSim_Accesses(2);
+}
+
+uint8_t CAN_Init(CAN_TypeDef* CANx, CAN_InitTypeDef* CAN_InitStruct)
+{
+    uint32_t mcr = CANx->MCR & ~(CAN_MCR_SLEEP | CAN_MCR_TTCM | CAN_MCR_ABOM | CAN_MCR_AWUM |
+                                 CAN_MCR_NART | CAN_MCR_RFLM | CAN_MCR_TXFP);
+
+    if (CAN_InitStruct->CAN_TTCM != DISABLE) mcr |= CAN_MCR_TTCM;
+    if (CAN_InitStruct->CAN_ABOM != DISABLE) mcr |= CAN_MCR_ABOM;
+    if (CAN_InitStruct->CAN_AWUM != DISABLE) mcr |= CAN_MCR_AWUM;
+    if (CAN_InitStruct->CAN_NART != DISABLE) mcr |= CAN_MCR_NART;
+    if (CAN_InitStruct->CAN_RFLM != DISABLE) mcr |= CAN_MCR_RFLM;
+    if (CAN_InitStruct->CAN_TXFP != DISABLE) mcr |= CAN_MCR_TXFP;
+    CANx->MCR = mcr;
+    CANx->BTR = ((uint32_t)CAN_InitStruct->CAN_Mode << 30) | ((uint32_t)CAN_InitStruct->CAN_SJW << 24) |
+                ((uint32_t)CAN_InitStruct->CAN_BS1 << 16) | ((uint32_t)CAN_InitStruct->CAN_BS2 << 20) |
+                ((uint32_t)CAN_InitStruct->CAN_Prescaler - 1u);
+    /* Leaves initialization mode, as the library does */
+    CANx->MSR &= ~(CAN_MSR_INAK | CAN_MSR_SLAK);
+    HostSim_Accesses(12);
+    HostSim_CanUpdate(HostSim_CanIndex(CANx));
+    return CAN_InitStatus_Success;
+}
+
+void CAN_FilterInit(CAN_FilterInitTypeDef* CAN_FilterInitStruct)
+{
+    CAN_TypeDef* f = &HostSim_CanRegs[0];
+    uint32_t bit = 1u << CAN_FilterInitStruct->CAN_FilterNumber;
+    CAN_FilterRegister_TypeDef* bank = &f->sFilterRegister[CAN_FilterInitStruct->CAN_FilterNumber];
+
+    f->FA1R &= ~bit;
+    if (CAN_FilterInitStruct->CAN_FilterScale == CAN_FilterScale_16bit) {
+        f->FS1R &= ~bit;
+        bank->FR1 = ((uint32_t)CAN_FilterInitStruct->CAN_FilterMaskIdLow << 16) | CAN_FilterInitStruct->CAN_FilterIdLow;
+        bank->FR2 = ((uint32_t)CAN_FilterInitStruct->CAN_FilterMaskIdHigh << 16) | CAN_FilterInitStruct->CAN_FilterIdHigh;
+    } else {
+        f->FS1R |= bit;
+        bank->FR1 = ((uint32_t)CAN_FilterInitStruct->CAN_FilterIdHigh << 16) | CAN_FilterInitStruct->CAN_FilterIdLow;
+        bank->FR2 = ((uint32_t)CAN_FilterInitStruct->CAN_FilterMaskIdHigh << 16) | CAN_FilterInitStruct->CAN_FilterMaskIdLow;
+    }
+    if (CAN_FilterInitStruct->CAN_FilterMode == CAN_FilterMode_IdMask) {
+        f->FM1R &= ~bit;
+    } else {
+        f->FM1R |= bit;
+    }
+    if (CAN_FilterInitStruct->CAN_FilterFIFOAssignment == CAN_Filter_FIFO0) {
+        f->FFA1R &= ~bit;
+    } else {
+        f->FFA1R |= bit;
+    }
+    if (CAN_FilterInitStruct->CAN_FilterActivation == ENABLE) {
+        f->FA1R |= bit;
+    }
+    f->FMR &= ~CAN_FMR_FINIT;
+    HostSim_Accesses(9);
+}
+
+void CAN_SlaveStartBank(uint8_t CAN_BankNumber)
+{
+    CAN_TypeDef* f = &HostSim_CanRegs[0];
+
+    f->FMR = (f->FMR & ~(HOSTSIM_CAN_FMR_CAN2SB | CAN_FMR_FINIT)) | ((uint32_t)CAN_BankNumber << 8);
+    HostSim_Accesses(4);
+}
+
+uint8_t CAN_OperatingModeRequest(CAN_TypeDef* CANx, uint8_t CAN_OperatingMode)
+{
+    uint32_t idx = HostSim_CanIndex(CANx);
+    uint8_t status = CAN_ModeStatus_Success;
+
+    HostSim_Accesses(3);
+    if (CAN_OperatingMode == CAN_OperatingMode_Initialization) {
+        CANx->MCR = (CANx->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ;
+        CANx->MSR = (CANx->MSR & ~CAN_MSR_SLAK) | CAN_MSR_INAK;
+    } else if (CAN_OperatingMode == CAN_OperatingMode_Normal) {
+        CANx->MCR &= ~(CAN_MCR_SLEEP | CAN_MCR_INRQ);
+        CANx->MSR &= ~(CAN_MSR_SLAK | CAN_MSR_INAK);
+        /* Bus-off recovery; the 128 x 11 recessive bits are not modelled */
+        CANx->ESR &= ~CAN_ESR_BOFF;
+    } else if (CAN_OperatingMode == CAN_OperatingMode_Sleep) {
+        CANx->MCR = (CANx->MCR & ~CAN_MCR_INRQ) | CAN_MCR_SLEEP;
+        CANx->MSR = (CANx->MSR & ~CAN_MSR_INAK) | CAN_MSR_SLAK;
+    } else {
+        status = CAN_ModeStatus_Failed;
+    }
+    HostSim_CanUpdate(idx);
+    return status;
+}
+
+void CAN_ITConfig(CAN_TypeDef* CANx, uint32_t CAN_IT, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        CANx->IER |= CAN_IT;
+    } else {
+        CANx->IER &= ~CAN_IT;
+    }
+    HostSim_Access();
+}
+
+FlagStatus CAN_GetFlagStatus(CAN_TypeDef* CANx, uint32_t CAN_FLAG)
+{
+    uint32_t reg;
+
+    HostSim_Access();
+    if (CAN_FLAG & 0x00F00000u) {
+        reg = CANx->ESR;
+    } else if (CAN_FLAG & 0x01000000u) {
+        reg = CANx->MSR;
+    } else if (CAN_FLAG & 0x08000000u) {
+        reg = CANx->TSR;
+    } else if (CAN_FLAG & 0x02000000u) {
+        reg = CANx->RF0R;
+    } else {
+        reg = CANx->RF1R;
+    }
+    return (reg & CAN_FLAG & 0x000FFFFFu) ? SET : RESET;
+}
+
+uint8_t CAN_Transmit(CAN_TypeDef* CANx, CanTxMsg* TxMessage)
+{
+    uint8_t mbx;
+    uint32_t tir;
+
+    for (mbx = 0; mbx < HOSTSIM_CAN_MAILBOXES && (CANx->TSR & (CAN_TSR_TME0 << mbx)) == 0; mbx++) {
+    }
+    HostSim_Accesses(mbx + 1u);
+    if (mbx == HOSTSIM_CAN_MAILBOXES) {
+        return CAN_TxStatus_NoMailBox;
+    }
+    if (TxMessage->IDE == CAN_Id_Standard) {
+        tir = (TxMessage->StdId << 21) | TxMessage->RTR;
+    } else {
+        tir = (TxMessage->ExtId << 3) | TxMessage->IDE | TxMessage->RTR;
+    }
+    CANx->sTxMailBox[mbx].TDTR = TxMessage->DLC & 0xFu;
+    memcpy((void*)&CANx->sTxMailBox[mbx].TDLR, &TxMessage->Data[0], 4);
+    memcpy((void*)&CANx->sTxMailBox[mbx].TDHR, &TxMessage->Data[4], 4);
+    HostSim_Accesses(8);
+    HostSim_WriteReg(&CANx->sTxMailBox[mbx].TIR, tir | CAN_TI0R_TXRQ);
+    return mbx;
+}
+
+void CAN_CancelTransmit(CAN_TypeDef* CANx, uint8_t Mailbox)
+{
+    HostSim_WriteReg(&CANx->TSR, CAN_TSR_ABRQ0 << (8u * Mailbox));
+}
+
+void CAN_Receive(CAN_TypeDef* CANx, uint8_t FIFONumber, CanRxMsg* RxMessage)
+{
+    const CAN_FIFOMailBox_TypeDef* mbx = &CANx->sFIFOMailBox[FIFONumber];
+
+    RxMessage->IDE = (uint8_t)(mbx->RIR & CAN_Id_Extended);
+    if (RxMessage->IDE == CAN_Id_Standard) {
+        RxMessage->StdId = 0x7FFu & (mbx->RIR >> 21);
+    } else {
+        RxMessage->ExtId = 0x1FFFFFFFu & (mbx->RIR >> 3);
+    }
+    RxMessage->RTR = (uint8_t)(mbx->RIR & CAN_RI0R_RTR);
+    RxMessage->DLC = (uint8_t)(mbx->RDTR & 0xFu);
+    RxMessage->FMI = (uint8_t)(mbx->RDTR >> 8);
+    memcpy(&RxMessage->Data[0], (const void*)&mbx->RDLR, 4);
+    memcpy(&RxMessage->Data[4], (const void*)&mbx->RDHR, 4);
+    HostSim_Accesses(13);
+    HostSim_WriteReg(&CANx->RF0R + FIFONumber, CAN_RF0R_RFOM0);
+}
+
+void CAN_FIFORelease(CAN_TypeDef* CANx, uint8_t FIFONumber)
+{
+    HostSim_WriteReg(&CANx->RF0R + FIFONumber, CAN_RF0R_RFOM0);
+}
+
+uint8_t CAN_MessagePending(CAN_TypeDef* CANx, uint8_t FIFONumber)
+{
+    HostSim_Access();
+    return (uint8_t)((FIFONumber == CAN_FIFO0 ? CANx->RF0R : CANx->RF1R) & CAN_RF0R_FMP0);
+}
+
+void HostSim_CanBusOff(uint32_t Idx)
+{
+    HostSim_CanRegs[Idx].ESR |= CAN_ESR_BOFF;
+}
+
+/* StdPeriph ADC. Each function is charged the register accesses the library makes. */
+
+static uint32_t HostSim_AdcIndex(ADC_TypeDef* ADCx)
+{
+    return (uint32_t)(ADCx - HostSim_AdcRegs);
+}
+
+void ADC_DeInit(void)
+{
+    /* Reset of the three ADCs through RCC_APB2RSTR */
+    memset(HostSim_AdcRegs, 0, sizeof(HostSim_AdcRegs));
+    memset(&HostSim_AdcCommon, 0, sizeof(HostSim_AdcCommon));
+    memset(HostSim_AdcUnit, 0, sizeof(HostSim_AdcUnit));
+    HostSim_Accesses(2);
+}
+
+void ADC_CommonInit(ADC_CommonInitTypeDef* ADC_CommonInitStruct)
+{
+    HostSim_AdcCommon.CCR = (HostSim_AdcCommon.CCR & ~(ADC_CCR_MULTI | ADC_CCR_DELAY | ADC_CCR_DMA | ADC_CCR_ADCPRE)) |
+                            ADC_CommonInitStruct->ADC_Mode | ADC_CommonInitStruct->ADC_Prescaler |
+                            ADC_CommonInitStruct->ADC_DMAAccessMode | ADC_CommonInitStruct->ADC_TwoSamplingDelay;
+    HostSim_Accesses(2);
+}
+
+void ADC_Init(ADC_TypeDef* ADCx, ADC_InitTypeDef* ADC_InitStruct)
+{
+    ADCx->CR1 = (ADCx->CR1 & ~(ADC_CR1_SCAN | ADC_CR1_RES)) |
+                ((uint32_t)ADC_InitStruct->ADC_ScanConvMode << 8) | ADC_InitStruct->ADC_Resolution;
+    ADCx->CR2 = (ADCx->CR2 & ~(ADC_CR2_CONT | ADC_CR2_ALIGN | ADC_CR2_EXTSEL | ADC_CR2_EXTEN)) |
+                ADC_InitStruct->ADC_DataAlign | ADC_InitStruct->ADC_ExternalTrigConv |
+                ADC_InitStruct->ADC_ExternalTrigConvEdge | ((uint32_t)ADC_InitStruct->ADC_ContinuousConvMode << 1);
+    ADCx->SQR1 = (ADCx->SQR1 & ~ADC_SQR1_L) | ((uint32_t)(ADC_InitStruct->ADC_NbrOfConversion - 1u) << 20);
+    HostSim_Accesses(6);
+}
+
+void ADC_RegularChannelConfig(ADC_TypeDef* ADCx, uint8_t ADC_Channel, uint8_t Rank, uint8_t ADC_SampleTime)
+{
+    uint32_t rank = Rank - 1u;
+    volatile uint32_t* sqr = (rank < 6) ? &ADCx->SQR3 : (rank < 12) ? &ADCx->SQR2 : &ADCx->SQR1;
+    uint32_t shift = 5u * (rank % 6u);
+
+    if (ADC_Channel < 10) {
+        ADCx->SMPR2 = (ADCx->SMPR2 & ~(0x7u << (3u * ADC_Channel))) | ((uint32_t)ADC_SampleTime << (3u * ADC_Channel));
+    } else {
+        ADCx->SMPR1 = (ADCx->SMPR1 & ~(0x7u << (3u * (ADC_Channel - 10u)))) |
+                      ((uint32_t)ADC_SampleTime << (3u * (ADC_Channel - 10u)));
+    }
+    *sqr = (*sqr & ~(0x1Fu << shift)) | ((uint32_t)ADC_Channel << shift);
+    HostSim_Accesses(4);
+}
+
+void ADC_Cmd(ADC_TypeDef* ADCx, FunctionalState NewState)
+{
+    uint32_t idx = HostSim_AdcIndex(ADCx);
+
+    HostSim_Access();
+    if (NewState != DISABLE) {
+        ADCx->CR2 |= ADC_CR2_ADON;
+    } else {
+        /* Clearing ADON stops the conversion in progress */
+        ADCx->CR2 &= ~ADC_CR2_ADON;
+        HostSim_AdcUnit[idx].converting = 0;
+    }
+    HostSim_Access();
+}
+
+void ADC_DMACmd(ADC_TypeDef* ADCx, FunctionalState NewState)
+{
+    uint32_t idx = HostSim_AdcIndex(ADCx);
+
+    HostSim_Access();
+    if (NewState != DISABLE) {
+        ADCx->CR2 |= ADC_CR2_DMA;
+    } else {
+        /* Writing DMA to 0 re-arms the requests stopped after the last transfer */
+        ADCx->CR2 &= ~ADC_CR2_DMA;
+        HostSim_AdcUnit[idx].dmaDone = 0;
+    }
+    HostSim_Access();
+}
+
+void ADC_DMARequestAfterLastTransferCmd(ADC_TypeDef* ADCx, FunctionalState NewState)
+{
+    HostSim_Access();
+    if (NewState != DISABLE) {
+        ADCx->CR2 |= ADC_CR2_DDS;
+    } else {
+        ADCx->CR2 &= ~ADC_CR2_DDS;
+    }
+    HostSim_Access();
+}
+
+void ADC_MultiModeDMARequestAfterLastTransferCmd(FunctionalState NewState)
+{
+    HostSim_Access();
+    if (NewState != DISABLE) {
+        HostSim_AdcCommon.CCR |= ADC_CCR_DDS;
+    } else {
+        HostSim_AdcCommon.CCR &= ~ADC_CCR_DDS;
+        HostSim_AdcUnit[0].dmaDone = 0;
+    }
+    HostSim_Access();
+}
+
+void ADC_ITConfig(ADC_TypeDef* ADCx, uint16_t ADC_IT, FunctionalState NewState)
+{
+    /* The low byte of ADC_IT is the position of the enable bit in CR1, as in the library */
+    uint32_t bit = 1u << (uint8_t)ADC_IT;
+
+    HostSim_Access();
+    if (NewState != DISABLE) {
+        ADCx->CR1 |= bit;
+    } else {
+        ADCx->CR1 &= ~bit;
+    }
+    HostSim_Access();
+}
+
+void ADC_SoftwareStartConv(ADC_TypeDef* ADCx)
+{
+    HostSim_Access();
+    ADCx->CR2 |= ADC_CR2_SWSTART;
+    HostSim_AdcStart(HostSim_AdcIndex(ADCx));
+    HostSim_Access();
+}
+
+FlagStatus ADC_GetFlagStatus(ADC_TypeDef* ADCx, uint8_t ADC_FLAG)
+{
+    HostSim_Access();
+    return (ADCx->SR & ADC_FLAG) ? SET : RESET;
+}
+
+void ADC_ClearFlag(ADC_TypeDef* ADCx, uint8_t ADC_FLAG)
+{
+    ADCx->SR &= ~(uint32_t)ADC_FLAG;
+    HostSim_Access();
+}
+
+uint16_t ADC_GetConversionValue(ADC_TypeDef* ADCx)
+{
+    uint32_t idx = HostSim_AdcIndex(ADCx);
+
+    HostSim_Access();
+    /* Reading DR clears EOC and frees the data register */
+    ADCx->SR &= ~ADC_SR_EOC;
+    if (!HostSim_AdcTriple()) {
+        HostSim_AdcUnit[idx].drFull = 0;
+    }
+    return (uint16_t)ADCx->DR;
+}
+
+/* StdPeriph TIM */
+
+static uint32_t HostSim_TimIndex(TIM_TypeDef* TIMx)
+{
+    return (uint32_t)(TIMx - HostSim_TimRegs);
+}
+
+void TIM_DeInit(TIM_TypeDef* TIMx)
+{
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    memset(TIMx, 0, sizeof(*TIMx));
+    memset(HostSim_TimUnit[idx].compare, 0, sizeof(HostSim_TimUnit[idx].compare));
+    HostSim_TimUnit[idx].watched = 0;
+    TIMx->ARR = HostSim_TimWide[idx] ? 0xFFFFFFFFu : 0xFFFFu;
+    HostSim_TimRebase(idx);
+    HostSim_Accesses(2);
+}
+
+void TIM_TimeBaseInit(TIM_TypeDef* TIMx, TIM_TimeBaseInitTypeDef* TIM_TimeBaseInitStruct)
+{
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_TimUpdate(idx);
+    TIMx->CR1 = (uint16_t)((TIMx->CR1 & ~(TIM_CR1_DIR | TIM_CR1_CMS | TIM_CR1_CKD)) |
+                           TIM_TimeBaseInitStruct->TIM_CounterMode | TIM_TimeBaseInitStruct->TIM_ClockDivision);
+    TIMx->ARR = TIM_TimeBaseInitStruct->TIM_Period;
+    TIMx->PSC = TIM_TimeBaseInitStruct->TIM_Prescaler;
+    if (HostSim_TimAdvanced[idx]) {
+        TIMx->RCR = TIM_TimeBaseInitStruct->TIM_RepetitionCounter;
+    }
+    /* The update generated by EGR loads the prescaler, clears the counter and sets UIF */
+    TIMx->CNT = 0;
+    HostSim_TimRebase(idx);
+    HostSim_TimUpdateEvent(idx, HostSim_Cycles);
+    HostSim_Accesses(5);
+}
+
+void TIM_Cmd(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_Access();
+    HostSim_TimUpdate(idx);
+    if (NewState != DISABLE) {
+        if ((TIMx->CR1 & TIM_CR1_CEN) == 0) {
+            /* Count from the current cycle, keeping CNT */
+            HostSim_TimRebase(idx);
+        }
+        TIMx->CR1 |= TIM_CR1_CEN;
+    } else {
+        TIMx->CR1 &= (uint16_t)~TIM_CR1_CEN;
+    }
+}
+
+void TIM_SetCounter(TIM_TypeDef* TIMx, uint32_t Counter)
+{
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_Access();
+    HostSim_TimUpdate(idx);
+    TIMx->CNT = Counter;
+}
+
+/* ARPE is not modelled: the new period applies to the running one, CNT must not be past it */
+void TIM_SetAutoreload(TIM_TypeDef* TIMx, uint32_t Autoreload)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->ARR = Autoreload;
+}
+
+uint32_t TIM_GetCounter(TIM_TypeDef* TIMx)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    return TIMx->CNT;
+}
+
+void TIM_SetCompare1(TIM_TypeDef* TIMx, uint32_t Compare1)
+{
+    HostSim_Access();
+    /* Matches made with the previous value are flagged first */
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->CCR1 = Compare1;
+}
+
+void TIM_SetCompare2(TIM_TypeDef* TIMx, uint32_t Compare2)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->CCR2 = Compare2;
+}
+
+void TIM_SetCompare3(TIM_TypeDef* TIMx, uint32_t Compare3)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->CCR3 = Compare3;
+}
+
+void TIM_SetCompare4(TIM_TypeDef* TIMx, uint32_t Compare4)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->CCR4 = Compare4;
+}
+
+void TIM_OCStructInit(TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    TIM_OCInitStruct->TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStruct->TIM_OutputState = TIM_OutputState_Disable;
+    TIM_OCInitStruct->TIM_OutputNState = TIM_OutputNState_Disable;
+    TIM_OCInitStruct->TIM_Pulse = 0;
+    TIM_OCInitStruct->TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OCInitStruct->TIM_OCNPolarity = TIM_OCPolarity_High;
+    TIM_OCInitStruct->TIM_OCIdleState = TIM_OCIdleState_Reset;
+    TIM_OCInitStruct->TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+}
+
+/* Output compare channel ch (0..3): mode, polarity, enable and pulse, as TIM_OCxInit writes them */
+static void HostSim_TimOcInit(TIM_TypeDef* TIMx, uint32_t ch, const TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    volatile uint16_t* ccmr = (ch < 2) ? &TIMx->CCMR1 : &TIMx->CCMR2;
+    uint32_t shift = 8u * (ch % 2u);
+
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    *ccmr = (uint16_t)((*ccmr & ~((TIM_CCMR1_OC1M | TIM_CCMR1_CC1S) << shift)) | (TIM_OCInitStruct->TIM_OCMode << shift));
+    TIMx->CCER = (uint16_t)((TIMx->CCER & ~((TIM_CCER_CC1E | TIM_CCER_CC1P) << (4u * ch))) |
+                            ((TIM_OCInitStruct->TIM_OutputState | TIM_OCInitStruct->TIM_OCPolarity) << (4u * ch)));
+    (&TIMx->CCR1)[ch] = TIM_OCInitStruct->TIM_Pulse;
+    HostSim_Accesses(HostSim_TimAdvanced[HostSim_TimIndex(TIMx)] ? 7u : 6u);
+}
+
+void TIM_OC1Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    HostSim_TimOcInit(TIMx, 0, TIM_OCInitStruct);
+}
+
+void TIM_OC2Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    HostSim_TimOcInit(TIMx, 1, TIM_OCInitStruct);
+}
+
+void TIM_OC3Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    HostSim_TimOcInit(TIMx, 2, TIM_OCInitStruct);
+}
+
+void TIM_OC4Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+    HostSim_TimOcInit(TIMx, 3, TIM_OCInitStruct);
+}
+
+/* OCxPE of channel ch (0..3) */
+static void HostSim_TimOcPreload(TIM_TypeDef* TIMx, uint32_t ch, uint16_t TIM_OCPreload)
+{
+    volatile uint16_t* ccmr = (ch < 2) ? &TIMx->CCMR1 : &TIMx->CCMR2;
+    uint32_t shift = 8u * (ch % 2u);
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_TimUpdate(idx);
+    /* The value in force stays the one written so far until the next update event */
+    HostSim_TimUnit[idx].compare[ch] = HostSim_TimCompare(idx, ch);
+    *ccmr = (uint16_t)((*ccmr & ~(TIM_CCMR1_OC1PE << shift)) | (TIM_OCPreload << shift));
+    HostSim_Accesses(2);
+}
+
+void TIM_OC1PreloadConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPreload)
+{
+    HostSim_TimOcPreload(TIMx, 0, TIM_OCPreload);
+}
+
+void TIM_OC2PreloadConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPreload)
+{
+    HostSim_TimOcPreload(TIMx, 1, TIM_OCPreload);
+}
+
+void TIM_OC3PreloadConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPreload)
+{
+    HostSim_TimOcPreload(TIMx, 2, TIM_OCPreload);
+}
+
+void TIM_OC4PreloadConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPreload)
+{
+    HostSim_TimOcPreload(TIMx, 3, TIM_OCPreload);
+}
+
+/* ARPE is kept but not modelled: ARR takes effect at once */
+void TIM_ARRPreloadConfig(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    if (NewState != DISABLE) {
+        TIMx->CR1 |= TIM_CR1_ARPE;
+    } else {
+        TIMx->CR1 &= (uint16_t)~TIM_CR1_ARPE;
+    }
+    HostSim_Access();
+}
+
+void TIM_UpdateDisableConfig(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    if (NewState != DISABLE) {
+        TIMx->CR1 |= TIM_CR1_UDIS;
+    } else {
+        TIMx->CR1 &= (uint16_t)~TIM_CR1_UDIS;
+    }
+    HostSim_Access();
+}
+
+void TIM_CtrlPWMOutputs(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+    if (NewState != DISABLE) {
+        TIMx->BDTR |= TIM_BDTR_MOE;
+    } else {
+        TIMx->BDTR &= (uint16_t)~TIM_BDTR_MOE;
+    }
+    HostSim_Access();
+}
+
+void TIM_DMAConfig(TIM_TypeDef* TIMx, uint16_t TIM_DMABase, uint16_t TIM_DMABurstLength)
+{
+    TIMx->DCR = TIM_DMABase | TIM_DMABurstLength;
+    HostSim_Access();
+}
+
+void TIM_DMACmd(TIM_TypeDef* TIMx, uint16_t TIM_DMASource, FunctionalState NewState)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    if (NewState != DISABLE) {
+        TIMx->DIER |= TIM_DMASource;
+    } else {
+        TIMx->DIER &= (uint16_t)~TIM_DMASource;
+    }
+    HostSim_Access();
+}
+
+void TIM_ITConfig(TIM_TypeDef* TIMx, uint16_t TIM_IT, FunctionalState NewState)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    if (NewState != DISABLE) {
+        TIMx->DIER |= TIM_IT;
+    } else {
+        TIMx->DIER &= (uint16_t)~TIM_IT;
+    }
+    HostSim_Access();
+}
+
+void TIM_GenerateEvent(TIM_TypeDef* TIMx, uint16_t TIM_EventSource)
+{
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_TimUpdate(idx);
+    if (TIM_EventSource & TIM_EGR_UG) {
+        TIMx->CNT = 0;
+        HostSim_TimRebase(idx);
+        HostSim_TimUpdateEvent(idx, HostSim_Cycles);
+    }
+    /* The CCxG bits of EGR raise the flags of the same position in SR */
+    TIMx->SR |= (uint16_t)(TIM_EventSource & HOSTSIM_TIM_SR_CC_MASK);
+    HostSim_Access();
+}
+
+FlagStatus TIM_GetFlagStatus(TIM_TypeDef* TIMx, uint16_t TIM_FLAG)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    return (TIMx->SR & TIM_FLAG) ? SET : RESET;
+}
+
+void TIM_ClearFlag(TIM_TypeDef* TIMx, uint16_t TIM_FLAG)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->SR = (uint16_t)~TIM_FLAG & TIMx->SR;
+    HostSim_Access();
+}
+
+ITStatus TIM_GetITStatus(TIM_TypeDef* TIMx, uint16_t TIM_IT)
+{
+    HostSim_Accesses(2);
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    return ((TIMx->SR & TIM_IT) && (TIMx->DIER & TIM_IT)) ? SET : RESET;
+}
+
+void TIM_ClearITPendingBit(TIM_TypeDef* TIMx, uint16_t TIM_IT)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->SR = (uint16_t)~TIM_IT & TIMx->SR;
+    HostSim_Access();
+}
+
+void TIM_ICStructInit(TIM_ICInitTypeDef* TIM_ICInitStruct)
+{
+    TIM_ICInitStruct->TIM_Channel = TIM_Channel_1;
+    TIM_ICInitStruct->TIM_ICPolarity = TIM_ICPolarity_Rising;
+    TIM_ICInitStruct->TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStruct->TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStruct->TIM_ICFilter = 0x00;
+}
+
+/* Input capture channel ch (0..3): input selection, prescaler and filter in CCMRx, polarity and
+   enable in CCER, as TIM_ICInit writes them. The input captured is followed from now on. */
+static void HostSim_TimIcInit(TIM_TypeDef* TIMx, uint32_t ch, uint16_t Polarity, uint16_t Selection,
+                              uint16_t Prescaler, uint16_t Filter)
+{
+    volatile uint16_t* ccmr = (ch < 2) ? &TIMx->CCMR1 : &TIMx->CCMR2;
+    uint32_t shift = 8u * (ch % 2u);
+    uint32_t idx = HostSim_TimIndex(TIMx);
+
+    HostSim_TimUpdate(idx);
+    *ccmr = (uint16_t)((*ccmr & ~(0xFFu << shift)) | ((Selection | Prescaler | (uint16_t)(Filter << 4)) << shift));
+    TIMx->CCER = (uint16_t)((TIMx->CCER & ~((TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP) << (4u * ch))) |
+                            ((Polarity | TIM_CCER_CC1E) << (4u * ch)));
+    HostSim_TimWatch(idx, HostSim_TimInputOf(TIMx, ch));
+    HostSim_Accesses(8);
+}
+
+void TIM_ICInit(TIM_TypeDef* TIMx, TIM_ICInitTypeDef* TIM_ICInitStruct)
+{
+    HostSim_TimIcInit(TIMx, TIM_ICInitStruct->TIM_Channel >> 2, TIM_ICInitStruct->TIM_ICPolarity,
+                      TIM_ICInitStruct->TIM_ICSelection, TIM_ICInitStruct->TIM_ICPrescaler, TIM_ICInitStruct->TIM_ICFilter);
+}
+
+/* Channel 1 or 2 as TIM_ICInit sets it, and the other one of the pair on the same input with the
+   opposite polarity */
+void TIM_PWMIConfig(TIM_TypeDef* TIMx, TIM_ICInitTypeDef* TIM_ICInitStruct)
+{
+    uint32_t ch = TIM_ICInitStruct->TIM_Channel >> 2;
+    uint16_t polarity = (TIM_ICInitStruct->TIM_ICPolarity == TIM_ICPolarity_Rising) ? TIM_ICPolarity_Falling : TIM_ICPolarity_Rising;
+    uint16_t selection = (TIM_ICInitStruct->TIM_ICSelection == TIM_ICSelection_DirectTI) ?
+        TIM_ICSelection_IndirectTI : TIM_ICSelection_DirectTI;
+
+    HostSim_TimIcInit(TIMx, ch, TIM_ICInitStruct->TIM_ICPolarity, TIM_ICInitStruct->TIM_ICSelection,
+                      TIM_ICInitStruct->TIM_ICPrescaler, TIM_ICInitStruct->TIM_ICFilter);
+    HostSim_TimIcInit(TIMx, ch ^ 1u, polarity, selection, TIM_ICInitStruct->TIM_ICPrescaler, TIM_ICInitStruct->TIM_ICFilter);
+}
+
+void TIM_CCxCmd(TIM_TypeDef* TIMx, uint16_t TIM_Channel, uint16_t TIM_CCx)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->CCER = (uint16_t)((TIMx->CCER & ~(TIM_CCER_CC1E << TIM_Channel)) | (TIM_CCx << TIM_Channel));
+    HostSim_Accesses(2);
+}
+
+void TIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->SMCR = (uint16_t)((TIMx->SMCR & ~TIM_SMCR_TS) | TIM_InputTriggerSource);
+    HostSim_Accesses(2);
+}
+
+void TIM_SelectSlaveMode(TIM_TypeDef* TIMx, uint16_t TIM_SlaveMode)
+{
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    TIMx->SMCR = (uint16_t)((TIMx->SMCR & ~TIM_SMCR_SMS) | TIM_SlaveMode);
+    HostSim_Accesses(2);
+}
+
+/* Reading a capture register clears its flag */
+static uint32_t HostSim_TimGetCapture(TIM_TypeDef* TIMx, uint32_t ch)
+{
+    HostSim_Access();
+    HostSim_TimUpdate(HostSim_TimIndex(TIMx));
+    if (!HostSim_TimOutput(TIMx, ch)) {
+        TIMx->SR &= (uint16_t)~(TIM_SR_CC1IF << ch);
+    }
+    return (&TIMx->CCR1)[ch];
+}
+
+uint32_t TIM_GetCapture1(TIM_TypeDef* TIMx)
+{
+    return HostSim_TimGetCapture(TIMx, 0);
+}
+
+uint32_t TIM_GetCapture2(TIM_TypeDef* TIMx)
+{
+    return HostSim_TimGetCapture(TIMx, 1);
+}
+
+uint32_t TIM_GetCapture3(TIM_TypeDef* TIMx)
+{
+    return HostSim_TimGetCapture(TIMx, 2);
+}
+
+uint32_t TIM_GetCapture4(TIM_TypeDef* TIMx)
+{
+    return HostSim_TimGetCapture(TIMx, 3);
+}
+
+/* StdPeriph FLASH */
+
+void FLASH_Unlock(void)
+{
+    HostSim_Access();
+    if (HostSim_FlashRegs.CR & FLASH_CR_LOCK) {
+        HostSim_Accesses(2);
+        HostSim_FlashRegs.CR &= ~FLASH_CR_LOCK;
+    }
+}
+
+void FLASH_Lock(void)
+{
+    HostSim_FlashRegs.CR |= FLASH_CR_LOCK;
+    HostSim_Access();
+}
+
+void FLASH_ITConfig(uint32_t FLASH_IT, FunctionalState NewState)
+{
+    if (!(HostSim_FlashRegs.CR & FLASH_CR_LOCK)) {
+        if (NewState != DISABLE) {
+            HostSim_FlashRegs.CR |= FLASH_IT;
+        } else {
+            HostSim_FlashRegs.CR &= ~FLASH_IT;
+        }
+    }
+    HostSim_Access();
+}
+
+FlagStatus FLASH_GetFlagStatus(uint32_t FLASH_FLAG)
+{
+    HostSim_Access();
+    return (HostSim_FlashRegs.SR & FLASH_FLAG) ? SET : RESET;
+}
+
+void FLASH_ClearFlag(uint32_t FLASH_FLAG)
+{
+    HostSim_FlashRegs.SR &= ~(FLASH_FLAG & HOSTSIM_FLASH_SR_W1C);
+    HostSim_Access();
+}
+
+FLASH_Status FLASH_GetStatus(void)
+{
+    uint32_t sr = HostSim_FlashRegs.SR;
+
+    HostSim_Access();
+    if (sr & FLASH_FLAG_BSY) {
+        return FLASH_BUSY;
+    }
+    if (sr & FLASH_FLAG_WRPERR) {
+        return FLASH_ERROR_WRP;
+    }
+    if (sr & (FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)) {
+        return FLASH_ERROR_PROGRAM;
+    }
+    return (sr & FLASH_FLAG_OPERR) ? FLASH_ERROR_OPERATION : FLASH_COMPLETE;
+}
+
+/* The library polls SR until BSY clears: the CPU spends the whole operation reading it, and
+   interrupts are served in between */
+FLASH_Status FLASH_WaitForLastOperation(void)
+{
+    FLASH_Status status;
+
+    while ((status = FLASH_GetStatus()) == FLASH_BUSY) {
+        uint64_t polls = (HostSim_FlashUnit.endAt - HostSim_Cycles) / HostSim_BusCycles;
+        HostSim_RegAccesses += polls;
+        HostSim_Run(HostSim_Cycles + polls * HostSim_BusCycles);
+    }
+    return status;
+}
+
+FLASH_Status FLASH_EraseSector(uint32_t FLASH_Sector, uint8_t VoltageRange)
+{
+    FLASH_Status status = FLASH_WaitForLastOperation();
+    uint32_t cr = HostSim_FlashRegs.CR & ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+
+    if (status == FLASH_COMPLETE) {
+        cr |= ((uint32_t)VoltageRange << 8) | FLASH_CR_SER | FLASH_Sector;
+        HostSim_Accesses(5);
+        HostSim_FlashWriteCr(cr);
+        HostSim_FlashWriteCr(cr | FLASH_CR_STRT);
+        status = FLASH_WaitForLastOperation();
+        HostSim_Accesses(2);
+        HostSim_FlashWriteCr(HostSim_FlashRegs.CR & ~(FLASH_CR_SER | FLASH_CR_SNB));
+    }
+    return status;
+}
+
+/* Programming of one unit by the library: PG, the stores of the unit, then the wait */
+static FLASH_Status HostSim_FlashProgram(uint32_t Address, const uint32_t* Words, uint32_t Count, uint32_t PSize)
+{
+    FLASH_Status status = FLASH_WaitForLastOperation();
+
+    if (status == FLASH_COMPLETE) {
+        HostSim_Accesses(3);
+        HostSim_FlashWriteCr((HostSim_FlashRegs.CR & ~FLASH_CR_PSIZE) | PSize | FLASH_CR_PG);
+        for (uint32_t i = 0; i < Count; i++) {
+            HostSim_Access();
+            HostSim_FlashStore(Address - FLASH_BASE + i * 4u, Words[i]);
+        }
+        status = FLASH_WaitForLastOperation();
+        HostSim_Access();
+        HostSim_FlashWriteCr(HostSim_FlashRegs.CR & ~FLASH_CR_PG);
+    }
+    return status;
+}
+
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data)
+{
+    return HostSim_FlashProgram(Address, &Data, 1, FLASH_PSIZE_WORD);
+}
+
+FLASH_Status FLASH_ProgramDoubleWord(uint32_t Address, uint64_t Data)
+{
+    uint32_t words[2] = { (uint32_t)Data, (uint32_t)(Data >> 32) };
+    return HostSim_FlashProgram(Address, words, 2, FLASH_PSIZE_DOUBLE_WORD);
+}
+
+/* StdPeriph CRC: CRC-32 of the Ethernet polynomial over words, most significant bit first. The unit
+   takes 4 AHB cycles per word, hidden behind the store of the next one */
+
+static uint32_t HostSim_CrcValue = 0xFFFFFFFFu;
+
+static void HostSim_CrcWord(uint32_t Data)
+{
+    HostSim_CrcValue ^= Data;
+    for (uint32_t bit = 0; bit < 32u; bit++) {
+        HostSim_CrcValue = (HostSim_CrcValue & 0x80000000u) ? (HostSim_CrcValue << 1) ^ 0x04C11DB7u : HostSim_CrcValue << 1;
+    }
+}
+
+void CRC_ResetDR(void)
+{
+    HostSim_CrcValue = 0xFFFFFFFFu;
+    HostSim_Access();
+}
+
+uint32_t CRC_CalcCRC(uint32_t Data)
+{
+    HostSim_CrcWord(Data);
+    HostSim_Accesses(2);
+    return HostSim_CrcValue;
+}
+
+/* One store per word, then the read of DR */
+uint32_t CRC_CalcBlockCRC(uint32_t pBuffer[], uint32_t BufferLength)
+{
+    for (uint32_t i = 0; i < BufferLength; i++) {
+        HostSim_CrcWord(pBuffer[i]);
+    }
+    HostSim_Accesses(BufferLength + 1u);
+    return HostSim_CrcValue;
+}
+
+uint32_t CRC_GetCRC(void)
+{
+    HostSim_Access();
+    return HostSim_CrcValue;
+}
@@ -0,0 +1,351 @@
+/*
+* File: HostSim.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Register model used to run the drivers on a Linux host. The file is force-included
+* in front of every source of the host build: it maps the GPIO, SPI, USART, DMA, CAN, ADC,
+* TIM1..TIM5 and TIM8 and FLASH peripherals onto a simulated register file, and the flash memory
+* onto HostSim_FlashMemory, and provides the StdPeriph functions the drivers call, CRC included,
+* with a modelled core clock and interrupts delivered between register accesses. A LIN slave node
+* answers the headers of a USART in LIN mode. Interrupt handlers can also be injected at any point
+* to load-test them. GPIO registers are accessed by the drivers through READ_REG/WRITE_REG, which
+* this file routes to the model so that BSRR stores update ODR; the CAN driver does the same so that
+* mailbox requests, FIFO releases and TSR clears take effect, and the flash driver so that CR and SR
+* writes and the stores programming the memory do.
+*/
+
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include "stm32f4xx.h"
+
+/* Core clock of the modelled STM32F407 */
+#define HOSTSIM_CORE_CLOCK_HZ   168000000u
+
+#define HOSTSIM_NUM_GPIO        9       /* GPIOA..GPIOI */
+#define HOSTSIM_GPIO_STRIDE     0x400u  /* Distance between two GPIO register blocks */
+#define HOSTSIM_NUM_SPI         3
+#define HOSTSIM_NUM_USART       4       /* USART1..USART3, UART5 */
+#define HOSTSIM_NUM_DMA         2
+#define HOSTSIM_NUM_STREAMS     8
+#define HOSTSIM_NUM_CAN         2       /* CAN1, CAN2 */
+#define HOSTSIM_NUM_ADC         3       /* ADC1..ADC3 */
+#define HOSTSIM_NUM_TIM         6       /* TIM1 of APB2, TIM2..TIM5 of APB1, TIM8 of APB2 */
+#define HOSTSIM_FLASH_SIZE      0x80000u    /* STM32F407VE: sectors 0..3 of 16 KB, 4 of 64 KB, 5..7 of 128 KB */
+
+/* GPIO register block padded to its size on AHB1, so the blocks keep the device layout */
+typedef struct {
+    GPIO_TypeDef regs;
+    uint8_t reserved[HOSTSIM_GPIO_STRIDE - sizeof(GPIO_TypeDef)];
+} HostSim_GpioBlockType;
+
+/* Simulated register file */
+extern HostSim_GpioBlockType HostSim_Gpio[HOSTSIM_NUM_GPIO];
+extern SPI_TypeDef HostSim_SpiRegs[HOSTSIM_NUM_SPI];
+extern USART_TypeDef HostSim_UsartRegs[HOSTSIM_NUM_USART];
+extern DMA_TypeDef HostSim_DmaRegs[HOSTSIM_NUM_DMA];
+extern DMA_Stream_TypeDef HostSim_DmaStreams[HOSTSIM_NUM_DMA][HOSTSIM_NUM_STREAMS];
+extern CAN_TypeDef HostSim_CanRegs[HOSTSIM_NUM_CAN];    /* Filter banks are those of CAN1 */
+extern ADC_TypeDef HostSim_AdcRegs[HOSTSIM_NUM_ADC];
+extern ADC_Common_TypeDef HostSim_AdcCommon;
+extern TIM_TypeDef HostSim_TimRegs[HOSTSIM_NUM_TIM];
+extern FLASH_TypeDef HostSim_FlashRegs;     /* A sector whose nWRP bit of OPTCR is cleared is write protected */
+extern uint8_t HostSim_FlashMemory[HOSTSIM_FLASH_SIZE]; /* Kept by HostSim_Reset, erased by the first one */
+extern DWT_Type HostSim_Dwt;
+extern CoreDebug_Type HostSim_CoreDebug;
+
+#undef DWT
+#undef CoreDebug
+#define DWT         (&HostSim_Dwt)          /* CYCCNT follows the modelled clock */
+#define CoreDebug   (&HostSim_CoreDebug)
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef GPIOG
+#undef GPIOH
+#undef GPIOI
+#undef GPIOJ
+#undef GPIOK
+#define GPIOA   (&HostSim_Gpio[0].regs)
+#define GPIOB   (&HostSim_Gpio[1].regs)
+#define GPIOC   (&HostSim_Gpio[2].regs)
+#define GPIOD   (&HostSim_Gpio[3].regs)
+#define GPIOE   (&HostSim_Gpio[4].regs)
+#define GPIOF   (&HostSim_Gpio[5].regs)
+#define GPIOG   (&HostSim_Gpio[6].regs)
+#define GPIOH   (&HostSim_Gpio[7].regs)
+#define GPIOI   (&HostSim_Gpio[8].regs)
+
+/* Register accesses with side effects go through the model */
+#undef READ_REG
+#undef WRITE_REG
+#define READ_REG(REG)           HostSim_ReadReg(&(REG))
+#define WRITE_REG(REG, VAL)     HostSim_WriteReg(&(REG), (VAL))
+
+#undef SPI1
+#undef SPI2
+#undef SPI3
+#define SPI1    (&HostSim_SpiRegs[0])
+#define SPI2    (&HostSim_SpiRegs[1])
+#define SPI3    (&HostSim_SpiRegs[2])
+
+#undef USART1
+#undef USART2
+#undef USART3
+#define USART1  (&HostSim_UsartRegs[0])
+#define USART2  (&HostSim_UsartRegs[1])
+#define USART3  (&HostSim_UsartRegs[2])
+#undef UART5
+#define UART5   (&HostSim_UsartRegs[3])
+
+#undef CAN1
+#undef CAN2
+#define CAN1    (&HostSim_CanRegs[0])
+#define CAN2    (&HostSim_CanRegs[1])
+
+#undef ADC1
+#undef ADC2
+#undef ADC3
+#undef ADC
+#define ADC1    (&HostSim_AdcRegs[0])
+#define ADC2    (&HostSim_AdcRegs[1])
+#define ADC3    (&HostSim_AdcRegs[2])
+#define ADC     (&HostSim_AdcCommon)
+
+#undef TIM1
+#undef TIM2
+#undef TIM3
+#undef TIM4
+#undef TIM5
+#undef TIM8
+#define TIM1    (&HostSim_TimRegs[0])
+#define TIM2    (&HostSim_TimRegs[1])
+#define TIM3    (&HostSim_TimRegs[2])
+#define TIM4    (&HostSim_TimRegs[3])
+#define TIM5    (&HostSim_TimRegs[4])
+#define TIM8    (&HostSim_TimRegs[5])
+
+#undef FLASH
+#undef FLASH_BASE
+#define FLASH       (&HostSim_FlashRegs)
+#define FLASH_BASE  ((uint32_t)(uintptr_t)HostSim_FlashMemory)
+
+#undef DMA1
+#undef DMA2
+#define DMA1    (&HostSim_DmaRegs[0])
+#define DMA2    (&HostSim_DmaRegs[1])
+
+#undef DMA1_Stream0
+#undef DMA1_Stream1
+#undef DMA1_Stream2
+#undef DMA1_Stream3
+#undef DMA1_Stream4
+#undef DMA1_Stream5
+#undef DMA1_Stream6
+#undef DMA1_Stream7
+#undef DMA2_Stream0
+#undef DMA2_Stream1
+#undef DMA2_Stream2
+#undef DMA2_Stream3
+#undef DMA2_Stream4
+#undef DMA2_Stream5
+#undef DMA2_Stream6
+#undef DMA2_Stream7
+#define DMA1_Stream0    (&HostSim_DmaStreams[0][0])
+#define DMA1_Stream1    (&HostSim_DmaStreams[0][1])
+#define DMA1_Stream2    (&HostSim_DmaStreams[0][2])
+#define DMA1_Stream3    (&HostSim_DmaStreams[0][3])
+#define DMA1_Stream4    (&HostSim_DmaStreams[0][4])
+#define DMA1_Stream5    (&HostSim_DmaStreams[0][5])
+#define DMA1_Stream6    (&HostSim_DmaStreams[0][6])
+#define DMA1_Stream7    (&HostSim_DmaStreams[0][7])
+#define DMA2_Stream0    (&HostSim_DmaStreams[1][0])
+#define DMA2_Stream1    (&HostSim_DmaStreams[1][1])
+#define DMA2_Stream2    (&HostSim_DmaStreams[1][2])
+#define DMA2_Stream3    (&HostSim_DmaStreams[1][3])
+#define DMA2_Stream4    (&HostSim_DmaStreams[1][4])
+#define DMA2_Stream5    (&HostSim_DmaStreams[1][5])
+#define DMA2_Stream6    (&HostSim_DmaStreams[1][6])
+#define DMA2_Stream7    (&HostSim_DmaStreams[1][7])
+
+/* Delays in core cycles between an SPI event and the flag reporting it, 0 for the ideal device:
+   TXE after the TX buffer moves into the shift register, RXNE after the last bit of a frame, BSY
+   clear after the last frame */
+typedef struct {
+    uint32_t txe;
+    uint32_t rxne;
+    uint32_t bsy;
+} HostSim_SpiTimingType;
+
+/* Statistics of one simulated GPIO port */
+typedef struct {
+    uint64_t writes;            /* Stores to BSRR and ODR */
+    uint64_t edges;             /* Output pin changes */
+} HostSim_GpioStatsType;
+
+/* Statistics of one simulated SPI unit */
+typedef struct {
+    uint64_t frames;            /* Frames shifted out */
+    uint64_t overruns;          /* Frames received while RXNE was still set */
+} HostSim_SpiStatsType;
+
+/* Statistics of one simulated USART */
+typedef struct {
+    uint64_t bytes;             /* Frames transmitted */
+    uint64_t busyCycles;        /* Core cycles spent shifting them out */
+    uint64_t breaks;            /* Breaks transmitted */
+    uint64_t rxBytes;           /* Frames received, breaks included */
+    uint64_t overruns;          /* Frames received while RXNE was still set */
+} HostSim_UsartStatsType;
+
+/* Receiver of the bytes transmitted by a USART, as a terminal on its TX line would be: the bytes
+   are stored while length < size, the others only counted in HostSim_UsartStats */
+typedef struct {
+    uint8_t* buffer;
+    uint32_t size;
+    uint32_t length;
+} HostSim_UsartCaptureType;
+
+/* Header seen on a LIN bus */
+typedef struct {
+    uint64_t at;                /* Cycle of the start of the break */
+    uint8_t pid;                /* Protected identifier */
+} HostSim_LinHeaderType;
+
+/* Slave on the LIN bus of a USART in LIN mode. It follows the headers the USART sends and answers
+   those whose identifier has a response with its bytes, checksum included, responseSpace bit times
+   after the identifier and back to back; a break ends a response early. The USART receives every
+   frame on the bus, its own included, as through a LIN transceiver. */
+typedef struct {
+    uint8_t response[64][9];
+    uint8_t length[64];         /* Bytes of response[id], 0 for a frame the slave does not answer */
+    uint32_t responseSpace;
+    HostSim_LinHeaderType* headers;     /* Headers with a valid identifier: stored while count < size */
+    uint32_t size;
+    uint32_t count;             /* Rewound by HostSim_Reset */
+    uint32_t responses;         /* Responses started, rewound by HostSim_Reset */
+} HostSim_LinNodeType;
+
+/* CAN frame seen on a bus */
+#define HOSTSIM_CAN_EXTENDED    0x80000000u     /* Set in id for an extended identifier */
+typedef struct {
+    uint64_t at;                /* Sent by a node: earliest start cycle. Captured: cycle of the end */
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+} HostSim_CanFrameType;
+
+/* Other node on the bus of a controller: it sends its frames in order, each as soon as the bus is
+   free and the frame is due, and competes for the bus by identifier like the controller does */
+typedef struct {
+    const HostSim_CanFrameType* frames;
+    uint32_t count;
+    uint32_t sent;              /* Frames that have left the bus, rewound by HostSim_Reset */
+} HostSim_CanNodeType;
+
+/* Receiver of the frames sent by a controller: stored while length < size */
+typedef struct {
+    HostSim_CanFrameType* buffer;
+    uint32_t size;
+    uint32_t length;
+} HostSim_CanCaptureType;
+
+/* Statistics of one simulated CAN controller */
+typedef struct {
+    uint64_t txFrames;          /* Frames sent by the controller */
+    uint64_t rxFrames;          /* Frames stored into an RX FIFO */
+    uint64_t rxLost;            /* Frames accepted by a filter and lost to a full RX FIFO */
+    uint64_t busyCycles;        /* Core cycles the bus carried a frame */
+} HostSim_CanStatsType;
+
+/* Statistics of one simulated ADC */
+typedef struct {
+    uint64_t conversions;       /* Conversions completed */
+    uint64_t overruns;          /* Results lost because DR was still unread */
+} HostSim_AdcStatsType;
+
+/* Analog input: value (12 bits) of a channel sampled at a core cycle, called once per conversion in
+   the order of the sampling instants. NULL converts 0. */
+typedef uint16_t (*HostSim_AdcSignalType)(uint32_t Channel, uint64_t Cycle);
+
+/* Statistics of one simulated timer */
+typedef struct {
+    uint64_t updates;           /* Update events, counter overflows and UG */
+    uint64_t dmaWrites;         /* Registers written by the DMA at update events */
+    uint64_t captures;          /* Counter values captured into CCRx on input edges */
+    uint64_t overcaptures;      /* Captures made while the previous one was still unread */
+    uint64_t dmaReads;          /* Registers read by the DMA at capture and trigger events */
+} HostSim_TimStatsType;
+
+/* Compare values in force on the outputs of a timer from one update event on */
+typedef struct {
+    uint64_t at;                /* Cycle of the update event */
+    uint32_t compare[4];        /* CCR1..CCR4 */
+} HostSim_TimUpdateType;
+
+/* Recorder of the update events of a timer, as a logic analyser on its outputs would see them:
+   stored while length < size */
+typedef struct {
+    HostSim_TimUpdateType* buffer;
+    uint32_t size;
+    uint32_t length;
+} HostSim_TimCaptureType;
+
+/* Statistics of the flash interface */
+typedef struct {
+    uint64_t programs;          /* Units of PSIZE bytes programmed */
+    uint64_t erases;            /* Sectors erased */
+    uint64_t busyCycles;        /* Core cycles spent programming and erasing */
+    uint64_t stallCycles;       /* Core cycles the CPU waited on a flash access during an operation */
+} HostSim_FlashStatsType;
+
+/* Input signal of a timer: cycle of the first edge of input TI1..TI4 (Input 0..3) of timer TIMn
+   (Timer n) strictly after cycle After, with the level of the input after it; UINT64_MAX once the
+   input does not change any more. Asked once per edge, in order, from the moment a channel captures
+   the input. NULL keeps every input still. */
+typedef uint64_t (*HostSim_TimInputType)(uint32_t Timer, uint32_t Input, uint64_t After, uint8_t* LevelPtr);
+
+extern uint64_t HostSim_Cycles;             /* Modelled core clock, in cycles */
+extern uint32_t HostSim_BusCycles;          /* Core cycles charged per peripheral register access */
+extern uint32_t HostSim_IrqCycles;          /* Core cycles charged per interrupt entry and exit */
+extern uint64_t HostSim_RegAccesses;        /* Peripheral register accesses made by the CPU */
+extern uint64_t HostSim_IrqCount;           /* Interrupt handlers run */
+extern HostSim_SpiStatsType HostSim_SpiStats[HOSTSIM_NUM_SPI];
+extern HostSim_GpioStatsType HostSim_GpioStats[HOSTSIM_NUM_GPIO];
+extern HostSim_UsartStatsType HostSim_UsartStats[HOSTSIM_NUM_USART];
+extern HostSim_UsartCaptureType HostSim_UsartCapture[HOSTSIM_NUM_USART];  /* Buffers kept by HostSim_Reset */
+extern HostSim_LinNodeType HostSim_LinNode[HOSTSIM_NUM_USART];      /* Responses kept by HostSim_Reset */
+extern uint16_t HostSim_GpioInput[HOSTSIM_NUM_GPIO];   /* Level of the pins not configured as outputs */
+extern HostSim_SpiTimingType HostSim_SpiTiming;        /* Kept by HostSim_Reset */
+extern HostSim_CanStatsType HostSim_CanStats[HOSTSIM_NUM_CAN];
+extern HostSim_CanNodeType HostSim_CanNode[HOSTSIM_NUM_CAN];        /* Frames kept by HostSim_Reset */
+extern HostSim_CanCaptureType HostSim_CanCapture[HOSTSIM_NUM_CAN];  /* Buffers kept by HostSim_Reset */
+extern HostSim_AdcStatsType HostSim_AdcStats[HOSTSIM_NUM_ADC];
+extern HostSim_AdcSignalType HostSim_AdcSignal;                     /* Kept by HostSim_Reset */
+extern HostSim_TimStatsType HostSim_TimStats[HOSTSIM_NUM_TIM];
+extern HostSim_TimCaptureType HostSim_TimCapture[HOSTSIM_NUM_TIM];  /* Buffers kept by HostSim_Reset */
+extern HostSim_TimInputType HostSim_TimInput;                       /* Kept by HostSim_Reset */
+extern HostSim_FlashStatsType HostSim_FlashStats;
+
+void HostSim_Reset(void);
+uint32_t HostSim_ReadReg(volatile uint32_t* Reg);
+void HostSim_WriteReg(volatile uint32_t* Reg, uint32_t Value);
+void HostSim_Idle(uint32_t Cycles);
+
+/* Interrupt masking and sleep, used by SchM.h in the host build */
+uint32_t HostSim_DisableIrq(void);
+void HostSim_RestoreIrq(uint32_t State);
+void HostSim_WaitForInterrupt(void);
+
+/* Runs the interrupt handler of SPI unit Idx as if TXE or RXNE had been raised now, whatever the
+   state of the flags and enables; returns 0 if interrupts are masked or the unit has no handler */
+uint8_t HostSim_SpiInjectIrq(uint32_t Idx);
+
+/* Puts CAN controller Idx into bus-off: it leaves the bus until software requests normal mode again */
+void HostSim_CanBusOff(uint32_t Idx);
+
+#endif /* HOSTSIM_H */
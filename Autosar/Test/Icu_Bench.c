@@ -0,0 +1,298 @@
+/*
+* File: Icu_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the ICU driver against the input capture model of HostSim.c. The
+* inputs of TIM5 and TIM8 are square waves generated to the core cycle.
+*   - Timestamps: the rising edges of the encoder at 100 kHz, 1 MHz and 4 MHz, captured by a
+*     compare interrupt per edge reading CCR4, then by Icu_StartTimestamp into a circular buffer
+*     the notifications. Every interval between two timestamps must be the
+*     period of the signal.
+*   - Duty cycle: a signal whose period changes every period, with an active time of a third of it,
+*     read at random instants by Icu_GetDutyCycleValues and by reading CCR1 and CCR2 of the timer
+*     in PWM input mode. A pair whose active time is not a third of the period mixes two periods.
+*   - Linear buffer: both edges into a linear buffer, which stops the capture once full.
+*
+*   icu_bench
+*/
+
+#include "Icu.h"
+#include <stdio.h>
+
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_STAMP_MS          10u         /* Run time of each timestamp test */
+#define BENCH_STAMPS            256u        /* Timestamps of the circular buffer */
+#define BENCH_LINEAR_STAMPS     64u
+#define BENCH_DUTY_READS        20000u      /* Random reads of the duty cycle test */
+#define BENCH_ENCODER_TICK      2u          /* Core cycles per tick of TIM5 and TIM8 */
+
+/* Square wave on input TIx (0..3) of timer TIMn, rising at start + k * period */
+typedef struct {
+    uint32_t timer;
+    uint32_t input;
+    uint64_t start;
+    uint64_t period;                        /* Core cycles, 0 for a still input */
+    uint64_t high;
+} Bench_SquareType;
+
+static Bench_SquareType Bench_Square;
+
+/* Period-changing signal of the duty cycle test on TIM8 TI2 */
+static uint8_t Bench_SweepOn;
+static uint64_t Bench_SweepAt;              /* Rising edge of the current period */
+static uint32_t Bench_SweepIndex;           /* Index of the current period */
+
+static Icu_ValueType Bench_Stamps[BENCH_STAMPS];
+static uint32_t Bench_Isr[BENCH_STAMPS];
+static uint32_t Bench_IsrCount;
+
+/* Checked by the notifications */
+static uint32_t Bench_Notifications;
+static uint32_t Bench_Errors;
+static uint32_t Bench_Last;
+static uint8_t Bench_HaveLast;
+static uint32_t Bench_Expected;             /* Ticks between two timestamps */
+
+static uint32_t Bench_Random = 0x2468ACE1u;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+/* Core cycles used by the CPU since a snapshot: register accesses and interrupt entries */
+static uint64_t Bench_CpuCycles(uint64_t regs0, uint64_t irqs0)
+{
+    return (HostSim_RegAccesses - regs0) * HostSim_BusCycles + (HostSim_IrqCount - irqs0) * HostSim_IrqCycles;
+}
+
+/* Core cycles of period k of the sweep: 3000 to 5250, a multiple of 6 so that a third of it is a
+   whole number of ticks */
+static uint64_t Bench_SweepPeriod(uint32_t k)
+{
+    return 3000u + (k % 16u) * 150u;
+}
+
+static uint64_t Bench_Input(uint32_t Timer, uint32_t Input, uint64_t After, uint8_t* LevelPtr)
+{
+    if (Bench_SweepOn && Timer == 8u && Input == 1u) {
+        for (;;) {
+            uint64_t period = Bench_SweepPeriod(Bench_SweepIndex);
+            if (Bench_SweepAt > After) {
+                *LevelPtr = 1;
+                return Bench_SweepAt;
+            }
+            if (Bench_SweepAt + period / 3u > After) {
+                *LevelPtr = 0;
+                return Bench_SweepAt + period / 3u;
+            }
+            Bench_SweepAt += period;
+            Bench_SweepIndex++;
+        }
+    }
+    if (Bench_Square.period != 0 && Timer == Bench_Square.timer && Input == Bench_Square.input) {
+        const Bench_SquareType* s = &Bench_Square;
+        if (After < s->start) {
+            *LevelPtr = 1;
+            return s->start;
+        }
+        uint64_t k = (After - s->start) / s->period;
+        uint64_t offset = (After - s->start) % s->period;
+        if (offset < s->high) {
+            *LevelPtr = 0;
+            return s->start + k * s->period + s->high;
+        }
+        *LevelPtr = 1;
+        return s->start + (k + 1u) * s->period;
+    }
+    return UINT64_MAX;
+}
+
+static void Bench_Start(uint32_t Timer, uint32_t Input, uint64_t Period, uint64_t High)
+{
+    HostSim_Reset();
+    HostSim_TimInput = Bench_Input;
+    Bench_Square.timer = Timer;
+    Bench_Square.input = Input;
+    Bench_Square.start = 1000u;
+    Bench_Square.period = Period;
+    Bench_Square.high = High;
+    Bench_SweepOn = 0;
+    Bench_Notifications = 0;
+    Bench_Errors = 0;
+    Bench_HaveLast = 0;
+    Icu_Init(NULL);
+}
+
+/* Checks the intervals of a run of timestamps against Bench_Expected */
+static void Bench_Check(const uint32_t* stamps, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (Bench_HaveLast && stamps[i] - Bench_Last != Bench_Expected) {
+            Bench_Errors++;
+        }
+        Bench_Last = stamps[i];
+        Bench_HaveLast = 1;
+    }
+}
+
+/* Each half of the circular buffer, checked while the DMA fills the other one, when the tests
+   expect a fixed interval */
+void IcuEncoder_Notification(void)
+{
+    uint32_t half = (Bench_Notifications++ % 2u) * (BENCH_STAMPS / 2u);
+
+    if (Bench_Expected != 0) {
+        Bench_Check(&Bench_Stamps[half], BENCH_STAMPS / 2u);
+    }
+}
+
+/* Compare interrupt of the baseline: one entry per edge */
+void TIM5_IRQHandler(void)
+{
+    if (TIM_GetITStatus(TIM5, TIM_IT_CC4) == SET) {
+        Bench_Isr[Bench_IsrCount++ % BENCH_STAMPS] = TIM_GetCapture4(TIM5);
+    }
+}
+
+/* Rising edges of the encoder at one rate, by interrupt then by DMA */
+static uint32_t Bench_Timestamps(uint32_t RateHz)
+{
+    uint64_t period = HOSTSIM_CORE_CLOCK_HZ / RateHz;
+    uint32_t edges = RateHz / 1000u * BENCH_STAMP_MS;
+    uint32_t errors = 0;
+
+    Bench_Start(5, 3, period, period / 2u);
+    Bench_Expected = (uint32_t)(period / BENCH_ENCODER_TICK);
+    NVIC_InitTypeDef NVIC_InitStruct = { TIM5_IRQn, 0, 0, ENABLE };
+    TIM_ICInitTypeDef TIM_ICInitStruct;
+    TIM_ICStructInit(&TIM_ICInitStruct);
+    TIM_ICInitStruct.TIM_Channel = TIM_Channel_4;
+    TIM_ITConfig(TIM5, TIM_IT_CC4, ENABLE);
+    NVIC_Init(&NVIC_InitStruct);
+    Bench_IsrCount = 0;
+    TIM_ICInit(TIM5, &TIM_ICInitStruct);
+    uint64_t cycles0 = HostSim_Cycles, regs0 = HostSim_RegAccesses, irqs0 = HostSim_IrqCount;
+    HostSim_Idle(BENCH_STAMP_MS * BENCH_MS);
+    double cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    uint32_t lost = (uint32_t)HostSim_TimStats[4].overcaptures;
+    printf("%4u kHz by interrupt:  CPU %6.3f%%, %6u irq, %6u of %u edges, %u lost\n", (unsigned)(RateHz / 1000u), cpu,
+           (unsigned)(HostSim_IrqCount - irqs0), (unsigned)Bench_IsrCount, (unsigned)edges, (unsigned)lost);
+
+    Bench_Start(5, 3, period, period / 2u);
+    Icu_EnableNotification(ICU_CHANNEL_ENCODER);
+    errors += (Icu_StartTimestamp(ICU_CHANNEL_ENCODER, Bench_Stamps, BENCH_STAMPS, BENCH_STAMPS / 2u) != E_OK);
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    irqs0 = HostSim_IrqCount;
+    HostSim_Idle(BENCH_STAMP_MS * BENCH_MS);
+    cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    uint32_t stored = Bench_Notifications * (BENCH_STAMPS / 2u) + Icu_GetTimestampIndex(ICU_CHANNEL_ENCODER) % (BENCH_STAMPS / 2u);
+    lost = (uint32_t)HostSim_TimStats[4].overcaptures;
+    errors += Bench_Errors + lost + (stored != HostSim_TimStats[4].captures) + (Icu_StopTimestamp(ICU_CHANNEL_ENCODER) != E_OK);
+    printf("%4u kHz by DMA:        CPU %6.3f%%, %6u irq, %6u of %u edges, %u lost, %u bad intervals%s\n",
+           (unsigned)(RateHz / 1000u), cpu, (unsigned)(HostSim_IrqCount - irqs0), (unsigned)stored, (unsigned)edges,
+           (unsigned)lost, (unsigned)Bench_Errors, errors ? "  FAILED" : "");
+    Icu_DeInit();
+    return errors;
+}
+
+/* Random reads of a period-changing signal through the driver, then from the capture registers */
+static uint32_t Bench_DutyCycle(void)
+{
+    Icu_DutyCycleType values;
+    uint32_t errors = 0;
+    uint32_t mixed[2] = { 0, 0 };
+    uint32_t empty = 0;
+
+    Bench_Start(0, 0, 0, 0);
+    Bench_SweepOn = 1;
+    Bench_SweepAt = HostSim_Cycles + 1000u;
+    Bench_SweepIndex = 0;
+    errors += (Icu_StartTimestamp(ICU_CHANNEL_PWM_IN, Bench_Stamps, BENCH_STAMPS, 0) != E_NOT_OK);
+    errors += (Icu_SetActivationCondition(ICU_CHANNEL_PWM_IN, ICU_BOTH_EDGES) != E_NOT_OK);
+    errors += (Icu_StartSignalMeasurement(ICU_CHANNEL_PWM_IN) != E_OK);
+    errors += (Icu_StartSignalMeasurement(ICU_CHANNEL_PWM_IN) != E_NOT_OK);
+    /* Nothing until the end of the first complete period: the burst of the first edge is discarded */
+    HostSim_Idle(1000u + (uint32_t)Bench_SweepPeriod(0) - 200u);
+    Icu_GetDutyCycleValues(ICU_CHANNEL_PWM_IN, &values);
+    errors += (values.PeriodTime != 0 || values.ActiveTime != 0);
+
+    for (uint32_t method = 0; method < 2; method++) {
+        uint64_t regs0 = HostSim_RegAccesses;
+        for (uint32_t i = 0; i < BENCH_DUTY_READS; i++) {
+            HostSim_Idle(Bench_Rand() % 6000u);
+            if (method == 0) {
+                Icu_GetDutyCycleValues(ICU_CHANNEL_PWM_IN, &values);
+            } else {
+                values.ActiveTime = TIM_GetCapture1(TIM8);
+                values.PeriodTime = TIM_GetCapture2(TIM8);
+            }
+            if (values.PeriodTime == 0) {
+                empty++;
+            } else if (values.ActiveTime * 3u != values.PeriodTime) {
+                mixed[method]++;
+            }
+        }
+        printf("%-24s %4.2f reg per read, %5u of %u pairs from two periods\n",
+               (method == 0) ? "Icu_GetDutyCycleValues:" : "CCR1 and CCR2 read:",
+               (double)(HostSim_RegAccesses - regs0) / BENCH_DUTY_READS, (unsigned)mixed[method], BENCH_DUTY_READS);
+    }
+    errors += mixed[0] + empty;
+    errors += (Icu_GetTimeElapsed(ICU_CHANNEL_PWM_IN) == 0);
+    errors += (Icu_StopSignalMeasurement(ICU_CHANNEL_PWM_IN) != E_OK);
+    errors += (Icu_StopSignalMeasurement(ICU_CHANNEL_PWM_IN) != E_NOT_OK);
+    printf("duty cycle:              %s\n", errors ? "FAILED" : "ok");
+    Icu_DeInit();
+    return errors;
+}
+
+/* Both edges of a 1 MHz signal with 25 % duty into a linear buffer, notified by halves */
+static uint32_t Bench_Linear(void)
+{
+    static Icu_ChannelConfigType config[ICU_MAX_CHANNEL];
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < ICU_MAX_CHANNEL; i++) {
+        config[i] = Icu_ChannelConfig[i];
+    }
+    config[ICU_CHANNEL_ENCODER].bufferType = ICU_LINEAR_BUFFER;
+    Bench_Start(5, 3, 168, 42);
+    Bench_Expected = 0;
+    Icu_Init(config);
+    Icu_EnableNotification(ICU_CHANNEL_ENCODER);
+    errors += (Icu_SetActivationCondition(ICU_CHANNEL_ENCODER, ICU_BOTH_EDGES) != E_OK);
+    errors += (Icu_StartTimestamp(ICU_CHANNEL_ENCODER, Bench_Stamps, BENCH_LINEAR_STAMPS, 10) != E_NOT_OK);
+    errors += (Icu_StartTimestamp(ICU_CHANNEL_ENCODER, Bench_Stamps, BENCH_LINEAR_STAMPS, BENCH_LINEAR_STAMPS / 2u) != E_OK);
+    errors += (Icu_StartTimestamp(ICU_CHANNEL_ENCODER, Bench_Stamps, BENCH_LINEAR_STAMPS, 0) != E_NOT_OK);
+    errors += (Icu_SetActivationCondition(ICU_CHANNEL_ENCODER, ICU_RISING_EDGE) != E_NOT_OK);
+    HostSim_Idle(BENCH_MS);
+    errors += (Bench_Notifications != 2u || Icu_GetTimestampIndex(ICU_CHANNEL_ENCODER) != BENCH_LINEAR_STAMPS);
+    errors += (Icu_StopTimestamp(ICU_CHANNEL_ENCODER) != E_NOT_OK);
+    /* High for 21 ticks, low for 63 */
+    for (uint32_t i = 1; i < BENCH_LINEAR_STAMPS; i++) {
+        uint32_t delta = Bench_Stamps[i] - Bench_Stamps[i - 1u];
+        errors += (delta != 21u && delta != 63u) || (i > 1u && delta == Bench_Stamps[i - 1u] - Bench_Stamps[i - 2u]);
+    }
+    errors += (HostSim_TimStats[4].captures != BENCH_LINEAR_STAMPS);
+    Icu_DeInit();
+    errors += (TIM5->CR1 & TIM_CR1_CEN) || (TIM8->CR1 & TIM_CR1_CEN);
+    printf("linear buffer:           %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    static const uint32_t rates[] = { 100000u, 1000000u, 4000000u };
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        errors += Bench_Timestamps(rates[i]);
+    }
+    errors += Bench_DutyCycle();
+    errors += Bench_Linear();
+    return errors ? 1 : 0;
+}
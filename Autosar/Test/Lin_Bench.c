@@ -0,0 +1,372 @@
+/*
+* File: Lin_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the LIN driver on UART5 at 19200 bit/s, with the slave node of
+* HostSim.c answering the slave responses of Lin_Cfg.h one bit time after the header.
+*   - Schedule: three seconds of LIN_SCHEDULE_NORMAL while the main loop runs tasks of 0 to 3 ms,
+*     against a main-function master calling Lin_SendFrame from a 1 ms task loop under the same
+*     load. The break of each header is compared with the grid of the schedule slots; the data of
+*     every frame are checked, and the interrupts per frame counted.
+*   - Frames: Lin_SendFrame with a master response, a slave response ended before its timer, a
+*     wrong checksum, a silent slave and a response cut short.
+*   - Switch: LIN_SCHEDULE_DIAG requested in the middle of a slot starts at the end of that slot,
+*     on the grid, and Lin_StopSchedule stops the bus at the end of the next one.
+*   - Shared stream: DMA1 stream 0 also serves SPI3, so Lin_Init fails while SPI3 is in
+*     SPI_DMA_MODE, and Spi_SetAsyncMode refuses that mode for SPI3 while the driver runs.
+*
+*   lin_bench
+*/
+
+#include "Lin.h"
+#include "Spi.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_UART5             3u          /* Index of UART5 in the model */
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_US                (HOSTSIM_CORE_CLOCK_HZ / 1000000u)
+#define BENCH_TICK              (BENCH_MS / LIN_TIMER_TICKS_PER_MS)     /* Core cycles per timer tick */
+#define BENCH_RUN               (3000u * BENCH_MS)
+#define BENCH_MAX_HEADERS       512u
+#define BENCH_MAX_TASK          (3u * BENCH_MS)
+#define BENCH_MAX_JITTER        (20u * BENCH_US)    /* Break of a scheduled header after its slot start */
+#define BENCH_MAX_IRQS          2.0                 /* Interrupts per scheduled frame */
+
+static HostSim_LinHeaderType Bench_Headers[BENCH_MAX_HEADERS];
+static uint32_t Bench_Random = 0x12345678u;
+
+static uint8_t Bench_DoorCommand[4] = { 0x01, 0x80, 0x00, 0x5A };
+static const uint8_t Bench_DoorStatus[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+static const uint8_t Bench_SeatStatus[2] = { 0x0F, 0xF0 };
+static const uint8_t Bench_SlaveResponse[8] = { 0x01, 0x06, 0x62, 0xF1, 0x90, 0x4C, 0x49, 0x4E };
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+/* Checksum of a response, as the slave computes it */
+static uint8_t Bench_Checksum(uint8_t Pid, Lin_FrameCsModelType Cs, const uint8_t* Data, uint8_t Dl)
+{
+    uint32_t sum = (Cs == LIN_ENHANCED_CS) ? Pid : 0u;
+
+    for (uint8_t i = 0; i < Dl; i++) {
+        sum += Data[i];
+        sum = (sum & 0xFFu) + (sum >> 8);
+    }
+    return (uint8_t)~sum;
+}
+
+/* Response of the slave to a frame of LIN_FRAMES, Length bytes of it sent (checksum included);
+   a checksum offset by Corrupt */
+static void Bench_SetResponse(Lin_FrameType Frame, const uint8_t* Data, uint8_t Length, uint8_t Corrupt)
+{
+    const Lin_FrameConfigType* frame = &Lin_FrameConfig[Frame];
+    HostSim_LinNodeType* node = &HostSim_LinNode[BENCH_UART5];
+
+    memcpy(node->response[frame->id], Data, frame->length);
+    node->response[frame->id][frame->length] =
+        (uint8_t)(Bench_Checksum(Lin_GetPid(frame->id), frame->cs, Data, frame->length) + Corrupt);
+    node->length[frame->id] = Length;
+}
+
+/* Starts the model and the driver with the slave answering every slave response */
+static void Bench_Start(void)
+{
+    HostSim_LinNodeType* node = &HostSim_LinNode[BENCH_UART5];
+
+    HostSim_Reset();
+    memset(node->length, 0, sizeof(node->length));
+    node->responseSpace = 1;
+    node->headers = Bench_Headers;
+    node->size = BENCH_MAX_HEADERS;
+    Bench_SetResponse(LIN_FRAME_DOOR_STATUS, Bench_DoorStatus, 9, 0);
+    Bench_SetResponse(LIN_FRAME_SEAT_STATUS, Bench_SeatStatus, 3, 0);
+    Bench_SetResponse(LIN_FRAME_SLAVE_RESPONSE, Bench_SlaveResponse, 9, 0);
+    (void)Lin_Init(NULL);
+}
+
+/* Slot of entry Entry of a schedule, in core cycles */
+static uint64_t Bench_SlotCycles(Lin_ScheduleType Schedule, uint32_t Entry)
+{
+    const Lin_ScheduleConfigType* schedule = &Lin_ScheduleConfig[Schedule];
+    return (uint64_t)schedule->entries[Entry % schedule->numEntries].ticks * BENCH_TICK;
+}
+
+/* Checks the headers of a run of LIN_SCHEDULE_NORMAL against the grid of its slots from the first
+   break: returns the largest distance from a slot start, counting the headers out of order */
+static uint64_t Bench_Jitter(uint32_t* ErrorsPtr)
+{
+    const Lin_ScheduleConfigType* schedule = &Lin_ScheduleConfig[LIN_SCHEDULE_NORMAL];
+    uint32_t count = HostSim_LinNode[BENCH_UART5].count;
+    uint64_t slot = Bench_Headers[0].at;
+    uint64_t worst = 0;
+
+    if (count > BENCH_MAX_HEADERS) {
+        count = BENCH_MAX_HEADERS;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t at = Bench_Headers[i].at;
+        uint64_t d = (at > slot) ? at - slot : slot - at;
+        uint8_t pid = Lin_GetPid(Lin_FrameConfig[schedule->entries[i % schedule->numEntries].frame].id);
+
+        if (Bench_Headers[i].pid != pid) {
+            (*ErrorsPtr)++;
+        }
+        if (d > worst) {
+            worst = d;
+        }
+        slot += Bench_SlotCycles(LIN_SCHEDULE_NORMAL, i);
+    }
+    return worst;
+}
+
+/* Checks the data of the frames of LIN_SCHEDULE_NORMAL read from the driver */
+static uint32_t Bench_CheckFrames(void)
+{
+    uint8_t data[8];
+    uint32_t errors = 0;
+
+    if (Lin_ReadFrame(LIN_FRAME_DOOR_COMMAND, NULL) != LIN_TX_OK) {
+        errors++;
+    }
+    if (Lin_ReadFrame(LIN_FRAME_DOOR_STATUS, data) != LIN_RX_OK || memcmp(data, Bench_DoorStatus, 8) != 0) {
+        errors++;
+    }
+    if (Lin_ReadFrame(LIN_FRAME_SEAT_STATUS, data) != LIN_RX_OK || memcmp(data, Bench_SeatStatus, 2) != 0) {
+        errors++;
+    }
+    return errors;
+}
+
+/* Runs the main loop for BENCH_RUN: tasks of random length, and in the main-function master the
+   frames of LIN_SCHEDULE_NORMAL sent from the 1 ms task once their slot has started. A frame still
+   on the bus when the next one is due is abandoned and counted in *LostPtr. */
+static void Bench_MainLoop(uint8_t Polled, uint32_t* ErrorsPtr, uint32_t* LostPtr)
+{
+    uint64_t end = HostSim_Cycles + BENCH_RUN;
+    uint64_t tick = HostSim_Cycles;
+    uint64_t slot = HostSim_Cycles;
+    uint32_t entry = 0;
+    const Lin_ScheduleConfigType* schedule = &Lin_ScheduleConfig[LIN_SCHEDULE_NORMAL];
+
+    while (HostSim_Cycles < end) {
+        if (HostSim_Cycles < tick) {
+            HostSim_Idle((uint32_t)(tick - HostSim_Cycles));
+        }
+        tick += BENCH_MS;
+        if (Polled && HostSim_Cycles >= slot) {
+            const Lin_FrameConfigType* frame = &Lin_FrameConfig[schedule->entries[entry % schedule->numEntries].frame];
+            Lin_PduType pdu = { Lin_GetPid(frame->id), frame->cs, frame->drc, frame->length, Bench_DoorCommand };
+            Lin_StatusType status = Lin_GetStatus(LIN_CHANNEL_0, NULL);
+
+            if (entry > 0 && status != LIN_TX_OK && status != LIN_RX_OK) {
+                (*LostPtr)++;
+            }
+            if (Lin_SendFrame(LIN_CHANNEL_0, &pdu) != E_OK) {
+                (*ErrorsPtr)++;
+            }
+            slot += Bench_SlotCycles(LIN_SCHEDULE_NORMAL, entry);
+            entry++;
+        }
+        HostSim_Idle(Bench_Rand() % BENCH_MAX_TASK);
+    }
+}
+
+static uint32_t Bench_Schedule(void)
+{
+    Lin_StatsType stats;
+    uint32_t errors = 0;
+    uint32_t lost = 0;
+    uint64_t jitter;
+    uint32_t frames;
+
+    /* Main-function master */
+    Bench_Start();
+    Bench_MainLoop(1, &errors, &lost);
+    HostSim_Idle(10u * BENCH_MS);
+    jitter = Bench_Jitter(&errors);
+    frames = HostSim_LinNode[BENCH_UART5].count;
+    printf("%-28s %4u frames, %3u cut by the next, slot start off by up to %7.1f us, %4.2f interrupts per frame%s\n",
+           "1 ms task, Lin_SendFrame:", (unsigned)frames, (unsigned)lost, (double)jitter / BENCH_US,
+           frames ? (double)HostSim_IrqCount / frames : 0.0, errors ? "  FAILED" : "");
+    Lin_DeInit();
+
+    /* Schedule table on the timer */
+    uint32_t scheduleErrors = 0;
+    Bench_Start();
+    Lin_WriteFrame(LIN_FRAME_DOOR_COMMAND, Bench_DoorCommand);
+    Lin_StartSchedule(LIN_CHANNEL_0, LIN_SCHEDULE_NORMAL);
+    Bench_MainLoop(0, &scheduleErrors, &lost);
+    Lin_StopSchedule(LIN_CHANNEL_0);
+    HostSim_Idle(20u * BENCH_MS);
+    jitter = Bench_Jitter(&scheduleErrors);
+    scheduleErrors += Bench_CheckFrames();
+    Lin_GetStats(&stats);
+    frames = HostSim_LinNode[BENCH_UART5].count;
+    if (jitter > BENCH_MAX_JITTER || stats.frames != frames || stats.headerErrors + stats.txErrors +
+        stats.rxErrors + stats.noResponses + stats.unexpectedBreaks != 0 ||
+        (double)HostSim_IrqCount / frames > BENCH_MAX_IRQS) {
+        scheduleErrors++;
+    }
+    printf("%-28s %4u frames, %3u with errors, slot start off by up to %7.1f us, %4.2f interrupts per frame%s\n",
+           "schedule table, TIM4:", (unsigned)frames, (unsigned)(stats.headerErrors + stats.txErrors +
+           stats.rxErrors + stats.noResponses), (double)jitter / BENCH_US,
+           (double)HostSim_IrqCount / frames, scheduleErrors ? "  FAILED" : "");
+    Lin_DeInit();
+    return errors + scheduleErrors;
+}
+
+/* Sends a frame with Lin_SendFrame and polls Lin_GetStatus every 100 us until it is not busy:
+   returns the status, and in *TimePtr the time from the call */
+static Lin_StatusType Bench_SendFrame(Lin_FrameType Frame, uint8_t** SduPtr, uint64_t* TimePtr)
+{
+    const Lin_FrameConfigType* frame = &Lin_FrameConfig[Frame];
+    Lin_PduType pdu = { Lin_GetPid(frame->id), frame->cs, frame->drc, frame->length, Bench_DoorCommand };
+    uint64_t start = HostSim_Cycles;
+    Lin_StatusType status;
+
+    if (Lin_SendFrame(LIN_CHANNEL_0, &pdu) != E_OK) {
+        return LIN_NOT_OK;
+    }
+    do {
+        HostSim_Idle(100u * BENCH_US);
+        status = Lin_GetStatus(LIN_CHANNEL_0, SduPtr);
+    } while ((status == LIN_TX_BUSY || status == LIN_RX_BUSY) && HostSim_Cycles - start < 20u * BENCH_MS);
+    *TimePtr = HostSim_Cycles - start;
+    /* Lets the timer of the frame end */
+    HostSim_Idle(10u * BENCH_MS);
+    return status;
+}
+
+static uint32_t Bench_Check(const char* Name, Lin_StatusType Status, Lin_StatusType Expected, uint64_t Time)
+{
+    static const char* const names[] = {
+        "LIN_NOT_OK", "LIN_TX_OK", "LIN_TX_BUSY", "LIN_TX_HEADER_ERROR", "LIN_TX_ERROR", "LIN_RX_OK",
+        "LIN_RX_BUSY", "LIN_RX_ERROR", "LIN_RX_NO_RESPONSE", "LIN_OPERATIONAL"
+    };
+
+    printf("%-28s %-20s after %6.3f ms%s\n", Name, names[Status], (double)Time / BENCH_MS,
+           Status != Expected ? "  FAILED" : "");
+    return Status != Expected;
+}
+
+static uint32_t Bench_Frames(void)
+{
+    Lin_StatsType stats;
+    uint8_t* sdu = NULL;
+    uint64_t time;
+    uint32_t errors = 0;
+    Lin_StatusType status;
+
+    Bench_Start();
+    status = Bench_SendFrame(LIN_FRAME_DOOR_COMMAND, NULL, &time);
+    errors += Bench_Check("master response:", status, LIN_TX_OK, time);
+    status = Bench_SendFrame(LIN_FRAME_DOOR_STATUS, &sdu, &time);
+    errors += Bench_Check("slave response:", status, LIN_RX_OK, time);
+    if (status == LIN_RX_OK && (sdu == NULL || memcmp(sdu, Bench_DoorStatus, 8) != 0)) {
+        printf("%-28s data differ  FAILED\n", "");
+        errors++;
+    }
+    /* Ended by the DMA before the longest time of the frame */
+    if (time >= (uint64_t)LIN_FRAME_MAX_TICKS(8u) * BENCH_TICK) {
+        errors++;
+    }
+    Bench_SetResponse(LIN_FRAME_DOOR_STATUS, Bench_DoorStatus, 9, 1);
+    status = Bench_SendFrame(LIN_FRAME_DOOR_STATUS, NULL, &time);
+    errors += Bench_Check("wrong checksum:", status, LIN_RX_ERROR, time);
+    Bench_SetResponse(LIN_FRAME_DOOR_STATUS, Bench_DoorStatus, 0, 0);
+    status = Bench_SendFrame(LIN_FRAME_DOOR_STATUS, NULL, &time);
+    errors += Bench_Check("silent slave:", status, LIN_RX_NO_RESPONSE, time);
+    Bench_SetResponse(LIN_FRAME_DOOR_STATUS, Bench_DoorStatus, 4, 0);
+    status = Bench_SendFrame(LIN_FRAME_DOOR_STATUS, NULL, &time);
+    errors += Bench_Check("response cut short:", status, LIN_RX_ERROR, time);
+
+    Lin_GetStats(&stats);
+    if (stats.frames != 5 || stats.rxErrors != 2 || stats.noResponses != 1 || stats.unexpectedBreaks != 0) {
+        printf("%-28s %u frames, %u errors, %u no response  FAILED\n", "counters:", (unsigned)stats.frames,
+               (unsigned)stats.rxErrors, (unsigned)stats.noResponses);
+        errors++;
+    }
+    Lin_DeInit();
+    return errors;
+}
+
+static uint32_t Bench_Switch(void)
+{
+    const Lin_ScheduleConfigType* normal = &Lin_ScheduleConfig[LIN_SCHEDULE_NORMAL];
+    uint8_t masterRequest = Lin_GetPid(Lin_FrameConfig[LIN_FRAME_MASTER_REQUEST].id);
+    uint8_t data[8];
+    uint32_t errors = 0;
+    uint32_t count;
+    uint64_t expected;
+
+    Bench_Start();
+    Lin_StartSchedule(LIN_CHANNEL_0, LIN_SCHEDULE_NORMAL);
+    /* Half way into the second slot */
+    HostSim_Idle((uint32_t)(Bench_SlotCycles(LIN_SCHEDULE_NORMAL, 0) + Bench_SlotCycles(LIN_SCHEDULE_NORMAL, 1) / 2u));
+    Lin_StartSchedule(LIN_CHANNEL_0, LIN_SCHEDULE_DIAG);
+    HostSim_Idle((uint32_t)(Bench_SlotCycles(LIN_SCHEDULE_NORMAL, 1) / 2u + Bench_SlotCycles(LIN_SCHEDULE_DIAG, 0) / 2u));
+    Lin_StopSchedule(LIN_CHANNEL_0);
+    HostSim_Idle(50u * BENCH_MS);
+
+    count = HostSim_LinNode[BENCH_UART5].count;
+    expected = Bench_Headers[0].at + Bench_SlotCycles(LIN_SCHEDULE_NORMAL, 0) + Bench_SlotCycles(LIN_SCHEDULE_NORMAL, 1);
+    if (count != 3 || Bench_Headers[2].pid != masterRequest || Bench_Headers[2].at < expected ||
+        Bench_Headers[2].at - expected > BENCH_MAX_JITTER ||
+        Bench_Headers[1].pid != Lin_GetPid(Lin_FrameConfig[normal->entries[1].frame].id)) {
+        errors++;
+    }
+    if (Lin_ReadFrame(LIN_FRAME_MASTER_REQUEST, data) != LIN_TX_OK) {
+        errors++;
+    }
+    printf("%-28s %u headers, diagnostic schedule from %6.3f ms, slot start at %6.3f ms%s\n",
+           "NORMAL to DIAG, then stop:", (unsigned)count,
+           count >= 3 ? (double)(Bench_Headers[2].at - Bench_Headers[0].at) / BENCH_MS : 0.0,
+           (double)(expected - Bench_Headers[0].at) / BENCH_MS, errors ? "  FAILED" : "");
+    Lin_DeInit();
+    return errors;
+}
+
+/* DMA1 stream 0, the reception of the driver, is also the RX stream of SPI3 */
+static uint32_t Bench_SharedStream(void)
+{
+    uint32_t errors = 0;
+
+    HostSim_Reset();
+    errors += (Spi_Init(NULL) != E_OK);
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_2, SPI_DMA_MODE) != E_OK);
+    errors += (Lin_Init(NULL) != E_NOT_OK || Lin_StartSchedule(LIN_CHANNEL_0, LIN_SCHEDULE_NORMAL) != E_NOT_OK);
+    /* The stream keeps the request of SPI3 */
+    errors += ((LIN_RX_DMA_STREAM->CR & DMA_SxCR_CHSEL) != DMA_Channel_0);
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_2, SPI_POLLING_MODE) != E_OK || Lin_Init(NULL) != E_OK);
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_2, SPI_DMA_MODE) != E_NOT_OK);
+    /* The other units and modes are not affected */
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_2, SPI_INTERRUPT_MODE) != E_OK);
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_1, SPI_DMA_MODE) != E_OK);
+    Lin_DeInit();
+    errors += (Spi_SetAsyncMode(SPI_HWUnit_2, SPI_DMA_MODE) != E_OK);
+    errors += (Spi_DeInit() != E_OK);
+    printf("%-28s %s\n", "DMA1 stream 0 with SPI3:", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    printf("LIN master on UART5 at %u bit/s, slot grid of LIN_SCHEDULE_NORMAL, tasks of 0 to %u ms:\n",
+           (unsigned)LIN_BAUDRATE, (unsigned)(BENCH_MAX_TASK / BENCH_MS));
+    failed += Bench_Schedule();
+    printf("frames of Lin_SendFrame, Lin_GetStatus polled every 100 us:\n");
+    failed += Bench_Frames();
+    printf("schedule switch:\n");
+    failed += Bench_Switch();
+    printf("shared DMA stream:\n");
+    failed += Bench_SharedStream();
+    return failed ? 1 : 0;
+}
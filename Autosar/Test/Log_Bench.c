@@ -0,0 +1,117 @@
+/*
+* File: Log_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the binary log against the register model of HostSim.c. A
+* baseline formats each message and sends it over the polled USART, as a blocking printf does.
+* The binary log then stores the same messages at a steady rate while the modelled core idles,
+* and a burst larger than the ring checks that records are dropped and reported rather than
+* corrupted. The bytes received on the USART are written to a file for Log_Decode.c.
+*
+*   log_bench [capture.bin]
+*/
+
+#include "Log.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_MESSAGES      1000u       /* Messages of the blocking baseline */
+#define BENCH_RECORDS       20000u      /* Records of the steady phase */
+#define BENCH_PERIOD        40000u      /* Core cycles between two records of the steady phase */
+#define BENCH_BURST         1000u       /* Records logged back to back */
+#define BENCH_LOG_USART     1u          /* Index of USART2 in the model */
+
+static uint8_t Bench_Capture[1u << 20];
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Blocking text output: format, then wait for TXE before each character */
+static void Bench_PolledPrint(uint32_t index, uint32_t data)
+{
+    char text[64];
+    int length = snprintf(text, sizeof(text), "SPI rx[%u] = %04X\n", (unsigned)index, (unsigned)data);
+
+    for (int i = 0; i < length; i++) {
+        while (USART_GetFlagStatus(LOG_USART, USART_FLAG_TXE) == RESET) {
+        }
+        USART_SendData(LOG_USART, (uint8_t)text[i]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc > 1) ? argv[1] : "build/log.bin";
+    HostSim_UsartCaptureType* capture = &HostSim_UsartCapture[BENCH_LOG_USART];
+    uint64_t cycles0, regs0, ns0;
+    uint64_t writeNs = 0, writeCycles = 0, writeRegs = 0;
+    uint64_t mainRegs = 0;
+    uint32_t stored = 0, burstDropped = 0;
+    FILE* out;
+
+    /* Baseline: the CPU waits for the USART on every character */
+    HostSim_Reset();
+    Log_Init();
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++) {
+        Bench_PolledPrint(i % 3u, i * 7u);
+    }
+    printf("blocking text:  %8.0f cycles/message  %6.1f reg/message\n",
+           (double)(HostSim_Cycles - cycles0) / BENCH_MESSAGES,
+           (double)(HostSim_RegAccesses - regs0) / BENCH_MESSAGES);
+
+    /* Binary log, steady rate: the main loop calls Log_MainFunction after each record */
+    HostSim_Reset();
+    capture->buffer = Bench_Capture;
+    capture->size = sizeof(Bench_Capture);
+    Log_Init();
+    LOG1(LOG_ID_BOOT, HOSTSIM_CORE_CLOCK_HZ);
+    cycles0 = HostSim_Cycles;
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        uint64_t c = HostSim_Cycles;
+        uint64_t r = HostSim_RegAccesses;
+        uint64_t ns = Bench_HostNow();
+        stored += (LOG2(LOG_ID_SPI_RX_FRAME, i % 3u, i * 7u) == E_OK);
+        writeNs += Bench_HostNow() - ns;
+        writeCycles += HostSim_Cycles - c;
+        writeRegs += HostSim_RegAccesses - r;
+
+        r = HostSim_RegAccesses;
+        Log_MainFunction();
+        mainRegs += HostSim_RegAccesses - r;
+        HostSim_Idle(BENCH_PERIOD);
+    }
+    printf("Log_Write:      %8.1f cycles/record   %6.1f reg/record     %6.1f ns/record (host)\n",
+           (double)writeCycles / BENCH_RECORDS, (double)writeRegs / BENCH_RECORDS, (double)writeNs / BENCH_RECORDS);
+    printf("Log_MainFunction: %6.1f reg/call, USART busy %.1f %%, %u of %u records stored\n",
+           (double)mainRegs / BENCH_RECORDS,
+           100.0 * (double)HostSim_UsartStats[BENCH_LOG_USART].busyCycles / (double)(HostSim_Cycles - cycles0),
+           (unsigned)stored, (unsigned)BENCH_RECORDS);
+
+    /* Burst: the ring overflows, the drops are counted and reported by the next Log_MainFunction */
+    ns0 = Bench_HostNow();
+    for (uint32_t i = 0; i < BENCH_BURST; i++) {
+        burstDropped += (LOG2(LOG_ID_SPI_RX_BLOCK, i, 8) != E_OK);
+    }
+    printf("burst:          %u of %u records dropped, %.1f ns/record (host)\n",
+           (unsigned)burstDropped, (unsigned)BENCH_BURST, (double)(Bench_HostNow() - ns0) / BENCH_BURST);
+    Log_Flush();
+    Log_MainFunction();
+    Log_Flush();
+
+    printf("captured %u bytes, expect %u records: boot + %u + %u + 1 drop report\n",
+           (unsigned)capture->length, (unsigned)(1u + stored + BENCH_BURST - burstDropped + 1u),
+           (unsigned)stored, (unsigned)(BENCH_BURST - burstDropped));
+    if ((out = fopen(path, "wb")) == NULL) {
+        perror(path);
+        return 1;
+    }
+    fwrite(Bench_Capture, 1, capture->length, out);
+    fclose(out);
+    return (Log_GetDropped() == 0 && stored == BENCH_RECORDS) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/*
+* File: Log_Decode.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host decoder of the binary log stream sent by Log.c. Reads the bytes captured from
+* the log USART (a file, or standard input) and prints one line per record with its timestamp
+* and its message formatted with the table of Log_Cfg.h. The stream may start in the middle of a
+* record or contain corrupted bytes: the decoder skips bytes until it finds a valid header and
+* counts them.
+*
+*   log_decode [capture.bin]
+*/
+
+#include "Log.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_MESSAGE_FORMAT(id, format)  format,
+
+static const char* const Decode_Formats[LOG_NUM_MESSAGES] = {
+    LOG_MESSAGES(LOG_MESSAGE_FORMAT)
+};
+
+static uint32_t Decode_Word(const uint8_t* bytes)
+{
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/* Reads a whole stream into memory */
+static uint8_t* Decode_Load(FILE* in, size_t* length)
+{
+    size_t size = 1u << 16;
+    uint8_t* data = malloc(size);
+    size_t n;
+
+    *length = 0;
+    while (data != NULL && (n = fread(data + *length, 1, size - *length, in)) > 0) {
+        *length += n;
+        if (*length == size) {
+            uint8_t* bigger = realloc(data, size * 2u);
+            if (bigger == NULL) {
+                free(data);
+                return NULL;
+            }
+            data = bigger;
+            size *= 2u;
+        }
+    }
+    return data;
+}
+
+int main(int argc, char** argv)
+{
+    FILE* in = stdin;
+    uint8_t* data;
+    size_t length;
+    size_t pos = 0;
+    uint64_t records = 0;
+    uint64_t badBytes = 0;
+    uint64_t timeHigh = 0;          /* Wraps of the 32-bit timestamp */
+    uint32_t lastTime = 0;
+
+    if (argc > 1 && (in = fopen(argv[1], "rb")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    data = Decode_Load(in, &length);
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (data == NULL) {
+        fprintf(stderr, "log_decode: out of memory\n");
+        return 1;
+    }
+
+    while (pos + LOG_HEADER_WORDS * 4u <= length) {
+        uint32_t header = Decode_Word(&data[pos]);
+        uint32_t id = (header >> 8) & 0xFFu;
+        uint32_t count = (header >> 16) & 0xFFu;
+        uint32_t args[LOG_MAX_ARGS] = { 0 };
+        uint32_t time;
+
+        if (header != LOG_HEADER(id, count) || id >= LOG_NUM_MESSAGES || count > LOG_MAX_ARGS ||
+            pos + (LOG_HEADER_WORDS + count) * 4u > length) {
+            badBytes++;
+            pos++;
+            continue;
+        }
+
+        time = Decode_Word(&data[pos + 4u]);
+        if (records != 0 && time < lastTime) {
+            timeHigh += 1ull << 32;
+        }
+        lastTime = time;
+        for (uint32_t i = 0; i < count; i++) {
+            args[i] = Decode_Word(&data[pos + (LOG_HEADER_WORDS + i) * 4u]);
+        }
+
+        printf("[%14.3f us] ", (double)(timeHigh + time) * 1e6 / LOG_TIMESTAMP_HZ);
+        printf(Decode_Formats[id], (unsigned)args[0], (unsigned)args[1], (unsigned)args[2], (unsigned)args[3]);
+        putchar('\n');
+        records++;
+        pos += (LOG_HEADER_WORDS + count) * 4u;
+    }
+    badBytes += length - pos;
+
+    printf("# %llu records, %llu bad bytes\n", (unsigned long long)records, (unsigned long long)badBytes);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+* File: NvM_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the NVM module over the FEE module, the FLS driver and the flash model
+* of HostSim.c, with 12 blocks of 16 to 195 bytes; the main loop runs every NVM_MAIN_FUNCTION_PERIOD_MS.
+*   - Frequent writer: a block changed and written every millisecond for 2 s, each request written
+*     to the FEE module in turn, then through NvM_WriteBlock without and with a write delay: the
+*     records reaching the flash and the units programmed.
+*   - The DTC block of NvM_Cfg.c, with its write delay, written every 100 ms for 20 s by the cycle of
+*     main.c: the records reaching the flash.
+*   - NvM_WriteAll with 2 of 12 blocks changed, with and without the CRC comparison.
+*   - Priority: an immediate write requested behind 8 queued writes.
+*   - NvM_ReadAll after a reset, a block whose CRC is wrong, blocks never written with and without
+*     default data, and argument checks.
+*
+*   nvm_bench
+*/
+
+#include "NvM.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_BLOCKS            12u
+#define BENCH_CHATTY            2u          /* Block of the frequent writer */
+#define BENCH_TICKS             2000u
+#define BENCH_DELAY             20u         /* Write delay of the frequent writer, in milliseconds */
+#define BENCH_DTC_MS            20000u      /* Duration of the DTC writer */
+#define BENCH_DTC_PERIOD_MS     100u        /* Main cycle of main.c, the most a DTC changes */
+
+/* RAM blocks of NvM_Cfg.c, unused here */
+uint32_t App_BootCount;
+uint8_t App_Calibration[64];
+uint8_t App_Dtc[128];
+
+static uint8_t Bench_Ram[BENCH_BLOCKS][NVM_MAX_BLOCK_LENGTH];
+static uint8_t Bench_Rom[NVM_MAX_BLOCK_LENGTH];
+static uint8_t Bench_Copy[NVM_MAX_BLOCK_LENGTH];
+
+static Fee_BlockType Bench_FeeBlocks[BENCH_BLOCKS];
+static NvM_BlockDescriptorType Bench_Blocks[BENCH_BLOCKS];
+static uint32_t Bench_FeeWrites;    /* Jobs ended by the FEE module */
+static uint32_t Bench_MultiEnds;
+
+static void Bench_FeeEnd(void)
+{
+    Bench_FeeWrites++;
+}
+
+static const Fee_ConfigType Bench_FeeConfig = { Bench_FeeBlocks, BENCH_BLOCKS, Bench_FeeEnd, NULL };
+static void Bench_MultiEnd(void);
+static const NvM_ConfigType Bench_Config = { Bench_Blocks, BENCH_BLOCKS, Bench_MultiEnd };
+
+/* Notifications of Fls_Cfg.c, Fee_Cfg.c and NvM_Cfg.c */
+void FlsJob_EndNotification(uint8_t User)
+{
+}
+
+void FlsJob_ErrorNotification(uint8_t User)
+{
+}
+
+void FeeJob_EndNotification(void)
+{
+}
+
+void FeeJob_ErrorNotification(void)
+{
+}
+
+void NvMJob_MultiBlockNotification(void)
+{
+}
+
+static void Bench_MultiEnd(void)
+{
+    Bench_MultiEnds++;
+}
+
+static uint32_t Bench_Random = 0x2B992DDFu;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+/* One period of the main loop */
+static void Bench_Tick(void)
+{
+    Fls_MainFunction();
+    Fee_MainFunction();
+    NvM_MainFunction();
+    HostSim_Idle(NVM_MAIN_FUNCTION_PERIOD_MS * BENCH_MS);
+}
+
+static NvM_RequestResultType Bench_Result(NvM_BlockIdType BlockId)
+{
+    NvM_RequestResultType result = NVM_REQ_NOT_OK;
+    NvM_GetErrorStatus(BlockId, &result);
+    return result;
+}
+
+/* Runs the main loop until a request of a block ends; returns its result */
+static NvM_RequestResultType Bench_Wait(NvM_BlockIdType BlockId)
+{
+    while (Bench_Result(BlockId) == NVM_REQ_PENDING) {
+        Bench_Tick();
+    }
+    return Bench_Result(BlockId);
+}
+
+/* Runs the main loop until the FEE module is idle */
+static void Bench_Settle(void)
+{
+    while (Fee_GetStatus() != MEMIF_IDLE) {
+        Bench_Tick();
+    }
+}
+
+/* Simulated reset; Erase clears the flash first */
+static void Bench_Reboot(uint8_t Erase)
+{
+    if (Erase) {
+        memset(HostSim_FlashMemory, 0xFF, sizeof(HostSim_FlashMemory));
+    }
+    HostSim_Reset();
+    Fls_Init(NULL);
+    Fee_Init(&Bench_FeeConfig);
+    NvM_Init(&Bench_Config);
+    Bench_FeeWrites = 0;
+}
+
+static void Bench_Fill(uint32_t Block)
+{
+    for (uint32_t i = 0; i < Bench_Blocks[Block].length; i++) {
+        Bench_Ram[Block][i] = (uint8_t)Bench_Rand();
+    }
+}
+
+/* The frequent writer: Mode 0 writes each request through the FEE module, 1 and 2 use
+   NvM_WriteBlock without and with the write delay */
+static uint32_t Bench_Chatty(uint32_t Mode)
+{
+    static const char* const names[3] = { "each request:", "NvM merged:", "NvM delayed:" };
+    NvM_BlockDescriptorType* block = &Bench_Blocks[BENCH_CHATTY - 1u];
+    uint32_t errors = 0;
+
+    block->writeDelay = (Mode == 2) ? BENCH_DELAY : 0;
+    Bench_Reboot(1);
+    uint64_t cycles0 = HostSim_Cycles;
+    for (uint32_t tick = 0; tick < BENCH_TICKS; tick++) {
+        Bench_Ram[BENCH_CHATTY - 1u][0] = (uint8_t)tick;
+        Bench_Ram[BENCH_CHATTY - 1u][1] = (uint8_t)(tick >> 8);
+        if (Mode == 0) {
+            /* Each request waits for the previous one */
+            Fee_Write(Bench_FeeBlocks[BENCH_CHATTY - 1u].blockNumber, Bench_Ram[BENCH_CHATTY - 1u]);
+            while (Fee_GetStatus() == MEMIF_BUSY) {
+                Bench_Tick();
+            }
+        } else {
+            errors += (NvM_WriteBlock(BENCH_CHATTY, NULL) != E_OK);
+            Bench_Tick();
+        }
+    }
+    if (Mode != 0) {
+        errors += (Bench_Wait(BENCH_CHATTY) != NVM_REQ_OK);
+    }
+    Bench_Settle();
+    uint64_t cycles = HostSim_Cycles - cycles0;
+    uint32_t records = Bench_FeeWrites;
+    uint32_t units = HostSim_FlashStats.programs;
+
+    /* The last data reached the flash */
+    Bench_Reboot(0);
+    memset(Bench_Copy, 0, sizeof(Bench_Copy));
+    errors += (Mode != 0 && (NvM_ReadBlock(BENCH_CHATTY, Bench_Copy) != E_OK || Bench_Wait(BENCH_CHATTY) != NVM_REQ_OK ||
+                             memcmp(Bench_Copy, Bench_Ram[BENCH_CHATTY - 1u], block->length) != 0));
+    printf("%-15s %4u requests, %4u records, %6u units, %6.1f ms, %u errors\n", names[Mode], (unsigned)BENCH_TICKS, (unsigned)records, (unsigned)units, (double)cycles / BENCH_MS, (unsigned)errors);
+    block->writeDelay = 0;
+    return errors;
+}
+
+/* The DTC block of NvM_Cfg.c changed every main cycle: its writes are merged over its write delay */
+static uint32_t Bench_Dtc(void)
+{
+    NvM_BlockDescriptorType* block = &Bench_Blocks[BENCH_CHATTY - 1u];
+    uint16_t delay = NvM_BlockDescriptor[NVM_BLOCK_DTC - 1u].writeDelay;
+    uint32_t errors = 0;
+
+    block->writeDelay = delay;
+    Bench_Reboot(1);
+    for (uint32_t ms = 0; ms < BENCH_DTC_MS; ms += NVM_MAIN_FUNCTION_PERIOD_MS) {
+        if (ms % BENCH_DTC_PERIOD_MS == 0) {
+            Bench_Ram[BENCH_CHATTY - 1u][0]++;
+            errors += (NvM_WriteBlock(BENCH_CHATTY, NULL) != E_OK);
+        }
+        Bench_Tick();
+    }
+    errors += (Bench_Wait(BENCH_CHATTY) != NVM_REQ_OK);
+    Bench_Settle();
+    uint32_t records = Bench_FeeWrites;
+    /* One write per write delay at most, plus the last one */
+    errors += (delay == 0 || records > BENCH_DTC_MS / delay + 1u);
+
+    Bench_Reboot(0);
+    memset(Bench_Copy, 0, sizeof(Bench_Copy));
+    errors += (NvM_ReadBlock(BENCH_CHATTY, Bench_Copy) != E_OK || Bench_Wait(BENCH_CHATTY) != NVM_REQ_OK ||
+               memcmp(Bench_Copy, Bench_Ram[BENCH_CHATTY - 1u], block->length) != 0);
+    printf("DTC block:     %4u requests, %4u records, write delay %u ms, cycle %u ms, %u errors\n",
+           (unsigned)(BENCH_DTC_MS / BENCH_DTC_PERIOD_MS), (unsigned)records, (unsigned)delay,
+           (unsigned)NVM_MAIN_FUNCTION_PERIOD_MS, (unsigned)errors);
+    block->writeDelay = 0;
+    return errors;
+}
+
+/* NvM_WriteAll after a change of 2 blocks */
+static uint32_t Bench_WriteAll(uint8_t UseCrc)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        Bench_Blocks[i].useCrc = UseCrc;
+        Bench_FeeBlocks[i].blockSize = (uint16_t)((Bench_Blocks[i].length + 3u) / 4u * 4u + (UseCrc ? 4u : 0));
+        Bench_Fill(i);
+    }
+    Bench_Reboot(1);
+    Bench_MultiEnds = 0;
+    NvM_WriteAll();
+    errors += (Bench_Wait(0) != NVM_REQ_OK);
+    Bench_Settle();
+
+    Bench_Ram[3][0] ^= 1u;
+    Bench_Ram[7][5] ^= 1u;
+    Bench_FeeWrites = 0;
+    uint32_t units = HostSim_FlashStats.programs;
+    uint64_t cycles0 = HostSim_Cycles;
+    NvM_WriteAll();
+    errors += (Bench_Wait(0) != NVM_REQ_OK || Bench_MultiEnds != 2u);
+    uint64_t cycles = HostSim_Cycles - cycles0;
+    errors += (UseCrc && Bench_FeeWrites != 2u) + (!UseCrc && Bench_FeeWrites != BENCH_BLOCKS);
+    printf("NvM_WriteAll %s %2u of %u blocks written, %5u units, %5.1f ms, %u errors\n", UseCrc ? "CRC:   " : "no CRC:",
+           (unsigned)Bench_FeeWrites, (unsigned)BENCH_BLOCKS, (unsigned)(HostSim_FlashStats.programs - units),
+           (double)cycles / BENCH_MS, (unsigned)errors);
+    return errors;
+}
+
+/* An immediate write behind 8 standard writes */
+static uint32_t Bench_Priority(void)
+{
+    uint32_t errors = 0;
+    uint32_t order = 0, immediateAt = 0, lastAt = 0;
+
+    Bench_Reboot(1);
+    for (uint32_t i = 4; i < 12u; i++) {
+        Bench_Fill(i);
+        errors += (NvM_WriteBlock((NvM_BlockIdType)(i + 1u), NULL) != E_OK);
+    }
+    Bench_Fill(0);
+    errors += (NvM_WriteBlock(1u, NULL) != E_OK);
+    while (Bench_Result(5u) == NVM_REQ_PENDING || Bench_Result(12u) == NVM_REQ_PENDING || Bench_Result(1u) == NVM_REQ_PENDING) {
+        Bench_Tick();
+        order++;
+        if (immediateAt == 0 && Bench_Result(1u) != NVM_REQ_PENDING) {
+            immediateAt = order;
+        }
+    }
+    lastAt = order;
+    for (uint32_t i = 4; i < 12u; i++) {
+        errors += (Bench_Result((NvM_BlockIdType)(i + 1u)) != NVM_REQ_OK);
+    }
+    /* Served after the write already started at most */
+    errors += (Bench_Result(1u) != NVM_REQ_OK) + (immediateAt > lastAt / 4u);
+    printf("priority:      immediate write done after %u ms, 8 queued writes after %u ms, %u errors\n",
+           (unsigned)immediateAt, (unsigned)lastAt, (unsigned)errors);
+    return errors;
+}
+
+/* NvM_ReadAll after a reset, a wrong CRC, blocks never written */
+static uint32_t Bench_ReadAll(void)
+{
+    uint32_t errors = 0;
+    uint8_t expected[BENCH_BLOCKS][NVM_MAX_BLOCK_LENGTH];
+
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        Bench_Blocks[i].useCrc = 1;
+        Bench_FeeBlocks[i].blockSize = (uint16_t)((Bench_Blocks[i].length + 3u) / 4u * 4u + 4u);
+        Bench_Fill(i);
+    }
+    Bench_Reboot(1);
+    /* Blocks 11 and 12 are never written, block 11 has default data */
+    for (uint32_t i = 0; i < 10u; i++) {
+        errors += (NvM_WriteBlock((NvM_BlockIdType)(i + 1u), NULL) != E_OK);
+    }
+    errors += (Bench_Wait(10u) != NVM_REQ_OK);
+    /* Block 4 stored with a wrong CRC */
+    memcpy(Bench_Copy, Bench_Ram[3], Bench_Blocks[3].length);
+    memset(&Bench_Copy[Bench_Blocks[3].length], 0x55, 4);
+    errors += (Fee_Write(Bench_FeeBlocks[3].blockNumber, Bench_Copy) != E_OK);
+    Bench_Settle();
+    memcpy(expected, Bench_Ram, sizeof(expected));
+    memset(Bench_Ram, 0xA5, sizeof(Bench_Ram));
+
+    Bench_Reboot(0);
+    Bench_MultiEnds = 0;
+    NvM_ReadAll();
+    errors += (Bench_Wait(0) != NVM_REQ_NOT_OK || Bench_MultiEnds != 1u);
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        NvM_RequestResultType result = Bench_Result((NvM_BlockIdType)(i + 1u));
+        if (i == 3u) {
+            errors += (result != NVM_REQ_INTEGRITY_FAILED);
+        } else if (i == 10u) {
+            errors += (result != NVM_REQ_RESTORED_FROM_ROM || memcmp(Bench_Ram[i], Bench_Rom, Bench_Blocks[i].length) != 0);
+        } else if (i == 11u) {
+            errors += (result != NVM_REQ_NV_INVALIDATED);
+        } else {
+            errors += (result != NVM_REQ_OK || memcmp(Bench_Ram[i], expected[i], Bench_Blocks[i].length) != 0);
+        }
+    }
+
+    /* A write of the data read is skipped, a changed one is not */
+    Bench_FeeWrites = 0;
+    errors += (NvM_WriteBlock(1u, NULL) != E_OK || Bench_Wait(1u) != NVM_REQ_OK || Bench_FeeWrites != 0);
+    Bench_Ram[0][0] ^= 0xFFu;
+    errors += (NvM_WriteBlock(1u, NULL) != E_OK || Bench_Wait(1u) != NVM_REQ_OK || Bench_FeeWrites != 1u);
+
+    /* Arguments and one request per block */
+    NvM_RequestResultType result;
+    errors += (NvM_ReadBlock(0, Bench_Copy) != E_NOT_OK) + (NvM_WriteBlock(BENCH_BLOCKS + 1u, Bench_Copy) != E_NOT_OK);
+    errors += (NvM_GetErrorStatus(BENCH_BLOCKS + 1u, &result) != E_NOT_OK);
+    Bench_Blocks[5].writeDelay = 10u;
+    errors += (NvM_WriteBlock(6u, Bench_Copy) != E_OK) + (NvM_WriteBlock(6u, NULL) != E_OK);
+    errors += (NvM_ReadBlock(6u, Bench_Copy) != E_NOT_OK);
+    Bench_Ram[5][0] ^= 0xFFu;
+    Bench_FeeWrites = 0;
+    errors += (Bench_Wait(6u) != NVM_REQ_OK || Bench_FeeWrites != 1u);
+    Bench_Blocks[5].writeDelay = 0;
+    errors += (NvM_ReadBlock(6u, Bench_Copy) != E_OK || Bench_Wait(6u) != NVM_REQ_OK);
+    errors += (memcmp(Bench_Copy, Bench_Ram[5], Bench_Blocks[5].length) != 0);
+    printf("NvM_ReadAll:   %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+        Bench_FeeBlocks[i].blockNumber = (uint16_t)(0x40u + i);
+        Bench_Blocks[i].feeBlockNumber = Bench_FeeBlocks[i].blockNumber;
+        Bench_Blocks[i].length = (uint16_t)(16u + i * 16u + (i & 1u) * 3u);
+        Bench_Blocks[i].priority = (i == 0) ? NVM_PRIORITY_IMMEDIATE : 10u;
+        Bench_Blocks[i].useCrc = 1;
+        Bench_Blocks[i].selectAll = 1;
+        Bench_Blocks[i].ramBlock = Bench_Ram[i];
+        Bench_Blocks[i].romBlock = (i == 10u) ? Bench_Rom : NULL;
+        Bench_FeeBlocks[i].blockSize = (uint16_t)((Bench_Blocks[i].length + 3u) / 4u * 4u + 4u);
+    }
+    for (uint32_t i = 0; i < sizeof(Bench_Rom); i++) {
+        Bench_Rom[i] = (uint8_t)i;
+    }
+
+    errors += Bench_Chatty(0);
+    errors += Bench_Chatty(1);
+    errors += Bench_Chatty(2);
+    errors += Bench_Dtc();
+    errors += Bench_WriteAll(0);
+    errors += Bench_WriteAll(1);
+    errors += Bench_Priority();
+    errors += Bench_ReadAll();
+    return errors ? 1 : 0;
+}
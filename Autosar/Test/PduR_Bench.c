@@ -0,0 +1,239 @@
+/*
+* File: PduR_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the PDU router at full bus load: the J1939 bus (CAN2, 500 kbit/s)
+* carries back to back 8-byte frames, four engine frames mirrored on CAN1 (1 Mbit/s), a diagnostic
+* message recorded by the logger on SPI2 and a frame no path routes. The CAN main functions run
+* every GPT_COM_CYCLE_MS (1 ms), the rate of the ECU, and every 5 ms.
+*   - COM copy: the way frames crossed the ECU so far. The receive notification takes the frame
+*     the driver found and copies it into the buffer of its I-PDU; the transmit main function, which runs before
+*     Can_MainFunction_Read, copies the buffer out to Can_Write. A frame received again before it
+*     is sent overwrites the previous one.
+*   - PduR: PduR_CanRxIndication hands the driver's receive buffer to Can_Write, and writes the
+*     diagnostic frames into the buffer the DMA sends to the logger.
+*   Latency runs from the end of a frame on CAN2 to the end of its copy on CAN1.
+*
+*   pdur_bench
+*/
+
+#include "PduR.h"
+#include "Spi.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CAN1              0u          /* Index of CAN1 in the model */
+#define BENCH_CAN2              1u          /* Index of CAN2 in the model */
+#define BENCH_SPI2              1u          /* Index of SPI2 in the model */
+#define BENCH_MS                (HOSTSIM_CORE_CLOCK_HZ / 1000u)
+#define BENCH_US                (HOSTSIM_CORE_CLOCK_HZ / 1000000u)
+#define BENCH_ECU_PERIOD        (GPT_COM_CYCLE_MS * BENCH_MS)  /* CAN main functions on the ECU */
+#define BENCH_FRAMES            6000u       /* Frames sent back to back on CAN2 */
+#define BENCH_EXT_FRAME_BITS    131u        /* Extended frame with 8 data bytes, without stuff bits */
+#define BENCH_TRAFFIC           6u
+#define BENCH_DRAIN             20u         /* Main loop periods run after the last frame */
+
+/* Frames of the traffic in turn, and their destination */
+#define BENCH_TO_CAN1           0u
+#define BENCH_TO_LOGGER         1u
+#define BENCH_UNROUTED          2u
+
+static const struct {
+    uint8_t canPdu;
+    uint8_t destination;
+} Bench_Traffic[BENCH_TRAFFIC] = {
+    { CAN_RX_PDU_EEC1_00, BENCH_TO_CAN1 },
+    { CAN_RX_PDU_EEC2_00, BENCH_TO_CAN1 },
+    { CAN_RX_PDU_DM1_00,  BENCH_TO_LOGGER },
+    { CAN_RX_PDU_EEC1_01, BENCH_TO_CAN1 },
+    { CAN_RX_PDU_EEC2_01, BENCH_TO_CAN1 },
+    { CAN_RX_PDU_ET1_00,  BENCH_UNROUTED },
+};
+
+#define BENCH_RX_PDU_ID(name, hrh, id)  (id),
+
+static const Can_IdType Bench_RxPduIds[CAN_NUM_RX_PDUS] = {
+    CAN_RX_PDUS(BENCH_RX_PDU_ID)
+};
+
+static HostSim_CanFrameType Bench_NodeFrames[BENCH_FRAMES];
+static HostSim_CanFrameType Bench_Capture[BENCH_FRAMES];
+static uint64_t Bench_FirstEnd;             /* End of the first frame on CAN2 */
+static uint32_t Bench_FrameCycles;          /* One frame on CAN2 */
+
+/* I-PDU buffers of the COM copy, per frame of CAN_RX_PDUS */
+static uint8_t Bench_IpduData[CAN_NUM_RX_PDUS][8];
+static uint8_t Bench_IpduPending[CAN_NUM_RX_PDUS];
+static uint8_t Bench_TxData[8];
+
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t Bench_Get32(const uint8_t* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void Bench_Put32(uint8_t* data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+/* Receive notification of the COM copy: a copy into the buffer of the I-PDU */
+static void Bench_CopyIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr)
+{
+    uint8_t canPdu = RxPdu;
+
+    (void)Hrh;
+    (void)CanId;
+    if (canPdu >= CAN_NUM_RX_PDUS || CanDlc != 8u) {
+        return;
+    }
+    if (!(PduR_RoutingTable[canPdu].destinations & PDUR_TO_GATEWAY) || PduR_RoutingTable[canPdu].gateway != PDUR_GW_CAN1) {
+        return;
+    }
+    memcpy(Bench_IpduData[canPdu], CanSduPtr, 8);
+    Bench_IpduPending[canPdu] = 1;
+}
+
+static const Can_ConfigType Bench_CopyConfig = { Bench_CopyIndication, NULL, NULL };
+
+/* Transmit main function of the COM copy: each pending I-PDU copied out to Can_Write */
+static void Bench_CopyMainFunctionTx(void)
+{
+    for (uint32_t i = 0; i < CAN_NUM_RX_PDUS; i++) {
+        if (Bench_IpduPending[i]) {
+            Can_PduType pdu;
+            memcpy(Bench_TxData, Bench_IpduData[i], 8);
+            pdu.swPduHandle = (PduIdType)i;
+            pdu.length = 8;
+            pdu.id = Bench_RxPduIds[i];
+            pdu.sdu = Bench_TxData;
+            if (Can_Write(CAN_HTH_CAN1, &pdu) == CAN_OK) {
+                Bench_IpduPending[i] = 0;
+            }
+        }
+    }
+}
+
+/* Traffic of CAN2: frame i is due when frame i - 1 ends, from Start on */
+static void Bench_NodeTraffic(uint64_t Start)
+{
+    const Can_ControllerConfigType* cfg = &Can_ControllerConfig[CAN_CONTROLLER_2];
+
+    /* A quantum lasts prescaler APB1 clocks of 4 core cycles; bs1 and bs2 hold the quanta less one */
+    Bench_FrameCycles = BENCH_EXT_FRAME_BITS * cfg->prescaler * (3u + cfg->bs1 + cfg->bs2) * 4u;
+    for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+        Bench_NodeFrames[i].at = Start + (uint64_t)i * Bench_FrameCycles;
+        Bench_NodeFrames[i].id = HOSTSIM_CAN_EXTENDED | (Bench_RxPduIds[Bench_Traffic[i % BENCH_TRAFFIC].canPdu] & CAN_ID_EXTENDED_MASK);
+        Bench_NodeFrames[i].dlc = 8;
+        Bench_Put32(&Bench_NodeFrames[i].data[0], i);
+        Bench_Put32(&Bench_NodeFrames[i].data[4], ~i);
+    }
+    Bench_FirstEnd = Start + Bench_FrameCycles;
+    HostSim_CanNode[BENCH_CAN2].frames = Bench_NodeFrames;
+    HostSim_CanNode[BENCH_CAN2].count = BENCH_FRAMES;
+}
+
+/* One run; returns 0 if no frame the path has to forward is lost or altered */
+static uint32_t Bench_Run(uint8_t Router, uint32_t Period, const char* name)
+{
+    uint32_t expected[BENCH_UNROUTED + 1u] = { 0 };
+    uint64_t latency = 0;
+    uint64_t maxLatency = 0;
+    uint64_t hostNs = 0;
+    uint32_t errors = 0;
+    uint32_t drain = 0;
+    PduR_StatsType stats;
+
+    HostSim_Reset();
+    memset(Bench_IpduPending, 0, sizeof(Bench_IpduPending));
+    HostSim_CanCapture[BENCH_CAN1].buffer = Bench_Capture;
+    HostSim_CanCapture[BENCH_CAN1].size = BENCH_FRAMES;
+    Spi_Init(NULL);
+    Spi_SetAsyncMode(SPI_HWUnit_1, SPI_DMA_MODE);
+    Can_Init(Router ? NULL : &Bench_CopyConfig);
+    PduR_Init();
+    (void)Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START);
+    (void)Can_SetControllerMode(CAN_CONTROLLER_2, CAN_T_START);
+    Bench_NodeTraffic(HostSim_Cycles + BENCH_MS);
+
+    while (drain < BENCH_DRAIN) {
+        uint64_t t0;
+        HostSim_Idle(Period);
+        t0 = Bench_HostNow();
+        if (!Router) {
+            Bench_CopyMainFunctionTx();
+        }
+        Can_MainFunction_Write();
+        Can_MainFunction_Read();
+        hostNs += Bench_HostNow() - t0;
+        Can_MainFunction_BusOff();
+        if (HostSim_CanNode[BENCH_CAN2].sent == BENCH_FRAMES) {
+            drain++;
+        }
+    }
+    while (Spi_GetHWUnitStatus(SPI_HWUnit_1) == SPI_BUSY) {
+        HostSim_Idle(BENCH_MS);
+    }
+
+    for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+        expected[Bench_Traffic[i % BENCH_TRAFFIC].destination]++;
+    }
+    for (uint32_t i = 0; i < HostSim_CanCapture[BENCH_CAN1].length; i++) {
+        const HostSim_CanFrameType* frame = &Bench_Capture[i];
+        uint32_t seq = Bench_Get32(&frame->data[0]);
+        uint64_t end;
+        if (seq >= BENCH_FRAMES || frame->dlc != 8u || Bench_Get32(&frame->data[4]) != ~seq ||
+            frame->id != Bench_NodeFrames[seq].id) {
+            errors++;
+            continue;
+        }
+        end = Bench_FirstEnd + (uint64_t)seq * Bench_FrameCycles;
+        latency += frame->at - end;
+        if (frame->at - end > maxLatency) {
+            maxLatency = frame->at - end;
+        }
+    }
+    (void)PduR_GetStats(&stats);
+
+    printf("%-14s %4u of %u frames forwarded, %4u lost, latency mean %6.1f us max %6.1f us, %5.0f ns/frame (host)",
+           name, (unsigned)HostSim_CanCapture[BENCH_CAN1].length, (unsigned)expected[BENCH_TO_CAN1],
+           (unsigned)(expected[BENCH_TO_CAN1] - HostSim_CanCapture[BENCH_CAN1].length),
+           HostSim_CanCapture[BENCH_CAN1].length ? (double)latency / HostSim_CanCapture[BENCH_CAN1].length / BENCH_US : 0.0,
+           (double)maxLatency / BENCH_US, (double)hostNs / BENCH_FRAMES);
+    if (!Router) {
+        printf("\n");
+        return errors;
+    }
+    printf(", %u logged in %u transfers, %u dropped\n",
+           (unsigned)(HostSim_SpiStats[BENCH_SPI2].frames / PDUR_SPI_RECORD_BYTES), (unsigned)stats.spiTransfers,
+           (unsigned)stats.dropped);
+    if (HostSim_CanCapture[BENCH_CAN1].length != expected[BENCH_TO_CAN1] || stats.gatewayLost != 0 ||
+        HostSim_SpiStats[BENCH_SPI2].frames != (uint64_t)expected[BENCH_TO_LOGGER] * PDUR_SPI_RECORD_BYTES ||
+        stats.dropped != expected[BENCH_UNROUTED] || HostSim_CanStats[BENCH_CAN2].rxLost != 0) {
+        errors++;
+    }
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    printf("gateway at full bus load, %u J1939 frames at 500 kbit/s, 4 in 6 to CAN1 at 1 Mbit/s, 1 in 6 to SPI2:\n",
+           (unsigned)BENCH_FRAMES);
+    failed += Bench_Run(0, BENCH_ECU_PERIOD, "COM copy 1 ms:");
+    failed += Bench_Run(1, BENCH_ECU_PERIOD, "PduR 1 ms:");
+    failed += Bench_Run(0, 5u * BENCH_MS, "COM copy 5 ms:");
+    failed += Bench_Run(1, 5u * BENCH_MS, "PduR 5 ms:");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,255 @@
+/*
+* File: Pwm_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the PWM driver against the timer and DMA model of HostSim.c. The
+* compare values in force on TIM1 and TIM3 are recorded at every update event.
+*   - Update: a control loop running at random instants sets the three phases of the motor bridge
+*     to one value, by TIM_SetCompareX, Pwm_SetDutyCycle and Pwm_SetDutyCycles. The register
+*     accesses per update are counted, and every period must show three equal phases.
+*   - Waveform: a three-phase sine played for one second by an update interrupt writing the
+*     compare registers, then by Pwm_StartWaveform alongside a breathing table on the dimmer.
+*     Every period must show the next row of its table.
+*   - Stop: the units return to their duty cycles and idle levels.
+*
+*   pwm_bench
+*/
+
+#include "Pwm.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_UPDATES           20000u      /* Control loop runs of the update test */
+#define BENCH_SINE_ROWS         400u        /* 50 Hz at 20 kHz */
+#define BENCH_BREATH_ROWS       1000u       /* 1 s at 1 kHz */
+#define BENCH_PERIOD_CYCLES     (PWM_MOTOR_PERIOD * (PWM_MOTOR_PRESCALER + 1u))
+#define BENCH_MAX_RECORDS       (BENCH_UPDATES * 4u)
+#define BENCH_PI                3.14159265358979323846
+
+static HostSim_TimUpdateType Bench_Motor[BENCH_MAX_RECORDS];
+static HostSim_TimUpdateType Bench_Dimmer[BENCH_MAX_RECORDS];
+static Pwm_CompareType Bench_Sine[BENCH_SINE_ROWS * PWM_MOTOR_BURST];
+static Pwm_CompareType Bench_Breath[BENCH_BREATH_ROWS];
+static uint32_t Bench_Row;                  /* Next row written by the update interrupt */
+
+static const Pwm_ChannelType Bench_Phases[PWM_MOTOR_BURST] = {
+    PWM_CHANNEL_PHASE_U, PWM_CHANNEL_PHASE_V, PWM_CHANNEL_PHASE_W
+};
+
+static uint32_t Bench_Random = 0x13579BDFu;
+
+static uint32_t Bench_Rand(void)
+{
+    Bench_Random ^= Bench_Random << 13;
+    Bench_Random ^= Bench_Random >> 17;
+    Bench_Random ^= Bench_Random << 5;
+    return Bench_Random;
+}
+
+/* Core cycles used by the CPU since a snapshot: register accesses and interrupt entries */
+static uint64_t Bench_CpuCycles(uint64_t regs0, uint64_t irqs0)
+{
+    return (HostSim_RegAccesses - regs0) * HostSim_BusCycles + (HostSim_IrqCount - irqs0) * HostSim_IrqCycles;
+}
+
+static HostSim_TimCaptureType* Bench_Capture(TIM_TypeDef* TIMx)
+{
+    return &HostSim_TimCapture[TIMx - HostSim_TimRegs];
+}
+
+static void Bench_Start(void)
+{
+    HostSim_Reset();
+    Pwm_Init(NULL);
+    Bench_Capture(TIM1)->buffer = Bench_Motor;
+    Bench_Capture(TIM1)->size = BENCH_MAX_RECORDS;
+    Bench_Capture(TIM3)->buffer = Bench_Dimmer;
+    Bench_Capture(TIM3)->size = BENCH_MAX_RECORDS;
+}
+
+/* Update interrupt of the interrupt-driven sine: the next row goes into the compare registers */
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+    const Pwm_CompareType* row = &Bench_Sine[Bench_Row * PWM_MOTOR_BURST];
+
+    TIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+    TIM_SetCompare1(TIM1, row[0]);
+    TIM_SetCompare2(TIM1, row[1]);
+    TIM_SetCompare3(TIM1, row[2]);
+    Bench_Row = (Bench_Row + 1u) % BENCH_SINE_ROWS;
+}
+
+/* Periods recorded on the motor timer whose three phases differ */
+static uint32_t Bench_Torn(uint32_t From)
+{
+    const HostSim_TimCaptureType* capture = Bench_Capture(TIM1);
+    uint32_t torn = 0;
+
+    for (uint32_t i = From; i < capture->length; i++) {
+        const uint32_t* compare = capture->buffer[i].compare;
+        torn += (compare[0] != compare[1] || compare[1] != compare[2]);
+    }
+    return torn;
+}
+
+/* The three phases set to one value at random instants, by one of three methods */
+static uint32_t Bench_Update(uint32_t Method)
+{
+    static const char* const names[] = { "TIM_SetCompareX", "Pwm_SetDutyCycle", "Pwm_SetDutyCycles" };
+    uint32_t errors = 0;
+    uint64_t regs = 0;
+    uint16_t duty = 0;
+
+    Bench_Start();
+    if (Method == 0) {
+        /* Without the driver's burst, which would overwrite the registers */
+        TIM_DMACmd(TIM1, TIM_DMA_Update, DISABLE);
+    }
+    for (uint32_t i = 0; i < BENCH_UPDATES; i++) {
+        HostSim_Idle(Bench_Rand() % (2u * BENCH_PERIOD_CYCLES));
+        duty = (uint16_t)(1u + Bench_Rand() % PWM_DUTY_100);
+        uint64_t regs0 = HostSim_RegAccesses;
+        if (Method == 0) {
+            Pwm_CompareType compare = Pwm_DutyToCompare(PWM_HWUnit_0, duty);
+            TIM_SetCompare1(TIM1, compare);
+            TIM_SetCompare2(TIM1, compare);
+            TIM_SetCompare3(TIM1, compare);
+        } else if (Method == 1) {
+            for (uint32_t p = 0; p < PWM_MOTOR_BURST; p++) {
+                Pwm_SetDutyCycle(Bench_Phases[p], duty);
+            }
+        } else {
+            const uint16_t duties[PWM_MOTOR_BURST] = { duty, duty, duty };
+            errors += (Pwm_SetDutyCycles(Bench_Phases, duties, PWM_MOTOR_BURST) != E_OK);
+        }
+        regs += HostSim_RegAccesses - regs0;
+    }
+    /* The last value is in force after two update events at most */
+    HostSim_Idle(2u * BENCH_PERIOD_CYCLES + 1u);
+    const HostSim_TimCaptureType* capture = Bench_Capture(TIM1);
+    uint32_t torn = Bench_Torn(0);
+    errors += (capture->length == 0 || capture->buffer[capture->length - 1u].compare[0] != Pwm_DutyToCompare(PWM_HWUnit_0, duty));
+    /* Only the driver calls that hold the update events guarantee whole periods */
+    errors += (Method == 2 && torn != 0);
+    printf("%-18s %4.2f reg per update, %3u of %u periods with mixed phases%s\n", names[Method],
+           (double)regs / BENCH_UPDATES, (unsigned)torn, (unsigned)capture->length, errors ? "  FAILED" : "");
+    return errors;
+}
+
+/* Records from From on must follow the rows of a table from its first row, after at most Lead
+   records of the values in force before */
+static uint32_t Bench_Follows(const HostSim_TimCaptureType* Capture, uint32_t From, const Pwm_CompareType* Table,
+                              uint32_t Rows, uint32_t Columns, uint32_t Lead)
+{
+    uint32_t i = From;
+    uint32_t errors = 0;
+
+    while (i < Capture->length && i < From + Lead && memcmp(Capture->buffer[i].compare, Table, Columns * sizeof(uint32_t)) != 0) {
+        i++;
+    }
+    errors += (i == From + Lead || i == Capture->length);
+    for (uint32_t row = 0; i < Capture->length; i++, row = (row + 1u) % Rows) {
+        errors += (memcmp(Capture->buffer[i].compare, &Table[row * Columns], Columns * sizeof(uint32_t)) != 0);
+    }
+    return errors;
+}
+
+/* One second of a three-phase sine by interrupt, then by DMA with the dimmer breathing */
+static uint32_t Bench_Waveform(void)
+{
+    uint32_t errors = 0;
+
+    Bench_Start();
+    for (uint32_t row = 0; row < BENCH_SINE_ROWS; row++) {
+        for (uint32_t p = 0; p < PWM_MOTOR_BURST; p++) {
+            double angle = 2.0 * BENCH_PI * ((double)row / BENCH_SINE_ROWS - (double)p / PWM_MOTOR_BURST);
+            uint16_t duty = (uint16_t)(PWM_DUTY_100 / 2u + (int32_t)(0.45 * PWM_DUTY_100 * sin(angle)));
+            Bench_Sine[row * PWM_MOTOR_BURST + p] = Pwm_DutyToCompare(PWM_HWUnit_0, duty);
+        }
+    }
+    for (uint32_t row = 0; row < BENCH_BREATH_ROWS; row++) {
+        uint32_t level = (row < BENCH_BREATH_ROWS / 2u) ? row : BENCH_BREATH_ROWS - row;
+        Bench_Breath[row] = Pwm_DutyToCompare(PWM_HWUnit_1, (uint16_t)(level * level * (PWM_DUTY_100 / 500u) / 500u));
+    }
+
+    /* The update interrupt takes over from the DMA */
+    NVIC_InitTypeDef NVIC_InitStruct = { TIM1_UP_TIM10_IRQn, 0, 0, ENABLE };
+    TIM_DMACmd(TIM1, TIM_DMA_Update, DISABLE);
+    Bench_Row = 0;
+    TIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+    TIM_ITConfig(TIM1, TIM_IT_Update, ENABLE);
+    NVIC_Init(&NVIC_InitStruct);
+    uint32_t from = Bench_Capture(TIM1)->length;
+    uint64_t cycles0 = HostSim_Cycles, regs0 = HostSim_RegAccesses, irqs0 = HostSim_IrqCount;
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ);
+    double cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    uint32_t irqErrors = Bench_Follows(Bench_Capture(TIM1), from, Bench_Sine, BENCH_SINE_ROWS, PWM_MOTOR_BURST, 2);
+    printf("sine by interrupt: CPU %5.3f%%, %u irq, %u periods%s\n", cpu, (unsigned)(HostSim_IrqCount - irqs0),
+           (unsigned)(Bench_Capture(TIM1)->length - from), irqErrors ? "  FAILED" : "");
+    errors += irqErrors;
+
+    Bench_Start();
+    uint32_t fromMotor = Bench_Capture(TIM1)->length, fromDimmer = Bench_Capture(TIM3)->length;
+    errors += (Pwm_StartWaveform(PWM_HWUnit_0, Bench_Sine, BENCH_SINE_ROWS) != E_OK);
+    errors += (Pwm_StartWaveform(PWM_HWUnit_1, Bench_Breath, BENCH_BREATH_ROWS) != E_OK);
+    cycles0 = HostSim_Cycles;
+    regs0 = HostSim_RegAccesses;
+    irqs0 = HostSim_IrqCount;
+    HostSim_Idle(HOSTSIM_CORE_CLOCK_HZ);
+    cpu = 100.0 * (double)Bench_CpuCycles(regs0, irqs0) / (double)(HostSim_Cycles - cycles0);
+    uint32_t dmaErrors = Bench_Follows(Bench_Capture(TIM1), fromMotor, Bench_Sine, BENCH_SINE_ROWS, PWM_MOTOR_BURST, 3);
+    dmaErrors += Bench_Follows(Bench_Capture(TIM3), fromDimmer, Bench_Breath, BENCH_BREATH_ROWS, PWM_DIMMER_BURST, 3);
+    dmaErrors += (cpu != 0.0);
+    printf("sine by DMA burst: CPU %5.3f%%, %u irq, %u periods, dimmer %u periods, %u DMA writes%s\n", cpu,
+           (unsigned)(HostSim_IrqCount - irqs0), (unsigned)(Bench_Capture(TIM1)->length - fromMotor),
+           (unsigned)(Bench_Capture(TIM3)->length - fromDimmer),
+           (unsigned)(HostSim_TimStats[0].dmaWrites + HostSim_TimStats[2].dmaWrites), dmaErrors ? "  FAILED" : "");
+    return errors + dmaErrors;
+}
+
+/* Duty cycles set during a waveform are in force once it stops, then the idle levels */
+static uint32_t Bench_Stop(void)
+{
+    static const uint16_t duties[PWM_MOTOR_BURST] = { PWM_DUTY_100 / 4u, PWM_DUTY_100 / 2u, PWM_DUTY_100 };
+    uint32_t errors = 0;
+
+    Bench_Start();
+    errors += (Pwm_StopWaveform(PWM_HWUnit_0) != E_NOT_OK);
+    errors += (Pwm_StartWaveform(PWM_HWUnit_0, Bench_Sine, 0) != E_NOT_OK);
+    errors += (Pwm_StartWaveform(PWM_HWUnit_0, Bench_Sine, BENCH_SINE_ROWS) != E_OK);
+    errors += (Pwm_SetDutyCycles(Bench_Phases, duties, PWM_MOTOR_BURST) != E_OK);
+    Pwm_SetDutyCycle(PWM_CHANNEL_DIMMER, PWM_DUTY_100 / 8u);
+    HostSim_Idle(10u * BENCH_PERIOD_CYCLES);
+    const HostSim_TimUpdateType* last = &Bench_Motor[Bench_Capture(TIM1)->length - 1u];
+    errors += (last->compare[0] == PWM_MOTOR_PERIOD / 4u && last->compare[1] == PWM_MOTOR_PERIOD / 2u);
+
+    errors += (Pwm_StopWaveform(PWM_HWUnit_0) != E_OK);
+    HostSim_Idle(2u * BENCH_PERIOD_CYCLES + 1u);
+    last = &Bench_Motor[Bench_Capture(TIM1)->length - 1u];
+    errors += (last->compare[0] != PWM_MOTOR_PERIOD / 4u || last->compare[1] != PWM_MOTOR_PERIOD / 2u ||
+               last->compare[2] != PWM_MOTOR_PERIOD);
+
+    Pwm_SetOutputToIdle(PWM_CHANNEL_PHASE_W);
+    HostSim_Idle(2u * (PWM_DIMMER_PERIOD * (PWM_DIMMER_PRESCALER + 1u) * 2u) + 1u);
+    last = &Bench_Motor[Bench_Capture(TIM1)->length - 1u];
+    errors += (last->compare[2] != 0);
+    errors += (Bench_Dimmer[Bench_Capture(TIM3)->length - 1u].compare[0] != PWM_DIMMER_PERIOD / 8u);
+
+    Pwm_DeInit();
+    errors += (TIM1->CR1 & TIM_CR1_CEN) || (TIM3->CR1 & TIM_CR1_CEN) || (TIM1->BDTR & TIM_BDTR_MOE);
+    printf("stop and idle:     %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t method = 0; method < 3; method++) {
+        errors += Bench_Update(method);
+    }
+    errors += Bench_Waveform();
+    errors += Bench_Stop();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,395 @@
+/*
+* File: Spi_Bench.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Host benchmark of the SPI job/sequence scheduler. Runs the sequences of Spi_Cfg.c
+* once serialized through Spi_SyncTransmit and in parallel through Spi_AsyncTransmit, with the
+* units polled, interrupt-driven and driven by DMA, and reports modelled bus time per round, CPU
+* register accesses, sequence latency, per-unit counters and host CPU time of the scheduler.
+* A stress run injects spurious SPI interrupts into the interrupt-driven engine and checks every
+* byte that comes back. A streaming run moves blocks through the EB channel with one buffer and
+* with ping-pong buffers, with the application processing each block while the next one streams.
+* A transfer error stopping the TX stream of SPI2 mid-transfer must fail the gateway job instead
+* of leaving it pending. A sequence cancelled while its polled job is on the bus must still see the
+* job end and its device released, the driver refusing Spi_DeInit until then.
+* Usage: spi_bench [txe rxne bsy] runs every scenario with these SPI flag latencies, in core cycles.
+*/
+
+#include "Spi.h"
+#include "Dio.h"
+#include "SchM.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_ROUNDS    10000u
+
+static const Spi_ConfigType Bench_SpiConfig = {
+    SPI_Direction_2Lines_FullDuplex, SPI_Mode_Master, SPI_DataSize_8b,
+    SPI_CPOL_Low, SPI_CPHA_1Edge, SPI_NSS_Soft,
+    SPI_BaudRatePrescaler_4, SPI_FirstBit_MSB, 7
+};
+
+static const char* const Bench_SeqName[SPI_MAX_SEQUENCE] = { "IMU", "BARO", "EEPROM", "EXT_ADC", "GATEWAY" };
+
+/* Channels with a transmit buffer, checked by the stress run */
+static const Spi_ChannelType Bench_TxChannel[] = {
+    SPI_CHANNEL_ACCEL_CMD, SPI_CHANNEL_GYRO_CMD, SPI_CHANNEL_BARO_CMD, SPI_CHANNEL_EEPROM_STATUS
+};
+#define BENCH_NUM_TX_CHANNELS   (sizeof(Bench_TxChannel) / sizeof(Bench_TxChannel[0]))
+#define BENCH_MAX_LENGTH        8u
+
+/* EB channel (16-bit frames): block read by every round, and blocks of the streaming run */
+#define BENCH_EB_LENGTH         8u
+
+/* Gateway channel (8-bit frames): one record of the PduR gateway per round */
+#define BENCH_GATEWAY_LENGTH    13u
+#define BENCH_STREAM_BLOCKS     2000u
+#define BENCH_PROCESS_CYCLES    4000u       /* Application work per received block */
+
+static uint16_t Bench_EbTx[BENCH_EB_LENGTH];
+static uint16_t Bench_EbRx[BENCH_EB_LENGTH];
+static uint8_t Bench_GatewayTx[BENCH_GATEWAY_LENGTH];
+static uint16_t Bench_StreamTx[2][SPI_EXT_ADC_MAX_LENGTH];
+static uint16_t Bench_StreamRx[2][SPI_EXT_ADC_MAX_LENGTH];
+
+static double Bench_HostSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void Bench_Report(const char* name, uint64_t cycles, double hostSeconds)
+{
+    double cyclesPerRound = (double)cycles / BENCH_ROUNDS;
+    printf("%-14s %10.1f cycles/round  %9.0f rounds/s (modelled)  %7.1f reg/round  %5.1f irq/round  %8.1f ns/round (host)\n",
+           name, cyclesPerRound, HOSTSIM_CORE_CLOCK_HZ / cyclesPerRound,
+           (double)HostSim_RegAccesses / BENCH_ROUNDS, (double)HostSim_IrqCount / BENCH_ROUNDS,
+           hostSeconds * 1e9 / BENCH_ROUNDS);
+}
+
+/* Bus settings of the scenarios, NULL runs each unit with its own settings of Spi_HWUnitConfig */
+static const Spi_ConfigType* Bench_Config = &Bench_SpiConfig;
+
+/* Starts a scenario with every unit in the given mode and the counters cleared */
+static void Bench_Start(Spi_AsyncModeType mode)
+{
+    HostSim_Reset();
+    Spi_Init(Bench_Config);
+    for (Spi_HWUnitType hw = SPI_HWUnit_0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        Spi_SetAsyncMode(hw, mode);
+    }
+    Spi_SetupEB(SPI_CHANNEL_EXT_ADC, (const Spi_DataBufferType*)Bench_EbTx, (Spi_DataBufferType*)Bench_EbRx, BENCH_EB_LENGTH);
+    Spi_SetupEB(SPI_CHANNEL_GATEWAY, Bench_GatewayTx, NULL, BENCH_GATEWAY_LENGTH);
+    HostSim_Cycles = 0;
+    HostSim_RegAccesses = 0;
+    HostSim_IrqCount = 0;
+}
+
+/* Counters of every hardware unit */
+static void Bench_ReportUnits(void)
+{
+    for (Spi_HWUnitType hw = SPI_HWUnit_0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        Spi_HWUnitStatsType stats;
+        if (Spi_GetHWUnitStats(hw, &stats) != E_OK || stats.jobs == 0) {
+            continue;
+        }
+        printf("  SPI%u     %7lu jobs  %8lu frames  %7lu irq  latency mean %7.1f max %5lu cycles  busy %5.1f%%\n",
+               hw + 1u, (unsigned long)stats.jobs, (unsigned long)stats.frames, (unsigned long)stats.interrupts,
+               (double)stats.latencySum / stats.jobs, (unsigned long)stats.latencyMax,
+               100.0 * (double)stats.busyCycles / (double)HostSim_Cycles);
+    }
+}
+
+/* Sleeps until the next interrupt while a sequence is pending, like Spi_SyncTransmit */
+static void Bench_Wait(Spi_AsyncModeType mode)
+{
+    SchM_StateType state;
+
+    Spi_MainFunction_Handling();
+    if (mode == SPI_POLLING_MODE) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Spi_GetStatus() == SPI_BUSY) {
+        SchM_WaitForInterrupt();
+    }
+    SchM_Exit(state);
+}
+
+/* All sequences one after the other, each waiting for the previous one */
+static void Bench_Serialized(const char* name, Spi_AsyncModeType mode)
+{
+    Bench_Start(mode);
+
+    double start = Bench_HostSeconds();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+            if (Spi_SyncTransmit(seq) != E_OK) {
+                printf("%s: sequence %u failed\n", name, seq);
+                return;
+            }
+        }
+    }
+    Bench_Report(name, HostSim_Cycles, Bench_HostSeconds() - start);
+    Spi_DeInit();
+}
+
+/* All sequences queued at once, the scheduler runs them on their units in parallel */
+static void Bench_Parallel(const char* name, Spi_AsyncModeType mode)
+{
+    uint64_t latencySum[SPI_MAX_SEQUENCE] = { 0 };
+    uint64_t latencyMax[SPI_MAX_SEQUENCE] = { 0 };
+
+    Bench_Start(mode);
+
+    double start = Bench_HostSeconds();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t submit = HostSim_Cycles;
+        uint8_t done[SPI_MAX_SEQUENCE] = { 0 };
+
+        for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+            Spi_AsyncTransmit(seq);
+        }
+        while (Spi_GetStatus() == SPI_BUSY) {
+            Bench_Wait(mode);
+            for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+                if (!done[seq] && Spi_GetSequenceResult(seq) != SPI_SEQ_PENDING) {
+                    uint64_t latency = HostSim_Cycles - submit;
+                    latencySum[seq] += latency;
+                    if (latency > latencyMax[seq]) {
+                        latencyMax[seq] = latency;
+                    }
+                    done[seq] = 1;
+                }
+            }
+        }
+    }
+    Bench_Report(name, HostSim_Cycles, Bench_HostSeconds() - start);
+    for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+        printf("  %-8s latency mean %8.1f cycles  max %6llu cycles\n", Bench_SeqName[seq],
+               (double)latencySum[seq] / BENCH_ROUNDS, (unsigned long long)latencyMax[seq]);
+    }
+    Bench_ReportUnits();
+    Spi_DeInit();
+}
+
+/* Fills a block of the stream with data derived from its number */
+static void Bench_FillBlock(uint16_t* tx, uint32_t block)
+{
+    for (uint32_t i = 0; i < SPI_EXT_ADC_MAX_LENGTH; i++) {
+        tx[i] = (uint16_t)(block * 0x1F3u + i * 0x101u);
+    }
+}
+
+/* Counts the bytes of a received block that differ from what was sent */
+static uint32_t Bench_CheckBlock(const uint16_t* rx, uint32_t block)
+{
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < SPI_EXT_ADC_MAX_LENGTH; i++) {
+        errors += (rx[i] != (uint16_t)(block * 0x1F3u + i * 0x101u));
+    }
+    return errors;
+}
+
+/* Waits for the end of one sequence */
+static void Bench_WaitSequence(Spi_AsyncModeType mode, Spi_SequenceType seq)
+{
+    while (Spi_GetSequenceResult(seq) == SPI_SEQ_PENDING) {
+        Bench_Wait(mode);
+    }
+}
+
+/* Continuous stream through the EB channel. With one buffer the application processes a block
+   before the next transfer starts; with ping-pong buffers the next transfer runs meanwhile */
+static void Bench_Stream(const char* name, Spi_AsyncModeType mode, uint8_t pingPong)
+{
+    const Spi_DataBufferType* src[2] = { (const Spi_DataBufferType*)Bench_StreamTx[0], (const Spi_DataBufferType*)Bench_StreamTx[1] };
+    Spi_DataBufferType* dst[2] = { (Spi_DataBufferType*)Bench_StreamRx[0], (Spi_DataBufferType*)Bench_StreamRx[1] };
+    uint32_t errors = 0;
+
+    Bench_Start(mode);
+    if (pingPong) {
+        Spi_SetupEBPingPong(SPI_CHANNEL_EXT_ADC, src, dst, SPI_EXT_ADC_MAX_LENGTH);
+    } else {
+        Spi_SetupEB(SPI_CHANNEL_EXT_ADC, src[0], dst[0], SPI_EXT_ADC_MAX_LENGTH);
+    }
+
+    double start = Bench_HostSeconds();
+    if (pingPong) {
+        Bench_FillBlock(Bench_StreamTx[0], 0);
+        Spi_AsyncTransmit(SPI_SEQ_EXT_ADC);
+        for (uint32_t block = 1; block <= BENCH_STREAM_BLOCKS; block++) {
+            const Spi_DataBufferType* tx;
+            Spi_DataBufferType* rx;
+
+            // Prepare the next block in the half the driver does not use
+            Spi_GetEBBuffers(SPI_CHANNEL_EXT_ADC, &tx, NULL);
+            Bench_FillBlock((uint16_t*)(uintptr_t)tx, block);
+            Bench_WaitSequence(mode, SPI_SEQ_EXT_ADC);
+            if (block < BENCH_STREAM_BLOCKS) {
+                Spi_AsyncTransmit(SPI_SEQ_EXT_ADC);
+            }
+            // Process the block just received while the next one streams
+            Spi_GetEBBuffers(SPI_CHANNEL_EXT_ADC, NULL, &rx);
+            errors += Bench_CheckBlock((const uint16_t*)(void*)rx, block - 1);
+            HostSim_Idle(BENCH_PROCESS_CYCLES);
+        }
+    } else {
+        for (uint32_t block = 0; block < BENCH_STREAM_BLOCKS; block++) {
+            Bench_FillBlock(Bench_StreamTx[0], block);
+            Spi_AsyncTransmit(SPI_SEQ_EXT_ADC);
+            Bench_WaitSequence(mode, SPI_SEQ_EXT_ADC);
+            errors += Bench_CheckBlock(Bench_StreamRx[0], block);
+            HostSim_Idle(BENCH_PROCESS_CYCLES);
+        }
+    }
+    double hostSeconds = Bench_HostSeconds() - start;
+
+    Spi_HWUnitStatsType stats;
+    Spi_GetHWUnitStats(SPI_HWUnit_2, &stats);
+    printf("%-18s %8.1f cycles/block  %8.0f kB/s (modelled)  bus busy %5.1f%%  %5.1f reg/block  %5.1f irq/block  %lu errors  %8.1f ns/block (host)\n",
+           name, (double)HostSim_Cycles / BENCH_STREAM_BLOCKS,
+           2.0 * SPI_EXT_ADC_MAX_LENGTH * BENCH_STREAM_BLOCKS * HOSTSIM_CORE_CLOCK_HZ / (double)HostSim_Cycles / 1000.0,
+           100.0 * (double)stats.busyCycles / (double)HostSim_Cycles,
+           (double)HostSim_RegAccesses / BENCH_STREAM_BLOCKS, (double)HostSim_IrqCount / BENCH_STREAM_BLOCKS,
+           (unsigned long)errors, hostSeconds * 1e9 / BENCH_STREAM_BLOCKS);
+    Spi_DeInit();
+}
+
+/* A transfer error on the TX stream of SPI2 (DMA1 stream 4) in the middle of the gateway job: the
+   stream stops, so the RX stream never completes and only the error interrupt can end the job */
+static void Bench_DmaTxError(void)
+{
+    uint32_t errors = 0;
+    uint32_t waits = 0;
+
+    Bench_Start(SPI_DMA_MODE);
+    errors += (Spi_AsyncTransmit(SPI_SEQ_GATEWAY) != E_OK);
+    HostSim_Idle(200u);
+    DMA1_Stream4->CR &= ~DMA_SxCR_EN;
+    DMA1->HISR |= DMA_HISR_TEIF4;
+    while (Spi_GetStatus() == SPI_BUSY && waits < 1000u) {
+        Bench_Wait(SPI_DMA_MODE);
+        waits++;
+    }
+    uint8_t stuck = (Spi_GetStatus() == SPI_BUSY);
+    errors += stuck;
+    errors += (Spi_GetJobResult(SPI_JOB_GATEWAY_WRITE) != SPI_JOB_FAILED);
+    errors += (Spi_GetSequenceResult(SPI_SEQ_GATEWAY) != SPI_SEQ_FAILED);
+
+    /* The next transfer runs normally */
+    errors += (!stuck && (Spi_SyncTransmit(SPI_SEQ_GATEWAY) != E_OK || Spi_GetSequenceResult(SPI_SEQ_GATEWAY) != SPI_SEQ_OK));
+    printf("dma tx error   gateway job %s after %lu waits, %lu errors\n",
+           stuck ? "still pending" : "ended", (unsigned long)waits, (unsigned long)errors);
+    Spi_DeInit();
+}
+
+/* Polled EEPROM job started, then its sequence cancelled: the main function must finish the job
+   and release the chip select; the driver stays busy until then */
+static void Bench_PollingCancel(void)
+{
+    const Spi_JobConfigType* jobCfg = &Spi_JobConfig[SPI_JOB_EEPROM_STATUS];
+    uint32_t errors = 0;
+    uint32_t calls = 0;
+
+    Bench_Start(SPI_POLLING_MODE);
+    /* The chip select reads back on IDR as an output */
+    HostSim_Gpio[DIO_CHANNEL_PORT(jobCfg->csChannel)].regs.MODER |= 1u << (DIO_CHANNEL_PIN(jobCfg->csChannel) * 2u);
+    errors += (Spi_AsyncTransmit(SPI_SEQ_EEPROM) != E_OK);
+    Spi_MainFunction_Handling();
+    errors += (Spi_GetJobResult(SPI_JOB_EEPROM_STATUS) != SPI_JOB_PENDING);
+    errors += (Spi_Cancel(SPI_SEQ_EEPROM) != E_OK);
+    errors += (Spi_GetSequenceResult(SPI_SEQ_EEPROM) != SPI_SEQ_CANCELED);
+    errors += (Spi_GetStatus() != SPI_BUSY || Spi_DeInit() != E_NOT_OK);
+    while (Spi_GetStatus() == SPI_BUSY && calls < 1000u) {
+        HostSim_Idle(50u);
+        Spi_MainFunction_Handling();
+        calls++;
+    }
+    uint8_t stuck = (Spi_GetStatus() == SPI_BUSY);
+    errors += stuck;
+    errors += (Spi_GetJobResult(SPI_JOB_EEPROM_STATUS) != SPI_JOB_OK);
+    errors += (Dio_ReadChannel(jobCfg->csChannel) == jobCfg->csActiveLevel);
+    errors += (Spi_DeInit() != E_OK);
+    printf("polling cancel eeprom job %s after %lu calls, %lu errors\n",
+           stuck ? "still pending" : "ended", (unsigned long)calls, (unsigned long)errors);
+}
+
+/* Interrupt-driven engine with random spurious interrupts and random main function delays;
+   every transmitted byte must come back through the loopback and nothing may be lost */
+static void Bench_IsrStress(void)
+{
+    uint8_t tx[BENCH_NUM_TX_CHANNELS][BENCH_MAX_LENGTH];
+    uint8_t rx[BENCH_MAX_LENGTH];
+    uint32_t errors = 0;
+    uint32_t injected = 0;
+
+    Bench_Start(SPI_INTERRUPT_MODE);
+    srand(1);
+
+    double start = Bench_HostSeconds();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BENCH_NUM_TX_CHANNELS; i++) {
+            for (uint32_t j = 0; j < BENCH_MAX_LENGTH; j++) {
+                tx[i][j] = (uint8_t)rand();
+            }
+            Spi_WriteIB(Bench_TxChannel[i], tx[i]);
+        }
+        for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+            if (Spi_AsyncTransmit(seq) != E_OK) {
+                errors++;
+            }
+        }
+        while (Spi_GetStatus() == SPI_BUSY) {
+            injected += HostSim_SpiInjectIrq((uint32_t)rand() % HOSTSIM_NUM_SPI);
+            HostSim_Idle((uint32_t)rand() % 256u);
+            Spi_MainFunction_Handling();
+        }
+        for (uint32_t i = 0; i < BENCH_NUM_TX_CHANNELS; i++) {
+            const Spi_ChannelConfigType* chCfg = &Spi_ChannelConfig[Bench_TxChannel[i]];
+            Spi_ReadIB(Bench_TxChannel[i], rx);
+            for (Spi_NumberOfDataType j = 0; j < chCfg->length; j++) {
+                errors += (rx[j] != tx[i][j]);
+            }
+        }
+        for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+            errors += (Spi_GetSequenceResult(seq) != SPI_SEQ_OK);
+        }
+    }
+    Bench_Report("isr stress", HostSim_Cycles, Bench_HostSeconds() - start);
+    printf("  %lu spurious interrupts injected, %lu errors\n", (unsigned long)injected, (unsigned long)errors);
+    Bench_ReportUnits();
+    Spi_DeInit();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 4) {
+        HostSim_SpiTiming.txe = (uint32_t)strtoul(argv[1], NULL, 0);
+        HostSim_SpiTiming.rxne = (uint32_t)strtoul(argv[2], NULL, 0);
+        HostSim_SpiTiming.bsy = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    printf("SPI scheduler, %u rounds of %u sequences, flag latency TXE %u RXNE %u BSY %u cycles\n",
+           BENCH_ROUNDS, SPI_MAX_SEQUENCE, HostSim_SpiTiming.txe, HostSim_SpiTiming.rxne, HostSim_SpiTiming.bsy);
+    Bench_Serialized("serialized", SPI_POLLING_MODE);
+    Bench_Parallel("parallel", SPI_POLLING_MODE);
+    Bench_Serialized("serialized/irq", SPI_INTERRUPT_MODE);
+    Bench_Parallel("parallel/irq", SPI_INTERRUPT_MODE);
+    Bench_Serialized("serialized/dma", SPI_DMA_MODE);
+    Bench_Parallel("parallel/dma", SPI_DMA_MODE);
+    Bench_Config = NULL;
+    Bench_Parallel("per-unit/dma", SPI_DMA_MODE);
+    Bench_Config = &Bench_SpiConfig;
+    Bench_IsrStress();
+    Bench_DmaTxError();
+    Bench_PollingCancel();
+    printf("EB stream, %u blocks of %u 16-bit frames, %u cycles of processing per block\n",
+           BENCH_STREAM_BLOCKS, SPI_EXT_ADC_MAX_LENGTH, BENCH_PROCESS_CYCLES);
+    Bench_Stream("single/irq", SPI_INTERRUPT_MODE, 0);
+    Bench_Stream("ping-pong/irq", SPI_INTERRUPT_MODE, 1);
+    Bench_Stream("single/dma", SPI_DMA_MODE, 0);
+    Bench_Stream("ping-pong/dma", SPI_DMA_MODE, 1);
+    return 0;
+}
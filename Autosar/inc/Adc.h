@@ -0,0 +1,96 @@
+/*
+* File: Adc.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the ADC driver for the three ADCs of the STM32F4. A group is a list
+* of channels converted by one ADC in a continuous scan; every conversion is moved by DMA into the
+* result buffer of the group, so the CPU only runs at the half-transfer and transfer-complete
+* interrupts of the stream. A group can also be converted by the three ADCs in triple interleaved
+* mode, which samples one channel at up to three times the rate of a single ADC.
+*/
+
+#ifndef ADC_H
+#define ADC_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Adc_Cfg.h"
+#include <stddef.h>
+
+// Number of ADC hardware units
+#define NUM_OF_ADC_HW_UNITS 3
+
+// Definition of ADC hardware units
+typedef enum {
+    ADC_HWUnit_0,       // ADC1
+    ADC_HWUnit_1,       // ADC2
+    ADC_HWUnit_2        // ADC3
+} Adc_HWUnitType;
+
+typedef uint8_t Adc_ChannelType;            // ADC_Channel_x
+typedef uint8_t Adc_GroupType;              // Group identifier, ADC_GROUP_x
+typedef uint16_t Adc_ValueGroupType;        // One conversion result, right aligned
+typedef uint16_t Adc_StreamNumSampleType;   // Number of rounds of a group
+
+// Status of a group
+typedef enum {
+    ADC_IDLE,               // Not converting, or stopped before a round completed
+    ADC_BUSY,               // Converting, no round completed since the last read
+    ADC_COMPLETED,          // At least one round completed since the last read
+    ADC_STREAM_COMPLETED    // The result buffer has been filled since the last read
+} Adc_StatusType;
+
+// Use of the result buffer
+typedef enum {
+    ADC_STREAM_BUFFER_LINEAR,   // The group stops once the buffer is full
+    ADC_STREAM_BUFFER_CIRCULAR  // The buffer is refilled from the start until the group is stopped
+} Adc_StreamBufferModeType;
+
+// Configuration of a group. The result buffer is sample-major, in the order the DMA writes it:
+// round 0 holds one result per channel in channelList order, then round 1, and so on. This differs
+// from the channel-major layout of AUTOSAR but needs no copy.
+typedef struct {
+    Adc_HWUnitType hwUnit;                  // Unit converting the group, ADC_HWUnit_0 when interleaved
+    const Adc_ChannelType* channelList;     // Channels converted in each round, in order
+    uint8_t numChannels;                    // 1 to 16, 1 when interleaved
+    uint8_t samplingTime;                   // ADC_SampleTime_x, used for every channel
+    Adc_StreamBufferModeType bufferMode;    // Linear or circular result buffer
+    Adc_StreamNumSampleType streamSamples;  // Rounds held by the result buffer
+    uint8_t tripleInterleaved;              // Converted by ADC1..ADC3 in turn, at most 3x the rate
+    void (*halfNotification)(void);         // First half of the buffer filled, NULL if unused
+    void (*fullNotification)(void);         // Second half of the buffer filled, NULL if unused
+} Adc_GroupConfigType;
+
+// Settings common to the three units
+typedef struct {
+    uint32_t prescaler;                     // ADC_Prescaler_DivX of PCLK2
+    uint32_t interleaveDelay;               // ADC_TwoSamplingDelay_xCycles of interleaved groups
+} Adc_ConfigType;
+
+// Counters of a group
+typedef struct {
+    uint32_t halfTransfers;                 // Half-transfer interrupts
+    uint32_t fullTransfers;                 // Transfer complete interrupts, one per filled buffer
+    uint32_t overruns;                      // Conversions lost because the DMA was late
+    uint32_t transferErrors;                // DMA transfer errors, each stopping the group
+} Adc_GroupStatsType;
+
+// Configuration tables, defined in Adc_Cfg.c
+extern const Adc_GroupConfigType Adc_GroupConfig[ADC_MAX_GROUP];
+extern const Adc_ConfigType Adc_Config;
+
+// Function prototypes
+void Adc_Init(const Adc_ConfigType* ConfigPtr);
+void Adc_DeInit(void);
+Std_ReturnType Adc_SetupResultBuffer(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr);
+Std_ReturnType Adc_StartGroupConversion(Adc_GroupType Group);
+Std_ReturnType Adc_StopGroupConversion(Adc_GroupType Group);
+Std_ReturnType Adc_ReadGroup(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr);
+Adc_StatusType Adc_GetGroupStatus(Adc_GroupType Group);
+Adc_StreamNumSampleType Adc_GetStreamLastPointer(Adc_GroupType Group, Adc_ValueGroupType** PtrToSamplePtr);
+void Adc_EnableGroupNotification(Adc_GroupType Group);
+void Adc_DisableGroupNotification(Adc_GroupType Group);
+Std_ReturnType Adc_GetGroupStats(Adc_GroupType Group, Adc_GroupStatsType* StatsPtr);
+Std_ReturnType Adc_ResetGroupStats(Adc_GroupType Group);
+
+#endif /* ADC_H */
@@ -0,0 +1,41 @@
+/*
+* File: Adc_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Pre-compile configuration of the ADC driver: symbolic names and number of the
+* channel groups defined in Adc_Cfg.c, and the sizes of their result buffers.
+*/
+
+#ifndef ADC_CFG_H
+#define ADC_CFG_H
+
+/* Groups */
+#define ADC_GROUP_SENSORS           0   /* ADC1: PC0, PC1, PA1 scanned continuously, circular */
+#define ADC_GROUP_SUPPLY            1   /* ADC2: PC3 supply voltage, one linear block per start */
+#define ADC_GROUP_CAPTURE           2   /* ADC1..ADC3 triple interleaved on PC2, circular */
+#define ADC_MAX_GROUP               3
+
+/* Rounds held by the result buffer of each group. Circular buffers are handed over by halves, so
+   they hold an even number of rounds; the triple interleaved group moves two samples per DMA
+   transfer and holds a multiple of four. */
+#define ADC_SENSORS_SAMPLES         32
+#define ADC_SUPPLY_SAMPLES          16
+#define ADC_CAPTURE_SAMPLES         2048
+
+/* Notifications of ADC_GROUP_CAPTURE, implemented by the application: each half of the buffer is
+   processed while the DMA fills the other one */
+void AdcCapture_HalfNotification(void);
+void AdcCapture_FullNotification(void);
+
+/* Common ADC clock: PCLK2 (84 MHz) / 4 = 21 MHz, within the 36 MHz maximum of the datasheet.
+   ADC_Prescaler_Div2 (42 MHz, as in the triple interleaved example of the library) doubles every
+   conversion rate but overclocks the ADC: opt in only where the accuracy figures of the datasheet
+   are not needed. */
+#define ADC_CLOCK_PRESCALER         ADC_Prescaler_Div4
+
+/* Delay between the sampling phases of two ADCs in triple interleaved mode. With 3-cycle sampling
+   a conversion lasts 15 ADC clocks, so a 5-cycle delay keeps the three ADCs converting back to
+   back: 21 MHz / 5 = 4.2 Msamples/s, 8.4 with ADC_Prescaler_Div2. */
+#define ADC_INTERLEAVE_DELAY        ADC_TwoSamplingDelay_5Cycles
+
+#endif /* ADC_CFG_H */
@@ -0,0 +1,146 @@
+/*
+* File: Can.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the CAN driver for the bxCAN controllers of the STM32F4. Frames to
+* transmit are queued by priority and loaded into the three TX mailboxes by the transmit
+* interrupt; received frames are moved from both RX FIFOs into lock-free queues by the receive
+* interrupts and indicated to the upper layer by Can_MainFunction_Read. Only the frames of
+* CAN_RX_PDUS reach the receive interrupts: the list is compiled into the hardware filter banks,
+* and the identifiers a bank lets through beyond the list are dropped in the interrupt.
+*/
+
+#ifndef CAN_H
+#define CAN_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "Can_Cfg.h"
+#include <stddef.h>
+
+// CAN identifier; extended identifiers have CAN_ID_EXTENDED set
+typedef uint32_t Can_IdType;
+#define CAN_ID_EXTENDED         0x80000000u
+#define CAN_ID_STANDARD_MASK    0x7FFu
+#define CAN_ID_EXTENDED_MASK    0x1FFFFFFFu
+
+// Hardware object handle, CAN_HTH_x or CAN_HRH_x
+typedef uint16_t Can_HwHandleType;
+
+// Frame to transmit
+typedef struct {
+    PduIdType swPduHandle;                  // Returned by the transmit confirmation
+    uint8_t length;                         // Data length, 0 to 8
+    Can_IdType id;                          // Identifier
+    const uint8_t* sdu;                     // Data, copied by Can_Write
+} Can_PduType;
+
+// Result of Can_Write
+typedef enum {
+    CAN_OK,             // Frame accepted
+    CAN_NOT_OK,         // Invalid request or controller not started
+    CAN_BUSY            // No room left in the transmit queue
+} Can_ReturnType;
+
+// Mode transition requested with Can_SetControllerMode
+typedef enum {
+    CAN_T_START,
+    CAN_T_STOP,
+    CAN_T_SLEEP,
+    CAN_T_WAKEUP
+} Can_StateTransitionType;
+
+// State of a controller
+typedef enum {
+    CAN_CS_UNINIT,
+    CAN_CS_STARTED,
+    CAN_CS_STOPPED,
+    CAN_CS_SLEEP
+} Can_ControllerStateType;
+
+// Bit timing and mode of a controller. The time quantum is (prescaler / 42 MHz), a bit lasts
+// (1 + bs1 + bs2) quanta.
+typedef struct {
+    uint8_t enabled;                        // Controller used by the configuration
+    uint16_t prescaler;                     // 1 to 1024
+    uint8_t sjw;                            // CAN_SJW_xtq
+    uint8_t bs1;                            // CAN_BS1_xtq
+    uint8_t bs2;                            // CAN_BS2_xtq
+    uint8_t mode;                           // CAN_Mode_Normal, CAN_Mode_LoopBack, ...
+} Can_ControllerConfigType;
+
+// Filter bank, with the values of its CAN_FxR1 and CAN_FxR2 registers. Banks are taken in order
+// from the first bank of their controller.
+typedef struct {
+    uint8_t controller;                     // CAN_CONTROLLER_x
+    uint8_t fifo;                           // CAN_FIFO0 or CAN_FIFO1
+    uint8_t mode;                           // CAN_FilterMode_IdMask or CAN_FilterMode_IdList
+    uint8_t scale;                          // CAN_FilterScale_16bit or CAN_FilterScale_32bit
+    uint32_t fr1;
+    uint32_t fr2;
+} Can_FilterBankConfigType;
+
+// Slot of the receive hash table: a received identifier and its frame of CAN_RX_PDUS
+typedef struct {
+    Can_IdType id;                          // CAN_RX_NO_ID in an empty slot
+    uint8_t pdu;                            // Can_RxPduIdType, CAN_NUM_RX_PDUS in an empty slot
+} Can_RxSlotType;
+
+// Hash table of a receive hardware object in Can_RxSlotTable: identifier Id can only be in slot
+// first + ((Id * multiplier) >> shift), the multiplier being chosen so that no two identifiers of
+// the object share a slot. When the filter banks of the object also accept other identifiers,
+// check is set and the receive interrupt drops every frame not found in the table.
+typedef struct {
+    uint16_t first;
+    uint8_t shift;                          // 32 - log2 of the number of slots
+    uint8_t check;
+    uint32_t multiplier;
+} Can_RxHashType;
+
+#define CAN_RX_NO_ID            0xFFFFFFFFu // Not an identifier: CAN_ID_EXTENDED_MASK has 29 bits
+
+// Notifications of the upper layer, NULL if unused. RxPdu is the frame of CAN_RX_PDUS found by the
+// receive interrupt, CAN_NUM_RX_PDUS for an identifier not listed for the hardware object.
+typedef struct {
+    void (*rxIndication)(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr);
+    void (*txConfirmation)(PduIdType CanTxPduId);
+    void (*busOffNotification)(uint8_t Controller);
+} Can_ConfigType;
+
+// Counters of a controller
+typedef struct {
+    uint32_t txFrames;                      // Frames transmitted and confirmed
+    uint32_t txAborts;                      // Mailboxes aborted for a higher priority frame
+    uint32_t rxFrames;                      // Frames indicated to the upper layer
+    uint32_t rxOverruns;                    // RX FIFO overruns, each losing at least one frame
+    uint32_t rxQueueFull;                   // Frames lost by a full RX queue
+    uint32_t rxRejected;                    // Frames let through by a filter mask but not in CAN_RX_PDUS
+    uint32_t interrupts;                    // TX and RX interrupts served
+} Can_ControllerStatsType;
+
+// Configuration tables, defined in Can_Cfg.c
+extern const Can_ControllerConfigType Can_ControllerConfig[CAN_NUM_CONTROLLERS];
+extern const Can_ConfigType Can_Config;
+
+// Filter tables, generated into Can_Filter_Cfg.c by Test/Can_FilterGen.c
+extern const Can_FilterBankConfigType Can_FilterBankConfig[];
+extern const uint8_t Can_FilterBankCount;
+extern const Can_RxSlotType Can_RxSlotTable[];
+extern const Can_RxHashType Can_RxHash[CAN_NUM_HRH];
+
+// Function prototypes
+void Can_Init(const Can_ConfigType* Config);
+void Can_DeInit(void);
+Std_ReturnType Can_SetControllerMode(uint8_t Controller, Can_StateTransitionType Transition);
+Std_ReturnType Can_GetControllerMode(uint8_t Controller, Can_ControllerStateType* ControllerModePtr);
+void Can_DisableControllerInterrupts(uint8_t Controller);
+void Can_EnableControllerInterrupts(uint8_t Controller);
+Can_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo);
+void Can_MainFunction_Write(void);
+void Can_MainFunction_Read(void);
+void Can_MainFunction_BusOff(void);
+Std_ReturnType Can_GetControllerStats(uint8_t Controller, Can_ControllerStatsType* StatsPtr);
+Std_ReturnType Can_ResetControllerStats(uint8_t Controller);
+
+#endif /* CAN_H */
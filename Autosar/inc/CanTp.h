@@ -0,0 +1,86 @@
+/*
+* File: CanTp.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the CAN transport layer (ISO 15765-2), which segments the messages of
+* the diagnostic layer into single, first and consecutive frames and reassembles them, with the
+* flow control of CanTp_Cfg.h. Received frames come from the PDU router and are copied straight
+* into the buffer the upper layer gives for the message; a message sent is read from the caller's
+* buffer until its confirmation. Consecutive frames are not paced by a main function: with an
+* STmin of 0 the transmit confirmation of one writes the next, otherwise a GPT timer of STmin
+* started at the confirmation does.
+*/
+
+#ifndef CANTP_H
+#define CANTP_H
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "Can.h"
+#include "Gpt.h"
+#include "CanTp_Cfg.h"
+
+// Addressing of a connection
+#define CANTP_PHYSICAL          0u
+#define CANTP_FUNCTIONAL        1u          // Single frames only
+
+// Handles of the frames written by CanTp: CANTP_TX_HANDLE + connection for the frames of a
+// message, CANTP_FC_HANDLE + connection for the flow control frames
+#define CANTP_TX_HANDLE         0x0100u
+#define CANTP_FC_HANDLE         0x0140u
+
+// Longest message: 4095 bytes fit a first frame, longer ones use its 32-bit length
+#define CANTP_MAX_LENGTH        0xFFFFu
+
+// Parameter of CanTp_ChangeParameter
+typedef enum {
+    CANTP_PARAM_BS,                         // Block size, 0 for no flow control after the first one
+    CANTP_PARAM_STMIN                       // STmin as coded in a flow control frame
+} CanTp_ParameterType;
+
+// Connection
+typedef struct {
+    Can_RxPduIdType rxPdu;                  // Frame of CAN_RX_PDUS received
+    Can_IdType txId;                        // Identifier sent
+    Can_HwHandleType hth;                   // Transmit hardware object
+    uint8_t bs;                             // Block size sent in the flow control frames
+    uint8_t stMin;                          // STmin sent in the flow control frames
+    uint8_t addressing;                     // CANTP_PHYSICAL or CANTP_FUNCTIONAL
+} CanTp_ConnectionConfigType;
+
+// Upper layer. The callbacks of the reception run from Can_MainFunction_Read, or from the GPT
+// interrupt for a timeout; the transmit confirmation runs from the CAN or GPT interrupt.
+typedef struct {
+    // Buffer for a message of Length bytes, kept until rxIndication; NULL refuses the message
+    uint8_t* (*startOfReception)(CanTp_ConnectionType Connection, PduLengthType Length);
+    // The message is complete in the buffer (E_OK) or its reception was aborted (E_NOT_OK)
+    void (*rxIndication)(CanTp_ConnectionType Connection, Std_ReturnType Result);
+    // The message of CanTp_Transmit is sent (E_OK) or aborted (E_NOT_OK); its buffer is released
+    void (*txConfirmation)(CanTp_ConnectionType Connection, Std_ReturnType Result);
+} CanTp_ConfigType;
+
+// Counters of the module
+typedef struct {
+    uint32_t rxMessages;                    // Messages received
+    uint32_t rxAborted;                     // Receptions aborted: sequence error, timeout, refused
+    uint32_t txMessages;                    // Messages sent
+    uint32_t txAborted;                     // Transmissions aborted: overflow, timeout
+    uint32_t flowControls;                  // Flow control frames sent
+    uint32_t cfByConfirmation;              // Consecutive frames written from a transmit confirmation
+    uint32_t cfByTimer;                     // Consecutive frames written from the STmin timer
+} CanTp_StatsType;
+
+// Configuration tables, defined in CanTp_Cfg.c
+extern const CanTp_ConnectionConfigType CanTp_ConnectionConfig[CANTP_NUM_CONNECTIONS];
+extern const CanTp_ConfigType CanTp_Config;
+
+// Function prototypes
+void CanTp_Init(const CanTp_ConfigType* ConfigPtr);
+void CanTp_DeInit(void);
+Std_ReturnType CanTp_Transmit(CanTp_ConnectionType Connection, const uint8_t* Data, PduLengthType Length);
+Std_ReturnType CanTp_ChangeParameter(CanTp_ConnectionType Connection, CanTp_ParameterType Parameter, uint8_t Value);
+void CanTp_RxIndication(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr);
+void CanTp_TxConfirmation(PduIdType CanTxPduId);
+Std_ReturnType CanTp_GetStats(CanTp_StatsType* StatsPtr);
+
+#endif /* CANTP_H */
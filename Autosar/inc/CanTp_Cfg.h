@@ -0,0 +1,49 @@
+/*
+* File: CanTp_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the CAN transport layer: the connections, the flow control
+* parameters sent to the tester and the timeouts.
+*/
+
+#ifndef CANTP_CFG_H
+#define CANTP_CFG_H
+
+// Connections: name, frame of CAN_RX_PDUS received, identifier sent, transmit hardware object,
+// block size and STmin sent in the flow control frames, CANTP_PHYSICAL or CANTP_FUNCTIONAL.
+// A functional connection only carries single frames.
+#define CANTP_CONNECTIONS(X) \
+    X(CANTP_DIAG_PHYSICAL,      CAN_RX_PDU_DIAG_PHYSICAL,   0x7E8,  CAN_HTH_CAN1,   CANTP_DIAG_BS,  0,  CANTP_PHYSICAL) \
+    X(CANTP_DIAG_FUNCTIONAL,    CAN_RX_PDU_DIAG_FUNCTIONAL, 0x7E8,  CAN_HTH_CAN1,   0,              0,  CANTP_FUNCTIONAL)
+
+// Block size of the diagnostic requests. The consecutive frames of a block wait in the receive
+// queue of the CAN driver until Can_MainFunction_Read, and the next flow control frame is only
+// sent once they are all read: a block that fits the queue, next to the other frames of its
+// FIFO, is never lost whatever the period of the main loop. CanTp_ChangeParameter sets 0 (no
+// flow control after the first frame) when the main loop drains the queue fast enough.
+#define CANTP_DIAG_BS           24u
+
+// Consecutive frames written ahead to the CAN driver when STmin is 0: each transmit
+// confirmation writes the next one, so the bus never waits for the CPU
+#define CANTP_TX_BURST          4u
+
+// Timeouts in GPT ticks: N_As for a frame written to be sent, N_Bs for a flow control frame, N_Cr
+// for a consecutive frame
+#define CANTP_N_AS              GPT_MS(1000u)
+#define CANTP_N_BS              GPT_MS(1000u)
+#define CANTP_N_CR              GPT_MS(1000u)
+
+// Delay before a frame refused by a full transmit queue of the CAN driver is written again
+#define CANTP_RETRY             (GPT_TICKS_PER_MS / 10u)
+
+// Value of the unused bytes of a frame; frames are always sent with 8 bytes
+#define CANTP_PADDING           0xCCu
+
+#define CANTP_CONNECTION_NAME(name, ...)    name,
+
+typedef enum {
+    CANTP_CONNECTIONS(CANTP_CONNECTION_NAME)
+    CANTP_NUM_CONNECTIONS
+} CanTp_ConnectionType;
+
+#endif /* CANTP_CFG_H */
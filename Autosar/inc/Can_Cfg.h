@@ -0,0 +1,109 @@
+/*
+* File: Can_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the CAN driver: controllers, hardware objects, queue sizes and the
+* frames received by the ECU.
+*/
+
+#ifndef CAN_CFG_H
+#define CAN_CFG_H
+
+// Controllers: bxCAN1 and bxCAN2
+#define CAN_CONTROLLER_1        0
+#define CAN_CONTROLLER_2        1
+#define CAN_NUM_CONTROLLERS     2
+
+// Transmit hardware objects: one per controller, served by its three mailboxes
+#define CAN_HTH_CAN1            0
+#define CAN_HTH_CAN2            1
+#define CAN_NUM_HTH             2
+
+// Receive hardware objects: one per RX FIFO of each controller
+#define CAN_HRH_CAN1_FIFO0      0
+#define CAN_HRH_CAN1_FIFO1      1
+#define CAN_HRH_CAN2_FIFO0      2
+#define CAN_HRH_CAN2_FIFO1      3
+#define CAN_NUM_HRH             4
+
+// Frames waiting for a mailbox, per controller
+#define CAN_TX_QUEUE_SIZE       16
+
+// Frames received and not yet indicated, per RX FIFO; a power of two
+#define CAN_RX_QUEUE_SIZE       32
+
+// Filter banks: 0..13 belong to CAN1, 14..27 to CAN2
+#define CAN_NUM_FILTER_BANKS    28
+#define CAN_SLAVE_START_BANK    14
+
+// Frames consumed by the ECU: name, receive hardware object, identifier (CAN_ID_EXTENDED set for an
+// extended identifier). Test/Can_FilterGen.c compiles this list into the filter banks of
+// src/Can_Filter_Cfg.c; run "make -C Test filters" after changing it.
+#define CAN_RX_PDUS(X) \
+    /* CAN1, urgent chassis traffic */ \
+    X(CAN_RX_PDU_BRAKE_PRESSURE,    CAN_HRH_CAN1_FIFO1, 0x010) \
+    X(CAN_RX_PDU_STEERING_ANGLE,    CAN_HRH_CAN1_FIFO1, 0x020) \
+    X(CAN_RX_PDU_WHEEL_SPEED_FL,    CAN_HRH_CAN1_FIFO1, 0x0C0) \
+    X(CAN_RX_PDU_WHEEL_SPEED_FR,    CAN_HRH_CAN1_FIFO1, 0x0C1) \
+    X(CAN_RX_PDU_WHEEL_SPEED_RL,    CAN_HRH_CAN1_FIFO1, 0x0C2) \
+    X(CAN_RX_PDU_WHEEL_SPEED_RR,    CAN_HRH_CAN1_FIFO1, 0x0C3) \
+    X(CAN_RX_PDU_YAW_RATE,          CAN_HRH_CAN1_FIFO1, 0x0F0) \
+    /* CAN1, powertrain and body */ \
+    X(CAN_RX_PDU_BMS_CELLS_0,       CAN_HRH_CAN1_FIFO0, 0x200) \
+    X(CAN_RX_PDU_BMS_CELLS_1,       CAN_HRH_CAN1_FIFO0, 0x201) \
+    X(CAN_RX_PDU_BMS_CELLS_2,       CAN_HRH_CAN1_FIFO0, 0x202) \
+    X(CAN_RX_PDU_BMS_CELLS_3,       CAN_HRH_CAN1_FIFO0, 0x203) \
+    X(CAN_RX_PDU_BMS_CELLS_4,       CAN_HRH_CAN1_FIFO0, 0x204) \
+    X(CAN_RX_PDU_BMS_CELLS_5,       CAN_HRH_CAN1_FIFO0, 0x205) \
+    X(CAN_RX_PDU_BMS_CELLS_6,       CAN_HRH_CAN1_FIFO0, 0x206) \
+    X(CAN_RX_PDU_BMS_CELLS_7,       CAN_HRH_CAN1_FIFO0, 0x207) \
+    X(CAN_RX_PDU_GEAR,              CAN_HRH_CAN1_FIFO0, 0x2A0) \
+    X(CAN_RX_PDU_THROTTLE,          CAN_HRH_CAN1_FIFO0, 0x2B4) \
+    X(CAN_RX_PDU_COOLANT,           CAN_HRH_CAN1_FIFO0, 0x300) \
+    X(CAN_RX_PDU_OIL,               CAN_HRH_CAN1_FIFO0, 0x310) \
+    X(CAN_RX_PDU_FUEL,              CAN_HRH_CAN1_FIFO0, 0x320) \
+    X(CAN_RX_PDU_AMBIENT,           CAN_HRH_CAN1_FIFO0, 0x330) \
+    X(CAN_RX_PDU_ODOMETER,          CAN_HRH_CAN1_FIFO0, 0x3E8) \
+    X(CAN_RX_PDU_DOORS,             CAN_HRH_CAN1_FIFO0, 0x400) \
+    X(CAN_RX_PDU_LIGHTS,            CAN_HRH_CAN1_FIFO0, 0x401) \
+    X(CAN_RX_PDU_CLIMATE_0,         CAN_HRH_CAN1_FIFO0, 0x5A0) \
+    X(CAN_RX_PDU_CLIMATE_1,         CAN_HRH_CAN1_FIFO0, 0x5A1) \
+    X(CAN_RX_PDU_CLIMATE_2,         CAN_HRH_CAN1_FIFO0, 0x5A2) \
+    X(CAN_RX_PDU_CLOCK,             CAN_HRH_CAN1_FIFO0, 0x600) \
+    X(CAN_RX_PDU_NM,                CAN_HRH_CAN1_FIFO0, 0x6F0) \
+    X(CAN_RX_PDU_DIAG_FUNCTIONAL,   CAN_HRH_CAN1_FIFO0, 0x7DF) \
+    X(CAN_RX_PDU_DIAG_PHYSICAL,     CAN_HRH_CAN1_FIFO0, 0x7E0) \
+    /* CAN2, J1939 engine control: EEC1, EEC2 from SA 00/01, TSC1 to SA 00 from SA 03/0B */ \
+    X(CAN_RX_PDU_EEC1_00,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0CF00400u) \
+    X(CAN_RX_PDU_EEC1_01,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0CF00401u) \
+    X(CAN_RX_PDU_EEC2_00,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0CF00300u) \
+    X(CAN_RX_PDU_EEC2_01,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0CF00301u) \
+    X(CAN_RX_PDU_TSC1_03,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0C000003u) \
+    X(CAN_RX_PDU_TSC1_0B,           CAN_HRH_CAN2_FIFO1, CAN_ID_EXTENDED | 0x0C00000Bu) \
+    /* CAN2, J1939 broadcast parameters from SA 00, 03, 0B and 17 */ \
+    CAN_RX_J1939(X, CCVS,   0xFEF1u) \
+    CAN_RX_J1939(X, ET1,    0xFEEEu) \
+    CAN_RX_J1939(X, IC1,    0xFEF6u) \
+    CAN_RX_J1939(X, AMB,    0xFEF5u) \
+    CAN_RX_J1939(X, LFC,    0xFEE9u) \
+    CAN_RX_J1939(X, EFLP1,  0xFEEFu) \
+    CAN_RX_J1939(X, DD,     0xFEFCu) \
+    CAN_RX_J1939(X, HOURS,  0xFEE5u) \
+    X(CAN_RX_PDU_DM1_00,            CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18FECA00u) \
+    X(CAN_RX_PDU_DM1_03,            CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18FECA03u)
+
+// One J1939 parameter group at priority 6 from the four source addresses
+#define CAN_RX_J1939(X, name, pgn) \
+    X(CAN_RX_PDU_##name##_00,       CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18000000u | ((pgn) << 8) | 0x00u) \
+    X(CAN_RX_PDU_##name##_03,       CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18000000u | ((pgn) << 8) | 0x03u) \
+    X(CAN_RX_PDU_##name##_0B,       CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18000000u | ((pgn) << 8) | 0x0Bu) \
+    X(CAN_RX_PDU_##name##_17,       CAN_HRH_CAN2_FIFO0, CAN_ID_EXTENDED | 0x18000000u | ((pgn) << 8) | 0x17u)
+
+#define CAN_RX_PDU_NAME(name, hrh, id)  name,
+
+typedef enum {
+    CAN_RX_PDUS(CAN_RX_PDU_NAME)
+    CAN_NUM_RX_PDUS
+} Can_RxPduIdType;
+
+#endif /* CAN_CFG_H */
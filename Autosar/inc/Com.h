@@ -0,0 +1,86 @@
+/*
+* File: Com.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the COM module, which maps the signals of the application onto the
+* I-PDUs exchanged with the CAN driver. Each I-PDU is packed and unpacked by a function generated
+* for its layout by Test/Com_Gen.c, with the bit positions, masks and shifts worked out at
+* generation time. Com_SendSignal only marks the signal in the dirty bitmap of its I-PDU; the
+* transmission repacks the marked signals and leaves the other bytes as they are.
+*/
+
+#ifndef COM_H
+#define COM_H
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "Can.h"
+#include "Com_Cfg.h"
+
+// Signal handle, from Com_RxSignalIdType or Com_TxSignalIdType
+typedef uint16_t Com_SignalIdType;
+
+// Returned by Com_SendSignal and Com_ReceiveSignal when the module is not initialized
+#define COM_SERVICE_NOT_AVAILABLE   0x80u
+
+// Type of a signal, giving the size of the value read or written by the API
+#define COM_BOOLEAN             0u          // uint8_t, 0 or 1
+#define COM_UINT8               1u
+#define COM_UINT16              2u
+#define COM_UINT32              3u
+#define COM_SINT8               4u          // Sign extended from its length in bits
+#define COM_SINT16              5u
+#define COM_SINT32              6u
+
+// Byte order of a signal
+#define COM_LITTLE_ENDIAN       0u
+#define COM_BIG_ENDIAN          1u
+
+// Update bit of a signal without one
+#define COM_NO_UPDATE_BIT       0xFFFFu
+
+// Generated functions of an I-PDU. A pack function clears the update bits of its I-PDU, then
+// writes the signals set in Dirty (bit n for the n-th signal of the I-PDU) and sets their update
+// bits. An unpack function writes every signal of its I-PDU whose update bit is set.
+typedef void (*Com_PackFunctionType)(uint8_t* Data, const uint32_t* Values, uint32_t Dirty);
+typedef void (*Com_UnpackFunctionType)(const uint8_t* Data, uint32_t* Values);
+
+// Received I-PDU
+typedef struct {
+    uint8_t length;
+} Com_RxIpduConfigType;
+
+// Sent I-PDU
+typedef struct {
+    Can_HwHandleType hth;
+    Can_IdType id;
+    uint8_t length;
+    uint16_t period;                        // Calls of Com_MainFunctionTx, 0 if sent on change
+} Com_TxIpduConfigType;
+
+// Signal
+typedef struct {
+    uint8_t ipdu;                           // Com_RxIpduIdType or Com_TxIpduIdType
+    uint8_t type;                           // COM_BOOLEAN, COM_UINT8, ...
+} Com_SignalConfigType;
+
+// Configuration tables, defined in Com_Cfg.c
+extern const Com_RxIpduConfigType Com_RxIpduConfig[COM_NUM_RX_IPDUS];
+extern const Com_TxIpduConfigType Com_TxIpduConfig[COM_NUM_TX_IPDUS];
+extern const Com_SignalConfigType Com_RxSignalConfig[COM_NUM_RX_SIGNALS];
+extern const Com_SignalConfigType Com_TxSignalConfig[COM_NUM_TX_SIGNALS];
+
+// Functions and tables generated into Com_Pack_Cfg.c by Test/Com_Gen.c
+extern const Com_PackFunctionType Com_PackFunctions[COM_NUM_TX_IPDUS];
+extern const Com_UnpackFunctionType Com_UnpackFunctions[COM_NUM_RX_IPDUS];
+extern const uint32_t Com_TxSignalMask[COM_NUM_TX_SIGNALS];
+
+// Function prototypes
+void Com_Init(void);
+void Com_DeInit(void);
+uint8_t Com_SendSignal(Com_SignalIdType SignalId, const void* SignalDataPtr);
+uint8_t Com_ReceiveSignal(Com_SignalIdType SignalId, void* SignalDataPtr);
+void Com_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr);
+void Com_MainFunctionTx(void);
+
+#endif /* COM_H */
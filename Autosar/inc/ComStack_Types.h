@@ -0,0 +1,22 @@
+/*
+* File: ComStack_Types.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Types shared by the modules of the communication stack.
+*/
+
+#ifndef COMSTACK_TYPES_H
+#define COMSTACK_TYPES_H
+
+#include "Std_Types.h"
+
+typedef uint16_t PduIdType;         // Identifier of a PDU within a module
+typedef uint16_t PduLengthType;     // Length of a PDU in bytes
+
+// Data of a PDU
+typedef struct {
+    uint8_t* SduDataPtr;            // Payload
+    PduLengthType SduLength;        // Number of bytes of the payload
+} PduInfoType;
+
+#endif /* COMSTACK_TYPES_H */
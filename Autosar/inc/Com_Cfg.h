@@ -0,0 +1,105 @@
+/*
+* File: Com_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the COM module: the I-PDUs received through PduR and sent to the CAN
+* driver, and the signals they carry. Test/Com_Gen.c compiles the signal lists into the pack and
+* unpack functions of src/Com_Pack_Cfg.c; run "make -C Test com" after changing them.
+*/
+
+#ifndef COM_CFG_H
+#define COM_CFG_H
+
+// Received I-PDUs: name, length in bytes. Shorter frames are ignored. The frames carrying them are
+// routed to COM by PDUR_ROUTES in PduR_Cfg.h.
+#define COM_RX_IPDUS(X) \
+    X(COM_RX_IPDU_BRAKE,            8) \
+    X(COM_RX_IPDU_STEERING,         8) \
+    X(COM_RX_IPDU_WHEEL_SPEED_FL,   4) \
+    X(COM_RX_IPDU_WHEEL_SPEED_FR,   4) \
+    X(COM_RX_IPDU_YAW_RATE,         8) \
+    X(COM_RX_IPDU_GEAR,             2) \
+    X(COM_RX_IPDU_ODOMETER,         7) \
+    X(COM_RX_IPDU_EEC1,             8)
+
+// Sent I-PDUs: name, transmit hardware object, identifier, length in bytes, period in calls of
+// Com_MainFunctionTx (0: sent by Com_MainFunctionTx after a signal changed)
+#define COM_TX_IPDUS(X) \
+    X(COM_TX_IPDU_EXT_ADC,          CAN_HTH_CAN1,   0x123u,                         6,  0) \
+    X(COM_TX_IPDU_ECU_STATUS,       CAN_HTH_CAN1,   0x124u,                         8,  10) \
+    X(COM_TX_IPDU_TSC1,             CAN_HTH_CAN2,   CAN_ID_EXTENDED | 0x0C000017u,  8,  1)
+
+// Signals: name, I-PDU, type, start bit, length in bits, byte order, update bit. Bit n is bit
+// (n % 8) of byte (n / 8). A COM_LITTLE_ENDIAN signal starts at its least significant bit and goes
+// up; a COM_BIG_ENDIAN signal starts at its most significant bit and goes down, on to bit 7 of the
+// next byte. The update bit, COM_NO_UPDATE_BIT if none, is set in a sent I-PDU when the signal
+// changed since the last transmission; a received signal is only updated when it is set.
+#define COM_RX_SIGNALS(X) \
+    X(COM_SIG_BRAKE_PRESSURE,       COM_RX_IPDU_BRAKE,          COM_UINT16, 0,  16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_BRAKE_PEDAL,          COM_RX_IPDU_BRAKE,          COM_BOOLEAN, 16, 1, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_BRAKE_COUNTER,        COM_RX_IPDU_BRAKE,          COM_UINT8,  56, 4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_BRAKE_CHECKSUM,       COM_RX_IPDU_BRAKE,          COM_UINT8,  60, 4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_STEERING_ANGLE,       COM_RX_IPDU_STEERING,       COM_SINT16, 7,  16, COM_BIG_ENDIAN,     COM_NO_UPDATE_BIT) \
+    X(COM_SIG_STEERING_RATE,        COM_RX_IPDU_STEERING,       COM_SINT16, 23, 12, COM_BIG_ENDIAN,     32) \
+    X(COM_SIG_STEERING_STATUS,      COM_RX_IPDU_STEERING,       COM_UINT8,  27, 4,  COM_BIG_ENDIAN,     COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_SPEED_FL,       COM_RX_IPDU_WHEEL_SPEED_FL, COM_UINT16, 0,  14, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_DIRECTION_FL,   COM_RX_IPDU_WHEEL_SPEED_FL, COM_UINT8,  14, 2,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_PULSES_FL,      COM_RX_IPDU_WHEEL_SPEED_FL, COM_UINT16, 16, 16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_SPEED_FR,       COM_RX_IPDU_WHEEL_SPEED_FR, COM_UINT16, 0,  14, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_DIRECTION_FR,   COM_RX_IPDU_WHEEL_SPEED_FR, COM_UINT8,  14, 2,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_WHEEL_PULSES_FR,      COM_RX_IPDU_WHEEL_SPEED_FR, COM_UINT16, 16, 16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_YAW_RATE,             COM_RX_IPDU_YAW_RATE,       COM_SINT16, 7,  16, COM_BIG_ENDIAN,     COM_NO_UPDATE_BIT) \
+    X(COM_SIG_LATERAL_ACCEL,        COM_RX_IPDU_YAW_RATE,       COM_SINT16, 23, 16, COM_BIG_ENDIAN,     COM_NO_UPDATE_BIT) \
+    X(COM_SIG_LONGITUDINAL_ACCEL,   COM_RX_IPDU_YAW_RATE,       COM_SINT16, 36, 13, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_YAW_QUALIFIER,        COM_RX_IPDU_YAW_RATE,       COM_UINT8,  32, 2,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_GEAR_POSITION,        COM_RX_IPDU_GEAR,           COM_UINT8,  0,  4,  COM_LITTLE_ENDIAN,  8) \
+    X(COM_SIG_GEAR_TARGET,          COM_RX_IPDU_GEAR,           COM_UINT8,  4,  4,  COM_LITTLE_ENDIAN,  9) \
+    X(COM_SIG_ODOMETER,             COM_RX_IPDU_ODOMETER,       COM_UINT32, 0,  32, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TRIP,                 COM_RX_IPDU_ODOMETER,       COM_UINT32, 32, 24, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ENGINE_TORQUE_MODE,   COM_RX_IPDU_EEC1,           COM_UINT8,  0,  4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_DRIVER_DEMAND_TORQUE, COM_RX_IPDU_EEC1,           COM_UINT8,  8,  8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ACTUAL_TORQUE,        COM_RX_IPDU_EEC1,           COM_UINT8,  16, 8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ENGINE_SPEED,         COM_RX_IPDU_EEC1,           COM_UINT16, 24, 16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ENGINE_SOURCE,        COM_RX_IPDU_EEC1,           COM_UINT8,  40, 8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_STARTER_MODE,         COM_RX_IPDU_EEC1,           COM_UINT8,  48, 4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ENGINE_DEMAND_TORQUE, COM_RX_IPDU_EEC1,           COM_UINT8,  56, 8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT)
+
+#define COM_TX_SIGNALS(X) \
+    X(COM_SIG_EXT_ADC_0,            COM_TX_IPDU_EXT_ADC,        COM_UINT16, 0,  16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_EXT_ADC_1,            COM_TX_IPDU_EXT_ADC,        COM_UINT16, 16, 16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_EXT_ADC_2,            COM_TX_IPDU_EXT_ADC,        COM_UINT16, 32, 16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ECU_STATE,            COM_TX_IPDU_ECU_STATUS,     COM_UINT8,  0,  3,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ECU_FAULT,            COM_TX_IPDU_ECU_STATUS,     COM_BOOLEAN, 3, 1,  COM_LITTLE_ENDIAN,  4) \
+    X(COM_SIG_ECU_VOLTAGE,          COM_TX_IPDU_ECU_STATUS,     COM_UINT16, 15, 12, COM_BIG_ENDIAN,     COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ECU_TEMPERATURE,      COM_TX_IPDU_ECU_STATUS,     COM_SINT8,  24, 8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_ECU_BOOT_COUNT,       COM_TX_IPDU_ECU_STATUS,     COM_UINT32, 39, 24, COM_BIG_ENDIAN,     63) \
+    X(COM_SIG_ECU_ALIVE,            COM_TX_IPDU_ECU_STATUS,     COM_UINT8,  56, 4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TSC1_OVERRIDE_MODE,   COM_TX_IPDU_TSC1,           COM_UINT8,  0,  2,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TSC1_SPEED_CONDITION, COM_TX_IPDU_TSC1,           COM_UINT8,  2,  2,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TSC1_REQUESTED_SPEED, COM_TX_IPDU_TSC1,           COM_UINT16, 8,  16, COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TSC1_REQUESTED_TORQUE, COM_TX_IPDU_TSC1,          COM_UINT8,  24, 8,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT) \
+    X(COM_SIG_TSC1_CHECKSUM,        COM_TX_IPDU_TSC1,           COM_UINT8,  60, 4,  COM_LITTLE_ENDIAN,  COM_NO_UPDATE_BIT)
+
+#define COM_NAME(name, ...)     name,
+
+typedef enum {
+    COM_RX_IPDUS(COM_NAME)
+    COM_NUM_RX_IPDUS
+} Com_RxIpduIdType;
+
+typedef enum {
+    COM_TX_IPDUS(COM_NAME)
+    COM_NUM_TX_IPDUS
+} Com_TxIpduIdType;
+
+typedef enum {
+    COM_RX_SIGNALS(COM_NAME)
+    COM_NUM_RX_SIGNALS
+} Com_RxSignalIdType;
+
+typedef enum {
+    COM_TX_SIGNALS(COM_NAME)
+    COM_NUM_TX_SIGNALS
+} Com_TxSignalIdType;
+
+#endif /* COM_CFG_H */
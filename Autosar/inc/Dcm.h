@@ -0,0 +1,68 @@
+/*
+* File: Dcm.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the DCM module, the diagnostic services of the tester received through
+* CanTp: ReadDataByIdentifier and WriteDataByIdentifier on the data identifiers of Dcm_Cfg.h, and
+* the download of an image into the flash with RequestDownload, TransferData and
+* RequestTransferExit. The data of a TransferData are programmed from the buffer CanTp received
+* them in, by a job of the FLS driver, and the positive response is sent as soon as another buffer
+* is free: the tester sends block N + 1 while block N is programmed. RequestDownload answers with a
+* response pending at once and queues the erase once it is sent, since the CPU stalls on the flash
+* until the erase ends; the positive response follows the erase.
+*/
+
+#ifndef DCM_H
+#define DCM_H
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "CanTp.h"
+#include "Gpt.h"
+#include "Fls.h"
+#include "NvM.h"
+#include "Dcm_Cfg.h"
+
+// Data identifier
+typedef struct {
+    uint16_t id;
+    uint8_t* data;
+    uint16_t length;
+    uint8_t writable;                       // Written by WriteDataByIdentifier
+    uint8_t nvmBlock;                       // NVM block written after WriteDataByIdentifier, 0 if none
+} Dcm_DidConfigType;
+
+// Configuration of the module
+typedef struct {
+    const Dcm_DidConfigType* dids;
+    uint8_t numDids;
+    uint8_t buffers;                        // Buffers of the requests used, 1 to DCM_NUM_BUFFERS;
+                                            // 1 programs each block before answering it
+} Dcm_ConfigType;
+
+// Counters of the module
+typedef struct {
+    uint32_t requests;                      // Requests received
+    uint32_t negativeResponses;             // Negative responses sent, response pending excluded
+    uint32_t responsesPending;              // Response pending sent while a response waited
+    uint32_t blocks;                        // TransferData blocks programmed
+    uint32_t bytesProgrammed;
+    uint32_t programmingFailures;           // Downloads ended by a failed FLS job
+} Dcm_StatsType;
+
+// Configuration, defined in Dcm_Cfg.c
+extern const Dcm_DidConfigType Dcm_DidConfig[DCM_NUM_DIDS];
+extern const Dcm_ConfigType Dcm_Config;
+// Upper layer of CanTp, passed to CanTp_Init
+extern const CanTp_ConfigType Dcm_CanTpConfig;
+
+// Function prototypes
+void Dcm_Init(const Dcm_ConfigType* ConfigPtr);
+void Dcm_DeInit(void);
+uint8_t* Dcm_StartOfReception(CanTp_ConnectionType Connection, PduLengthType Length);
+void Dcm_TpRxIndication(CanTp_ConnectionType Connection, Std_ReturnType Result);
+void Dcm_TpTxConfirmation(CanTp_ConnectionType Connection, Std_ReturnType Result);
+void Dcm_MainFunction(void);
+Std_ReturnType Dcm_GetStats(Dcm_StatsType* StatsPtr);
+
+#endif /* DCM_H */
@@ -0,0 +1,46 @@
+/*
+* File: Dcm_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the DCM module: the data identifiers, listed in Dcm_Cfg.c, the
+* download area and the buffers of TransferData, and the response times.
+*/
+
+#ifndef DCM_CFG_H
+#define DCM_CFG_H
+
+// Data identifiers: name, identifier, data, length, written by WriteDataByIdentifier, NVM block
+// written after it or 0. The data are RAM blocks of NvM_Cfg.h.
+#define DCM_DIDS(X) \
+    X(DCM_DID_BOOT_COUNT,   0x0100u,    &App_BootCount,     4u,     0,  0) \
+    X(DCM_DID_CALIBRATION,  0x0101u,    App_Calibration,    64u,    1,  NVM_BLOCK_CALIBRATION)
+
+// Download area, in FLS addresses: sector 5. RequestDownload takes the memory address of the
+// device, FLASH_BASE added.
+#define DCM_DOWNLOAD_ADDRESS    0x20000u
+#define DCM_DOWNLOAD_SIZE       0x20000u
+
+// Longest TransferData request, service identifier and block sequence counter included. It fits a
+// 12-bit first frame of CanTp, and its 4088 data bytes are a multiple of the double word.
+#define DCM_MAX_BLOCK_LENGTH    4090u
+
+// Buffers of the requests: one receives the next TransferData while the others are programmed.
+// The FLS queue holds the erase and one job per buffer.
+#define DCM_NUM_BUFFERS         2u
+
+// Response times in GPT ticks: a response not ready after DCM_P2 is announced by a response
+// pending, repeated every DCM_P2_STAR. DCM_P2 stays below the 50 ms of the tester.
+#define DCM_P2                  GPT_MS(40u)
+#define DCM_P2_STAR             GPT_MS(2000u)
+
+// Longest response other than a response pending: ReadDataByIdentifier of the longest data
+#define DCM_MAX_RESPONSE_LENGTH 67u
+
+#define DCM_DID_NAME(name, ...)     name,
+
+typedef enum {
+    DCM_DIDS(DCM_DID_NAME)
+    DCM_NUM_DIDS
+} Dcm_DidType;
+
+#endif /* DCM_CFG_H */
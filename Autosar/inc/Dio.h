@@ -9,6 +9,8 @@ configurations and functions for controlling individual channels, channel groups
 #define DIO_H_
 
 #include <stdint.h>
+#include "stm32f4xx.h"
+#include "Dio_Cfg.h"
 
 // Define GPIO_MODER_MODE0_0 macro
 #define GPIO_MODER_MODE0_0    (0x1 << (0 * 2))
@@ -24,26 +26,53 @@ configurations and functions for controlling individual channels, channel groups
 #define SW_MINOR_VERSION    0
 #define SW_PATCH_VERSION    0
 
-/* Base Addresses for GPIO Ports */
-#define GPIOA_BASE          ((Dio_PortType)GPIOA)
-#define GPIOB_BASE          ((Dio_PortType)GPIOB)
-
 /* Standard Logic Levels */
 #define STD_HIGH            ((Dio_LevelType)1)
 #define STD_LOW             ((Dio_LevelType)0)
 
 /* Data Types */
 typedef uint8_t Dio_ChannelType;            /* Type for individual channel */
-typedef uint16_t Dio_PortType;              /* Type for GPIO port */
+typedef uint8_t Dio_PortType;               /* Type for GPIO port, DIO_PORT_A..DIO_PORT_I */
 typedef uint16_t Dio_PortLevelType;         /* Type for port level */
 typedef uint16_t Dio_LevelType;             /* Type for logic level */
 
 /* Structure for Channel Group */
 typedef struct {
     Dio_PortType port;                  /* Port ID */
-    Dio_ChannelType mask;               /* Channel Mask */
+    Dio_PortLevelType mask;             /* Channel Mask, one bit per pin 0..15 */
 } Dio_ChannelGroupType;
 
+/* Channel table entry: a write is a single store of setMask or resetMask to port->BSRR. GPIO
+   registers are accessed through the CMSIS READ_REG/WRITE_REG macros, which the host build maps
+   onto its register model. */
+typedef struct {
+    GPIO_TypeDef* port;                 /* GPIO register block of the channel */
+    uint32_t setMask;                   /* BSRR word driving the pin high */
+    uint32_t resetMask;                 /* BSRR word driving the pin low */
+} Dio_ChannelConfigType;
+
+/* Register block of a port, the GPIO blocks are 0x400 apart */
+#define DIO_PORT_STRIDE             0x400u
+#define DIO_PORT_REGS(port)         ((GPIO_TypeDef*)((uint8_t*)GPIOA + ((uint32_t)(port) * DIO_PORT_STRIDE)))
+
+/* Port, pin and BSRR words of a channel ID */
+#define DIO_CHANNEL_PORT(ch)        ((uint32_t)(ch) >> 4)
+#define DIO_CHANNEL_PIN(ch)         ((uint32_t)(ch) & 0x0Fu)
+#define DIO_BSRR_SET(ch)            ((uint32_t)1 << DIO_CHANNEL_PIN(ch))
+#define DIO_BSRR_RESET(ch)          ((uint32_t)1 << (DIO_CHANNEL_PIN(ch) + 16u))
+
+/* BSRR word driving the pins of Mask to Level in one store: set half from the 1 bits, reset half
+   from the 0 bits, pins outside Mask untouched */
+#define DIO_BSRR_MASKED(level, mask) \
+    ((uint32_t)((level) & (mask) & 0xFFFFu) | ((uint32_t)(~(level) & (mask) & 0xFFFFu) << 16))
+
+/* Single-store writes for channel IDs known at compile time, e.g. DIO_CHANNEL_HIGH(DIO_CHANNEL_CS_ACCEL) */
+#define DIO_CHANNEL_HIGH(ch)        WRITE_REG(DIO_PORT_REGS(DIO_CHANNEL_PORT(ch))->BSRR, DIO_BSRR_SET(ch))
+#define DIO_CHANNEL_LOW(ch)         WRITE_REG(DIO_PORT_REGS(DIO_CHANNEL_PORT(ch))->BSRR, DIO_BSRR_RESET(ch))
+
+/* Channel table, defined in Dio_Cfg.c */
+extern const Dio_ChannelConfigType Dio_ChannelConfig[DIO_NUM_CHANNELS];
+
 /* Version Information Structure */
 typedef struct {
     uint16_t vendorID;                  /* Vendor ID */
@@ -61,5 +90,54 @@ void Dio_WriteChannelGroup(const Dio_ChannelGroupType* ChannelGroupIdPtr, Dio_Po
 void Dio_GetVersionInfo(Std_VersionInfoType* VersionInfo);
 Dio_LevelType Dio_FlipChannel(Dio_ChannelType ChannelId);
 void Dio_MaskedWritePort(Dio_PortType PortId, Dio_PortLevelType Level, Dio_PortLevelType Mask);
+Dio_PortLevelType Dio_ReadPort(Dio_PortType PortId);
+void Dio_WritePort(Dio_PortType PortId, Dio_PortLevelType Level);
+Dio_PortLevelType Dio_FlipChannels(Dio_PortType PortId, Dio_PortLevelType Mask);
+
+/*
+* Function: Dio_WriteChannelInline
+* Description: Inline Dio_WriteChannel computing the register block and BSRR word from the channel ID,
+*   so a constant ChannelId and Level compile to one store of an immediate to BSRR.
+* Input:
+*   - ChannelId: The ID of the channel to be written, below DIO_NUM_CHANNELS.
+*   - Level: The desired state (STD_HIGH or STD_LOW) to be set on the channel.
+* Output: None
+*/
+__STATIC_INLINE void Dio_WriteChannelInline(Dio_ChannelType ChannelId, Dio_LevelType Level)
+{
+    WRITE_REG(DIO_PORT_REGS(DIO_CHANNEL_PORT(ChannelId))->BSRR, (Level == STD_HIGH) ? DIO_BSRR_SET(ChannelId) : DIO_BSRR_RESET(ChannelId));
+}
+
+/*
+* Function: Dio_FlipChannelInline
+* Description: Inline Dio_FlipChannel: one load of ODR and one store to BSRR, without branches for a
+*   constant ChannelId.
+* Input:
+*   - ChannelId: Identifier of the channel to toggle, below DIO_NUM_CHANNELS.
+* Output:
+*   - Returns the new state of the channel (STD_HIGH or STD_LOW).
+*/
+__STATIC_INLINE Dio_LevelType Dio_FlipChannelInline(Dio_ChannelType ChannelId)
+{
+    GPIO_TypeDef* gpio = DIO_PORT_REGS(DIO_CHANNEL_PORT(ChannelId));
+    uint32_t high = (READ_REG(gpio->ODR) >> DIO_CHANNEL_PIN(ChannelId)) & 1u;
+
+    /* A high latch selects the reset half of BSRR, a low one the set half */
+    WRITE_REG(gpio->BSRR, DIO_BSRR_SET(ChannelId) << (high << 4));
+    return (Dio_LevelType)(high ^ 1u);
+}
+
+/*
+* Function: Dio_ReadChannelInline
+* Description: Inline Dio_ReadChannel, a single load of IDR.
+* Input:
+*   - ChannelId: Identifier of the channel to read, below DIO_NUM_CHANNELS.
+* Output:
+*   - Returns the state of the specified channel (STD_HIGH or STD_LOW)
+*/
+__STATIC_INLINE Dio_LevelType Dio_ReadChannelInline(Dio_ChannelType ChannelId)
+{
+    return (READ_REG(DIO_PORT_REGS(DIO_CHANNEL_PORT(ChannelId))->IDR) & DIO_BSRR_SET(ChannelId)) ? STD_HIGH : STD_LOW;
+}
 
 #endif /* DIO_H_ */
@@ -0,0 +1,39 @@
+/*
+* File: Dio_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Port and channel configuration of the DIO driver. A channel ID encodes its port and
+* pin as port * 16 + pin, so channels 0..15 are PA0..PA15, 16..31 are PB0..PB15 and so on up to PI15.
+*/
+#ifndef DIO_CFG_H_
+#define DIO_CFG_H_
+
+/* Port IDs, in the order of the GPIO register blocks on AHB1. The STM32F407 stops at GPIOI. */
+#define DIO_PORT_A              0
+#define DIO_PORT_B              1
+#define DIO_PORT_C              2
+#define DIO_PORT_D              3
+#define DIO_PORT_E              4
+#define DIO_PORT_F              5
+#define DIO_PORT_G              6
+#define DIO_PORT_H              7
+#define DIO_PORT_I              8
+
+#define DIO_NUM_PORTS           9
+#define DIO_PINS_PER_PORT       16
+#define DIO_NUM_CHANNELS        (DIO_NUM_PORTS * DIO_PINS_PER_PORT)
+
+/* Channel ID of a pin */
+#define DIO_CHANNEL(port, pin)  (((port) << 4) | (pin))
+
+/* Channels used by the application */
+#define DIO_CHANNEL_LED_A               DIO_CHANNEL(DIO_PORT_A, 0)
+#define DIO_CHANNEL_LED_B               DIO_CHANNEL(DIO_PORT_B, 0)
+#define DIO_CHANNEL_CS_EEPROM           DIO_CHANNEL(DIO_PORT_C, 4)
+#define DIO_CHANNEL_CS_ACCEL            DIO_CHANNEL(DIO_PORT_A, 4)
+#define DIO_CHANNEL_CS_EXT_ADC          DIO_CHANNEL(DIO_PORT_A, 8)
+#define DIO_CHANNEL_CS_BARO             DIO_CHANNEL(DIO_PORT_A, 15)
+#define DIO_CHANNEL_CS_GYRO             DIO_CHANNEL(DIO_PORT_B, 12)
+#define DIO_CHANNEL_CS_GATEWAY          DIO_CHANNEL(DIO_PORT_B, 1)
+
+#endif /* DIO_CFG_H_ */
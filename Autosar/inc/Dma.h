@@ -0,0 +1,21 @@
+/*
+* File: Dma.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Ownership of the DMA streams shared by several drivers. A driver claims the streams
+* it is about to program and releases them when it stops using them, so two drivers configured
+* on the same stream refuse each other instead of corrupting their transfers. Neither driver needs
+* to know the other.
+*/
+
+#ifndef DMA_H
+#define DMA_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+
+// Function prototypes
+Std_ReturnType Dma_ClaimStreams(DMA_Stream_TypeDef* RxStream, DMA_Stream_TypeDef* TxStream);
+void Dma_ReleaseStreams(DMA_Stream_TypeDef* RxStream, DMA_Stream_TypeDef* TxStream);
+
+#endif /* DMA_H */
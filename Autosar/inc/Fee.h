@@ -0,0 +1,55 @@
+/*
+* File: Fee.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the FEE module, emulating an EEPROM of numbered blocks on sectors of the
+* internal flash. Each write appends a record holding the block to the log; a RAM index maps each
+* block to its latest record, built by one scan of the log in Fee_Init, so a read costs one lookup.
+* When no erased sector is left, Fee_MainFunction copies the latest records of the oldest sector a few
+* at a time and erases it in the background.
+*   The flash can neither be read nor programmed during an erase: a job waits for the erase in
+* progress, up to 2 s for a 128 KB sector.
+*/
+
+#ifndef FEE_H
+#define FEE_H
+
+#include "Fls.h"
+#include "Fee_Cfg.h"
+
+// Sector of the log
+typedef struct {
+    Fls_AddressType address;                // A sector of Fls_SectorList
+    Fls_LengthType size;
+} Fee_SectorType;
+
+// Block of the emulated EEPROM
+typedef struct {
+    uint16_t blockNumber;                   // Any value but 0xFFFF
+    uint16_t blockSize;                     // Bytes, up to FEE_MAX_BLOCK_SIZE
+} Fee_BlockType;
+
+// Configuration of the module
+typedef struct {
+    const Fee_BlockType* blocks;            // Latest records of all blocks fit in one sector
+    uint16_t numBlocks;                     // Up to FEE_INDEX_SIZE / 2
+    void (*jobEndNotification)(void);       // NULL if unused
+    void (*jobErrorNotification)(void);     // NULL if unused
+} Fee_ConfigType;
+
+// Configuration, defined in Fee_Cfg.c
+extern const Fee_SectorType Fee_SectorList[FEE_NUM_SECTORS];
+extern const Fee_BlockType Fee_BlockList[FEE_NUM_BLOCKS];
+extern const Fee_ConfigType Fee_Config;
+
+// Function prototypes
+void Fee_Init(const Fee_ConfigType* ConfigPtr);
+Std_ReturnType Fee_Read(uint16_t BlockNumber, uint16_t BlockOffset, uint8_t* DataBufferPtr, uint16_t Length);
+Std_ReturnType Fee_Write(uint16_t BlockNumber, const uint8_t* DataBufferPtr);
+Std_ReturnType Fee_InvalidateBlock(uint16_t BlockNumber);
+void Fee_Cancel(void);
+MemIf_StatusType Fee_GetStatus(void);
+MemIf_JobResultType Fee_GetJobResult(void);
+void Fee_MainFunction(void);
+
+#endif /* FEE_H */
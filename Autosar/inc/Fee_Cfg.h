@@ -0,0 +1,38 @@
+/*
+* File: Fee_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the FEE module: the flash sectors holding the log of records, listed
+* in Fee_Cfg.c with the blocks of the application, and the sizes of the index and of the work done
+* per call of Fee_MainFunction.
+*/
+
+#ifndef FEE_CFG_H
+#define FEE_CFG_H
+
+/* Sectors of the log, erased and programmed through the FLS driver: sectors 6 and 7. Sector 5 is
+   the download area of the DCM module. */
+#define FEE_NUM_SECTORS         2
+
+/* Slots of the RAM index, a power of two holding at least twice the blocks of a configuration */
+#define FEE_INDEX_BITS          6
+#define FEE_INDEX_SIZE          (1u << FEE_INDEX_BITS)
+
+/* Largest block, a multiple of 8 bytes */
+#define FEE_MAX_BLOCK_SIZE      256u
+
+/* Record headers examined by one step of the garbage collection */
+#define FEE_GC_HEADERS          16u
+
+/* Blocks of the application, listed in Fee_Cfg.c */
+#define FEE_NUM_BLOCKS          3
+#define FEE_BLOCK_BOOT_COUNT    1u
+#define FEE_BLOCK_CALIBRATION   2u
+#define FEE_BLOCK_DTC           3u
+
+/* Notifications of the end of a job and of a failed job, implemented by the user of the module and
+   called from Fee_MainFunction */
+void FeeJob_EndNotification(void);
+void FeeJob_ErrorNotification(void);
+
+#endif /* FEE_CFG_H */
@@ -0,0 +1,68 @@
+/*
+* File: Fls.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the FLS driver, erasing and programming the internal flash without
+* waiting for it. Fls_Erase, Fls_Write, Fls_Read and Fls_Compare queue a job and return; the jobs
+* run in order, each erase or program operation being started by the end-of-operation interrupt of
+* the previous one, or by Fls_MainFunction, which also copies the data of reads and compares and
+* reports the end of the jobs. Each job belongs to a user: a failed job drops the pending jobs of its
+* user only, and each user has a result of its own. Units are programmed in the widest parallelism the supply allows:
+* words at 2.7 to 3.6 V, double words with VPP.
+*   The STM32F407 has a single bank: a read of the flash stalls until the operation in progress
+* ends. The code running during an erase must execute from RAM to keep running; none does in this
+* tree, so an erase stalls the CPU and its interrupts for 1 to 2 s per 128 kB sector.
+*/
+
+#ifndef FLS_H
+#define FLS_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "MemIf_Types.h"
+#include "Fls_Cfg.h"
+#include <stddef.h>
+
+typedef uint32_t Fls_AddressType;           // Offset from FLASH_BASE
+typedef uint32_t Fls_LengthType;            // Number of bytes
+typedef uint8_t Fls_UserType;               // FLS_USER_x of Fls_Cfg.h
+
+// Sector the driver may erase and program
+typedef struct {
+    uint16_t flashSector;                   // FLASH_Sector_x
+    Fls_AddressType address;
+    Fls_LengthType size;
+} Fls_SectorType;
+
+// Configuration of the driver
+typedef struct {
+    uint8_t voltageRange;                   // VoltageRange_3: x32, VoltageRange_4: x64
+    uint8_t useInterrupt;                   // Operations chained by the end-of-operation interrupt
+    Fls_LengthType maxRead;                 // Bytes read or compared per Fls_MainFunction
+    Fls_LengthType maxWrite;                // Bytes programmed per Fls_MainFunction without interrupt
+    void (*jobEndNotification)(Fls_UserType User);      // NULL if unused
+    void (*jobErrorNotification)(Fls_UserType User);    // NULL if unused
+} Fls_ConfigType;
+
+// Configuration, defined in Fls_Cfg.c
+extern const Fls_SectorType Fls_SectorList[FLS_NUM_SECTORS];
+extern const Fls_ConfigType Fls_Config;
+
+// Function prototypes
+void Fls_Init(const Fls_ConfigType* ConfigPtr);
+Std_ReturnType Fls_Erase(Fls_UserType User, Fls_AddressType TargetAddress, Fls_LengthType Length);
+Std_ReturnType Fls_Write(Fls_UserType User, Fls_AddressType TargetAddress, const uint8_t* SourceAddressPtr,
+                         Fls_LengthType Length);
+Std_ReturnType Fls_Read(Fls_UserType User, Fls_AddressType SourceAddress, uint8_t* TargetAddressPtr,
+                        Fls_LengthType Length);
+Std_ReturnType Fls_Compare(Fls_UserType User, Fls_AddressType SourceAddress, const uint8_t* TargetAddressPtr,
+                           Fls_LengthType Length);
+void Fls_Cancel(Fls_UserType User);
+MemIf_StatusType Fls_GetStatus(void);
+MemIf_JobResultType Fls_GetJobResult(Fls_UserType User);
+uint8_t Fls_GetPendingJobs(Fls_UserType User);
+uint8_t Fls_GetFreeJobs(void);
+Fls_LengthType Fls_GetPageSize(void);
+void Fls_MainFunction(void);
+
+#endif /* FLS_H */
@@ -0,0 +1,43 @@
+/*
+* File: Fls_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the FLS driver: the sectors it may erase and program, listed in
+* Fls_Cfg.c, the supply range setting the programming parallelism and the work done per call of
+* Fls_MainFunction.
+*/
+
+#ifndef FLS_CFG_H
+#define FLS_CFG_H
+
+/* Sectors 5..7 of the STM32F407VE, 128 KB each; the application is linked below 0x08020000 */
+#define FLS_NUM_SECTORS         3
+
+/* Supply of the device: VoltageRange_3 (2.7 to 3.6 V) programs words, VoltageRange_4 (VPP applied)
+   double words. The lower ranges program bytes or half words and are not supported. */
+#define FLS_VOLTAGE_RANGE       VoltageRange_3
+
+/* Users of the driver, each with its own jobs and result */
+#define FLS_USER_FEE            0u
+#define FLS_USER_DCM            1u
+#define FLS_NUM_USERS           2u
+
+/* Jobs accepted while others are pending */
+#define FLS_JOB_QUEUE_SIZE      4u
+
+/* Bytes copied or compared by Fls_MainFunction per call */
+#define FLS_MAX_READ            1024u
+/* Bytes programmed by Fls_MainFunction per call when the end-of-operation interrupt is not used:
+   16 words wait 256 us for the flash */
+#define FLS_MAX_WRITE           64u
+
+/* Erase and program operations chained by the end-of-operation interrupt instead of
+   Fls_MainFunction */
+#define FLS_USE_INTERRUPT       1u
+
+/* Notifications of the end of each job and of a failed job, with the user of the job, implemented by
+   the application and called from Fls_MainFunction */
+void FlsJob_EndNotification(uint8_t User);
+void FlsJob_ErrorNotification(uint8_t User);
+
+#endif /* FLS_CFG_H */
@@ -0,0 +1,79 @@
+/*
+* File: Gpt.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the GPT driver. Every channel and every software timer is an entry
+* of a hierarchical timer wheel driven by one free-running timer: starting or stopping a timer
+* takes constant time whatever the number of timers, and the compare interrupt is only raised at
+* the next expiry, so the core can sleep until then instead of counting in a delay loop.
+*/
+
+#ifndef GPT_H
+#define GPT_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Gpt_Cfg.h"
+#include <stddef.h>
+
+typedef uint8_t Gpt_ChannelType;            // GPT_CHANNEL_x
+typedef uint32_t Gpt_ValueType;             // Duration in ticks, see GPT_TICKS_PER_MS
+
+// Longest duration of a channel or timer, about 17 minutes at 1 us per tick
+#define GPT_MAX_VALUE   0x3FFFFFFFu
+
+// Mode of a channel
+typedef enum {
+    GPT_CH_MODE_CONTINUOUS,     // Restarted with the same duration at each expiry
+    GPT_CH_MODE_ONESHOT         // Stops at its expiry
+} Gpt_ChannelModeType;
+
+// Configuration of a channel
+typedef struct {
+    Gpt_ChannelModeType mode;
+    void (*notification)(void);             // Called from the timer interrupt at expiry, NULL if unused
+} Gpt_ChannelConfigType;
+
+// Called from the timer interrupt when a software timer expires
+typedef void (*Gpt_TimerCallbackType)(void* Context);
+
+// Software timer, owned by the caller and linked into the wheel while it runs. Its fields are
+// private to the driver.
+typedef struct Gpt_TimerTag {
+    struct Gpt_TimerTag* next;
+    struct Gpt_TimerTag** prev;             // Link pointing at this timer, NULL while stopped
+    uint32_t expiry;                        // Tick of the next expiry
+    Gpt_ValueType period;                   // 0 for a one-shot timer
+    Gpt_TimerCallbackType callback;
+    void* context;                          // Passed to the callback
+    uint8_t slot;                           // Wheel slot holding the timer
+} Gpt_TimerType;
+
+// Counters of the driver
+typedef struct {
+    uint32_t interrupts;                    // Compare interrupts served
+    uint32_t expirations;                   // Callbacks run
+    uint32_t cascades;                      // Timers moved down a level of the wheel
+} Gpt_StatsType;
+
+// Configuration table, defined in Gpt_Cfg.c
+extern const Gpt_ChannelConfigType Gpt_ChannelConfig[GPT_MAX_CHANNEL];
+
+// Function prototypes
+void Gpt_Init(const Gpt_ChannelConfigType* ConfigPtr);
+void Gpt_DeInit(void);
+Std_ReturnType Gpt_StartTimer(Gpt_ChannelType Channel, Gpt_ValueType Value);
+Std_ReturnType Gpt_StopTimer(Gpt_ChannelType Channel);
+Gpt_ValueType Gpt_GetTimeElapsed(Gpt_ChannelType Channel);
+Gpt_ValueType Gpt_GetTimeRemaining(Gpt_ChannelType Channel);
+void Gpt_EnableNotification(Gpt_ChannelType Channel);
+void Gpt_DisableNotification(Gpt_ChannelType Channel);
+Std_ReturnType Gpt_GetPredefTimerValue(uint32_t* TimeValuePtr);
+Std_ReturnType Gpt_TimerStart(Gpt_TimerType* Timer, Gpt_ValueType Value, Gpt_ValueType Period,
+                              Gpt_TimerCallbackType Callback, void* Context);
+void Gpt_TimerStop(Gpt_TimerType* Timer);
+uint8_t Gpt_TimerIsRunning(const Gpt_TimerType* Timer);
+void Gpt_Delay(Gpt_ValueType Value);
+Std_ReturnType Gpt_GetStats(Gpt_StatsType* StatsPtr);
+
+#endif /* GPT_H */
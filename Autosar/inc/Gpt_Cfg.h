@@ -0,0 +1,41 @@
+/*
+* File: Gpt_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the GPT driver: the hardware timer behind the software timers, the
+* length of a tick and the channels defined in Gpt_Cfg.c.
+*/
+
+#ifndef GPT_CFG_H
+#define GPT_CFG_H
+
+/* Free-running 32-bit timer. Its compare channel 1 is set to the next expiry of the timer wheel. */
+#define GPT_TIMER               TIM2
+#define GPT_TIMER_CLOCK         RCC_APB1Periph_TIM2
+#define GPT_TIMER_IRQn          TIM2_IRQn
+#define GPT_TIMER_IRQHandler    TIM2_IRQHandler
+
+/* One tick per microsecond: the APB1 timer clock (84 MHz) divided by GPT_TIMER_PRESCALER + 1 */
+#define GPT_TICKS_PER_MS        1000u
+#define GPT_TIMER_PRESCALER     (84000000u / (GPT_TICKS_PER_MS * 1000u) - 1u)
+
+/* Ticks of a duration in milliseconds */
+#define GPT_MS(ms)              ((ms) * GPT_TICKS_PER_MS)
+
+/* Channels */
+#define GPT_CHANNEL_LED         0   /* Continuous, toggles the LEDs */
+#define GPT_CHANNEL_MAIN_CYCLE  1   /* Continuous, starts a cycle of the main loop */
+#define GPT_CHANNEL_COM_CYCLE   2   /* Continuous, starts a cycle of the CAN, diagnostic and flash stack */
+#define GPT_MAX_CHANNEL         3
+
+/* Period of GPT_CHANNEL_COM_CYCLE, draining the CAN receive queues. At 1 Mbit/s CAN1 delivers an
+   8-byte frame every 111 us at most, so a queue of CAN_RX_QUEUE_SIZE (32) frames overflows after
+   3.5 ms of back-to-back frames; drained every 1 ms it holds 9 at most, and a block of CANTP_DIAG_BS
+   consecutive frames waits 1 ms at most for its next flow control.
+   The drain stops while the flash erases a sector: nothing runs from RAM, so the CPU, its CAN
+   interrupts included, stalls for the 1 to 2 s of a 128 kB erase and the 3-frame FIFO of the
+   controller overflows. RequestDownload erases sector 5 only once its response pending is sent, and
+   the tester waits for the final response; frames received while Fee erases sector 6 or 7 are lost. */
+#define GPT_COM_CYCLE_MS        1u
+
+#endif /* GPT_CFG_H */
@@ -0,0 +1,88 @@
+/*
+* File: Icu.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the ICU driver, measuring input signals with the input capture of
+* the timers. A timestamp channel captures the counter of a 32-bit timer at every edge and a DMA
+* stream moves each capture into the buffer of the application, so the CPU only runs at the
+* notifications, every NotifyInterval edges. A signal measurement channel runs the timer in PWM
+* input mode: each active edge restarts the counter, and a DMA burst copies the period and the
+* active time of the period just ended, so reading them takes no interrupt at all.
+*/
+
+#ifndef ICU_H
+#define ICU_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Icu_Cfg.h"
+#include <stddef.h>
+
+// Number of ICU hardware units
+#define NUM_OF_ICU_HW_UNITS 2
+
+// Definition of ICU hardware units
+typedef enum {
+    ICU_HWUnit_0,       // TIM5 CH4
+    ICU_HWUnit_1        // TIM8 CH2, with CH1 on the same input
+} Icu_HWUnitType;
+
+typedef uint8_t Icu_ChannelType;            // ICU_CHANNEL_x
+typedef uint32_t Icu_ValueType;             // Timer ticks
+typedef uint16_t Icu_IndexType;             // Index in a timestamp buffer
+
+// Edges measured
+typedef enum {
+    ICU_RISING_EDGE,
+    ICU_FALLING_EDGE,
+    ICU_BOTH_EDGES          // Timestamp channels only
+} Icu_ActivationType;
+
+// Measurement of a channel
+typedef enum {
+    ICU_MODE_TIMESTAMP,             // Counter value at each edge, into a buffer
+    ICU_MODE_SIGNAL_MEASUREMENT     // Period and active time of the last complete period
+} Icu_MeasurementModeType;
+
+// Use of a timestamp buffer
+typedef enum {
+    ICU_LINEAR_BUFFER,      // Capture stops once the buffer is full
+    ICU_CIRCULAR_BUFFER     // The buffer is refilled from the start until the channel is stopped
+} Icu_TimestampBufferType;
+
+// Period and active time, in timer ticks
+typedef struct {
+    Icu_ValueType ActiveTime;               // From an active edge to the next opposite edge
+    Icu_ValueType PeriodTime;               // Between two active edges
+} Icu_DutyCycleType;
+
+// Configuration of a channel, one channel per hardware unit
+typedef struct {
+    Icu_HWUnitType hwUnit;                  // Timer and input of the channel
+    Icu_MeasurementModeType measurementMode;
+    Icu_ActivationType defaultStartEdge;    // Edges timestamped, or active edge of a period
+    uint16_t prescaler;                     // Timer clock divided by prescaler + 1
+    uint8_t filter;                         // ICxF input filter, 0 to 15
+    Icu_TimestampBufferType bufferType;     // Timestamp channels only
+    void (*notification)(void);             // NotifyInterval timestamps stored, NULL if unused
+} Icu_ChannelConfigType;
+
+// Configuration table, defined in Icu_Cfg.c
+extern const Icu_ChannelConfigType Icu_ChannelConfig[ICU_MAX_CHANNEL];
+
+// Function prototypes
+void Icu_Init(const Icu_ChannelConfigType* ConfigPtr);
+void Icu_DeInit(void);
+Std_ReturnType Icu_SetActivationCondition(Icu_ChannelType Channel, Icu_ActivationType Activation);
+void Icu_EnableNotification(Icu_ChannelType Channel);
+void Icu_DisableNotification(Icu_ChannelType Channel);
+Std_ReturnType Icu_StartTimestamp(Icu_ChannelType Channel, Icu_ValueType* BufferPtr, Icu_IndexType BufferSize,
+                                  Icu_IndexType NotifyInterval);
+Std_ReturnType Icu_StopTimestamp(Icu_ChannelType Channel);
+Icu_IndexType Icu_GetTimestampIndex(Icu_ChannelType Channel);
+Std_ReturnType Icu_StartSignalMeasurement(Icu_ChannelType Channel);
+Std_ReturnType Icu_StopSignalMeasurement(Icu_ChannelType Channel);
+Icu_ValueType Icu_GetTimeElapsed(Icu_ChannelType Channel);
+void Icu_GetDutyCycleValues(Icu_ChannelType Channel, Icu_DutyCycleType* DutyCycleValues);
+
+#endif /* ICU_H */
@@ -0,0 +1,31 @@
+/*
+* File: Icu_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the ICU driver: symbolic names and number of the channels defined
+* in Icu_Cfg.c, the resolution of their timers and the input filters.
+*/
+
+#ifndef ICU_CFG_H
+#define ICU_CFG_H
+
+/* Channels */
+#define ICU_CHANNEL_ENCODER         0   /* TIM5 CH4 on PA3: timestamps of the encoder edges */
+#define ICU_CHANNEL_PWM_IN          1   /* TIM8 CH2 on PC7: period and duty cycle */
+#define ICU_MAX_CHANNEL             2
+
+/* TIM5 counts the APB1 timer clock (84 MHz): a 32-bit timestamp wraps after 51 s */
+#define ICU_ENCODER_PRESCALER       0u
+/* TIM8 counts the APB2 timer clock (168 MHz) / 2: 16 bits measure periods of up to 780 us, that is
+   signals down to 1.3 kHz */
+#define ICU_PWM_IN_PRESCALER        1u
+
+/* ICxF input filters: 0 samples every timer clock, 3 requires 8 equal samples at the timer clock */
+#define ICU_ENCODER_FILTER          0u
+#define ICU_PWM_IN_FILTER           3u
+
+/* Notification of ICU_CHANNEL_ENCODER, implemented by the application: called each time
+   NotifyInterval more timestamps have been stored */
+void IcuEncoder_Notification(void);
+
+#endif /* ICU_CFG_H */
@@ -0,0 +1,116 @@
+/*
+* File: Lin.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the LIN master driver. A frame is one DMA transfer each way: the
+* header and a master response leave the USART by DMA after a break, and the bus is read back by
+* DMA into one buffer, the echo of the header and the response. The break-detect interrupt of the
+* USART synchronizes the reception with the frame, and the update interrupt of a hardware timer
+* ends each slot of the schedule table and starts the next frame, so the slots follow the timer
+* and not the main loop. Frames outside a schedule are sent by Lin_SendFrame and polled with
+* Lin_GetStatus, as LinIf does. Sleep and wakeup are not supported.
+*/
+
+#ifndef LIN_H
+#define LIN_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Lin_Cfg.h"
+#include <stddef.h>
+
+typedef uint8_t Lin_ChannelType;            // LIN_CHANNEL_x
+typedef uint8_t Lin_FramePidType;           // Identifier with its parity bits
+
+// Checksum of a frame: the enhanced checksum covers the protected identifier too
+typedef enum {
+    LIN_ENHANCED_CS,
+    LIN_CLASSIC_CS
+} Lin_FrameCsModelType;
+
+// Node sending the response of a frame
+typedef enum {
+    LIN_MASTER_RESPONSE,
+    LIN_SLAVE_RESPONSE
+} Lin_FrameResponseType;
+
+// Frame sent by Lin_SendFrame
+typedef struct {
+    Lin_FramePidType Pid;
+    Lin_FrameCsModelType Cs;
+    Lin_FrameResponseType Drc;
+    uint8_t Dl;                             // Data bytes, 1 to 8
+    uint8_t* SduPtr;                        // Data of a master response, copied by Lin_SendFrame
+} Lin_PduType;
+
+// State of a channel and result of its last frame
+typedef enum {
+    LIN_NOT_OK,                             // Not initialized
+    LIN_TX_OK,                              // Master response sent and read back
+    LIN_TX_BUSY,
+    LIN_TX_HEADER_ERROR,                    // Header not read back as sent
+    LIN_TX_ERROR,                           // Master response not read back as sent
+    LIN_RX_OK,                              // Slave response received with its checksum
+    LIN_RX_BUSY,
+    LIN_RX_ERROR,                           // Slave response incomplete or with a wrong checksum
+    LIN_RX_NO_RESPONSE,                     // No byte of slave response
+    LIN_OPERATIONAL                         // No frame sent yet
+} Lin_StatusType;
+
+// Frame of LIN_FRAMES
+typedef struct {
+    uint8_t id;                             // Identifier, 0 to 0x3F
+    Lin_FrameCsModelType cs;
+    Lin_FrameResponseType drc;
+    uint8_t length;                         // Data bytes, 1 to 8
+} Lin_FrameConfigType;
+
+// Slot of a schedule table
+typedef struct {
+    Lin_FrameType frame;
+    uint16_t ticks;                         // Length of the slot in timer ticks
+} Lin_ScheduleEntryType;
+
+// Schedule table, run in a loop
+typedef struct {
+    const Lin_ScheduleEntryType* entries;
+    uint8_t numEntries;
+} Lin_ScheduleConfigType;
+
+// Configuration of the driver
+typedef struct {
+    const Lin_FrameConfigType* frames;
+    const Lin_ScheduleConfigType* schedules;
+    // Called from the timer interrupt at the end of the slot of each scheduled frame, NULL if unused
+    void (*frameNotification)(Lin_FrameType Frame, Lin_StatusType Status);
+} Lin_ConfigType;
+
+// Counters of the driver
+typedef struct {
+    uint32_t frames;                        // Frames ended
+    uint32_t headerErrors;                  // LIN_TX_HEADER_ERROR
+    uint32_t txErrors;                      // LIN_TX_ERROR
+    uint32_t rxErrors;                      // LIN_RX_ERROR
+    uint32_t noResponses;                   // LIN_RX_NO_RESPONSE
+    uint32_t unexpectedBreaks;              // Breaks detected outside a header of the driver
+    uint32_t scheduleSwitches;              // Schedules started or stopped at the end of a slot
+} Lin_StatsType;
+
+// Configuration tables, defined in Lin_Cfg.c
+extern const Lin_FrameConfigType Lin_FrameConfig[LIN_NUM_FRAMES];
+extern const Lin_ScheduleConfigType Lin_ScheduleConfig[LIN_NUM_SCHEDULES];
+extern const Lin_ConfigType Lin_Config;
+
+// Function prototypes
+Std_ReturnType Lin_Init(const Lin_ConfigType* ConfigPtr);
+void Lin_DeInit(void);
+Std_ReturnType Lin_SendFrame(Lin_ChannelType Channel, const Lin_PduType* PduInfoPtr);
+Lin_StatusType Lin_GetStatus(Lin_ChannelType Channel, uint8_t** Lin_SduPtr);
+Std_ReturnType Lin_StartSchedule(Lin_ChannelType Channel, Lin_ScheduleType Schedule);
+Std_ReturnType Lin_StopSchedule(Lin_ChannelType Channel);
+Std_ReturnType Lin_WriteFrame(Lin_FrameType Frame, const uint8_t* Data);
+Lin_StatusType Lin_ReadFrame(Lin_FrameType Frame, uint8_t* Data);
+Lin_FramePidType Lin_GetPid(uint8_t Id);
+Std_ReturnType Lin_GetStats(Lin_StatsType* StatsPtr);
+
+#endif /* LIN_H */
@@ -0,0 +1,90 @@
+/*
+* File: Lin_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the LIN driver: the USART of the bus with its DMA streams, the
+* timer of the schedule slots, the frames and the schedule tables, listed in Lin_Cfg.c.
+*/
+
+#ifndef LIN_CFG_H
+#define LIN_CFG_H
+
+/* Bus: UART5 on PC12 (TX) and PD2 (RX). USART6, the other free one, only has PC6 and PC7 on the
+   100-pin package, taken by TIM3 and TIM8. */
+#define LIN_USART               UART5
+#define LIN_USART_CLOCK         RCC_APB1Periph_UART5
+#define LIN_USART_CLOCK_CMD     RCC_APB1PeriphClockCmd
+#define LIN_USART_IRQn          UART5_IRQn
+#define LIN_USART_IRQHandler    UART5_IRQHandler
+#define LIN_BAUDRATE            19200u
+
+/* Header and master response sent by DMA1 stream 7, the bus read back by DMA1 stream 0, both on
+   channel 4. Stream 0 is also the RX stream of SPI3, which Spi_Cfg.c runs in SPI_POLLING_MODE: the
+   streams are claimed from Dma.h, so Spi_SetAsyncMode refuses SPI_DMA_MODE for SPI3 while LIN runs,
+   and Lin_Init fails while SPI3 is in SPI_DMA_MODE. Neither stream raises an interrupt. */
+#define LIN_DMA_CLOCK           RCC_AHB1Periph_DMA1
+#define LIN_DMA_CHANNEL         DMA_Channel_4
+#define LIN_TX_DMA_STREAM       DMA1_Stream7
+#define LIN_TX_DMA_FLAGS        (DMA_FLAG_FEIF7 | DMA_FLAG_DMEIF7 | DMA_FLAG_TEIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TCIF7)
+#define LIN_RX_DMA_STREAM       DMA1_Stream0
+#define LIN_RX_DMA_FLAGS        (DMA_FLAG_FEIF0 | DMA_FLAG_DMEIF0 | DMA_FLAG_TEIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TCIF0)
+
+/* Timer of the slots: its update event ends a slot and its interrupt starts the next frame */
+#define LIN_TIMER               TIM4
+#define LIN_TIMER_CLOCK         RCC_APB1Periph_TIM4
+#define LIN_TIMER_IRQn          TIM4_IRQn
+#define LIN_TIMER_IRQHandler    TIM4_IRQHandler
+
+/* 10 us per tick: the APB1 timer clock (84 MHz) divided by LIN_TIMER_PRESCALER + 1. A slot lasts
+   at most 655 ms. */
+#define LIN_TIMER_TICKS_PER_MS  100u
+#define LIN_TIMER_PRESCALER     (84000000u / (LIN_TIMER_TICKS_PER_MS * 1000u) - 1u)
+
+/* Longest frame of Length data bytes in timer ticks: 1.4 times the 34 bits of the header and the
+   10 bits of each byte of the response, checksum included */
+#define LIN_FRAME_MAX_TICKS(length) \
+    ((14u * (34u + 10u * ((length) + 1u)) * LIN_TIMER_TICKS_PER_MS * 100u + LIN_BAUDRATE - 1u) / LIN_BAUDRATE)
+
+/* Frames: name, identifier, checksum model, response sent by LIN_MASTER_RESPONSE or
+   LIN_SLAVE_RESPONSE, data bytes. The diagnostic frames 0x3C and 0x3D use the classic checksum. */
+#define LIN_FRAMES(X) \
+    X(LIN_FRAME_DOOR_COMMAND,   0x10u,  LIN_ENHANCED_CS,    LIN_MASTER_RESPONSE,    4u) \
+    X(LIN_FRAME_DOOR_STATUS,    0x11u,  LIN_ENHANCED_CS,    LIN_SLAVE_RESPONSE,     8u) \
+    X(LIN_FRAME_SEAT_STATUS,    0x20u,  LIN_ENHANCED_CS,    LIN_SLAVE_RESPONSE,     2u) \
+    X(LIN_FRAME_MASTER_REQUEST, 0x3Cu,  LIN_CLASSIC_CS,     LIN_MASTER_RESPONSE,    8u) \
+    X(LIN_FRAME_SLAVE_RESPONSE, 0x3Du,  LIN_CLASSIC_CS,     LIN_SLAVE_RESPONSE,     8u)
+
+/* Schedule tables: frame and length of its slot in milliseconds, long enough for the
+   LIN_FRAME_MAX_TICKS of the frame (9.1 ms for 8 bytes) */
+#define LIN_SCHEDULE_NORMAL_ENTRIES(X) \
+    X(LIN_FRAME_DOOR_COMMAND,   10u) \
+    X(LIN_FRAME_DOOR_STATUS,    10u) \
+    X(LIN_FRAME_SEAT_STATUS,    5u)
+
+#define LIN_SCHEDULE_DIAG_ENTRIES(X) \
+    X(LIN_FRAME_MASTER_REQUEST, 10u) \
+    X(LIN_FRAME_SLAVE_RESPONSE, 10u)
+
+/* Schedules: name and list of entries */
+#define LIN_SCHEDULES(X) \
+    X(LIN_SCHEDULE_NORMAL,      LIN_SCHEDULE_NORMAL_ENTRIES) \
+    X(LIN_SCHEDULE_DIAG,        LIN_SCHEDULE_DIAG_ENTRIES)
+
+/* Channels */
+#define LIN_CHANNEL_0           0
+#define LIN_MAX_CHANNEL         1
+
+#define LIN_FRAME_NAME(name, ...)       name,
+#define LIN_SCHEDULE_NAME(name, ...)    name,
+
+typedef enum {
+    LIN_FRAMES(LIN_FRAME_NAME)
+    LIN_NUM_FRAMES
+} Lin_FrameType;
+
+typedef enum {
+    LIN_SCHEDULES(LIN_SCHEDULE_NAME)
+    LIN_NUM_SCHEDULES
+} Lin_ScheduleType;
+
+#endif /* LIN_CFG_H */
@@ -0,0 +1,44 @@
+/*
+* File: Log.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Binary logging module. A log call stores a message ID, a timestamp and up to four
+* 32-bit arguments in a lock-free ring, which DMA drains to a USART in the background; the text
+* is only produced on the host by the decoder. Logging costs a few tens of cycles and can be used
+* from tasks and interrupt handlers alike.
+*/
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "stm32f4xx.h"
+#include "Log_Cfg.h"
+#include "Std_Types.h"
+
+/*
+* Record layout on the wire, little-endian 32-bit words:
+*   word 0: header  bits 0-7 LOG_SYNC, 8-15 message ID, 16-23 argument count, 24-31 ~message ID
+*   word 1: timestamp, core clock cycles
+*   word 2..: arguments
+*/
+#define LOG_SYNC                0xA5u
+#define LOG_MAX_ARGS            4u
+#define LOG_HEADER_WORDS        2u
+
+#define LOG_HEADER(id, argc) \
+    ((uint32_t)LOG_SYNC | ((uint32_t)(id) << 8) | ((uint32_t)(argc) << 16) | ((uint32_t)(~(id) & 0xFFu) << 24))
+
+/* Logging with 0 to 4 arguments */
+#define LOG0(id)                    Log_Write((id), 0, 0, 0, 0, 0)
+#define LOG1(id, a0)                Log_Write((id), 1, (uint32_t)(a0), 0, 0, 0)
+#define LOG2(id, a0, a1)            Log_Write((id), 2, (uint32_t)(a0), (uint32_t)(a1), 0, 0)
+#define LOG3(id, a0, a1, a2)        Log_Write((id), 3, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), 0)
+#define LOG4(id, a0, a1, a2, a3)    Log_Write((id), 4, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3))
+
+/* Function prototypes */
+Std_ReturnType Log_Init(void);
+Std_ReturnType Log_Write(Log_IdType Id, uint8_t Argc, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2, uint32_t Arg3);
+void Log_MainFunction(void);
+void Log_Flush(void);
+uint32_t Log_GetDropped(void);
+
+#endif /* LOG_H_ */
@@ -0,0 +1,59 @@
+/*
+* File: Log_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the binary logging module: log ring size, output USART and its DMA
+* stream, and the table of log messages. The message table is shared with the host decoder
+* (Test/Log_Decode.c), which turns the binary stream back into text.
+*/
+#ifndef LOG_CFG_H_
+#define LOG_CFG_H_
+
+/* Size of the log ring in 32-bit words, a power of two */
+#define LOG_RING_WORDS          512u
+
+/* Clock of the record timestamps (DWT cycle counter) */
+#define LOG_TIMESTAMP_HZ        168000000u
+
+/* Output: USART2 TX on PA2, drained by DMA1 stream 6 channel 4 */
+#define LOG_USART               USART2
+#define LOG_USART_CLOCK         RCC_APB1Periph_USART2
+#define LOG_USART_CLOCK_CMD     RCC_APB1PeriphClockCmd
+#define LOG_USART_BAUDRATE      921600u
+#define LOG_DMA_STREAM          DMA1_Stream6
+#define LOG_DMA_CHANNEL         DMA_Channel_4
+#define LOG_DMA_CLOCK           RCC_AHB1Periph_DMA1
+#define LOG_DMA_IRQn            DMA1_Stream6_IRQn
+#define LOG_DMA_FLAGS           (DMA_FLAG_FEIF6 | DMA_FLAG_DMEIF6 | DMA_FLAG_TEIF6 | DMA_FLAG_HTIF6 | DMA_FLAG_TCIF6)
+#define LOG_DMA_DONE_FLAGS      (DMA_FLAG_TCIF6 | DMA_FLAG_TEIF6)
+#define LOG_DMA_IRQHandler      DMA1_Stream6_IRQHandler
+
+/* Log messages: identifier and printf format. Arguments are 32-bit values, at most 4 per message;
+   the formats may use the integer conversions (%u %d %x %X %c with flags and width). */
+#define LOG_MESSAGES(X) \
+    X(LOG_ID_DROPPED,           "%u log records dropped, ring full") \
+    X(LOG_ID_BOOT,              "boot, core clock %u Hz") \
+    X(LOG_ID_SPI_INIT,          "Spi_Init returned %u") \
+    X(LOG_ID_SPI_TX_FAILED,     "SPI sequence %u failed, error %u") \
+    X(LOG_ID_SPI_RX_FRAME,      "SPI rx[%u] = %04X") \
+    X(LOG_ID_SPI_RX_BLOCK,      "SPI block %u received, %u frames") \
+    X(LOG_ID_CAN_START,         "CAN controller %u start returned %u") \
+    X(LOG_ID_COM_ENGINE,        "COM engine speed %u, gear %u") \
+    X(LOG_ID_ADC_SENSORS,       "ADC sensors PC0 %u, PC1 %u, PA1 %u") \
+    X(LOG_ID_ADC_CAPTURE,       "ADC capture half %u, min %u, max %u") \
+    X(LOG_ID_ICU_ENCODER,       "ICU encoder %u ticks per edge") \
+    X(LOG_ID_ICU_PWM_IN,        "ICU PWM input period %u, active %u") \
+    X(LOG_ID_FLS_JOB_END,       "FLS job of user %u done, result %u") \
+    X(LOG_ID_FLS_JOB_FAILED,    "FLS job of user %u failed, result %u") \
+    X(LOG_ID_NVM_BOOT_COUNT,    "NVM boot count %u") \
+    X(LOG_ID_FEE_JOB_FAILED,    "FEE job failed, result %u") \
+    X(LOG_ID_LIN_INIT,          "Lin_Init returned %u")
+
+#define LOG_MESSAGE_ID(id, format)  id,
+
+typedef enum {
+    LOG_MESSAGES(LOG_MESSAGE_ID)
+    LOG_NUM_MESSAGES
+} Log_IdType;
+
+#endif /* LOG_CFG_H_ */
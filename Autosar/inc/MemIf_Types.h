@@ -0,0 +1,31 @@
+/*
+* File: MemIf_Types.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Types shared by the modules of the memory stack.
+*/
+
+#ifndef MEMIF_TYPES_H
+#define MEMIF_TYPES_H
+
+#include "Std_Types.h"
+
+// State of a memory module
+typedef enum {
+    MEMIF_UNINIT,           // Not initialized
+    MEMIF_IDLE,             // No job pending
+    MEMIF_BUSY,             // A job is pending
+    MEMIF_BUSY_INTERNAL     // Busy with work of its own, such as a garbage collection
+} MemIf_StatusType;
+
+// Result of the last job of a memory module
+typedef enum {
+    MEMIF_JOB_OK,               // Completed
+    MEMIF_JOB_FAILED,           // Rejected by the hardware, or a compare found different data
+    MEMIF_JOB_PENDING,          // Still in progress
+    MEMIF_JOB_CANCELED,         // Cancelled before its end
+    MEMIF_BLOCK_INCONSISTENT,   // The block read is corrupted
+    MEMIF_BLOCK_INVALID         // The block read has been invalidated
+} MemIf_JobResultType;
+
+#endif /* MEMIF_TYPES_H */
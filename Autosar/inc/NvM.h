@@ -0,0 +1,65 @@
+/*
+* File: NvM.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the NVM module, keeping RAM blocks of the application in FEE blocks.
+* Requests are queued by priority and served one at a time by NvM_MainFunction; a block has at most
+* one request pending, and a write requested again before it starts is merged with the pending one,
+* its data being taken when it starts. A block with a write delay holds its writes that long to merge
+* the writes of a frequent writer. Each block is protected by a CRC-32 computed by the CRC unit; a
+* write whose CRC matches the one of the block in flash is skipped.
+*/
+
+#ifndef NVM_H
+#define NVM_H
+
+#include "Fee.h"
+#include "NvM_Cfg.h"
+
+typedef uint16_t NvM_BlockIdType;
+
+// Result of the last request of a block
+typedef enum {
+    NVM_REQ_OK,
+    NVM_REQ_NOT_OK,                 // Rejected by the FEE module
+    NVM_REQ_PENDING,
+    NVM_REQ_INTEGRITY_FAILED,       // The CRC read differs from the one of the data
+    NVM_REQ_BLOCK_SKIPPED,          // Left out of NvM_ReadAll or NvM_WriteAll
+    NVM_REQ_NV_INVALIDATED,         // Never written or invalidated
+    NVM_REQ_CANCELED,
+    NVM_REQ_RESTORED_FROM_ROM       // Not read, the RAM block holds the default data
+} NvM_RequestResultType;
+
+// Block of the configuration
+typedef struct {
+    uint16_t feeBlockNumber;                // Its size is the length rounded up to words, plus the CRC
+    uint16_t length;                        // Bytes, up to NVM_MAX_BLOCK_LENGTH
+    uint8_t priority;                       // NVM_PRIORITY_IMMEDIATE first, then by increasing value
+    uint8_t useCrc;
+    uint8_t selectAll;                      // Read by NvM_ReadAll and written by NvM_WriteAll
+    uint16_t writeDelay;                    // Milliseconds a write waits for newer data, up to 32767 periods
+    void* ramBlock;                         // Permanent RAM block, NULL if none
+    const void* romBlock;                   // Default data, NULL if none
+} NvM_BlockDescriptorType;
+
+// Configuration of the module
+typedef struct {
+    const NvM_BlockDescriptorType* blocks;  // Block 1 first
+    uint16_t numBlocks;                     // Up to NVM_MAX_BLOCKS
+    void (*multiBlockNotification)(void);   // NULL if unused
+} NvM_ConfigType;
+
+// Configuration, defined in NvM_Cfg.c
+extern const NvM_BlockDescriptorType NvM_BlockDescriptor[NVM_NUM_BLOCKS];
+extern const NvM_ConfigType NvM_Config;
+
+// Function prototypes
+void NvM_Init(const NvM_ConfigType* ConfigPtr);
+Std_ReturnType NvM_ReadBlock(NvM_BlockIdType BlockId, void* NvM_DstPtr);
+Std_ReturnType NvM_WriteBlock(NvM_BlockIdType BlockId, const void* NvM_SrcPtr);
+void NvM_ReadAll(void);
+void NvM_WriteAll(void);
+Std_ReturnType NvM_GetErrorStatus(NvM_BlockIdType BlockId, NvM_RequestResultType* RequestResultPtr);
+void NvM_MainFunction(void);
+
+#endif /* NVM_H */
@@ -0,0 +1,43 @@
+/*
+* File: NvM_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the NVM module: the blocks, listed in NvM_Cfg.c with the FEE block
+* holding each one, and the RAM blocks and notification the application provides.
+*/
+
+#ifndef NVM_CFG_H
+#define NVM_CFG_H
+
+#include <stdint.h>
+#include "Gpt_Cfg.h"
+
+/* Blocks of a configuration at most, the size of the job queue */
+#define NVM_MAX_BLOCKS          16u
+
+/* Largest block; its FEE block adds the CRC word */
+#define NVM_MAX_BLOCK_LENGTH    252u
+
+/* Period of the calls of NvM_MainFunction, in milliseconds: main.c calls it every cycle of
+   GPT_CHANNEL_COM_CYCLE. The write delays of the blocks are rounded up to whole periods. */
+#define NVM_MAIN_FUNCTION_PERIOD_MS     GPT_COM_CYCLE_MS
+
+/* Priority of the jobs served before all others and never delayed */
+#define NVM_PRIORITY_IMMEDIATE  0u
+
+/* Blocks of the application, 1 first: block 0 stands for NvM_ReadAll and NvM_WriteAll */
+#define NVM_NUM_BLOCKS          3
+#define NVM_BLOCK_BOOT_COUNT    1u
+#define NVM_BLOCK_CALIBRATION   2u
+#define NVM_BLOCK_DTC           3u
+
+/* RAM blocks of the application, read by NvM_ReadAll and written by NvM_WriteAll */
+extern uint32_t App_BootCount;
+extern uint8_t App_Calibration[64];
+extern uint8_t App_Dtc[128];
+
+/* Notification of the end of NvM_ReadAll and NvM_WriteAll, implemented by the application and
+   called from NvM_MainFunction */
+void NvMJob_MultiBlockNotification(void);
+
+#endif /* NVM_CFG_H */
@@ -0,0 +1,80 @@
+/*
+* File: PduR.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the PDU router, the receive notification of the CAN driver. The driver
+* passes the frame of CAN_RX_PDUS its receive interrupt found for the identifier, and the routing
+* table is indexed by that frame, without a search. Gateway paths hand the received
+* data to the destination without a copy through COM: Can_Write takes the driver's own receive
+* buffer, frames for the SPI logger are written straight into the buffer the DMA sends, and
+* diagnostic frames go to the CAN transport layer, which copies their data into the message buffer.
+*/
+
+#ifndef PDUR_H
+#define PDUR_H
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "Can.h"
+#include "Com.h"
+#include "CanTp.h"
+#include "PduR_Cfg.h"
+
+// Kind of a gateway destination
+#define PDUR_GW_CAN             0u          // Frame sent by Can_Write
+#define PDUR_GW_SPI             1u          // Record sent through SPI_CHANNEL_GATEWAY
+#define PDUR_GW_CANTP           2u          // Frame of a CanTp connection
+
+// Identifier of a PDUR_GW_CAN destination sending the frame with the identifier it was received with
+#define PDUR_SOURCE_ID          0xFFFFFFFFu
+
+// Routing path without COM or without gateway
+#define PDUR_NO_COM_PDU         0xFFu
+#define PDUR_NO_GATEWAY         0xFFu
+
+// Destinations of a routing path
+#define PDUR_TO_COM             0x01u
+#define PDUR_TO_GATEWAY         0x02u
+
+// Record of the SPI gateway: identifier (big endian, CAN_ID_EXTENDED set for an extended one),
+// length, then 8 data bytes, those beyond the length cleared
+#define PDUR_SPI_RECORD_BYTES   13u
+
+// Routing path of a frame of CAN_RX_PDUS
+typedef struct {
+    uint8_t destinations;                   // PDUR_TO_COM, PDUR_TO_GATEWAY, 0 if the frame is dropped
+    uint8_t comPdu;                         // Com_RxIpduIdType
+    uint8_t gateway;                        // PduR_GatewayIdType
+} PduR_RoutingPathType;
+
+// Gateway destination
+typedef struct {
+    uint8_t kind;                           // PDUR_GW_CAN, PDUR_GW_SPI or PDUR_GW_CANTP
+    uint8_t target;                         // PDUR_GW_CAN: transmit hardware object;
+                                            // PDUR_GW_CANTP: CanTp connection
+    Can_IdType id;                          // PDUR_GW_CAN: identifier sent, or PDUR_SOURCE_ID
+} PduR_GatewayConfigType;
+
+// Counters of the router
+typedef struct {
+    uint32_t rxFrames;                      // Frames indicated by the CAN driver
+    uint32_t dropped;                       // Frames without routing path
+    uint32_t toCom;                         // Frames passed to COM
+    uint32_t gatewayed;                     // Frames taken by their gateway destination
+    uint32_t gatewayLost;                   // Frames refused by Can_Write, or with both SPI buffers in use
+    uint32_t spiTransfers;                  // Buffers sent through SPI_SEQ_GATEWAY
+} PduR_StatsType;
+
+// Configuration tables, defined in PduR_Cfg.c
+extern const PduR_RoutingPathType PduR_RoutingTable[CAN_NUM_RX_PDUS];
+extern const PduR_GatewayConfigType PduR_GatewayConfig[PDUR_NUM_GATEWAYS];
+
+// Function prototypes
+void PduR_Init(void);
+void PduR_DeInit(void);
+void PduR_CanRxIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr);
+void PduR_CanTxConfirmation(PduIdType CanTxPduId);
+void PduR_SpiGatewayNotification(void);
+Std_ReturnType PduR_GetStats(PduR_StatsType* StatsPtr);
+
+#endif /* PDUR_H */
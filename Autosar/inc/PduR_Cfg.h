@@ -0,0 +1,67 @@
+/*
+* File: PduR_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Configuration of the PDU router: the gateway destinations and the routing path of
+* each frame of CAN_RX_PDUS.
+*/
+
+#ifndef PDUR_CFG_H
+#define PDUR_CFG_H
+
+// Gateway destinations: name, kind, transmit hardware object or CanTp connection, identifier sent
+// (PDUR_SOURCE_ID to keep the received one). A PDUR_GW_CAN destination passes the received data
+// straight to Can_Write; the PDUR_GW_SPI destination appends the frame to the buffer SPI_SEQ_GATEWAY
+// sends next; a PDUR_GW_CANTP destination passes it to CanTp_RxIndication.
+#define PDUR_GATEWAYS(X) \
+    X(PDUR_GW_CAN1,         PDUR_GW_CAN,    CAN_HTH_CAN1,   PDUR_SOURCE_ID) \
+    X(PDUR_GW_CAN2,         PDUR_GW_CAN,    CAN_HTH_CAN2,   PDUR_SOURCE_ID) \
+    X(PDUR_GW_LOGGER,       PDUR_GW_SPI,    0,              0) \
+    X(PDUR_TP_DIAG_PHYSICAL,    PDUR_GW_CANTP,  CANTP_DIAG_PHYSICAL,    0) \
+    X(PDUR_TP_DIAG_FUNCTIONAL,  PDUR_GW_CANTP,  CANTP_DIAG_FUNCTIONAL,  0)
+
+// Routing paths: frame of CAN_RX_PDUS, I-PDU of COM_RX_IPDUS or PDUR_NO_COM_PDU, gateway
+// destination or PDUR_NO_GATEWAY. A frame with both goes out first, then to COM. Frames not listed
+// are dropped.
+#define PDUR_ROUTES(X) \
+    /* Chassis frames, the wheel speeds forwarded to the J1939 bus */ \
+    X(CAN_RX_PDU_BRAKE_PRESSURE,    COM_RX_IPDU_BRAKE,          PDUR_NO_GATEWAY) \
+    X(CAN_RX_PDU_STEERING_ANGLE,    COM_RX_IPDU_STEERING,       PDUR_NO_GATEWAY) \
+    X(CAN_RX_PDU_WHEEL_SPEED_FL,    COM_RX_IPDU_WHEEL_SPEED_FL, PDUR_GW_CAN2) \
+    X(CAN_RX_PDU_WHEEL_SPEED_FR,    COM_RX_IPDU_WHEEL_SPEED_FR, PDUR_GW_CAN2) \
+    X(CAN_RX_PDU_WHEEL_SPEED_RL,    PDUR_NO_COM_PDU,            PDUR_GW_CAN2) \
+    X(CAN_RX_PDU_WHEEL_SPEED_RR,    PDUR_NO_COM_PDU,            PDUR_GW_CAN2) \
+    X(CAN_RX_PDU_YAW_RATE,          COM_RX_IPDU_YAW_RATE,       PDUR_NO_GATEWAY) \
+    X(CAN_RX_PDU_GEAR,              COM_RX_IPDU_GEAR,           PDUR_NO_GATEWAY) \
+    X(CAN_RX_PDU_ODOMETER,          COM_RX_IPDU_ODOMETER,       PDUR_NO_GATEWAY) \
+    /* Engine frames of the J1939 bus, mirrored on CAN1 */ \
+    X(CAN_RX_PDU_EEC1_00,           COM_RX_IPDU_EEC1,           PDUR_GW_CAN1) \
+    X(CAN_RX_PDU_EEC1_01,           PDUR_NO_COM_PDU,            PDUR_GW_CAN1) \
+    X(CAN_RX_PDU_EEC2_00,           PDUR_NO_COM_PDU,            PDUR_GW_CAN1) \
+    X(CAN_RX_PDU_EEC2_01,           PDUR_NO_COM_PDU,            PDUR_GW_CAN1) \
+    /* Battery cells and diagnostic messages, recorded by the logger on SPI2 */ \
+    X(CAN_RX_PDU_BMS_CELLS_0,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_1,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_2,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_3,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_4,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_5,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_6,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_BMS_CELLS_7,       PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_DM1_00,            PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    X(CAN_RX_PDU_DM1_03,            PDUR_NO_COM_PDU,            PDUR_GW_LOGGER) \
+    /* Diagnostic requests of the tester */ \
+    X(CAN_RX_PDU_DIAG_PHYSICAL,     PDUR_NO_COM_PDU,            PDUR_TP_DIAG_PHYSICAL) \
+    X(CAN_RX_PDU_DIAG_FUNCTIONAL,   PDUR_NO_COM_PDU,            PDUR_TP_DIAG_FUNCTIONAL)
+
+// Records of the SPI gateway, per buffer; two buffers are sent in turns
+#define PDUR_SPI_RECORDS        8u
+
+#define PDUR_GATEWAY_NAME(name, ...)    name,
+
+typedef enum {
+    PDUR_GATEWAYS(PDUR_GATEWAY_NAME)
+    PDUR_NUM_GATEWAYS
+} PduR_GatewayIdType;
+
+#endif /* PDUR_CFG_H */
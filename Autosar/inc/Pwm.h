@@ -0,0 +1,78 @@
+/*
+* File: Pwm.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Header file of the PWM driver. The compare values of all the channels of a timer
+* are kept in RAM and copied into CCR1..CCRn by one DMA burst at every update event, so setting a
+* duty cycle is a store to memory instead of a register write, and the channels of a timer change
+* together at the start of a period. A unit can also play a table of compare values from memory,
+* one row per period, without the CPU.
+*/
+
+#ifndef PWM_H
+#define PWM_H
+
+#include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Pwm_Cfg.h"
+#include <stddef.h>
+
+// Number of PWM hardware units
+#define NUM_OF_PWM_HW_UNITS 2
+
+// Definition of PWM hardware units
+typedef enum {
+    PWM_HWUnit_0,       // TIM1
+    PWM_HWUnit_1        // TIM3
+} Pwm_HWUnitType;
+
+typedef uint8_t Pwm_ChannelType;            // PWM_CHANNEL_x
+typedef uint32_t Pwm_PeriodType;            // Period of a unit in timer ticks
+typedef uint32_t Pwm_CompareType;           // Value of a CCRx register, 0 to the period
+
+// Duty cycles, 0x8000 is 100 %
+#define PWM_DUTY_0          0x0000u
+#define PWM_DUTY_100        0x8000u
+
+// Output level
+typedef enum {
+    PWM_LOW,
+    PWM_HIGH
+} Pwm_OutputStateType;
+
+// Configuration of a hardware unit
+typedef struct {
+    uint16_t prescaler;                     // Timer clock divided by prescaler + 1
+    Pwm_PeriodType period;                  // Ticks per period, at most 65536
+    uint8_t burstLength;                    // CCR1..CCRn written per update event, 1 to 4
+} Pwm_HWUnitConfigType;
+
+// Configuration of a channel
+typedef struct {
+    Pwm_HWUnitType hwUnit;                  // Timer of the channel
+    uint8_t timChannel;                     // 0..3 for CH1..CH4, below burstLength of the unit
+    Pwm_OutputStateType polarity;           // Level of the active part of the period
+    Pwm_OutputStateType idleState;          // Level after Pwm_SetOutputToIdle and while stopped
+    uint16_t dutyCycle;                     // Duty cycle after Pwm_Init
+} Pwm_ChannelConfigType;
+
+// Configuration of the driver
+typedef struct {
+    const Pwm_HWUnitConfigType* hwUnits;    // NUM_OF_PWM_HW_UNITS entries
+    const Pwm_ChannelConfigType* channels;  // PWM_MAX_CHANNEL entries
+} Pwm_ConfigType;
+
+// Configuration table, defined in Pwm_Cfg.c
+extern const Pwm_ConfigType Pwm_Config;
+
+// Function prototypes
+void Pwm_Init(const Pwm_ConfigType* ConfigPtr);
+void Pwm_DeInit(void);
+void Pwm_SetDutyCycle(Pwm_ChannelType ChannelNumber, uint16_t DutyCycle);
+Std_ReturnType Pwm_SetDutyCycles(const Pwm_ChannelType* Channels, const uint16_t* DutyCycles, uint8_t Count);
+void Pwm_SetOutputToIdle(Pwm_ChannelType ChannelNumber);
+Pwm_CompareType Pwm_DutyToCompare(Pwm_HWUnitType HWUnit, uint16_t DutyCycle);
+Std_ReturnType Pwm_StartWaveform(Pwm_HWUnitType HWUnit, const Pwm_CompareType* Table, uint16_t Rows);
+Std_ReturnType Pwm_StopWaveform(Pwm_HWUnitType HWUnit);
+
+#endif /* PWM_H */
@@ -0,0 +1,32 @@
+/*
+* File: Pwm_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Pre-compile configuration of the PWM driver: the period of each hardware unit, the
+* number of compare registers its DMA burst writes and the channels defined in Pwm_Cfg.c.
+*/
+
+#ifndef PWM_CFG_H
+#define PWM_CFG_H
+
+/* PWM_HWUnit_0, TIM1: 20 kHz motor bridge, 8400 ticks of the 168 MHz timer clock */
+#define PWM_MOTOR_PRESCALER     0u
+#define PWM_MOTOR_PERIOD        8400u
+
+/* PWM_HWUnit_1, TIM3: 1 kHz LED dimmer, 1000 ticks of 1 us from the 84 MHz timer clock */
+#define PWM_DIMMER_PRESCALER    83u
+#define PWM_DIMMER_PERIOD       1000u
+
+/* Compare registers written by each DMA burst, CCR1 up to the highest channel of the unit. They
+   are also the columns of a waveform table of the unit. */
+#define PWM_MOTOR_BURST         3u
+#define PWM_DIMMER_BURST        1u
+
+/* Channels */
+#define PWM_CHANNEL_PHASE_U     0   /* TIM1 CH1, PE9 */
+#define PWM_CHANNEL_PHASE_V     1   /* TIM1 CH2, PE11 */
+#define PWM_CHANNEL_PHASE_W     2   /* TIM1 CH3, PE13 */
+#define PWM_CHANNEL_DIMMER      3   /* TIM3 CH1, PC6 */
+#define PWM_MAX_CHANNEL         4
+
+#endif /* PWM_CFG_H */
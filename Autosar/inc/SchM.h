@@ -0,0 +1,47 @@
+/*
+* File: SchM.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Exclusive areas used by the drivers to protect data shared between tasks and
+* interrupt handlers.
+*/
+
+#ifndef SCHM_H
+#define SCHM_H
+
+#include "stm32f4xx.h"
+
+typedef uint32_t SchM_StateType;    /* Interrupt state saved on entry of an exclusive area */
+
+#ifndef HOST_SIM
+/* Save PRIMASK and mask interrupts, so exclusive areas can be nested */
+#define SchM_Enter(state)   do { (state) = __get_PRIMASK(); __disable_irq(); } while (0)
+/* Restore the interrupt state saved by SchM_Enter */
+#define SchM_Exit(state)    __set_PRIMASK(state)
+/* Sleep until an interrupt is pending; used inside an exclusive area so no wake-up is lost */
+#define SchM_WaitForInterrupt()     __WFI()
+/* Orders the memory accesses of a lock-free producer or consumer before publishing an index */
+#define SchM_MemoryBarrier()        __DMB()
+/* Replaces *Addr by Desired if it still holds Expected; returns 1 on success. Lets several tasks
+   and interrupt handlers claim space in a shared buffer without masking interrupts. */
+__STATIC_INLINE uint32_t SchM_CompareAndSwap(volatile uint32_t* Addr, uint32_t Expected, uint32_t Desired)
+{
+    do {
+        if (__LDREXW(Addr) != Expected) {
+            __CLREX();
+            return 0;
+        }
+    } while (__STREXW(Desired, Addr) != 0);
+    return 1;
+}
+#else
+/* The host simulation delivers interrupts between register accesses while they are unmasked */
+#define SchM_Enter(state)   ((state) = HostSim_DisableIrq())
+#define SchM_Exit(state)    HostSim_RestoreIrq(state)
+#define SchM_WaitForInterrupt()     HostSim_WaitForInterrupt()
+#define SchM_MemoryBarrier()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define SchM_CompareAndSwap(Addr, Expected, Desired) \
+    __sync_bool_compare_and_swap((Addr), (Expected), (Desired))
+#endif
+
+#endif /* SCHM_H */
@@ -2,7 +2,7 @@
 File: Spi.h
 Author: Tran Nhat Thai
 Date: 29/02/2024
-Description: Header file for SPI (Serial Peripheral Interface) operations, including initialization, 
+Description: Header file for SPI (Serial Peripheral Interface) operations, including initialization,
 data transmission, and configuration.
 */
 
@@ -13,6 +13,8 @@ data transmission, and configuration.
 #define SPI_H
 
 #include "stm32f4xx.h"
+#include "Std_Types.h"
+#include "Spi_Cfg.h"
 #include <stddef.h>
 
 // Vendor and module identification information
@@ -23,9 +25,6 @@ data transmission, and configuration.
 #define SW_MINOR_VERSION   0      // Software minor version
 #define SW_PATCH_VERSION   0      // Software patch version
 */
-// Number of SPI sequences
-#define NUM_OF_SPI_SEQUENCES 5
-
 // Number of SPI hardware units
 #define NUM_OF_SPI_HW_UNITS 3
 
@@ -46,13 +45,41 @@ typedef enum {
 } Spi_AsyncModeType;
 
 typedef uint8_t Spi_SequenceType;
-#define NUM_OF_SEQUENCES 8
 
-// Return type for SPI functions
+// Types used by the channel/job/sequence model
+typedef uint8_t Spi_DataBufferType;         // Type of one data element in an IB/EB buffer
+typedef uint16_t Spi_NumberOfDataType;      // Number of data elements of a channel
+typedef uint8_t Spi_ChannelType;            // Channel identifier
+typedef uint16_t Spi_JobType;               // Job identifier
+
+// Status of the SPI driver or of a single hardware unit
+typedef enum {
+    SPI_UNINIT,     // Driver not initialized
+    SPI_IDLE,       // No job in progress
+    SPI_BUSY        // At least one job in progress
+} Spi_StatusType;
+
+// Result of a job
+typedef enum {
+    SPI_JOB_OK,         // Last transmission of the job finished successfully
+    SPI_JOB_PENDING,    // Job is being transmitted
+    SPI_JOB_FAILED,     // Last transmission of the job failed
+    SPI_JOB_QUEUED      // Job is waiting in the queue of its hardware unit
+} Spi_JobResultType;
+
+// Result of a sequence
+typedef enum {
+    SPI_SEQ_OK,         // Last transmission of the sequence finished successfully
+    SPI_SEQ_PENDING,    // Sequence is being transmitted
+    SPI_SEQ_FAILED,     // Last transmission of the sequence failed
+    SPI_SEQ_CANCELED    // Last transmission of the sequence was cancelled
+} Spi_SeqResultType;
+
+// Buffer location of a channel
 typedef enum {
-    E_OK = 0,       // Success
-    E_NOT_OK = 1    // Failure
-} Std_ReturnType;
+    SPI_IB,         // Internal buffer, owned by the driver
+    SPI_EB          // External buffer, provided by the user
+} Spi_BufferType;
 
 // Structure for SPI configuration
 typedef struct {
@@ -67,6 +94,63 @@ typedef struct {
     uint16_t crcPolynomial;
 } Spi_ConfigType;
 
+// Configuration of one hardware unit. Units that are not enabled are left unclocked and reject
+// jobs.
+typedef struct {
+    uint8_t enabled;                        // Unit used by the configuration
+    Spi_ConfigType settings;                // Bus settings of the unit
+    Spi_AsyncModeType asyncMode;            // Mode selected by Spi_Init
+} Spi_HWUnitConfigType;
+
+// Structure for channel configuration. Buffers of 16-bit channels hold uint16_t frames and must be
+// 2-byte aligned; lengths always count frames.
+typedef struct {
+    Spi_BufferType bufferType;              // IB or EB channel
+    uint16_t dataSize;                      // Frame size, SPI_DataSize_8b or SPI_DataSize_16b
+    Spi_NumberOfDataType length;            // Number of frames (IB) or largest buffer (EB)
+    uint16_t defaultData;                   // Frame sent when no source buffer is given
+    Spi_DataBufferType* txBuffer;           // Internal transmit buffer (IB only)
+    Spi_DataBufferType* rxBuffer;           // Internal receive buffer (IB only)
+} Spi_ChannelConfigType;
+
+// Structure for job configuration
+typedef struct {
+    Spi_HWUnitType hwUnit;                  // Hardware unit used by the job
+    uint8_t priority;                       // 0 (lowest) to 3 (highest)
+    uint8_t csChannel;                      // Dio channel used as chip select, SPI_CS_NONE if unused
+    uint8_t csActiveLevel;                  // Dio level that selects the device
+    const Spi_ChannelType* channelList;     // Channels transmitted by the job, in order
+    uint8_t numChannels;                    // Number of channels in channelList
+    void (*endNotification)(void);          // Called when the job has been transmitted
+} Spi_JobConfigType;
+
+// Structure for sequence configuration
+typedef struct {
+    const Spi_JobType* jobList;             // Jobs of the sequence, in order
+    uint8_t numJobs;                        // Number of jobs in jobList
+    void (*endNotification)(void);          // Called when the sequence has been transmitted
+} Spi_SequenceConfigType;
+
+// Counters of a hardware unit, times in core clock cycles
+typedef struct {
+    uint32_t frames;                        // Frames transferred
+    uint32_t jobs;                          // Jobs finished
+    uint32_t interrupts;                    // SPI interrupts served in SPI_INTERRUPT_MODE
+    uint32_t latencyLast;                   // Spi_AsyncTransmit to end of the last finished job
+    uint32_t latencyMax;                    // Largest latency seen
+    uint64_t latencySum;                    // Sum of all latencies, divided by jobs gives the mean
+    uint64_t busyCycles;                    // Time spent with a device selected
+} Spi_HWUnitStatsType;
+
+// Chip select value for jobs driving the NSS line by hardware or not at all
+#define SPI_CS_NONE 0xFF
+
+// Configuration tables, defined in Spi_Cfg.c
+extern const Spi_HWUnitConfigType Spi_HWUnitConfig[NUM_OF_SPI_HW_UNITS];
+extern const Spi_ChannelConfigType Spi_ChannelConfig[SPI_MAX_CHANNEL];
+extern const Spi_JobConfigType Spi_JobConfig[SPI_MAX_JOB];
+extern const Spi_SequenceConfigType Spi_SequenceConfig[SPI_MAX_SEQUENCE];
+
 // Structure for version information
 /*
 typedef struct {
@@ -82,13 +166,22 @@ typedef struct {
 // Function prototypes
 Std_ReturnType Spi_Init(const Spi_ConfigType* ConfigPtr);
 Std_ReturnType Spi_DeInit(void);
-Std_ReturnType Spi_WriteIB(const uint8_t* DataBufferPtr);
-Std_ReturnType Spi_SetupEB(const Spi_ConfigType* ConfigPtr, const uint8_t* SrcDataBufferPtr, uint8_t* DesDataBufferPtr, uint16_t Length);
-Std_ReturnType Spi_GetJobResult(void);
-Std_ReturnType Spi_GetSequenceResult(void);
+Std_ReturnType Spi_WriteIB(Spi_ChannelType Channel, const Spi_DataBufferType* DataBufferPtr);
+Std_ReturnType Spi_ReadIB(Spi_ChannelType Channel, Spi_DataBufferType* DataBufferPtr);
+Std_ReturnType Spi_SetupEB(Spi_ChannelType Channel, const Spi_DataBufferType* SrcDataBufferPtr, Spi_DataBufferType* DesDataBufferPtr, Spi_NumberOfDataType Length);
+Std_ReturnType Spi_SetupEBPingPong(Spi_ChannelType Channel, const Spi_DataBufferType* const SrcDataBufferPtr[2], Spi_DataBufferType* const DesDataBufferPtr[2], Spi_NumberOfDataType Length);
+Std_ReturnType Spi_GetEBBuffers(Spi_ChannelType Channel, const Spi_DataBufferType** SrcDataBufferPtr, Spi_DataBufferType** DesDataBufferPtr);
+Std_ReturnType Spi_AsyncTransmit(Spi_SequenceType Sequence);
+Spi_StatusType Spi_GetStatus(void);
+Spi_StatusType Spi_GetHWUnitStatus(Spi_HWUnitType HWUnit);
+Spi_JobResultType Spi_GetJobResult(Spi_JobType Job);
+Spi_SeqResultType Spi_GetSequenceResult(Spi_SequenceType Sequence);
 /*void Spi_GetVersionInfo(Std_VersionInfoType* VersionInfo);*/
 Std_ReturnType Spi_SyncTransmit(const Spi_SequenceType Sequence);
 Std_ReturnType Spi_Cancel(Spi_SequenceType Sequence);
 Std_ReturnType Spi_SetAsyncMode(Spi_HWUnitType HWUnit, Spi_AsyncModeType Mode);
+void Spi_MainFunction_Handling(void);
+Std_ReturnType Spi_GetHWUnitStats(Spi_HWUnitType HWUnit, Spi_HWUnitStatsType* StatsPtr);
+Std_ReturnType Spi_ResetHWUnitStats(Spi_HWUnitType HWUnit);
 
 #endif /* SPI_H */
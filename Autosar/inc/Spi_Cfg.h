@@ -0,0 +1,52 @@
+/*
+* File: Spi_Cfg.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Pre-compile configuration of the SPI driver: symbolic names and number of the
+* channels, jobs and sequences defined in Spi_Cfg.c.
+*/
+
+#ifndef SPI_CFG_H
+#define SPI_CFG_H
+
+/* Channels */
+#define SPI_CHANNEL_ACCEL_CMD       0   /* Accelerometer register address */
+#define SPI_CHANNEL_ACCEL_DATA      1   /* Accelerometer X/Y/Z samples */
+#define SPI_CHANNEL_GYRO_CMD        2   /* Gyroscope register address */
+#define SPI_CHANNEL_GYRO_DATA       3   /* Gyroscope X/Y/Z samples */
+#define SPI_CHANNEL_BARO_CMD        4   /* Pressure sensor conversion read command */
+#define SPI_CHANNEL_BARO_DATA       5   /* Pressure sensor 24-bit result */
+#define SPI_CHANNEL_EEPROM_STATUS   6   /* EEPROM read status register command and answer */
+#define SPI_CHANNEL_EXT_ADC         7   /* External 16-bit ADC conversion stream, EB */
+#define SPI_CHANNEL_GATEWAY         8   /* CAN frames forwarded by PduR to the logger, EB */
+#define SPI_MAX_CHANNEL             9
+
+/* Largest buffer that can be bound to an EB channel, in frames */
+#define SPI_EXT_ADC_MAX_LENGTH      32
+#define SPI_GATEWAY_MAX_LENGTH      104 /* PDUR_SPI_RECORDS records of PDUR_SPI_RECORD_BYTES */
+
+/* Jobs */
+#define SPI_JOB_ACCEL_READ          0   /* SPI1, CS on PA4 */
+#define SPI_JOB_GYRO_READ           1   /* SPI2, CS on PB12 */
+#define SPI_JOB_BARO_READ           2   /* SPI3, CS on PA15 */
+#define SPI_JOB_EEPROM_STATUS       3   /* SPI1, CS on PC4 */
+#define SPI_JOB_EXT_ADC_READ        4   /* SPI3, CS on PA8 */
+#define SPI_JOB_GATEWAY_WRITE       5   /* SPI2, CS on PB1 */
+#define SPI_MAX_JOB                 6
+
+/* Sequences */
+#define SPI_SEQ_IMU                 0   /* Accelerometer and gyroscope sample */
+#define SPI_SEQ_BARO                1   /* Pressure sample */
+#define SPI_SEQ_EEPROM              2   /* EEPROM status poll */
+#define SPI_SEQ_EXT_ADC             3   /* External ADC block read */
+#define SPI_SEQ_GATEWAY             4   /* Frames forwarded by the PduR gateway */
+#define SPI_MAX_SEQUENCE            5
+
+/* End notification of SPI_SEQ_GATEWAY, implemented by the PDU router */
+void PduR_SpiGatewayNotification(void);
+
+/* Channel slots of the ring feeding each hardware unit in SPI_INTERRUPT_MODE (power of two, at
+   most 128). A job enters the ring only as a whole, so it must hold the longest job. */
+#define SPI_IRQ_RING_SIZE           8
+
+#endif /* SPI_CFG_H */
@@ -0,0 +1,19 @@
+/*
+* File: Std_Types.h
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Types shared by all modules.
+*/
+
+#ifndef STD_TYPES_H
+#define STD_TYPES_H
+
+#include <stdint.h>
+
+// Return type of the module functions
+typedef enum {
+    E_OK = 0,       // Success
+    E_NOT_OK = 1    // Failure
+} Std_ReturnType;
+
+#endif /* STD_TYPES_H */
@@ -0,0 +1,709 @@
+/*
+* File: Adc.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Adc.h containing the implementation of the ADC driver. Groups are
+* converted continuously and moved by a DMA stream into their result buffer; the position of the
+* stream tells how far the buffer has been written, so reading a group never waits for the ADC.
+*/
+
+#include "Adc.h"
+#include "SchM.h"
+#include <stdint.h>
+
+// Value of Adc_HWUnitGroup when a hardware unit converts no group
+#define ADC_GROUP_NONE ((Adc_GroupType)0xFF)
+
+// Value of readRound before the first read of a started group
+#define ADC_ROUND_NONE ((Adc_StreamNumSampleType)0xFFFF)
+
+// All flags of DMA stream n
+#define ADC_DMA_FLAGS(n) (DMA_FLAG_FEIF##n | DMA_FLAG_DMEIF##n | DMA_FLAG_TEIF##n | DMA_FLAG_HTIF##n | DMA_FLAG_TCIF##n)
+
+// Peripheral resources of a hardware unit
+typedef struct {
+    ADC_TypeDef* regs;                  // ADC peripheral
+    uint32_t rccPeriph;                 // RCC_APB2Periph_ADCx clock enable bit
+    DMA_Stream_TypeDef* stream;         // Stream moving DR to the result buffer
+    uint32_t channel;                   // DMA_Channel_x selecting the ADC request
+    uint32_t flags;                     // All flags of the stream
+    uint32_t halfFlag;                  // Half transfer flag of the stream
+    uint32_t completeFlag;              // Transfer complete flag of the stream
+    uint32_t errorFlag;                 // Transfer error flag of the stream
+    IRQn_Type irqn;                     // Interrupt of the stream
+} Adc_HWUnitHwType;
+
+// Resources of ADC1..ADC3. DMA request mapping of RM0090 on DMA2, avoiding stream 0 and 3 used by
+// SPI1. In triple mode the results of the three ADCs are read from CDR by the stream of ADC1.
+static const Adc_HWUnitHwType Adc_HWUnitHw[NUM_OF_ADC_HW_UNITS] = {
+    { ADC1, RCC_APB2Periph_ADC1, DMA2_Stream4, DMA_Channel_0, ADC_DMA_FLAGS(4),
+      DMA_FLAG_HTIF4, DMA_FLAG_TCIF4, DMA_FLAG_TEIF4, DMA2_Stream4_IRQn },
+    { ADC2, RCC_APB2Periph_ADC2, DMA2_Stream2, DMA_Channel_1, ADC_DMA_FLAGS(2),
+      DMA_FLAG_HTIF2, DMA_FLAG_TCIF2, DMA_FLAG_TEIF2, DMA2_Stream2_IRQn },
+    { ADC3, RCC_APB2Periph_ADC3, DMA2_Stream1, DMA_Channel_2, ADC_DMA_FLAGS(1),
+      DMA_FLAG_HTIF1, DMA_FLAG_TCIF1, DMA_FLAG_TEIF1, DMA2_Stream1_IRQn },
+};
+
+// Conversion state of a group
+typedef struct {
+    Adc_ValueGroupType* buffer;         // Result buffer, NULL until Adc_SetupResultBuffer
+    volatile Adc_StatusType status;     // IDLE, BUSY or STREAM_COMPLETED; COMPLETED is derived
+    volatile uint8_t filled;            // The buffer has been filled since the group was started
+    Adc_StreamNumSampleType readRound;  // Round returned by the last read
+    uint8_t notification;               // Half and full notifications enabled
+} Adc_GroupStateType;
+
+static uint8_t Adc_Initialized;
+static const Adc_ConfigType* Adc_ActiveConfig;
+static Adc_GroupType Adc_HWUnitGroup[NUM_OF_ADC_HW_UNITS];     // Group converted by each unit
+static Adc_GroupStateType Adc_GroupState[ADC_MAX_GROUP];
+static Adc_GroupStatsType Adc_GroupStats[ADC_MAX_GROUP];
+
+/*
+* Function: Adc_GroupTransfers
+* Description: Number of DMA transfers filling the result buffer of a group. An interleaved
+*   group moves two results per transfer.
+* Input:
+*   - Group: Group whose transfers are counted.
+* Output: Length of the DMA transfer.
+*/
+static uint32_t Adc_GroupTransfers(Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+
+    if (groupCfg->tripleInterleaved) {
+        return groupCfg->streamSamples / 2u;
+    }
+    return (uint32_t)groupCfg->streamSamples * groupCfg->numChannels;
+}
+
+/*
+* Function: Adc_CommonCmd
+* Description: Selects independent or triple interleaved mode for the three units.
+* Input:
+*   - Triple: Non-zero for the triple interleaved mode.
+* Output: None
+*/
+static void Adc_CommonCmd(uint8_t Triple) {
+    ADC_CommonInitTypeDef ADC_CommonInitStruct;
+
+    ADC_CommonInitStruct.ADC_Mode = Triple ? ADC_TripleMode_Interl : ADC_Mode_Independent;
+    ADC_CommonInitStruct.ADC_Prescaler = Adc_ActiveConfig->prescaler;
+    // Two 12-bit results per 32-bit word of CDR
+    ADC_CommonInitStruct.ADC_DMAAccessMode = Triple ? ADC_DMAAccessMode_2 : ADC_DMAAccessMode_Disabled;
+    ADC_CommonInitStruct.ADC_TwoSamplingDelay = Adc_ActiveConfig->interleaveDelay;
+    ADC_CommonInit(&ADC_CommonInitStruct);
+}
+
+/*
+* Function: Adc_UnitInit
+* Description: Programs the regular sequence of a unit with the channels of a group, converted
+*   continuously.
+* Input:
+*   - HWUnit: Unit to program.
+*   - Group: Group whose channels are converted.
+* Output: None
+*/
+static void Adc_UnitInit(Adc_HWUnitType HWUnit, Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+    ADC_TypeDef* ADCx = Adc_HWUnitHw[HWUnit].regs;
+    ADC_InitTypeDef ADC_InitStruct;
+
+    ADC_InitStruct.ADC_Resolution = ADC_Resolution_12b;
+    ADC_InitStruct.ADC_ScanConvMode = (groupCfg->numChannels > 1u) ? ENABLE : DISABLE;
+    ADC_InitStruct.ADC_ContinuousConvMode = ENABLE;
+    ADC_InitStruct.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_None;
+    ADC_InitStruct.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T1_CC1;
+    ADC_InitStruct.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStruct.ADC_NbrOfConversion = groupCfg->numChannels;
+    ADC_Init(ADCx, &ADC_InitStruct);
+
+    for (uint8_t i = 0; i < groupCfg->numChannels; i++) {
+        ADC_RegularChannelConfig(ADCx, groupCfg->channelList[i], (uint8_t)(i + 1u), groupCfg->samplingTime);
+    }
+}
+
+/*
+* Function: Adc_DmaInit
+* Description: Points the DMA stream of a unit at the result buffer of a group. Circular groups
+*   restart the stream from the first round after the last one.
+* Input:
+*   - HWUnit: Unit whose stream is programmed.
+*   - Group: Group whose results are moved.
+* Output: None
+*/
+static void Adc_DmaInit(Adc_HWUnitType HWUnit, Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+    const Adc_HWUnitHwType* hw = &Adc_HWUnitHw[HWUnit];
+    DMA_InitTypeDef DMA_InitStruct;
+
+    DMA_Cmd(hw->stream, DISABLE);
+    DMA_DeInit(hw->stream);
+
+    DMA_InitStruct.DMA_Channel = hw->channel;
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Adc_GroupState[Group].buffer;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStruct.DMA_BufferSize = Adc_GroupTransfers(Group);
+    DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    if (groupCfg->tripleInterleaved) {
+        // The older result of a pair is in the low half of CDR, so the buffer stays in time order
+        DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&ADC->CDR;
+        DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+        DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+        DMA_InitStruct.DMA_Priority = DMA_Priority_VeryHigh;
+    } else {
+        DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&hw->regs->DR;
+        DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+        DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+        DMA_InitStruct.DMA_Priority = DMA_Priority_High;
+    }
+    DMA_InitStruct.DMA_Mode = (groupCfg->bufferMode == ADC_STREAM_BUFFER_CIRCULAR) ? DMA_Mode_Circular : DMA_Mode_Normal;
+    DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(hw->stream, &DMA_InitStruct);
+
+    DMA_ClearFlag(hw->stream, hw->flags);
+    // Half transfers only interrupt the CPU when someone is notified of them
+    DMA_ITConfig(hw->stream, DMA_IT_TC | DMA_IT_TE, ENABLE);
+    DMA_ITConfig(hw->stream, DMA_IT_HT, (groupCfg->halfNotification != NULL) ? ENABLE : DISABLE);
+    DMA_Cmd(hw->stream, ENABLE);
+}
+
+/*
+* Function: Adc_StartUnits
+* Description: Starts the conversions of a group whose units have been claimed: programs the
+*   units and the stream, then triggers ADC1 for an interleaved group or the unit of the group.
+* Input:
+*   - Group: Group to start.
+* Output: None
+*/
+static void Adc_StartUnits(Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+    ADC_TypeDef* ADCx = Adc_HWUnitHw[groupCfg->hwUnit].regs;
+    Adc_GroupStateType* state = &Adc_GroupState[Group];
+
+    state->status = ADC_BUSY;
+    state->filled = 0;
+    state->readRound = ADC_ROUND_NONE;
+
+    if (groupCfg->tripleInterleaved) {
+        Adc_CommonCmd(1);
+        for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+            Adc_UnitInit((Adc_HWUnitType)hw, Group);
+            ADC_ClearFlag(Adc_HWUnitHw[hw].regs, ADC_FLAG_OVR | ADC_FLAG_EOC);
+        }
+        Adc_DmaInit(ADC_HWUnit_0, Group);
+        // Keep requesting after the last transfer of a circular buffer
+        ADC_MultiModeDMARequestAfterLastTransferCmd(DISABLE);
+        ADC_MultiModeDMARequestAfterLastTransferCmd((groupCfg->bufferMode == ADC_STREAM_BUFFER_CIRCULAR) ? ENABLE : DISABLE);
+        for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+            ADC_Cmd(Adc_HWUnitHw[hw].regs, ENABLE);
+        }
+    } else {
+        Adc_UnitInit(groupCfg->hwUnit, Group);
+        ADC_ClearFlag(ADCx, ADC_FLAG_OVR | ADC_FLAG_EOC);
+        Adc_DmaInit(groupCfg->hwUnit, Group);
+        // The DMA bit is written to 0 then to 1 to re-arm the requests of a linear buffer
+        ADC_DMACmd(ADCx, DISABLE);
+        ADC_DMARequestAfterLastTransferCmd(ADCx, (groupCfg->bufferMode == ADC_STREAM_BUFFER_CIRCULAR) ? ENABLE : DISABLE);
+        ADC_DMACmd(ADCx, ENABLE);
+        ADC_Cmd(ADCx, ENABLE);
+    }
+    ADC_ITConfig(ADCx, ADC_IT_OVR, ENABLE);
+    ADC_SoftwareStartConv(ADCx);
+}
+
+/*
+* Function: Adc_StopUnits
+* Description: Stops the conversions of a group and its DMA stream. The units stay claimed.
+* Input:
+*   - Group: Group to stop.
+* Output: None
+*/
+static void Adc_StopUnits(Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+    const Adc_HWUnitHwType* hw = &Adc_HWUnitHw[groupCfg->hwUnit];
+
+    ADC_ITConfig(hw->regs, ADC_IT_OVR, DISABLE);
+    if (groupCfg->tripleInterleaved) {
+        for (uint8_t unit = 0; unit < NUM_OF_ADC_HW_UNITS; unit++) {
+            ADC_Cmd(Adc_HWUnitHw[unit].regs, DISABLE);
+        }
+        Adc_CommonCmd(0);
+        for (uint8_t unit = 0; unit < NUM_OF_ADC_HW_UNITS; unit++) {
+            (void)ADC_GetConversionValue(Adc_HWUnitHw[unit].regs);
+        }
+    } else {
+        ADC_Cmd(hw->regs, DISABLE);
+        ADC_DMACmd(hw->regs, DISABLE);
+        // A result left in DR would be the first one moved at the next start, shifting the rounds
+        (void)ADC_GetConversionValue(hw->regs);
+    }
+    DMA_Cmd(hw->stream, DISABLE);
+    DMA_ClearFlag(hw->stream, hw->flags);
+}
+
+/*
+* Function: Adc_ReleaseUnits
+* Description: Frees the units claimed by a group. Must be called inside an exclusive area.
+* Input:
+*   - Group: Group whose units are freed.
+* Output: None
+*/
+static void Adc_ReleaseUnits(Adc_GroupType Group) {
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        if (Adc_HWUnitGroup[hw] == Group) {
+            Adc_HWUnitGroup[hw] = ADC_GROUP_NONE;
+        }
+    }
+}
+
+/*
+* Function: Adc_LastRound
+* Description: Finds the last round of a group completely written by the DMA, from the number
+*   of transfers left in its stream.
+* Input:
+*   - Group: Group to look at.
+*   - RoundPtr: Receives the index of that round in the result buffer.
+* Output: Number of valid rounds in the buffer, 0 if no round has completed yet.
+*/
+static Adc_StreamNumSampleType Adc_LastRound(Adc_GroupType Group, Adc_StreamNumSampleType* RoundPtr) {
+    const Adc_GroupConfigType* groupCfg = &Adc_GroupConfig[Group];
+    const Adc_HWUnitHwType* hw = &Adc_HWUnitHw[groupCfg->hwUnit];
+    uint32_t transfers = Adc_GroupTransfers(Group) - DMA_GetCurrDataCounter(hw->stream);
+    uint32_t rounds = groupCfg->tripleInterleaved ? transfers * 2u : transfers / groupCfg->numChannels;
+
+    // Once a circular buffer has been filled, the round after the last one is being overwritten
+    Adc_StreamNumSampleType full = (groupCfg->bufferMode == ADC_STREAM_BUFFER_CIRCULAR) ?
+                                   (Adc_StreamNumSampleType)(groupCfg->streamSamples - 1u) : groupCfg->streamSamples;
+
+    if (rounds != 0) {
+        *RoundPtr = (Adc_StreamNumSampleType)(rounds - 1u);
+        return Adc_GroupState[Group].filled ? full : (Adc_StreamNumSampleType)rounds;
+    }
+    // The stream has just wrapped, possibly before its interrupt was served
+    if (Adc_GroupState[Group].filled || DMA_GetFlagStatus(hw->stream, hw->completeFlag) == SET) {
+        *RoundPtr = (Adc_StreamNumSampleType)(groupCfg->streamSamples - 1u);
+        return full;
+    }
+    return 0;
+}
+
+/*
+* Function: Adc_MarkRead
+* Description: Updates the status of a group after its results have been read: a circular group
+*   goes back to ADC_BUSY, a linear group that has filled its buffer to ADC_IDLE.
+* Input:
+*   - Group: Group that has been read.
+*   - Round: Round returned to the caller.
+* Output: None
+*/
+static void Adc_MarkRead(Adc_GroupType Group, Adc_StreamNumSampleType Round) {
+    Adc_GroupStateType* state = &Adc_GroupState[Group];
+    SchM_StateType schState;
+
+    SchM_Enter(schState);
+    state->readRound = Round;
+    if (state->status == ADC_STREAM_COMPLETED) {
+        state->status = (Adc_GroupConfig[Group].bufferMode == ADC_STREAM_BUFFER_LINEAR) ? ADC_IDLE : ADC_BUSY;
+    }
+    SchM_Exit(schState);
+}
+
+/*
+* Function: Adc_DmaIrqHandler
+* Description: Handles the stream interrupt of a unit: notifies the group of each half of the
+*   buffer, stops a linear group once its buffer is full and stops the group on a transfer error.
+* Input:
+*   - HWUnit: Unit whose stream raised the interrupt.
+* Output: None
+*/
+static void Adc_DmaIrqHandler(Adc_HWUnitType HWUnit) {
+    const Adc_HWUnitHwType* hw = &Adc_HWUnitHw[HWUnit];
+    Adc_GroupType group = Adc_HWUnitGroup[HWUnit];
+    const Adc_GroupConfigType* groupCfg;
+    Adc_GroupStateType* state;
+
+    if (group == ADC_GROUP_NONE) {
+        DMA_ClearFlag(hw->stream, hw->flags);
+        return;
+    }
+    groupCfg = &Adc_GroupConfig[group];
+    state = &Adc_GroupState[group];
+
+    if (DMA_GetFlagStatus(hw->stream, hw->errorFlag) == SET) {
+        Adc_StopUnits(group);
+        Adc_ReleaseUnits(group);
+        state->status = ADC_IDLE;
+        Adc_GroupStats[group].transferErrors++;
+        return;
+    }
+    if (DMA_GetFlagStatus(hw->stream, hw->halfFlag) == SET) {
+        DMA_ClearFlag(hw->stream, hw->halfFlag);
+        Adc_GroupStats[group].halfTransfers++;
+        if (state->notification && groupCfg->halfNotification != NULL) {
+            groupCfg->halfNotification();
+        }
+    }
+    if (DMA_GetFlagStatus(hw->stream, hw->completeFlag) == SET) {
+        DMA_ClearFlag(hw->stream, hw->completeFlag);
+        Adc_GroupStats[group].fullTransfers++;
+        state->filled = 1;
+        state->status = ADC_STREAM_COMPLETED;
+        if (groupCfg->bufferMode == ADC_STREAM_BUFFER_LINEAR) {
+            Adc_StopUnits(group);
+            Adc_ReleaseUnits(group);
+        }
+        if (state->notification && groupCfg->fullNotification != NULL) {
+            groupCfg->fullNotification();
+        }
+    }
+}
+
+/* Stream interrupts of the three hardware units */
+void DMA2_Stream4_IRQHandler(void) {
+    Adc_DmaIrqHandler(ADC_HWUnit_0);
+}
+
+void DMA2_Stream2_IRQHandler(void) {
+    Adc_DmaIrqHandler(ADC_HWUnit_1);
+}
+
+void DMA2_Stream1_IRQHandler(void) {
+    Adc_DmaIrqHandler(ADC_HWUnit_2);
+}
+
+/*
+* Function: ADC_IRQHandler
+* Description: Handles the overruns of the three units. A result lost by a late DMA stops the
+*   requests of the unit, so the group is restarted from the start of its buffer.
+* Input: None
+* Output: None
+*/
+void ADC_IRQHandler(void) {
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        Adc_GroupType group = Adc_HWUnitGroup[hw];
+
+        if (ADC_GetFlagStatus(Adc_HWUnitHw[hw].regs, ADC_FLAG_OVR) == RESET) {
+            continue;
+        }
+        ADC_ClearFlag(Adc_HWUnitHw[hw].regs, ADC_FLAG_OVR);
+        if (group == ADC_GROUP_NONE || Adc_GroupConfig[group].hwUnit != hw) {
+            continue;
+        }
+        Adc_GroupStats[group].overruns++;
+        Adc_StopUnits(group);
+        Adc_StartUnits(group);
+    }
+}
+
+/*
+* Function: Adc_Init
+* Description: Initializes the three units in independent mode and enables the interrupts of
+*   their DMA streams. No group is converted until Adc_StartGroupConversion.
+* Input:
+*   - ConfigPtr: Common settings, NULL for Adc_Config.
+* Output: None
+*/
+void Adc_Init(const Adc_ConfigType* ConfigPtr) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (Adc_Initialized) {
+        Adc_DeInit();
+    }
+    Adc_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Adc_Config;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        RCC_APB2PeriphClockCmd(Adc_HWUnitHw[hw].rccPeriph, ENABLE);
+        Adc_HWUnitGroup[hw] = ADC_GROUP_NONE;
+    }
+    ADC_DeInit();
+    Adc_CommonCmd(0);
+
+    for (Adc_GroupType group = 0; group < ADC_MAX_GROUP; group++) {
+        Adc_GroupState[group].buffer = NULL;
+        Adc_GroupState[group].status = ADC_IDLE;
+        Adc_GroupState[group].filled = 0;
+        Adc_GroupState[group].notification = 0;
+        Adc_ResetGroupStats(group);
+    }
+
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        NVIC_InitStruct.NVIC_IRQChannel = Adc_HWUnitHw[hw].irqn;
+        NVIC_Init(&NVIC_InitStruct);
+    }
+    NVIC_InitStruct.NVIC_IRQChannel = ADC_IRQn;
+    NVIC_Init(&NVIC_InitStruct);
+
+    Adc_Initialized = 1;
+}
+
+/*
+* Function: Adc_DeInit
+* Description: Stops every group, resets the units and switches their clocks off.
+* Input: None
+* Output: None
+*/
+void Adc_DeInit(void) {
+    if (!Adc_Initialized) {
+        return;
+    }
+    for (Adc_GroupType group = 0; group < ADC_MAX_GROUP; group++) {
+        Adc_StopGroupConversion(group);
+    }
+    ADC_DeInit();
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        RCC_APB2PeriphClockCmd(Adc_HWUnitHw[hw].rccPeriph, DISABLE);
+    }
+    Adc_Initialized = 0;
+}
+
+/*
+* Function: Adc_SetupResultBuffer
+* Description: Sets the buffer receiving the results of a group. It holds streamSamples rounds of
+*   numChannels results, sample-major, and must stay valid while the group is converted.
+* Input:
+*   - Group: Group whose buffer is set.
+*   - DataBufferPtr: Result buffer, 4-byte aligned for an interleaved group.
+* Output:
+*   - E_OK: If the buffer has been set.
+*   - E_NOT_OK: If the driver is not initialized, the group is invalid or being converted, or
+*     the buffer is NULL.
+*/
+Std_ReturnType Adc_SetupResultBuffer(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr) {
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP || DataBufferPtr == NULL ||
+        Adc_GroupState[Group].status != ADC_IDLE) {
+        return E_NOT_OK;
+    }
+    Adc_GroupState[Group].buffer = DataBufferPtr;
+    return E_OK;
+}
+
+/*
+* Function: Adc_StartGroupConversion
+* Description: Starts the continuous conversion of a group into its result buffer. An interleaved
+*   group needs the three units free, the other groups their own unit.
+* Input:
+*   - Group: Group to start.
+* Output:
+*   - E_OK: If the conversions have started.
+*   - E_NOT_OK: If the driver is not initialized, the group is invalid, has no buffer, is already
+*     converted or one of its units is busy with another group.
+*/
+Std_ReturnType Adc_StartGroupConversion(Adc_GroupType Group) {
+    const Adc_GroupConfigType* groupCfg;
+    SchM_StateType schState;
+
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP || Adc_GroupState[Group].buffer == NULL) {
+        return E_NOT_OK;
+    }
+    groupCfg = &Adc_GroupConfig[Group];
+
+    // Claim the units of the group
+    SchM_Enter(schState);
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        if ((groupCfg->tripleInterleaved || hw == groupCfg->hwUnit) && Adc_HWUnitGroup[hw] != ADC_GROUP_NONE) {
+            SchM_Exit(schState);
+            return E_NOT_OK;
+        }
+    }
+    for (uint8_t hw = 0; hw < NUM_OF_ADC_HW_UNITS; hw++) {
+        if (groupCfg->tripleInterleaved || hw == groupCfg->hwUnit) {
+            Adc_HWUnitGroup[hw] = Group;
+        }
+    }
+    SchM_Exit(schState);
+
+    Adc_StartUnits(Group);
+    return E_OK;
+}
+
+/*
+* Function: Adc_StopGroupConversion
+* Description: Stops the conversion of a group and frees its units. The results already in the
+*   buffer are kept but the group becomes ADC_IDLE.
+* Input:
+*   - Group: Group to stop.
+* Output:
+*   - E_OK: If the group has been stopped.
+*   - E_NOT_OK: If the driver is not initialized, the group is invalid or not converted.
+*/
+Std_ReturnType Adc_StopGroupConversion(Adc_GroupType Group) {
+    SchM_StateType schState;
+
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(schState);
+    if (Adc_HWUnitGroup[Adc_GroupConfig[Group].hwUnit] != Group) {
+        // Not started, or a linear group that has already filled its buffer
+        if (Adc_GroupState[Group].status == ADC_IDLE) {
+            SchM_Exit(schState);
+            return E_NOT_OK;
+        }
+    } else {
+        Adc_StopUnits(Group);
+        Adc_ReleaseUnits(Group);
+    }
+    Adc_GroupState[Group].status = ADC_IDLE;
+    SchM_Exit(schState);
+    return E_OK;
+}
+
+/*
+* Function: Adc_ReadGroup
+* Description: Copies the last complete round of a group, one result per channel in channelList
+*   order. The DMA keeps writing the other rounds meanwhile.
+* Input:
+*   - Group: Group to read.
+*   - DataBufferPtr: Receives numChannels results.
+* Output:
+*   - E_OK: If a round has been copied.
+*   - E_NOT_OK: If the group is invalid, idle or has not completed a round yet.
+*/
+Std_ReturnType Adc_ReadGroup(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr) {
+    const Adc_GroupConfigType* groupCfg;
+    const Adc_ValueGroupType* round;
+    Adc_StreamNumSampleType last;
+
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP || DataBufferPtr == NULL ||
+        Adc_GroupState[Group].status == ADC_IDLE || Adc_LastRound(Group, &last) == 0) {
+        return E_NOT_OK;
+    }
+    groupCfg = &Adc_GroupConfig[Group];
+    round = &Adc_GroupState[Group].buffer[(uint32_t)last * groupCfg->numChannels];
+    for (uint8_t i = 0; i < groupCfg->numChannels; i++) {
+        DataBufferPtr[i] = round[i];
+    }
+    Adc_MarkRead(Group, last);
+    return E_OK;
+}
+
+/*
+* Function: Adc_GetGroupStatus
+* Description: Returns the conversion status of a group. ADC_COMPLETED is reported while the
+*   group is converted and a round has completed since the last read.
+* Input:
+*   - Group: Group whose status is returned.
+* Output: Status of the group, ADC_IDLE for an invalid group.
+*/
+Adc_StatusType Adc_GetGroupStatus(Adc_GroupType Group) {
+    Adc_StreamNumSampleType last;
+    Adc_StatusType status;
+
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP) {
+        return ADC_IDLE;
+    }
+    status = Adc_GroupState[Group].status;
+    if (status == ADC_BUSY && Adc_LastRound(Group, &last) != 0 && last != Adc_GroupState[Group].readRound) {
+        status = ADC_COMPLETED;
+    }
+    return status;
+}
+
+/*
+* Function: Adc_GetStreamLastPointer
+* Description: Gives access to the results of a group in place: the pointer designates the last
+*   complete round, the rounds before it (wrapping around in a circular buffer) are the older ones.
+* Input:
+*   - Group: Group to look at.
+*   - PtrToSamplePtr: Receives the address of the first result of the last round, NULL if none.
+* Output: Number of valid rounds in the buffer, 0 if none.
+*/
+Adc_StreamNumSampleType Adc_GetStreamLastPointer(Adc_GroupType Group, Adc_ValueGroupType** PtrToSamplePtr) {
+    Adc_StreamNumSampleType last;
+    Adc_StreamNumSampleType valid;
+
+    if (PtrToSamplePtr == NULL) {
+        return 0;
+    }
+    *PtrToSamplePtr = NULL;
+    if (!Adc_Initialized || Group >= ADC_MAX_GROUP || Adc_GroupState[Group].status == ADC_IDLE) {
+        return 0;
+    }
+    valid = Adc_LastRound(Group, &last);
+    if (valid == 0) {
+        return 0;
+    }
+    *PtrToSamplePtr = &Adc_GroupState[Group].buffer[(uint32_t)last * Adc_GroupConfig[Group].numChannels];
+    Adc_MarkRead(Group, last);
+    return valid;
+}
+
+/*
+* Function: Adc_EnableGroupNotification
+* Description: Enables the half and full notifications of a group.
+* Input:
+*   - Group: Group to notify.
+* Output: None
+*/
+void Adc_EnableGroupNotification(Adc_GroupType Group) {
+    if (Group < ADC_MAX_GROUP) {
+        Adc_GroupState[Group].notification = 1;
+    }
+}
+
+/*
+* Function: Adc_DisableGroupNotification
+* Description: Disables the half and full notifications of a group.
+* Input:
+*   - Group: Group no longer notified.
+* Output: None
+*/
+void Adc_DisableGroupNotification(Adc_GroupType Group) {
+    if (Group < ADC_MAX_GROUP) {
+        Adc_GroupState[Group].notification = 0;
+    }
+}
+
+/*
+* Function: Adc_GetGroupStats
+* Description: Copies the counters of a group.
+* Input:
+*   - Group: Group whose counters are read.
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters have been copied.
+*   - E_NOT_OK: If the group is invalid or StatsPtr is NULL.
+*/
+Std_ReturnType Adc_GetGroupStats(Adc_GroupType Group, Adc_GroupStatsType* StatsPtr) {
+    SchM_StateType schState;
+
+    if (Group >= ADC_MAX_GROUP || StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(schState);
+    *StatsPtr = Adc_GroupStats[Group];
+    SchM_Exit(schState);
+    return E_OK;
+}
+
+/*
+* Function: Adc_ResetGroupStats
+* Description: Clears the counters of a group.
+* Input:
+*   - Group: Group whose counters are cleared.
+* Output:
+*   - E_OK: If the counters have been cleared.
+*   - E_NOT_OK: If the group is invalid.
+*/
+Std_ReturnType Adc_ResetGroupStats(Adc_GroupType Group) {
+    SchM_StateType schState;
+
+    if (Group >= ADC_MAX_GROUP) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(schState);
+    Adc_GroupStats[Group].halfTransfers = 0;
+    Adc_GroupStats[Group].fullTransfers = 0;
+    Adc_GroupStats[Group].overruns = 0;
+    Adc_GroupStats[Group].transferErrors = 0;
+    SchM_Exit(schState);
+    return E_OK;
+}
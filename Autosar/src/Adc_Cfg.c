@@ -0,0 +1,27 @@
+/*
+* File: Adc_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Group configuration of the ADC driver.
+*/
+
+#include "Adc.h"
+
+/* Common settings of the three units, see Adc_Cfg.h */
+const Adc_ConfigType Adc_Config = { ADC_CLOCK_PRESCALER, ADC_INTERLEAVE_DELAY };
+
+/* Analog inputs: PA1 = ADC123_IN1, PC0..PC3 = ADC123_IN10..IN13 */
+static const Adc_ChannelType Adc_SensorsChannels[] = { ADC_Channel_10, ADC_Channel_11, ADC_Channel_1 };
+static const Adc_ChannelType Adc_SupplyChannels[] = { ADC_Channel_13 };
+static const Adc_ChannelType Adc_CaptureChannels[] = { ADC_Channel_12 };
+
+const Adc_GroupConfigType Adc_GroupConfig[ADC_MAX_GROUP] = {
+    /* hwUnit, channelList, numChannels, samplingTime, bufferMode, streamSamples, tripleInterleaved,
+       halfNotification, fullNotification */
+    { ADC_HWUnit_0, Adc_SensorsChannels, 3, ADC_SampleTime_56Cycles, ADC_STREAM_BUFFER_CIRCULAR,
+      ADC_SENSORS_SAMPLES, 0, NULL, NULL },                                             /* ADC_GROUP_SENSORS */
+    { ADC_HWUnit_1, Adc_SupplyChannels, 1, ADC_SampleTime_480Cycles, ADC_STREAM_BUFFER_LINEAR,
+      ADC_SUPPLY_SAMPLES, 0, NULL, NULL },                                              /* ADC_GROUP_SUPPLY */
+    { ADC_HWUnit_0, Adc_CaptureChannels, 1, ADC_SampleTime_3Cycles, ADC_STREAM_BUFFER_CIRCULAR,
+      ADC_CAPTURE_SAMPLES, 1, AdcCapture_HalfNotification, AdcCapture_FullNotification },  /* ADC_GROUP_CAPTURE */
+};
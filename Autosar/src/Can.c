@@ -0,0 +1,923 @@
+/*
+* File: Can.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Can.h containing the implementation of the CAN driver.
+*/
+
+#include "Can.h"
+#include "SchM.h"
+#include <stdint.h>
+
+#define CAN_NUM_MAILBOXES   3u
+#define CAN_NUM_FIFOS       2u
+#define CAN_TX_SLOTS        (CAN_TX_QUEUE_SIZE + CAN_NUM_MAILBOXES)
+#define CAN_RX_QUEUE_MASK   (CAN_RX_QUEUE_SIZE - 1u)
+
+// Value of a mailbox entry holding no frame, and of a mailbox search that found none
+#define CAN_NO_FRAME        0xFFu
+#define CAN_NO_MAILBOX      0xFFu
+
+// Bits of mailbox n in CAN_TSR
+#define CAN_TSR_RQCP(n)     (CAN_TSR_RQCP0 << (8u * (n)))
+#define CAN_TSR_TXOK(n)     (CAN_TSR_TXOK0 << (8u * (n)))
+#define CAN_TSR_ABRQ(n)     (CAN_TSR_ABRQ0 << (8u * (n)))
+#define CAN_TSR_RQCP_ALL    (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2)
+#define CAN_TSR_ABRQ_ALL    (CAN_TSR_ABRQ0 | CAN_TSR_ABRQ1 | CAN_TSR_ABRQ2)
+
+// Registers and interrupt lines of a controller
+typedef struct {
+    CAN_TypeDef* regs;
+    uint32_t rccPeriph;                 // RCC_APB1Periph_CANx
+    IRQn_Type txIrqn;
+    IRQn_Type rx0Irqn;
+    IRQn_Type rx1Irqn;
+    uint8_t firstFilterBank;            // Filter banks owned by the controller
+    uint8_t endFilterBank;
+} Can_ControllerHwType;
+
+static const Can_ControllerHwType Can_ControllerHw[CAN_NUM_CONTROLLERS] = {
+    { CAN1, RCC_APB1Periph_CAN1, CAN1_TX_IRQn, CAN1_RX0_IRQn, CAN1_RX1_IRQn, 0, CAN_SLAVE_START_BANK },
+    { CAN2, RCC_APB1Periph_CAN2, CAN2_TX_IRQn, CAN2_RX0_IRQn, CAN2_RX1_IRQn, CAN_SLAVE_START_BANK, CAN_NUM_FILTER_BANKS },
+};
+
+// Frame waiting for or loaded into a mailbox, in the layout of the mailbox registers
+typedef struct {
+    uint32_t key;                       // Arbitration priority, the lowest value wins the bus
+    uint32_t seq;                       // Write order, keeps frames with the same identifier in order
+    uint32_t tir;                       // CAN_TIxR without TXRQ
+    uint32_t tdtr;                      // CAN_TDTxR, data length
+    uint32_t data[2];                   // CAN_TDLxR and CAN_TDHxR
+    PduIdType pduId;                    // Handle returned by the confirmation
+} Can_TxFrameType;
+
+// Transmit side of a controller. Frames are kept in slots; the queue is a binary heap of slot
+// numbers ordered by arbitration priority, so the mailboxes always get the most urgent frames.
+typedef struct {
+    Can_TxFrameType frames[CAN_TX_SLOTS];
+    uint8_t freeSlots[CAN_TX_SLOTS];    // Stack of unused slots
+    uint8_t numFree;
+    uint8_t heap[CAN_TX_SLOTS];         // Queued slots, aborted frames come back here
+    uint8_t heapCount;
+    uint8_t mailbox[CAN_NUM_MAILBOXES]; // Slot loaded into each mailbox, CAN_NO_FRAME if empty
+    uint8_t aborting;                   // Mailboxes with an abort request, one bit each
+    uint32_t nextSeq;
+} Can_TxStateType;
+
+// Received frame, copied from the FIFO mailbox registers, with its frame of CAN_RX_PDUS
+typedef struct {
+    uint32_t rir;
+    uint8_t dlc;
+    uint8_t pdu;                        // Can_RxPduIdType, CAN_NUM_RX_PDUS if not listed
+    uint32_t data[2];
+} Can_RxFrameType;
+
+// Single producer (receive interrupt), single consumer (Can_MainFunction_Read) queue of a FIFO
+typedef struct {
+    volatile uint32_t head;             // Frames written, free-running
+    volatile uint32_t tail;             // Frames indicated, free-running
+    Can_RxFrameType frames[CAN_RX_QUEUE_SIZE];
+} Can_RxQueueType;
+
+static const Can_ConfigType* Can_ConfigPtr = &Can_Config;
+static Can_ControllerStateType Can_ControllerState[CAN_NUM_CONTROLLERS];
+static uint8_t Can_IrqDisableCount[CAN_NUM_CONTROLLERS];
+static Can_TxStateType Can_TxState[CAN_NUM_CONTROLLERS];
+static Can_RxQueueType Can_RxQueue[CAN_NUM_CONTROLLERS][CAN_NUM_FIFOS];
+static Can_ControllerStatsType Can_Stats[CAN_NUM_CONTROLLERS];
+
+/*
+* Function: Can_TxBefore
+* Description: Tells whether a frame has to be sent before another one: it wins the arbitration,
+*   or it has the same identifier and was written first.
+* Input:
+*   - A, B: Frames to compare.
+* Output:
+*   - 1 if A goes first, 0 otherwise.
+*/
+static uint8_t Can_TxBefore(const Can_TxFrameType* A, const Can_TxFrameType* B) {
+    return (A->key < B->key) || (A->key == B->key && (int32_t)(A->seq - B->seq) < 0);
+}
+
+/*
+* Function: Can_TxPush
+* Description: Inserts a slot into the transmit queue of a controller.
+* Input:
+*   - Tx: Transmit side of the controller.
+*   - Slot: Slot holding the frame.
+* Output: None
+*/
+static void Can_TxPush(Can_TxStateType* Tx, uint8_t Slot) {
+    uint8_t i = Tx->heapCount++;
+
+    while (i > 0) {
+        uint8_t parent = (uint8_t)((i - 1u) / 2u);
+        if (!Can_TxBefore(&Tx->frames[Slot], &Tx->frames[Tx->heap[parent]])) {
+            break;
+        }
+        Tx->heap[i] = Tx->heap[parent];
+        i = parent;
+    }
+    Tx->heap[i] = Slot;
+}
+
+/*
+* Function: Can_TxPop
+* Description: Removes the most urgent slot from the transmit queue of a controller.
+* Input:
+*   - Tx: Transmit side of the controller, with a non-empty queue.
+* Output:
+*   - Slot removed.
+*/
+static uint8_t Can_TxPop(Can_TxStateType* Tx) {
+    uint8_t top = Tx->heap[0];
+    uint8_t last = Tx->heap[--Tx->heapCount];
+    uint8_t i = 0;
+
+    for (;;) {
+        uint8_t child = (uint8_t)(2u * i + 1u);
+        if (child >= Tx->heapCount) {
+            break;
+        }
+        if (child + 1u < Tx->heapCount && Can_TxBefore(&Tx->frames[Tx->heap[child + 1u]], &Tx->frames[Tx->heap[child]])) {
+            child++;
+        }
+        if (!Can_TxBefore(&Tx->frames[Tx->heap[child]], &Tx->frames[last])) {
+            break;
+        }
+        Tx->heap[i] = Tx->heap[child];
+        i = child;
+    }
+    Tx->heap[i] = last;
+    return top;
+}
+
+/*
+* Function: Can_TxReset
+* Description: Drops every frame of a controller, queued or in a mailbox.
+* Input:
+*   - Controller: Controller to reset.
+* Output: None
+*/
+static void Can_TxReset(uint8_t Controller) {
+    Can_TxStateType* tx = &Can_TxState[Controller];
+
+    for (uint8_t i = 0; i < CAN_TX_SLOTS; i++) {
+        tx->freeSlots[i] = i;
+    }
+    tx->numFree = CAN_TX_SLOTS;
+    tx->heapCount = 0;
+    for (uint8_t mbx = 0; mbx < CAN_NUM_MAILBOXES; mbx++) {
+        tx->mailbox[mbx] = CAN_NO_FRAME;
+    }
+    tx->aborting = 0;
+}
+
+/*
+* Function: Can_TxLoad
+* Description: Writes a frame into an empty mailbox and requests its transmission. CAN_Transmit is
+*   not used: it takes any mailbox with TME set, including one whose completion is not processed yet.
+* Input:
+*   - CANx: Controller registers.
+*   - Mailbox: Empty mailbox.
+*   - Frame: Frame to transmit.
+* Output: None
+*/
+static void Can_TxLoad(CAN_TypeDef* CANx, uint8_t Mailbox, const Can_TxFrameType* Frame) {
+    CAN_TxMailBox_TypeDef* mbx = &CANx->sTxMailBox[Mailbox];
+
+    WRITE_REG(mbx->TDTR, Frame->tdtr);
+    WRITE_REG(mbx->TDLR, Frame->data[0]);
+    WRITE_REG(mbx->TDHR, Frame->data[1]);
+    WRITE_REG(mbx->TIR, Frame->tir | CAN_TI0R_TXRQ);
+}
+
+/*
+* Function: Can_TxFill
+* Description: Loads the most urgent queued frames into the empty mailboxes. A frame is held back
+*   while a frame with the same identifier is pending, since the mailboxes are served by
+*   identifier and would not keep their order. When every mailbox is busy and the most urgent
+*   queued frame would win the arbitration against one of them, the least urgent mailbox is
+*   aborted so that frame does not wait behind lower priority traffic; the aborted frame returns
+*   to the queue. Called with interrupts masked.
+* Input:
+*   - Controller: Controller to serve.
+* Output: None
+*/
+static void Can_TxFill(uint8_t Controller) {
+    Can_TxStateType* tx = &Can_TxState[Controller];
+    CAN_TypeDef* CANx = Can_ControllerHw[Controller].regs;
+
+    while (tx->heapCount != 0) {
+        const Can_TxFrameType* next = &tx->frames[tx->heap[0]];
+        uint8_t empty = CAN_NO_MAILBOX;
+        uint8_t lowest = CAN_NO_MAILBOX;
+
+        for (uint8_t mbx = 0; mbx < CAN_NUM_MAILBOXES; mbx++) {
+            uint8_t slot = tx->mailbox[mbx];
+            if (slot == CAN_NO_FRAME) {
+                if (empty == CAN_NO_MAILBOX) {
+                    empty = mbx;
+                }
+            } else if (tx->frames[slot].key == next->key) {
+                return;
+            } else if (lowest == CAN_NO_MAILBOX || Can_TxBefore(&tx->frames[tx->mailbox[lowest]], &tx->frames[slot])) {
+                lowest = mbx;
+            }
+        }
+
+        if (empty != CAN_NO_MAILBOX) {
+            Can_TxLoad(CANx, empty, next);
+            tx->mailbox[empty] = Can_TxPop(tx);
+            continue;
+        }
+
+        if (Can_TxBefore(next, &tx->frames[tx->mailbox[lowest]]) && (tx->aborting & (1u << lowest)) == 0) {
+            tx->aborting |= (uint8_t)(1u << lowest);
+            WRITE_REG(CANx->TSR, CAN_TSR_ABRQ(lowest));
+            Can_Stats[Controller].txAborts++;
+        }
+        return;
+    }
+}
+
+/*
+* Function: Can_TxProcess
+* Description: Frees the mailboxes whose request has completed: transmitted frames are returned
+*   for confirmation, aborted ones go back to the queue. Then refills the mailboxes. Called with
+*   interrupts masked.
+* Input:
+*   - Controller: Controller to serve.
+*   - Confirmed: Receives the handles of the transmitted frames.
+* Output:
+*   - Number of handles written to Confirmed.
+*/
+static uint8_t Can_TxProcess(uint8_t Controller, PduIdType Confirmed[CAN_NUM_MAILBOXES]) {
+    Can_TxStateType* tx = &Can_TxState[Controller];
+    CAN_TypeDef* CANx = Can_ControllerHw[Controller].regs;
+    uint32_t tsr = READ_REG(CANx->TSR);
+    uint8_t count = 0;
+
+    if ((tsr & CAN_TSR_RQCP_ALL) == 0) {
+        return 0;
+    }
+
+    for (uint8_t mbx = 0; mbx < CAN_NUM_MAILBOXES; mbx++) {
+        uint8_t slot = tx->mailbox[mbx];
+        if (slot == CAN_NO_FRAME || (tsr & CAN_TSR_RQCP(mbx)) == 0) {
+            continue;
+        }
+        tx->mailbox[mbx] = CAN_NO_FRAME;
+        tx->aborting &= (uint8_t)~(1u << mbx);
+        if (tsr & CAN_TSR_TXOK(mbx)) {
+            Confirmed[count++] = tx->frames[slot].pduId;
+            tx->freeSlots[tx->numFree++] = slot;
+            Can_Stats[Controller].txFrames++;
+        } else {
+            // Aborted before it won the bus: it keeps its place among frames of the same identifier
+            Can_TxPush(tx, slot);
+        }
+    }
+
+    // Clearing RQCP also clears the TXOK, ALST and TERR bits of the mailbox
+    WRITE_REG(CANx->TSR, tsr & CAN_TSR_RQCP_ALL);
+    Can_TxFill(Controller);
+    return count;
+}
+
+/*
+* Function: Can_TxConfirm
+* Description: Confirms transmitted frames to the upper layer, outside of the exclusive area.
+* Input:
+*   - Confirmed: Handles of the frames.
+*   - Count: Number of handles.
+* Output: None
+*/
+static void Can_TxConfirm(const PduIdType* Confirmed, uint8_t Count) {
+    if (Can_ConfigPtr->txConfirmation == NULL) {
+        return;
+    }
+    for (uint8_t i = 0; i < Count; i++) {
+        Can_ConfigPtr->txConfirmation(Confirmed[i]);
+    }
+}
+
+/*
+* Function: Can_TxIrqHandler
+* Description: Transmit mailbox empty interrupt of a controller.
+* Input:
+*   - Controller: Controller that raised the interrupt.
+* Output: None
+*/
+static void Can_TxIrqHandler(uint8_t Controller) {
+    PduIdType confirmed[CAN_NUM_MAILBOXES];
+    SchM_StateType state;
+    uint8_t count;
+
+    // Can_Write may run in a higher priority interrupt
+    SchM_Enter(state);
+    Can_Stats[Controller].interrupts++;
+    count = Can_TxProcess(Controller, confirmed);
+    SchM_Exit(state);
+    Can_TxConfirm(confirmed, count);
+}
+
+/*
+* Function: Can_RxId
+* Description: Extracts the identifier of a received frame.
+* Input:
+*   - Rir: CAN_RIxR of the frame.
+* Output:
+*   - Identifier, CAN_ID_EXTENDED set for an extended frame.
+*/
+static Can_IdType Can_RxId(uint32_t Rir) {
+    if (Rir & CAN_RI0R_IDE) {
+        return ((Rir >> 3) & CAN_ID_EXTENDED_MASK) | CAN_ID_EXTENDED;
+    }
+    return Rir >> 21;
+}
+
+/*
+* Function: Can_RxLookup
+* Description: Looks an identifier up in the hash table of a receive hardware object: one
+*   multiplication and one comparison.
+* Input:
+*   - Hash: Hash table of the hardware object in Can_RxSlotTable.
+*   - Id: Received identifier.
+* Output:
+*   - Frame of CAN_RX_PDUS with this identifier, CAN_NUM_RX_PDUS if the identifier is not listed.
+*/
+static uint8_t Can_RxLookup(const Can_RxHashType* Hash, Can_IdType Id) {
+    const Can_RxSlotType* slot = &Can_RxSlotTable[Hash->first + ((uint32_t)(Id * Hash->multiplier) >> Hash->shift)];
+    return (slot->id == Id) ? slot->pdu : (uint8_t)CAN_NUM_RX_PDUS;
+}
+
+/*
+* Function: Can_RxDrain
+* Description: Moves every frame of an RX FIFO into its queue and releases the FIFO, so the three
+*   hardware slots are free again within one interrupt. Each frame is looked up once here, and its
+*   frame of CAN_RX_PDUS travels with it to the upper layer. Frames that do not fit into the queue
+*   are dropped and counted, as are frames a filter mask let through that are not in CAN_RX_PDUS. Runs
+*   in the receive interrupt, or in Can_MainFunction_Read while the interrupts of the controller
+*   are disabled.
+* Input:
+*   - Controller: Controller to serve.
+*   - Fifo: CAN_FIFO0 or CAN_FIFO1.
+* Output: None
+*/
+static void Can_RxDrain(uint8_t Controller, uint8_t Fifo) {
+    CAN_TypeDef* CANx = Can_ControllerHw[Controller].regs;
+    volatile uint32_t* rfr = &CANx->RF0R + Fifo;
+    CAN_FIFOMailBox_TypeDef* mbx = &CANx->sFIFOMailBox[Fifo];
+    Can_RxQueueType* queue = &Can_RxQueue[Controller][Fifo];
+    const Can_RxHashType* hash = &Can_RxHash[Controller * CAN_NUM_FIFOS + Fifo];
+    uint32_t head = queue->head;
+    uint32_t status;
+
+    while (((status = READ_REG(*rfr)) & CAN_RF0R_FMP0) != 0) {
+        uint32_t rir = READ_REG(mbx->RIR);
+        uint8_t pdu = Can_RxLookup(hash, Can_RxId(rir));
+
+        if (hash->check && pdu == CAN_NUM_RX_PDUS) {
+            Can_Stats[Controller].rxRejected++;
+        } else if (head - queue->tail < CAN_RX_QUEUE_SIZE) {
+            Can_RxFrameType* frame = &queue->frames[head & CAN_RX_QUEUE_MASK];
+            frame->rir = rir;
+            frame->dlc = (uint8_t)(READ_REG(mbx->RDTR) & CAN_RDT0R_DLC);
+            frame->pdu = pdu;
+            frame->data[0] = READ_REG(mbx->RDLR);
+            frame->data[1] = READ_REG(mbx->RDHR);
+            head++;
+        } else {
+            Can_Stats[Controller].rxQueueFull++;
+        }
+        if (status & CAN_RF0R_FOVR0) {
+            Can_Stats[Controller].rxOverruns++;
+        }
+        // Release the output mailbox and clear the overrun flag (RF0R and RF1R share the layout)
+        WRITE_REG(*rfr, CAN_RF0R_RFOM0 | (status & CAN_RF0R_FOVR0));
+    }
+
+    // Publish the frames once they are complete
+    SchM_MemoryBarrier();
+    queue->head = head;
+}
+
+/*
+* Function: Can_RxIrqHandler
+* Description: Message pending interrupt of an RX FIFO.
+* Input:
+*   - Controller: Controller that raised the interrupt.
+*   - Fifo: FIFO with pending messages.
+* Output: None
+*/
+static void Can_RxIrqHandler(uint8_t Controller, uint8_t Fifo) {
+    Can_Stats[Controller].interrupts++;
+    Can_RxDrain(Controller, Fifo);
+}
+
+/* Interrupts of the two controllers */
+void CAN1_TX_IRQHandler(void) {
+    Can_TxIrqHandler(CAN_CONTROLLER_1);
+}
+
+void CAN1_RX0_IRQHandler(void) {
+    Can_RxIrqHandler(CAN_CONTROLLER_1, CAN_FIFO0);
+}
+
+void CAN1_RX1_IRQHandler(void) {
+    Can_RxIrqHandler(CAN_CONTROLLER_1, CAN_FIFO1);
+}
+
+void CAN2_TX_IRQHandler(void) {
+    Can_TxIrqHandler(CAN_CONTROLLER_2);
+}
+
+void CAN2_RX0_IRQHandler(void) {
+    Can_RxIrqHandler(CAN_CONTROLLER_2, CAN_FIFO0);
+}
+
+void CAN2_RX1_IRQHandler(void) {
+    Can_RxIrqHandler(CAN_CONTROLLER_2, CAN_FIFO1);
+}
+
+/*
+* Function: Can_IrqCmd
+* Description: Enables or disables the transmit and receive interrupts of a controller.
+* Input:
+*   - Controller: Controller to configure.
+*   - NewState: ENABLE or DISABLE.
+* Output: None
+*/
+static void Can_IrqCmd(uint8_t Controller, FunctionalState NewState) {
+    CAN_ITConfig(Can_ControllerHw[Controller].regs, CAN_IT_TME | CAN_IT_FMP0 | CAN_IT_FMP1, NewState);
+}
+
+/*
+* Function: Can_StopController
+* Description: Puts a controller into initialization mode. Pending transmissions are aborted and
+*   queued frames dropped without confirmation; received frames already queued are still
+*   indicated.
+* Input:
+*   - Controller: Controller to stop.
+* Output: None
+*/
+static void Can_StopController(uint8_t Controller) {
+    CAN_TypeDef* CANx = Can_ControllerHw[Controller].regs;
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    Can_ControllerState[Controller] = CAN_CS_STOPPED;
+    Can_IrqCmd(Controller, DISABLE);
+    Can_TxReset(Controller);
+    SchM_Exit(state);
+
+    // Waits for the end of the frame on the bus, with the interrupts of the controller off
+    WRITE_REG(CANx->TSR, CAN_TSR_ABRQ_ALL);
+    (void)CAN_OperatingModeRequest(CANx, CAN_OperatingMode_Initialization);
+    WRITE_REG(CANx->TSR, CAN_TSR_RQCP_ALL);
+}
+
+/*
+* Function: Can_FilterInitBank
+* Description: Programs one filter bank.
+* Input:
+*   - Bank: Filter bank.
+*   - Filter: Register values of the bank.
+* Output: None
+*/
+static void Can_FilterInitBank(uint8_t Bank, const Can_FilterBankConfigType* Filter) {
+    CAN_FilterInitTypeDef CAN_FilterInitStruct;
+
+    CAN_FilterInitStruct.CAN_FilterNumber = Bank;
+    CAN_FilterInitStruct.CAN_FilterMode = Filter->mode;
+    CAN_FilterInitStruct.CAN_FilterScale = Filter->scale;
+    if (Filter->scale == CAN_FilterScale_32bit) {
+        CAN_FilterInitStruct.CAN_FilterIdHigh = (uint16_t)(Filter->fr1 >> 16);
+        CAN_FilterInitStruct.CAN_FilterIdLow = (uint16_t)Filter->fr1;
+        CAN_FilterInitStruct.CAN_FilterMaskIdHigh = (uint16_t)(Filter->fr2 >> 16);
+        CAN_FilterInitStruct.CAN_FilterMaskIdLow = (uint16_t)Filter->fr2;
+    } else {
+        // CAN_FilterInit writes FR1 = MaskIdLow:IdLow and FR2 = MaskIdHigh:IdHigh in 16-bit scale
+        CAN_FilterInitStruct.CAN_FilterIdLow = (uint16_t)Filter->fr1;
+        CAN_FilterInitStruct.CAN_FilterMaskIdLow = (uint16_t)(Filter->fr1 >> 16);
+        CAN_FilterInitStruct.CAN_FilterIdHigh = (uint16_t)Filter->fr2;
+        CAN_FilterInitStruct.CAN_FilterMaskIdHigh = (uint16_t)(Filter->fr2 >> 16);
+    }
+    CAN_FilterInitStruct.CAN_FilterFIFOAssignment = Filter->fifo;
+    CAN_FilterInitStruct.CAN_FilterActivation = ENABLE;
+    CAN_FilterInit(&CAN_FilterInitStruct);
+}
+
+/*
+* Function: Can_Init
+* Description: Initializes the enabled controllers of Can_ControllerConfig and their filters. The
+*   controllers are left in CAN_CS_STOPPED until started with Can_SetControllerMode. Mailboxes are
+*   served by identifier priority, lost arbitration and errors are retransmitted by the hardware,
+*   bus-off is handled by Can_MainFunction_BusOff.
+* Input:
+*   - Config: Notifications of the upper layer, NULL for Can_Config.
+* Output: None
+*/
+void Can_Init(const Can_ConfigType* Config) {
+    CAN_InitTypeDef CAN_InitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
+    uint8_t nextBank[CAN_NUM_CONTROLLERS];
+
+    Can_ConfigPtr = (Config != NULL) ? Config : &Can_Config;
+
+    // CAN2 uses the filter banks of CAN1, which is therefore always clocked
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_CAN1, ENABLE);
+
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        const Can_ControllerConfigType* cfg = &Can_ControllerConfig[ctrl];
+        const Can_ControllerHwType* hw = &Can_ControllerHw[ctrl];
+
+        Can_ControllerState[ctrl] = CAN_CS_UNINIT;
+        Can_IrqDisableCount[ctrl] = 0;
+        Can_TxReset(ctrl);
+        Can_TxState[ctrl].nextSeq = 0;
+        for (uint8_t fifo = 0; fifo < CAN_NUM_FIFOS; fifo++) {
+            Can_RxQueue[ctrl][fifo].head = 0;
+            Can_RxQueue[ctrl][fifo].tail = 0;
+        }
+        Can_ResetControllerStats(ctrl);
+        nextBank[ctrl] = hw->firstFilterBank;
+
+        if (!cfg->enabled) {
+            continue;
+        }
+
+        RCC_APB1PeriphClockCmd(hw->rccPeriph, ENABLE);
+        CAN_DeInit(hw->regs);
+
+        CAN_InitStruct.CAN_TTCM = DISABLE;
+        CAN_InitStruct.CAN_ABOM = DISABLE;
+        CAN_InitStruct.CAN_AWUM = DISABLE;
+        CAN_InitStruct.CAN_NART = DISABLE;
+        CAN_InitStruct.CAN_RFLM = DISABLE;
+        CAN_InitStruct.CAN_TXFP = DISABLE;
+        CAN_InitStruct.CAN_Mode = cfg->mode;
+        CAN_InitStruct.CAN_SJW = cfg->sjw;
+        CAN_InitStruct.CAN_BS1 = cfg->bs1;
+        CAN_InitStruct.CAN_BS2 = cfg->bs2;
+        CAN_InitStruct.CAN_Prescaler = cfg->prescaler;
+        if (CAN_Init(hw->regs, &CAN_InitStruct) != CAN_InitStatus_Success) {
+            continue;
+        }
+        // CAN_Init leaves the controller on the bus
+        (void)CAN_OperatingModeRequest(hw->regs, CAN_OperatingMode_Initialization);
+
+        NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+        NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+        NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_InitStruct.NVIC_IRQChannel = hw->txIrqn;
+        NVIC_Init(&NVIC_InitStruct);
+        NVIC_InitStruct.NVIC_IRQChannel = hw->rx0Irqn;
+        NVIC_Init(&NVIC_InitStruct);
+        NVIC_InitStruct.NVIC_IRQChannel = hw->rx1Irqn;
+        NVIC_Init(&NVIC_InitStruct);
+
+        Can_ControllerState[ctrl] = CAN_CS_STOPPED;
+    }
+
+    // Each filter takes the next bank of its controller
+    CAN_SlaveStartBank(CAN_SLAVE_START_BANK);
+    for (uint8_t f = 0; f < Can_FilterBankCount; f++) {
+        const Can_FilterBankConfigType* filter = &Can_FilterBankConfig[f];
+        uint8_t ctrl = filter->controller;
+
+        if (ctrl >= CAN_NUM_CONTROLLERS || Can_ControllerState[ctrl] == CAN_CS_UNINIT ||
+            nextBank[ctrl] >= Can_ControllerHw[ctrl].endFilterBank) {
+            continue;
+        }
+        Can_FilterInitBank(nextBank[ctrl]++, filter);
+    }
+}
+
+/*
+* Function: Can_DeInit
+* Description: Stops the controllers and returns them to their reset state.
+* Input: None
+* Output: None
+*/
+void Can_DeInit(void) {
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        if (Can_ControllerState[ctrl] == CAN_CS_UNINIT) {
+            continue;
+        }
+        Can_StopController(ctrl);
+        CAN_DeInit(Can_ControllerHw[ctrl].regs);
+        Can_ControllerState[ctrl] = CAN_CS_UNINIT;
+    }
+}
+
+/*
+* Function: Can_SetControllerMode
+* Description: Performs a mode transition of a controller: START from STOPPED, STOP from STARTED
+*   or STOPPED, SLEEP from STOPPED, WAKEUP from SLEEP to STOPPED. Starting a controller after
+*   bus-off runs the bus-off recovery of the hardware.
+* Input:
+*   - Controller: Controller to change.
+*   - Transition: Requested transition.
+* Output:
+*   - E_OK: If the transition is done.
+*   - E_NOT_OK: If the transition is not allowed or the hardware did not change mode.
+*/
+Std_ReturnType Can_SetControllerMode(uint8_t Controller, Can_StateTransitionType Transition) {
+    CAN_TypeDef* CANx;
+    Can_ControllerStateType state;
+
+    if (Controller >= CAN_NUM_CONTROLLERS || Can_ControllerState[Controller] == CAN_CS_UNINIT) {
+        return E_NOT_OK;
+    }
+    CANx = Can_ControllerHw[Controller].regs;
+    state = Can_ControllerState[Controller];
+
+    switch (Transition) {
+        case CAN_T_START:
+            if (state != CAN_CS_STOPPED ||
+                CAN_OperatingModeRequest(CANx, CAN_OperatingMode_Normal) != CAN_ModeStatus_Success) {
+                return E_NOT_OK;
+            }
+            Can_ControllerState[Controller] = CAN_CS_STARTED;
+            if (Can_IrqDisableCount[Controller] == 0) {
+                Can_IrqCmd(Controller, ENABLE);
+            }
+            return E_OK;
+
+        case CAN_T_STOP:
+            if (state != CAN_CS_STARTED && state != CAN_CS_STOPPED) {
+                return E_NOT_OK;
+            }
+            Can_StopController(Controller);
+            return E_OK;
+
+        case CAN_T_SLEEP:
+            if (state != CAN_CS_STOPPED ||
+                CAN_OperatingModeRequest(CANx, CAN_OperatingMode_Sleep) != CAN_ModeStatus_Success) {
+                return E_NOT_OK;
+            }
+            Can_ControllerState[Controller] = CAN_CS_SLEEP;
+            return E_OK;
+
+        case CAN_T_WAKEUP:
+            if (state != CAN_CS_SLEEP ||
+                CAN_OperatingModeRequest(CANx, CAN_OperatingMode_Initialization) != CAN_ModeStatus_Success) {
+                return E_NOT_OK;
+            }
+            Can_ControllerState[Controller] = CAN_CS_STOPPED;
+            return E_OK;
+
+        default:
+            return E_NOT_OK;
+    }
+}
+
+/*
+* Function: Can_GetControllerMode
+* Description: Returns the state of a controller.
+* Input:
+*   - Controller: Controller to query.
+*   - ControllerModePtr: Receives the state.
+* Output:
+*   - E_OK: If the state is returned.
+*   - E_NOT_OK: If the controller or the pointer is invalid.
+*/
+Std_ReturnType Can_GetControllerMode(uint8_t Controller, Can_ControllerStateType* ControllerModePtr) {
+    if (Controller >= CAN_NUM_CONTROLLERS || ControllerModePtr == NULL) {
+        return E_NOT_OK;
+    }
+    *ControllerModePtr = Can_ControllerState[Controller];
+    return E_OK;
+}
+
+/*
+* Function: Can_DisableControllerInterrupts
+* Description: Disables the interrupts of a controller. Calls nest; while disabled, the main
+*   functions poll the controller instead.
+* Input:
+*   - Controller: Controller to configure.
+* Output: None
+*/
+void Can_DisableControllerInterrupts(uint8_t Controller) {
+    SchM_StateType state;
+
+    if (Controller >= CAN_NUM_CONTROLLERS) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Can_IrqDisableCount[Controller]++ == 0 && Can_ControllerState[Controller] == CAN_CS_STARTED) {
+        Can_IrqCmd(Controller, DISABLE);
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Can_EnableControllerInterrupts
+* Description: Undoes one Can_DisableControllerInterrupts; the interrupts are enabled again when
+*   every disable has been undone.
+* Input:
+*   - Controller: Controller to configure.
+* Output: None
+*/
+void Can_EnableControllerInterrupts(uint8_t Controller) {
+    SchM_StateType state;
+
+    if (Controller >= CAN_NUM_CONTROLLERS) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Can_IrqDisableCount[Controller] != 0 && --Can_IrqDisableCount[Controller] == 0 &&
+        Can_ControllerState[Controller] == CAN_CS_STARTED) {
+        Can_IrqCmd(Controller, ENABLE);
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Can_Write
+* Description: Queues a frame for transmission. The frame is copied, loaded into a mailbox as soon
+*   as it is among the three most urgent frames of its controller, and confirmed to the upper
+*   layer once transmitted. Can be called from tasks and interrupt handlers.
+* Input:
+*   - Hth: Transmit hardware object, CAN_HTH_x.
+*   - PduInfo: Frame to transmit.
+* Output:
+*   - CAN_OK: If the frame is queued.
+*   - CAN_BUSY: If the transmit queue of the controller is full.
+*   - CAN_NOT_OK: If the request is invalid or the controller is not started.
+*/
+Can_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo) {
+    Can_TxStateType* tx;
+    Can_TxFrameType frame;
+    SchM_StateType state;
+    uint8_t controller;
+    uint8_t slot;
+
+    if (Hth >= CAN_NUM_HTH || PduInfo == NULL || PduInfo->length > 8u ||
+        (PduInfo->length != 0 && PduInfo->sdu == NULL)) {
+        return CAN_NOT_OK;
+    }
+    controller = (uint8_t)Hth;
+    if (Can_ControllerState[controller] != CAN_CS_STARTED) {
+        return CAN_NOT_OK;
+    }
+
+    // Build the mailbox image outside the exclusive area
+    if (PduInfo->id & CAN_ID_EXTENDED) {
+        frame.tir = ((PduInfo->id & CAN_ID_EXTENDED_MASK) << 3) | CAN_Id_Extended;
+        // Base identifier, then IDE (recessive, loses against a standard frame), then extension
+        frame.key = (frame.tir & CAN_TI0R_STID) | (1u << 20) | (((frame.tir & CAN_TI0R_EXID) >> 3) << 2);
+    } else {
+        frame.tir = (PduInfo->id & CAN_ID_STANDARD_MASK) << 21;
+        frame.key = frame.tir;
+    }
+    frame.tdtr = PduInfo->length;
+    frame.data[0] = 0;
+    frame.data[1] = 0;
+    for (uint8_t i = 0; i < PduInfo->length; i++) {
+        frame.data[i >> 2] |= (uint32_t)PduInfo->sdu[i] << (8u * (i & 3u));
+    }
+    frame.pduId = PduInfo->swPduHandle;
+
+    tx = &Can_TxState[controller];
+    SchM_Enter(state);
+    if (tx->heapCount >= CAN_TX_QUEUE_SIZE || tx->numFree == 0) {
+        SchM_Exit(state);
+        return CAN_BUSY;
+    }
+    slot = tx->freeSlots[--tx->numFree];
+    frame.seq = tx->nextSeq++;
+    tx->frames[slot] = frame;
+    Can_TxPush(tx, slot);
+    Can_TxFill(controller);
+    SchM_Exit(state);
+    return CAN_OK;
+}
+
+/*
+* Function: Can_MainFunction_Write
+* Description: Confirms the transmitted frames of the controllers whose interrupts are disabled
+*   and refills their mailboxes. Called periodically.
+* Input: None
+* Output: None
+*/
+void Can_MainFunction_Write(void) {
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        PduIdType confirmed[CAN_NUM_MAILBOXES];
+        SchM_StateType state;
+        uint8_t count;
+
+        if (Can_ControllerState[ctrl] != CAN_CS_STARTED || Can_IrqDisableCount[ctrl] == 0) {
+            continue;
+        }
+        SchM_Enter(state);
+        count = Can_TxProcess(ctrl, confirmed);
+        SchM_Exit(state);
+        Can_TxConfirm(confirmed, count);
+    }
+}
+
+/*
+* Function: Can_MainFunction_Read
+* Description: Indicates the received frames to the upper layer, in order of reception per FIFO.
+*   Drains the FIFOs first for the controllers whose interrupts are disabled. Called periodically;
+*   the RX queues absorb the frames received between two calls.
+* Input: None
+* Output: None
+*/
+void Can_MainFunction_Read(void) {
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        if (Can_ControllerState[ctrl] == CAN_CS_UNINIT) {
+            continue;
+        }
+        for (uint8_t fifo = 0; fifo < CAN_NUM_FIFOS; fifo++) {
+            Can_RxQueueType* queue = &Can_RxQueue[ctrl][fifo];
+            uint32_t tail = queue->tail;
+
+            if (Can_IrqDisableCount[ctrl] != 0 && Can_ControllerState[ctrl] == CAN_CS_STARTED) {
+                Can_RxDrain(ctrl, fifo);
+            }
+
+            while (tail != queue->head) {
+                const Can_RxFrameType* frame = &queue->frames[tail & CAN_RX_QUEUE_MASK];
+                Can_IdType id = Can_RxId(frame->rir);
+                uint8_t dlc = frame->dlc;
+
+                Can_Stats[ctrl].rxFrames++;
+                if (Can_ConfigPtr->rxIndication != NULL) {
+                    Can_ConfigPtr->rxIndication((Can_HwHandleType)(ctrl * CAN_NUM_FIFOS + fifo), frame->pdu, id,
+                                                (dlc > 8u) ? 8u : dlc, (const uint8_t*)frame->data);
+                }
+                // Hand the entry back to the interrupt only once it has been read
+                tail++;
+                SchM_MemoryBarrier();
+                queue->tail = tail;
+            }
+        }
+    }
+}
+
+/*
+* Function: Can_MainFunction_BusOff
+* Description: Stops the started controllers that went bus-off and notifies the upper layer, which
+*   restarts them with CAN_T_START. Called periodically.
+* Input: None
+* Output: None
+*/
+void Can_MainFunction_BusOff(void) {
+    for (uint8_t ctrl = 0; ctrl < CAN_NUM_CONTROLLERS; ctrl++) {
+        if (Can_ControllerState[ctrl] != CAN_CS_STARTED ||
+            CAN_GetFlagStatus(Can_ControllerHw[ctrl].regs, CAN_FLAG_BOF) == RESET) {
+            continue;
+        }
+        Can_StopController(ctrl);
+        if (Can_ConfigPtr->busOffNotification != NULL) {
+            Can_ConfigPtr->busOffNotification(ctrl);
+        }
+    }
+}
+
+/*
+* Function: Can_GetControllerStats
+* Description: Returns the counters of a controller.
+* Input:
+*   - Controller: Controller to query.
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters are returned.
+*   - E_NOT_OK: If the controller or the pointer is invalid.
+*/
+Std_ReturnType Can_GetControllerStats(uint8_t Controller, Can_ControllerStatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (Controller >= CAN_NUM_CONTROLLERS || StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = Can_Stats[Controller];
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Can_ResetControllerStats
+* Description: Clears the counters of a controller.
+* Input:
+*   - Controller: Controller to reset.
+* Output:
+*   - E_OK: If the counters are cleared.
+*   - E_NOT_OK: If the controller is invalid.
+*/
+Std_ReturnType Can_ResetControllerStats(uint8_t Controller) {
+    SchM_StateType state;
+
+    if (Controller >= CAN_NUM_CONTROLLERS) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    Can_Stats[Controller] = (Can_ControllerStatsType){ 0 };
+    SchM_Exit(state);
+    return E_OK;
+}
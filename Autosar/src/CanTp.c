@@ -0,0 +1,801 @@
+/*
+* File: CanTp.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for CanTp.h containing the implementation of the CAN transport layer.
+*/
+
+#include "CanTp.h"
+#include "SchM.h"
+#include <string.h>
+
+// Frame type, high nibble of the first byte
+#define CANTP_PCI_SF            0x00u
+#define CANTP_PCI_FF            0x10u
+#define CANTP_PCI_CF            0x20u
+#define CANTP_PCI_FC            0x30u
+
+// Flow status of a flow control frame
+#define CANTP_FS_CTS            0u
+#define CANTP_FS_WAIT           1u
+#define CANTP_FS_OVFLW          2u
+
+#define CANTP_FRAME_LENGTH      8u
+#define CANTP_SF_MAX            7u          // Data bytes of a single frame
+#define CANTP_CF_DATA           7u          // Data bytes of a consecutive frame
+#define CANTP_FF_MAX            4095u       // Longest message with a 12-bit first frame length
+
+// State of the reception of a connection
+#define CANTP_RX_IDLE           0u
+#define CANTP_RX_WAIT_CF        1u
+
+// State of the transmission of a connection
+#define CANTP_TX_IDLE           0u
+#define CANTP_TX_WAIT_FC        1u          // Waiting for a flow control frame
+#define CANTP_TX_SENDING        2u          // Consecutive frames of a block left to write
+#define CANTP_TX_WAIT_CONF      3u          // Last frame written, waiting for its confirmation
+
+// State of a connection
+typedef struct {
+    uint8_t rxState;
+    uint8_t rxSn;                           // Sequence number of the next consecutive frame
+    uint8_t rxBs;                           // Block size sent for the message being received
+    uint8_t rxBlockLeft;                    // Consecutive frames until the next flow control frame
+    uint8_t bs;                             // Sent in the flow control frames
+    uint8_t stMin;
+    uint8_t* rxBuffer;                      // Buffer of the upper layer
+    PduLengthType rxLength;
+    PduLengthType rxOffset;
+    Gpt_TimerType rxTimer;                  // N_Cr
+
+    uint8_t txState;
+    uint8_t txSn;
+    uint8_t txBs;                           // Block size of the last flow control frame
+    uint8_t txBlockLeft;
+    uint8_t txInFlight;                     // Frames written and not yet confirmed
+    Gpt_ValueType txStMin;                  // STmin of the last flow control frame, in ticks
+    const uint8_t* txData;                  // Buffer of the caller of CanTp_Transmit
+    PduLengthType txLength;
+    PduLengthType txOffset;
+    Gpt_TimerType txTimer;                  // STmin, or the retry after a full transmit queue
+    Gpt_TimerType txGuard;                  // N_As, then N_Bs while waiting for a flow control frame
+} CanTp_ChannelType;
+
+static const CanTp_ConfigType* CanTp_ConfigPtr;
+static uint8_t CanTp_Initialized;
+static CanTp_ChannelType CanTp_Channels[CANTP_NUM_CONNECTIONS];
+static CanTp_StatsType CanTp_Stats;
+
+static void CanTp_TxTimerExpired(void* Context);
+static void CanTp_TxTimeout(void* Context);
+
+/*
+* Function: CanTp_Init
+* Description: Stops every transfer, sets the flow control parameters of CanTp_Cfg.h and clears the
+*   counters. The GPT driver must be initialized; timers of a previous initialization are
+*   forgotten, so a running module is stopped by CanTp_DeInit first.
+* Input:
+*   - ConfigPtr: Upper layer, NULL for CanTp_Config.
+* Output: None
+*/
+void CanTp_Init(const CanTp_ConfigType* ConfigPtr) {
+    CanTp_ConfigPtr = (ConfigPtr != NULL) ? ConfigPtr : &CanTp_Config;
+    memset(CanTp_Channels, 0, sizeof(CanTp_Channels));
+    for (uint8_t i = 0; i < CANTP_NUM_CONNECTIONS; i++) {
+        CanTp_Channels[i].bs = CanTp_ConnectionConfig[i].bs;
+        CanTp_Channels[i].stMin = CanTp_ConnectionConfig[i].stMin;
+    }
+    memset(&CanTp_Stats, 0, sizeof(CanTp_Stats));
+    CanTp_Initialized = 1;
+}
+
+/*
+* Function: CanTp_DeInit
+* Description: Stops the timers of every connection; transfers in progress end without
+*   notification.
+* Input: None
+* Output: None
+*/
+void CanTp_DeInit(void) {
+    CanTp_Initialized = 0;
+    for (uint8_t i = 0; i < CANTP_NUM_CONNECTIONS; i++) {
+        Gpt_TimerStop(&CanTp_Channels[i].rxTimer);
+        Gpt_TimerStop(&CanTp_Channels[i].txTimer);
+        Gpt_TimerStop(&CanTp_Channels[i].txGuard);
+        CanTp_Channels[i].rxState = CANTP_RX_IDLE;
+        CanTp_Channels[i].txState = CANTP_TX_IDLE;
+    }
+}
+
+/*
+* Function: CanTp_Write
+* Description: Writes a frame of 8 bytes of a connection to the CAN driver, which copies it.
+* Input:
+*   - Connection: Connection of the frame.
+*   - Handle: Handle returned by the transmit confirmation.
+*   - Frame: The 8 bytes.
+* Output:
+*   - Result of Can_Write.
+*/
+static Can_ReturnType CanTp_Write(CanTp_ConnectionType Connection, PduIdType Handle, const uint8_t* Frame) {
+    const CanTp_ConnectionConfigType* cfg = &CanTp_ConnectionConfig[Connection];
+    Can_PduType pdu;
+
+    pdu.swPduHandle = Handle;
+    pdu.length = CANTP_FRAME_LENGTH;
+    pdu.id = cfg->txId;
+    pdu.sdu = Frame;
+    return Can_Write(cfg->hth, &pdu);
+}
+
+/*
+* Function: CanTp_SendFlowControl
+* Description: Sends a flow control frame with the block size and STmin of the connection.
+* Input:
+*   - Connection: Connection receiving a message.
+*   - FlowStatus: CANTP_FS_CTS or CANTP_FS_OVFLW.
+* Output:
+*   - E_OK: If the frame is written.
+*   - E_NOT_OK: If the CAN driver refused it.
+*/
+static Std_ReturnType CanTp_SendFlowControl(CanTp_ConnectionType Connection, uint8_t FlowStatus) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    uint8_t frame[CANTP_FRAME_LENGTH];
+
+    frame[0] = CANTP_PCI_FC | FlowStatus;
+    frame[1] = ch->rxBs;
+    frame[2] = ch->stMin;
+    memset(&frame[3], CANTP_PADDING, CANTP_FRAME_LENGTH - 3u);
+    if (CanTp_Write(Connection, (PduIdType)(CANTP_FC_HANDLE + Connection), frame) != CAN_OK) {
+        return E_NOT_OK;
+    }
+    CanTp_Stats.flowControls++;
+    return E_OK;
+}
+
+/*
+* Function: CanTp_StMinTicks
+* Description: Converts an STmin coded in a flow control frame into GPT ticks.
+* Input:
+*   - StMin: 0x00..0x7F in ms, 0xF1..0xF9 in hundreds of us; other values are reserved and read as
+*     the longest STmin, 127 ms.
+* Output:
+*   - Ticks, 0 for no delay. One tick is added: the timer starts within the current tick and could
+*     otherwise expire up to one tick before STmin.
+*/
+static Gpt_ValueType CanTp_StMinTicks(uint8_t StMin) {
+    if (StMin == 0) {
+        return 0;
+    }
+    if (StMin <= 0x7Fu) {
+        return GPT_MS(StMin) + 1u;
+    }
+    if (StMin >= 0xF1u && StMin <= 0xF9u) {
+        return (StMin - 0xF0u) * (GPT_TICKS_PER_MS / 10u) + 1u;
+    }
+    return GPT_MS(0x7Fu) + 1u;
+}
+
+/*
+* Function: CanTp_TxStop
+* Description: Ends the transmission of a connection. Called inside an exclusive area.
+* Input:
+*   - ch: State of the connection.
+* Output: None
+*/
+static void CanTp_TxStop(CanTp_ChannelType* ch) {
+    ch->txState = CANTP_TX_IDLE;
+    ch->txInFlight = 0;
+    ch->txData = NULL;
+    Gpt_TimerStop(&ch->txTimer);
+    Gpt_TimerStop(&ch->txGuard);
+}
+
+/*
+* Function: CanTp_TxEnd
+* Description: Confirms the end of a transmission to the upper layer, outside of the exclusive area.
+* Input:
+*   - Connection: Connection of the message.
+*   - Result: E_OK if the message is sent, E_NOT_OK if it was aborted.
+* Output: None
+*/
+static void CanTp_TxEnd(CanTp_ConnectionType Connection, Std_ReturnType Result) {
+    if (Result == E_OK) {
+        CanTp_Stats.txMessages++;
+    } else {
+        CanTp_Stats.txAborted++;
+    }
+    if (CanTp_ConfigPtr->txConfirmation != NULL) {
+        CanTp_ConfigPtr->txConfirmation(Connection, Result);
+    }
+}
+
+/*
+* Function: CanTp_SendConsecutiveFrame
+* Description: Writes the next consecutive frame of a message, straight from the caller's buffer,
+*   and moves to the next state when it ends the message or the block. Called inside an exclusive
+*   area.
+* Input:
+*   - Connection: Connection sending a message.
+* Output:
+*   - E_OK: If the frame is written.
+*   - E_NOT_OK: If the transmit queue of the CAN driver is full.
+*/
+static Std_ReturnType CanTp_SendConsecutiveFrame(CanTp_ConnectionType Connection) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    uint8_t frame[CANTP_FRAME_LENGTH];
+    PduLengthType count = ch->txLength - ch->txOffset;
+
+    if (count > CANTP_CF_DATA) {
+        count = CANTP_CF_DATA;
+    }
+    frame[0] = CANTP_PCI_CF | ch->txSn;
+    memcpy(&frame[1], &ch->txData[ch->txOffset], count);
+    memset(&frame[1 + count], CANTP_PADDING, CANTP_CF_DATA - count);
+    if (CanTp_Write(Connection, (PduIdType)(CANTP_TX_HANDLE + Connection), frame) != CAN_OK) {
+        return E_NOT_OK;
+    }
+    ch->txOffset += count;
+    ch->txSn = (ch->txSn + 1u) & 0x0Fu;
+    ch->txInFlight++;
+    if (ch->txOffset == ch->txLength) {
+        ch->txState = CANTP_TX_WAIT_CONF;
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_AS, 0, CanTp_TxTimeout, ch);
+    } else if (ch->txBs != 0 && --ch->txBlockLeft == 0) {
+        ch->txState = CANTP_TX_WAIT_FC;
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_BS, 0, CanTp_TxTimeout, ch);
+    } else {
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_AS, 0, CanTp_TxTimeout, ch);
+    }
+    return E_OK;
+}
+
+/*
+* Function: CanTp_TxSchedule
+* Description: Writes the consecutive frames due now: up to CANTP_TX_BURST in flight when STmin
+*   is 0, otherwise one, the STmin timer started by its confirmation writing the next. A frame
+*   refused with nothing left to confirm is retried by the timer. Called inside an exclusive area.
+* Input:
+*   - Connection: Connection sending a message.
+*   - Counter: Counter of the frames written, NULL if not counted.
+* Output: None
+*/
+static void CanTp_TxSchedule(CanTp_ConnectionType Connection, uint32_t* Counter) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    uint8_t limit = (ch->txStMin == 0) ? CANTP_TX_BURST : 1u;
+
+    while (ch->txState == CANTP_TX_SENDING && ch->txInFlight < limit) {
+        if (CanTp_SendConsecutiveFrame(Connection) != E_OK) {
+            if (ch->txInFlight == 0) {
+                (void)Gpt_TimerStart(&ch->txTimer, CANTP_RETRY, 0, CanTp_TxTimerExpired, ch);
+            }
+            return;
+        }
+        if (Counter != NULL) {
+            (*Counter)++;
+        }
+    }
+}
+
+/*
+* Function: CanTp_TxTimerExpired
+* Description: STmin elapsed since the confirmation of the last consecutive frame, or retry after
+*   a full transmit queue: writes the next frames. Runs from the GPT interrupt.
+* Input:
+*   - Context: State of the connection.
+* Output: None
+*/
+static void CanTp_TxTimerExpired(void* Context) {
+    CanTp_ChannelType* ch = (CanTp_ChannelType*)Context;
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (ch->txState == CANTP_TX_SENDING && ch->txInFlight == 0) {
+        CanTp_TxSchedule((CanTp_ConnectionType)(ch - CanTp_Channels), &CanTp_Stats.cfByTimer);
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: CanTp_TxTimeout
+* Description: N_As or N_Bs elapsed: aborts the transmission. Runs from the GPT interrupt.
+* Input:
+*   - Context: State of the connection.
+* Output: None
+*/
+static void CanTp_TxTimeout(void* Context) {
+    CanTp_ChannelType* ch = (CanTp_ChannelType*)Context;
+    SchM_StateType state;
+    uint8_t aborted = 0;
+
+    SchM_Enter(state);
+    if (ch->txState != CANTP_TX_IDLE) {
+        CanTp_TxStop(ch);
+        aborted = 1;
+    }
+    SchM_Exit(state);
+    if (aborted) {
+        CanTp_TxEnd((CanTp_ConnectionType)(ch - CanTp_Channels), E_NOT_OK);
+    }
+}
+
+/*
+* Function: CanTp_Transmit
+* Description: Starts sending a message: a single frame up to 7 bytes, otherwise a first frame
+*   followed by consecutive frames as the flow control frames of the receiver allow. The data is
+*   read from Data until the transmit confirmation of the upper layer.
+* Input:
+*   - Connection: Connection of the message.
+*   - Data: Message, kept unchanged by the caller until the confirmation.
+*   - Length: 1 to CANTP_MAX_LENGTH bytes, 7 at most on a functional connection.
+* Output:
+*   - E_OK: If the first frame is written.
+*   - E_NOT_OK: If the connection is sending, the arguments are invalid or the CAN driver refused
+*     the frame.
+*/
+Std_ReturnType CanTp_Transmit(CanTp_ConnectionType Connection, const uint8_t* Data, PduLengthType Length) {
+    CanTp_ChannelType* ch;
+    SchM_StateType state;
+    uint8_t frame[CANTP_FRAME_LENGTH];
+    PduLengthType count;
+
+    if (!CanTp_Initialized || Connection >= CANTP_NUM_CONNECTIONS || Data == NULL || Length == 0 ||
+        (Length > CANTP_SF_MAX && CanTp_ConnectionConfig[Connection].addressing == CANTP_FUNCTIONAL)) {
+        return E_NOT_OK;
+    }
+    ch = &CanTp_Channels[Connection];
+
+    if (Length <= CANTP_SF_MAX) {
+        frame[0] = CANTP_PCI_SF | (uint8_t)Length;
+        count = Length;
+        memcpy(&frame[1], Data, count);
+        memset(&frame[1 + count], CANTP_PADDING, CANTP_SF_MAX - count);
+    } else if (Length <= CANTP_FF_MAX) {
+        frame[0] = CANTP_PCI_FF | (uint8_t)(Length >> 8);
+        frame[1] = (uint8_t)Length;
+        count = CANTP_FRAME_LENGTH - 2u;
+        memcpy(&frame[2], Data, count);
+    } else {
+        // Escape sequence: length 0, then the length on 32 bits
+        frame[0] = CANTP_PCI_FF;
+        frame[1] = 0;
+        frame[2] = 0;
+        frame[3] = 0;
+        frame[4] = (uint8_t)(Length >> 8);
+        frame[5] = (uint8_t)Length;
+        count = CANTP_FRAME_LENGTH - 6u;
+        memcpy(&frame[6], Data, count);
+    }
+
+    SchM_Enter(state);
+    if (ch->txState != CANTP_TX_IDLE ||
+        CanTp_Write(Connection, (PduIdType)(CANTP_TX_HANDLE + Connection), frame) != CAN_OK) {
+        SchM_Exit(state);
+        return E_NOT_OK;
+    }
+    ch->txData = Data;
+    ch->txLength = Length;
+    ch->txOffset = count;
+    ch->txSn = 1;
+    ch->txInFlight = 1;
+    if (Length <= CANTP_SF_MAX) {
+        ch->txState = CANTP_TX_WAIT_CONF;
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_AS, 0, CanTp_TxTimeout, ch);
+    } else {
+        ch->txState = CANTP_TX_WAIT_FC;
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_BS, 0, CanTp_TxTimeout, ch);
+    }
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: CanTp_TxConfirmation
+* Description: Transmit confirmation of a frame written by CanTp, from the CAN driver through the
+*   PDU router. Ends a message whose last frame is confirmed; otherwise writes the next
+*   consecutive frame, or starts the STmin timer that will.
+* Input:
+*   - CanTxPduId: Handle of the frame; those of flow control frames are ignored.
+* Output: None
+*/
+void CanTp_TxConfirmation(PduIdType CanTxPduId) {
+    CanTp_ConnectionType connection;
+    CanTp_ChannelType* ch;
+    SchM_StateType state;
+    uint8_t done = 0;
+
+    if (!CanTp_Initialized || CanTxPduId < CANTP_TX_HANDLE || CanTxPduId >= CANTP_TX_HANDLE + CANTP_NUM_CONNECTIONS) {
+        return;
+    }
+    connection = (CanTp_ConnectionType)(CanTxPduId - CANTP_TX_HANDLE);
+    ch = &CanTp_Channels[connection];
+
+    SchM_Enter(state);
+    if (ch->txState == CANTP_TX_IDLE || ch->txInFlight == 0) {
+        SchM_Exit(state);
+        return;
+    }
+    ch->txInFlight--;
+    if (ch->txState == CANTP_TX_WAIT_CONF) {
+        if (ch->txInFlight == 0) {
+            CanTp_TxStop(ch);
+            done = 1;
+        }
+    } else if (ch->txState == CANTP_TX_SENDING) {
+        if (ch->txStMin == 0) {
+            CanTp_TxSchedule(connection, &CanTp_Stats.cfByConfirmation);
+        } else {
+            (void)Gpt_TimerStart(&ch->txTimer, ch->txStMin, 0, CanTp_TxTimerExpired, ch);
+        }
+    }
+    SchM_Exit(state);
+    if (done) {
+        CanTp_TxEnd(connection, E_OK);
+    }
+}
+
+/*
+* Function: CanTp_RxFlowControl
+* Description: Flow control frame of the receiver of the message being sent: the next block is
+*   sent with its block size and STmin, a wait restarts N_Bs, an overflow aborts the message.
+* Input:
+*   - Connection: Connection of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+static void CanTp_RxFlowControl(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    SchM_StateType state;
+    uint8_t aborted = 0;
+
+    if (CanDlc < 3u) {
+        return;
+    }
+    SchM_Enter(state);
+    if (ch->txState != CANTP_TX_WAIT_FC) {
+        SchM_Exit(state);
+        return;
+    }
+    switch (CanSduPtr[0] & 0x0Fu) {
+    case CANTP_FS_CTS:
+        ch->txBs = CanSduPtr[1];
+        ch->txBlockLeft = CanSduPtr[1];
+        ch->txStMin = CanTp_StMinTicks(CanSduPtr[2]);
+        ch->txState = CANTP_TX_SENDING;
+        // The last frame of the previous block starts the STmin timer when it is confirmed
+        if (ch->txStMin == 0 || ch->txInFlight == 0) {
+            CanTp_TxSchedule(Connection, NULL);
+        }
+        break;
+    case CANTP_FS_WAIT:
+        (void)Gpt_TimerStart(&ch->txGuard, CANTP_N_BS, 0, CanTp_TxTimeout, ch);
+        break;
+    default:
+        CanTp_TxStop(ch);
+        aborted = 1;
+        break;
+    }
+    SchM_Exit(state);
+    if (aborted) {
+        CanTp_TxEnd(Connection, E_NOT_OK);
+    }
+}
+
+/*
+* Function: CanTp_RxStop
+* Description: Ends the reception of a connection. Called inside an exclusive area.
+* Input:
+*   - ch: State of the connection.
+* Output: None
+*/
+static void CanTp_RxStop(CanTp_ChannelType* ch) {
+    ch->rxState = CANTP_RX_IDLE;
+    ch->rxBuffer = NULL;
+    Gpt_TimerStop(&ch->rxTimer);
+}
+
+/*
+* Function: CanTp_RxEnd
+* Description: Indicates the end of a reception to the upper layer, outside of the exclusive area.
+* Input:
+*   - Connection: Connection of the message.
+*   - Result: E_OK if the message is complete, E_NOT_OK if it was aborted.
+* Output: None
+*/
+static void CanTp_RxEnd(CanTp_ConnectionType Connection, Std_ReturnType Result) {
+    if (Result == E_OK) {
+        CanTp_Stats.rxMessages++;
+    } else {
+        CanTp_Stats.rxAborted++;
+    }
+    if (CanTp_ConfigPtr->rxIndication != NULL) {
+        CanTp_ConfigPtr->rxIndication(Connection, Result);
+    }
+}
+
+/*
+* Function: CanTp_RxAbort
+* Description: Aborts the message being received, if any: a new single or first frame replaces it.
+* Input:
+*   - Connection: Connection of the frame.
+* Output: None
+*/
+static void CanTp_RxAbort(CanTp_ConnectionType Connection) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    SchM_StateType state;
+    uint8_t aborted = 0;
+
+    SchM_Enter(state);
+    if (ch->rxState != CANTP_RX_IDLE) {
+        CanTp_RxStop(ch);
+        aborted = 1;
+    }
+    SchM_Exit(state);
+    if (aborted) {
+        CanTp_RxEnd(Connection, E_NOT_OK);
+    }
+}
+
+/*
+* Function: CanTp_RxTimeout
+* Description: N_Cr elapsed: aborts the reception. Runs from the GPT interrupt.
+* Input:
+*   - Context: State of the connection.
+* Output: None
+*/
+static void CanTp_RxTimeout(void* Context) {
+    CanTp_RxAbort((CanTp_ConnectionType)((CanTp_ChannelType*)Context - CanTp_Channels));
+}
+
+/*
+* Function: CanTp_StartOfReception
+* Description: Asks the upper layer for the buffer of a message.
+* Input:
+*   - Connection: Connection of the message.
+*   - Length: Length of the message.
+* Output:
+*   - Buffer of Length bytes, NULL if the message is refused.
+*/
+static uint8_t* CanTp_StartOfReception(CanTp_ConnectionType Connection, PduLengthType Length) {
+    if (CanTp_ConfigPtr->startOfReception == NULL) {
+        return NULL;
+    }
+    return CanTp_ConfigPtr->startOfReception(Connection, Length);
+}
+
+/*
+* Function: CanTp_RxSingleFrame
+* Description: Single frame: the message is copied into the buffer of the upper layer and
+*   indicated.
+* Input:
+*   - Connection: Connection of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+static void CanTp_RxSingleFrame(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    PduLengthType length = CanSduPtr[0] & 0x0Fu;
+    uint8_t* buffer;
+
+    if (length == 0 || length > CANTP_SF_MAX || length >= CanDlc) {
+        return;
+    }
+    CanTp_RxAbort(Connection);
+    buffer = CanTp_StartOfReception(Connection, length);
+    if (buffer == NULL) {
+        CanTp_Stats.rxAborted++;
+        return;
+    }
+    memcpy(buffer, &CanSduPtr[1], length);
+    CanTp_RxEnd(Connection, E_OK);
+}
+
+/*
+* Function: CanTp_RxFirstFrame
+* Description: First frame: the upper layer gives the buffer of the whole message, the data of the
+*   frame is copied into it and a flow control frame lets the sender go on. A message refused, or
+*   longer than CANTP_MAX_LENGTH, is answered with an overflow.
+* Input:
+*   - Connection: Connection of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+static void CanTp_RxFirstFrame(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    uint32_t length = ((uint32_t)(CanSduPtr[0] & 0x0Fu) << 8) | CanSduPtr[1];
+    uint8_t first = 2;
+    uint8_t* buffer = NULL;
+    SchM_StateType state;
+    Std_ReturnType result;
+
+    if (CanTp_ConnectionConfig[Connection].addressing == CANTP_FUNCTIONAL || CanDlc != CANTP_FRAME_LENGTH) {
+        return;
+    }
+    if (length == 0) {
+        length = ((uint32_t)CanSduPtr[2] << 24) | ((uint32_t)CanSduPtr[3] << 16) |
+                 ((uint32_t)CanSduPtr[4] << 8) | CanSduPtr[5];
+        first = 6;
+        if (length <= CANTP_FF_MAX) {
+            return;
+        }
+    } else if (length <= CANTP_SF_MAX) {
+        return;
+    }
+    CanTp_RxAbort(Connection);
+    if (length <= CANTP_MAX_LENGTH) {
+        buffer = CanTp_StartOfReception(Connection, (PduLengthType)length);
+    }
+
+    SchM_Enter(state);
+    ch->rxBs = ch->bs;
+    if (buffer == NULL) {
+        (void)CanTp_SendFlowControl(Connection, CANTP_FS_OVFLW);
+        SchM_Exit(state);
+        CanTp_Stats.rxAborted++;
+        return;
+    }
+    memcpy(buffer, &CanSduPtr[first], CANTP_FRAME_LENGTH - first);
+    ch->rxBuffer = buffer;
+    ch->rxLength = (PduLengthType)length;
+    ch->rxOffset = CANTP_FRAME_LENGTH - first;
+    ch->rxSn = 1;
+    ch->rxBlockLeft = ch->rxBs;
+    ch->rxState = CANTP_RX_WAIT_CF;
+    result = CanTp_SendFlowControl(Connection, CANTP_FS_CTS);
+    if (result == E_OK) {
+        (void)Gpt_TimerStart(&ch->rxTimer, CANTP_N_CR, 0, CanTp_RxTimeout, ch);
+    } else {
+        CanTp_RxStop(ch);
+    }
+    SchM_Exit(state);
+    if (result != E_OK) {
+        CanTp_RxEnd(Connection, E_NOT_OK);
+    }
+}
+
+/*
+* Function: CanTp_RxConsecutiveFrame
+* Description: Consecutive frame: its data is copied into the buffer of the upper layer at the
+*   offset reached. Ends the message, or sends the flow control frame of the next block. A wrong
+*   sequence number aborts the message.
+* Input:
+*   - Connection: Connection of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+static void CanTp_RxConsecutiveFrame(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    CanTp_ChannelType* ch = &CanTp_Channels[Connection];
+    SchM_StateType state;
+    PduLengthType count;
+    uint8_t done = 0;
+    Std_ReturnType result = E_NOT_OK;
+
+    SchM_Enter(state);
+    if (ch->rxState != CANTP_RX_WAIT_CF) {
+        SchM_Exit(state);
+        return;
+    }
+    count = ch->rxLength - ch->rxOffset;
+    if (count > CANTP_CF_DATA) {
+        count = CANTP_CF_DATA;
+    }
+    if ((CanSduPtr[0] & 0x0Fu) != ch->rxSn || count >= CanDlc) {
+        CanTp_RxStop(ch);
+        done = 1;
+    } else {
+        memcpy(&ch->rxBuffer[ch->rxOffset], &CanSduPtr[1], count);
+        ch->rxOffset += count;
+        ch->rxSn = (ch->rxSn + 1u) & 0x0Fu;
+        if (ch->rxOffset == ch->rxLength) {
+            CanTp_RxStop(ch);
+            result = E_OK;
+            done = 1;
+        } else if (ch->rxBs != 0 && --ch->rxBlockLeft == 0) {
+            ch->rxBlockLeft = ch->rxBs;
+            if (CanTp_SendFlowControl(Connection, CANTP_FS_CTS) != E_OK) {
+                CanTp_RxStop(ch);
+                done = 1;
+            }
+        }
+        if (!done) {
+            (void)Gpt_TimerStart(&ch->rxTimer, CANTP_N_CR, 0, CanTp_RxTimeout, ch);
+        }
+    }
+    SchM_Exit(state);
+    if (done) {
+        CanTp_RxEnd(Connection, result);
+    }
+}
+
+/*
+* Function: CanTp_RxIndication
+* Description: Frame received on a connection, from the PDU router.
+* Input:
+*   - Connection: Connection of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+void CanTp_RxIndication(CanTp_ConnectionType Connection, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    if (!CanTp_Initialized || Connection >= CANTP_NUM_CONNECTIONS || CanSduPtr == NULL || CanDlc == 0) {
+        return;
+    }
+    switch (CanSduPtr[0] & 0xF0u) {
+    case CANTP_PCI_SF:
+        CanTp_RxSingleFrame(Connection, CanDlc, CanSduPtr);
+        break;
+    case CANTP_PCI_FF:
+        CanTp_RxFirstFrame(Connection, CanDlc, CanSduPtr);
+        break;
+    case CANTP_PCI_CF:
+        CanTp_RxConsecutiveFrame(Connection, CanDlc, CanSduPtr);
+        break;
+    case CANTP_PCI_FC:
+        CanTp_RxFlowControl(Connection, CanDlc, CanSduPtr);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+* Function: CanTp_ChangeParameter
+* Description: Changes the block size or STmin sent in the flow control frames of a connection,
+*   from the next message received on.
+* Input:
+*   - Connection: Connection to change.
+*   - Parameter: CANTP_PARAM_BS or CANTP_PARAM_STMIN.
+*   - Value: New value, coded as in a flow control frame.
+* Output:
+*   - E_OK: If the parameter is changed.
+*   - E_NOT_OK: If the arguments are invalid or a message is being received.
+*/
+Std_ReturnType CanTp_ChangeParameter(CanTp_ConnectionType Connection, CanTp_ParameterType Parameter, uint8_t Value) {
+    CanTp_ChannelType* ch;
+    SchM_StateType state;
+    Std_ReturnType result = E_OK;
+
+    if (!CanTp_Initialized || Connection >= CANTP_NUM_CONNECTIONS) {
+        return E_NOT_OK;
+    }
+    if (Parameter == CANTP_PARAM_STMIN && Value > 0x7Fu && (Value < 0xF1u || Value > 0xF9u)) {
+        return E_NOT_OK;
+    }
+    ch = &CanTp_Channels[Connection];
+    SchM_Enter(state);
+    if (ch->rxState != CANTP_RX_IDLE) {
+        result = E_NOT_OK;
+    } else if (Parameter == CANTP_PARAM_BS) {
+        ch->bs = Value;
+    } else if (Parameter == CANTP_PARAM_STMIN) {
+        ch->stMin = Value;
+    } else {
+        result = E_NOT_OK;
+    }
+    SchM_Exit(state);
+    return result;
+}
+
+/*
+* Function: CanTp_GetStats
+* Description: Copies the counters of the module.
+* Input:
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters are copied.
+*   - E_NOT_OK: If StatsPtr is NULL.
+*/
+Std_ReturnType CanTp_GetStats(CanTp_StatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = CanTp_Stats;
+    SchM_Exit(state);
+    return E_OK;
+}
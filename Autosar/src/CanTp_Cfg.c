@@ -0,0 +1,23 @@
+/*
+* File: CanTp_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Connections of the CAN transport layer, from the list of CanTp_Cfg.h.
+*/
+
+#include "CanTp.h"
+
+#define CANTP_CONNECTION(name, rxPdu, txId, hth, bs, stMin, addressing) \
+    { (rxPdu), (txId), (hth), (bs), (stMin), (addressing) },
+
+const CanTp_ConnectionConfigType CanTp_ConnectionConfig[CANTP_NUM_CONNECTIONS] = {
+    CANTP_CONNECTIONS(CANTP_CONNECTION)
+};
+
+// CanTp is linked without a diagnostic layer: messages received are refused and nothing is
+// confirmed. Dcm_CanTpConfig binds it to the DCM module.
+const CanTp_ConfigType CanTp_Config = {
+    NULL,       /* startOfReception */
+    NULL,       /* rxIndication */
+    NULL,       /* txConfirmation */
+};
@@ -0,0 +1,25 @@
+/*
+* File: Can_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Controller configuration of the CAN driver. The filter banks are generated into
+* Can_Filter_Cfg.c from CAN_RX_PDUS.
+*/
+
+#include "Can.h"
+#include "PduR.h"
+
+// Bit timing from the 42 MHz APB1 clock, sampling at 85.7 %: CAN1 at 1 Mbit/s
+// (42 MHz / 3 / 14 quanta), CAN2 at 500 kbit/s (42 MHz / 6 / 14 quanta)
+const Can_ControllerConfigType Can_ControllerConfig[CAN_NUM_CONTROLLERS] = {
+    /* enabled, prescaler, sjw, bs1, bs2, mode */
+    { 1, 3, CAN_SJW_1tq, CAN_BS1_11tq, CAN_BS2_2tq, CAN_Mode_Normal },    /* CAN_CONTROLLER_1 */
+    { 1, 6, CAN_SJW_1tq, CAN_BS1_11tq, CAN_BS2_2tq, CAN_Mode_Normal },    /* CAN_CONTROLLER_2 */
+};
+
+// Received frames and transmit confirmations go to the PDU router
+const Can_ConfigType Can_Config = {
+    PduR_CanRxIndication,   /* rxIndication */
+    PduR_CanTxConfirmation, /* txConfirmation */
+    NULL,       /* busOffNotification */
+};
@@ -0,0 +1,277 @@
+/*
+* File: Can_Filter_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Filter banks of the CAN driver, generated by Test/Can_FilterGen.c from CAN_RX_PDUS in
+* Can_Cfg.h. Do not edit: run "make -C Test filters" instead.
+*/
+
+#include "Can.h"
+
+// CAN_CONTROLLER_1: 6 of 14 banks for 31 identifiers, no other identifier accepted
+// CAN_CONTROLLER_2: 14 of 14 banks for 40 identifiers, 20 other identifiers accepted by masks
+const Can_FilterBankConfigType Can_FilterBankConfig[] = {
+    /* controller, fifo, mode, scale, fr1, fr2 */
+    { CAN_CONTROLLER_1, CAN_FIFO0, CAN_FilterMode_IdList, CAN_FilterScale_16bit, 0x56805400u, 0xB4407D00u },   /* 0x2A0 0x2B4 0x3E8 0x5A2 */
+    { CAN_CONTROLLER_1, CAN_FIFO0, CAN_FilterMode_IdList, CAN_FilterScale_16bit, 0xDE00C000u, 0xFC00FBE0u },   /* 0x600 0x6F0 0x7DF 0x7E0 */
+    { CAN_CONTROLLER_1, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_16bit, 0xFF184000u, 0xF9F86000u },   /* 0x200/0x7F8 0x300/0x7CF */
+    { CAN_CONTROLLER_1, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_16bit, 0xFFD88000u, 0xFFD8B400u },   /* 0x400/0x7FE 0x5A0/0x7FE */
+    { CAN_CONTROLLER_1, CAN_FIFO1, CAN_FilterMode_IdList, CAN_FilterScale_16bit, 0x04000200u, 0x1E001E00u },   /* 0x010 0x020 0x0F0 0x0F0 */
+    { CAN_CONTROLLER_1, CAN_FIFO1, CAN_FilterMode_IdMask, CAN_FilterScale_16bit, 0xFF981800u, 0xFF981800u },   /* 0x0C0/0x7FC 0x0C0/0x7FC */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F70804u, 0xFFFF1FFEu },   /* 0x18FEE100/0x1FFFE3FF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7081Cu, 0xFFFF5FBEu },   /* 0x18FEE103/0x1FFFEBF7 */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F708BCu, 0xFFFF1FFEu },   /* 0x18FEE117/0x1FFFE3FF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F77004u, 0xFFFFF7FEu },   /* 0x18FEEE00/0x1FFFFEFF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7701Cu, 0xFFFFF7BEu },   /* 0x18FEEE03/0x1FFFFEF7 */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F770BCu, 0xFFFFF7FEu },   /* 0x18FEEE17/0x1FFFFEFF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7A004u, 0xFFFFAFFEu },   /* 0x18FEF400/0x1FFFF5FF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7A01Cu, 0xFFFFAFBEu },   /* 0x18FEF403/0x1FFFF5F7 */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7A0BCu, 0xFFFFAFFEu },   /* 0x18FEF417/0x1FFFF5FF */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F7481Cu, 0xFFFFFFBEu },   /* 0x18FEE903/0x1FFFFFF7 */
+    { CAN_CONTROLLER_2, CAN_FIFO0, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0xC7F65004u, 0xFFFFFFE6u },   /* 0x18FECA00/0x1FFFFFFC */
+    { CAN_CONTROLLER_2, CAN_FIFO1, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0x67802004u, 0xFFFFFFF6u },   /* 0x0CF00400/0x1FFFFFFE */
+    { CAN_CONTROLLER_2, CAN_FIFO1, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0x67801804u, 0xFFFFFFF6u },   /* 0x0CF00300/0x1FFFFFFE */
+    { CAN_CONTROLLER_2, CAN_FIFO1, CAN_FilterMode_IdMask, CAN_FilterScale_32bit, 0x6000001Cu, 0xFFFFFFBEu },   /* 0x0C000003/0x1FFFFFF7 */
+};
+
+const uint8_t Can_FilterBankCount = sizeof(Can_FilterBankConfig) / sizeof(Can_FilterBankConfig[0]);
+
+const Can_RxSlotType Can_RxSlotTable[] = {
+    /* id, pdu */
+    /* CAN_HRH_CAN1_FIFO0 */
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000204u, CAN_RX_PDU_BMS_CELLS_4 },
+    { 0x00000401u, CAN_RX_PDU_LIGHTS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000300u, CAN_RX_PDU_COOLANT },
+    { 0x000005A2u, CAN_RX_PDU_CLIMATE_2 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000206u, CAN_RX_PDU_BMS_CELLS_6 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000600u, CAN_RX_PDU_CLOCK },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000201u, CAN_RX_PDU_BMS_CELLS_1 },
+    { 0x00000310u, CAN_RX_PDU_OIL },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000002B4u, CAN_RX_PDU_THROTTLE },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000006F0u, CAN_RX_PDU_NM },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000203u, CAN_RX_PDU_BMS_CELLS_3 },
+    { 0x00000400u, CAN_RX_PDU_DOORS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000320u, CAN_RX_PDU_FUEL },
+    { 0x000005A1u, CAN_RX_PDU_CLIMATE_1 },
+    { 0x000007E0u, CAN_RX_PDU_DIAG_PHYSICAL },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000205u, CAN_RX_PDU_BMS_CELLS_5 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000003E8u, CAN_RX_PDU_ODOMETER },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000200u, CAN_RX_PDU_BMS_CELLS_0 },
+    { 0x00000330u, CAN_RX_PDU_AMBIENT },
+    { 0x00000207u, CAN_RX_PDU_BMS_CELLS_7 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000002A0u, CAN_RX_PDU_GEAR },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000202u, CAN_RX_PDU_BMS_CELLS_2 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000005A0u, CAN_RX_PDU_CLIMATE_0 },
+    { 0x000007DFu, CAN_RX_PDU_DIAG_FUNCTIONAL },
+    /* CAN_HRH_CAN1_FIFO1 */
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000000C3u, CAN_RX_PDU_WHEEL_SPEED_RR },
+    { 0x00000010u, CAN_RX_PDU_BRAKE_PRESSURE },
+    { 0x000000C2u, CAN_RX_PDU_WHEEL_SPEED_RL },
+    { 0x000000C1u, CAN_RX_PDU_WHEEL_SPEED_FR },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x000000C0u, CAN_RX_PDU_WHEEL_SPEED_FL },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x00000020u, CAN_RX_PDU_STEERING_ANGLE },
+    { 0x000000F0u, CAN_RX_PDU_YAW_RATE },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    /* CAN_HRH_CAN2_FIFO0 */
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE90Bu, CAN_RX_PDU_LFC_0B },
+    { 0x98FEFC00u, CAN_RX_PDU_DD_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE503u, CAN_RX_PDU_HOURS_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEF00u, CAN_RX_PDU_EFLP1_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE517u, CAN_RX_PDU_HOURS_17 },
+    { 0x98FEF603u, CAN_RX_PDU_IC1_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF100u, CAN_RX_PDU_CCVS_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEFC0Bu, CAN_RX_PDU_DD_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE903u, CAN_RX_PDU_LFC_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF617u, CAN_RX_PDU_IC1_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEF0Bu, CAN_RX_PDU_EFLP1_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE917u, CAN_RX_PDU_LFC_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF500u, CAN_RX_PDU_AMB_00 },
+    { 0x98FEF10Bu, CAN_RX_PDU_CCVS_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FECA00u, CAN_RX_PDU_DM1_00 },
+    { 0x98FEFC03u, CAN_RX_PDU_DD_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEF03u, CAN_RX_PDU_EFLP1_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEFC17u, CAN_RX_PDU_DD_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF50Bu, CAN_RX_PDU_AMB_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF103u, CAN_RX_PDU_CCVS_03 },
+    { 0x98FEEF17u, CAN_RX_PDU_EFLP1_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF117u, CAN_RX_PDU_CCVS_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEE00u, CAN_RX_PDU_ET1_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF503u, CAN_RX_PDU_AMB_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FECA03u, CAN_RX_PDU_DM1_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF517u, CAN_RX_PDU_AMB_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEE0Bu, CAN_RX_PDU_ET1_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE500u, CAN_RX_PDU_HOURS_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF600u, CAN_RX_PDU_IC1_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEE03u, CAN_RX_PDU_ET1_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEE900u, CAN_RX_PDU_LFC_00 },
+    { 0x98FEE50Bu, CAN_RX_PDU_HOURS_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEEE17u, CAN_RX_PDU_ET1_17 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x98FEF60Bu, CAN_RX_PDU_IC1_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    /* CAN_HRH_CAN2_FIFO1 */
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8CF00400u, CAN_RX_PDU_EEC1_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8C00000Bu, CAN_RX_PDU_TSC1_0B },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8C000003u, CAN_RX_PDU_TSC1_03 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8CF00301u, CAN_RX_PDU_EEC2_01 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8CF00401u, CAN_RX_PDU_EEC1_01 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+    { 0x8CF00300u, CAN_RX_PDU_EEC2_00 },
+    { CAN_RX_NO_ID, CAN_NUM_RX_PDUS },
+};
+
+const Can_RxHashType Can_RxHash[CAN_NUM_HRH] = {
+    /* first, shift, check, multiplier */
+    { 0, 26, 0, 0x935F84DFu },   /* CAN_HRH_CAN1_FIFO0: 24 identifiers in 64 slots */
+    { 64, 28, 0, 0xE6336D1Fu },   /* CAN_HRH_CAN1_FIFO1: 7 identifiers in 16 slots */
+    { 80, 25, 1, 0x1A88A9EFu },   /* CAN_HRH_CAN2_FIFO0: 34 identifiers in 128 slots */
+    { 208, 28, 0, 0xBA2529D1u },   /* CAN_HRH_CAN2_FIFO1: 6 identifiers in 16 slots */
+};
@@ -0,0 +1,225 @@
+/*
+* File: Com.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Com.h containing the implementation of the COM module.
+*/
+
+#include "Com.h"
+#include "SchM.h"
+#include <string.h>
+
+#define COM_MAX_IPDU_LENGTH     8u
+
+// State of a received I-PDU
+typedef struct {
+    uint8_t data[COM_MAX_IPDU_LENGTH];      // Last frame unpacked
+    uint8_t received;                       // A frame has been unpacked since Com_Init
+} Com_RxIpduStateType;
+
+// State of a sent I-PDU
+typedef struct {
+    uint8_t data[COM_MAX_IPDU_LENGTH];      // Signals as last packed
+    volatile uint32_t dirty;                // Signals changed since they were last packed
+    uint16_t countdown;                     // Calls of Com_MainFunctionTx left until the period ends
+    uint8_t retry;                          // The last Can_Write failed
+} Com_TxIpduStateType;
+
+static uint8_t Com_Initialized;
+static uint32_t Com_RxValues[COM_NUM_RX_SIGNALS];
+static uint32_t Com_TxValues[COM_NUM_TX_SIGNALS];
+static Com_RxIpduStateType Com_RxState[COM_NUM_RX_IPDUS];
+static Com_TxIpduStateType Com_TxState[COM_NUM_TX_IPDUS];
+
+/*
+* Function: Com_Init
+* Description: Clears the signals and the I-PDUs. Every periodic I-PDU is sent by the first call of
+*   Com_MainFunctionTx.
+* Input: None
+* Output: None
+*/
+void Com_Init(void) {
+    memset(Com_RxValues, 0, sizeof(Com_RxValues));
+    memset(Com_TxValues, 0, sizeof(Com_TxValues));
+    memset(Com_RxState, 0, sizeof(Com_RxState));
+    memset(Com_TxState, 0, sizeof(Com_TxState));
+    for (uint8_t ipdu = 0; ipdu < COM_NUM_TX_IPDUS; ipdu++) {
+        Com_TxState[ipdu].countdown = 1;
+    }
+    Com_Initialized = 1;
+}
+
+/*
+* Function: Com_DeInit
+* Description: Stops the module: signals are no longer sent nor received.
+* Input: None
+* Output: None
+*/
+void Com_DeInit(void) {
+    Com_Initialized = 0;
+}
+
+/*
+* Function: Com_SendSignal
+* Description: Updates a sent signal. A changed value is marked in the dirty bitmap of its I-PDU
+*   and packed by the next transmission of the I-PDU; an unchanged one costs nothing more.
+* Input:
+*   - SignalId: Signal of Com_TxSignalIdType.
+*   - SignalDataPtr: Value, of the size given by the type of the signal.
+* Output:
+*   - E_OK: If the value is taken.
+*   - E_NOT_OK: If the signal is unknown.
+*   - COM_SERVICE_NOT_AVAILABLE: If the module is not initialized.
+*/
+uint8_t Com_SendSignal(Com_SignalIdType SignalId, const void* SignalDataPtr) {
+    const Com_SignalConfigType* cfg;
+    uint32_t value;
+    SchM_StateType state;
+
+    if (!Com_Initialized) {
+        return COM_SERVICE_NOT_AVAILABLE;
+    }
+    if (SignalId >= COM_NUM_TX_SIGNALS || SignalDataPtr == NULL) {
+        return E_NOT_OK;
+    }
+    cfg = &Com_TxSignalConfig[SignalId];
+    switch (cfg->type) {
+    case COM_BOOLEAN:
+        value = (*(const uint8_t*)SignalDataPtr != 0);
+        break;
+    case COM_UINT8:
+    case COM_SINT8:
+        value = *(const uint8_t*)SignalDataPtr;
+        break;
+    case COM_UINT16:
+    case COM_SINT16:
+        value = *(const uint16_t*)SignalDataPtr;
+        break;
+    default:
+        value = *(const uint32_t*)SignalDataPtr;
+        break;
+    }
+
+    if (value != Com_TxValues[SignalId]) {
+        SchM_Enter(state);
+        Com_TxValues[SignalId] = value;
+        Com_TxState[cfg->ipdu].dirty |= Com_TxSignalMask[SignalId];
+        SchM_Exit(state);
+    }
+    return E_OK;
+}
+
+/*
+* Function: Com_ReceiveSignal
+* Description: Reads the last value received for a signal, 0 until its I-PDU is received.
+* Input:
+*   - SignalId: Signal of Com_RxSignalIdType.
+*   - SignalDataPtr: Value, of the size given by the type of the signal.
+* Output:
+*   - E_OK: If the value is copied.
+*   - E_NOT_OK: If the signal is unknown.
+*   - COM_SERVICE_NOT_AVAILABLE: If the module is not initialized.
+*/
+uint8_t Com_ReceiveSignal(Com_SignalIdType SignalId, void* SignalDataPtr) {
+    uint32_t value;
+
+    if (!Com_Initialized) {
+        return COM_SERVICE_NOT_AVAILABLE;
+    }
+    if (SignalId >= COM_NUM_RX_SIGNALS || SignalDataPtr == NULL) {
+        return E_NOT_OK;
+    }
+    value = Com_RxValues[SignalId];
+    switch (Com_RxSignalConfig[SignalId].type) {
+    case COM_BOOLEAN:
+    case COM_UINT8:
+    case COM_SINT8:
+        *(uint8_t*)SignalDataPtr = (uint8_t)value;
+        break;
+    case COM_UINT16:
+    case COM_SINT16:
+        *(uint16_t*)SignalDataPtr = (uint16_t)value;
+        break;
+    default:
+        *(uint32_t*)SignalDataPtr = value;
+        break;
+    }
+    return E_OK;
+}
+
+/*
+* Function: Com_RxIndication
+* Description: Unpacks a received I-PDU into its signals. A frame equal to the last one unpacked
+*   is skipped, since it carries the same values.
+* Input:
+*   - RxPduId: I-PDU of Com_RxIpduIdType.
+*   - PduInfoPtr: Received data, at least as long as the I-PDU.
+* Output: None
+*/
+void Com_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr) {
+    Com_RxIpduStateType* st;
+    uint8_t length;
+
+    if (!Com_Initialized || RxPduId >= COM_NUM_RX_IPDUS || PduInfoPtr == NULL ||
+        PduInfoPtr->SduLength < Com_RxIpduConfig[RxPduId].length) {
+        return;
+    }
+    st = &Com_RxState[RxPduId];
+    length = Com_RxIpduConfig[RxPduId].length;
+    if (st->received && memcmp(st->data, PduInfoPtr->SduDataPtr, length) == 0) {
+        return;
+    }
+    memcpy(st->data, PduInfoPtr->SduDataPtr, length);
+    st->received = 1;
+    Com_UnpackFunctions[RxPduId](st->data, Com_RxValues);
+}
+
+/*
+* Function: Com_MainFunctionTx
+* Description: Sends the I-PDUs whose period ended, and those sent on change with a changed
+*   signal. Only the signals marked in the dirty bitmap are packed again; update bits are set for
+*   them and cleared for the others. A frame the CAN driver does not take is tried again at the
+*   next call, with its signals still marked. Called periodically.
+* Input: None
+* Output: None
+*/
+void Com_MainFunctionTx(void) {
+    if (!Com_Initialized) {
+        return;
+    }
+    for (uint8_t ipdu = 0; ipdu < COM_NUM_TX_IPDUS; ipdu++) {
+        const Com_TxIpduConfigType* cfg = &Com_TxIpduConfig[ipdu];
+        Com_TxIpduStateType* st = &Com_TxState[ipdu];
+        Can_PduType pdu;
+        SchM_StateType state;
+        uint32_t dirty;
+
+        if (cfg->period != 0) {
+            if (--st->countdown != 0 && !st->retry) {
+                continue;
+            }
+            if (st->countdown == 0) {
+                st->countdown = cfg->period;
+            }
+        } else if (st->dirty == 0 && !st->retry) {
+            continue;
+        }
+
+        SchM_Enter(state);
+        dirty = st->dirty;
+        st->dirty = 0;
+        SchM_Exit(state);
+        Com_PackFunctions[ipdu](st->data, Com_TxValues, dirty);
+
+        pdu.swPduHandle = ipdu;
+        pdu.length = cfg->length;
+        pdu.id = cfg->id;
+        pdu.sdu = st->data;
+        st->retry = (Can_Write(cfg->hth, &pdu) != CAN_OK);
+        if (st->retry) {
+            SchM_Enter(state);
+            st->dirty |= dirty;
+            SchM_Exit(state);
+        }
+    }
+}
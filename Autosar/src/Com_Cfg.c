@@ -0,0 +1,29 @@
+/*
+* File: Com_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: I-PDUs and signals of the COM module, from the lists of Com_Cfg.h. Their pack and
+* unpack functions are generated into Com_Pack_Cfg.c.
+*/
+
+#include "Com.h"
+
+#define COM_RX_IPDU(name, length)                   { (length) },
+#define COM_TX_IPDU(name, hth, id, length, period)  { (hth), (id), (length), (period) },
+#define COM_SIGNAL(name, ipdu, type, ...)           { (ipdu), (type) },
+
+const Com_RxIpduConfigType Com_RxIpduConfig[COM_NUM_RX_IPDUS] = {
+    COM_RX_IPDUS(COM_RX_IPDU)
+};
+
+const Com_TxIpduConfigType Com_TxIpduConfig[COM_NUM_TX_IPDUS] = {
+    COM_TX_IPDUS(COM_TX_IPDU)
+};
+
+const Com_SignalConfigType Com_RxSignalConfig[COM_NUM_RX_SIGNALS] = {
+    COM_RX_SIGNALS(COM_SIGNAL)
+};
+
+const Com_SignalConfigType Com_TxSignalConfig[COM_NUM_TX_SIGNALS] = {
+    COM_TX_SIGNALS(COM_SIGNAL)
+};
@@ -0,0 +1,178 @@
+/*
+* File: Com_Pack_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Pack and unpack functions of the COM module, generated by Test/Com_Gen.c from the signal
+* lists of Com_Cfg.h. Do not edit: run "make -C Test com" instead.
+*/
+
+#include "Com.h"
+
+static void Com_Pack_EXT_ADC(uint8_t* Data, const uint32_t* Values, uint32_t Dirty) {
+    if (Dirty & 0x1u) {
+        uint32_t v = Values[COM_SIG_EXT_ADC_0];
+        Data[0] = (uint8_t)v;
+        Data[1] = (uint8_t)(v >> 8);
+    }
+    if (Dirty & 0x2u) {
+        uint32_t v = Values[COM_SIG_EXT_ADC_1];
+        Data[2] = (uint8_t)v;
+        Data[3] = (uint8_t)(v >> 8);
+    }
+    if (Dirty & 0x4u) {
+        uint32_t v = Values[COM_SIG_EXT_ADC_2];
+        Data[4] = (uint8_t)v;
+        Data[5] = (uint8_t)(v >> 8);
+    }
+}
+
+static void Com_Pack_ECU_STATUS(uint8_t* Data, const uint32_t* Values, uint32_t Dirty) {
+    Data[0] &= 0xEFu;
+    Data[7] &= 0x7Fu;
+    if (Dirty & 0x1u) {
+        uint32_t v = Values[COM_SIG_ECU_STATE];
+        Data[0] = (uint8_t)((Data[0] & 0xF8u) | (v & 0x07u));
+    }
+    if (Dirty & 0x2u) {
+        uint32_t v = Values[COM_SIG_ECU_FAULT];
+        Data[0] = (uint8_t)((Data[0] & 0xF7u) | ((v << 3) & 0x08u));
+        Data[0] |= 0x10u;
+    }
+    if (Dirty & 0x4u) {
+        uint32_t v = Values[COM_SIG_ECU_VOLTAGE];
+        Data[2] = (uint8_t)((Data[2] & 0x0Fu) | ((v << 4) & 0xF0u));
+        Data[1] = (uint8_t)(v >> 4);
+    }
+    if (Dirty & 0x8u) {
+        uint32_t v = Values[COM_SIG_ECU_TEMPERATURE];
+        Data[3] = (uint8_t)v;
+    }
+    if (Dirty & 0x10u) {
+        uint32_t v = Values[COM_SIG_ECU_BOOT_COUNT];
+        Data[6] = (uint8_t)v;
+        Data[5] = (uint8_t)(v >> 8);
+        Data[4] = (uint8_t)(v >> 16);
+        Data[7] |= 0x80u;
+    }
+    if (Dirty & 0x20u) {
+        uint32_t v = Values[COM_SIG_ECU_ALIVE];
+        Data[7] = (uint8_t)((Data[7] & 0xF0u) | (v & 0x0Fu));
+    }
+}
+
+static void Com_Pack_TSC1(uint8_t* Data, const uint32_t* Values, uint32_t Dirty) {
+    if (Dirty & 0x1u) {
+        uint32_t v = Values[COM_SIG_TSC1_OVERRIDE_MODE];
+        Data[0] = (uint8_t)((Data[0] & 0xFCu) | (v & 0x03u));
+    }
+    if (Dirty & 0x2u) {
+        uint32_t v = Values[COM_SIG_TSC1_SPEED_CONDITION];
+        Data[0] = (uint8_t)((Data[0] & 0xF3u) | ((v << 2) & 0x0Cu));
+    }
+    if (Dirty & 0x4u) {
+        uint32_t v = Values[COM_SIG_TSC1_REQUESTED_SPEED];
+        Data[1] = (uint8_t)v;
+        Data[2] = (uint8_t)(v >> 8);
+    }
+    if (Dirty & 0x8u) {
+        uint32_t v = Values[COM_SIG_TSC1_REQUESTED_TORQUE];
+        Data[3] = (uint8_t)v;
+    }
+    if (Dirty & 0x10u) {
+        uint32_t v = Values[COM_SIG_TSC1_CHECKSUM];
+        Data[7] = (uint8_t)((Data[7] & 0x0Fu) | ((v << 4) & 0xF0u));
+    }
+}
+
+static void Com_Unpack_BRAKE(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_BRAKE_PRESSURE] = (uint32_t)Data[0] | ((uint32_t)Data[1] << 8);
+    Values[COM_SIG_BRAKE_PEDAL] = (uint32_t)(Data[2] & 0x01u);
+    Values[COM_SIG_BRAKE_COUNTER] = (uint32_t)(Data[7] & 0x0Fu);
+    Values[COM_SIG_BRAKE_CHECKSUM] = ((uint32_t)(Data[7] & 0xF0u) >> 4);
+}
+
+static void Com_Unpack_STEERING(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_STEERING_ANGLE] = (((uint32_t)Data[1] | ((uint32_t)Data[0] << 8)) ^ 0x8000u) - 0x8000u;
+    if (Data[4] & 0x01u) {
+        Values[COM_SIG_STEERING_RATE] = ((((uint32_t)(Data[3] & 0xF0u) >> 4) | ((uint32_t)Data[2] << 4)) ^ 0x800u) - 0x800u;
+    }
+    Values[COM_SIG_STEERING_STATUS] = (uint32_t)(Data[3] & 0x0Fu);
+}
+
+static void Com_Unpack_WHEEL_SPEED_FL(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_WHEEL_SPEED_FL] = (uint32_t)Data[0] | ((uint32_t)(Data[1] & 0x3Fu) << 8);
+    Values[COM_SIG_WHEEL_DIRECTION_FL] = ((uint32_t)(Data[1] & 0xC0u) >> 6);
+    Values[COM_SIG_WHEEL_PULSES_FL] = (uint32_t)Data[2] | ((uint32_t)Data[3] << 8);
+}
+
+static void Com_Unpack_WHEEL_SPEED_FR(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_WHEEL_SPEED_FR] = (uint32_t)Data[0] | ((uint32_t)(Data[1] & 0x3Fu) << 8);
+    Values[COM_SIG_WHEEL_DIRECTION_FR] = ((uint32_t)(Data[1] & 0xC0u) >> 6);
+    Values[COM_SIG_WHEEL_PULSES_FR] = (uint32_t)Data[2] | ((uint32_t)Data[3] << 8);
+}
+
+static void Com_Unpack_YAW_RATE(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_YAW_RATE] = (((uint32_t)Data[1] | ((uint32_t)Data[0] << 8)) ^ 0x8000u) - 0x8000u;
+    Values[COM_SIG_LATERAL_ACCEL] = (((uint32_t)Data[3] | ((uint32_t)Data[2] << 8)) ^ 0x8000u) - 0x8000u;
+    Values[COM_SIG_LONGITUDINAL_ACCEL] = ((((uint32_t)(Data[4] & 0xF0u) >> 4) | ((uint32_t)Data[5] << 4) | ((uint32_t)(Data[6] & 0x01u) << 12)) ^ 0x1000u) - 0x1000u;
+    Values[COM_SIG_YAW_QUALIFIER] = (uint32_t)(Data[4] & 0x03u);
+}
+
+static void Com_Unpack_GEAR(const uint8_t* Data, uint32_t* Values) {
+    if (Data[1] & 0x01u) {
+        Values[COM_SIG_GEAR_POSITION] = (uint32_t)(Data[0] & 0x0Fu);
+    }
+    if (Data[1] & 0x02u) {
+        Values[COM_SIG_GEAR_TARGET] = ((uint32_t)(Data[0] & 0xF0u) >> 4);
+    }
+}
+
+static void Com_Unpack_ODOMETER(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_ODOMETER] = (uint32_t)Data[0] | ((uint32_t)Data[1] << 8) | ((uint32_t)Data[2] << 16) | ((uint32_t)Data[3] << 24);
+    Values[COM_SIG_TRIP] = (uint32_t)Data[4] | ((uint32_t)Data[5] << 8) | ((uint32_t)Data[6] << 16);
+}
+
+static void Com_Unpack_EEC1(const uint8_t* Data, uint32_t* Values) {
+    Values[COM_SIG_ENGINE_TORQUE_MODE] = (uint32_t)(Data[0] & 0x0Fu);
+    Values[COM_SIG_DRIVER_DEMAND_TORQUE] = (uint32_t)Data[1];
+    Values[COM_SIG_ACTUAL_TORQUE] = (uint32_t)Data[2];
+    Values[COM_SIG_ENGINE_SPEED] = (uint32_t)Data[3] | ((uint32_t)Data[4] << 8);
+    Values[COM_SIG_ENGINE_SOURCE] = (uint32_t)Data[5];
+    Values[COM_SIG_STARTER_MODE] = (uint32_t)(Data[6] & 0x0Fu);
+    Values[COM_SIG_ENGINE_DEMAND_TORQUE] = (uint32_t)Data[7];
+}
+
+const Com_PackFunctionType Com_PackFunctions[COM_NUM_TX_IPDUS] = {
+    Com_Pack_EXT_ADC,
+    Com_Pack_ECU_STATUS,
+    Com_Pack_TSC1,
+};
+
+const Com_UnpackFunctionType Com_UnpackFunctions[COM_NUM_RX_IPDUS] = {
+    Com_Unpack_BRAKE,
+    Com_Unpack_STEERING,
+    Com_Unpack_WHEEL_SPEED_FL,
+    Com_Unpack_WHEEL_SPEED_FR,
+    Com_Unpack_YAW_RATE,
+    Com_Unpack_GEAR,
+    Com_Unpack_ODOMETER,
+    Com_Unpack_EEC1,
+};
+
+// Bit of each sent signal in the dirty bitmap of its I-PDU
+const uint32_t Com_TxSignalMask[COM_NUM_TX_SIGNALS] = {
+    0x00000001u,   /* COM_SIG_EXT_ADC_0 */
+    0x00000002u,   /* COM_SIG_EXT_ADC_1 */
+    0x00000004u,   /* COM_SIG_EXT_ADC_2 */
+    0x00000001u,   /* COM_SIG_ECU_STATE */
+    0x00000002u,   /* COM_SIG_ECU_FAULT */
+    0x00000004u,   /* COM_SIG_ECU_VOLTAGE */
+    0x00000008u,   /* COM_SIG_ECU_TEMPERATURE */
+    0x00000010u,   /* COM_SIG_ECU_BOOT_COUNT */
+    0x00000020u,   /* COM_SIG_ECU_ALIVE */
+    0x00000001u,   /* COM_SIG_TSC1_OVERRIDE_MODE */
+    0x00000002u,   /* COM_SIG_TSC1_SPEED_CONDITION */
+    0x00000004u,   /* COM_SIG_TSC1_REQUESTED_SPEED */
+    0x00000008u,   /* COM_SIG_TSC1_REQUESTED_TORQUE */
+    0x00000010u,   /* COM_SIG_TSC1_CHECKSUM */
+};
@@ -0,0 +1,692 @@
+/*
+* File: Dcm.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Dcm.h containing the implementation of the DCM module.
+*/
+
+#include "Dcm.h"
+#include "SchM.h"
+#include <string.h>
+
+// Services
+#define DCM_SID_READ_DID            0x22u
+#define DCM_SID_WRITE_DID           0x2Eu
+#define DCM_SID_REQUEST_DOWNLOAD    0x34u
+#define DCM_SID_TRANSFER_DATA       0x36u
+#define DCM_SID_TRANSFER_EXIT       0x37u
+#define DCM_POSITIVE                0x40u   // Added to the service identifier in a positive response
+#define DCM_NEGATIVE                0x7Fu
+
+// Negative response codes
+#define DCM_E_POSITIVE                      0x00u   // No negative response
+#define DCM_E_SERVICE_NOT_SUPPORTED         0x11u
+#define DCM_E_INCORRECT_LENGTH              0x13u
+#define DCM_E_REQUEST_SEQUENCE_ERROR        0x24u
+#define DCM_E_REQUEST_OUT_OF_RANGE          0x31u
+#define DCM_E_UPLOAD_DOWNLOAD_NOT_ACCEPTED  0x70u
+#define DCM_E_TRANSFER_DATA_SUSPENDED       0x71u
+#define DCM_E_GENERAL_PROGRAMMING_FAILURE   0x72u
+#define DCM_E_WRONG_BLOCK_SEQUENCE_COUNTER  0x73u
+#define DCM_E_RESPONSE_PENDING              0x78u
+
+// RequestDownload: uncompressed, unencrypted data; 4-byte memory address and size
+#define DCM_DATA_FORMAT             0x00u
+#define DCM_ADDRESS_LENGTH_FORMAT   0x44u
+// Length of maxNumberOfBlockLength in the positive response
+#define DCM_BLOCK_LENGTH_FORMAT     0x20u
+
+// State of a buffer
+#define DCM_BUFFER_FREE             0u
+#define DCM_BUFFER_RECEIVING        1u      // CanTp copies a request into it
+#define DCM_BUFFER_QUEUED           2u      // Data of a TransferData waiting for room in the FLS queue
+#define DCM_BUFFER_PROGRAMMING      3u      // FLS job of its data queued
+
+// Response awaited
+#define DCM_WAIT_NONE               0u
+#define DCM_WAIT_BUFFER             1u      // TransferData: a buffer free for the next block
+#define DCM_WAIT_IDLE               2u      // RequestTransferExit: every job ended
+#define DCM_WAIT_ERASE              3u      // RequestDownload: the download area erased
+
+// Frame sent by CanTp
+#define DCM_TX_NONE                 0u
+#define DCM_TX_PENDING              1u      // Response pending
+#define DCM_TX_RESPONSE             2u
+
+// Job of Dcm_Jobs erasing the download area; other jobs are buffer indexes
+#define DCM_ERASE_JOB               0xFFu
+#define DCM_MAX_JOBS                (DCM_NUM_BUFFERS + 1u)
+
+// Room for the last block padded to the program unit
+#define DCM_BUFFER_SIZE             (DCM_MAX_BLOCK_LENGTH + 8u)
+
+// Download in progress
+typedef struct {
+    uint8_t active;
+    uint8_t failed;                         // An FLS job failed
+    uint8_t bsc;                            // Block sequence counter of the next block
+    uint8_t blocks;                         // A block has been accepted
+    Fls_AddressType address;                // Next address programmed
+    Fls_LengthType remaining;
+    Fls_AddressType eraseAddress;
+    Fls_LengthType eraseLength;             // Of the erase not queued yet, 0 once queued
+} Dcm_DownloadType;
+
+static const Dcm_ConfigType* Dcm_ActiveConfig;
+static uint8_t Dcm_Initialized;
+
+static uint8_t Dcm_Buffers[DCM_NUM_BUFFERS][DCM_BUFFER_SIZE];
+static volatile uint8_t Dcm_BufferState[DCM_NUM_BUFFERS];
+static PduLengthType Dcm_BufferLength[DCM_NUM_BUFFERS];     // Request, then the data programmed
+static Fls_AddressType Dcm_BufferAddress[DCM_NUM_BUFFERS];  // Where the data are programmed
+static uint8_t Dcm_RxBuffer;                // Buffer receiving, DCM_NUM_BUFFERS if none
+static CanTp_ConnectionType Dcm_RxConnection;
+
+// FLS jobs of the module in the order they were queued
+static uint8_t Dcm_Jobs[DCM_MAX_JOBS];
+static uint8_t Dcm_JobHead;
+static uint8_t Dcm_JobCount;
+
+static Dcm_DownloadType Dcm_Download;
+static volatile uint8_t Dcm_Wait;
+static volatile uint8_t Dcm_PendingSent;    // A response pending was sent during the wait
+static uint8_t Dcm_WaitSid;
+static uint8_t Dcm_WaitBsc;
+
+static uint8_t Dcm_Response[DCM_MAX_RESPONSE_LENGTH];
+static volatile PduLengthType Dcm_ResponseLength;   // Response not yet taken by CanTp, 0 if none
+static uint8_t Dcm_PendingFrame[3];
+static volatile uint8_t Dcm_TxFrame;
+static Gpt_TimerType Dcm_P2Timer;
+static Dcm_StatsType Dcm_Stats;
+
+/*
+* Function: Dcm_Init
+* Description: Initializes the module: no request, no download. The GPT driver must be initialized;
+*   the timer of a previous initialization is forgotten, so a running module is stopped by
+*   Dcm_DeInit first.
+* Input:
+*   - ConfigPtr: Configuration, NULL for Dcm_Config.
+* Output: None
+*/
+void Dcm_Init(const Dcm_ConfigType* ConfigPtr) {
+    Dcm_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Dcm_Config;
+    memset((void*)Dcm_BufferState, DCM_BUFFER_FREE, sizeof(Dcm_BufferState));
+    Dcm_RxBuffer = DCM_NUM_BUFFERS;
+    Dcm_JobHead = 0;
+    Dcm_JobCount = 0;
+    memset(&Dcm_Download, 0, sizeof(Dcm_Download));
+    Dcm_Wait = DCM_WAIT_NONE;
+    Dcm_ResponseLength = 0;
+    Dcm_TxFrame = DCM_TX_NONE;
+    memset(&Dcm_P2Timer, 0, sizeof(Dcm_P2Timer));
+    memset(&Dcm_Stats, 0, sizeof(Dcm_Stats));
+    Dcm_Initialized = 1;
+}
+
+/*
+* Function: Dcm_DeInit
+* Description: Stops the module and its timer. FLS jobs already queued run to their end.
+* Input: None
+* Output: None
+*/
+void Dcm_DeInit(void) {
+    Dcm_Initialized = 0;
+    Gpt_TimerStop(&Dcm_P2Timer);
+}
+
+/*
+* Function: Dcm_P2Expired
+* Description: The response is not ready in time: sends a response pending, again every
+*   DCM_P2_STAR. Runs from the GPT interrupt.
+* Input:
+*   - Context: Unused.
+* Output: None
+*/
+static void Dcm_P2Expired(void* Context) {
+    SchM_StateType state;
+
+    (void)Context;
+    SchM_Enter(state);
+    if (Dcm_Wait != DCM_WAIT_NONE && Dcm_TxFrame == DCM_TX_NONE) {
+        Dcm_PendingFrame[0] = DCM_NEGATIVE;
+        Dcm_PendingFrame[1] = Dcm_WaitSid;
+        Dcm_PendingFrame[2] = DCM_E_RESPONSE_PENDING;
+        if (CanTp_Transmit(CANTP_DIAG_PHYSICAL, Dcm_PendingFrame, sizeof(Dcm_PendingFrame)) == E_OK) {
+            Dcm_TxFrame = DCM_TX_PENDING;
+            Dcm_PendingSent = 1;
+            Dcm_Stats.responsesPending++;
+        }
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Dcm_StartWait
+* Description: Defers the response of a request until the condition is met; response pending is
+*   sent meanwhile.
+* Input:
+*   - Wait: DCM_WAIT_BUFFER, DCM_WAIT_IDLE or DCM_WAIT_ERASE.
+*   - Sid: Service of the request.
+* Output: None
+*/
+static void Dcm_StartWait(uint8_t Wait, uint8_t Sid) {
+    Dcm_WaitSid = Sid;
+    Dcm_PendingSent = 0;
+    Dcm_Wait = Wait;
+    (void)Gpt_TimerStart(&Dcm_P2Timer, DCM_P2, DCM_P2_STAR, Dcm_P2Expired, NULL);
+}
+
+/*
+* Function: Dcm_SetResponse
+* Description: Hands the response written into Dcm_Response to Dcm_TrySend and ends the wait, if
+*   any.
+* Input:
+*   - Length: Bytes of the response.
+* Output: None
+*/
+static void Dcm_SetResponse(PduLengthType Length) {
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    Dcm_Wait = DCM_WAIT_NONE;
+    Dcm_ResponseLength = Length;
+    SchM_Exit(state);
+    Gpt_TimerStop(&Dcm_P2Timer);
+}
+
+/*
+* Function: Dcm_SetNegativeResponse
+* Description: Answers a request with a negative response.
+* Input:
+*   - Sid: Service of the request.
+*   - Nrc: Negative response code.
+* Output: None
+*/
+static void Dcm_SetNegativeResponse(uint8_t Sid, uint8_t Nrc) {
+    Dcm_Response[0] = DCM_NEGATIVE;
+    Dcm_Response[1] = Sid;
+    Dcm_Response[2] = Nrc;
+    Dcm_Stats.negativeResponses++;
+    Dcm_SetResponse(3);
+}
+
+/*
+* Function: Dcm_TrySend
+* Description: Gives the response to CanTp once the frame it is sending, a response pending, is
+*   confirmed.
+* Input: None
+* Output: None
+*/
+static void Dcm_TrySend(void) {
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (Dcm_ResponseLength != 0 && Dcm_TxFrame == DCM_TX_NONE &&
+        CanTp_Transmit(CANTP_DIAG_PHYSICAL, Dcm_Response, Dcm_ResponseLength) == E_OK) {
+        Dcm_TxFrame = DCM_TX_RESPONSE;
+        Dcm_ResponseLength = 0;
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Dcm_FindDid
+* Description: Looks a data identifier up in the configuration.
+* Input:
+*   - Id: Identifier of the request.
+* Output: The data identifier, NULL if it is not configured.
+*/
+static const Dcm_DidConfigType* Dcm_FindDid(uint16_t Id) {
+    for (uint8_t i = 0; i < Dcm_ActiveConfig->numDids; i++) {
+        if (Dcm_ActiveConfig->dids[i].id == Id) {
+            return &Dcm_ActiveConfig->dids[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+* Function: Dcm_ReadDataByIdentifier
+* Description: Service 0x22 for one data identifier.
+* Input:
+*   - Request: Request.
+*   - Length: Bytes of the request.
+* Output: DCM_E_POSITIVE or a negative response code.
+*/
+static uint8_t Dcm_ReadDataByIdentifier(const uint8_t* Request, PduLengthType Length) {
+    const Dcm_DidConfigType* did;
+
+    if (Length != 3u) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    did = Dcm_FindDid((uint16_t)((Request[1] << 8) | Request[2]));
+    if (did == NULL || 3u + did->length > DCM_MAX_RESPONSE_LENGTH) {
+        return DCM_E_REQUEST_OUT_OF_RANGE;
+    }
+    Dcm_Response[0] = DCM_SID_READ_DID + DCM_POSITIVE;
+    Dcm_Response[1] = Request[1];
+    Dcm_Response[2] = Request[2];
+    memcpy(&Dcm_Response[3], did->data, did->length);
+    Dcm_SetResponse(3u + did->length);
+    return DCM_E_POSITIVE;
+}
+
+/*
+* Function: Dcm_WriteDataByIdentifier
+* Description: Service 0x2E: writes the data and queues the write of its NVM block.
+* Input:
+*   - Request: Request.
+*   - Length: Bytes of the request.
+* Output: DCM_E_POSITIVE or a negative response code.
+*/
+static uint8_t Dcm_WriteDataByIdentifier(const uint8_t* Request, PduLengthType Length) {
+    const Dcm_DidConfigType* did;
+
+    if (Length < 3u) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    did = Dcm_FindDid((uint16_t)((Request[1] << 8) | Request[2]));
+    if (did == NULL || !did->writable) {
+        return DCM_E_REQUEST_OUT_OF_RANGE;
+    }
+    if (Length != 3u + did->length) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    memcpy(did->data, &Request[3], did->length);
+    if (did->nvmBlock != 0 && NvM_WriteBlock(did->nvmBlock, NULL) != E_OK) {
+        return DCM_E_GENERAL_PROGRAMMING_FAILURE;
+    }
+    Dcm_Response[0] = DCM_SID_WRITE_DID + DCM_POSITIVE;
+    Dcm_Response[1] = Request[1];
+    Dcm_Response[2] = Request[2];
+    Dcm_SetResponse(3);
+    return DCM_E_POSITIVE;
+}
+
+/*
+* Function: Dcm_AddJob
+* Description: Records an FLS job just queued.
+* Input:
+*   - Job: Buffer programmed, or DCM_ERASE_JOB.
+* Output: None
+*/
+static void Dcm_AddJob(uint8_t Job) {
+    Dcm_Jobs[(Dcm_JobHead + Dcm_JobCount) % DCM_MAX_JOBS] = Job;
+    Dcm_JobCount++;
+}
+
+/*
+* Function: Dcm_RequestDownload
+* Description: Service 0x34: answers with a response pending at once, then queues the erase of the
+*   sectors holding the range once it is sent, as the CPU stalls on the flash until the erase ends.
+*   The longest TransferData is answered after the erase.
+* Input:
+*   - Request: Request.
+*   - Length: Bytes of the request.
+* Output: DCM_E_POSITIVE or a negative response code.
+*/
+static uint8_t Dcm_RequestDownload(const uint8_t* Request, PduLengthType Length) {
+    Fls_AddressType address;
+    Fls_LengthType size;
+    Fls_AddressType eraseStart = 0xFFFFFFFFu;
+    Fls_AddressType eraseEnd = 0;
+
+    if (Length != 11u) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    if (Request[1] != DCM_DATA_FORMAT || Request[2] != DCM_ADDRESS_LENGTH_FORMAT) {
+        return DCM_E_REQUEST_OUT_OF_RANGE;
+    }
+    if (Dcm_Download.active) {
+        return DCM_E_REQUEST_SEQUENCE_ERROR;
+    }
+    address = (((uint32_t)Request[3] << 24) | ((uint32_t)Request[4] << 16) | ((uint32_t)Request[5] << 8) | Request[6]) -
+              FLASH_BASE;
+    size = ((uint32_t)Request[7] << 24) | ((uint32_t)Request[8] << 16) | ((uint32_t)Request[9] << 8) | Request[10];
+    if (size == 0 || address < DCM_DOWNLOAD_ADDRESS || address - DCM_DOWNLOAD_ADDRESS >= DCM_DOWNLOAD_SIZE ||
+        size > DCM_DOWNLOAD_SIZE - (address - DCM_DOWNLOAD_ADDRESS) || address % Fls_GetPageSize() != 0) {
+        return DCM_E_REQUEST_OUT_OF_RANGE;
+    }
+    // Whole sectors holding the range
+    for (uint32_t i = 0; i < FLS_NUM_SECTORS; i++) {
+        const Fls_SectorType* sector = &Fls_SectorList[i];
+        if (sector->address < address + size && address < sector->address + sector->size) {
+            if (sector->address < eraseStart) {
+                eraseStart = sector->address;
+            }
+            if (sector->address + sector->size > eraseEnd) {
+                eraseEnd = sector->address + sector->size;
+            }
+        }
+    }
+    // Jobs of a previous download still run
+    if (Dcm_JobCount != 0 || eraseEnd <= eraseStart) {
+        return DCM_E_UPLOAD_DOWNLOAD_NOT_ACCEPTED;
+    }
+    Dcm_Download.active = 1;
+    Dcm_Download.failed = 0;
+    Dcm_Download.bsc = 1;
+    Dcm_Download.blocks = 0;
+    Dcm_Download.address = address;
+    Dcm_Download.remaining = size;
+    Dcm_Download.eraseAddress = eraseStart;
+    Dcm_Download.eraseLength = eraseEnd - eraseStart;
+    Dcm_StartWait(DCM_WAIT_ERASE, DCM_SID_REQUEST_DOWNLOAD);
+    Dcm_P2Expired(NULL);
+    return DCM_E_POSITIVE;
+}
+
+/*
+* Function: Dcm_TransferData
+* Description: Service 0x36: the data are programmed from the buffer they were received in, padded
+*   with erased bytes to the program unit; the response waits for a buffer free for the next block.
+*   A block repeated because its response was lost is answered again without being programmed.
+* Input:
+*   - Buffer: Buffer of the request.
+*   - Length: Bytes of the request.
+* Output: DCM_E_POSITIVE or a negative response code.
+*/
+static uint8_t Dcm_TransferData(uint8_t Buffer, PduLengthType Length) {
+    uint8_t* request = Dcm_Buffers[Buffer];
+    Fls_LengthType count = (Fls_LengthType)Length - 2u;
+    Fls_LengthType page = Fls_GetPageSize();
+    Fls_LengthType padded;
+
+    if (!Dcm_Download.active) {
+        return DCM_E_REQUEST_SEQUENCE_ERROR;
+    }
+    if (Length < 3u) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    if (Dcm_Download.failed) {
+        return DCM_E_GENERAL_PROGRAMMING_FAILURE;
+    }
+    if (Dcm_Download.blocks && request[1] == (uint8_t)(Dcm_Download.bsc - 1u)) {
+        Dcm_WaitBsc = request[1];
+        Dcm_StartWait(DCM_WAIT_BUFFER, DCM_SID_TRANSFER_DATA);
+        return DCM_E_POSITIVE;
+    }
+    if (request[1] != Dcm_Download.bsc) {
+        return DCM_E_WRONG_BLOCK_SEQUENCE_COUNTER;
+    }
+    // Blocks keep the next address aligned; only the last one may end within a unit
+    if (count > Dcm_Download.remaining || (count % page != 0 && count != Dcm_Download.remaining)) {
+        return DCM_E_TRANSFER_DATA_SUSPENDED;
+    }
+    padded = (count + page - 1u) / page * page;
+    memset(&request[2u + count], 0xFF, padded - count);
+    Dcm_BufferLength[Buffer] = (PduLengthType)padded;
+    Dcm_BufferAddress[Buffer] = Dcm_Download.address;
+    Dcm_BufferState[Buffer] = DCM_BUFFER_QUEUED;
+    Dcm_Download.address += count;
+    Dcm_Download.remaining -= count;
+    Dcm_Download.blocks = 1;
+    Dcm_WaitBsc = Dcm_Download.bsc++;
+    Dcm_StartWait(DCM_WAIT_BUFFER, DCM_SID_TRANSFER_DATA);
+    return DCM_E_POSITIVE;
+}
+
+/*
+* Function: Dcm_RequestTransferExit
+* Description: Service 0x37: the response waits for the end of the jobs of the download.
+* Input:
+*   - Length: Bytes of the request.
+* Output: DCM_E_POSITIVE or a negative response code.
+*/
+static uint8_t Dcm_RequestTransferExit(PduLengthType Length) {
+    if (!Dcm_Download.active) {
+        return DCM_E_REQUEST_SEQUENCE_ERROR;
+    }
+    if (Length != 1u) {
+        return DCM_E_INCORRECT_LENGTH;
+    }
+    Dcm_StartWait(DCM_WAIT_IDLE, DCM_SID_TRANSFER_EXIT);
+    return DCM_E_POSITIVE;
+}
+
+/*
+* Function: Dcm_UpdateJobs
+* Description: Frees the buffers whose FLS job has ended. The jobs of the module end in the order
+*   they were queued: when n of them are left in the FLS queue, the others have been programmed. A
+*   failed job ends the download; the jobs of other users, such as Fee, do not affect it.
+* Input: None
+* Output: None
+*/
+static void Dcm_UpdateJobs(void) {
+    uint8_t pending = Fls_GetPendingJobs(FLS_USER_DCM);
+
+    if (Dcm_JobCount == 0) {
+        return;
+    }
+    if (pending == 0 && Fls_GetJobResult(FLS_USER_DCM) != MEMIF_JOB_OK) {
+        // The FLS driver dropped the jobs of the module queued after the failed one
+        for (uint8_t i = 0; i < DCM_NUM_BUFFERS; i++) {
+            if (Dcm_BufferState[i] == DCM_BUFFER_PROGRAMMING || Dcm_BufferState[i] == DCM_BUFFER_QUEUED) {
+                Dcm_BufferState[i] = DCM_BUFFER_FREE;
+            }
+        }
+        Dcm_JobCount = 0;
+        Dcm_Download.failed = 1;
+        Dcm_Stats.programmingFailures++;
+        return;
+    }
+    while (Dcm_JobCount > pending) {
+        uint8_t job = Dcm_Jobs[Dcm_JobHead];
+        Dcm_JobHead = (Dcm_JobHead + 1u) % DCM_MAX_JOBS;
+        Dcm_JobCount--;
+        if (job != DCM_ERASE_JOB) {
+            Dcm_Stats.blocks++;
+            Dcm_Stats.bytesProgrammed += Dcm_BufferLength[job];
+            Dcm_BufferState[job] = DCM_BUFFER_FREE;
+        }
+    }
+}
+
+/*
+* Function: Dcm_Poll
+* Description: Frees the buffers programmed, queues the data waiting for room in the FLS queue, then
+*   sends the deferred response once its condition is met.
+* Input: None
+* Output: None
+*/
+static void Dcm_Poll(void) {
+    uint8_t queued = 0;
+    uint8_t free = 0;
+
+    Dcm_UpdateJobs();
+    for (uint8_t i = 0; i < Dcm_ActiveConfig->buffers; i++) {
+        if (Dcm_BufferState[i] == DCM_BUFFER_QUEUED) {
+            if (Fls_Write(FLS_USER_DCM, Dcm_BufferAddress[i], &Dcm_Buffers[i][2], Dcm_BufferLength[i]) == E_OK) {
+                Dcm_BufferState[i] = DCM_BUFFER_PROGRAMMING;
+                Dcm_AddJob(i);
+            } else {
+                queued = 1;
+            }
+        }
+    }
+    // Programming a single buffer ends in the same call of Fls_MainFunction that queued nothing else
+    Dcm_UpdateJobs();
+    for (uint8_t i = 0; i < Dcm_ActiveConfig->buffers; i++) {
+        free |= (Dcm_BufferState[i] == DCM_BUFFER_FREE);
+    }
+
+    if (Dcm_Wait == DCM_WAIT_BUFFER) {
+        if (Dcm_Download.failed) {
+            Dcm_SetNegativeResponse(DCM_SID_TRANSFER_DATA, DCM_E_GENERAL_PROGRAMMING_FAILURE);
+        } else if (!queued && free) {
+            Dcm_Response[0] = DCM_SID_TRANSFER_DATA + DCM_POSITIVE;
+            Dcm_Response[1] = Dcm_WaitBsc;
+            Dcm_SetResponse(2);
+        }
+    } else if (Dcm_Wait == DCM_WAIT_IDLE) {
+        if (Dcm_Download.failed) {
+            Dcm_Download.active = 0;
+            Dcm_SetNegativeResponse(DCM_SID_TRANSFER_EXIT, DCM_E_GENERAL_PROGRAMMING_FAILURE);
+        } else if (!queued && Dcm_JobCount == 0) {
+            Dcm_Download.active = 0;
+            Dcm_Response[0] = DCM_SID_TRANSFER_EXIT + DCM_POSITIVE;
+            Dcm_SetResponse(1);
+        }
+    } else if (Dcm_Wait == DCM_WAIT_ERASE) {
+        // Queued once the tester has its response pending; the blocks wait for the response
+        if (Dcm_Download.eraseLength != 0 && Dcm_PendingSent && Dcm_TxFrame == DCM_TX_NONE &&
+            Fls_Erase(FLS_USER_DCM, Dcm_Download.eraseAddress, Dcm_Download.eraseLength) == E_OK) {
+            Dcm_AddJob(DCM_ERASE_JOB);
+            Dcm_Download.eraseLength = 0;
+        } else if (Dcm_Download.failed) {
+            Dcm_Download.active = 0;
+            Dcm_SetNegativeResponse(DCM_SID_REQUEST_DOWNLOAD, DCM_E_GENERAL_PROGRAMMING_FAILURE);
+        } else if (Dcm_Download.eraseLength == 0 && Dcm_JobCount == 0) {
+            Dcm_Response[0] = DCM_SID_REQUEST_DOWNLOAD + DCM_POSITIVE;
+            Dcm_Response[1] = DCM_BLOCK_LENGTH_FORMAT;
+            Dcm_Response[2] = (uint8_t)(DCM_MAX_BLOCK_LENGTH >> 8);
+            Dcm_Response[3] = (uint8_t)DCM_MAX_BLOCK_LENGTH;
+            Dcm_SetResponse(4);
+        }
+    }
+    Dcm_TrySend();
+}
+
+/*
+* Function: Dcm_StartOfReception
+* Description: Buffer for a request, from CanTp. One request is served at a time: a request is
+*   refused while the previous one is answered, or when no buffer is free.
+* Input:
+*   - Connection: Connection of the request.
+*   - Length: Bytes of the request.
+* Output: Buffer of DCM_MAX_BLOCK_LENGTH bytes, NULL if the request is refused.
+*/
+uint8_t* Dcm_StartOfReception(CanTp_ConnectionType Connection, PduLengthType Length) {
+    SchM_StateType state;
+    uint8_t* buffer = NULL;
+
+    if (!Dcm_Initialized || Length == 0 || Length > DCM_MAX_BLOCK_LENGTH) {
+        return NULL;
+    }
+    SchM_Enter(state);
+    if (Dcm_RxBuffer == DCM_NUM_BUFFERS && Dcm_Wait == DCM_WAIT_NONE && Dcm_ResponseLength == 0 &&
+        Dcm_TxFrame != DCM_TX_RESPONSE) {
+        for (uint8_t i = 0; i < Dcm_ActiveConfig->buffers; i++) {
+            if (Dcm_BufferState[i] == DCM_BUFFER_FREE) {
+                Dcm_BufferState[i] = DCM_BUFFER_RECEIVING;
+                Dcm_BufferLength[i] = Length;
+                Dcm_RxBuffer = i;
+                Dcm_RxConnection = Connection;
+                buffer = Dcm_Buffers[i];
+                break;
+            }
+        }
+    }
+    SchM_Exit(state);
+    return buffer;
+}
+
+/*
+* Function: Dcm_TpRxIndication
+* Description: End of the reception of a request, from CanTp: serves it. A functional request gets
+*   no negative response for a service or data identifier it does not support.
+* Input:
+*   - Connection: Connection of the request.
+*   - Result: E_OK if the request is complete in the buffer.
+* Output: None
+*/
+void Dcm_TpRxIndication(CanTp_ConnectionType Connection, Std_ReturnType Result) {
+    uint8_t buffer = Dcm_RxBuffer;
+    uint8_t* request;
+    uint8_t nrc;
+
+    (void)Connection;
+    if (!Dcm_Initialized || buffer == DCM_NUM_BUFFERS) {
+        return;
+    }
+    Dcm_RxBuffer = DCM_NUM_BUFFERS;
+    if (Result != E_OK) {
+        Dcm_BufferState[buffer] = DCM_BUFFER_FREE;
+        return;
+    }
+    Dcm_Stats.requests++;
+    request = Dcm_Buffers[buffer];
+    switch (request[0]) {
+    case DCM_SID_READ_DID:
+        nrc = Dcm_ReadDataByIdentifier(request, Dcm_BufferLength[buffer]);
+        break;
+    case DCM_SID_WRITE_DID:
+        nrc = Dcm_WriteDataByIdentifier(request, Dcm_BufferLength[buffer]);
+        break;
+    case DCM_SID_REQUEST_DOWNLOAD:
+        nrc = Dcm_RequestDownload(request, Dcm_BufferLength[buffer]);
+        break;
+    case DCM_SID_TRANSFER_DATA:
+        nrc = Dcm_TransferData(buffer, Dcm_BufferLength[buffer]);
+        break;
+    case DCM_SID_TRANSFER_EXIT:
+        nrc = Dcm_RequestTransferExit(Dcm_BufferLength[buffer]);
+        break;
+    default:
+        nrc = DCM_E_SERVICE_NOT_SUPPORTED;
+        break;
+    }
+    // The buffer of a block programmed is freed at the end of its job
+    if (Dcm_BufferState[buffer] == DCM_BUFFER_RECEIVING) {
+        Dcm_BufferState[buffer] = DCM_BUFFER_FREE;
+    }
+    if (nrc != DCM_E_POSITIVE &&
+        !(Dcm_RxConnection == CANTP_DIAG_FUNCTIONAL &&
+          (nrc == DCM_E_SERVICE_NOT_SUPPORTED || nrc == DCM_E_REQUEST_OUT_OF_RANGE))) {
+        Dcm_SetNegativeResponse(request[0], nrc);
+    }
+    Dcm_Poll();
+}
+
+/*
+* Function: Dcm_TpTxConfirmation
+* Description: End of the transmission of a response or response pending, from CanTp: a response
+*   that waited for it is sent.
+* Input:
+*   - Connection: Connection of the response.
+*   - Result: E_OK if it was sent; a response lost is not repeated.
+* Output: None
+*/
+void Dcm_TpTxConfirmation(CanTp_ConnectionType Connection, Std_ReturnType Result) {
+    (void)Connection;
+    (void)Result;
+    Dcm_TxFrame = DCM_TX_NONE;
+    if (Dcm_Initialized) {
+        Dcm_TrySend();
+    }
+}
+
+/*
+* Function: Dcm_MainFunction
+* Description: Follows the FLS jobs of a download and sends the response waiting for them. Runs
+*   after Fls_MainFunction, which reports the end of the jobs.
+* Input: None
+* Output: None
+*/
+void Dcm_MainFunction(void) {
+    if (Dcm_Initialized) {
+        Dcm_Poll();
+    }
+}
+
+/*
+* Function: Dcm_GetStats
+* Description: Copies the counters of the module.
+* Input:
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters are copied.
+*   - E_NOT_OK: If StatsPtr is NULL.
+*/
+Std_ReturnType Dcm_GetStats(Dcm_StatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = Dcm_Stats;
+    SchM_Exit(state);
+    return E_OK;
+}
@@ -0,0 +1,26 @@
+/*
+* File: Dcm_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Data identifiers of the DCM module, from the list of Dcm_Cfg.h, and its binding to
+* CanTp.
+*/
+
+#include "Dcm.h"
+
+#define DCM_DID(name, id, data, length, writable, nvmBlock) \
+    { (id), (uint8_t*)(data), (length), (writable), (nvmBlock) },
+
+const Dcm_DidConfigType Dcm_DidConfig[DCM_NUM_DIDS] = {
+    DCM_DIDS(DCM_DID)
+};
+
+const Dcm_ConfigType Dcm_Config = {
+    Dcm_DidConfig, DCM_NUM_DIDS, DCM_NUM_BUFFERS
+};
+
+const CanTp_ConfigType Dcm_CanTpConfig = {
+    Dcm_StartOfReception,   /* startOfReception */
+    Dcm_TpRxIndication,     /* rxIndication */
+    Dcm_TpTxConfirmation,   /* txConfirmation */
+};
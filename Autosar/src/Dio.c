@@ -6,7 +6,7 @@
 */
 
 
-#include "DIO.h"
+#include "Dio.h"
 #include "stm32f4xx.h"
 #include "stm32f4xx_gpio.h"
 #include <stddef.h>
@@ -18,32 +18,21 @@
 * Input:
 *   ChannelId - Identifier of the channel to read
 * Output:
-*   Returns the state of the specified channel (STD_HIGH or STD_LOW)
+*   Returns the state of the specified channel (STD_HIGH or STD_LOW), STD_LOW for an invalid channel
 */
 Dio_LevelType Dio_ReadChannel(Dio_ChannelType ChannelId)
 {
-    Dio_LevelType channel_state = STD_LOW;  /* Default channel state is LOW */
-    
-    if (ChannelId < 16) {
-        if (GPIOA->IDR & (1 << ChannelId)) {
-            return STD_HIGH;
-        } else {
-            return STD_LOW;
-        }
-    } else if (ChannelId < 32) {
-        if (GPIOB->IDR & (1 << (ChannelId - 16))) {
-            return STD_HIGH;
-        } else {
-            return STD_LOW;
-        }
+    if (ChannelId >= DIO_NUM_CHANNELS) {
+        return STD_LOW;
     }
-    
-    return channel_state;
+
+    const Dio_ChannelConfigType* channel = &Dio_ChannelConfig[ChannelId];
+    return (READ_REG(channel->port->IDR) & channel->setMask) ? STD_HIGH : STD_LOW;
 }
 
 /*
 * Function: Dio_WriteChannel
-* Description: Writes the state (HIGH or LOW) to a specified channel.
+* Description: Writes the state (HIGH or LOW) to a specified channel with a single store to BSRR.
 * Input:
 *   - ChannelId: The ID of the channel to be written.
 *   - Level: The desired state (STD_HIGH or STD_LOW) to be set on the channel.
@@ -51,19 +40,12 @@ Dio_LevelType Dio_ReadChannel(Dio_ChannelType ChannelId)
 */
 void Dio_WriteChannel(Dio_ChannelType ChannelId, Dio_LevelType Level)
 {
-    if (ChannelId < 16) {
-        if (Level == STD_HIGH) {
-            GPIOA->BSRR = (1 << ChannelId); // Set bit to turn on the channel
-        } else {
-            GPIOA->BSRR = (1 << (ChannelId + 16)); // Set bit to turn off the channel
-        }
-    } else if (ChannelId < 32) {
-        if (Level == STD_HIGH) {
-            GPIOB->BSRR = (1 << (ChannelId - 16)); // Set bit to turn on the channel
-        } else {
-            GPIOB->BSRR = (1 << (ChannelId + 16 - 16)); // Set bit to turn off the channel
-        }
+    if (ChannelId >= DIO_NUM_CHANNELS) {
+        return;
     }
+
+    const Dio_ChannelConfigType* channel = &Dio_ChannelConfig[ChannelId];
+    WRITE_REG(channel->port->BSRR, (Level == STD_HIGH) ? channel->setMask : channel->resetMask);
 }
 
 /*
@@ -79,22 +61,10 @@ Dio_PortLevelType Dio_ReadChannelGroup(const Dio_ChannelGroupType* ChannelGroupI
 {
     Dio_PortLevelType port_state = 0;  /* Initialize port state to 0 */
     
-    if (ChannelGroupIdPtr != NULL)
+    if (ChannelGroupIdPtr != NULL && ChannelGroupIdPtr->port < DIO_NUM_PORTS)
     {
-        switch(ChannelGroupIdPtr->port)
-        {
-            case GPIOA_BASE:
-                port_state = GPIOA->IDR & ChannelGroupIdPtr->mask;  /* Read the state of port A for the specified channels and store in port_state */
-                break;
-            case GPIOB_BASE:
-                port_state = GPIOB->IDR & ChannelGroupIdPtr->mask;  /* Read the state of port B for the specified channels and store in port_state */
-                break;
-            // Add other cases for other ports if needed
-            default:
-                // Handle the case if PortId is invalid
-                // For example: do nothing or report an error
-                break;
-        }
+        /* Read the state of the port for the specified channels */
+        port_state = READ_REG(DIO_PORT_REGS(ChannelGroupIdPtr->port)->IDR) & ChannelGroupIdPtr->mask;
     }
     
     return port_state;  /* Return the state of the port */
@@ -105,6 +75,8 @@ Dio_PortLevelType Dio_ReadChannelGroup(const Dio_ChannelGroupType* ChannelGroupI
 /*
 * Function: Dio_WriteChannelGroup
 * Description: Writes the specified level to the group of channels indicated by the given ChannelGroupIdPtr.
+*   A single BSRR store sets and clears the channels of the group together, so pins of the same port
+*   driven from interrupts are never overwritten and no interrupt lock is needed.
 * Input:
 *   - ChannelGroupIdPtr: Pointer to a structure containing the port ID and channel mask.
 *   - Level: The level to be written to the specified channels.
@@ -113,22 +85,9 @@ Dio_PortLevelType Dio_ReadChannelGroup(const Dio_ChannelGroupType* ChannelGroupI
 */
 void Dio_WriteChannelGroup(const Dio_ChannelGroupType* ChannelGroupIdPtr, Dio_PortLevelType Level)
 {
-    if (ChannelGroupIdPtr != NULL)
+    if (ChannelGroupIdPtr != NULL && ChannelGroupIdPtr->port < DIO_NUM_PORTS)
     {
-        switch(ChannelGroupIdPtr->port)
-        {
-            case GPIOA_BASE:
-                GPIOA->ODR = (GPIOA->ODR & ~ChannelGroupIdPtr->mask) | (Level & ChannelGroupIdPtr->mask);  /* Write value of port A for the specified channels */
-                break;
-            case GPIOB_BASE:
-                GPIOB->ODR = (GPIOB->ODR & ~ChannelGroupIdPtr->mask) | (Level & ChannelGroupIdPtr->mask);  /* Write value of port B for the specified channels */
-                break;
-            // Add other cases for other ports if needed
-            default:
-                // Handle the case if PortId is invalid
-                // For example: do nothing or report an error
-                break;
-        }
+        WRITE_REG(DIO_PORT_REGS(ChannelGroupIdPtr->port)->BSRR, DIO_BSRR_MASKED(Level, ChannelGroupIdPtr->mask));
     }
 }
 
@@ -157,50 +116,101 @@ void Dio_GetVersionInfo(Std_VersionInfoType* VersionInfo)
 /*
 * Function: Dio_FlipChannel
 * Description: Toggles the state of the specified channel (i.e., flips the channel's logic level).
+*   The new level is derived from the output latch (ODR), not from the pin input, and written with
+*   one BSRR store.
 * Input:
 *   - ChannelId: Identifier of the channel whose state will be toggled.
 * Output:
-*   - Returns the new state of the channel after toggling (STD_HIGH or STD_LOW).
+*   - Returns the new state of the channel after toggling (STD_HIGH or STD_LOW), STD_LOW for an
+*     invalid channel.
 */
 
 Dio_LevelType Dio_FlipChannel(Dio_ChannelType ChannelId)
 {
-    Dio_LevelType channel_state = Dio_ReadChannel(ChannelId);  /* Read current state of channel */
-    
-    /* Toggle the state */
-    if(channel_state == STD_HIGH)
-    {
-        Dio_WriteChannel(ChannelId, STD_LOW);  /* If state is HIGH, write LOW */
-        return STD_LOW;  /* Return LOW */
+    if (ChannelId >= DIO_NUM_CHANNELS) {
+        return STD_LOW;
     }
-    else
-    {
-        Dio_WriteChannel(ChannelId, STD_HIGH);  /* If state is LOW, write HIGH */
-        return STD_HIGH;  /* Return HIGH */
+
+    const Dio_ChannelConfigType* channel = &Dio_ChannelConfig[ChannelId];
+    if (READ_REG(channel->port->ODR) & channel->setMask) {
+        WRITE_REG(channel->port->BSRR, channel->resetMask);
+        return STD_LOW;
     }
+    WRITE_REG(channel->port->BSRR, channel->setMask);
+    return STD_HIGH;
+}
+
+/*
+* Function: Dio_FlipChannels
+* Description: Toggles all channels of a port selected by the mask with one read of ODR and one BSRR
+*   store, e.g. to generate several clock or square-wave outputs in phase.
+* Input:
+*   - PortId: Identifier of the port (DIO_PORT_A..DIO_PORT_I).
+*   - Mask: A bitmask of the channels to toggle.
+* Output:
+*   - Returns the new output level of the toggled channels, 0 for an invalid port.
+*/
+Dio_PortLevelType Dio_FlipChannels(Dio_PortType PortId, Dio_PortLevelType Mask)
+{
+    if (PortId >= DIO_NUM_PORTS) {
+        return 0;
+    }
+
+    GPIO_TypeDef* gpio = DIO_PORT_REGS(PortId);
+    Dio_PortLevelType level = (Dio_PortLevelType)~READ_REG(gpio->ODR);
+
+    WRITE_REG(gpio->BSRR, DIO_BSRR_MASKED(level, Mask));
+    return (Dio_PortLevelType)(level & Mask);
 }
 
 /*
 * Function: Dio_MaskedWritePort
-* Description: Writes the specified value to the specified port, while preserving the state of only the channels specified by the mask.
+* Description: Writes the specified value to the channels of the port selected by the mask, with a single
+*   atomic BSRR store. The other channels of the port keep their state.
 * Input:
-*   - PortId: Identifier of the port to write to (e.g., GPIOA_BASE, GPIOB_BASE).
+*   - PortId: Identifier of the port to write to (DIO_PORT_A..DIO_PORT_I).
 *   - Level: The value to write to the port.
-*   - Mask: A bitmask indicating which channels' states should be preserved while writing the new value.
+*   - Mask: A bitmask of the channels to write.
 * Output: None
 */
 void Dio_MaskedWritePort(Dio_PortType PortId, Dio_PortLevelType Level, Dio_PortLevelType Mask)
 {
-    switch(PortId)
+    if (PortId < DIO_NUM_PORTS)
+    {
+        WRITE_REG(DIO_PORT_REGS(PortId)->BSRR, DIO_BSRR_MASKED(Level, Mask));
+    }
+}
+
+/*
+* Function: Dio_ReadPort
+* Description: Reads the input level of all 16 channels of a port.
+* Input:
+*   - PortId: Identifier of the port to read (DIO_PORT_A..DIO_PORT_I).
+* Output:
+*   - Returns the level of the port, 0 for an invalid port.
+*/
+Dio_PortLevelType Dio_ReadPort(Dio_PortType PortId)
+{
+    if (PortId >= DIO_NUM_PORTS)
+    {
+        return 0;
+    }
+
+    return (Dio_PortLevelType)READ_REG(DIO_PORT_REGS(PortId)->IDR);
+}
+
+/*
+* Function: Dio_WritePort
+* Description: Writes all 16 channels of a port with a single BSRR store.
+* Input:
+*   - PortId: Identifier of the port to write to (DIO_PORT_A..DIO_PORT_I).
+*   - Level: The value to write to the port.
+* Output: None
+*/
+void Dio_WritePort(Dio_PortType PortId, Dio_PortLevelType Level)
+{
+    if (PortId < DIO_NUM_PORTS)
     {
-        case GPIOA_BASE:
-            GPIOA->ODR = (GPIOA->ODR & ~Mask) | (Level & Mask);  /* Write value to port A, changing only the channels specified by the mask */
-            break;
-        case GPIOB_BASE:
-            GPIOB->ODR = (GPIOB->ODR & ~Mask) | (Level & Mask);  /* Write value to port B, changing only the channels specified by the mask */
-            break;
-        // Add other cases for other ports if needed
-        default:
-            break;
+        WRITE_REG(DIO_PORT_REGS(PortId)->BSRR, DIO_BSRR_MASKED(Level, 0xFFFFu));
     }
 }
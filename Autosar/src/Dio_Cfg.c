@@ -0,0 +1,31 @@
+/*
+* File: Dio_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Channel table of the DIO driver, generated at compile time for every pin of GPIOA..GPIOI.
+*/
+
+#include "Dio.h"
+
+/* One entry per pin: register block, BSRR word driving the pin high, BSRR word driving it low */
+#define DIO_CHANNEL_ENTRY(port, pin) \
+    { DIO_PORT_REGS(port), DIO_BSRR_SET(DIO_CHANNEL(port, pin)), DIO_BSRR_RESET(DIO_CHANNEL(port, pin)) }
+
+/* The 16 entries of a port */
+#define DIO_PORT_ENTRIES(port) \
+    DIO_CHANNEL_ENTRY(port, 0),  DIO_CHANNEL_ENTRY(port, 1),  DIO_CHANNEL_ENTRY(port, 2),  DIO_CHANNEL_ENTRY(port, 3),  \
+    DIO_CHANNEL_ENTRY(port, 4),  DIO_CHANNEL_ENTRY(port, 5),  DIO_CHANNEL_ENTRY(port, 6),  DIO_CHANNEL_ENTRY(port, 7),  \
+    DIO_CHANNEL_ENTRY(port, 8),  DIO_CHANNEL_ENTRY(port, 9),  DIO_CHANNEL_ENTRY(port, 10), DIO_CHANNEL_ENTRY(port, 11), \
+    DIO_CHANNEL_ENTRY(port, 12), DIO_CHANNEL_ENTRY(port, 13), DIO_CHANNEL_ENTRY(port, 14), DIO_CHANNEL_ENTRY(port, 15)
+
+const Dio_ChannelConfigType Dio_ChannelConfig[DIO_NUM_CHANNELS] = {
+    DIO_PORT_ENTRIES(DIO_PORT_A),
+    DIO_PORT_ENTRIES(DIO_PORT_B),
+    DIO_PORT_ENTRIES(DIO_PORT_C),
+    DIO_PORT_ENTRIES(DIO_PORT_D),
+    DIO_PORT_ENTRIES(DIO_PORT_E),
+    DIO_PORT_ENTRIES(DIO_PORT_F),
+    DIO_PORT_ENTRIES(DIO_PORT_G),
+    DIO_PORT_ENTRIES(DIO_PORT_H),
+    DIO_PORT_ENTRIES(DIO_PORT_I),
+};
@@ -0,0 +1,72 @@
+/*
+* File: Dma.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Dma.h: one bit per stream of DMA1 and DMA2, set while a driver owns it.
+*/
+
+#include "Dma.h"
+#include "SchM.h"
+
+#define DMA_STREAMS_PER_CONTROLLER  8
+
+// Streams claimed, bit 0 for DMA1 stream 0 and bit 8 for DMA2 stream 0
+static uint16_t Dma_ClaimedStreams;
+
+/*
+* Function: Dma_StreamMask
+* Description: Finds the bit of a stream.
+* Input:
+*   - Stream: DMA1_Stream0 to DMA2_Stream7.
+* Output: Bit of the stream, 0 for any other address.
+*/
+static uint16_t Dma_StreamMask(const DMA_Stream_TypeDef* Stream) {
+    if (Stream >= DMA1_Stream0 && Stream <= DMA1_Stream7) {
+        return (uint16_t)(1u << (Stream - DMA1_Stream0));
+    }
+    if (Stream >= DMA2_Stream0 && Stream <= DMA2_Stream7) {
+        return (uint16_t)(1u << (DMA_STREAMS_PER_CONTROLLER + (Stream - DMA2_Stream0)));
+    }
+    return 0;
+}
+
+/*
+* Function: Dma_ClaimStreams
+* Description: Claims the two streams of a transfer path, both or neither.
+* Input:
+*   - RxStream: Stream moving the peripheral to memory.
+*   - TxStream: Stream moving memory to the peripheral.
+* Output:
+*   - E_OK: If both streams were free and are now owned by the caller.
+*   - E_NOT_OK: If another driver owns one of them; nothing is claimed.
+*/
+Std_ReturnType Dma_ClaimStreams(DMA_Stream_TypeDef* RxStream, DMA_Stream_TypeDef* TxStream) {
+    uint16_t mask = Dma_StreamMask(RxStream) | Dma_StreamMask(TxStream);
+    Std_ReturnType result = E_NOT_OK;
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if ((Dma_ClaimedStreams & mask) == 0) {
+        Dma_ClaimedStreams |= mask;
+        result = E_OK;
+    }
+    SchM_Exit(state);
+    return result;
+}
+
+/*
+* Function: Dma_ReleaseStreams
+* Description: Releases the streams claimed by Dma_ClaimStreams, once they are disabled.
+* Input:
+*   - RxStream: Stream moving the peripheral to memory.
+*   - TxStream: Stream moving memory to the peripheral.
+* Output: None
+*/
+void Dma_ReleaseStreams(DMA_Stream_TypeDef* RxStream, DMA_Stream_TypeDef* TxStream) {
+    uint16_t mask = Dma_StreamMask(RxStream) | Dma_StreamMask(TxStream);
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    Dma_ClaimedStreams &= (uint16_t)~mask;
+    SchM_Exit(state);
+}
@@ -0,0 +1,787 @@
+/*
+* File: Fee.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Fee.h containing the implementation of the FEE module. The sectors
+* form a ring: each one starts with a header holding a sequence number, the newest being the head,
+* where the records are appended. A record is a header of 8 bytes, with the block number, the length,
+* a checksum of the data and a check of the header itself, followed by the data padded to the page
+* size; a length of 0 invalidates the block. Fee_Init scans the sectors from the oldest one, the last
+* valid record of each block winning; a record whose header or data was cut by a reset is skipped.
+* The garbage collection state is rebuilt from the log, nothing else is stored.
+*/
+
+#include "Fee.h"
+#include <string.h>
+
+// Sector header: magic word, then the sequence number
+#define FEE_SECTOR_MAGIC 0x31454546u
+#define FEE_ERASED_WORD 0xFFFFFFFFu
+#define FEE_HEADER_SIZE 8u
+
+// Block number of the free slots of the index and of the erased flash
+#define FEE_NO_BLOCK 0xFFFFu
+// Address of no record: records never start at the beginning of a sector
+#define FEE_NO_RECORD 0u
+
+// Pointer to the flash memory at an Fls address
+#define FEE_MEMORY(Address) ((const uint8_t*)(uintptr_t)(FLASH_BASE + (Address)))
+
+// Header of a record
+typedef struct {
+    uint16_t blockNumber;
+    uint16_t length;                        // Bytes of data, 0 for an invalidated block
+    uint16_t checksum;                      // Fletcher-16 of the data
+    uint16_t check;                         // Complement of the exclusive or of the other fields
+} Fee_RecordHeaderType;
+
+// State of a sector
+typedef enum {
+    FEE_SECTOR_ERASED,
+    FEE_SECTOR_USED,                        // Header written, holds records
+    FEE_SECTOR_DIRTY                        // No header but not erased: an erase was cut by a reset
+} Fee_SectorStateType;
+
+// Slot of the index
+typedef struct {
+    uint16_t blockNumber;                   // FEE_NO_BLOCK if free
+    uint16_t blockSize;
+    Fls_AddressType record;                 // Latest record, FEE_NO_RECORD if never written
+    Fls_LengthType recordSize;              // Bytes of the latest record in the log
+} Fee_SlotType;
+
+// Kind of a job of the user
+typedef enum {
+    FEE_JOB_NONE,
+    FEE_JOB_READ,
+    FEE_JOB_WRITE,
+    FEE_JOB_INVALIDATE
+} Fee_JobKindType;
+
+// Job of the user
+typedef struct {
+    Fee_JobKindType kind;
+    Fee_SlotType* slot;
+    uint16_t offset;                        // Of a read
+    uint16_t length;                        // Of a read
+    const uint8_t* source;                  // Data of a write
+    uint8_t* target;                        // Buffer of a read
+} Fee_JobType;
+
+// Kind of the FLS job in progress
+typedef enum {
+    FEE_FLS_NONE,
+    FEE_FLS_USER,                           // The job of the user
+    FEE_FLS_COPY,                           // A record copied by the garbage collection
+    FEE_FLS_ERASE,                          // A sector erased
+    FEE_FLS_HEADER                          // The header of a sector left without its record
+} Fee_FlsJobType;
+
+static const Fee_ConfigType* Fee_ActiveConfig;
+static MemIf_StatusType Fee_Status;
+static MemIf_JobResultType Fee_JobResult;
+static Fls_LengthType Fee_PageSize;
+static Fee_SlotType Fee_Index[FEE_INDEX_SIZE];
+
+static uint8_t Fee_SectorState[FEE_NUM_SECTORS];
+static uint32_t Fee_SectorSequence[FEE_NUM_SECTORS];
+static Fls_LengthType Fee_SectorLive[FEE_NUM_SECTORS];  // Bytes of the latest records held
+static uint8_t Fee_Head;                    // FEE_NUM_SECTORS until a sector is used
+static Fls_LengthType Fee_HeadOffset;       // First free byte of the head
+static uint8_t Fee_GcSector;                // Sector collected, FEE_NUM_SECTORS if none
+static Fls_LengthType Fee_GcOffset;         // Next record of the collected sector
+
+static Fee_JobType Fee_Job;
+static Fee_FlsJobType Fee_FlsJob;
+static Fee_SlotType* Fee_FlsSlot;           // Block of the record programmed
+static Fls_AddressType Fee_FlsRecord;       // Record programmed, FEE_NO_RECORD for a read
+static Fls_LengthType Fee_FlsRecordSize;
+static uint8_t Fee_FlsSector;               // Sector erased, or opened by the record programmed
+static uint8_t Fee_OpenedFrom;              // Head before the sector was opened
+static Fls_LengthType Fee_OpenedOffset;
+
+// Records and sector headers are programmed from here, not from the buffers of the user
+static uint32_t Fee_Buffer[(FEE_HEADER_SIZE + FEE_MAX_BLOCK_SIZE) / 4u];
+static uint32_t Fee_SectorHeader[FEE_HEADER_SIZE / 4u];
+
+/*
+* Function: Fee_Checksum
+* Description: Computes the Fletcher-16 checksum of data.
+* Input:
+*   - Data: Bytes to sum.
+*   - Length: Number of bytes.
+* Output: Checksum, never 0xFFFF.
+*/
+static uint16_t Fee_Checksum(const uint8_t* Data, uint32_t Length) {
+    uint32_t sum1 = 0, sum2 = 0;
+
+    while (Length != 0) {
+        // 359 bytes keep the sums below 2^32 before the reduction
+        uint32_t count = (Length < 359u) ? Length : 359u;
+        Length -= count;
+        while (count-- != 0) {
+            sum1 += *Data++;
+            sum2 += sum1;
+        }
+        sum1 %= 255u;
+        sum2 %= 255u;
+    }
+    return (uint16_t)((sum2 << 8) | sum1);
+}
+
+/*
+* Function: Fee_HeaderCheck
+* Description: Computes the check field of a record header.
+* Input:
+*   - Header: Header with the other fields set.
+* Output: Check field.
+*/
+static uint16_t Fee_HeaderCheck(const Fee_RecordHeaderType* Header) {
+    return (uint16_t)~(Header->blockNumber ^ Header->length ^ Header->checksum);
+}
+
+/*
+* Function: Fee_RecordSize
+* Description: Computes the bytes taken in the log by a record.
+* Input:
+*   - Length: Bytes of data.
+* Output: Header and data, padded to the page size.
+*/
+static Fls_LengthType Fee_RecordSize(Fls_LengthType Length) {
+    return FEE_HEADER_SIZE + (Length + Fee_PageSize - 1u) / Fee_PageSize * Fee_PageSize;
+}
+
+/*
+* Function: Fee_Find
+* Description: Looks a block up in the index, probing the slots after its hash.
+* Input:
+*   - BlockNumber: Block to find.
+* Output: Slot of the block, or the free slot ending the probe if the block is not configured.
+*/
+static Fee_SlotType* Fee_Find(uint16_t BlockNumber) {
+    uint32_t i = ((uint32_t)BlockNumber * 0x9E3779B1u) >> (32 - FEE_INDEX_BITS);
+
+    while (Fee_Index[i].blockNumber != BlockNumber && Fee_Index[i].blockNumber != FEE_NO_BLOCK) {
+        i = (i + 1u) & (FEE_INDEX_SIZE - 1u);
+    }
+    return &Fee_Index[i];
+}
+
+/*
+* Function: Fee_Lookup
+* Description: Returns the slot of a configured block.
+* Input:
+*   - BlockNumber: Block to find.
+* Output: Slot of the block, NULL if the block is not configured.
+*/
+static Fee_SlotType* Fee_Lookup(uint16_t BlockNumber) {
+    Fee_SlotType* slot = Fee_Find(BlockNumber);
+
+    return (slot->blockNumber == FEE_NO_BLOCK) ? NULL : slot;
+}
+
+/*
+* Function: Fee_SectorOf
+* Description: Finds the sector holding an address.
+* Input:
+*   - Address: Fls address in the log.
+* Output: Index in Fee_SectorList.
+*/
+static uint8_t Fee_SectorOf(Fls_AddressType Address) {
+    uint8_t sector = 0;
+
+    while (sector < FEE_NUM_SECTORS - 1 &&
+           Address - Fee_SectorList[sector].address >= Fee_SectorList[sector].size) {
+        sector++;
+    }
+    return sector;
+}
+
+/*
+* Function: Fee_SetRecord
+* Description: Makes a record the latest of its block, moving its bytes between the live counts of
+*   the sectors.
+* Input:
+*   - Slot: Block of the record.
+*   - Record: Address of the record, FEE_NO_RECORD to forget the block.
+*   - Size: Bytes of the record.
+* Output: None
+*/
+static void Fee_SetRecord(Fee_SlotType* Slot, Fls_AddressType Record, Fls_LengthType Size) {
+    if (Slot->record != FEE_NO_RECORD) {
+        Fee_SectorLive[Fee_SectorOf(Slot->record)] -= Slot->recordSize;
+    }
+    Slot->record = Record;
+    Slot->recordSize = Size;
+    if (Record != FEE_NO_RECORD) {
+        Fee_SectorLive[Fee_SectorOf(Record)] += Size;
+    }
+}
+
+/*
+* Function: Fee_ReadHeader
+* Description: Reads the header of the record at an offset of a sector.
+* Input:
+*   - Sector: Index in Fee_SectorList.
+*   - Offset: Offset of the record in the sector.
+*   - Header: Receives the header.
+* Output: Bytes to the next record; 0 at the free space, FEE_HEADER_SIZE for a header cut by a reset,
+*   whose data was never programmed.
+*/
+static Fls_LengthType Fee_ReadHeader(uint8_t Sector, Fls_LengthType Offset, Fee_RecordHeaderType* Header) {
+    const Fee_SectorType* sector = &Fee_SectorList[Sector];
+
+    memcpy(Header, FEE_MEMORY(sector->address + Offset), sizeof(*Header));
+    if (Header->blockNumber == FEE_NO_BLOCK && Header->length == 0xFFFFu &&
+        Header->checksum == 0xFFFFu && Header->check == 0xFFFFu) {
+        return 0;
+    }
+    if (Header->check != Fee_HeaderCheck(Header) ||
+        Header->length > sector->size - Offset - FEE_HEADER_SIZE) {
+        Header->blockNumber = FEE_NO_BLOCK;
+        return FEE_HEADER_SIZE;
+    }
+    return Fee_RecordSize(Header->length);
+}
+
+/*
+* Function: Fee_ScanSector
+* Description: Enters the valid records of a sector into the index, later records replacing earlier
+*   ones. Records of blocks not configured, or of another size, are ignored.
+* Input:
+*   - Sector: Index in Fee_SectorList.
+* Output: Offset of the free space of the sector.
+*/
+static Fls_LengthType Fee_ScanSector(uint8_t Sector) {
+    Fls_AddressType base = Fee_SectorList[Sector].address;
+    Fls_LengthType offset = FEE_HEADER_SIZE;
+
+    while (offset + FEE_HEADER_SIZE <= Fee_SectorList[Sector].size) {
+        Fee_RecordHeaderType header;
+        Fls_LengthType size = Fee_ReadHeader(Sector, offset, &header);
+        if (size == 0) {
+            break;
+        }
+        Fee_SlotType* slot = (header.blockNumber == FEE_NO_BLOCK) ? NULL : Fee_Lookup(header.blockNumber);
+        if (slot != NULL && (header.length == 0 || header.length == slot->blockSize) &&
+            (header.length == 0 || Fee_Checksum(FEE_MEMORY(base + offset + FEE_HEADER_SIZE), header.length) == header.checksum)) {
+            slot->record = base + offset;
+            slot->recordSize = size;
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+/*
+* Function: Fee_IsBlank
+* Description: Checks that a sector is erased.
+* Input:
+*   - Sector: Index in Fee_SectorList.
+* Output: 1 if all its words read 0xFFFFFFFF, 0 otherwise.
+*/
+static uint8_t Fee_IsBlank(uint8_t Sector) {
+    const uint8_t* memory = FEE_MEMORY(Fee_SectorList[Sector].address);
+
+    for (Fls_LengthType i = 0; i < Fee_SectorList[Sector].size; i += 4u) {
+        uint32_t word;
+        memcpy(&word, memory + i, 4);
+        if (word != FEE_ERASED_WORD) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+* Function: Fee_Allocate
+* Description: Reserves room for a record at the head, opening an erased sector when the head is
+*   full. While a sector is collected, the head keeps room for its latest records.
+* Input:
+*   - Size: Bytes of the record.
+*   - Freed: Bytes of the collected sector the record makes obsolete.
+* Output: Address of the record, FEE_NO_RECORD if the room is not available yet, in the log or in
+*   the queue of the FLS driver.
+*/
+static Fls_AddressType Fee_Allocate(Fls_LengthType Size, Fls_LengthType Freed) {
+    uint8_t sector;
+
+    if (Fee_Head != FEE_NUM_SECTORS) {
+        Fls_LengthType reserved = (Fee_GcSector != FEE_NUM_SECTORS) ? Fee_SectorLive[Fee_GcSector] - Freed : 0;
+        if (Fee_HeadOffset + Size + reserved <= Fee_SectorList[Fee_Head].size) {
+            if (Fls_GetFreeJobs() < 1u) {
+                return FEE_NO_RECORD;
+            }
+            Fee_FlsSector = FEE_NUM_SECTORS;
+            Fee_HeadOffset += Size;
+            return Fee_SectorList[Fee_Head].address + Fee_HeadOffset - Size;
+        }
+    }
+    // Next erased sector of the ring
+    for (sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+        uint8_t next = (Fee_Head == FEE_NUM_SECTORS) ? sector : (uint8_t)((Fee_Head + 1u + sector) % FEE_NUM_SECTORS);
+        if (Fee_SectorState[next] == FEE_SECTOR_ERASED) {
+            sector = next;
+            break;
+        }
+    }
+    // The header and the record are queued together
+    if (sector == FEE_NUM_SECTORS || Fee_GcSector != FEE_NUM_SECTORS || Fls_GetFreeJobs() < 2u) {
+        return FEE_NO_RECORD;
+    }
+    uint32_t sequence = (Fee_Head == FEE_NUM_SECTORS) ? 0 : Fee_SectorSequence[Fee_Head] + 1u;
+    Fee_SectorHeader[0] = FEE_SECTOR_MAGIC;
+    Fee_SectorHeader[1] = sequence;
+    if (Fls_Write(FLS_USER_FEE, Fee_SectorList[sector].address, (const uint8_t*)Fee_SectorHeader, FEE_HEADER_SIZE) != E_OK) {
+        return FEE_NO_RECORD;
+    }
+    Fee_OpenedFrom = Fee_Head;
+    Fee_OpenedOffset = Fee_HeadOffset;
+    Fee_FlsSector = sector;
+    Fee_SectorState[sector] = FEE_SECTOR_USED;
+    Fee_SectorSequence[sector] = sequence;
+    Fee_Head = sector;
+    Fee_HeadOffset = FEE_HEADER_SIZE + Size;
+    return Fee_SectorList[sector].address + FEE_HEADER_SIZE;
+}
+
+/*
+* Function: Fee_Program
+* Description: Queues the programming of the record staged in Fee_Buffer.
+* Input:
+*   - Slot: Block of the record.
+*   - Size: Bytes of the record.
+*   - Freed: Bytes of the collected sector the record makes obsolete.
+*   - Kind: FEE_FLS_USER or FEE_FLS_COPY.
+* Output: 1 if the record is queued, 0 if it must wait for room.
+*/
+static uint8_t Fee_Program(Fee_SlotType* Slot, Fls_LengthType Size, Fls_LengthType Freed, Fee_FlsJobType Kind) {
+    Fls_AddressType record = Fee_Allocate(Size, Freed);
+
+    if (record == FEE_NO_RECORD) {
+        return 0;
+    }
+    if (Fls_Write(FLS_USER_FEE, record, (const uint8_t*)Fee_Buffer, Size) != E_OK) {
+        // An erased gap would end the scan of the sector at the next Fee_Init
+        if (Fee_FlsSector == FEE_NUM_SECTORS) {
+            Fee_HeadOffset -= Size;
+        } else {
+            // The sector opened holds its header alone: erased again once it is programmed
+            Fee_SectorState[Fee_FlsSector] = FEE_SECTOR_DIRTY;
+            Fee_Head = Fee_OpenedFrom;
+            Fee_HeadOffset = Fee_OpenedOffset;
+            Fee_FlsJob = FEE_FLS_HEADER;
+        }
+        return 0;
+    }
+    Fee_FlsJob = Kind;
+    Fee_FlsSlot = Slot;
+    Fee_FlsRecord = record;
+    Fee_FlsRecordSize = Size;
+    return 1;
+}
+
+/*
+* Function: Fee_EndJob
+* Description: Ends the job of the user and notifies it.
+* Input:
+*   - Result: Result of the job.
+* Output: None
+*/
+static void Fee_EndJob(MemIf_JobResultType Result) {
+    void (*notification)(void) = (Result == MEMIF_JOB_OK) ? Fee_ActiveConfig->jobEndNotification :
+                                                            Fee_ActiveConfig->jobErrorNotification;
+
+    Fee_Job.kind = FEE_JOB_NONE;
+    Fee_JobResult = Result;
+    if (notification != NULL) {
+        notification();
+    }
+}
+
+/*
+* Function: Fee_StartJob
+* Description: Starts the job of the user: queues the read of its latest record, or stages and
+*   queues its new record.
+* Input: None
+* Output: 1 if the job is started or ended, 0 if it waits for room in the log.
+*/
+static uint8_t Fee_StartJob(void) {
+    Fee_SlotType* slot = Fee_Job.slot;
+
+    if (Fee_Job.kind == FEE_JOB_READ) {
+        if (slot->record == FEE_NO_RECORD || slot->recordSize == FEE_HEADER_SIZE) {
+            Fee_EndJob(MEMIF_BLOCK_INVALID);
+            return 1;
+        }
+        if (Fls_Read(FLS_USER_FEE, slot->record + FEE_HEADER_SIZE + Fee_Job.offset, Fee_Job.target, Fee_Job.length) != E_OK) {
+            return 0;
+        }
+        Fee_FlsJob = FEE_FLS_USER;
+        Fee_FlsRecord = FEE_NO_RECORD;
+        return 1;
+    }
+    Fee_RecordHeaderType* header = (Fee_RecordHeaderType*)Fee_Buffer;
+    uint16_t length = (Fee_Job.kind == FEE_JOB_WRITE) ? slot->blockSize : 0;
+    Fls_LengthType size = Fee_RecordSize(length);
+    Fls_LengthType freed = 0;
+    uint8_t* data = (uint8_t*)Fee_Buffer + FEE_HEADER_SIZE;
+
+    if (Fee_GcSector != FEE_NUM_SECTORS && slot->record != FEE_NO_RECORD && Fee_SectorOf(slot->record) == Fee_GcSector) {
+        freed = slot->recordSize;
+    }
+    memcpy(data, Fee_Job.source, length);
+    memset(data + length, 0xFF, size - FEE_HEADER_SIZE - length);
+    header->blockNumber = slot->blockNumber;
+    header->length = length;
+    header->checksum = Fee_Checksum(data, length);
+    header->check = Fee_HeaderCheck(header);
+    return Fee_Program(slot, size, freed, FEE_FLS_USER);
+}
+
+/*
+* Function: Fee_Collect
+* Description: Advances the garbage collection by one step: erases a sector left dirty by a reset,
+*   or, when no erased sector is left, examines a few records of the oldest sector and copies the
+*   first one still latest to the head, or erases the sector once all are examined.
+* Input: None
+* Output: None
+*/
+static void Fee_Collect(void) {
+    uint8_t sector;
+
+    for (sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+        if (Fee_SectorState[sector] == FEE_SECTOR_DIRTY) {
+            if (Fls_Erase(FLS_USER_FEE, Fee_SectorList[sector].address, Fee_SectorList[sector].size) == E_OK) {
+                Fee_FlsJob = FEE_FLS_ERASE;
+                Fee_FlsSector = sector;
+            }
+            return;
+        }
+    }
+    if (Fee_GcSector == FEE_NUM_SECTORS) {
+        for (sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+            if (Fee_SectorState[sector] == FEE_SECTOR_ERASED) {
+                return;
+            }
+        }
+        // Oldest sector: all but the head are used
+        for (sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+            if (sector != Fee_Head && (Fee_GcSector == FEE_NUM_SECTORS ||
+                                       Fee_SectorSequence[sector] < Fee_SectorSequence[Fee_GcSector])) {
+                Fee_GcSector = sector;
+            }
+        }
+        Fee_GcOffset = FEE_HEADER_SIZE;
+    }
+
+    const Fee_SectorType* gc = &Fee_SectorList[Fee_GcSector];
+    for (uint32_t examined = 0; examined < FEE_GC_HEADERS && Fee_GcOffset + FEE_HEADER_SIZE <= gc->size; examined++) {
+        Fee_RecordHeaderType header;
+        Fls_LengthType size = Fee_ReadHeader(Fee_GcSector, Fee_GcOffset, &header);
+        if (size == 0) {
+            Fee_GcOffset = gc->size;
+            break;
+        }
+        Fls_AddressType record = gc->address + Fee_GcOffset;
+        Fee_SlotType* slot = (header.blockNumber == FEE_NO_BLOCK) ? NULL : Fee_Lookup(header.blockNumber);
+        Fee_GcOffset += size;
+        if (slot == NULL || slot->record != record) {
+            continue;
+        }
+        if (header.length == 0) {
+            // The older records of the block are in this sector or already erased
+            Fee_SetRecord(slot, FEE_NO_RECORD, 0);
+            continue;
+        }
+        memcpy(Fee_Buffer, FEE_MEMORY(record), size);
+        if (!Fee_Program(slot, size, size, FEE_FLS_COPY)) {
+            Fee_GcOffset -= size;
+        }
+        return;
+    }
+    if (Fee_GcOffset + FEE_HEADER_SIZE > gc->size &&
+        Fls_Erase(FLS_USER_FEE, gc->address, gc->size) == E_OK) {
+        Fee_FlsJob = FEE_FLS_ERASE;
+        Fee_FlsSector = Fee_GcSector;
+    }
+}
+
+/*
+* Function: Fee_EndFlsJob
+* Description: Takes the result of the FLS job in progress once it has ended.
+* Input: None
+* Output: None
+*/
+static void Fee_EndFlsJob(void) {
+    MemIf_JobResultType result = Fls_GetJobResult(FLS_USER_FEE);
+    Fee_FlsJobType kind = Fee_FlsJob;
+
+    Fee_FlsJob = FEE_FLS_NONE;
+    if (kind == FEE_FLS_HEADER) {
+        // The sector is already dirty, whatever the result
+        return;
+    }
+    if (kind == FEE_FLS_ERASE) {
+        if (result == MEMIF_JOB_OK) {
+            // Slots still pointing into the sector would read erased flash
+            for (uint32_t i = 0; i < FEE_INDEX_SIZE; i++) {
+                if (Fee_Index[i].record != FEE_NO_RECORD && Fee_SectorOf(Fee_Index[i].record) == Fee_FlsSector) {
+                    Fee_SetRecord(&Fee_Index[i], FEE_NO_RECORD, 0);
+                }
+            }
+            Fee_SectorState[Fee_FlsSector] = FEE_SECTOR_ERASED;
+            Fee_SectorSequence[Fee_FlsSector] = FEE_ERASED_WORD;
+            if (Fee_GcSector == Fee_FlsSector) {
+                Fee_GcSector = FEE_NUM_SECTORS;
+            }
+        } else {
+            Fee_SectorState[Fee_FlsSector] = FEE_SECTOR_DIRTY;
+        }
+        return;
+    }
+    if (Fee_FlsRecord != FEE_NO_RECORD) {
+        if (result == MEMIF_JOB_OK) {
+            Fee_SetRecord(Fee_FlsSlot, Fee_FlsRecord, Fee_FlsRecordSize);
+        } else if (kind == FEE_FLS_COPY && Fee_GcSector != FEE_NUM_SECTORS) {
+            // Examine the sector again: the records already copied are no longer the latest
+            Fee_GcOffset = FEE_HEADER_SIZE;
+        }
+        if (result != MEMIF_JOB_OK && Fee_FlsSector != FEE_NUM_SECTORS) {
+            // The sector opened for the record may lack its header
+            Fee_SectorState[Fee_FlsSector] = FEE_SECTOR_DIRTY;
+            Fee_Head = Fee_OpenedFrom;
+            Fee_HeadOffset = Fee_OpenedOffset;
+        }
+    }
+    if (kind == FEE_FLS_USER) {
+        Fee_EndJob((result == MEMIF_JOB_OK) ? MEMIF_JOB_OK : MEMIF_JOB_FAILED);
+    }
+}
+
+/*
+* Function: Fee_Init
+* Description: Builds the index of the blocks and scans the log once, from the oldest sector, to
+*   find the latest record of each block. The FLS driver must be initialized and idle.
+* Input:
+*   - ConfigPtr: Configuration, NULL for Fee_Config.
+* Output: None
+*/
+void Fee_Init(const Fee_ConfigType* ConfigPtr) {
+    uint8_t order[FEE_NUM_SECTORS];
+    uint8_t used = 0;
+    Fls_LengthType total = 0;
+
+    Fee_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Fee_Config;
+    Fee_Status = MEMIF_UNINIT;
+    Fee_PageSize = Fls_GetPageSize();
+    if (Fls_GetStatus() != MEMIF_IDLE || Fee_ActiveConfig->numBlocks > FEE_INDEX_SIZE / 2u) {
+        return;
+    }
+
+    // Index of the configured blocks
+    memset(Fee_Index, 0xFF, sizeof(Fee_Index));
+    for (uint16_t i = 0; i < FEE_INDEX_SIZE; i++) {
+        Fee_Index[i].record = FEE_NO_RECORD;
+        Fee_Index[i].recordSize = 0;
+    }
+    for (uint16_t i = 0; i < Fee_ActiveConfig->numBlocks; i++) {
+        const Fee_BlockType* block = &Fee_ActiveConfig->blocks[i];
+        Fee_SlotType* slot = Fee_Find(block->blockNumber);
+        if (block->blockNumber == FEE_NO_BLOCK || slot->blockNumber != FEE_NO_BLOCK ||
+            block->blockSize == 0 || block->blockSize > FEE_MAX_BLOCK_SIZE) {
+            return;
+        }
+        slot->blockNumber = block->blockNumber;
+        slot->blockSize = block->blockSize;
+        total += Fee_RecordSize(block->blockSize);
+    }
+
+    // State of the sectors, the used ones in order of sequence
+    for (uint8_t sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+        uint32_t header[FEE_HEADER_SIZE / 4u];
+        // A collection copies the latest records of a sector to the head
+        if (total > Fee_SectorList[sector].size - FEE_HEADER_SIZE) {
+            return;
+        }
+        memcpy(header, FEE_MEMORY(Fee_SectorList[sector].address), FEE_HEADER_SIZE);
+        Fee_SectorLive[sector] = 0;
+        Fee_SectorSequence[sector] = FEE_ERASED_WORD;
+        if (header[0] == FEE_SECTOR_MAGIC && header[1] != FEE_ERASED_WORD) {
+            uint8_t i = used++;
+            Fee_SectorState[sector] = FEE_SECTOR_USED;
+            Fee_SectorSequence[sector] = header[1];
+            while (i > 0 && Fee_SectorSequence[order[i - 1u]] > header[1]) {
+                order[i] = order[i - 1u];
+                i--;
+            }
+            order[i] = sector;
+        } else {
+            Fee_SectorState[sector] = Fee_IsBlank(sector) ? FEE_SECTOR_ERASED : FEE_SECTOR_DIRTY;
+        }
+    }
+    Fee_Head = FEE_NUM_SECTORS;
+    Fee_HeadOffset = 0;
+    for (uint8_t i = 0; i < used; i++) {
+        Fee_Head = order[i];
+        Fee_HeadOffset = Fee_ScanSector(order[i]);
+    }
+    for (uint16_t i = 0; i < FEE_INDEX_SIZE; i++) {
+        if (Fee_Index[i].record != FEE_NO_RECORD) {
+            Fee_SectorLive[Fee_SectorOf(Fee_Index[i].record)] += Fee_Index[i].recordSize;
+        }
+    }
+
+    Fee_GcSector = FEE_NUM_SECTORS;
+    Fee_Job.kind = FEE_JOB_NONE;
+    Fee_FlsJob = FEE_FLS_NONE;
+    Fee_JobResult = MEMIF_JOB_OK;
+    Fee_Status = MEMIF_IDLE;
+}
+
+/*
+* Function: Fee_Read
+* Description: Accepts the read of a part of a block, from its latest record.
+* Input:
+*   - BlockNumber: Block to read.
+*   - BlockOffset: First byte of the block to read.
+*   - DataBufferPtr: Buffer receiving the data.
+*   - Length: Bytes to read.
+* Output: E_OK if the job is accepted, E_NOT_OK if a job is pending or an argument is wrong.
+*/
+Std_ReturnType Fee_Read(uint16_t BlockNumber, uint16_t BlockOffset, uint8_t* DataBufferPtr, uint16_t Length) {
+    if (Fee_Status == MEMIF_UNINIT || Fee_Job.kind != FEE_JOB_NONE) {
+        return E_NOT_OK;
+    }
+    Fee_SlotType* slot = Fee_Lookup(BlockNumber);
+    if (slot == NULL || DataBufferPtr == NULL || Length == 0 || (uint32_t)BlockOffset + Length > slot->blockSize) {
+        return E_NOT_OK;
+    }
+    Fee_Job = (Fee_JobType){ FEE_JOB_READ, slot, BlockOffset, Length, NULL, DataBufferPtr };
+    Fee_JobResult = MEMIF_JOB_PENDING;
+    return E_OK;
+}
+
+/*
+* Function: Fee_Write
+* Description: Accepts the write of a whole block. The data must stay unchanged until the job starts.
+* Input:
+*   - BlockNumber: Block to write.
+*   - DataBufferPtr: Data of the block.
+* Output: E_OK if the job is accepted, E_NOT_OK if a job is pending or an argument is wrong.
+*/
+Std_ReturnType Fee_Write(uint16_t BlockNumber, const uint8_t* DataBufferPtr) {
+    if (Fee_Status == MEMIF_UNINIT || Fee_Job.kind != FEE_JOB_NONE) {
+        return E_NOT_OK;
+    }
+    Fee_SlotType* slot = Fee_Lookup(BlockNumber);
+    if (slot == NULL || DataBufferPtr == NULL) {
+        return E_NOT_OK;
+    }
+    Fee_Job = (Fee_JobType){ FEE_JOB_WRITE, slot, 0, 0, DataBufferPtr, NULL };
+    Fee_JobResult = MEMIF_JOB_PENDING;
+    return E_OK;
+}
+
+/*
+* Function: Fee_InvalidateBlock
+* Description: Accepts the invalidation of a block: its reads end with MEMIF_BLOCK_INVALID until it
+*   is written again.
+* Input:
+*   - BlockNumber: Block to invalidate.
+* Output: E_OK if the job is accepted, E_NOT_OK if a job is pending or the block is not configured.
+*/
+Std_ReturnType Fee_InvalidateBlock(uint16_t BlockNumber) {
+    if (Fee_Status == MEMIF_UNINIT || Fee_Job.kind != FEE_JOB_NONE) {
+        return E_NOT_OK;
+    }
+    Fee_SlotType* slot = Fee_Lookup(BlockNumber);
+    if (slot == NULL) {
+        return E_NOT_OK;
+    }
+    Fee_Job = (Fee_JobType){ FEE_JOB_INVALIDATE, slot, 0, 0, NULL, NULL };
+    Fee_JobResult = MEMIF_JOB_PENDING;
+    return E_OK;
+}
+
+/*
+* Function: Fee_Cancel
+* Description: Drops the job of the user. A record already queued is still programmed and becomes the
+*   latest of its block; a read already queued is dropped.
+* Input: None
+* Output: None
+*/
+void Fee_Cancel(void) {
+    if (Fee_Status == MEMIF_UNINIT || Fee_Job.kind == FEE_JOB_NONE) {
+        return;
+    }
+    if (Fee_FlsJob == FEE_FLS_USER) {
+        if (Fee_FlsRecord != FEE_NO_RECORD) {
+            Fee_FlsJob = FEE_FLS_COPY;
+        } else {
+            Fls_Cancel(FLS_USER_FEE);
+            Fee_FlsJob = FEE_FLS_NONE;
+        }
+    }
+    Fee_Job.kind = FEE_JOB_NONE;
+    Fee_JobResult = MEMIF_JOB_CANCELED;
+}
+
+/*
+* Function: Fee_GetStatus
+* Description: Returns the state of the module.
+* Input: None
+* Output: MEMIF_BUSY while a job of the user is pending, MEMIF_BUSY_INTERNAL while a sector is
+*   collected or erased, MEMIF_IDLE or MEMIF_UNINIT otherwise.
+*/
+MemIf_StatusType Fee_GetStatus(void) {
+    if (Fee_Status == MEMIF_UNINIT) {
+        return MEMIF_UNINIT;
+    }
+    if (Fee_Job.kind != FEE_JOB_NONE) {
+        return MEMIF_BUSY;
+    }
+    if (Fee_FlsJob != FEE_FLS_NONE || Fee_GcSector != FEE_NUM_SECTORS) {
+        return MEMIF_BUSY_INTERNAL;
+    }
+    for (uint8_t sector = 0; sector < FEE_NUM_SECTORS; sector++) {
+        if (Fee_SectorState[sector] == FEE_SECTOR_DIRTY) {
+            return MEMIF_BUSY_INTERNAL;
+        }
+    }
+    return MEMIF_IDLE;
+}
+
+/*
+* Function: Fee_GetJobResult
+* Description: Returns the result of the last job of the user.
+* Input: None
+* Output: MEMIF_JOB_PENDING while it is pending, then its result.
+*/
+MemIf_JobResultType Fee_GetJobResult(void) {
+    return Fee_JobResult;
+}
+
+/*
+* Function: Fee_MainFunction
+* Description: Takes the result of the FLS job once it has ended, then starts the job of the
+*   user, or a step of the garbage collection when there is none or it waits for room. Called after
+*   Fls_MainFunction.
+* Input: None
+* Output: None
+*/
+void Fee_MainFunction(void) {
+    // Jobs of other users of the driver do not hold the module
+    if (Fee_Status == MEMIF_UNINIT || Fls_GetPendingJobs(FLS_USER_FEE) != 0) {
+        return;
+    }
+    if (Fee_FlsJob != FEE_FLS_NONE) {
+        Fee_EndFlsJob();
+    }
+    if (Fee_Job.kind != FEE_JOB_NONE && Fee_StartJob()) {
+        return;
+    }
+    if (Fee_FlsJob == FEE_FLS_NONE) {
+        Fee_Collect();
+    }
+}
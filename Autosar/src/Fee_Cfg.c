@@ -0,0 +1,26 @@
+/*
+* File: Fee_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Sectors and blocks of the FEE module.
+*/
+
+#include "Fee.h"
+
+const Fee_SectorType Fee_SectorList[FEE_NUM_SECTORS] = {
+    /* address, size */
+    { 0x40000u, 0x20000u },
+    { 0x60000u, 0x20000u },
+};
+
+// Blocks of NvM_BlockDescriptor: the data rounded up to words, then the CRC
+const Fee_BlockType Fee_BlockList[FEE_NUM_BLOCKS] = {
+    /* blockNumber, blockSize */
+    { FEE_BLOCK_BOOT_COUNT, 8u },
+    { FEE_BLOCK_CALIBRATION, 68u },
+    { FEE_BLOCK_DTC, 132u },
+};
+
+const Fee_ConfigType Fee_Config = {
+    Fee_BlockList, FEE_NUM_BLOCKS, FeeJob_EndNotification, FeeJob_ErrorNotification
+};
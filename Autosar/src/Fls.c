@@ -0,0 +1,584 @@
+/*
+* File: Fls.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Fls.h containing the implementation of the FLS driver. The library
+* functions FLASH_EraseSector and FLASH_ProgramWord poll the flash until the end of the operation;
+* here each operation is started by writing FLASH_CR and the memory directly, and the next one is
+* started when the flash reports the end of the previous one: from the end-of-operation interrupt,
+* or from Fls_MainFunction, which never waits for an erase. Units left erased in the data of a
+* write are not programmed.
+*/
+
+#include "Fls.h"
+#include "SchM.h"
+#include <string.h>
+
+// Error flags of FLASH_SR
+#define FLS_FLASH_ERRORS (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+// Pointer to the flash memory at an Fls address
+#define FLS_MEMORY(Address) ((uintptr_t)(FLASH_BASE + (Address)))
+
+// Largest program unit, a double word
+#define FLS_MAX_PAGE_SIZE 8u
+
+// Kind of a job
+typedef enum {
+    FLS_JOB_ERASE,
+    FLS_JOB_WRITE,
+    FLS_JOB_READ,
+    FLS_JOB_COMPARE
+} Fls_JobKindType;
+
+// Job of the queue
+typedef struct {
+    Fls_JobKindType kind;
+    Fls_UserType user;
+    Fls_AddressType address;
+    Fls_LengthType length;
+    const uint8_t* source;                  // Data of a write or a compare
+    uint8_t* target;                        // Buffer of a read
+} Fls_JobType;
+
+static const Fls_ConfigType* Fls_ActiveConfig;
+static MemIf_StatusType Fls_Status;
+static volatile MemIf_JobResultType Fls_JobResult[FLS_NUM_USERS];
+static uint32_t Fls_PageSize;               // Bytes of a program unit
+static uint32_t Fls_ControlBits;            // PSIZE and interrupt enables of FLASH_CR
+static uint32_t Fls_ControlValue;           // Last value written to FLASH_CR
+static uint8_t Fls_Unlocked;
+
+// Jobs in order; the job at Fls_QueueHead is in progress
+static Fls_JobType Fls_Queue[FLS_JOB_QUEUE_SIZE];
+static uint8_t Fls_QueueHead;
+static volatile uint8_t Fls_QueueCount;
+static uint8_t Fls_UserJobs[FLS_NUM_USERS]; // Jobs of each user in the queue
+static volatile Fls_LengthType Fls_Done;    // Bytes of the job in progress started or copied
+static volatile uint8_t Fls_Operation;      // An erase or program operation is in progress
+static volatile MemIf_JobResultType Fls_Failure;    // MEMIF_JOB_OK, or the result of a failed job
+
+/*
+* Function: Fls_SectorOf
+* Description: Finds the configured sector holding an address.
+* Input:
+*   - Address: Offset from FLASH_BASE.
+* Output: Index in Fls_SectorList, FLS_NUM_SECTORS if the address is in no configured sector.
+*/
+static uint32_t Fls_SectorOf(Fls_AddressType Address) {
+    for (uint32_t i = 0; i < FLS_NUM_SECTORS; i++) {
+        if (Address >= Fls_SectorList[i].address && Address - Fls_SectorList[i].address < Fls_SectorList[i].size) {
+            return i;
+        }
+    }
+    return FLS_NUM_SECTORS;
+}
+
+/*
+* Function: Fls_InRange
+* Description: Checks that a range is not empty and lies in configured sectors.
+* Input:
+*   - Address: Start of the range.
+*   - Length: Bytes of the range.
+* Output: 1 if it does, 0 otherwise.
+*/
+static uint8_t Fls_InRange(Fls_AddressType Address, Fls_LengthType Length) {
+    Fls_AddressType end = Address + Length;
+
+    if (Length == 0 || end < Address) {
+        return 0;
+    }
+    while (Address < end) {
+        uint32_t sector = Fls_SectorOf(Address);
+        if (sector == FLS_NUM_SECTORS) {
+            return 0;
+        }
+        Address = Fls_SectorList[sector].address + Fls_SectorList[sector].size;
+    }
+    return 1;
+}
+
+/*
+* Function: Fls_Enqueue
+* Description: Adds a job at the end of the queue.
+* Input:
+*   - Job: Job to add.
+* Output: E_OK if the job is queued, E_NOT_OK if the driver is not initialized or the queue is full.
+*/
+static Std_ReturnType Fls_Enqueue(const Fls_JobType* Job) {
+    SchM_StateType state;
+    Std_ReturnType result = E_NOT_OK;
+
+    if (Job->user >= FLS_NUM_USERS) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Fls_Status != MEMIF_UNINIT && Fls_QueueCount < FLS_JOB_QUEUE_SIZE) {
+        Fls_Queue[(Fls_QueueHead + Fls_QueueCount) % FLS_JOB_QUEUE_SIZE] = *Job;
+        Fls_QueueCount++;
+        Fls_UserJobs[Job->user]++;
+        Fls_JobResult[Job->user] = MEMIF_JOB_PENDING;
+        Fls_Status = MEMIF_BUSY;
+        result = E_OK;
+    }
+    SchM_Exit(state);
+    return result;
+}
+
+/*
+* Function: Fls_Drop
+* Description: Removes the jobs of a user from the queue, keeping the others in order. An operation
+*   of the job in progress runs to its end, and the next job waits for it. Called with interrupts
+*   masked.
+* Input:
+*   - User: User whose jobs are dropped.
+* Output: None
+*/
+static void Fls_Drop(Fls_UserType User) {
+    uint8_t kept = 0;
+
+    if (Fls_QueueCount != 0 && Fls_Queue[Fls_QueueHead].user == User) {
+        Fls_Done = 0;
+        Fls_Failure = MEMIF_JOB_OK;
+    }
+    for (uint8_t i = 0; i < Fls_QueueCount; i++) {
+        const Fls_JobType* job = &Fls_Queue[(Fls_QueueHead + i) % FLS_JOB_QUEUE_SIZE];
+        if (job->user != User) {
+            Fls_Queue[(Fls_QueueHead + kept) % FLS_JOB_QUEUE_SIZE] = *job;
+            kept++;
+        }
+    }
+    Fls_QueueCount = kept;
+    Fls_UserJobs[User] = 0;
+    if (kept == 0) {
+        Fls_Status = MEMIF_IDLE;
+    }
+}
+
+/*
+* Function: Fls_SetControl
+* Description: Writes FLASH_CR, unlocking it first, unless it already holds the value.
+* Input:
+*   - Value: Value of FLASH_CR.
+* Output: None
+*/
+static void Fls_SetControl(uint32_t Value) {
+    if (!Fls_Unlocked) {
+        FLASH_Unlock();
+        Fls_Unlocked = 1;
+    }
+    if (Value != Fls_ControlValue) {
+        WRITE_REG(FLASH->CR, Value);
+        Fls_ControlValue = Value;
+    }
+}
+
+/*
+* Function: Fls_Blank
+* Description: Checks whether a program unit of data is all 0xFF, which programming leaves as is.
+* Input:
+*   - Data: Unit of Fls_PageSize bytes.
+* Output: 1 if it is, 0 otherwise.
+*/
+static uint8_t Fls_Blank(const uint8_t* Data) {
+    uint32_t words[FLS_MAX_PAGE_SIZE / 4u];
+
+    memcpy(words, Data, Fls_PageSize);
+    return (words[0] & ((Fls_PageSize == 8u) ? words[1] : 0xFFFFFFFFu)) == 0xFFFFFFFFu;
+}
+
+/*
+* Function: Fls_StartOperation
+* Description: Starts the next operation of the job in progress: the erase of its next sector,
+*   or the programming of its next unit that is not left erased. Called with interrupts masked or
+*   from the flash interrupt, while no operation is in progress.
+* Input:
+*   - Job: Job in progress.
+* Output: 1 if an operation was started, 0 if the job has none left.
+*/
+static uint8_t Fls_StartOperation(const Fls_JobType* Job) {
+    if (Job->kind == FLS_JOB_ERASE) {
+        if (Fls_Done >= Job->length) {
+            return 0;
+        }
+        const Fls_SectorType* sector = &Fls_SectorList[Fls_SectorOf(Job->address + Fls_Done)];
+        Fls_SetControl(Fls_ControlBits | FLASH_CR_SER | sector->flashSector);
+        WRITE_REG(FLASH->CR, Fls_ControlValue | FLASH_CR_STRT);
+        Fls_Done += sector->size;
+        Fls_Operation = 1;
+        return 1;
+    }
+    if (Job->kind != FLS_JOB_WRITE) {
+        return 0;
+    }
+    while (Fls_Done < Job->length) {
+        const uint8_t* data = Job->source + Fls_Done;
+        volatile uint32_t* target = (volatile uint32_t*)FLS_MEMORY(Job->address + Fls_Done);
+        Fls_Done += Fls_PageSize;
+        if (!Fls_Blank(data)) {
+            uint32_t words[FLS_MAX_PAGE_SIZE / 4u];
+            memcpy(words, data, Fls_PageSize);
+            Fls_SetControl(Fls_ControlBits | FLASH_CR_PG);
+            // A double word is written as two words, the second one starting the operation
+            WRITE_REG(target[0], words[0]);
+            if (Fls_PageSize == 8u) {
+                WRITE_REG(target[1], words[1]);
+            }
+            Fls_Operation = 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+* Function: Fls_CheckOperation
+* Description: Ends the operation in progress once the flash is no longer busy, recording its
+*   errors. Called with interrupts masked or from the flash interrupt.
+* Input: None
+* Output: None
+*/
+static void Fls_CheckOperation(void) {
+    uint32_t status = READ_REG(FLASH->SR);
+
+    if (status & FLASH_FLAG_BSY) {
+        return;
+    }
+    if (status & (FLASH_FLAG_EOP | FLS_FLASH_ERRORS)) {
+        WRITE_REG(FLASH->SR, status & (FLASH_FLAG_EOP | FLS_FLASH_ERRORS));
+    }
+    if (status & FLS_FLASH_ERRORS) {
+        Fls_Failure = MEMIF_JOB_FAILED;
+    }
+    Fls_Operation = 0;
+}
+
+/*
+* Function: Fls_WriteBurst
+* Description: Programs up to maxWrite bytes of the job in progress, waiting for each unit, when
+*   the end-of-operation interrupt is not used.
+* Input:
+*   - Job: Write job in progress.
+* Output: None
+*/
+static void Fls_WriteBurst(const Fls_JobType* Job) {
+    Fls_LengthType end = Fls_Done + Fls_ActiveConfig->maxWrite;
+
+    while (Fls_Failure == MEMIF_JOB_OK && Fls_Done < end && Fls_StartOperation(Job)) {
+        while (Fls_Operation) {
+            Fls_CheckOperation();
+        }
+    }
+}
+
+/*
+* Function: Fls_Copy
+* Description: Reads or compares up to maxRead bytes of the job in progress.
+* Input:
+*   - Job: Read or compare job in progress.
+* Output: None
+*/
+static void Fls_Copy(const Fls_JobType* Job) {
+    Fls_LengthType count = Job->length - Fls_Done;
+    const uint8_t* flash = (const uint8_t*)FLS_MEMORY(Job->address + Fls_Done);
+
+    if (count > Fls_ActiveConfig->maxRead) {
+        count = Fls_ActiveConfig->maxRead;
+    }
+    if (Job->kind == FLS_JOB_READ) {
+        memcpy(Job->target + Fls_Done, flash, count);
+    } else if (memcmp(Job->source + Fls_Done, flash, count) != 0) {
+        Fls_Failure = MEMIF_BLOCK_INCONSISTENT;
+    }
+    Fls_Done += count;
+}
+
+/*
+* Function: Fls_Init
+* Description: Initializes the driver with an empty queue. The flash stays locked while no job
+*   is pending.
+* Input:
+*   - ConfigPtr: Configuration, NULL for Fls_Config.
+* Output: None
+*/
+void Fls_Init(const Fls_ConfigType* ConfigPtr) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    Fls_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Fls_Config;
+    Fls_Status = MEMIF_UNINIT;
+    // Bytes and half words would need byte and half word stores: below 2.7 V the driver stays
+    // uninitialized
+    if (Fls_ActiveConfig->voltageRange == VoltageRange_4) {
+        Fls_PageSize = 8u;
+        Fls_ControlBits = FLASH_PSIZE_DOUBLE_WORD;
+    } else if (Fls_ActiveConfig->voltageRange == VoltageRange_3) {
+        Fls_PageSize = 4u;
+        Fls_ControlBits = FLASH_PSIZE_WORD;
+    } else {
+        return;
+    }
+    if (Fls_ActiveConfig->useInterrupt) {
+        Fls_ControlBits |= FLASH_IT_EOP | FLASH_IT_ERR;
+    }
+    Fls_ControlValue = 0;
+    Fls_Unlocked = 0;
+    Fls_QueueHead = 0;
+    Fls_QueueCount = 0;
+    Fls_Done = 0;
+    Fls_Operation = 0;
+    Fls_Failure = MEMIF_JOB_OK;
+    for (uint8_t i = 0; i < FLS_NUM_USERS; i++) {
+        Fls_UserJobs[i] = 0;
+        Fls_JobResult[i] = MEMIF_JOB_OK;
+    }
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLS_FLASH_ERRORS);
+
+    NVIC_InitStruct.NVIC_IRQChannel = FLASH_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = Fls_ActiveConfig->useInterrupt ? ENABLE : DISABLE;
+    NVIC_Init(&NVIC_InitStruct);
+    Fls_Status = MEMIF_IDLE;
+}
+
+/*
+* Function: Fls_Erase
+* Description: Queues the erase of whole sectors.
+* Input:
+*   - User: User of the job.
+*   - TargetAddress: Start of the first sector.
+*   - Length: Bytes to erase, up to the end of a sector.
+* Output: E_OK if the job is queued, E_NOT_OK otherwise.
+*/
+Std_ReturnType Fls_Erase(Fls_UserType User, Fls_AddressType TargetAddress, Fls_LengthType Length) {
+    Fls_JobType job = { FLS_JOB_ERASE, User, TargetAddress, Length, NULL, NULL };
+
+    if (!Fls_InRange(TargetAddress, Length) ||
+        Fls_SectorList[Fls_SectorOf(TargetAddress)].address != TargetAddress) {
+        return E_NOT_OK;
+    }
+    const Fls_SectorType* last = &Fls_SectorList[Fls_SectorOf(TargetAddress + Length - 1u)];
+    if (last->address + last->size != TargetAddress + Length) {
+        return E_NOT_OK;
+    }
+    return Fls_Enqueue(&job);
+}
+
+/*
+* Function: Fls_Write
+* Description: Queues the programming of erased flash. The data must stay unchanged until the end
+*   of the job.
+* Input:
+*   - User: User of the job.
+*   - TargetAddress: Start of the range, aligned to the page size.
+*   - SourceAddressPtr: Data to program.
+*   - Length: Bytes to program, a multiple of the page size.
+* Output: E_OK if the job is queued, E_NOT_OK otherwise.
+*/
+Std_ReturnType Fls_Write(Fls_UserType User, Fls_AddressType TargetAddress, const uint8_t* SourceAddressPtr,
+                         Fls_LengthType Length) {
+    Fls_JobType job = { FLS_JOB_WRITE, User, TargetAddress, Length, SourceAddressPtr, NULL };
+
+    if (Fls_Status == MEMIF_UNINIT || SourceAddressPtr == NULL || !Fls_InRange(TargetAddress, Length) ||
+        TargetAddress % Fls_PageSize != 0 || Length % Fls_PageSize != 0) {
+        return E_NOT_OK;
+    }
+    return Fls_Enqueue(&job);
+}
+
+/*
+* Function: Fls_Read
+* Description: Queues a copy of flash into a buffer, made once the jobs before it have ended.
+* Input:
+*   - User: User of the job.
+*   - SourceAddress: Start of the range.
+*   - TargetAddressPtr: Buffer receiving the data.
+*   - Length: Bytes to read.
+* Output: E_OK if the job is queued, E_NOT_OK otherwise.
+*/
+Std_ReturnType Fls_Read(Fls_UserType User, Fls_AddressType SourceAddress, uint8_t* TargetAddressPtr,
+                        Fls_LengthType Length) {
+    Fls_JobType job = { FLS_JOB_READ, User, SourceAddress, Length, NULL, TargetAddressPtr };
+
+    if (TargetAddressPtr == NULL || !Fls_InRange(SourceAddress, Length)) {
+        return E_NOT_OK;
+    }
+    return Fls_Enqueue(&job);
+}
+
+/*
+* Function: Fls_Compare
+* Description: Queues a comparison of flash with a buffer; a difference ends the job with
+*   MEMIF_BLOCK_INCONSISTENT.
+* Input:
+*   - User: User of the job.
+*   - SourceAddress: Start of the range.
+*   - TargetAddressPtr: Data expected.
+*   - Length: Bytes to compare.
+* Output: E_OK if the job is queued, E_NOT_OK otherwise.
+*/
+Std_ReturnType Fls_Compare(Fls_UserType User, Fls_AddressType SourceAddress, const uint8_t* TargetAddressPtr,
+                           Fls_LengthType Length) {
+    Fls_JobType job = { FLS_JOB_COMPARE, User, SourceAddress, Length, TargetAddressPtr, NULL };
+
+    if (TargetAddressPtr == NULL || !Fls_InRange(SourceAddress, Length)) {
+        return E_NOT_OK;
+    }
+    return Fls_Enqueue(&job);
+}
+
+/*
+* Function: Fls_Cancel
+* Description: Drops the pending jobs of a user. An operation already started runs to its end, and
+*   the next job waits for it.
+* Input:
+*   - User: User whose jobs are dropped.
+* Output: None
+*/
+void Fls_Cancel(Fls_UserType User) {
+    SchM_StateType state;
+
+    if (User >= FLS_NUM_USERS) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Fls_UserJobs[User] != 0) {
+        Fls_Drop(User);
+        Fls_JobResult[User] = MEMIF_JOB_CANCELED;
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Fls_GetStatus
+* Description: Returns the state of the driver.
+* Input: None
+* Output: MEMIF_UNINIT, MEMIF_IDLE, or MEMIF_BUSY while jobs of any user are pending.
+*/
+MemIf_StatusType Fls_GetStatus(void) {
+    return Fls_Status;
+}
+
+/*
+* Function: Fls_GetJobResult
+* Description: Returns the result of the jobs of a user.
+* Input:
+*   - User: User of the jobs.
+* Output: MEMIF_JOB_PENDING while jobs of the user are pending, then MEMIF_JOB_OK, or the result of
+*   the job that failed or MEMIF_JOB_CANCELED; the jobs of the user queued after a failed one are
+*   dropped, those of other users are not.
+*/
+MemIf_JobResultType Fls_GetJobResult(Fls_UserType User) {
+    return (User < FLS_NUM_USERS) ? Fls_JobResult[User] : MEMIF_JOB_FAILED;
+}
+
+/*
+* Function: Fls_GetPendingJobs
+* Description: Returns the jobs of a user queued and not yet ended, the one in progress included.
+*   Jobs end in the order they were queued, so a user knows which of its jobs have ended without a
+*   notification.
+* Input:
+*   - User: User of the jobs.
+* Output: Number of jobs, 0 once none of the user is queued.
+*/
+uint8_t Fls_GetPendingJobs(Fls_UserType User) {
+    return (User < FLS_NUM_USERS) ? Fls_UserJobs[User] : 0;
+}
+
+/*
+* Function: Fls_GetFreeJobs
+* Description: Returns the room left in the queue, shared by all users. A user queueing jobs that
+*   depend on each other checks it first, so that none of them is queued alone.
+* Input: None
+* Output: Number of jobs that can still be queued.
+*/
+uint8_t Fls_GetFreeJobs(void) {
+    return (uint8_t)(FLS_JOB_QUEUE_SIZE - Fls_QueueCount);
+}
+
+/*
+* Function: Fls_GetPageSize
+* Description: Returns the program unit, to which writes are aligned.
+* Input: None
+* Output: 4 bytes at x32, 8 bytes at x64.
+*/
+Fls_LengthType Fls_GetPageSize(void) {
+    return Fls_PageSize;
+}
+
+/*
+* Function: Fls_MainFunction
+* Description: Advances the job in progress: starts its next operation once the flash is free,
+*   programs a burst of a write when the interrupt is not used, copies or compares a part of a
+*   read or compare. Ends the job when it is complete and notifies the application with its user;
+*   a failed job drops the other jobs of its user. The flash is locked again once the queue is empty.
+* Input: None
+* Output: None
+*/
+void Fls_MainFunction(void) {
+    SchM_StateType state;
+    void (*notification)(Fls_UserType User) = NULL;
+    Fls_UserType user = 0;
+
+    if (Fls_Status == MEMIF_UNINIT) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Fls_Operation && !Fls_ActiveConfig->useInterrupt) {
+        Fls_CheckOperation();
+    }
+    if (Fls_QueueCount != 0 && !Fls_Operation) {
+        const Fls_JobType* job = &Fls_Queue[Fls_QueueHead];
+        user = job->user;
+        if (Fls_Failure == MEMIF_JOB_OK) {
+            if (job->kind == FLS_JOB_READ || job->kind == FLS_JOB_COMPARE) {
+                Fls_Copy(job);
+            } else if (job->kind == FLS_JOB_WRITE && !Fls_ActiveConfig->useInterrupt) {
+                Fls_WriteBurst(job);
+            } else {
+                Fls_StartOperation(job);
+            }
+        }
+        if (Fls_Failure != MEMIF_JOB_OK) {
+            // The jobs of the user after a failed one may depend on it
+            MemIf_JobResultType result = Fls_Failure;
+            Fls_Drop(user);
+            Fls_JobResult[user] = result;
+            notification = Fls_ActiveConfig->jobErrorNotification;
+        } else if (!Fls_Operation && Fls_Done >= job->length) {
+            Fls_QueueHead = (Fls_QueueHead + 1u) % FLS_JOB_QUEUE_SIZE;
+            Fls_QueueCount--;
+            Fls_Done = 0;
+            if (--Fls_UserJobs[user] == 0) {
+                Fls_JobResult[user] = MEMIF_JOB_OK;
+            }
+            if (Fls_QueueCount == 0) {
+                Fls_Status = MEMIF_IDLE;
+            }
+            notification = Fls_ActiveConfig->jobEndNotification;
+        }
+    }
+    if (Fls_QueueCount == 0 && !Fls_Operation && Fls_Unlocked) {
+        FLASH_Lock();
+        Fls_Unlocked = 0;
+    }
+    SchM_Exit(state);
+
+    if (notification != NULL) {
+        notification(user);
+    }
+}
+
+/*
+* Function: FLASH_IRQHandler
+* Description: End of an operation, or an error: starts the next operation of the job in
+*   progress. The end of the job is left to Fls_MainFunction.
+* Input: None
+* Output: None
+*/
+void FLASH_IRQHandler(void) {
+    Fls_CheckOperation();
+    if (!Fls_Operation && Fls_QueueCount != 0 && Fls_Failure == MEMIF_JOB_OK) {
+        Fls_StartOperation(&Fls_Queue[Fls_QueueHead]);
+    }
+}
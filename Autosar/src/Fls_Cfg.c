@@ -0,0 +1,20 @@
+/*
+* File: Fls_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Sectors and settings of the FLS driver.
+*/
+
+#include "Fls.h"
+
+const Fls_SectorType Fls_SectorList[FLS_NUM_SECTORS] = {
+    /* flashSector, address, size */
+    { FLASH_Sector_5, 0x20000u, 0x20000u },
+    { FLASH_Sector_6, 0x40000u, 0x20000u },
+    { FLASH_Sector_7, 0x60000u, 0x20000u },
+};
+
+const Fls_ConfigType Fls_Config = {
+    FLS_VOLTAGE_RANGE, FLS_USE_INTERRUPT, FLS_MAX_READ, FLS_MAX_WRITE,
+    FlsJob_EndNotification, FlsJob_ErrorNotification
+};
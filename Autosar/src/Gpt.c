@@ -0,0 +1,644 @@
+/*
+* File: Gpt.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Gpt.h containing the implementation of the GPT driver. Timers are
+* kept in a hierarchical wheel of GPT_WHEEL_LEVELS levels of 32 slots: a slot of level L spans
+* 32^L ticks, so a timer is filed by the highest bit of its remaining time and moved down one level
+* each time the wheel reaches its slot. The wheel is advanced in jumps from one occupied slot to
+* the next, found from a bitmap per level, and the compare channel of the hardware timer is only
+* set to that next event: there is no periodic tick.
+*/
+
+#include "Gpt.h"
+#include "SchM.h"
+
+// Slots per level and bits of the expiry selecting the slot
+#define GPT_WHEEL_BITS      5u
+#define GPT_WHEEL_SLOTS     (1u << GPT_WHEEL_BITS)
+
+// Levels needed to hold GPT_MAX_VALUE: 6 x 5 bits = 30 bits
+#define GPT_WHEEL_LEVELS    6u
+
+// Slot value of a timer in Gpt_Expired
+#define GPT_SLOT_EXPIRED    0xFFu
+
+// State of a channel
+typedef enum {
+    GPT_CHANNEL_INITIALIZED,
+    GPT_CHANNEL_RUNNING,
+    GPT_CHANNEL_STOPPED,
+    GPT_CHANNEL_EXPIRED
+} Gpt_ChannelStateType;
+
+static uint8_t Gpt_Initialized;
+static const Gpt_ChannelConfigType* Gpt_ActiveConfig;
+
+// Timer wheel: lists of timers per slot, and per level the slots that are not empty
+static Gpt_TimerType* Gpt_WheelSlot[GPT_WHEEL_LEVELS * GPT_WHEEL_SLOTS];
+static uint32_t Gpt_WheelMap[GPT_WHEEL_LEVELS];
+static uint32_t Gpt_WheelTime;              // Tick up to which the wheel has been advanced
+static Gpt_TimerType* Gpt_Expired;          // Timers due, waiting for their callback
+static uint8_t Gpt_Armed;                   // The compare interrupt is enabled
+static uint32_t Gpt_ArmedTime;              // Tick in the compare register
+static Gpt_StatsType Gpt_Stats;
+
+// Channels
+static Gpt_TimerType Gpt_ChannelTimer[GPT_MAX_CHANNEL];
+static Gpt_ValueType Gpt_ChannelValue[GPT_MAX_CHANNEL];     // Duration given to Gpt_StartTimer
+static Gpt_ValueType Gpt_ChannelStopped[GPT_MAX_CHANNEL];   // Elapsed time when stopped
+static volatile Gpt_ChannelStateType Gpt_ChannelState[GPT_MAX_CHANNEL];
+static uint8_t Gpt_ChannelNotify[GPT_MAX_CHANNEL];
+
+/*
+* Function: Gpt_Link
+* Description: Pushes a timer onto a list.
+* Input:
+*   - Head: List to push onto.
+*   - Timer: Timer to push.
+* Output: None
+*/
+static void Gpt_Link(Gpt_TimerType** Head, Gpt_TimerType* Timer) {
+    Timer->next = *Head;
+    if (Timer->next != NULL) {
+        Timer->next->prev = &Timer->next;
+    }
+    Timer->prev = Head;
+    *Head = Timer;
+}
+
+/*
+* Function: Gpt_Unlink
+* Description: Removes a running timer from its slot or from the expired list, clearing the bit
+*   of its slot once the slot is empty.
+* Input:
+*   - Timer: Timer to remove.
+* Output: None
+*/
+static void Gpt_Unlink(Gpt_TimerType* Timer) {
+    *Timer->prev = Timer->next;
+    if (Timer->next != NULL) {
+        Timer->next->prev = Timer->prev;
+    }
+    Timer->prev = NULL;
+    if (Timer->slot != GPT_SLOT_EXPIRED && Gpt_WheelSlot[Timer->slot] == NULL) {
+        Gpt_WheelMap[Timer->slot / GPT_WHEEL_SLOTS] &= ~(1u << (Timer->slot % GPT_WHEEL_SLOTS));
+    }
+}
+
+/*
+* Function: Gpt_Insert
+* Description: Files a timer in the slot of its expiry relative to the wheel time: level L holds
+*   the timers due in 32^L to 32^(L+1) - 1 ticks. A timer already due joins the expired list.
+* Input:
+*   - Timer: Timer to file, with its expiry set.
+* Output: None
+*/
+static void Gpt_Insert(Gpt_TimerType* Timer) {
+    uint32_t delta = Timer->expiry - Gpt_WheelTime;
+    uint32_t target = Timer->expiry;
+
+    if ((int32_t)delta <= 0) {
+        Timer->slot = GPT_SLOT_EXPIRED;
+        Gpt_Link(&Gpt_Expired, Timer);
+        return;
+    }
+    // A timer started while the wheel lags behind the counter may be due beyond the top level:
+    // it is filed at the end of the wheel and filed again from there
+    if (delta >= (1u << (GPT_WHEEL_BITS * GPT_WHEEL_LEVELS))) {
+        delta = (1u << (GPT_WHEEL_BITS * GPT_WHEEL_LEVELS)) - 1u;
+        target = Gpt_WheelTime + delta;
+    }
+    uint32_t level = (31u - __CLZ(delta)) / GPT_WHEEL_BITS;
+    uint32_t index = (target >> (GPT_WHEEL_BITS * level)) & (GPT_WHEEL_SLOTS - 1u);
+
+    Timer->slot = (uint8_t)(level * GPT_WHEEL_SLOTS + index);
+    Gpt_Link(&Gpt_WheelSlot[Timer->slot], Timer);
+    Gpt_WheelMap[level] |= 1u << index;
+}
+
+/*
+* Function: Gpt_NextEvent
+* Description: Finds the next tick at which the wheel has work: the first occupied slot after the
+*   current one on each level, level 0 slots expiring and the others moving down at the start of
+*   their span.
+* Input:
+*   - EventPtr: Receives the tick of the next event.
+* Output: 0 if the wheel is empty, 1 otherwise.
+*/
+static uint8_t Gpt_NextEvent(uint32_t* EventPtr) {
+    uint32_t best = 0xFFFFFFFFu;
+    uint8_t found = 0;
+
+    for (uint32_t level = 0; level < GPT_WHEEL_LEVELS; level++) {
+        uint32_t map = Gpt_WheelMap[level];
+        if (map == 0) {
+            continue;
+        }
+        uint32_t shift = GPT_WHEEL_BITS * level;
+        uint32_t start = ((Gpt_WheelTime >> shift) + 1u) & (GPT_WHEEL_SLOTS - 1u);
+        // Rotate the slot after the current one to bit 0; the lowest set bit is then the distance
+        uint32_t rotated = (map >> start) | (map << ((GPT_WHEEL_SLOTS - start) & (GPT_WHEEL_SLOTS - 1u)));
+        uint32_t distance = 32u - __CLZ(rotated & (0u - rotated));
+        uint32_t event = ((Gpt_WheelTime >> shift) + distance) << shift;
+        if (event - Gpt_WheelTime - 1u < best) {
+            best = event - Gpt_WheelTime - 1u;
+            found = 1;
+        }
+    }
+    *EventPtr = Gpt_WheelTime + best + 1u;
+    return found;
+}
+
+/*
+* Function: Gpt_Advance
+* Description: Moves the wheel to its next event if the counter has reached it: the slots reached
+*   on the upper levels are filed again one level down, the slot reached on level 0 becomes the
+*   expired list.
+* Input:
+*   - Now: Current value of the counter.
+* Output: 1 if the wheel moved, 0 if its next event is still ahead or the wheel is empty.
+*/
+static uint8_t Gpt_Advance(uint32_t Now) {
+    uint32_t event;
+
+    if (!Gpt_NextEvent(&event) || (int32_t)(Now - event) < 0) {
+        return 0;
+    }
+    Gpt_WheelTime = event;
+    for (uint32_t level = GPT_WHEEL_LEVELS - 1u; level > 0; level--) {
+        uint32_t shift = GPT_WHEEL_BITS * level;
+        uint32_t index = (event >> shift) & (GPT_WHEEL_SLOTS - 1u);
+        if ((event & ((1u << shift) - 1u)) != 0 || (Gpt_WheelMap[level] & (1u << index)) == 0) {
+            continue;
+        }
+        Gpt_TimerType* timer = Gpt_WheelSlot[level * GPT_WHEEL_SLOTS + index];
+        Gpt_WheelSlot[level * GPT_WHEEL_SLOTS + index] = NULL;
+        Gpt_WheelMap[level] &= ~(1u << index);
+        while (timer != NULL) {
+            Gpt_TimerType* next = timer->next;
+            Gpt_Insert(timer);
+            Gpt_Stats.cascades++;
+            timer = next;
+        }
+    }
+    uint32_t index = event & (GPT_WHEEL_SLOTS - 1u);
+    if (Gpt_WheelMap[0] & (1u << index)) {
+        Gpt_TimerType* timer = Gpt_WheelSlot[index];
+        Gpt_WheelSlot[index] = NULL;
+        Gpt_WheelMap[0] &= ~(1u << index);
+        while (timer != NULL) {
+            Gpt_TimerType* next = timer->next;
+            timer->slot = GPT_SLOT_EXPIRED;
+            Gpt_Link(&Gpt_Expired, timer);
+            timer = next;
+        }
+    }
+    return 1;
+}
+
+/*
+* Function: Gpt_Arm
+* Description: Sets the compare channel to the next event of the wheel, or disables its interrupt
+*   when the wheel is empty. An event the counter has already passed is raised by software, since
+*   the compare only matches when the counter reaches it.
+* Input: None
+* Output: None
+*/
+static void Gpt_Arm(void) {
+    uint32_t event = 0;
+
+    if (Gpt_Expired == NULL && !Gpt_NextEvent(&event)) {
+        if (Gpt_Armed) {
+            TIM_ITConfig(GPT_TIMER, TIM_IT_CC1, DISABLE);
+            Gpt_Armed = 0;
+        }
+        return;
+    }
+    if (!Gpt_Armed) {
+        TIM_ClearITPendingBit(GPT_TIMER, TIM_IT_CC1);
+        TIM_ITConfig(GPT_TIMER, TIM_IT_CC1, ENABLE);
+        Gpt_Armed = 1;
+        Gpt_ArmedTime = event + 1u;
+    }
+    if (Gpt_Expired != NULL) {
+        TIM_GenerateEvent(GPT_TIMER, TIM_EventSource_CC1);
+        return;
+    }
+    if (event == Gpt_ArmedTime) {
+        return;
+    }
+    TIM_SetCompare1(GPT_TIMER, event);
+    Gpt_ArmedTime = event;
+    if ((int32_t)(TIM_GetCounter(GPT_TIMER) - event) >= 0) {
+        TIM_GenerateEvent(GPT_TIMER, TIM_EventSource_CC1);
+    }
+}
+
+/*
+* Function: Gpt_WheelEmpty
+* Description: Tells if no timer is running.
+* Input: None
+* Output: 1 if the wheel and the expired list are empty.
+*/
+static uint8_t Gpt_WheelEmpty(void) {
+    for (uint32_t level = 0; level < GPT_WHEEL_LEVELS; level++) {
+        if (Gpt_WheelMap[level] != 0) {
+            return 0;
+        }
+    }
+    return Gpt_Expired == NULL;
+}
+
+/*
+* Function: GPT_TIMER_IRQHandler
+* Description: Advances the wheel up to the counter and runs the callbacks of the expired timers
+*   one at a time, outside the exclusive area, so a callback can start and stop timers. Periodic
+*   timers are filed again before their callback runs.
+* Input: None
+* Output: None
+*/
+void GPT_TIMER_IRQHandler(void) {
+    if (TIM_GetITStatus(GPT_TIMER, TIM_IT_CC1) == RESET) {
+        return;
+    }
+    TIM_ClearITPendingBit(GPT_TIMER, TIM_IT_CC1);
+    Gpt_Stats.interrupts++;
+
+    for (;;) {
+        SchM_StateType state;
+        SchM_Enter(state);
+        Gpt_TimerType* timer = Gpt_Expired;
+        if (timer == NULL) {
+            if (Gpt_Advance(TIM_GetCounter(GPT_TIMER))) {
+                SchM_Exit(state);
+                continue;
+            }
+            Gpt_Arm();
+            SchM_Exit(state);
+            // An event raised by Gpt_Arm is served by the next interrupt
+            return;
+        }
+        Gpt_Unlink(timer);
+        if (timer->period != 0) {
+            timer->expiry += timer->period;
+            Gpt_Insert(timer);
+        }
+        Gpt_Stats.expirations++;
+        Gpt_TimerCallbackType callback = timer->callback;
+        void* context = timer->context;
+        SchM_Exit(state);
+
+        callback(context);
+    }
+}
+
+/*
+* Function: Gpt_Init
+* Description: Starts the hardware timer counting ticks from 0 and stops every channel. Software
+*   timers still running are forgotten: stop them first, or clear them before they are started again.
+* Input:
+*   - ConfigPtr: Channel configuration, NULL for Gpt_ChannelConfig.
+* Output: None
+*/
+void Gpt_Init(const Gpt_ChannelConfigType* ConfigPtr) {
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    Gpt_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : Gpt_ChannelConfig;
+
+    RCC_APB1PeriphClockCmd(GPT_TIMER_CLOCK, ENABLE);
+    TIM_DeInit(GPT_TIMER);
+    TIM_TimeBaseInitStruct.TIM_Prescaler = (uint16_t)GPT_TIMER_PRESCALER;
+    TIM_TimeBaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStruct.TIM_Period = 0xFFFFFFFFu;
+    TIM_TimeBaseInitStruct.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStruct.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(GPT_TIMER, &TIM_TimeBaseInitStruct);
+    // The update loading the prescaler also sets the flags
+    TIM_ClearFlag(GPT_TIMER, TIM_FLAG_Update | TIM_FLAG_CC1);
+
+    for (uint32_t i = 0; i < GPT_WHEEL_LEVELS * GPT_WHEEL_SLOTS; i++) {
+        Gpt_WheelSlot[i] = NULL;
+    }
+    for (uint32_t level = 0; level < GPT_WHEEL_LEVELS; level++) {
+        Gpt_WheelMap[level] = 0;
+    }
+    Gpt_WheelTime = 0;
+    Gpt_Expired = NULL;
+    Gpt_Armed = 0;
+    Gpt_Stats = (Gpt_StatsType){ 0 };
+    for (Gpt_ChannelType ch = 0; ch < GPT_MAX_CHANNEL; ch++) {
+        Gpt_ChannelTimer[ch].prev = NULL;
+        Gpt_ChannelState[ch] = GPT_CHANNEL_INITIALIZED;
+        Gpt_ChannelNotify[ch] = 0;
+    }
+
+    NVIC_InitStruct.NVIC_IRQChannel = GPT_TIMER_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStruct);
+
+    TIM_Cmd(GPT_TIMER, ENABLE);
+    Gpt_Initialized = 1;
+}
+
+/*
+* Function: Gpt_DeInit
+* Description: Stops the hardware timer. Every channel and software timer is dropped, see Gpt_Init.
+* Input: None
+* Output: None
+*/
+void Gpt_DeInit(void) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (!Gpt_Initialized) {
+        return;
+    }
+    NVIC_InitStruct.NVIC_IRQChannel = GPT_TIMER_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = DISABLE;
+    NVIC_Init(&NVIC_InitStruct);
+    TIM_Cmd(GPT_TIMER, DISABLE);
+    TIM_DeInit(GPT_TIMER);
+    Gpt_Initialized = 0;
+}
+
+/*
+* Function: Gpt_TimerStart
+* Description: Starts a software timer, or restarts it if it is running. The callback runs from
+*   the timer interrupt Value ticks from now, then every Period ticks if Period is not 0.
+* Input:
+*   - Timer: Timer to start, kept by the caller until it is stopped or has expired.
+*   - Value: Ticks until the first expiry, 1 to GPT_MAX_VALUE.
+*   - Period: Ticks between the following expiries, 0 for a one-shot timer.
+*   - Callback: Function called at each expiry.
+*   - Context: Argument of the callback.
+* Output: E_OK if the timer was started, E_NOT_OK otherwise.
+*/
+Std_ReturnType Gpt_TimerStart(Gpt_TimerType* Timer, Gpt_ValueType Value, Gpt_ValueType Period,
+                              Gpt_TimerCallbackType Callback, void* Context) {
+    SchM_StateType state;
+
+    if (!Gpt_Initialized || Timer == NULL || Callback == NULL || Value == 0 || Value > GPT_MAX_VALUE ||
+        Period > GPT_MAX_VALUE) {
+        return E_NOT_OK;
+    }
+    uint32_t now = TIM_GetCounter(GPT_TIMER);
+
+    SchM_Enter(state);
+    if (Timer->prev != NULL) {
+        Gpt_Unlink(Timer);
+    }
+    // An idle wheel is brought up to the counter, so new timers are filed from the current time
+    if (Gpt_WheelEmpty()) {
+        Gpt_WheelTime = now;
+    }
+    Timer->expiry = now + Value;
+    Timer->period = Period;
+    Timer->callback = Callback;
+    Timer->context = Context;
+    Gpt_Insert(Timer);
+    Gpt_Arm();
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Gpt_TimerStop
+* Description: Stops a software timer; its callback does not run after this call returns unless
+*   it is already running. Stopping a stopped timer has no effect.
+* Input:
+*   - Timer: Timer to stop.
+* Output: None
+*/
+void Gpt_TimerStop(Gpt_TimerType* Timer) {
+    SchM_StateType state;
+
+    if (Timer == NULL) {
+        return;
+    }
+    SchM_Enter(state);
+    if (Timer->prev != NULL) {
+        Gpt_Unlink(Timer);
+        // The compare is left on the stopped timer's event: the interrupt then finds nothing to do
+        // and moves it on, which is cheaper than searching the wheel on every stop
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Gpt_TimerIsRunning
+* Description: Tells if a software timer is waiting for an expiry.
+* Input:
+*   - Timer: Timer to check.
+* Output: 1 if the timer runs, 0 otherwise.
+*/
+uint8_t Gpt_TimerIsRunning(const Gpt_TimerType* Timer) {
+    return (Timer != NULL && Timer->prev != NULL) ? 1u : 0u;
+}
+
+/*
+* Function: Gpt_DelayExpired
+* Description: Callback of the timer of Gpt_Delay.
+* Input:
+*   - Context: Flag set on expiry.
+* Output: None
+*/
+static void Gpt_DelayExpired(void* Context) {
+    *(volatile uint8_t*)Context = 1;
+}
+
+/*
+* Function: Gpt_Delay
+* Description: Waits for a number of ticks with the core asleep between interrupts. Must not be
+*   called from an interrupt handler.
+* Input:
+*   - Value: Ticks to wait, 1 to GPT_MAX_VALUE.
+* Output: None
+*/
+void Gpt_Delay(Gpt_ValueType Value) {
+    Gpt_TimerType timer = { 0 };
+    volatile uint8_t done = 0;
+    SchM_StateType state;
+
+    if (Gpt_TimerStart(&timer, Value, 0, Gpt_DelayExpired, (void*)&done) != E_OK) {
+        return;
+    }
+    SchM_Enter(state);
+    while (!done) {
+        // The timer interrupt runs between exit and enter
+        SchM_WaitForInterrupt();
+        SchM_Exit(state);
+        SchM_Enter(state);
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Gpt_ChannelExpired
+* Description: Callback of the channel timers: one-shot channels become expired, then the
+*   notification runs if it is enabled.
+* Input:
+*   - Context: Timer of the channel.
+* Output: None
+*/
+static void Gpt_ChannelExpired(void* Context) {
+    Gpt_ChannelType channel = (Gpt_ChannelType)((Gpt_TimerType*)Context - Gpt_ChannelTimer);
+
+    if (Gpt_ActiveConfig[channel].mode == GPT_CH_MODE_ONESHOT) {
+        Gpt_ChannelState[channel] = GPT_CHANNEL_EXPIRED;
+    }
+    if (Gpt_ChannelNotify[channel] && Gpt_ActiveConfig[channel].notification != NULL) {
+        Gpt_ActiveConfig[channel].notification();
+    }
+}
+
+/*
+* Function: Gpt_StartTimer
+* Description: Starts a channel with the given duration; continuous channels restart at each
+*   expiry.
+* Input:
+*   - Channel: Channel to start.
+*   - Value: Ticks until the expiry, 1 to GPT_MAX_VALUE.
+* Output: E_OK if the channel was started, E_NOT_OK if it is invalid or already running.
+*/
+Std_ReturnType Gpt_StartTimer(Gpt_ChannelType Channel, Gpt_ValueType Value) {
+    if (Channel >= GPT_MAX_CHANNEL || Gpt_ChannelState[Channel] == GPT_CHANNEL_RUNNING) {
+        return E_NOT_OK;
+    }
+    Gpt_ValueType period = (Gpt_ActiveConfig[Channel].mode == GPT_CH_MODE_CONTINUOUS) ? Value : 0;
+    Gpt_ChannelStateType state = Gpt_ChannelState[Channel];
+    Gpt_ValueType value = Gpt_ChannelValue[Channel];
+
+    // Running before it is armed: a short one-shot channel may expire in the timer interrupt at once
+    Gpt_ChannelValue[Channel] = Value;
+    Gpt_ChannelState[Channel] = GPT_CHANNEL_RUNNING;
+    if (Gpt_TimerStart(&Gpt_ChannelTimer[Channel], Value, period, Gpt_ChannelExpired,
+                       &Gpt_ChannelTimer[Channel]) != E_OK) {
+        Gpt_ChannelValue[Channel] = value;
+        Gpt_ChannelState[Channel] = state;
+        return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+/*
+* Function: Gpt_StopTimer
+* Description: Stops a running channel, keeping the time elapsed for Gpt_GetTimeElapsed.
+* Input:
+*   - Channel: Channel to stop.
+* Output: E_OK if the channel was running, E_NOT_OK otherwise.
+*/
+Std_ReturnType Gpt_StopTimer(Gpt_ChannelType Channel) {
+    if (Channel >= GPT_MAX_CHANNEL || Gpt_ChannelState[Channel] != GPT_CHANNEL_RUNNING) {
+        return E_NOT_OK;
+    }
+    Gpt_ChannelStopped[Channel] = Gpt_GetTimeElapsed(Channel);
+    Gpt_TimerStop(&Gpt_ChannelTimer[Channel]);
+    Gpt_ChannelState[Channel] = GPT_CHANNEL_STOPPED;
+    return E_OK;
+}
+
+/*
+* Function: Gpt_GetTimeElapsed
+* Description: Ticks since the channel was started or, for a continuous channel, since its last
+*   expiry.
+* Input:
+*   - Channel: Channel to read.
+* Output: Elapsed ticks; the duration once a one-shot channel has expired, 0 before the first start.
+*/
+Gpt_ValueType Gpt_GetTimeElapsed(Gpt_ChannelType Channel) {
+    if (Channel >= GPT_MAX_CHANNEL) {
+        return 0;
+    }
+    switch (Gpt_ChannelState[Channel]) {
+    case GPT_CHANNEL_RUNNING: {
+        Gpt_ValueType remaining = Gpt_GetTimeRemaining(Channel);
+        return (remaining < Gpt_ChannelValue[Channel]) ? Gpt_ChannelValue[Channel] - remaining : 0;
+    }
+    case GPT_CHANNEL_STOPPED:
+        return Gpt_ChannelStopped[Channel];
+    case GPT_CHANNEL_EXPIRED:
+        return Gpt_ChannelValue[Channel];
+    default:
+        return 0;
+    }
+}
+
+/*
+* Function: Gpt_GetTimeRemaining
+* Description: Ticks until the next expiry of a running channel.
+* Input:
+*   - Channel: Channel to read.
+* Output: Remaining ticks, 0 if the channel does not run or its expiry is being served.
+*/
+Gpt_ValueType Gpt_GetTimeRemaining(Gpt_ChannelType Channel) {
+    if (Channel >= GPT_MAX_CHANNEL || Gpt_ChannelState[Channel] != GPT_CHANNEL_RUNNING) {
+        return 0;
+    }
+    int32_t remaining = (int32_t)(Gpt_ChannelTimer[Channel].expiry - TIM_GetCounter(GPT_TIMER));
+    return (remaining > 0) ? (Gpt_ValueType)remaining : 0;
+}
+
+/*
+* Function: Gpt_EnableNotification
+* Description: Enables the notification of a channel.
+* Input:
+*   - Channel: Channel whose notification is enabled.
+* Output: None
+*/
+void Gpt_EnableNotification(Gpt_ChannelType Channel) {
+    if (Channel < GPT_MAX_CHANNEL) {
+        Gpt_ChannelNotify[Channel] = 1;
+    }
+}
+
+/*
+* Function: Gpt_DisableNotification
+* Description: Disables the notification of a channel; the channel keeps running.
+* Input:
+*   - Channel: Channel whose notification is disabled.
+* Output: None
+*/
+void Gpt_DisableNotification(Gpt_ChannelType Channel) {
+    if (Channel < GPT_MAX_CHANNEL) {
+        Gpt_ChannelNotify[Channel] = 0;
+    }
+}
+
+/*
+* Function: Gpt_GetPredefTimerValue
+* Description: Reads the free-running counter, a 32-bit timer of GPT_TICKS_PER_MS ticks per ms.
+* Input:
+*   - TimeValuePtr: Receives the counter.
+* Output: E_OK, or E_NOT_OK if the driver is not initialized.
+*/
+Std_ReturnType Gpt_GetPredefTimerValue(uint32_t* TimeValuePtr) {
+    if (!Gpt_Initialized || TimeValuePtr == NULL) {
+        return E_NOT_OK;
+    }
+    *TimeValuePtr = TIM_GetCounter(GPT_TIMER);
+    return E_OK;
+}
+
+/*
+* Function: Gpt_GetStats
+* Description: Copies the counters of the driver.
+* Input:
+*   - StatsPtr: Receives the counters.
+* Output: E_OK, or E_NOT_OK if StatsPtr is NULL.
+*/
+Std_ReturnType Gpt_GetStats(Gpt_StatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = Gpt_Stats;
+    SchM_Exit(state);
+    return E_OK;
+}
@@ -0,0 +1,17 @@
+/*
+* File: Gpt_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Channel configuration of the GPT driver.
+*/
+
+#include "Gpt.h"
+
+// Channels without notification. The software timers are used by modules linked everywhere, such
+// as CanTp, so this table names no application function; the application passes its own table
+// with the notifications to Gpt_Init.
+const Gpt_ChannelConfigType Gpt_ChannelConfig[GPT_MAX_CHANNEL] = {
+    { GPT_CH_MODE_CONTINUOUS, NULL },       /* GPT_CHANNEL_LED */
+    { GPT_CH_MODE_CONTINUOUS, NULL },       /* GPT_CHANNEL_MAIN_CYCLE */
+    { GPT_CH_MODE_CONTINUOUS, NULL },       /* GPT_CHANNEL_COM_CYCLE */
+};
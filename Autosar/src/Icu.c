@@ -0,0 +1,555 @@
+/*
+* File: Icu.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Icu.h containing the implementation of the ICU driver. The timers
+* count freely from Icu_Init; starting a channel enables its capture and a DMA request: the
+* capture/compare request of a timestamp channel moves each captured CCRx into the buffer of the
+* application, the trigger request of a signal measurement channel reads CCR1 and CCR2 in one burst
+* through DMAR at each active edge.
+*/
+
+#include "Icu.h"
+#include <stdint.h>
+
+// All flags of DMA stream n
+#define ICU_DMA_FLAGS(n) (DMA_FLAG_FEIF##n | DMA_FLAG_DMEIF##n | DMA_FLAG_TEIF##n | DMA_FLAG_HTIF##n | DMA_FLAG_TCIF##n)
+
+// Words written by the burst of a signal measurement channel: CCR1 and CCR2
+#define ICU_BURST_LENGTH 2u
+
+// Peripheral resources of a hardware unit
+typedef struct {
+    TIM_TypeDef* regs;                  // Timer
+    uint32_t rccPeriph;                 // RCC_APBxPeriph_TIMx clock enable bit
+    uint8_t apb2;                       // TIM8: clock enable bit on APB2
+    uint32_t maxCount;                  // Last value of the counter
+    uint8_t timChannel;                 // 0..3 for the channel CH1..CH4 on the input pin
+    DMA_Stream_TypeDef* stream;         // Stream of the capture or trigger request
+    uint32_t dmaClock;                  // RCC_AHB1Periph_DMAx of the stream
+    uint32_t channel;                   // DMA_Channel_x selecting the request
+    uint16_t dmaRequest;                // TIM_DMA_CCx for timestamps, TIM_DMA_Trigger for measurements
+    uint32_t flags;                     // All flags of the stream
+    uint32_t halfFlag;                  // Half transfer flag of the stream
+    uint32_t completeFlag;              // Transfer complete flag of the stream
+    uint32_t errorFlag;                 // Transfer error flag of the stream
+    IRQn_Type irqn;                     // Interrupt of the stream
+} Icu_HWUnitHwType;
+
+// Resources of TIM5 and TIM8, the timers not used by the GPT and PWM drivers. TIM5 has a 32-bit
+// counter for timestamps; its CH4 request is on DMA1 stream 1, the TIM8 trigger request on DMA2
+// stream 7, both streams free of the other drivers. Only TIM1 and TIM8 have a trigger request
+// with a free stream, and a measurement needs the pair CH1/CH2.
+static const Icu_HWUnitHwType Icu_HWUnitHw[NUM_OF_ICU_HW_UNITS] = {
+    { TIM5, RCC_APB1Periph_TIM5, 0, 0xFFFFFFFFu, 3, DMA1_Stream1, RCC_AHB1Periph_DMA1, DMA_Channel_6, TIM_DMA_CC4,
+      ICU_DMA_FLAGS(1), DMA_FLAG_HTIF1, DMA_FLAG_TCIF1, DMA_FLAG_TEIF1, DMA1_Stream1_IRQn },
+    { TIM8, RCC_APB2Periph_TIM8, 1, 0xFFFFu, 1, DMA2_Stream7, RCC_AHB1Periph_DMA2, DMA_Channel_7, TIM_DMA_Trigger,
+      ICU_DMA_FLAGS(7), DMA_FLAG_HTIF7, DMA_FLAG_TCIF7, DMA_FLAG_TEIF7, DMA2_Stream7_IRQn },
+};
+
+// Input capture polarity of each Icu_ActivationType
+static const uint16_t Icu_Polarity[] = { TIM_ICPolarity_Rising, TIM_ICPolarity_Falling, TIM_ICPolarity_BothEdge };
+
+// State of a channel
+typedef struct {
+    Icu_ActivationType activation;      // Edges of the next start
+    volatile uint8_t running;           // Capture enabled; cleared by the stream of a full linear buffer
+    uint8_t notification;               // Timestamp notification enabled
+    Icu_ValueType* buffer;              // Timestamp buffer, NULL before the first start
+    Icu_IndexType size;                 // Timestamps held by the buffer
+    Icu_IndexType notifyInterval;       // 0, size / 2 or size
+} Icu_ChannelStateType;
+
+static uint8_t Icu_Initialized;
+static const Icu_ChannelConfigType* Icu_ActiveConfig;
+static Icu_ChannelStateType Icu_ChannelState[ICU_MAX_CHANNEL];
+static Icu_ChannelType Icu_HWUnitChannel[NUM_OF_ICU_HW_UNITS];     // Channel of each unit
+// CCR1 and CCR2 of the last two active edges of a signal measurement, written in turn by the burst
+static volatile Icu_ValueType Icu_Period[NUM_OF_ICU_HW_UNITS][2][ICU_BURST_LENGTH];
+
+/*
+* Function: Icu_InputStart
+* Description: Sets up the input capture of a channel with its activation, which enables the
+*   capture. A signal measurement also captures the opposite edges on the other channel of the pair.
+* Input:
+*   - Channel: Channel to start.
+* Output: None
+*/
+static void Icu_InputStart(Icu_ChannelType Channel) {
+    const Icu_ChannelConfigType* channelCfg = &Icu_ActiveConfig[Channel];
+    const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+    TIM_ICInitTypeDef TIM_ICInitStruct;
+
+    TIM_ICStructInit(&TIM_ICInitStruct);
+    TIM_ICInitStruct.TIM_Channel = (uint16_t)(hw->timChannel << 2);
+    TIM_ICInitStruct.TIM_ICPolarity = Icu_Polarity[Icu_ChannelState[Channel].activation];
+    TIM_ICInitStruct.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStruct.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStruct.TIM_ICFilter = channelCfg->filter;
+    if (channelCfg->measurementMode == ICU_MODE_SIGNAL_MEASUREMENT) {
+        TIM_PWMIConfig(hw->regs, &TIM_ICInitStruct);
+    } else {
+        TIM_ICInit(hw->regs, &TIM_ICInitStruct);
+    }
+}
+
+/*
+* Function: Icu_StreamStart
+* Description: Starts the stream of a unit, reading a timer register into a buffer at each request.
+* Input:
+*   - HWUnit: Unit whose stream is started.
+*   - Source: Register read, CCRx or DMAR.
+*   - Buffer: Destination of the transfers.
+*   - Size: Words of the buffer.
+*   - Circular: Restart from the start of the buffer once it is full.
+*   - Interrupts: DMA_IT_x enabled on the stream, 0 for none.
+* Output: None
+*/
+static void Icu_StreamStart(Icu_HWUnitType HWUnit, const volatile void* Source, volatile Icu_ValueType* Buffer,
+                            uint16_t Size, uint8_t Circular, uint32_t Interrupts) {
+    const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[HWUnit];
+    DMA_InitTypeDef DMA_InitStruct;
+
+    DMA_InitStruct.DMA_Channel = hw->channel;
+    DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)Source;
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Buffer;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStruct.DMA_BufferSize = Size;
+    DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStruct.DMA_Mode = Circular ? DMA_Mode_Circular : DMA_Mode_Normal;
+    DMA_InitStruct.DMA_Priority = DMA_Priority_High;
+    DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(hw->stream, &DMA_InitStruct);
+    // DMA_Init keeps the interrupt enables of the previous start
+    DMA_ITConfig(hw->stream, DMA_IT_TC | DMA_IT_HT | DMA_IT_TE, DISABLE);
+    if (Interrupts != 0) {
+        DMA_ITConfig(hw->stream, Interrupts, ENABLE);
+    }
+
+    DMA_ClearFlag(hw->stream, hw->flags);
+    DMA_Cmd(hw->stream, ENABLE);
+}
+
+/*
+* Function: Icu_Stop
+* Description: Disables the capture of a channel, its DMA request and its stream. The counter
+*   keeps running and the stream keeps its position.
+* Input:
+*   - Channel: Channel to stop.
+* Output: None
+*/
+static void Icu_Stop(Icu_ChannelType Channel) {
+    const Icu_ChannelConfigType* channelCfg = &Icu_ActiveConfig[Channel];
+    const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+
+    TIM_CCxCmd(hw->regs, (uint16_t)(hw->timChannel << 2), TIM_CCx_Disable);
+    if (channelCfg->measurementMode == ICU_MODE_SIGNAL_MEASUREMENT) {
+        TIM_CCxCmd(hw->regs, (uint16_t)((hw->timChannel ^ 1u) << 2), TIM_CCx_Disable);
+    }
+    TIM_DMACmd(hw->regs, hw->dmaRequest, DISABLE);
+    DMA_Cmd(hw->stream, DISABLE);
+    Icu_ChannelState[Channel].running = 0;
+}
+
+/*
+* Function: Icu_Init
+* Description: Starts the timers of the channels counting, in reset slave mode on the active edges
+*   for the signal measurement channels. No edge is captured before a channel is started.
+* Input:
+*   - ConfigPtr: Channel configuration, NULL for Icu_ChannelConfig.
+* Output: None
+*/
+void Icu_Init(const Icu_ChannelConfigType* ConfigPtr) {
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (Icu_Initialized) {
+        Icu_DeInit();
+    }
+    Icu_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : Icu_ChannelConfig;
+
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    for (Icu_ChannelType channel = 0; channel < ICU_MAX_CHANNEL; channel++) {
+        const Icu_ChannelConfigType* channelCfg = &Icu_ActiveConfig[channel];
+        const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+        Icu_ChannelStateType* state = &Icu_ChannelState[channel];
+
+        if (hw->apb2) {
+            RCC_APB2PeriphClockCmd(hw->rccPeriph, ENABLE);
+        } else {
+            RCC_APB1PeriphClockCmd(hw->rccPeriph, ENABLE);
+        }
+        RCC_AHB1PeriphClockCmd(hw->dmaClock, ENABLE);
+
+        TIM_DeInit(hw->regs);
+        TIM_TimeBaseInitStruct.TIM_Prescaler = channelCfg->prescaler;
+        TIM_TimeBaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
+        TIM_TimeBaseInitStruct.TIM_Period = hw->maxCount;
+        TIM_TimeBaseInitStruct.TIM_ClockDivision = TIM_CKD_DIV1;
+        TIM_TimeBaseInitStruct.TIM_RepetitionCounter = 0;
+        TIM_TimeBaseInit(hw->regs, &TIM_TimeBaseInitStruct);
+        if (channelCfg->measurementMode == ICU_MODE_SIGNAL_MEASUREMENT) {
+            // The active edge restarts the counter after capturing the period into CCRx
+            TIM_SelectInputTrigger(hw->regs, (hw->timChannel == 0) ? TIM_TS_TI1FP1 : TIM_TS_TI2FP2);
+            TIM_SelectSlaveMode(hw->regs, TIM_SlaveMode_Reset);
+            TIM_DMAConfig(hw->regs, TIM_DMABase_CCR1, TIM_DMABurstLength_2Transfers);
+        } else {
+            NVIC_InitStruct.NVIC_IRQChannel = hw->irqn;
+            NVIC_Init(&NVIC_InitStruct);
+        }
+        TIM_Cmd(hw->regs, ENABLE);
+
+        state->activation = channelCfg->defaultStartEdge;
+        state->running = 0;
+        state->notification = 0;
+        state->buffer = NULL;
+        state->size = 0;
+        state->notifyInterval = 0;
+        Icu_HWUnitChannel[channelCfg->hwUnit] = channel;
+    }
+    Icu_Initialized = 1;
+}
+
+/*
+* Function: Icu_DeInit
+* Description: Stops the channels and their timers and switches the timer clocks off.
+* Input: None
+* Output: None
+*/
+void Icu_DeInit(void) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (!Icu_Initialized) {
+        return;
+    }
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = DISABLE;
+    for (Icu_ChannelType channel = 0; channel < ICU_MAX_CHANNEL; channel++) {
+        const Icu_ChannelConfigType* channelCfg = &Icu_ActiveConfig[channel];
+        const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+
+        Icu_Stop(channel);
+        DMA_ClearFlag(hw->stream, hw->flags);
+        if (channelCfg->measurementMode == ICU_MODE_TIMESTAMP) {
+            NVIC_InitStruct.NVIC_IRQChannel = hw->irqn;
+            NVIC_Init(&NVIC_InitStruct);
+        }
+        TIM_Cmd(hw->regs, DISABLE);
+        TIM_DeInit(hw->regs);
+        if (hw->apb2) {
+            RCC_APB2PeriphClockCmd(hw->rccPeriph, DISABLE);
+        } else {
+            RCC_APB1PeriphClockCmd(hw->rccPeriph, DISABLE);
+        }
+    }
+    Icu_Initialized = 0;
+}
+
+/*
+* Function: Icu_SetActivationCondition
+* Description: Sets the edges measured by a stopped channel from its next start.
+* Input:
+*   - Channel: Channel to set.
+*   - Activation: Edges timestamped, or active edge of a signal measurement.
+* Output:
+*   - E_OK: If the edges are set.
+*   - E_NOT_OK: If the driver is not initialized, the channel is invalid or running, or both edges
+*     are asked of a signal measurement.
+*/
+Std_ReturnType Icu_SetActivationCondition(Icu_ChannelType Channel, Icu_ActivationType Activation) {
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL || Icu_ChannelState[Channel].running || Activation > ICU_BOTH_EDGES ||
+        (Activation == ICU_BOTH_EDGES && Icu_ActiveConfig[Channel].measurementMode == ICU_MODE_SIGNAL_MEASUREMENT)) {
+        return E_NOT_OK;
+    }
+    Icu_ChannelState[Channel].activation = Activation;
+    return E_OK;
+}
+
+/*
+* Function: Icu_EnableNotification
+* Description: Enables the timestamp notification of a channel.
+* Input:
+*   - Channel: Channel whose notification is enabled.
+* Output: None
+*/
+void Icu_EnableNotification(Icu_ChannelType Channel) {
+    if (Icu_Initialized && Channel < ICU_MAX_CHANNEL) {
+        Icu_ChannelState[Channel].notification = 1;
+    }
+}
+
+/*
+* Function: Icu_DisableNotification
+* Description: Disables the timestamp notification of a channel.
+* Input:
+*   - Channel: Channel whose notification is disabled.
+* Output: None
+*/
+void Icu_DisableNotification(Icu_ChannelType Channel) {
+    if (Icu_Initialized && Channel < ICU_MAX_CHANNEL) {
+        Icu_ChannelState[Channel].notification = 0;
+    }
+}
+
+/*
+* Function: Icu_StartTimestamp
+* Description: Starts storing the counter value at each edge of a timestamp channel into a buffer,
+*   by DMA. The stream interrupts only at the notifications, so they are limited to the halves or
+*   the whole of the buffer; a linear buffer stops the capture once full.
+* Input:
+*   - Channel: Timestamp channel to start.
+*   - BufferPtr: Timestamps, valid until the channel is stopped.
+*   - BufferSize: Timestamps held by the buffer.
+*   - NotifyInterval: Timestamps between two notifications: 0 for none, BufferSize / 2 for each
+*     half of the buffer or BufferSize for each whole buffer.
+* Output:
+*   - E_OK: If the edges are captured from now on.
+*   - E_NOT_OK: If the driver is not initialized, the channel is invalid, running or not a
+*     timestamp channel, the buffer is NULL or empty, or NotifyInterval is not supported.
+*/
+Std_ReturnType Icu_StartTimestamp(Icu_ChannelType Channel, Icu_ValueType* BufferPtr, Icu_IndexType BufferSize,
+                                  Icu_IndexType NotifyInterval) {
+    const Icu_ChannelConfigType* channelCfg;
+    const Icu_HWUnitHwType* hw;
+    Icu_ChannelStateType* state;
+    uint32_t interrupts = DMA_IT_TE;
+
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL || BufferPtr == NULL || BufferSize == 0) {
+        return E_NOT_OK;
+    }
+    channelCfg = &Icu_ActiveConfig[Channel];
+    hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+    state = &Icu_ChannelState[Channel];
+    if (channelCfg->measurementMode != ICU_MODE_TIMESTAMP || state->running ||
+        (NotifyInterval != 0 && NotifyInterval != BufferSize && (uint32_t)NotifyInterval * 2u != BufferSize)) {
+        return E_NOT_OK;
+    }
+    state->buffer = BufferPtr;
+    state->size = BufferSize;
+    state->notifyInterval = NotifyInterval;
+
+    if (NotifyInterval != 0 || channelCfg->bufferType == ICU_LINEAR_BUFFER) {
+        interrupts |= DMA_IT_TC;
+    }
+    if (NotifyInterval != 0 && NotifyInterval != BufferSize) {
+        interrupts |= DMA_IT_HT;
+    }
+    Icu_StreamStart(channelCfg->hwUnit, &(&hw->regs->CCR1)[hw->timChannel], BufferPtr, BufferSize,
+                    channelCfg->bufferType == ICU_CIRCULAR_BUFFER, interrupts);
+    // A capture left from before the start would be counted as an overcapture
+    TIM_ClearFlag(hw->regs, (uint16_t)((TIM_FLAG_CC1 | TIM_FLAG_CC1OF) << hw->timChannel));
+    TIM_DMACmd(hw->regs, hw->dmaRequest, ENABLE);
+    state->running = 1;
+    Icu_InputStart(Channel);
+    return E_OK;
+}
+
+/*
+* Function: Icu_StopTimestamp
+* Description: Stops the capture of a timestamp channel. The buffer keeps the timestamps stored.
+* Input:
+*   - Channel: Timestamp channel to stop.
+* Output:
+*   - E_OK: If the channel is stopped.
+*   - E_NOT_OK: If the driver is not initialized, the channel is invalid, not a timestamp channel
+*     or not running.
+*/
+Std_ReturnType Icu_StopTimestamp(Icu_ChannelType Channel) {
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL || Icu_ActiveConfig[Channel].measurementMode != ICU_MODE_TIMESTAMP ||
+        !Icu_ChannelState[Channel].running) {
+        return E_NOT_OK;
+    }
+    Icu_Stop(Channel);
+    return E_OK;
+}
+
+/*
+* Function: Icu_GetTimestampIndex
+* Description: Position in the buffer of a timestamp channel, read from the stream.
+* Input:
+*   - Channel: Timestamp channel.
+* Output: Index of the next timestamp to be written, the size of the buffer once a linear buffer
+*   is full, 0 if the channel has never been started or is invalid.
+*/
+Icu_IndexType Icu_GetTimestampIndex(Icu_ChannelType Channel) {
+    const Icu_ChannelStateType* state;
+
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL || Icu_ActiveConfig[Channel].measurementMode != ICU_MODE_TIMESTAMP) {
+        return 0;
+    }
+    state = &Icu_ChannelState[Channel];
+    if (state->buffer == NULL) {
+        return 0;
+    }
+    return (Icu_IndexType)(state->size - DMA_GetCurrDataCounter(Icu_HWUnitHw[Icu_ActiveConfig[Channel].hwUnit].stream));
+}
+
+/*
+* Function: Icu_StartSignalMeasurement
+* Description: Starts measuring the period and active time of the signal of a channel. The values
+*   are available from the second active edge after the first complete period.
+* Input:
+*   - Channel: Signal measurement channel to start.
+* Output:
+*   - E_OK: If the measurement is started.
+*   - E_NOT_OK: If the driver is not initialized, the channel is invalid, running or not a signal
+*     measurement channel.
+*/
+Std_ReturnType Icu_StartSignalMeasurement(Icu_ChannelType Channel) {
+    const Icu_ChannelConfigType* channelCfg;
+    const Icu_HWUnitHwType* hw;
+
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL) {
+        return E_NOT_OK;
+    }
+    channelCfg = &Icu_ActiveConfig[Channel];
+    hw = &Icu_HWUnitHw[channelCfg->hwUnit];
+    if (channelCfg->measurementMode != ICU_MODE_SIGNAL_MEASUREMENT || Icu_ChannelState[Channel].running) {
+        return E_NOT_OK;
+    }
+    for (uint8_t record = 0; record < 2; record++) {
+        for (uint8_t i = 0; i < ICU_BURST_LENGTH; i++) {
+            Icu_Period[channelCfg->hwUnit][record][i] = 0;
+        }
+    }
+    // Two records in turn: the one not being written is always complete
+    Icu_StreamStart(channelCfg->hwUnit, &hw->regs->DMAR, &Icu_Period[channelCfg->hwUnit][0][0],
+                    2u * ICU_BURST_LENGTH, 1, 0);
+    TIM_DMACmd(hw->regs, hw->dmaRequest, ENABLE);
+    Icu_ChannelState[Channel].running = 1;
+    Icu_InputStart(Channel);
+    return E_OK;
+}
+
+/*
+* Function: Icu_StopSignalMeasurement
+* Description: Stops the measurement of a channel. The last values stay readable.
+* Input:
+*   - Channel: Signal measurement channel to stop.
+* Output:
+*   - E_OK: If the measurement is stopped.
+*   - E_NOT_OK: If the driver is not initialized, the channel is invalid, not a signal
+*     measurement channel or not running.
+*/
+Std_ReturnType Icu_StopSignalMeasurement(Icu_ChannelType Channel) {
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL ||
+        Icu_ActiveConfig[Channel].measurementMode != ICU_MODE_SIGNAL_MEASUREMENT || !Icu_ChannelState[Channel].running) {
+        return E_NOT_OK;
+    }
+    Icu_Stop(Channel);
+    return E_OK;
+}
+
+/*
+* Function: Icu_GetDutyCycleValues
+* Description: Reads the period and active time of the last complete period of a signal
+*   measurement channel from the record the DMA is not writing: the position of the stream is read
+*   again after the record, and an odd position is a burst under way. Both values come from the
+*   same burst, so they belong to the same period.
+* Input:
+*   - Channel: Signal measurement channel.
+*   - DutyCycleValues: Receives the values in timer ticks, 0 before the first complete period or
+*     if the channel is invalid.
+* Output: None
+*/
+void Icu_GetDutyCycleValues(Icu_ChannelType Channel, Icu_DutyCycleType* DutyCycleValues) {
+    const Icu_HWUnitHwType* hw;
+    Icu_HWUnitType hwUnit;
+    uint16_t remaining;
+
+    if (DutyCycleValues == NULL) {
+        return;
+    }
+    DutyCycleValues->ActiveTime = 0;
+    DutyCycleValues->PeriodTime = 0;
+    if (!Icu_Initialized || Channel >= ICU_MAX_CHANNEL ||
+        Icu_ActiveConfig[Channel].measurementMode != ICU_MODE_SIGNAL_MEASUREMENT) {
+        return;
+    }
+    hwUnit = Icu_ActiveConfig[Channel].hwUnit;
+    hw = &Icu_HWUnitHw[hwUnit];
+    // The second record is written by the second burst, the first one after a complete period
+    if (Icu_Period[hwUnit][1][hw->timChannel] == 0) {
+        return;
+    }
+    do {
+        remaining = DMA_GetCurrDataCounter(hw->stream);
+        // The record written last is the one before the next transfer
+        uint8_t record = (remaining == ICU_BURST_LENGTH) ? 0 : 1;
+        DutyCycleValues->PeriodTime = Icu_Period[hwUnit][record][hw->timChannel];
+        DutyCycleValues->ActiveTime = Icu_Period[hwUnit][record][hw->timChannel ^ 1u];
+    } while (remaining % ICU_BURST_LENGTH != 0 || DMA_GetCurrDataCounter(hw->stream) != remaining);
+}
+
+/*
+* Function: Icu_GetTimeElapsed
+* Description: Active time of the last complete period of a signal measurement channel.
+* Input:
+*   - Channel: Signal measurement channel.
+* Output: Active time in timer ticks, 0 before the first complete period or if the channel is
+*   invalid.
+*/
+Icu_ValueType Icu_GetTimeElapsed(Icu_ChannelType Channel) {
+    Icu_DutyCycleType values;
+
+    Icu_GetDutyCycleValues(Channel, &values);
+    return values.ActiveTime;
+}
+
+/*
+* Function: Icu_DmaIrqHandler
+* Description: Handles the stream of a timestamp channel: notifies each half or whole buffer
+*   according to NotifyInterval and stops the capture once a linear buffer is full or on a transfer
+*   error.
+* Input:
+*   - HWUnit: Unit whose stream raised the interrupt.
+* Output: None
+*/
+static void Icu_DmaIrqHandler(Icu_HWUnitType HWUnit) {
+    const Icu_HWUnitHwType* hw = &Icu_HWUnitHw[HWUnit];
+    Icu_ChannelType channel = Icu_HWUnitChannel[HWUnit];
+    const Icu_ChannelConfigType* channelCfg;
+    Icu_ChannelStateType* state;
+    uint8_t notify = 0;
+
+    if (!Icu_Initialized) {
+        DMA_ClearFlag(hw->stream, hw->flags);
+        return;
+    }
+    channelCfg = &Icu_ActiveConfig[channel];
+    state = &Icu_ChannelState[channel];
+
+    if (DMA_GetFlagStatus(hw->stream, hw->errorFlag) == SET) {
+        DMA_ClearFlag(hw->stream, hw->flags);
+        Icu_Stop(channel);
+        return;
+    }
+    if (DMA_GetFlagStatus(hw->stream, hw->halfFlag) == SET) {
+        DMA_ClearFlag(hw->stream, hw->halfFlag);
+        notify = (state->notifyInterval != 0 && state->notifyInterval != state->size);
+    }
+    if (DMA_GetFlagStatus(hw->stream, hw->completeFlag) == SET) {
+        DMA_ClearFlag(hw->stream, hw->completeFlag);
+        if (channelCfg->bufferType == ICU_LINEAR_BUFFER) {
+            Icu_Stop(channel);
+        }
+        notify |= (state->notifyInterval != 0);
+    }
+    if (notify && state->notification && channelCfg->notification != NULL) {
+        channelCfg->notification();
+    }
+}
+
+/* Stream interrupt of the timestamp unit. The stream of the signal measurement unit raises none. */
+void DMA1_Stream1_IRQHandler(void) {
+    Icu_DmaIrqHandler(ICU_HWUnit_0);
+}
@@ -0,0 +1,16 @@
+/*
+* File: Icu_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Channel configuration of the ICU driver.
+*/
+
+#include "Icu.h"
+
+const Icu_ChannelConfigType Icu_ChannelConfig[ICU_MAX_CHANNEL] = {
+    /* hwUnit, measurementMode, defaultStartEdge, prescaler, filter, bufferType, notification */
+    { ICU_HWUnit_0, ICU_MODE_TIMESTAMP, ICU_RISING_EDGE, ICU_ENCODER_PRESCALER, ICU_ENCODER_FILTER,
+      ICU_CIRCULAR_BUFFER, IcuEncoder_Notification },                                   /* ICU_CHANNEL_ENCODER */
+    { ICU_HWUnit_1, ICU_MODE_SIGNAL_MEASUREMENT, ICU_RISING_EDGE, ICU_PWM_IN_PRESCALER, ICU_PWM_IN_FILTER,
+      ICU_LINEAR_BUFFER, NULL },                                                        /* ICU_CHANNEL_PWM_IN */
+};
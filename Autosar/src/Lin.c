@@ -0,0 +1,629 @@
+/*
+* File: Lin.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Lin.h containing the implementation of the LIN master driver. A
+* frame costs two interrupts whatever its length: the break detected on the bus arms the DMA
+* stream reading the bus back, and the end of the slot evaluates what it received and starts the
+* next frame. The timer restarts by itself at the end of a slot, and only its period is written
+* for the next one, so the slots keep to the timer even when its interrupt is late.
+*/
+
+#include "Lin.h"
+#include "Dma.h"
+#include "SchM.h"
+#include <string.h>
+
+#define LIN_SYNC                0x55u
+#define LIN_MAX_DATA            8u
+#define LIN_BUFFER_LENGTH       (2u + LIN_MAX_DATA + 1u)    // Sync, identifier, data, checksum
+
+// Frame of Lin_CurrentFrame sent by Lin_SendFrame, schedule of Lin_Schedule when none runs
+#define LIN_NO_FRAME            LIN_NUM_FRAMES
+#define LIN_NO_SCHEDULE         LIN_NUM_SCHEDULES
+
+// State of the frame on the bus
+#define LIN_FRAME_IDLE          0u          // No frame, or its result is known
+#define LIN_FRAME_BREAK         1u          // Header sent, waiting for its break on the bus
+#define LIN_FRAME_RECEIVING     2u          // Bus read back by DMA
+
+static const Lin_ConfigType* Lin_ActiveConfig;
+static uint8_t Lin_Initialized;
+static Lin_StatsType Lin_Stats;
+
+// Frame on the bus
+static volatile uint8_t Lin_FrameState;
+static Lin_FrameType Lin_CurrentFrame;
+static Lin_FrameResponseType Lin_CurrentDrc;
+static Lin_FrameCsModelType Lin_CurrentCs;
+static uint8_t Lin_CurrentDl;
+static uint8_t Lin_RxLength;                // Bytes read back for the whole frame
+static uint8_t Lin_TxBuffer[LIN_BUFFER_LENGTH];
+static uint8_t Lin_RxBuffer[LIN_BUFFER_LENGTH];
+static volatile Lin_StatusType Lin_Status;  // Last frame, for Lin_GetStatus
+static uint8_t Lin_SduBuffer[LIN_MAX_DATA]; // Response of the frame of Lin_SendFrame
+
+// Data and last result of the frames of LIN_FRAMES
+static uint8_t Lin_FrameData[LIN_NUM_FRAMES][LIN_MAX_DATA];
+static Lin_StatusType Lin_FrameStatus[LIN_NUM_FRAMES];
+
+// Schedule: the running one, and the one requested for the end of the slot
+static volatile Lin_ScheduleType Lin_Schedule;
+static volatile Lin_ScheduleType Lin_NextSchedule;
+static volatile uint8_t Lin_SwitchPending;
+static uint8_t Lin_Entry;
+static volatile uint8_t Lin_TimerRunning;
+
+/*
+* Function: Lin_GetPid
+* Description: Adds the parity bits to a frame identifier: P0 = ID0 ^ ID1 ^ ID2 ^ ID4 in bit 6 and
+*   P1 = !(ID1 ^ ID3 ^ ID4 ^ ID5) in bit 7.
+* Input:
+*   - Id: Identifier, 0 to 0x3F.
+* Output:
+*   - The protected identifier.
+*/
+Lin_FramePidType Lin_GetPid(uint8_t Id) {
+    uint8_t p0 = (Id ^ (Id >> 1) ^ (Id >> 2) ^ (Id >> 4)) & 1u;
+    uint8_t p1 = (uint8_t)(~((Id >> 1) ^ (Id >> 3) ^ (Id >> 4) ^ (Id >> 5)) & 1u);
+
+    return (Lin_FramePidType)((Id & 0x3Fu) | (p0 << 6) | (p1 << 7));
+}
+
+/*
+* Function: Lin_Checksum
+* Description: Sum of the bytes with the carries added back, inverted. The diagnostic frames
+*   always use the classic checksum.
+* Input:
+*   - Pid: Protected identifier, summed by the enhanced checksum.
+*   - Cs: Checksum model.
+*   - Data, Dl: Data bytes.
+* Output:
+*   - The checksum.
+*/
+static uint8_t Lin_Checksum(Lin_FramePidType Pid, Lin_FrameCsModelType Cs, const uint8_t* Data, uint8_t Dl) {
+    uint32_t sum = 0;
+
+    if (Cs == LIN_ENHANCED_CS && (Pid & 0x3Fu) != 0x3Cu && (Pid & 0x3Fu) != 0x3Du) {
+        sum = Pid;
+    }
+    for (uint8_t i = 0; i < Dl; i++) {
+        sum += Data[i];
+        if (sum > 0xFFu) {
+            sum -= 0xFFu;
+        }
+    }
+    return (uint8_t)~sum;
+}
+
+/*
+* Function: Lin_StartFrame
+* Description: Sends the break, then the header and a master response by DMA. The bus is read
+*   back from the break on, see LIN_USART_IRQHandler.
+* Input:
+*   - Pid, Cs, Drc, Dl: Frame.
+*   - Data: Data of a master response.
+* Output: None
+*/
+static void Lin_StartFrame(Lin_FramePidType Pid, Lin_FrameCsModelType Cs, Lin_FrameResponseType Drc,
+                           uint8_t Dl, const uint8_t* Data) {
+    uint8_t txLength = 2u;
+
+    Lin_CurrentDrc = Drc;
+    Lin_CurrentCs = Cs;
+    Lin_CurrentDl = Dl;
+    Lin_RxLength = (uint8_t)(2u + Dl + 1u);
+    Lin_TxBuffer[0] = LIN_SYNC;
+    Lin_TxBuffer[1] = Pid;
+    if (Drc == LIN_MASTER_RESPONSE) {
+        memcpy(&Lin_TxBuffer[2], Data, Dl);
+        Lin_TxBuffer[2u + Dl] = Lin_Checksum(Pid, Cs, Data, Dl);
+        txLength = Lin_RxLength;
+    }
+
+    DMA_Cmd(LIN_RX_DMA_STREAM, DISABLE);
+    DMA_Cmd(LIN_TX_DMA_STREAM, DISABLE);
+    DMA_ClearFlag(LIN_TX_DMA_STREAM, LIN_TX_DMA_FLAGS);
+    DMA_SetCurrDataCounter(LIN_TX_DMA_STREAM, txLength);
+    Lin_FrameState = LIN_FRAME_BREAK;
+    Lin_Status = (Drc == LIN_MASTER_RESPONSE) ? LIN_TX_BUSY : LIN_RX_BUSY;
+    // The break goes out first, the DMA fills the data register behind it
+    USART_SendBreak(LIN_USART);
+    DMA_Cmd(LIN_TX_DMA_STREAM, ENABLE);
+}
+
+/*
+* Function: Lin_Evaluate
+* Description: Result of the frame on the bus from what was read back: the header echo, then the
+*   echo of a master response or the checksum of a slave response.
+* Input: None
+* Output:
+*   - Status of the frame.
+*/
+static Lin_StatusType Lin_Evaluate(void) {
+    uint32_t received;
+    const uint8_t* response = &Lin_RxBuffer[2];
+
+    if (Lin_FrameState == LIN_FRAME_BREAK) {
+        return LIN_TX_HEADER_ERROR;
+    }
+    received = Lin_RxLength - DMA_GetCurrDataCounter(LIN_RX_DMA_STREAM);
+    if (received < 2u || Lin_RxBuffer[0] != LIN_SYNC || Lin_RxBuffer[1] != Lin_TxBuffer[1]) {
+        return LIN_TX_HEADER_ERROR;
+    }
+    if (Lin_CurrentDrc == LIN_MASTER_RESPONSE) {
+        if (received < Lin_RxLength || memcmp(response, &Lin_TxBuffer[2], Lin_CurrentDl + 1u) != 0) {
+            return LIN_TX_ERROR;
+        }
+        return LIN_TX_OK;
+    }
+    if (received == 2u) {
+        return LIN_RX_NO_RESPONSE;
+    }
+    if (received < Lin_RxLength ||
+        Lin_Checksum(Lin_TxBuffer[1], Lin_CurrentCs, response, Lin_CurrentDl) != response[Lin_CurrentDl]) {
+        return LIN_RX_ERROR;
+    }
+    return LIN_RX_OK;
+}
+
+/*
+* Function: Lin_EndFrame
+* Description: Records the result of the frame on the bus: the data of a slave response are
+*   copied to the frame, or to the buffer of Lin_GetStatus, and a scheduled frame is notified.
+* Input:
+*   - Status: Result of Lin_Evaluate.
+* Output: None
+*/
+static void Lin_EndFrame(Lin_StatusType Status) {
+    Lin_FrameState = LIN_FRAME_IDLE;
+    Lin_Status = Status;
+    Lin_Stats.frames++;
+    switch (Status) {
+    case LIN_TX_HEADER_ERROR:
+        Lin_Stats.headerErrors++;
+        break;
+    case LIN_TX_ERROR:
+        Lin_Stats.txErrors++;
+        break;
+    case LIN_RX_ERROR:
+        Lin_Stats.rxErrors++;
+        break;
+    case LIN_RX_NO_RESPONSE:
+        Lin_Stats.noResponses++;
+        break;
+    default:
+        break;
+    }
+
+    if (Lin_CurrentFrame == LIN_NO_FRAME) {
+        if (Status == LIN_RX_OK) {
+            memcpy(Lin_SduBuffer, &Lin_RxBuffer[2], Lin_CurrentDl);
+        }
+        return;
+    }
+    if (Status == LIN_RX_OK) {
+        memcpy(Lin_FrameData[Lin_CurrentFrame], &Lin_RxBuffer[2], Lin_CurrentDl);
+    }
+    Lin_FrameStatus[Lin_CurrentFrame] = Status;
+    if (Lin_ActiveConfig->frameNotification != NULL) {
+        Lin_ActiveConfig->frameNotification(Lin_CurrentFrame, Status);
+    }
+}
+
+/*
+* Function: Lin_StartSlot
+* Description: Starts the frame of the current entry of the schedule, and sets the length of its
+*   slot. The timer is already counting the slot from its update event.
+* Input: None
+* Output: None
+*/
+static void Lin_StartSlot(void) {
+    const Lin_ScheduleEntryType* entry = &Lin_ActiveConfig->schedules[Lin_Schedule].entries[Lin_Entry];
+    const Lin_FrameConfigType* frame = &Lin_ActiveConfig->frames[entry->frame];
+
+    Lin_CurrentFrame = entry->frame;
+    Lin_StartFrame(Lin_GetPid(frame->id), frame->cs, frame->drc, frame->length, Lin_FrameData[entry->frame]);
+    TIM_SetAutoreload(LIN_TIMER, entry->ticks - 1u);
+}
+
+/*
+* Function: Lin_StartTimer
+* Description: Starts the timer from 0 for a slot of some ticks.
+* Input:
+*   - Ticks: Length of the slot.
+* Output: None
+*/
+static void Lin_StartTimer(uint32_t Ticks) {
+    TIM_Cmd(LIN_TIMER, DISABLE);
+    TIM_SetCounter(LIN_TIMER, 0);
+    TIM_SetAutoreload(LIN_TIMER, Ticks - 1u);
+    TIM_ClearITPendingBit(LIN_TIMER, TIM_IT_Update);
+    TIM_Cmd(LIN_TIMER, ENABLE);
+    Lin_TimerRunning = 1;
+}
+
+/*
+* Function: LIN_USART_IRQHandler
+* Description: Break detected on the bus. The break of the header of the driver arms the stream
+*   reading the bus back, so the buffer starts with the sync byte whatever was on the bus before.
+* Input: None
+* Output: None
+*/
+void LIN_USART_IRQHandler(void) {
+    if (USART_GetITStatus(LIN_USART, USART_IT_LBD) == RESET) {
+        return;
+    }
+    USART_ClearITPendingBit(LIN_USART, USART_IT_LBD);
+    // Drops the break character, received with a framing error, and any overrun
+    (void)USART_ReceiveData(LIN_USART);
+    if (Lin_FrameState != LIN_FRAME_BREAK) {
+        Lin_Stats.unexpectedBreaks++;
+        return;
+    }
+    DMA_ClearFlag(LIN_RX_DMA_STREAM, LIN_RX_DMA_FLAGS);
+    DMA_SetCurrDataCounter(LIN_RX_DMA_STREAM, Lin_RxLength);
+    DMA_Cmd(LIN_RX_DMA_STREAM, ENABLE);
+    Lin_FrameState = LIN_FRAME_RECEIVING;
+}
+
+/*
+* Function: LIN_TIMER_IRQHandler
+* Description: End of a slot: ends the frame on the bus, applies a schedule requested meanwhile,
+*   then starts the frame of the next entry, or stops the timer when no schedule runs.
+* Input: None
+* Output: None
+*/
+void LIN_TIMER_IRQHandler(void) {
+    if (TIM_GetITStatus(LIN_TIMER, TIM_IT_Update) == RESET) {
+        return;
+    }
+    TIM_ClearITPendingBit(LIN_TIMER, TIM_IT_Update);
+
+    if (Lin_FrameState != LIN_FRAME_IDLE) {
+        Lin_EndFrame(Lin_Evaluate());
+    }
+    DMA_Cmd(LIN_RX_DMA_STREAM, DISABLE);
+    DMA_Cmd(LIN_TX_DMA_STREAM, DISABLE);
+
+    if (Lin_SwitchPending) {
+        Lin_SwitchPending = 0;
+        Lin_Schedule = Lin_NextSchedule;
+        Lin_Entry = 0;
+        Lin_Stats.scheduleSwitches++;
+    } else if (Lin_Schedule != LIN_NO_SCHEDULE) {
+        Lin_Entry++;
+        if (Lin_Entry >= Lin_ActiveConfig->schedules[Lin_Schedule].numEntries) {
+            Lin_Entry = 0;
+        }
+    }
+    if (Lin_Schedule == LIN_NO_SCHEDULE) {
+        TIM_Cmd(LIN_TIMER, DISABLE);
+        Lin_TimerRunning = 0;
+        return;
+    }
+    Lin_StartSlot();
+}
+
+/*
+* Function: Lin_Init
+* Description: Sets up the USART in LIN mode (19200 8N1, 11-bit break detection), its DMA streams
+*   and the slot timer. No schedule runs. The pins are configured by the application.
+* Input:
+*   - ConfigPtr: Frames and schedules, NULL for Lin_Config.
+* Output: E_OK, or E_NOT_OK if another driver owns a DMA stream of the driver, which it then keeps.
+*/
+Std_ReturnType Lin_Init(const Lin_ConfigType* ConfigPtr) {
+    USART_InitTypeDef USART_InitStruct;
+    DMA_InitTypeDef DMA_InitStruct;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    // The RX stream is also that of SPI3 in SPI_DMA_MODE; a driver initialized again keeps its streams
+    if (!Lin_Initialized && Dma_ClaimStreams(LIN_RX_DMA_STREAM, LIN_TX_DMA_STREAM) != E_OK) {
+        return E_NOT_OK;
+    }
+    Lin_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Lin_Config;
+    Lin_Initialized = 0;
+    Lin_FrameState = LIN_FRAME_IDLE;
+    Lin_CurrentFrame = LIN_NO_FRAME;
+    Lin_Status = LIN_OPERATIONAL;
+    Lin_Schedule = LIN_NO_SCHEDULE;
+    Lin_SwitchPending = 0;
+    Lin_TimerRunning = 0;
+    memset(Lin_FrameData, 0, sizeof(Lin_FrameData));
+    for (uint8_t i = 0; i < LIN_NUM_FRAMES; i++) {
+        Lin_FrameStatus[i] = LIN_OPERATIONAL;
+    }
+    memset(&Lin_Stats, 0, sizeof(Lin_Stats));
+
+    RCC_AHB1PeriphClockCmd(LIN_DMA_CLOCK, ENABLE);
+    LIN_USART_CLOCK_CMD(LIN_USART_CLOCK, ENABLE);
+    RCC_APB1PeriphClockCmd(LIN_TIMER_CLOCK, ENABLE);
+
+    USART_DeInit(LIN_USART);
+    USART_InitStruct.USART_BaudRate = LIN_BAUDRATE;
+    USART_InitStruct.USART_WordLength = USART_WordLength_8b;
+    USART_InitStruct.USART_StopBits = USART_StopBits_1;
+    USART_InitStruct.USART_Parity = USART_Parity_No;
+    USART_InitStruct.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
+    USART_InitStruct.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_Init(LIN_USART, &USART_InitStruct);
+    USART_LINBreakDetectLengthConfig(LIN_USART, USART_LINBreakDetectLength_11b);
+    USART_LINCmd(LIN_USART, ENABLE);
+    USART_DMACmd(LIN_USART, USART_DMAReq_Tx | USART_DMAReq_Rx, ENABLE);
+    USART_ITConfig(LIN_USART, USART_IT_LBD, ENABLE);
+    USART_Cmd(LIN_USART, ENABLE);
+
+    // Byte by byte between the buffers and the data register, the lengths are set per frame
+    DMA_DeInit(LIN_TX_DMA_STREAM);
+    DMA_DeInit(LIN_RX_DMA_STREAM);
+    DMA_InitStruct.DMA_Channel = LIN_DMA_CHANNEL;
+    DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&LIN_USART->DR;
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Lin_TxBuffer;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStruct.DMA_BufferSize = 1;
+    DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStruct.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStruct.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+    DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(LIN_TX_DMA_STREAM, &DMA_InitStruct);
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Lin_RxBuffer;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_Init(LIN_RX_DMA_STREAM, &DMA_InitStruct);
+
+    // ARR is written for each slot and takes effect at once: no preload
+    TIM_DeInit(LIN_TIMER);
+    TIM_TimeBaseInitStruct.TIM_Prescaler = (uint16_t)LIN_TIMER_PRESCALER;
+    TIM_TimeBaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInitStruct.TIM_Period = 0xFFFFu;
+    TIM_TimeBaseInitStruct.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseInitStruct.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(LIN_TIMER, &TIM_TimeBaseInitStruct);
+    // The update loading the prescaler also sets the flag
+    TIM_ClearFlag(LIN_TIMER, TIM_FLAG_Update);
+    TIM_ITConfig(LIN_TIMER, TIM_IT_Update, ENABLE);
+
+    NVIC_InitStruct.NVIC_IRQChannel = LIN_TIMER_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStruct);
+    NVIC_InitStruct.NVIC_IRQChannel = LIN_USART_IRQn;
+    NVIC_Init(&NVIC_InitStruct);
+
+    Lin_Initialized = 1;
+    return E_OK;
+}
+
+/*
+* Function: Lin_DeInit
+* Description: Stops the schedule, the timer and the USART; a frame on the bus is abandoned.
+* Input: None
+* Output: None
+*/
+void Lin_DeInit(void) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (!Lin_Initialized) {
+        return;
+    }
+    Lin_Initialized = 0;
+    TIM_Cmd(LIN_TIMER, DISABLE);
+    TIM_ITConfig(LIN_TIMER, TIM_IT_Update, DISABLE);
+    DMA_Cmd(LIN_RX_DMA_STREAM, DISABLE);
+    DMA_Cmd(LIN_TX_DMA_STREAM, DISABLE);
+    Dma_ReleaseStreams(LIN_RX_DMA_STREAM, LIN_TX_DMA_STREAM);
+    USART_ITConfig(LIN_USART, USART_IT_LBD, DISABLE);
+    USART_Cmd(LIN_USART, DISABLE);
+
+    NVIC_InitStruct.NVIC_IRQChannel = LIN_TIMER_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = DISABLE;
+    NVIC_Init(&NVIC_InitStruct);
+    NVIC_InitStruct.NVIC_IRQChannel = LIN_USART_IRQn;
+    NVIC_Init(&NVIC_InitStruct);
+
+    Lin_FrameState = LIN_FRAME_IDLE;
+    Lin_Schedule = LIN_NO_SCHEDULE;
+    Lin_SwitchPending = 0;
+    Lin_TimerRunning = 0;
+}
+
+/*
+* Function: Lin_SendFrame
+* Description: Sends a frame outside any schedule; a frame still on the bus is abandoned. Its
+*   result is read with Lin_GetStatus, at the latest after the longest time of the frame.
+* Input:
+*   - Channel: LIN_CHANNEL_0.
+*   - PduInfoPtr: Frame. The data of a master response are copied.
+* Output:
+*   - E_OK: If the frame is started.
+*   - E_NOT_OK: If a schedule runs or the frame is invalid.
+*/
+Std_ReturnType Lin_SendFrame(Lin_ChannelType Channel, const Lin_PduType* PduInfoPtr) {
+    SchM_StateType state;
+
+    if (!Lin_Initialized || Channel >= LIN_MAX_CHANNEL || PduInfoPtr == NULL || PduInfoPtr->Dl == 0 ||
+        PduInfoPtr->Dl > LIN_MAX_DATA || (PduInfoPtr->Drc == LIN_MASTER_RESPONSE && PduInfoPtr->SduPtr == NULL)) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Lin_Schedule != LIN_NO_SCHEDULE || Lin_SwitchPending) {
+        SchM_Exit(state);
+        return E_NOT_OK;
+    }
+    if (PduInfoPtr->Drc == LIN_MASTER_RESPONSE) {
+        memcpy(Lin_SduBuffer, PduInfoPtr->SduPtr, PduInfoPtr->Dl);
+    }
+    Lin_CurrentFrame = LIN_NO_FRAME;
+    Lin_StartFrame(PduInfoPtr->Pid, PduInfoPtr->Cs, PduInfoPtr->Drc, PduInfoPtr->Dl, Lin_SduBuffer);
+    Lin_StartTimer(LIN_FRAME_MAX_TICKS(PduInfoPtr->Dl));
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Lin_GetStatus
+* Description: State of the channel and result of its last frame. A frame of Lin_SendFrame whose
+*   bytes are all read back is ended here, without waiting for the timer.
+* Input:
+*   - Channel: LIN_CHANNEL_0.
+*   - Lin_SduPtr: Receives the data of a slave response for LIN_RX_OK, valid until the next
+*     Lin_SendFrame; NULL if unused.
+* Output:
+*   - Status of the channel.
+*/
+Lin_StatusType Lin_GetStatus(Lin_ChannelType Channel, uint8_t** Lin_SduPtr) {
+    SchM_StateType state;
+    Lin_StatusType status;
+
+    if (!Lin_Initialized || Channel >= LIN_MAX_CHANNEL) {
+        return LIN_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Lin_FrameState == LIN_FRAME_RECEIVING && Lin_CurrentFrame == LIN_NO_FRAME &&
+        DMA_GetCurrDataCounter(LIN_RX_DMA_STREAM) == 0) {
+        Lin_EndFrame(Lin_Evaluate());
+    }
+    status = Lin_Status;
+    SchM_Exit(state);
+    if (status == LIN_RX_OK && Lin_SduPtr != NULL) {
+        *Lin_SduPtr = Lin_SduBuffer;
+    }
+    return status;
+}
+
+/*
+* Function: Lin_StartSchedule
+* Description: Runs a schedule table in a loop from its first entry: at once when the channel is
+*   idle, otherwise at the end of the current slot.
+* Input:
+*   - Channel: LIN_CHANNEL_0.
+*   - Schedule: Schedule of LIN_SCHEDULES.
+* Output:
+*   - E_OK: If the schedule is started or will be.
+*   - E_NOT_OK: If the driver is not initialized or the schedule is invalid.
+*/
+Std_ReturnType Lin_StartSchedule(Lin_ChannelType Channel, Lin_ScheduleType Schedule) {
+    SchM_StateType state;
+
+    if (!Lin_Initialized || Channel >= LIN_MAX_CHANNEL || Schedule >= LIN_NUM_SCHEDULES) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Lin_TimerRunning) {
+        Lin_NextSchedule = Schedule;
+        Lin_SwitchPending = 1;
+    } else {
+        Lin_Schedule = Schedule;
+        Lin_Entry = 0;
+        Lin_Stats.scheduleSwitches++;
+        Lin_StartTimer(Lin_ActiveConfig->schedules[Schedule].entries[0].ticks);
+        Lin_StartSlot();
+    }
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Lin_StopSchedule
+* Description: Stops the schedule at the end of the current slot, its frame ended as usual.
+* Input:
+*   - Channel: LIN_CHANNEL_0.
+* Output:
+*   - E_OK: If no schedule runs after the current slot.
+*   - E_NOT_OK: If the driver is not initialized.
+*/
+Std_ReturnType Lin_StopSchedule(Lin_ChannelType Channel) {
+    SchM_StateType state;
+
+    if (!Lin_Initialized || Channel >= LIN_MAX_CHANNEL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Lin_TimerRunning) {
+        Lin_NextSchedule = LIN_NO_SCHEDULE;
+        Lin_SwitchPending = 1;
+    }
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Lin_WriteFrame
+* Description: Sets the data of a master response, sent from the next slot of the frame on.
+* Input:
+*   - Frame: Frame of LIN_FRAMES.
+*   - Data: Its data bytes.
+* Output:
+*   - E_OK: If the data are set.
+*   - E_NOT_OK: If the frame is invalid or a slave response.
+*/
+Std_ReturnType Lin_WriteFrame(Lin_FrameType Frame, const uint8_t* Data) {
+    SchM_StateType state;
+
+    if (!Lin_Initialized || Frame >= LIN_NUM_FRAMES || Data == NULL ||
+        Lin_ActiveConfig->frames[Frame].drc != LIN_MASTER_RESPONSE) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    memcpy(Lin_FrameData[Frame], Data, Lin_ActiveConfig->frames[Frame].length);
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Lin_ReadFrame
+* Description: Copies the data of a frame: the last slave response received with its checksum, or
+*   the master response set by Lin_WriteFrame.
+* Input:
+*   - Frame: Frame of LIN_FRAMES.
+*   - Data: Receives its data bytes; NULL to read the status only.
+* Output:
+*   - Result of the last slot of the frame, LIN_OPERATIONAL if it was not sent yet, LIN_NOT_OK if
+*     the frame is invalid.
+*/
+Lin_StatusType Lin_ReadFrame(Lin_FrameType Frame, uint8_t* Data) {
+    SchM_StateType state;
+    Lin_StatusType status;
+
+    if (!Lin_Initialized || Frame >= LIN_NUM_FRAMES) {
+        return LIN_NOT_OK;
+    }
+    SchM_Enter(state);
+    if (Data != NULL) {
+        memcpy(Data, Lin_FrameData[Frame], Lin_ActiveConfig->frames[Frame].length);
+    }
+    status = Lin_FrameStatus[Frame];
+    SchM_Exit(state);
+    return status;
+}
+
+/*
+* Function: Lin_GetStats
+* Description: Copies the counters of the driver.
+* Input:
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters are copied.
+*   - E_NOT_OK: If StatsPtr is NULL.
+*/
+Std_ReturnType Lin_GetStats(Lin_StatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = Lin_Stats;
+    SchM_Exit(state);
+    return E_OK;
+}
@@ -0,0 +1,34 @@
+/*
+* File: Lin_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Frames and schedule tables of the LIN driver, from the lists of Lin_Cfg.h.
+*/
+
+#include "Lin.h"
+
+#define LIN_FRAME(name, id, cs, drc, length) \
+    { (id), (cs), (drc), (length) },
+
+const Lin_FrameConfigType Lin_FrameConfig[LIN_NUM_FRAMES] = {
+    LIN_FRAMES(LIN_FRAME)
+};
+
+#define LIN_ENTRY(frame, ms) \
+    { (frame), (uint16_t)((ms) * LIN_TIMER_TICKS_PER_MS) },
+#define LIN_SCHEDULE_ENTRIES(name, entries) \
+    static const Lin_ScheduleEntryType name##_Entries[] = { entries(LIN_ENTRY) };
+
+LIN_SCHEDULES(LIN_SCHEDULE_ENTRIES)
+
+#define LIN_SCHEDULE(name, entries) \
+    { name##_Entries, (uint8_t)(sizeof(name##_Entries) / sizeof(name##_Entries[0])) },
+
+const Lin_ScheduleConfigType Lin_ScheduleConfig[LIN_NUM_SCHEDULES] = {
+    LIN_SCHEDULES(LIN_SCHEDULE)
+};
+
+// No notification: the application reads the frames with Lin_ReadFrame
+const Lin_ConfigType Lin_Config = {
+    Lin_FrameConfig, Lin_ScheduleConfig, NULL
+};
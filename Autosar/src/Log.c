@@ -0,0 +1,313 @@
+/*
+* File: Log.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Log.h. Producers reserve space in the ring with a compare-and-swap on
+* the head index and publish a record by writing its header last; the consumer, run from
+* Log_MainFunction and from the DMA interrupt, sends the published records to the USART by DMA
+* and frees their space when the transfer is complete.
+*/
+
+#include "Log.h"
+#include "SchM.h"
+#include <stdint.h>
+
+#define LOG_RING_MASK       (LOG_RING_WORDS - 1u)
+
+// Argument count of a record header
+#define LOG_HEADER_ARGC(header) (((header) >> 16) & 0xFFu)
+
+static volatile uint32_t Log_Ring[LOG_RING_WORDS];  // Records, a zero word marks a record not yet published
+static volatile uint32_t Log_Head;                  // Words reserved by the producers, free-running
+static volatile uint32_t Log_Tail;                  // Words sent and freed by the consumer, free-running
+static uint32_t Log_Scan;                           // End of the published records found by the consumer
+static uint32_t Log_Sending;                        // Words of the DMA transfer in progress, 0 when idle
+static volatile uint32_t Log_Dropped;               // Records lost since the last LOG_ID_DROPPED report
+static uint8_t Log_Initialized;
+
+/*
+* Function: Log_AtomicAdd
+* Description: Adds a value to a counter shared by tasks and interrupt handlers without masking
+*   interrupts.
+* Input:
+*   - Counter: Counter to update.
+*   - Value: Value to add, two's complement to subtract.
+* Output: None
+*/
+static void Log_AtomicAdd(volatile uint32_t* Counter, uint32_t Value) {
+    uint32_t old;
+
+    do {
+        old = *Counter;
+    } while (!SchM_CompareAndSwap(Counter, old, old + Value));
+}
+
+/*
+* Function: Log_StartTransfer
+* Description: Collects the records published after the last transfer and hands the contiguous
+*   part of them to the DMA. Does nothing while a transfer is in progress. Called with interrupts
+*   masked or from the DMA interrupt.
+* Input: None
+* Output: None
+*/
+static void Log_StartTransfer(void) {
+    uint32_t header;
+    uint32_t start;
+    uint32_t count;
+
+    if (Log_Sending != 0) {
+        return;
+    }
+
+    // Records are published in any order, they are sent in reservation order
+    while (Log_Scan != Log_Head && (header = Log_Ring[Log_Scan & LOG_RING_MASK]) != 0) {
+        Log_Scan += LOG_HEADER_WORDS + LOG_HEADER_ARGC(header);
+    }
+    if (Log_Scan == Log_Tail) {
+        return;
+    }
+
+    // A transfer stops at the end of the ring, the rest follows in the next one
+    start = Log_Tail & LOG_RING_MASK;
+    count = Log_Scan - Log_Tail;
+    if (count > LOG_RING_WORDS - start) {
+        count = LOG_RING_WORDS - start;
+    }
+    Log_Sending = count;
+
+    DMA_ClearFlag(LOG_DMA_STREAM, LOG_DMA_FLAGS);
+    DMA_MemoryTargetConfig(LOG_DMA_STREAM, (uint32_t)(uintptr_t)&Log_Ring[start], DMA_Memory_0);
+    DMA_SetCurrDataCounter(LOG_DMA_STREAM, (uint16_t)(count * sizeof(uint32_t)));
+    DMA_Cmd(LOG_DMA_STREAM, ENABLE);
+}
+
+/*
+* Function: Log_ReleaseTransfer
+* Description: Frees the words of the completed transfer: clears them so the consumer can tell
+*   published records from reserved ones, then gives the space back to the producers.
+* Input: None
+* Output: None
+*/
+static void Log_ReleaseTransfer(void) {
+    uint32_t start = Log_Tail & LOG_RING_MASK;
+
+    for (uint32_t i = 0; i < Log_Sending; i++) {
+        Log_Ring[start + i] = 0;
+    }
+    SchM_MemoryBarrier();
+    Log_Tail += Log_Sending;
+    Log_Sending = 0;
+}
+
+/*
+* Function: LOG_DMA_IRQHandler
+* Description: End of a DMA transfer to the USART: frees the words sent and starts sending the
+*   records published meanwhile. A transfer error loses the records of the transfer.
+* Input: None
+* Output: None
+*/
+void LOG_DMA_IRQHandler(void) {
+    if (DMA_GetFlagStatus(LOG_DMA_STREAM, LOG_DMA_DONE_FLAGS) == RESET) {
+        return;
+    }
+    DMA_Cmd(LOG_DMA_STREAM, DISABLE);
+    DMA_ClearFlag(LOG_DMA_STREAM, LOG_DMA_FLAGS);
+    Log_ReleaseTransfer();
+    Log_StartTransfer();
+}
+
+/*
+* Function: Log_Init
+* Description: Initializes the log ring, the output USART (8N1, TX only) and the DMA stream
+*   draining the ring into it. The TX pin is configured by the application.
+* Input: None
+* Output:
+*   - E_OK: If initialization is successful.
+*/
+Std_ReturnType Log_Init(void) {
+    USART_InitTypeDef USART_InitStruct;
+    DMA_InitTypeDef DMA_InitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    // Timestamps of the records
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Log_Initialized = 0;
+    RCC_AHB1PeriphClockCmd(LOG_DMA_CLOCK, ENABLE);
+    LOG_USART_CLOCK_CMD(LOG_USART_CLOCK, ENABLE);
+    DMA_DeInit(LOG_DMA_STREAM);
+
+    for (uint32_t i = 0; i < LOG_RING_WORDS; i++) {
+        Log_Ring[i] = 0;
+    }
+    Log_Head = 0;
+    Log_Tail = 0;
+    Log_Scan = 0;
+    Log_Sending = 0;
+    Log_Dropped = 0;
+
+    USART_InitStruct.USART_BaudRate = LOG_USART_BAUDRATE;
+    USART_InitStruct.USART_WordLength = USART_WordLength_8b;
+    USART_InitStruct.USART_StopBits = USART_StopBits_1;
+    USART_InitStruct.USART_Parity = USART_Parity_No;
+    USART_InitStruct.USART_Mode = USART_Mode_Tx;
+    USART_InitStruct.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_Init(LOG_USART, &USART_InitStruct);
+    USART_DMACmd(LOG_USART, USART_DMAReq_Tx, ENABLE);
+    USART_Cmd(LOG_USART, ENABLE);
+
+    // Memory to USART data register byte by byte, the address and length are set per transfer
+    DMA_InitStruct.DMA_Channel = LOG_DMA_CHANNEL;
+    DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&LOG_USART->DR;
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Log_Ring;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStruct.DMA_BufferSize = 1;
+    DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStruct.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStruct.DMA_Priority = DMA_Priority_Low;
+    DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+    DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(LOG_DMA_STREAM, &DMA_InitStruct);
+    DMA_ITConfig(LOG_DMA_STREAM, DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+    // Lowest priority: the drivers' interrupts preempt the log drain
+    NVIC_InitStruct.NVIC_IRQChannel = LOG_DMA_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStruct);
+
+    Log_Initialized = 1;
+    return E_OK;
+}
+
+/*
+* Function: Log_Store
+* Description: Reserves the words of a record in the ring and publishes it.
+* Input:
+*   - Id, Argc, Arg0..Arg3: Record, see Log_Write.
+* Output:
+*   - E_OK: If the record is stored.
+*   - E_NOT_OK: If the ring is full.
+*/
+static Std_ReturnType Log_Store(Log_IdType Id, uint8_t Argc, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2, uint32_t Arg3) {
+    uint32_t words = LOG_HEADER_WORDS + Argc;
+    uint32_t head;
+
+    // Reserve the words of the record
+    do {
+        head = Log_Head;
+        if (head + words - Log_Tail > LOG_RING_WORDS) {
+            return E_NOT_OK;
+        }
+    } while (!SchM_CompareAndSwap(&Log_Head, head, head + words));
+
+    Log_Ring[(head + 1u) & LOG_RING_MASK] = DWT->CYCCNT;
+    switch (Argc) {
+        case 4: Log_Ring[(head + 5u) & LOG_RING_MASK] = Arg3;   // fall through
+        case 3: Log_Ring[(head + 4u) & LOG_RING_MASK] = Arg2;   // fall through
+        case 2: Log_Ring[(head + 3u) & LOG_RING_MASK] = Arg1;   // fall through
+        case 1: Log_Ring[(head + 2u) & LOG_RING_MASK] = Arg0;   // fall through
+        default: break;
+    }
+
+    // Publish: the consumer sends a record once its header is set
+    SchM_MemoryBarrier();
+    Log_Ring[head & LOG_RING_MASK] = LOG_HEADER(Id, Argc);
+    return E_OK;
+}
+
+/*
+* Function: Log_Write
+* Description: Stores a log record, without formatting it and without masking interrupts. Can be
+*   called from any task or interrupt handler. When the ring is full the record is dropped and
+*   counted, Log_MainFunction reports the count.
+* Input:
+*   - Id: Message of Log_Cfg.h.
+*   - Argc: Number of arguments of the message, at most LOG_MAX_ARGS.
+*   - Arg0..Arg3: Arguments, the unused ones are ignored.
+* Output:
+*   - E_OK: If the record is stored.
+*   - E_NOT_OK: If the module is not initialized, the parameters are invalid or the ring is full.
+*/
+Std_ReturnType Log_Write(Log_IdType Id, uint8_t Argc, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2, uint32_t Arg3) {
+    if (!Log_Initialized || Id >= LOG_NUM_MESSAGES || Argc > LOG_MAX_ARGS) {
+        return E_NOT_OK;
+    }
+    if (Log_Store(Id, Argc, Arg0, Arg1, Arg2, Arg3) != E_OK) {
+        Log_AtomicAdd(&Log_Dropped, 1);
+        return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+/*
+* Function: Log_MainFunction
+* Description: Reports the records dropped since the last call and starts sending the records
+*   published while the DMA was idle. Called periodically from the main loop.
+* Input: None
+* Output: None
+*/
+void Log_MainFunction(void) {
+    SchM_StateType state;
+    uint32_t dropped;
+
+    if (!Log_Initialized) {
+        return;
+    }
+
+    // A report that does not fit is retried at the next call, it is not counted as dropped
+    dropped = Log_Dropped;
+    if (dropped != 0 && Log_Store(LOG_ID_DROPPED, 1, dropped, 0, 0, 0) == E_OK) {
+        Log_AtomicAdd(&Log_Dropped, (uint32_t)-dropped);
+    }
+
+    SchM_Enter(state);
+    Log_StartTransfer();
+    SchM_Exit(state);
+}
+
+/*
+* Function: Log_Flush
+* Description: Sends every published record and waits until the last byte has left the USART,
+*   for example before a reset. Interrupts must not be masked by the caller.
+* Input: None
+* Output: None
+*/
+void Log_Flush(void) {
+    SchM_StateType state;
+
+    if (!Log_Initialized) {
+        return;
+    }
+
+    Log_MainFunction();
+    SchM_Enter(state);
+    while (Log_Sending != 0) {
+        // The DMA interrupt runs between exit and enter and chains the remaining transfers
+        SchM_WaitForInterrupt();
+        SchM_Exit(state);
+        SchM_Enter(state);
+    }
+    SchM_Exit(state);
+
+    while (USART_GetFlagStatus(LOG_USART, USART_FLAG_TC) == RESET) {
+    }
+}
+
+/*
+* Function: Log_GetDropped
+* Description: Returns the number of records dropped and not yet reported.
+* Input: None
+* Output:
+*   - Number of dropped records.
+*/
+uint32_t Log_GetDropped(void) {
+    return Log_Dropped;
+}
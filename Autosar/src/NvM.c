@@ -0,0 +1,411 @@
+/*
+* File: NvM.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for NvM.h containing the implementation of the NVM module. The queue holds
+* the pending requests of the blocks in order of priority, those of equal priority in order of
+* arrival; since a block has at most one pending request, it never holds more entries than blocks.
+* NvM_MainFunction starts the first request due, or else the next block of NvM_ReadAll or
+* NvM_WriteAll, and ends it once the FEE module has. The FEE block holds the data padded to words,
+* then its CRC-32; the CRC of the data last read or written is kept to skip the writes of unchanged
+* data.
+*/
+
+#include "NvM.h"
+#include <string.h>
+
+// Kind of a request
+typedef enum {
+    NVM_JOB_NONE,
+    NVM_JOB_READ,
+    NVM_JOB_WRITE
+} NvM_JobKindType;
+
+// State of a block
+typedef struct {
+    NvM_RequestResultType result;
+    NvM_JobKindType queued;                 // Request in the queue
+    uint16_t due;                           // Call of NvM_MainFunction from which a write may start
+    const uint8_t* source;                  // Data of the queued write
+    uint8_t* target;                        // Buffer of the queued read
+    uint32_t crc;                           // CRC of the block in flash, if crcKnown
+    uint8_t crcKnown;
+} NvM_BlockStateType;
+
+static const NvM_ConfigType* NvM_ActiveConfig;
+static uint8_t NvM_Initialized;
+static uint16_t NvM_Tick;                   // Calls of NvM_MainFunction
+
+// Index 0 is NvM_ReadAll and NvM_WriteAll
+static NvM_BlockStateType NvM_BlockState[NVM_MAX_BLOCKS + 1u];
+static NvM_BlockIdType NvM_Queue[NVM_MAX_BLOCKS];
+static uint16_t NvM_QueueCount;
+
+// Request handed to the FEE module
+static NvM_BlockIdType NvM_CurrentBlock;    // 0 if none
+static NvM_JobKindType NvM_CurrentKind;
+static uint8_t* NvM_CurrentTarget;
+static uint32_t NvM_CurrentCrc;
+static uint8_t NvM_CurrentMulti;            // Part of NvM_ReadAll or NvM_WriteAll
+
+// NvM_ReadAll or NvM_WriteAll in progress
+static NvM_JobKindType NvM_MultiKind;
+static NvM_BlockIdType NvM_MultiNext;
+static uint8_t NvM_MultiFailed;
+
+// Data and CRC of the FEE block
+static uint32_t NvM_Buffer[NVM_MAX_BLOCK_LENGTH / 4u + 1u];
+
+/*
+* Function: NvM_Words
+* Description: Computes the words of the data of a block.
+* Input:
+*   - Block: Descriptor of the block.
+* Output: Length rounded up to words, in words.
+*/
+static uint32_t NvM_Words(const NvM_BlockDescriptorType* Block) {
+    return (Block->length + 3u) / 4u;
+}
+
+/*
+* Function: NvM_Crc
+* Description: Computes the CRC of the data in NvM_Buffer with the CRC unit.
+* Input:
+*   - Block: Descriptor of the block.
+* Output: CRC-32 of the words of the data.
+*/
+static uint32_t NvM_Crc(const NvM_BlockDescriptorType* Block) {
+    CRC_ResetDR();
+    return CRC_CalcBlockCRC(NvM_Buffer, NvM_Words(Block));
+}
+
+/*
+* Function: NvM_Enqueue
+* Description: Queues a request after those of higher or equal priority. A write of a block whose
+*   write is already queued is merged with it.
+* Input:
+*   - BlockId: Block of the request.
+*   - Kind: NVM_JOB_READ or NVM_JOB_WRITE.
+*   - Source: Data of a write.
+*   - Target: Buffer of a read.
+* Output: E_OK if the request is queued or merged, E_NOT_OK if another request of the block is queued.
+*/
+static Std_ReturnType NvM_Enqueue(NvM_BlockIdType BlockId, NvM_JobKindType Kind, const uint8_t* Source, uint8_t* Target) {
+    const NvM_BlockDescriptorType* block = &NvM_ActiveConfig->blocks[BlockId - 1u];
+    NvM_BlockStateType* state = &NvM_BlockState[BlockId];
+    uint16_t i = NvM_QueueCount;
+
+    if (state->queued != NVM_JOB_NONE) {
+        if (state->queued != NVM_JOB_WRITE || Kind != NVM_JOB_WRITE) {
+            return E_NOT_OK;
+        }
+        state->source = Source;
+        return E_OK;
+    }
+    while (i > 0 && NvM_ActiveConfig->blocks[NvM_Queue[i - 1u] - 1u].priority > block->priority) {
+        NvM_Queue[i] = NvM_Queue[i - 1u];
+        i--;
+    }
+    NvM_Queue[i] = BlockId;
+    NvM_QueueCount++;
+    state->queued = Kind;
+    state->due = NvM_Tick;
+    if (Kind == NVM_JOB_WRITE && block->priority != NVM_PRIORITY_IMMEDIATE) {
+        state->due += (uint16_t)((block->writeDelay + NVM_MAIN_FUNCTION_PERIOD_MS - 1u) / NVM_MAIN_FUNCTION_PERIOD_MS);
+    }
+    state->source = Source;
+    state->target = Target;
+    state->result = NVM_REQ_PENDING;
+    return E_OK;
+}
+
+/*
+* Function: NvM_Finish
+* Description: Sets the result of a request of a block, unless another one is queued.
+* Input:
+*   - BlockId: Block of the request.
+*   - Result: Result of the request.
+* Output: None
+*/
+static void NvM_Finish(NvM_BlockIdType BlockId, NvM_RequestResultType Result) {
+    NvM_BlockStateType* state = &NvM_BlockState[BlockId];
+
+    if (state->queued == NVM_JOB_NONE) {
+        state->result = Result;
+    }
+    if (NvM_CurrentMulti && (Result == NVM_REQ_NOT_OK || Result == NVM_REQ_INTEGRITY_FAILED)) {
+        NvM_MultiFailed = 1;
+    }
+}
+
+/*
+* Function: NvM_Start
+* Description: Hands a request to the FEE module. A write whose data has the CRC of the block in
+*   flash ends at once.
+* Input:
+*   - BlockId: Block of the request.
+*   - Kind: NVM_JOB_READ or NVM_JOB_WRITE.
+*   - Source: Data of a write.
+*   - Target: Buffer of a read.
+* Output: None
+*/
+static void NvM_Start(NvM_BlockIdType BlockId, NvM_JobKindType Kind, const uint8_t* Source, uint8_t* Target) {
+    const NvM_BlockDescriptorType* block = &NvM_ActiveConfig->blocks[BlockId - 1u];
+    NvM_BlockStateType* state = &NvM_BlockState[BlockId];
+    uint32_t words = NvM_Words(block);
+    Std_ReturnType accepted;
+
+    if (Kind == NVM_JOB_READ) {
+        accepted = Fee_Read(block->feeBlockNumber, 0, (uint8_t*)NvM_Buffer, (uint16_t)((words + block->useCrc) * 4u));
+    } else {
+        NvM_Buffer[words - 1u] = 0;
+        memcpy(NvM_Buffer, Source, block->length);
+        NvM_CurrentCrc = block->useCrc ? NvM_Crc(block) : 0;
+        if (block->useCrc && state->crcKnown && state->crc == NvM_CurrentCrc) {
+            NvM_Finish(BlockId, NVM_REQ_OK);
+            return;
+        }
+        NvM_Buffer[words] = NvM_CurrentCrc;
+        accepted = Fee_Write(block->feeBlockNumber, (const uint8_t*)NvM_Buffer);
+    }
+    if (accepted != E_OK) {
+        NvM_Finish(BlockId, NVM_REQ_NOT_OK);
+        return;
+    }
+    NvM_CurrentBlock = BlockId;
+    NvM_CurrentKind = Kind;
+    NvM_CurrentTarget = Target;
+}
+
+/*
+* Function: NvM_End
+* Description: Ends the request handed to the FEE module: checks the CRC of the data read and copies
+*   it, or the default data if the block could not be read.
+* Input:
+*   - Result: Result of the FEE job.
+* Output: None
+*/
+static void NvM_End(MemIf_JobResultType Result) {
+    NvM_BlockIdType id = NvM_CurrentBlock;
+    const NvM_BlockDescriptorType* block = &NvM_ActiveConfig->blocks[id - 1u];
+    NvM_BlockStateType* state = &NvM_BlockState[id];
+    NvM_RequestResultType result = NVM_REQ_NOT_OK;
+
+    NvM_CurrentBlock = 0;
+    state->crcKnown = 0;
+    if (NvM_CurrentKind == NVM_JOB_WRITE) {
+        if (Result == MEMIF_JOB_OK) {
+            state->crc = NvM_CurrentCrc;
+            state->crcKnown = block->useCrc;
+            result = NVM_REQ_OK;
+        }
+        NvM_Finish(id, result);
+        return;
+    }
+    if (Result == MEMIF_JOB_OK) {
+        uint32_t words = NvM_Words(block);
+        uint32_t crc = block->useCrc ? NvM_Crc(block) : 0;
+        if (block->useCrc && crc != NvM_Buffer[words]) {
+            result = NVM_REQ_INTEGRITY_FAILED;
+        } else {
+            memcpy(NvM_CurrentTarget, NvM_Buffer, block->length);
+            state->crc = crc;
+            state->crcKnown = block->useCrc;
+            result = NVM_REQ_OK;
+        }
+    } else if (Result == MEMIF_BLOCK_INVALID) {
+        result = NVM_REQ_NV_INVALIDATED;
+    } else if (Result == MEMIF_BLOCK_INCONSISTENT) {
+        result = NVM_REQ_INTEGRITY_FAILED;
+    }
+    if (result != NVM_REQ_OK && block->romBlock != NULL) {
+        memcpy(NvM_CurrentTarget, block->romBlock, block->length);
+        result = NVM_REQ_RESTORED_FROM_ROM;
+    }
+    NvM_Finish(id, result);
+}
+
+/*
+* Function: NvM_StartNext
+* Description: Starts the first request of the queue that is due, or else the next block of
+*   NvM_ReadAll or NvM_WriteAll, and ends NvM_ReadAll or NvM_WriteAll after its last block.
+* Input: None
+* Output: 1 if a request was started or ended, 0 if there is nothing to do yet.
+*/
+static uint8_t NvM_StartNext(void) {
+    for (uint16_t i = 0; i < NvM_QueueCount; i++) {
+        NvM_BlockIdType id = NvM_Queue[i];
+        NvM_BlockStateType* state = &NvM_BlockState[id];
+        if (state->queued == NVM_JOB_READ || (int16_t)(NvM_Tick - state->due) >= 0) {
+            NvM_JobKindType kind = state->queued;
+            NvM_QueueCount--;
+            memmove(&NvM_Queue[i], &NvM_Queue[i + 1u], (NvM_QueueCount - i) * sizeof(NvM_Queue[0]));
+            state->queued = NVM_JOB_NONE;
+            NvM_CurrentMulti = 0;
+            NvM_Start(id, kind, state->source, state->target);
+            return 1;
+        }
+    }
+    if (NvM_MultiKind == NVM_JOB_NONE) {
+        return 0;
+    }
+    if (NvM_MultiNext > NvM_ActiveConfig->numBlocks) {
+        NvM_MultiKind = NVM_JOB_NONE;
+        NvM_BlockState[0].result = NvM_MultiFailed ? NVM_REQ_NOT_OK : NVM_REQ_OK;
+        if (NvM_ActiveConfig->multiBlockNotification != NULL) {
+            NvM_ActiveConfig->multiBlockNotification();
+        }
+        return 0;
+    }
+
+    NvM_BlockIdType id = NvM_MultiNext++;
+    const NvM_BlockDescriptorType* block = &NvM_ActiveConfig->blocks[id - 1u];
+    NvM_BlockStateType* state = &NvM_BlockState[id];
+    if (!block->selectAll || block->ramBlock == NULL) {
+        NvM_CurrentMulti = 0;
+        NvM_Finish(id, NVM_REQ_BLOCK_SKIPPED);
+    } else if (state->queued == NVM_JOB_WRITE && NvM_MultiKind == NVM_JOB_WRITE) {
+        // Merged with the pending write, started now
+        state->due = NvM_Tick;
+    } else if (state->queued == NVM_JOB_NONE) {
+        NvM_CurrentMulti = 1;
+        NvM_Start(id, NvM_MultiKind, (const uint8_t*)block->ramBlock, (uint8_t*)block->ramBlock);
+    }
+    return 1;
+}
+
+/*
+* Function: NvM_Init
+* Description: Initializes the NVM module and enables the CRC unit. The FEE module must be
+*   initialized.
+* Input:
+*   - ConfigPtr: Configuration, NULL for NvM_Config.
+* Output: None
+*/
+void NvM_Init(const NvM_ConfigType* ConfigPtr) {
+    NvM_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &NvM_Config;
+    NvM_Initialized = 0;
+    if (NvM_ActiveConfig->numBlocks > NVM_MAX_BLOCKS) {
+        return;
+    }
+    for (uint16_t i = 0; i < NvM_ActiveConfig->numBlocks; i++) {
+        if (NvM_ActiveConfig->blocks[i].length == 0 || NvM_ActiveConfig->blocks[i].length > NVM_MAX_BLOCK_LENGTH) {
+            return;
+        }
+    }
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+    memset(NvM_BlockState, 0, sizeof(NvM_BlockState));
+    NvM_QueueCount = 0;
+    NvM_CurrentBlock = 0;
+    NvM_MultiKind = NVM_JOB_NONE;
+    NvM_Initialized = 1;
+}
+
+/*
+* Function: NvM_ReadBlock
+* Description: Queues the read of a block.
+* Input:
+*   - BlockId: Block to read.
+*   - NvM_DstPtr: Buffer receiving the data, NULL for the permanent RAM block.
+* Output: E_OK if the request is queued, E_NOT_OK otherwise.
+*/
+Std_ReturnType NvM_ReadBlock(NvM_BlockIdType BlockId, void* NvM_DstPtr) {
+    if (!NvM_Initialized || BlockId == 0 || BlockId > NvM_ActiveConfig->numBlocks) {
+        return E_NOT_OK;
+    }
+    if (NvM_DstPtr == NULL) {
+        NvM_DstPtr = NvM_ActiveConfig->blocks[BlockId - 1u].ramBlock;
+    }
+    return (NvM_DstPtr != NULL) ? NvM_Enqueue(BlockId, NVM_JOB_READ, NULL, (uint8_t*)NvM_DstPtr) : E_NOT_OK;
+}
+
+/*
+* Function: NvM_WriteBlock
+* Description: Queues the write of a block. The data is taken when the write starts and must stay
+*   valid until then.
+* Input:
+*   - BlockId: Block to write.
+*   - NvM_SrcPtr: Data of the block, NULL for the permanent RAM block.
+* Output: E_OK if the request is queued or merged with the queued write, E_NOT_OK otherwise.
+*/
+Std_ReturnType NvM_WriteBlock(NvM_BlockIdType BlockId, const void* NvM_SrcPtr) {
+    if (!NvM_Initialized || BlockId == 0 || BlockId > NvM_ActiveConfig->numBlocks) {
+        return E_NOT_OK;
+    }
+    if (NvM_SrcPtr == NULL) {
+        NvM_SrcPtr = NvM_ActiveConfig->blocks[BlockId - 1u].ramBlock;
+    }
+    return (NvM_SrcPtr != NULL) ? NvM_Enqueue(BlockId, NVM_JOB_WRITE, (const uint8_t*)NvM_SrcPtr, NULL) : E_NOT_OK;
+}
+
+/*
+* Function: NvM_ReadAll
+* Description: Reads the selected blocks into their RAM blocks, after the queued requests. Ignored
+*   while NvM_ReadAll or NvM_WriteAll is in progress.
+* Input: None
+* Output: None
+*/
+void NvM_ReadAll(void) {
+    if (NvM_Initialized && NvM_MultiKind == NVM_JOB_NONE) {
+        NvM_MultiKind = NVM_JOB_READ;
+        NvM_MultiNext = 1;
+        NvM_MultiFailed = 0;
+        NvM_BlockState[0].result = NVM_REQ_PENDING;
+    }
+}
+
+/*
+* Function: NvM_WriteAll
+* Description: Writes the RAM blocks of the selected blocks, after the queued requests; the pending
+*   writes of these blocks are started without their delay instead, and the blocks whose data has the
+*   CRC of the block in flash are not written. Ignored while NvM_ReadAll or NvM_WriteAll is in
+*   progress.
+* Input: None
+* Output: None
+*/
+void NvM_WriteAll(void) {
+    if (NvM_Initialized && NvM_MultiKind == NVM_JOB_NONE) {
+        NvM_MultiKind = NVM_JOB_WRITE;
+        NvM_MultiNext = 1;
+        NvM_MultiFailed = 0;
+        NvM_BlockState[0].result = NVM_REQ_PENDING;
+    }
+}
+
+/*
+* Function: NvM_GetErrorStatus
+* Description: Returns the result of the last request of a block.
+* Input:
+*   - BlockId: Block, 0 for NvM_ReadAll and NvM_WriteAll.
+*   - RequestResultPtr: Receives the result.
+* Output: E_OK, or E_NOT_OK if the block is not configured.
+*/
+Std_ReturnType NvM_GetErrorStatus(NvM_BlockIdType BlockId, NvM_RequestResultType* RequestResultPtr) {
+    if (!NvM_Initialized || BlockId > NvM_ActiveConfig->numBlocks || RequestResultPtr == NULL) {
+        return E_NOT_OK;
+    }
+    *RequestResultPtr = NvM_BlockState[BlockId].result;
+    return E_OK;
+}
+
+/*
+* Function: NvM_MainFunction
+* Description: Ends the request handed to the FEE module once it has ended it, then starts the next
+*   one. Called after Fee_MainFunction.
+* Input: None
+* Output: None
+*/
+void NvM_MainFunction(void) {
+    if (!NvM_Initialized) {
+        return;
+    }
+    NvM_Tick++;
+    if (NvM_CurrentBlock != 0) {
+        if (Fee_GetStatus() == MEMIF_BUSY) {
+            return;
+        }
+        NvM_End(Fee_GetJobResult());
+    }
+    while (NvM_CurrentBlock == 0 && NvM_StartNext()) {
+    }
+}
@@ -0,0 +1,22 @@
+/*
+* File: NvM_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Blocks of the NVM module.
+*/
+
+#include "NvM.h"
+
+// Calibration used until one is stored
+static const uint8_t NvM_RomCalibration[64] = { 0 };
+
+const NvM_BlockDescriptorType NvM_BlockDescriptor[NVM_NUM_BLOCKS] = {
+    /* feeBlockNumber, length, priority, useCrc, selectAll, writeDelay (ms), ramBlock, romBlock */
+    { FEE_BLOCK_BOOT_COUNT, 4u, NVM_PRIORITY_IMMEDIATE, 1u, 1u, 0u, &App_BootCount, NULL },   /* NVM_BLOCK_BOOT_COUNT */
+    { FEE_BLOCK_CALIBRATION, 64u, 10u, 1u, 1u, 0u, App_Calibration, NvM_RomCalibration },     /* NVM_BLOCK_CALIBRATION */
+    { FEE_BLOCK_DTC, 128u, 20u, 1u, 1u, 5000u, App_Dtc, NULL },                                /* NVM_BLOCK_DTC */
+};
+
+const NvM_ConfigType NvM_Config = {
+    NvM_BlockDescriptor, NVM_NUM_BLOCKS, NvMJob_MultiBlockNotification
+};
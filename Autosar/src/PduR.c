@@ -0,0 +1,247 @@
+/*
+* File: PduR.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for PduR.h containing the implementation of the PDU router.
+*/
+
+#include "PduR.h"
+#include "Spi.h"
+#include "SchM.h"
+#include <string.h>
+
+#define PDUR_SPI_BUFFER_BYTES   (PDUR_SPI_RECORDS * PDUR_SPI_RECORD_BYTES)
+
+// Buffers of the SPI gateway: one takes the records while the other one is sent
+typedef struct {
+    uint8_t data[2][PDUR_SPI_BUFFER_BYTES];
+    uint8_t records[2];                     // Records in each buffer
+    uint8_t fill;                           // Buffer taking the records
+    uint8_t sending;                        // The other buffer is being sent
+} PduR_SpiGatewayType;
+
+static uint8_t PduR_Initialized;
+static PduR_SpiGatewayType PduR_Spi;
+static PduR_StatsType PduR_Stats;
+
+/*
+* Function: PduR_Init
+* Description: Empties the SPI gateway buffers and clears the counters.
+* Input: None
+* Output: None
+*/
+void PduR_Init(void) {
+    memset(&PduR_Spi, 0, sizeof(PduR_Spi));
+    memset(&PduR_Stats, 0, sizeof(PduR_Stats));
+    PduR_Initialized = 1;
+}
+
+/*
+* Function: PduR_DeInit
+* Description: Stops the router: received frames are dropped.
+* Input: None
+* Output: None
+*/
+void PduR_DeInit(void) {
+    PduR_Initialized = 0;
+}
+
+/*
+* Function: PduR_SpiStart
+* Description: Sends the buffer taking the records when it holds some and the other one is not
+*   being sent; the other one takes the next records. A transfer that cannot start now is started
+*   by the next record or end notification. Called inside an exclusive area.
+* Input: None
+* Output: None
+*/
+static void PduR_SpiStart(void) {
+    PduR_SpiGatewayType* gw = &PduR_Spi;
+    uint8_t half = gw->fill;
+
+    if (gw->sending || gw->records[half] == 0) {
+        return;
+    }
+    // The records are bound in place: the DMA reads them from this buffer
+    if (Spi_SetupEB(SPI_CHANNEL_GATEWAY, gw->data[half], NULL,
+                    (Spi_NumberOfDataType)(gw->records[half] * PDUR_SPI_RECORD_BYTES)) != E_OK ||
+        Spi_AsyncTransmit(SPI_SEQ_GATEWAY) != E_OK) {
+        return;
+    }
+    gw->sending = 1;
+    gw->fill = half ^ 1u;
+    PduR_Stats.spiTransfers++;
+}
+
+/*
+* Function: PduR_SpiAppend
+* Description: Writes a frame as a record of the buffer taking the records and starts its transfer
+*   if the link is idle. The frame is lost when both buffers are in use.
+* Input:
+*   - CanId: Identifier of the frame.
+*   - CanDlc: Data length, at most 8.
+*   - CanSduPtr: Data.
+* Output:
+*   - E_OK: If the frame is recorded.
+*   - E_NOT_OK: If both buffers are in use.
+*/
+static Std_ReturnType PduR_SpiAppend(Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    PduR_SpiGatewayType* gw = &PduR_Spi;
+    SchM_StateType state;
+    uint8_t* record;
+
+    SchM_Enter(state);
+    // A transfer that failed or was cancelled ends without notification
+    if (gw->sending && Spi_GetSequenceResult(SPI_SEQ_GATEWAY) != SPI_SEQ_PENDING) {
+        gw->records[gw->fill ^ 1u] = 0;
+        gw->sending = 0;
+    }
+    if (gw->records[gw->fill] == PDUR_SPI_RECORDS) {
+        SchM_Exit(state);
+        return E_NOT_OK;
+    }
+    record = &gw->data[gw->fill][gw->records[gw->fill] * PDUR_SPI_RECORD_BYTES];
+    record[0] = (uint8_t)(CanId >> 24);
+    record[1] = (uint8_t)(CanId >> 16);
+    record[2] = (uint8_t)(CanId >> 8);
+    record[3] = (uint8_t)CanId;
+    record[4] = CanDlc;
+    memcpy(&record[5], CanSduPtr, CanDlc);
+    memset(&record[5 + CanDlc], 0, 8u - CanDlc);
+    gw->records[gw->fill]++;
+    PduR_SpiStart();
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: PduR_SpiGatewayNotification
+* Description: End notification of SPI_SEQ_GATEWAY: frees the buffer just sent and sends the other
+*   one if it holds records.
+* Input: None
+* Output: None
+*/
+void PduR_SpiGatewayNotification(void) {
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (PduR_Spi.sending) {
+        PduR_Spi.records[PduR_Spi.fill ^ 1u] = 0;
+        PduR_Spi.sending = 0;
+    }
+    PduR_SpiStart();
+    SchM_Exit(state);
+}
+
+/*
+* Function: PduR_Gateway
+* Description: Hands a received frame to its gateway destination. A CAN destination gets the
+*   buffer of the CAN driver as it is, Can_Write copying it into the mailbox or its queue; a CanTp
+*   connection copies the data into the buffer of its message.
+* Input:
+*   - Gateway: Destination.
+*   - CanPdu: Frame of CAN_RX_PDUS, handle of the frame sent.
+*   - CanId: Received identifier.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+static void PduR_Gateway(const PduR_GatewayConfigType* Gateway, uint8_t CanPdu, Can_IdType CanId, uint8_t CanDlc,
+                         const uint8_t* CanSduPtr) {
+    Std_ReturnType result;
+
+    if (Gateway->kind == PDUR_GW_CAN) {
+        Can_PduType pdu;
+        pdu.swPduHandle = CanPdu;
+        pdu.length = CanDlc;
+        pdu.id = (Gateway->id == PDUR_SOURCE_ID) ? CanId : Gateway->id;
+        pdu.sdu = CanSduPtr;
+        result = (Can_Write(Gateway->target, &pdu) == CAN_OK) ? E_OK : E_NOT_OK;
+    } else if (Gateway->kind == PDUR_GW_CANTP) {
+        CanTp_RxIndication((CanTp_ConnectionType)Gateway->target, CanDlc, CanSduPtr);
+        result = E_OK;
+    } else {
+        result = PduR_SpiAppend(CanId, CanDlc, CanSduPtr);
+    }
+    if (result == E_OK) {
+        PduR_Stats.gatewayed++;
+    } else {
+        PduR_Stats.gatewayLost++;
+    }
+}
+
+/*
+* Function: PduR_CanRxIndication
+* Description: Receive notification of the CAN driver. Indexes the routing table with the frame of
+*   CAN_RX_PDUS the driver found, then follows its routing path: the gateway destination first,
+*   then COM.
+* Input:
+*   - Hrh: Receive hardware object of the frame.
+*   - RxPdu: Frame of CAN_RX_PDUS, CAN_NUM_RX_PDUS for an identifier not listed.
+*   - CanId: Identifier of the frame.
+*   - CanDlc: Data length.
+*   - CanSduPtr: Data.
+* Output: None
+*/
+void PduR_CanRxIndication(Can_HwHandleType Hrh, uint8_t RxPdu, Can_IdType CanId, uint8_t CanDlc, const uint8_t* CanSduPtr) {
+    const PduR_RoutingPathType* path;
+
+    if (!PduR_Initialized || Hrh >= CAN_NUM_HRH || CanDlc > 8u) {
+        return;
+    }
+    PduR_Stats.rxFrames++;
+    if (RxPdu >= CAN_NUM_RX_PDUS) {
+        PduR_Stats.dropped++;
+        return;
+    }
+    path = &PduR_RoutingTable[RxPdu];
+
+    if (path->destinations == 0) {
+        PduR_Stats.dropped++;
+        return;
+    }
+    if (path->destinations & PDUR_TO_GATEWAY) {
+        PduR_Gateway(&PduR_GatewayConfig[path->gateway], RxPdu, CanId, CanDlc, CanSduPtr);
+    }
+    if (path->destinations & PDUR_TO_COM) {
+        PduInfoType info;
+        info.SduDataPtr = (uint8_t*)CanSduPtr;
+        info.SduLength = CanDlc;
+        Com_RxIndication(path->comPdu, &info);
+        PduR_Stats.toCom++;
+    }
+}
+
+/*
+* Function: PduR_CanTxConfirmation
+* Description: Transmit confirmation of the CAN driver. Frames written by CanTp are confirmed to
+*   it; those of the gateway paths are not tracked.
+* Input:
+*   - CanTxPduId: Handle of the frame sent.
+* Output: None
+*/
+void PduR_CanTxConfirmation(PduIdType CanTxPduId) {
+    if (CanTxPduId >= CANTP_TX_HANDLE) {
+        CanTp_TxConfirmation(CanTxPduId);
+    }
+}
+
+/*
+* Function: PduR_GetStats
+* Description: Copies the counters of the router.
+* Input:
+*   - StatsPtr: Receives the counters.
+* Output:
+*   - E_OK: If the counters are copied.
+*   - E_NOT_OK: If StatsPtr is NULL.
+*/
+Std_ReturnType PduR_GetStats(PduR_StatsType* StatsPtr) {
+    SchM_StateType state;
+
+    if (StatsPtr == NULL) {
+        return E_NOT_OK;
+    }
+    SchM_Enter(state);
+    *StatsPtr = PduR_Stats;
+    SchM_Exit(state);
+    return E_OK;
+}
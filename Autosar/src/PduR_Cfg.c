@@ -0,0 +1,24 @@
+/*
+* File: PduR_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Routing table and gateway destinations of the PDU router, from the lists of
+* PduR_Cfg.h.
+*/
+
+#include "PduR.h"
+
+#define PDUR_GATEWAY(name, kind, target, id)    { (kind), (target), (id) },
+
+// Frames missing from PDUR_ROUTES keep destinations 0
+#define PDUR_ROUTE(canPdu, comPdu, gateway) \
+    [canPdu] = { (((comPdu) != PDUR_NO_COM_PDU) ? PDUR_TO_COM : 0u) | \
+                 (((gateway) != PDUR_NO_GATEWAY) ? PDUR_TO_GATEWAY : 0u), (comPdu), (gateway) },
+
+const PduR_GatewayConfigType PduR_GatewayConfig[PDUR_NUM_GATEWAYS] = {
+    PDUR_GATEWAYS(PDUR_GATEWAY)
+};
+
+const PduR_RoutingPathType PduR_RoutingTable[CAN_NUM_RX_PDUS] = {
+    PDUR_ROUTES(PDUR_ROUTE)
+};
@@ -0,0 +1,412 @@
+/*
+* File: Pwm.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Source file for Pwm.h containing the implementation of the PWM driver. Each timer
+* runs its compare registers in preload mode and requests a DMA burst at every update event: a
+* circular stream copies the compare values of the unit from RAM through DMAR into CCR1..CCRn,
+* which take effect together at the following update event.
+*/
+
+#include "Pwm.h"
+#include <stdint.h>
+
+// All flags of DMA stream n
+#define PWM_DMA_FLAGS(n) (DMA_FLAG_FEIF##n | DMA_FLAG_DMEIF##n | DMA_FLAG_TEIF##n | DMA_FLAG_HTIF##n | DMA_FLAG_TCIF##n)
+
+// Peripheral resources of a hardware unit
+typedef struct {
+    TIM_TypeDef* regs;                  // Timer
+    uint32_t rccPeriph;                 // RCC_APBxPeriph_TIMx clock enable bit
+    uint8_t advanced;                   // TIM1: on APB2, outputs gated by MOE
+    DMA_Stream_TypeDef* stream;         // Stream of the update request, writing DMAR
+    uint32_t dmaClock;                  // RCC_AHB1Periph_DMAx of the stream
+    uint32_t channel;                   // DMA_Channel_x selecting the update request
+    uint32_t flags;                     // All flags of the stream
+} Pwm_HWUnitHwType;
+
+// Resources of TIM1 and TIM3. Update requests of RM0090 on streams not used by the other drivers:
+// TIM4_UP shares DMA1 stream 6 with the log, TIM8_UP DMA2 stream 1 with ADC3.
+static const Pwm_HWUnitHwType Pwm_HWUnitHw[NUM_OF_PWM_HW_UNITS] = {
+    { TIM1, RCC_APB2Periph_TIM1, 1, DMA2_Stream5, RCC_AHB1Periph_DMA2, DMA_Channel_6, PWM_DMA_FLAGS(5) },
+    { TIM3, RCC_APB1Periph_TIM3, 0, DMA1_Stream2, RCC_AHB1Periph_DMA1, DMA_Channel_5, PWM_DMA_FLAGS(2) },
+};
+
+static uint8_t Pwm_Initialized;
+static const Pwm_ConfigType* Pwm_ActiveConfig;
+// Compare values copied into CCR1..CCR4 by the burst of each unit
+static Pwm_CompareType Pwm_Compare[NUM_OF_PWM_HW_UNITS][4];
+// Unit playing a waveform table instead of Pwm_Compare
+static uint8_t Pwm_Waveform[NUM_OF_PWM_HW_UNITS];
+
+/*
+* Function: Pwm_OutputInit
+* Description: Sets a compare channel of a timer to PWM mode 1 with its compare register in
+*   preload mode.
+* Input:
+*   - HWUnit: Unit of the channel.
+*   - ChannelCfg: Channel to set up.
+*   - Compare: First compare value.
+* Output: None
+*/
+static void Pwm_OutputInit(Pwm_HWUnitType HWUnit, const Pwm_ChannelConfigType* ChannelCfg, Pwm_CompareType Compare) {
+    TIM_TypeDef* TIMx = Pwm_HWUnitHw[HWUnit].regs;
+    TIM_OCInitTypeDef TIM_OCInitStruct;
+
+    TIM_OCStructInit(&TIM_OCInitStruct);
+    TIM_OCInitStruct.TIM_OCMode = TIM_OCMode_PWM1;
+    TIM_OCInitStruct.TIM_OutputState = TIM_OutputState_Enable;
+    TIM_OCInitStruct.TIM_Pulse = Compare;
+    TIM_OCInitStruct.TIM_OCPolarity = (ChannelCfg->polarity == PWM_HIGH) ? TIM_OCPolarity_High : TIM_OCPolarity_Low;
+    // Level of the output of TIM1 while MOE is clear
+    TIM_OCInitStruct.TIM_OCIdleState = (ChannelCfg->idleState == PWM_HIGH) ? TIM_OCIdleState_Set : TIM_OCIdleState_Reset;
+
+    switch (ChannelCfg->timChannel) {
+        case 0:
+            TIM_OC1Init(TIMx, &TIM_OCInitStruct);
+            TIM_OC1PreloadConfig(TIMx, TIM_OCPreload_Enable);
+            break;
+        case 1:
+            TIM_OC2Init(TIMx, &TIM_OCInitStruct);
+            TIM_OC2PreloadConfig(TIMx, TIM_OCPreload_Enable);
+            break;
+        case 2:
+            TIM_OC3Init(TIMx, &TIM_OCInitStruct);
+            TIM_OC3PreloadConfig(TIMx, TIM_OCPreload_Enable);
+            break;
+        default:
+            TIM_OC4Init(TIMx, &TIM_OCInitStruct);
+            TIM_OC4PreloadConfig(TIMx, TIM_OCPreload_Enable);
+            break;
+    }
+}
+
+/*
+* Function: Pwm_StreamStart
+* Description: Starts the circular stream of a unit on a buffer of compare values, one burst of
+*   burstLength values per update event.
+* Input:
+*   - HWUnit: Unit whose stream is started.
+*   - Buffer: Compare values, burstLength per row.
+*   - Rows: Rows of the buffer.
+* Output: None
+*/
+static void Pwm_StreamStart(Pwm_HWUnitType HWUnit, const Pwm_CompareType* Buffer, uint16_t Rows) {
+    const Pwm_HWUnitHwType* hw = &Pwm_HWUnitHw[HWUnit];
+    DMA_InitTypeDef DMA_InitStruct;
+
+    DMA_InitStruct.DMA_Channel = hw->channel;
+    DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&hw->regs->DMAR;
+    DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Buffer;
+    DMA_InitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStruct.DMA_BufferSize = (uint32_t)Rows * Pwm_ActiveConfig->hwUnits[HWUnit].burstLength;
+    DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStruct.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStruct.DMA_Priority = DMA_Priority_High;
+    DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+    DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(hw->stream, &DMA_InitStruct);
+
+    DMA_ClearFlag(hw->stream, hw->flags);
+    DMA_Cmd(hw->stream, ENABLE);
+}
+
+/*
+* Function: Pwm_Hold
+* Description: Suspends the update events of a unit, so that neither the DMA nor the compare
+*   registers change, and waits for the end of a burst the DMA may have started. A period that
+*   ends meanwhile keeps the compare values of the previous one.
+* Input:
+*   - HWUnit: Unit to hold.
+* Output: None
+*/
+static void Pwm_Hold(Pwm_HWUnitType HWUnit) {
+    const Pwm_HWUnitHwType* hw = &Pwm_HWUnitHw[HWUnit];
+    uint8_t burstLength = Pwm_ActiveConfig->hwUnits[HWUnit].burstLength;
+
+    TIM_UpdateDisableConfig(hw->regs, ENABLE);
+    // A burst lasts a few bus cycles
+    while (DMA_GetCurrDataCounter(hw->stream) % burstLength != 0) {
+    }
+}
+
+/*
+* Function: Pwm_Release
+* Description: Resumes the update events of a unit held by Pwm_Hold.
+* Input:
+*   - HWUnit: Unit to release.
+* Output: None
+*/
+static void Pwm_Release(Pwm_HWUnitType HWUnit) {
+    TIM_UpdateDisableConfig(Pwm_HWUnitHw[HWUnit].regs, DISABLE);
+}
+
+/*
+* Function: Pwm_SwitchStream
+* Description: Points the stream of a unit at another buffer between two bursts.
+* Input:
+*   - HWUnit: Unit whose stream is switched.
+*   - Buffer: New buffer of compare values.
+*   - Rows: Rows of the buffer.
+* Output: None
+*/
+static void Pwm_SwitchStream(Pwm_HWUnitType HWUnit, const Pwm_CompareType* Buffer, uint16_t Rows) {
+    DMA_Stream_TypeDef* stream = Pwm_HWUnitHw[HWUnit].stream;
+
+    Pwm_Hold(HWUnit);
+    DMA_Cmd(stream, DISABLE);
+    while (DMA_GetCmdStatus(stream) == ENABLE) {
+    }
+    Pwm_StreamStart(HWUnit, Buffer, Rows);
+    Pwm_Release(HWUnit);
+}
+
+/*
+* Function: Pwm_Init
+* Description: Starts the timers with the duty cycles of the configuration and their DMA streams
+*   on the compare values of the units.
+* Input:
+*   - ConfigPtr: Configuration of the units and channels, NULL for Pwm_Config.
+* Output: None
+*/
+void Pwm_Init(const Pwm_ConfigType* ConfigPtr) {
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
+
+    if (Pwm_Initialized) {
+        Pwm_DeInit();
+    }
+    Pwm_ActiveConfig = (ConfigPtr != NULL) ? ConfigPtr : &Pwm_Config;
+
+    for (uint8_t hw = 0; hw < NUM_OF_PWM_HW_UNITS; hw++) {
+        const Pwm_HWUnitHwType* unitHw = &Pwm_HWUnitHw[hw];
+        const Pwm_HWUnitConfigType* unitCfg = &Pwm_ActiveConfig->hwUnits[hw];
+
+        if (unitHw->advanced) {
+            RCC_APB2PeriphClockCmd(unitHw->rccPeriph, ENABLE);
+        } else {
+            RCC_APB1PeriphClockCmd(unitHw->rccPeriph, ENABLE);
+        }
+        RCC_AHB1PeriphClockCmd(unitHw->dmaClock, ENABLE);
+
+        TIM_DeInit(unitHw->regs);
+        TIM_TimeBaseInitStruct.TIM_Prescaler = unitCfg->prescaler;
+        TIM_TimeBaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
+        TIM_TimeBaseInitStruct.TIM_Period = unitCfg->period - 1u;
+        TIM_TimeBaseInitStruct.TIM_ClockDivision = TIM_CKD_DIV1;
+        TIM_TimeBaseInitStruct.TIM_RepetitionCounter = 0;
+        TIM_TimeBaseInit(unitHw->regs, &TIM_TimeBaseInitStruct);
+
+        for (uint8_t ch = 0; ch < 4; ch++) {
+            Pwm_Compare[hw][ch] = 0;
+        }
+        Pwm_Waveform[hw] = 0;
+    }
+
+    for (Pwm_ChannelType channel = 0; channel < PWM_MAX_CHANNEL; channel++) {
+        const Pwm_ChannelConfigType* channelCfg = &Pwm_ActiveConfig->channels[channel];
+        Pwm_CompareType compare = Pwm_DutyToCompare(channelCfg->hwUnit, channelCfg->dutyCycle);
+
+        Pwm_Compare[channelCfg->hwUnit][channelCfg->timChannel] = compare;
+        Pwm_OutputInit(channelCfg->hwUnit, channelCfg, compare);
+    }
+
+    for (uint8_t hw = 0; hw < NUM_OF_PWM_HW_UNITS; hw++) {
+        const Pwm_HWUnitHwType* unitHw = &Pwm_HWUnitHw[hw];
+        uint8_t burstLength = Pwm_ActiveConfig->hwUnits[hw].burstLength;
+
+        TIM_ARRPreloadConfig(unitHw->regs, ENABLE);
+        // Each update request writes DMAR burstLength times, into CCR1 onwards
+        TIM_DMAConfig(unitHw->regs, TIM_DMABase_CCR1, (uint16_t)(TIM_DMABurstLength_1Transfer + ((burstLength - 1u) << 8)));
+        Pwm_StreamStart((Pwm_HWUnitType)hw, Pwm_Compare[hw], 1);
+        TIM_DMACmd(unitHw->regs, TIM_DMA_Update, ENABLE);
+        if (unitHw->advanced) {
+            TIM_CtrlPWMOutputs(unitHw->regs, ENABLE);
+        }
+        TIM_Cmd(unitHw->regs, ENABLE);
+    }
+    Pwm_Initialized = 1;
+}
+
+/*
+* Function: Pwm_DeInit
+* Description: Stops the timers and their streams and switches the timer clocks off. The outputs
+*   of TIM1 go to their idle state.
+* Input: None
+* Output: None
+*/
+void Pwm_DeInit(void) {
+    if (!Pwm_Initialized) {
+        return;
+    }
+    for (uint8_t hw = 0; hw < NUM_OF_PWM_HW_UNITS; hw++) {
+        const Pwm_HWUnitHwType* unitHw = &Pwm_HWUnitHw[hw];
+
+        TIM_DMACmd(unitHw->regs, TIM_DMA_Update, DISABLE);
+        DMA_Cmd(unitHw->stream, DISABLE);
+        DMA_ClearFlag(unitHw->stream, unitHw->flags);
+        if (unitHw->advanced) {
+            TIM_CtrlPWMOutputs(unitHw->regs, DISABLE);
+        }
+        TIM_Cmd(unitHw->regs, DISABLE);
+        TIM_DeInit(unitHw->regs);
+        if (unitHw->advanced) {
+            RCC_APB2PeriphClockCmd(unitHw->rccPeriph, DISABLE);
+        } else {
+            RCC_APB1PeriphClockCmd(unitHw->rccPeriph, DISABLE);
+        }
+    }
+    Pwm_Initialized = 0;
+}
+
+/*
+* Function: Pwm_DutyToCompare
+* Description: Converts a duty cycle into the compare value of a unit, for waveform tables.
+* Input:
+*   - HWUnit: Unit whose period is used.
+*   - DutyCycle: Duty cycle, 0x8000 for 100 %; larger values are taken as 100 %.
+* Output: Compare value, 0 if the driver is not initialized or the unit is invalid.
+*/
+Pwm_CompareType Pwm_DutyToCompare(Pwm_HWUnitType HWUnit, uint16_t DutyCycle) {
+    if (Pwm_ActiveConfig == NULL || HWUnit >= NUM_OF_PWM_HW_UNITS) {
+        return 0;
+    }
+    if (DutyCycle > PWM_DUTY_100) {
+        DutyCycle = PWM_DUTY_100;
+    }
+    return (Pwm_ActiveConfig->hwUnits[HWUnit].period * DutyCycle) >> 15;
+}
+
+/*
+* Function: Pwm_SetDutyCycle
+* Description: Sets the duty cycle of a channel from the next period on. Only the compare value
+*   in RAM is written: the DMA burst of the next update event moves it into the timer. While a
+*   waveform is played, the value is kept for Pwm_StopWaveform.
+* Input:
+*   - ChannelNumber: Channel to set.
+*   - DutyCycle: Duty cycle, 0x8000 for 100 %.
+* Output: None
+*/
+void Pwm_SetDutyCycle(Pwm_ChannelType ChannelNumber, uint16_t DutyCycle) {
+    const Pwm_ChannelConfigType* channelCfg;
+
+    if (!Pwm_Initialized || ChannelNumber >= PWM_MAX_CHANNEL) {
+        return;
+    }
+    channelCfg = &Pwm_ActiveConfig->channels[ChannelNumber];
+    // One word store, which the DMA reads either before or after
+    Pwm_Compare[channelCfg->hwUnit][channelCfg->timChannel] = Pwm_DutyToCompare(channelCfg->hwUnit, DutyCycle);
+}
+
+/*
+* Function: Pwm_SetDutyCycles
+* Description: Sets the duty cycles of several channels so that the channels of one unit change
+*   in the same period: the update events of the units concerned are held while the compare
+*   values are written, which costs two register writes per unit whatever the number of channels.
+*   Not reentrant for the channels of one unit.
+* Input:
+*   - Channels: Channels to set.
+*   - DutyCycles: Duty cycle of each channel, 0x8000 for 100 %.
+*   - Count: Number of channels.
+* Output:
+*   - E_OK: If the duty cycles have been set.
+*   - E_NOT_OK: If the driver is not initialized, a pointer is NULL or a channel is invalid;
+*     nothing is set then.
+*/
+Std_ReturnType Pwm_SetDutyCycles(const Pwm_ChannelType* Channels, const uint16_t* DutyCycles, uint8_t Count) {
+    uint8_t held = 0;       // Bit n set when unit n is held
+
+    if (!Pwm_Initialized || Channels == NULL || DutyCycles == NULL) {
+        return E_NOT_OK;
+    }
+    for (uint8_t i = 0; i < Count; i++) {
+        if (Channels[i] >= PWM_MAX_CHANNEL) {
+            return E_NOT_OK;
+        }
+    }
+    for (uint8_t i = 0; i < Count; i++) {
+        Pwm_HWUnitType hw = Pwm_ActiveConfig->channels[Channels[i]].hwUnit;
+
+        if ((held & (1u << hw)) == 0 && !Pwm_Waveform[hw]) {
+            Pwm_Hold(hw);
+            held |= (uint8_t)(1u << hw);
+        }
+    }
+    for (uint8_t i = 0; i < Count; i++) {
+        const Pwm_ChannelConfigType* channelCfg = &Pwm_ActiveConfig->channels[Channels[i]];
+        Pwm_Compare[channelCfg->hwUnit][channelCfg->timChannel] = Pwm_DutyToCompare(channelCfg->hwUnit, DutyCycles[i]);
+    }
+    for (uint8_t hw = 0; hw < NUM_OF_PWM_HW_UNITS; hw++) {
+        if (held & (1u << hw)) {
+            Pwm_Release((Pwm_HWUnitType)hw);
+        }
+    }
+    return E_OK;
+}
+
+/*
+* Function: Pwm_SetOutputToIdle
+* Description: Sets a channel to its idle level from the next period on, by a compare value of 0
+*   or of the whole period. It leaves the idle level at the next Pwm_SetDutyCycle.
+* Input:
+*   - ChannelNumber: Channel to set.
+* Output: None
+*/
+void Pwm_SetOutputToIdle(Pwm_ChannelType ChannelNumber) {
+    const Pwm_ChannelConfigType* channelCfg;
+
+    if (!Pwm_Initialized || ChannelNumber >= PWM_MAX_CHANNEL) {
+        return;
+    }
+    channelCfg = &Pwm_ActiveConfig->channels[ChannelNumber];
+    // The output is at the active level while the counter is below the compare value
+    Pwm_Compare[channelCfg->hwUnit][channelCfg->timChannel] =
+        (channelCfg->idleState == channelCfg->polarity) ? Pwm_ActiveConfig->hwUnits[channelCfg->hwUnit].period : 0;
+}
+
+/*
+* Function: Pwm_StartWaveform
+* Description: Plays a table of compare values on a unit, one row per period, from the first row
+*   again after the last one, until Pwm_StopWaveform. A row holds burstLength values, for CH1
+*   onwards; the table must stay valid while it is played.
+* Input:
+*   - HWUnit: Unit playing the table.
+*   - Table: Compare values, see Pwm_DutyToCompare.
+*   - Rows: Rows of the table.
+* Output:
+*   - E_OK: If the table is played from the next period on.
+*   - E_NOT_OK: If the driver is not initialized, the unit is invalid, the table is NULL or does
+*     not fit in one DMA transfer.
+*/
+Std_ReturnType Pwm_StartWaveform(Pwm_HWUnitType HWUnit, const Pwm_CompareType* Table, uint16_t Rows) {
+    if (!Pwm_Initialized || HWUnit >= NUM_OF_PWM_HW_UNITS || Table == NULL || Rows == 0 ||
+        (uint32_t)Rows * Pwm_ActiveConfig->hwUnits[HWUnit].burstLength > 0xFFFFu) {
+        return E_NOT_OK;
+    }
+    Pwm_SwitchStream(HWUnit, Table, Rows);
+    Pwm_Waveform[HWUnit] = 1;
+    return E_OK;
+}
+
+/*
+* Function: Pwm_StopWaveform
+* Description: Stops the table played by a unit and returns to the duty cycles set for its
+*   channels.
+* Input:
+*   - HWUnit: Unit to stop.
+* Output:
+*   - E_OK: If the unit is back on its duty cycles.
+*   - E_NOT_OK: If the driver is not initialized, the unit is invalid or plays no table.
+*/
+Std_ReturnType Pwm_StopWaveform(Pwm_HWUnitType HWUnit) {
+    if (!Pwm_Initialized || HWUnit >= NUM_OF_PWM_HW_UNITS || !Pwm_Waveform[HWUnit]) {
+        return E_NOT_OK;
+    }
+    Pwm_SwitchStream(HWUnit, Pwm_Compare[HWUnit], 1);
+    Pwm_Waveform[HWUnit] = 0;
+    return E_OK;
+}
@@ -0,0 +1,24 @@
+/*
+* File: Pwm_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Hardware unit and channel configuration of the PWM driver.
+*/
+
+#include "Pwm.h"
+
+static const Pwm_HWUnitConfigType Pwm_HWUnitConfig[NUM_OF_PWM_HW_UNITS] = {
+    /* prescaler, period, burstLength */
+    { PWM_MOTOR_PRESCALER, PWM_MOTOR_PERIOD, PWM_MOTOR_BURST },         /* PWM_HWUnit_0 */
+    { PWM_DIMMER_PRESCALER, PWM_DIMMER_PERIOD, PWM_DIMMER_BURST },      /* PWM_HWUnit_1 */
+};
+
+static const Pwm_ChannelConfigType Pwm_ChannelConfig[PWM_MAX_CHANNEL] = {
+    /* hwUnit, timChannel, polarity, idleState, dutyCycle */
+    { PWM_HWUnit_0, 0, PWM_HIGH, PWM_LOW, PWM_DUTY_0 },                 /* PWM_CHANNEL_PHASE_U */
+    { PWM_HWUnit_0, 1, PWM_HIGH, PWM_LOW, PWM_DUTY_0 },                 /* PWM_CHANNEL_PHASE_V */
+    { PWM_HWUnit_0, 2, PWM_HIGH, PWM_LOW, PWM_DUTY_0 },                 /* PWM_CHANNEL_PHASE_W */
+    { PWM_HWUnit_1, 0, PWM_HIGH, PWM_LOW, PWM_DUTY_100 / 2 },           /* PWM_CHANNEL_DIMMER */
+};
+
+const Pwm_ConfigType Pwm_Config = { Pwm_HWUnitConfig, Pwm_ChannelConfig };
@@ -6,37 +6,934 @@
 */
 
 #include "Spi.h"
+#include "Dio.h"
+#include "Dma.h"
+#include "SchM.h"
+#include <stdint.h>
+
+// Value of activeJob when a hardware unit has no job in progress
+#define SPI_JOB_NONE ((Spi_JobType)0xFFFF)
+
+// DMA streams serving a hardware unit
+typedef struct {
+    DMA_Stream_TypeDef* rxStream;       // Stream moving DR to memory
+    DMA_Stream_TypeDef* txStream;       // Stream moving memory to DR
+    uint32_t channel;                   // DMA_Channel_x selecting the SPI requests
+    uint32_t rxFlags;                   // All flags of the RX stream
+    uint32_t txFlags;                   // All flags of the TX stream
+    uint32_t rxCompleteFlag;            // Transfer complete flag of the RX stream
+    uint32_t errorFlags;                // Transfer error flags of both streams
+    uint32_t ahb1Periph;                // Clock of the DMA controller
+    IRQn_Type rxIRQn;                   // Interrupt of the RX stream
+    IRQn_Type txIRQn;                   // Interrupt of the TX stream, on a transfer error only
+} Spi_DmaStreamType;
+
+// All flags of DMA stream n
+#define SPI_DMA_FLAGS(n) (DMA_FLAG_FEIF##n | DMA_FLAG_DMEIF##n | DMA_FLAG_TEIF##n | DMA_FLAG_HTIF##n | DMA_FLAG_TCIF##n)
+
+// Peripheral resources of a hardware unit
+typedef struct {
+    SPI_TypeDef* regs;                  // SPI peripheral
+    uint8_t apb2;                       // Clock on APB2, otherwise on APB1
+    uint32_t rccPeriph;                 // RCC_APBxPeriph_SPIx clock enable bit
+    IRQn_Type irqn;                     // SPI interrupt, used in SPI_INTERRUPT_MODE
+    Spi_DmaStreamType dma;              // DMA streams, used in SPI_DMA_MODE
+} Spi_HWUnitHwType;
+
+// Resources of SPI1..SPI3. DMA request mapping of RM0090: SPI1 on DMA2 channel 3, SPI2 and SPI3
+// on DMA1 channel 0
+static const Spi_HWUnitHwType Spi_HWUnitHw[NUM_OF_SPI_HW_UNITS] = {
+    { SPI1, 1, RCC_APB2Periph_SPI1, SPI1_IRQn,
+      { DMA2_Stream0, DMA2_Stream3, DMA_Channel_3, SPI_DMA_FLAGS(0), SPI_DMA_FLAGS(3),
+        DMA_FLAG_TCIF0, DMA_FLAG_TEIF0 | DMA_FLAG_TEIF3, RCC_AHB1Periph_DMA2, DMA2_Stream0_IRQn, DMA2_Stream3_IRQn } },
+    { SPI2, 0, RCC_APB1Periph_SPI2, SPI2_IRQn,
+      { DMA1_Stream3, DMA1_Stream4, DMA_Channel_0, SPI_DMA_FLAGS(3), SPI_DMA_FLAGS(4),
+        DMA_FLAG_TCIF3, DMA_FLAG_TEIF3 | DMA_FLAG_TEIF4, RCC_AHB1Periph_DMA1, DMA1_Stream3_IRQn, DMA1_Stream4_IRQn } },
+    { SPI3, 0, RCC_APB1Periph_SPI3, SPI3_IRQn,
+      { DMA1_Stream0, DMA1_Stream5, DMA_Channel_0, SPI_DMA_FLAGS(0), SPI_DMA_FLAGS(5),
+        DMA_FLAG_TCIF0, DMA_FLAG_TEIF0 | DMA_FLAG_TEIF5, RCC_AHB1Periph_DMA1, DMA1_Stream0_IRQn, DMA1_Stream5_IRQn } },
+};
+
+// Core clock cycle counter used for the statistics, enabled by Spi_Init
+#define SPI_GET_CYCLES() (DWT->CYCCNT)
+
+// Buffers currently attached to a channel
+typedef struct {
+    const Spi_DataBufferType* src;      // Data to send, NULL to send the default data
+    Spi_DataBufferType* dst;            // Destination of received data, NULL to discard it
+    Spi_NumberOfDataType length;        // Number of data elements to transfer
+    const Spi_DataBufferType* ebSrc[2]; // Halves bound to an EB channel, equal when not ping-pong
+    Spi_DataBufferType* ebDst[2];
+    uint8_t ebHalf;                     // Half of ebSrc/ebDst used by the next transfer
+} Spi_ChannelStateType;
+
+// Scheduling state of a hardware unit
+typedef struct {
+    Spi_JobType queue[SPI_MAX_JOB];     // Queued jobs, highest priority first
+    uint8_t queueCount;                 // Number of jobs in queue
+    Spi_JobType activeJob;              // Job in progress, SPI_JOB_NONE if idle
+    uint8_t channelIndex;               // Position of the channel in progress in the job
+    Spi_NumberOfDataType txCount;       // Data elements written to DR for this channel
+    Spi_NumberOfDataType rxCount;       // Data elements read from DR for this channel
+    uint32_t jobStart;                  // Cycle counter when the device of activeJob was selected
+    uint16_t dataSize;                  // Frame size programmed in CR1
+} Spi_HWUnitStateType;
+
+// Channel handed to the interrupt handler of a hardware unit
+typedef struct {
+    Spi_JobType job;                    // Job the channel belongs to
+    Spi_ChannelType channel;            // Channel to transfer
+    uint8_t lastChannel;                // The device is released after this channel
+} Spi_IrqRingEntryType;
+
+// Single-producer/single-consumer ring between the task context and the interrupt handler.
+// The task only writes head, the interrupt handler only writes tail; the slot of the channel in
+// progress is released once the channel is complete.
+typedef struct {
+    Spi_IrqRingEntryType entry[SPI_IRQ_RING_SIZE];
+    volatile uint8_t head;              // Free-running index of the next slot to fill
+    volatile uint8_t tail;              // Free-running index of the channel in progress
+} Spi_IrqRingType;
+
+#define SPI_IRQ_RING_MASK ((uint8_t)(SPI_IRQ_RING_SIZE - 1u))
+
+// Transmission state of a sequence
+typedef struct {
+    Spi_SeqResultType result;
+    uint8_t remainingJobs;              // Jobs of the sequence not finished yet
+} Spi_SequenceStateType;
+
+static Spi_StatusType Spi_DriverStatus = SPI_UNINIT;
+static Spi_AsyncModeType Spi_HWUnitMode[NUM_OF_SPI_HW_UNITS];
+static Spi_ChannelStateType Spi_ChannelState[SPI_MAX_CHANNEL];
+static Spi_JobResultType Spi_JobResult[SPI_MAX_JOB];
+static Spi_SequenceType Spi_JobSequence[SPI_MAX_JOB];   // Sequence that queued each job
+static Spi_SequenceStateType Spi_SequenceState[SPI_MAX_SEQUENCE];
+static Spi_HWUnitStateType Spi_HWUnitState[NUM_OF_SPI_HW_UNITS];
+static uint16_t Spi_DmaRxSink[NUM_OF_SPI_HW_UNITS];               // Receives data of channels without destination
+static uint16_t Spi_DmaTxDefault[NUM_OF_SPI_HW_UNITS];            // Default data of channels without source
+static Spi_IrqRingType Spi_IrqRing[NUM_OF_SPI_HW_UNITS];
+static uint32_t Spi_JobQueuedAt[SPI_MAX_JOB];                       // Cycle counter when each job was queued
+static Spi_HWUnitStatsType Spi_HWUnitStats[NUM_OF_SPI_HW_UNITS];
+
+/*
+* Function: Spi_HWUnitClockCmd
+* Description: Enables or disables the peripheral clock of a hardware unit.
+* Input:
+*   - HWUnit: Hardware unit whose clock is switched.
+*   - NewState: ENABLE or DISABLE.
+* Output: None
+*/
+static void Spi_HWUnitClockCmd(Spi_HWUnitType HWUnit, FunctionalState NewState) {
+    const Spi_HWUnitHwType* hw = &Spi_HWUnitHw[HWUnit];
+
+    if (hw->apb2) {
+        RCC_APB2PeriphClockCmd(hw->rccPeriph, NewState);
+    } else {
+        RCC_APB1PeriphClockCmd(hw->rccPeriph, NewState);
+    }
+}
+
+/*
+* Function: Spi_EnqueueJob
+* Description: Inserts a job in the queue of its hardware unit. Jobs are kept ordered by
+*   decreasing priority; jobs of equal priority keep the order in which they were queued.
+*   Must be called inside an exclusive area.
+* Input:
+*   - Job: Job to queue.
+* Output: None
+*/
+static void Spi_EnqueueJob(Spi_JobType Job) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[Spi_JobConfig[Job].hwUnit];
+    uint8_t priority = Spi_JobConfig[Job].priority;
+    uint8_t pos = unit->queueCount;
+
+    // Shift lower priority jobs one place back
+    while (pos > 0 && Spi_JobConfig[unit->queue[pos - 1]].priority < priority) {
+        unit->queue[pos] = unit->queue[pos - 1];
+        pos--;
+    }
+    unit->queue[pos] = Job;
+    unit->queueCount++;
+}
+
+/*
+* Function: Spi_DequeueJob
+* Description: Removes the highest priority job from the queue of a hardware unit. Must be
+*   called inside an exclusive area with a non-empty queue.
+* Input:
+*   - HWUnit: Hardware unit whose queue is read.
+* Output:
+*   - The job removed from the queue.
+*/
+static Spi_JobType Spi_DequeueJob(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    Spi_JobType job = unit->queue[0];
+
+    unit->queueCount--;
+    for (uint8_t i = 0; i < unit->queueCount; i++) {
+        unit->queue[i] = unit->queue[i + 1];
+    }
+    return job;
+}
+
+/*
+* Function: Spi_SelectDevice
+* Description: Makes a job the job in progress of its hardware unit and selects its device.
+* Input:
+*   - HWUnit: Hardware unit of the job.
+*   - Job: Job to start.
+* Output: None
+*/
+static void Spi_SelectDevice(Spi_HWUnitType HWUnit, Spi_JobType Job) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+
+    unit->activeJob = Job;
+    Spi_JobResult[Job] = SPI_JOB_PENDING;
+    unit->channelIndex = 0;
+    unit->txCount = 0;
+    unit->rxCount = 0;
+    unit->jobStart = SPI_GET_CYCLES();
+
+    if (Spi_JobConfig[Job].csChannel != SPI_CS_NONE) {
+        Dio_WriteChannel(Spi_JobConfig[Job].csChannel, Spi_JobConfig[Job].csActiveLevel);
+    }
+}
+
+/*
+* Function: Spi_StartNextJob
+* Description: Takes the highest priority job from the queue of an idle hardware unit and
+*   selects its device.
+* Input:
+*   - HWUnit: Hardware unit to start.
+* Output:
+*   - 1: If a job was started.
+*   - 0: If the unit is busy or its queue is empty.
+*/
+static uint8_t Spi_StartNextJob(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    SchM_StateType state;
+    Spi_JobType job;
+
+    SchM_Enter(state);
+    if (unit->activeJob != SPI_JOB_NONE || unit->queueCount == 0) {
+        SchM_Exit(state);
+        return 0;
+    }
+    job = Spi_DequeueJob(HWUnit);
+    unit->activeJob = job;
+    SchM_Exit(state);
+
+    Spi_SelectDevice(HWUnit, job);
+    return 1;
+}
+
+/*
+* Function: Spi_FinishJob
+* Description: Deselects the device of the job in progress on a hardware unit, records the job
+*   result and completes the owning sequence when it was its last job.
+* Input:
+*   - HWUnit: Hardware unit whose job has ended.
+*   - Result: SPI_JOB_OK or SPI_JOB_FAILED.
+* Output: None
+*/
+static void Spi_FinishJob(Spi_HWUnitType HWUnit, Spi_JobResultType Result) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    Spi_JobType job = unit->activeJob;
+    const Spi_JobConfigType* jobCfg = &Spi_JobConfig[job];
+    Spi_SequenceType seq = Spi_JobSequence[job];
+    Spi_SequenceStateType* seqState = &Spi_SequenceState[seq];
+    Spi_HWUnitStatsType* stats = &Spi_HWUnitStats[HWUnit];
+    uint8_t seqDone = 0;
+    SchM_StateType state;
+
+    // Deselect the device
+    if (jobCfg->csChannel != SPI_CS_NONE) {
+        Dio_WriteChannel(jobCfg->csChannel, (Dio_LevelType)(jobCfg->csActiveLevel ^ 1u));
+    }
+
+    SchM_Enter(state);
+    uint32_t now = SPI_GET_CYCLES();
+    stats->jobs++;
+    stats->latencyLast = now - Spi_JobQueuedAt[job];
+    stats->latencySum += stats->latencyLast;
+    if (stats->latencyLast > stats->latencyMax) {
+        stats->latencyMax = stats->latencyLast;
+    }
+    stats->busyCycles += now - unit->jobStart;
+    unit->activeJob = SPI_JOB_NONE;
+    Spi_JobResult[job] = Result;
+    if (Result == SPI_JOB_FAILED && seqState->result == SPI_SEQ_PENDING) {
+        seqState->result = SPI_SEQ_FAILED;
+    }
+    seqState->remainingJobs--;
+    if (seqState->remainingJobs == 0) {
+        if (seqState->result == SPI_SEQ_PENDING) {
+            seqState->result = SPI_SEQ_OK;
+        }
+        seqDone = 1;
+    }
+    SchM_Exit(state);
+
+    if (jobCfg->endNotification != NULL) {
+        jobCfg->endNotification();
+    }
+    if (seqDone && seqState->result == SPI_SEQ_OK && Spi_SequenceConfig[seq].endNotification != NULL) {
+        Spi_SequenceConfig[seq].endNotification();
+    }
+}
+
+// Size in bytes of one frame of a channel
+#define SPI_FRAME_BYTES(dataSize) (((dataSize) == SPI_DataSize_16b) ? 2u : 1u)
+
+/*
+* Function: Spi_ReadFrame
+* Description: Reads one frame from a channel buffer, or the default data without buffer.
+* Input:
+*   - Channel: Channel owning the buffer.
+*   - Buffer: Source buffer of the channel, NULL for the default data.
+*   - Index: Position of the frame.
+* Output:
+*   - The frame to write to DR.
+*/
+static uint16_t Spi_ReadFrame(Spi_ChannelType Channel, const Spi_DataBufferType* Buffer, Spi_NumberOfDataType Index) {
+    if (Buffer == NULL) {
+        return Spi_ChannelConfig[Channel].defaultData;
+    }
+    if (Spi_ChannelConfig[Channel].dataSize == SPI_DataSize_16b) {
+        return ((const uint16_t*)(const void*)Buffer)[Index];
+    }
+    return Buffer[Index];
+}
+
+/*
+* Function: Spi_WriteFrame
+* Description: Stores one received frame in a channel buffer, or drops it without buffer.
+* Input:
+*   - Channel: Channel owning the buffer.
+*   - Buffer: Destination buffer of the channel, NULL to drop the frame.
+*   - Index: Position of the frame.
+*   - Data: Frame read from DR.
+* Output: None
+*/
+static void Spi_WriteFrame(Spi_ChannelType Channel, Spi_DataBufferType* Buffer, Spi_NumberOfDataType Index, uint16_t Data) {
+    if (Buffer == NULL) {
+        return;
+    }
+    if (Spi_ChannelConfig[Channel].dataSize == SPI_DataSize_16b) {
+        ((uint16_t*)(void*)Buffer)[Index] = Data;
+    } else {
+        Buffer[Index] = (Spi_DataBufferType)Data;
+    }
+}
+
+/*
+* Function: Spi_SetDataSize
+* Description: Programs the frame size of a channel into its hardware unit before the channel
+*   starts. DFF can only change while the unit is disabled, so the unit is only stopped when the
+*   size actually differs from the previous channel.
+* Input:
+*   - HWUnit: Hardware unit about to transfer the channel.
+*   - Channel: Channel about to start.
+* Output: None
+*/
+static void Spi_SetDataSize(Spi_HWUnitType HWUnit, Spi_ChannelType Channel) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    uint16_t dataSize = Spi_ChannelConfig[Channel].dataSize;
+
+    if (unit->dataSize != dataSize) {
+        SPI_Cmd(Spi_HWUnitHw[HWUnit].regs, DISABLE);
+        SPI_DataSizeConfig(Spi_HWUnitHw[HWUnit].regs, dataSize);
+        SPI_Cmd(Spi_HWUnitHw[HWUnit].regs, ENABLE);
+        unit->dataSize = dataSize;
+    }
+}
+
+/*
+* Function: Spi_ChannelDone
+* Description: Called by the transfer engines when a channel has been transferred. An EB channel
+*   moves on to its other half, which the next transfer uses while the application owns this one.
+* Input:
+*   - Channel: Channel that has been transferred.
+* Output: None
+*/
+static void Spi_ChannelDone(Spi_ChannelType Channel) {
+    Spi_ChannelStateType* chState = &Spi_ChannelState[Channel];
+
+    if (Spi_ChannelConfig[Channel].bufferType == SPI_EB) {
+        chState->ebHalf ^= 1u;
+        chState->src = chState->ebSrc[chState->ebHalf];
+        chState->dst = chState->ebDst[chState->ebHalf];
+    }
+}
+
+/*
+* Function: Spi_ChannelInUse
+* Description: Checks whether a channel belongs to a job that is queued or in progress.
+* Input:
+*   - Channel: Channel to check.
+* Output:
+*   - 1: If the buffers of the channel may be accessed by a transfer engine.
+*   - 0: Otherwise.
+*/
+static uint8_t Spi_ChannelInUse(Spi_ChannelType Channel) {
+    for (Spi_JobType job = 0; job < SPI_MAX_JOB; job++) {
+        if (Spi_JobResult[job] != SPI_JOB_PENDING && Spi_JobResult[job] != SPI_JOB_QUEUED) {
+            continue;
+        }
+        for (uint8_t i = 0; i < Spi_JobConfig[job].numChannels; i++) {
+            if (Spi_JobConfig[job].channelList[i] == Channel) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+* Function: Spi_HWUnitsBusy
+* Description: Tells whether a hardware unit still has a job in progress, queued or in its
+*   interrupt ring, as a job of a cancelled sequence does until it ends.
+* Input: None
+* Output:
+*   - 1: If a unit is busy.
+*   - 0: Otherwise.
+*/
+static uint8_t Spi_HWUnitsBusy(void) {
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        if (Spi_GetHWUnitStatus((Spi_HWUnitType)hw) == SPI_BUSY) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+* Function: Spi_UpdateDriverStatus
+* Description: Sets the driver status back to SPI_IDLE once no sequence is pending and no unit is
+*   busy, so that Spi_MainFunction_Handling keeps advancing the job in progress of a cancelled
+*   sequence until its device is released.
+* Input: None
+* Output: None
+*/
+static void Spi_UpdateDriverStatus(void) {
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (Spi_DriverStatus == SPI_BUSY) {
+        uint8_t busy = Spi_HWUnitsBusy();
+        for (uint8_t seq = 0; seq < SPI_MAX_SEQUENCE && !busy; seq++) {
+            busy = (Spi_SequenceState[seq].result == SPI_SEQ_PENDING);
+        }
+        if (!busy) {
+            Spi_DriverStatus = SPI_IDLE;
+        }
+    }
+    SchM_Exit(state);
+}
+
+/*
+* Function: Spi_ProcessHWUnit
+* Description: Advances the job in progress on a hardware unit as far as the hardware allows
+*   without waiting: writes the next frame when TXE is set, reads the answer when RXNE is set,
+*   moves on to the next channel and the next queued job. Returns as soon as a flag is not set.
+* Input:
+*   - HWUnit: Hardware unit to process.
+* Output: None
+*/
+static void Spi_ProcessHWUnit(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    SPI_TypeDef* SPIx = Spi_HWUnitHw[HWUnit].regs;
+
+    for (;;) {
+        if (unit->activeJob == SPI_JOB_NONE && !Spi_StartNextJob(HWUnit)) {
+            return;
+        }
+
+        const Spi_JobConfigType* jobCfg = &Spi_JobConfig[unit->activeJob];
+        Spi_ChannelType channel = jobCfg->channelList[unit->channelIndex];
+        const Spi_ChannelStateType* chState = &Spi_ChannelState[channel];
+
+        if (unit->rxCount < chState->length) {
+            // Keep a single frame in flight so that RXNE can never overrun
+            if (unit->txCount == unit->rxCount) {
+                if (unit->txCount == 0) {
+                    Spi_SetDataSize(HWUnit, channel);
+                }
+                if (SPI_I2S_GetFlagStatus(SPIx, SPI_I2S_FLAG_TXE) == RESET) {
+                    return;
+                }
+                SPI_I2S_SendData(SPIx, Spi_ReadFrame(channel, chState->src, unit->txCount));
+                unit->txCount++;
+            }
+            if (SPI_I2S_GetFlagStatus(SPIx, SPI_I2S_FLAG_RXNE) == RESET) {
+                return;
+            }
+            Spi_WriteFrame(channel, chState->dst, unit->rxCount, SPI_I2S_ReceiveData(SPIx));
+            unit->rxCount++;
+            Spi_HWUnitStats[HWUnit].frames++;
+        } else if (unit->channelIndex + 1u < jobCfg->numChannels) {
+            // Next channel of the job, the device stays selected
+            Spi_ChannelDone(channel);
+            unit->channelIndex++;
+            unit->txCount = 0;
+            unit->rxCount = 0;
+        } else {
+            Spi_ChannelDone(channel);
+            Spi_FinishJob(HWUnit, SPI_JOB_OK);
+        }
+    }
+}
+
+/*
+* Function: Spi_DmaCmd
+* Description: Enables or disables the DMA path of a hardware unit: configures its RX and TX
+*   streams, the SPI DMA requests, the RX transfer complete interrupt and the transfer error
+*   interrupts of both streams. The streams are claimed
+*   by Spi_SetAsyncMode before and released here after.
+* Input:
+*   - HWUnit: Hardware unit to configure.
+*   - NewState: ENABLE or DISABLE.
+* Output: None
+*/
+static void Spi_DmaCmd(Spi_HWUnitType HWUnit, FunctionalState NewState) {
+    const Spi_DmaStreamType* dma = &Spi_HWUnitHw[HWUnit].dma;
+    SPI_TypeDef* SPIx = Spi_HWUnitHw[HWUnit].regs;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    if (NewState != DISABLE) {
+        DMA_InitTypeDef DMA_InitStruct;
+
+        RCC_AHB1PeriphClockCmd(dma->ahb1Periph, ENABLE);
+        DMA_DeInit(dma->rxStream);
+        DMA_DeInit(dma->txStream);
+
+        // Memory address, length and data sizes are set per channel by Spi_DmaStartChannel
+        DMA_InitStruct.DMA_Channel = dma->channel;
+        DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&SPIx->DR;
+        DMA_InitStruct.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)&Spi_DmaRxSink[HWUnit];
+        DMA_InitStruct.DMA_BufferSize = 1;
+        DMA_InitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+        DMA_InitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+        DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+        DMA_InitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+        DMA_InitStruct.DMA_Mode = DMA_Mode_Normal;
+        DMA_InitStruct.DMA_Priority = DMA_Priority_High;
+        DMA_InitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+        DMA_InitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+        DMA_InitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+        DMA_InitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+
+        DMA_InitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+        DMA_Init(dma->rxStream, &DMA_InitStruct);
+        DMA_InitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+        DMA_Init(dma->txStream, &DMA_InitStruct);
+
+        // The RX stream finishes last, its interrupt ends the channel. A TX stream stopped by an
+        // error would leave the RX stream waiting forever, so its error interrupt fails the job.
+        DMA_ITConfig(dma->rxStream, DMA_IT_TC | DMA_IT_TE, ENABLE);
+        DMA_ITConfig(dma->txStream, DMA_IT_TE, ENABLE);
+        SPI_I2S_DMACmd(SPIx, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+    } else {
+        SPI_I2S_DMACmd(SPIx, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+        DMA_Cmd(dma->rxStream, DISABLE);
+        DMA_Cmd(dma->txStream, DISABLE);
+        Dma_ReleaseStreams(dma->rxStream, dma->txStream);
+    }
+
+    NVIC_InitStruct.NVIC_IRQChannel = dma->rxIRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = NewState;
+    NVIC_Init(&NVIC_InitStruct);
+    NVIC_InitStruct.NVIC_IRQChannel = dma->txIRQn;
+    NVIC_Init(&NVIC_InitStruct);
+}
+
+/*
+* Function: Spi_DmaStartChannel
+* Description: Starts the DMA transfer of a whole channel. Channels without source buffer repeat
+*   their default data, channels without destination buffer discard what they receive.
+* Input:
+*   - HWUnit: Hardware unit of the transfer.
+*   - Channel: Channel to transfer.
+* Output: None
+*/
+static void Spi_DmaStartChannel(Spi_HWUnitType HWUnit, Spi_ChannelType Channel) {
+    const Spi_DmaStreamType* dma = &Spi_HWUnitHw[HWUnit].dma;
+    const Spi_ChannelStateType* chState = &Spi_ChannelState[Channel];
+    // Peripheral and memory side move whole frames
+    uint32_t size = (Spi_ChannelConfig[Channel].dataSize == SPI_DataSize_16b)
+                    ? (DMA_PeripheralDataSize_HalfWord | DMA_MemoryDataSize_HalfWord)
+                    : (DMA_PeripheralDataSize_Byte | DMA_MemoryDataSize_Byte);
+
+    Spi_SetDataSize(HWUnit, Channel);
+    DMA_ClearFlag(dma->rxStream, dma->rxFlags);
+    DMA_ClearFlag(dma->txStream, dma->txFlags);
+
+    if (chState->dst != NULL) {
+        DMA_MemoryTargetConfig(dma->rxStream, (uint32_t)(uintptr_t)chState->dst, DMA_Memory_0);
+        dma->rxStream->CR |= DMA_SxCR_MINC;
+    } else {
+        DMA_MemoryTargetConfig(dma->rxStream, (uint32_t)(uintptr_t)&Spi_DmaRxSink[HWUnit], DMA_Memory_0);
+        dma->rxStream->CR &= ~DMA_SxCR_MINC;
+    }
+    if (chState->src != NULL) {
+        DMA_MemoryTargetConfig(dma->txStream, (uint32_t)(uintptr_t)chState->src, DMA_Memory_0);
+        dma->txStream->CR |= DMA_SxCR_MINC;
+    } else {
+        Spi_DmaTxDefault[HWUnit] = Spi_ChannelConfig[Channel].defaultData;
+        DMA_MemoryTargetConfig(dma->txStream, (uint32_t)(uintptr_t)&Spi_DmaTxDefault[HWUnit], DMA_Memory_0);
+        dma->txStream->CR &= ~DMA_SxCR_MINC;
+    }
+    dma->rxStream->CR = (dma->rxStream->CR & ~(DMA_SxCR_PSIZE | DMA_SxCR_MSIZE)) | size;
+    dma->txStream->CR = (dma->txStream->CR & ~(DMA_SxCR_PSIZE | DMA_SxCR_MSIZE)) | size;
+    DMA_SetCurrDataCounter(dma->rxStream, chState->length);
+    DMA_SetCurrDataCounter(dma->txStream, chState->length);
+
+    // Receiver first, so that no frame is missed once the transmitter runs
+    DMA_Cmd(dma->rxStream, ENABLE);
+    DMA_Cmd(dma->txStream, ENABLE);
+}
+
+/*
+* Function: Spi_DmaProcessHWUnit
+* Description: Advances the job in progress on a DMA hardware unit: starts the transfer of the
+*   next channel, or ends the job and starts the next queued one. Called when a job has been
+*   started and from the RX transfer complete interrupt.
+* Input:
+*   - HWUnit: Hardware unit to process.
+* Output: None
+*/
+static void Spi_DmaProcessHWUnit(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+
+    for (;;) {
+        if (unit->activeJob == SPI_JOB_NONE && !Spi_StartNextJob(HWUnit)) {
+            return;
+        }
+
+        const Spi_JobConfigType* jobCfg = &Spi_JobConfig[unit->activeJob];
+        Spi_ChannelType channel = jobCfg->channelList[unit->channelIndex];
+        Spi_NumberOfDataType length = Spi_ChannelState[channel].length;
+
+        if (unit->rxCount < length) {
+            // The whole channel is handed to the DMA, the interrupt resumes here
+            if (unit->txCount == 0) {
+                unit->txCount = length;
+                Spi_DmaStartChannel(HWUnit, channel);
+            }
+            return;
+        } else if (unit->channelIndex + 1u < jobCfg->numChannels) {
+            Spi_ChannelDone(channel);
+            unit->channelIndex++;
+            unit->txCount = 0;
+            unit->rxCount = 0;
+        } else {
+            Spi_ChannelDone(channel);
+            Spi_FinishJob(HWUnit, SPI_JOB_OK);
+        }
+    }
+}
+
+/*
+* Function: Spi_DmaIrqHandler
+* Description: Handles the stream interrupts of a DMA hardware unit: completes the channel,
+*   or fails the job on a transfer error of either stream, and continues with the next transfer.
+* Input:
+*   - HWUnit: Hardware unit whose RX or TX stream raised the interrupt.
+* Output: None
+*/
+static void Spi_DmaIrqHandler(Spi_HWUnitType HWUnit) {
+    const Spi_DmaStreamType* dma = &Spi_HWUnitHw[HWUnit].dma;
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+
+    if (DMA_GetFlagStatus(dma->rxStream, dma->errorFlags & dma->rxFlags) == SET ||
+        DMA_GetFlagStatus(dma->txStream, dma->errorFlags & dma->txFlags) == SET) {
+        DMA_Cmd(dma->rxStream, DISABLE);
+        DMA_Cmd(dma->txStream, DISABLE);
+        DMA_ClearFlag(dma->rxStream, dma->rxFlags);
+        DMA_ClearFlag(dma->txStream, dma->txFlags);
+        if (unit->activeJob != SPI_JOB_NONE) {
+            Spi_FinishJob(HWUnit, SPI_JOB_FAILED);
+        }
+    } else if (DMA_GetFlagStatus(dma->rxStream, dma->rxCompleteFlag) == SET) {
+        DMA_ClearFlag(dma->rxStream, dma->rxFlags);
+        if (unit->activeJob == SPI_JOB_NONE) {
+            return;
+        }
+        unit->rxCount = unit->txCount;
+        Spi_HWUnitStats[HWUnit].frames += unit->rxCount;
+    } else {
+        return;
+    }
+
+    Spi_DmaProcessHWUnit(HWUnit);
+    Spi_UpdateDriverStatus();
+}
+
+/* RX and TX stream interrupts of the three hardware units */
+void DMA2_Stream0_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_0);
+}
+
+void DMA2_Stream3_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_0);
+}
+
+void DMA1_Stream3_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_1);
+}
+
+void DMA1_Stream4_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_1);
+}
+
+void DMA1_Stream0_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_2);
+}
+
+void DMA1_Stream5_IRQHandler(void) {
+    Spi_DmaIrqHandler(SPI_HWUnit_2);
+}
+
+/*
+* Function: Spi_IrqCmd
+* Description: Enables or disables the interrupt path of a hardware unit. RXNE ends every frame;
+*   TXE is only enabled by Spi_IrqFillRing to wake an idle unit.
+* Input:
+*   - HWUnit: Hardware unit to configure.
+*   - NewState: ENABLE or DISABLE.
+* Output: None
+*/
+static void Spi_IrqCmd(Spi_HWUnitType HWUnit, FunctionalState NewState) {
+    SPI_TypeDef* SPIx = Spi_HWUnitHw[HWUnit].regs;
+    NVIC_InitTypeDef NVIC_InitStruct;
+
+    SPI_I2S_ITConfig(SPIx, SPI_I2S_IT_TXE, DISABLE);
+    SPI_I2S_ITConfig(SPIx, SPI_I2S_IT_RXNE, NewState);
+
+    NVIC_InitStruct.NVIC_IRQChannel = Spi_HWUnitHw[HWUnit].irqn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = NewState;
+    NVIC_Init(&NVIC_InitStruct);
+}
+
+/*
+* Function: Spi_IrqFillRing
+* Description: Moves queued jobs of an interrupt-driven hardware unit into its ring, highest
+*   priority first, as long as every channel of the next job fits, then wakes the unit. Runs in
+*   the task context, which is the only producer of the ring. Jobs in the ring are served in
+*   order, so the ring size bounds how long a higher priority job can be delayed.
+* Input:
+*   - HWUnit: Hardware unit to feed.
+* Output: None
+*/
+static void Spi_IrqFillRing(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    Spi_IrqRingType* ring = &Spi_IrqRing[HWUnit];
+    uint8_t head = ring->head;
+    SchM_StateType state;
+
+    for (;;) {
+        Spi_JobType job;
+
+        SchM_Enter(state);
+        if (unit->queueCount == 0 ||
+            Spi_JobConfig[unit->queue[0]].numChannels > (uint8_t)(SPI_IRQ_RING_SIZE - (uint8_t)(head - ring->tail))) {
+            SchM_Exit(state);
+            break;
+        }
+        job = Spi_DequeueJob(HWUnit);
+        SchM_Exit(state);
+
+        const Spi_JobConfigType* jobCfg = &Spi_JobConfig[job];
+        for (uint8_t i = 0; i < jobCfg->numChannels; i++) {
+            Spi_IrqRingEntryType* entry = &ring->entry[head & SPI_IRQ_RING_MASK];
+            entry->job = job;
+            entry->channel = jobCfg->channelList[i];
+            entry->lastChannel = (i + 1u == jobCfg->numChannels);
+            head++;
+        }
+    }
+
+    if (head != ring->head) {
+        // Publish the slots, then raise TXE so that an idle unit picks them up
+        SchM_MemoryBarrier();
+        ring->head = head;
+        SPI_I2S_ITConfig(Spi_HWUnitHw[HWUnit].regs, SPI_I2S_IT_TXE, ENABLE);
+    }
+}
+
+/*
+* Function: Spi_IrqHandler
+* Description: Interrupt handler of a hardware unit in SPI_INTERRUPT_MODE, the only consumer of
+*   its ring. Stores the frame received, then writes the next frame of the channel in progress,
+*   or releases the channel, ends its job and starts the next one of the ring. A single frame is
+*   in flight, so RXNE can never overrun.
+* Input:
+*   - HWUnit: Hardware unit that raised the interrupt.
+* Output: None
+*/
+static void Spi_IrqHandler(Spi_HWUnitType HWUnit) {
+    Spi_HWUnitStateType* unit = &Spi_HWUnitState[HWUnit];
+    Spi_IrqRingType* ring = &Spi_IrqRing[HWUnit];
+    SPI_TypeDef* SPIx = Spi_HWUnitHw[HWUnit].regs;
+
+    Spi_HWUnitStats[HWUnit].interrupts++;
+
+    if (unit->txCount != unit->rxCount) {
+        if (SPI_I2S_GetFlagStatus(SPIx, SPI_I2S_FLAG_RXNE) == RESET) {
+            // TXE raised by a ring refill while the unit is busy: the ring is served without it
+            SPI_I2S_ITConfig(SPIx, SPI_I2S_IT_TXE, DISABLE);
+            return;
+        }
+        Spi_ChannelType channel = ring->entry[ring->tail & SPI_IRQ_RING_MASK].channel;
+        Spi_WriteFrame(channel, Spi_ChannelState[channel].dst, unit->rxCount, SPI_I2S_ReceiveData(SPIx));
+        unit->rxCount++;
+        Spi_HWUnitStats[HWUnit].frames++;
+    }
+
+    for (;;) {
+        if (ring->tail == ring->head) {
+            // Nothing left: stop the TXE wake-up until the task fills the ring again
+            SPI_I2S_ITConfig(SPIx, SPI_I2S_IT_TXE, DISABLE);
+            return;
+        }
+        SchM_MemoryBarrier();
+
+        const Spi_IrqRingEntryType* entry = &ring->entry[ring->tail & SPI_IRQ_RING_MASK];
+        const Spi_ChannelStateType* chState = &Spi_ChannelState[entry->channel];
+
+        if (unit->activeJob == SPI_JOB_NONE) {
+            SPI_I2S_ITConfig(SPIx, SPI_I2S_IT_TXE, DISABLE);
+            Spi_SelectDevice(HWUnit, entry->job);
+        }
+        if (unit->txCount < chState->length) {
+            if (unit->txCount == 0) {
+                Spi_SetDataSize(HWUnit, entry->channel);
+            }
+            SPI_I2S_SendData(SPIx, Spi_ReadFrame(entry->channel, chState->src, unit->txCount));
+            unit->txCount++;
+            return;
+        }
+
+        // Channel complete, release its slot; the device stays selected until the last one
+        uint8_t lastChannel = entry->lastChannel;
+        Spi_ChannelDone(entry->channel);
+        unit->txCount = 0;
+        unit->rxCount = 0;
+        SchM_MemoryBarrier();
+        ring->tail++;
+        if (lastChannel) {
+            Spi_FinishJob(HWUnit, SPI_JOB_OK);
+            Spi_UpdateDriverStatus();
+        }
+    }
+}
+
+/* SPI interrupts of the three hardware units */
+void SPI1_IRQHandler(void) {
+    Spi_IrqHandler(SPI_HWUnit_0);
+}
+
+void SPI2_IRQHandler(void) {
+    Spi_IrqHandler(SPI_HWUnit_1);
+}
+
+void SPI3_IRQHandler(void) {
+    Spi_IrqHandler(SPI_HWUnit_2);
+}
 
 /*
 * Function: Spi_Init
-* Description: Initializes the SPI peripheral with the provided configuration.
+* Description: Initializes the SPI hardware units used by the configuration. Each enabled unit of
+*   Spi_HWUnitConfig gets its own bus settings and asynchronous mode and runs its own queue, so
+*   the units work independently and in parallel.
 * Input:
-*   - ConfigPtr: Pointer to the configuration structure containing SPI settings.
+*   - ConfigPtr: Bus settings applied to every enabled unit, NULL to use the settings of each
+*     unit in Spi_HWUnitConfig.
 * Output:
 *   - E_OK: If initialization is successful.
-*   - E_NOT_OK: If the configuration pointer is NULL.
+*   - E_NOT_OK: If the driver is busy or a unit still has a job.
 */
 
 Std_ReturnType Spi_Init(const Spi_ConfigType* ConfigPtr) {
-		RCC_APB2PeriphClockCmd(RCC_APB2Periph_SPI1, ENABLE);
-    // Check if the configuration pointer is valid
-    if (ConfigPtr == NULL) {
-        return E_NOT_OK; // Return error code if the pointer is NULL
-    }
-
-    // Initialize SPI structure
-    SPI_InitTypeDef SPI_InitStruct;
-
-    // Configure SPI settings from the provided configuration
-    SPI_InitStruct.SPI_Direction = ConfigPtr->direction;
-    SPI_InitStruct.SPI_Mode = ConfigPtr->mode;
-    SPI_InitStruct.SPI_DataSize = ConfigPtr->dataSize;
-    SPI_InitStruct.SPI_CPOL = ConfigPtr->clockPolarity;
-    SPI_InitStruct.SPI_CPHA = ConfigPtr->clockPhase;
-    SPI_InitStruct.SPI_NSS = ConfigPtr->nss;
-    SPI_InitStruct.SPI_BaudRatePrescaler = ConfigPtr->baudRatePrescaler;
-    SPI_InitStruct.SPI_FirstBit = ConfigPtr->firstBit;
-    SPI_InitStruct.SPI_CRCPolynomial = ConfigPtr->crcPolynomial;
+    if (Spi_DriverStatus == SPI_BUSY || Spi_HWUnitsBusy()) {
+        return E_NOT_OK;
+    }
+
+    // Cycle counter for the statistics
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Apply the settings to every enabled hardware unit and reset its queue
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        const Spi_HWUnitConfigType* unitCfg = &Spi_HWUnitConfig[hw];
+        const Spi_ConfigType* settings = (ConfigPtr != NULL) ? ConfigPtr : &unitCfg->settings;
+
+        if (Spi_DriverStatus != SPI_UNINIT && Spi_HWUnitMode[hw] == SPI_DMA_MODE) {
+            Spi_DmaCmd((Spi_HWUnitType)hw, DISABLE);
+        } else if (Spi_DriverStatus != SPI_UNINIT && Spi_HWUnitMode[hw] == SPI_INTERRUPT_MODE) {
+            Spi_IrqCmd((Spi_HWUnitType)hw, DISABLE);
+        }
+
+        Spi_HWUnitState[hw].queueCount = 0;
+        Spi_HWUnitState[hw].activeJob = SPI_JOB_NONE;
+        Spi_HWUnitState[hw].dataSize = settings->dataSize;
+        Spi_HWUnitMode[hw] = SPI_POLLING_MODE;
+        Spi_IrqRing[hw].head = 0;
+        Spi_IrqRing[hw].tail = 0;
+        Spi_ResetHWUnitStats((Spi_HWUnitType)hw);
+
+        if (!unitCfg->enabled) {
+            continue;
+        }
+
+        SPI_InitTypeDef SPI_InitStruct;
+        SPI_InitStruct.SPI_Direction = settings->direction;
+        SPI_InitStruct.SPI_Mode = settings->mode;
+        SPI_InitStruct.SPI_DataSize = settings->dataSize;
+        SPI_InitStruct.SPI_CPOL = settings->clockPolarity;
+        SPI_InitStruct.SPI_CPHA = settings->clockPhase;
+        SPI_InitStruct.SPI_NSS = settings->nss;
+        SPI_InitStruct.SPI_BaudRatePrescaler = settings->baudRatePrescaler;
+        SPI_InitStruct.SPI_FirstBit = settings->firstBit;
+        SPI_InitStruct.SPI_CRCPolynomial = settings->crcPolynomial;
+
+        Spi_HWUnitClockCmd((Spi_HWUnitType)hw, ENABLE);
+        SPI_Init(Spi_HWUnitHw[hw].regs, &SPI_InitStruct);
+        SPI_Cmd(Spi_HWUnitHw[hw].regs, ENABLE);
+    }
+
+    // Attach the internal buffers to the IB channels, EB channels wait for Spi_SetupEB
+    for (Spi_ChannelType ch = 0; ch < SPI_MAX_CHANNEL; ch++) {
+        const Spi_ChannelConfigType* chCfg = &Spi_ChannelConfig[ch];
+        Spi_ChannelStateType* chState = &Spi_ChannelState[ch];
+        chState->src = (chCfg->bufferType == SPI_IB) ? chCfg->txBuffer : NULL;
+        chState->dst = (chCfg->bufferType == SPI_IB) ? chCfg->rxBuffer : NULL;
+        chState->length = (chCfg->bufferType == SPI_IB) ? chCfg->length : 0;
+        chState->ebSrc[0] = chState->ebSrc[1] = NULL;
+        chState->ebDst[0] = chState->ebDst[1] = NULL;
+        chState->ebHalf = 0;
+    }
+    for (Spi_JobType job = 0; job < SPI_MAX_JOB; job++) {
+        Spi_JobResult[job] = SPI_JOB_OK;
+    }
+    for (Spi_SequenceType seq = 0; seq < SPI_MAX_SEQUENCE; seq++) {
+        Spi_SequenceState[seq].result = SPI_SEQ_OK;
+        Spi_SequenceState[seq].remainingJobs = 0;
+    }
+
+    Spi_DriverStatus = SPI_IDLE;
+
+    // Configured asynchronous mode of each unit
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        if (Spi_HWUnitConfig[hw].enabled) {
+            Spi_SetAsyncMode((Spi_HWUnitType)hw, Spi_HWUnitConfig[hw].asyncMode);
+        }
+    }
 
     // Return success status
     return E_OK;
@@ -50,99 +947,298 @@ Std_ReturnType Spi_Init(const Spi_ConfigType* ConfigPtr) {
 * Input: None
 * Output:
 *   - E_OK: If deinitialization is successful.
+*   - E_NOT_OK: If a sequence is still pending or a unit still has a job.
 */
 
 Std_ReturnType Spi_DeInit(void) {
-    // Deinitialize SPI peripheral
-    SPI_DeInit(SPI1);
+    if (Spi_DriverStatus == SPI_BUSY || Spi_HWUnitsBusy()) {
+        return E_NOT_OK;
+    }
+
+    // Deinitialize every SPI peripheral in use
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        if (!Spi_HWUnitConfig[hw].enabled) {
+            continue;
+        }
+        if (Spi_HWUnitMode[hw] == SPI_DMA_MODE) {
+            Spi_DmaCmd((Spi_HWUnitType)hw, DISABLE);
+        } else if (Spi_HWUnitMode[hw] == SPI_INTERRUPT_MODE) {
+            Spi_IrqCmd((Spi_HWUnitType)hw, DISABLE);
+        }
+        SPI_DeInit(Spi_HWUnitHw[hw].regs);
+        Spi_HWUnitClockCmd((Spi_HWUnitType)hw, DISABLE);
+    }
+    Spi_DriverStatus = SPI_UNINIT;
+
     // Return success status
     return E_OK;
 }
 
 /*
 * Function: Spi_WriteIB
-* Description: Writes data to the SPI peripheral using interrupt-based transmission.
+* Description: Writes the data to transmit into the internal buffer of an IB channel.
 * Input:
-*   - DataBufferPtr: Pointer to the data buffer containing the data to be transmitted.
+*   - Channel: IB channel to write.
+*   - DataBufferPtr: Pointer to the data to be transmitted, NULL to transmit the default data. For
+*     16-bit channels it holds the frames in memory order, without alignment requirement.
 * Output:
-*   - E_OK: If data transmission is successful.
-*   - E_NOT_OK: If the data buffer pointer is NULL.
+*   - E_OK: If the data has been copied.
+*   - E_NOT_OK: If the channel is invalid, is not an IB channel or has no transmit buffer.
 */
 
-Std_ReturnType Spi_WriteIB(const uint8_t* DataBufferPtr) {
-    // Check if the data buffer pointer is valid
-    if (DataBufferPtr == NULL) {
-        return E_NOT_OK; // Return error code if the pointer is NULL
+Std_ReturnType Spi_WriteIB(Spi_ChannelType Channel, const Spi_DataBufferType* DataBufferPtr) {
+    if (Spi_DriverStatus == SPI_UNINIT || Channel >= SPI_MAX_CHANNEL ||
+        Spi_ChannelConfig[Channel].bufferType != SPI_IB) {
+        return E_NOT_OK;
     }
-    
-    // Wait until SPI is ready for transmission
-    while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_TXE) == RESET);
 
-    // Send data via SPI
-    SPI_I2S_SendData(SPI1, *DataBufferPtr);
+    const Spi_ChannelConfigType* chCfg = &Spi_ChannelConfig[Channel];
+
+    if (DataBufferPtr == NULL) {
+        // Transmit the default data
+        Spi_ChannelState[Channel].src = NULL;
+        return E_OK;
+    }
+    if (chCfg->txBuffer == NULL) {
+        return E_NOT_OK;
+    }
+    uint32_t bytes = (uint32_t)chCfg->length * SPI_FRAME_BYTES(chCfg->dataSize);
+    for (uint32_t i = 0; i < bytes; i++) {
+        chCfg->txBuffer[i] = DataBufferPtr[i];
+    }
+    Spi_ChannelState[Channel].src = chCfg->txBuffer;
 
     // Return success status
     return E_OK;
 }
 
+/*
+* Function: Spi_ReadIB
+* Description: Reads the data received in the internal buffer of an IB channel.
+* Input:
+*   - Channel: IB channel to read.
+*   - DataBufferPtr: Pointer to the buffer receiving the data, two bytes per frame on 16-bit channels.
+* Output:
+*   - E_OK: If the data has been copied.
+*   - E_NOT_OK: If the channel is invalid, is not an IB channel or the pointer is NULL.
+*/
+
+Std_ReturnType Spi_ReadIB(Spi_ChannelType Channel, Spi_DataBufferType* DataBufferPtr) {
+    if (Spi_DriverStatus == SPI_UNINIT || Channel >= SPI_MAX_CHANNEL || DataBufferPtr == NULL ||
+        Spi_ChannelConfig[Channel].bufferType != SPI_IB || Spi_ChannelConfig[Channel].rxBuffer == NULL) {
+        return E_NOT_OK;
+    }
+
+    const Spi_ChannelConfigType* chCfg = &Spi_ChannelConfig[Channel];
+    uint32_t bytes = (uint32_t)chCfg->length * SPI_FRAME_BYTES(chCfg->dataSize);
+    for (uint32_t i = 0; i < bytes; i++) {
+        DataBufferPtr[i] = chCfg->rxBuffer[i];
+    }
+    return E_OK;
+}
+
 /*
 * Function: Spi_SetupEB
-* Description: Sets up SPI for transmission and reception using interrupt-based communication.
+* Description: Binds caller-owned buffers to an EB channel. The binding stays until the next call,
+*   every transmission of the channel then reads and writes these buffers directly.
 * Input:
-*   - ConfigPtr: Pointer to the SPI configuration structure.
-*   - SrcDataBufferPtr: Pointer to the source data buffer containing the data to be transmitted.
-*   - DesDataBufferPtr: Pointer to the destination data buffer to store the received data.
-*   - Length: Length of the data to be transmitted and received.
+*   - Channel: EB channel to set up.
+*   - SrcDataBufferPtr: Pointer to the data to be transmitted, NULL to transmit the default data.
+*   - DesDataBufferPtr: Pointer to the buffer receiving the data, NULL to discard it.
+*   - Length: Number of frames to transfer.
 * Output:
-*   - E_OK: If data transmission and reception are successful.
-*   - E_NOT_OK: If any of the pointers is NULL or if data transmission fails.
+*   - E_OK: If the buffers have been bound.
+*   - E_NOT_OK: If the channel is invalid, is not an EB channel, is longer than configured, has
+*     16-bit frames and a buffer that is not 2-byte aligned, or belongs to a job that is queued or
+*     in progress.
 */
 
-Std_ReturnType Spi_SetupEB(const Spi_ConfigType* ConfigPtr, const uint8_t* SrcDataBufferPtr, uint8_t* DesDataBufferPtr, uint16_t Length) {
-    // Check if any of the pointers is NULL
-    if (ConfigPtr == NULL || SrcDataBufferPtr == NULL || DesDataBufferPtr == NULL) {
-        return E_NOT_OK; // Return error code if any pointer is NULL
+Std_ReturnType Spi_SetupEB(Spi_ChannelType Channel, const Spi_DataBufferType* SrcDataBufferPtr, Spi_DataBufferType* DesDataBufferPtr, Spi_NumberOfDataType Length) {
+    const Spi_DataBufferType* src[2] = { SrcDataBufferPtr, SrcDataBufferPtr };
+    Spi_DataBufferType* dst[2] = { DesDataBufferPtr, DesDataBufferPtr };
+
+    return Spi_SetupEBPingPong(Channel, src, dst, Length);
+}
+
+/*
+* Function: Spi_SetupEBPingPong
+* Description: Binds two caller-owned buffer pairs to an EB channel. Transmissions of the channel
+*   alternate between them, starting with the first pair, so the application can fill or read one
+*   pair while the other one is transferred; Spi_GetEBBuffers returns the pair it owns.
+* Input:
+*   - Channel: EB channel to set up.
+*   - SrcDataBufferPtr: Data to be transmitted by each half, NULL entries transmit the default data.
+*   - DesDataBufferPtr: Buffers receiving the data of each half, NULL entries discard it.
+*   - Length: Number of frames to transfer.
+* Output:
+*   - E_OK: If the buffers have been bound.
+*   - E_NOT_OK: If the channel is invalid, is not an EB channel, is longer than configured, has
+*     16-bit frames and a buffer that is not 2-byte aligned, or belongs to a job that is queued or
+*     in progress.
+*/
+
+Std_ReturnType Spi_SetupEBPingPong(Spi_ChannelType Channel, const Spi_DataBufferType* const SrcDataBufferPtr[2], Spi_DataBufferType* const DesDataBufferPtr[2], Spi_NumberOfDataType Length) {
+    if (Spi_DriverStatus == SPI_UNINIT || Channel >= SPI_MAX_CHANNEL || SrcDataBufferPtr == NULL ||
+        DesDataBufferPtr == NULL || Spi_ChannelConfig[Channel].bufferType != SPI_EB ||
+        Length > Spi_ChannelConfig[Channel].length) {
+        return E_NOT_OK;
     }
+    // Frames of 16-bit channels are accessed as uint16_t
+    if (Spi_ChannelConfig[Channel].dataSize == SPI_DataSize_16b &&
+        ((((uintptr_t)SrcDataBufferPtr[0] | (uintptr_t)SrcDataBufferPtr[1] |
+           (uintptr_t)DesDataBufferPtr[0] | (uintptr_t)DesDataBufferPtr[1]) & 1u) != 0)) {
+        return E_NOT_OK;
+    }
+
+    Spi_ChannelStateType* chState = &Spi_ChannelState[Channel];
+    SchM_StateType state;
 
-    // Initialize SPI with the provided configuration
-    if (Spi_Init(ConfigPtr) != E_OK) {
-        return E_NOT_OK; // Return error code if initialization fails
+    SchM_Enter(state);
+    if (Spi_ChannelInUse(Channel)) {
+        SchM_Exit(state);
+        return E_NOT_OK;
     }
+    chState->ebSrc[0] = SrcDataBufferPtr[0];
+    chState->ebSrc[1] = SrcDataBufferPtr[1];
+    chState->ebDst[0] = DesDataBufferPtr[0];
+    chState->ebDst[1] = DesDataBufferPtr[1];
+    chState->ebHalf = 0;
+    chState->src = SrcDataBufferPtr[0];
+    chState->dst = DesDataBufferPtr[0];
+    chState->length = Length;
+    SchM_Exit(state);
 
-    // Transmit and receive data
-    for (uint16_t i = 0; i < Length; i++) {
-        // Send data from source buffer
-        if (Spi_WriteIB(&SrcDataBufferPtr[i]) != E_OK) {
-            return E_NOT_OK; // Return error code if data transmission fails
+    return E_OK;
+}
+
+/*
+* Function: Spi_GetEBBuffers
+* Description: Returns the buffers of an EB channel owned by the application: the half that is not
+*   used by the next transmission. After a transmission it holds the data just received and is
+*   the one to fill for the transmission after next.
+* Input:
+*   - Channel: EB channel to read.
+*   - SrcDataBufferPtr: Receives the transmit buffer of the half, may be NULL.
+*   - DesDataBufferPtr: Receives the receive buffer of the half, may be NULL.
+* Output:
+*   - E_OK: If the buffers have been returned.
+*   - E_NOT_OK: If the channel is invalid or is not an EB channel.
+*/
+
+Std_ReturnType Spi_GetEBBuffers(Spi_ChannelType Channel, const Spi_DataBufferType** SrcDataBufferPtr, Spi_DataBufferType** DesDataBufferPtr) {
+    if (Spi_DriverStatus == SPI_UNINIT || Channel >= SPI_MAX_CHANNEL ||
+        Spi_ChannelConfig[Channel].bufferType != SPI_EB) {
+        return E_NOT_OK;
+    }
+
+    const Spi_ChannelStateType* chState = &Spi_ChannelState[Channel];
+    uint8_t half = chState->ebHalf ^ 1u;
+
+    if (SrcDataBufferPtr != NULL) {
+        *SrcDataBufferPtr = chState->ebSrc[half];
+    }
+    if (DesDataBufferPtr != NULL) {
+        *DesDataBufferPtr = chState->ebDst[half];
+    }
+    return E_OK;
+}
+
+/*
+* Function: Spi_AsyncTransmit
+* Description: Queues all jobs of a sequence on their hardware units and returns immediately.
+*   Units in DMA or interrupt mode start at once and continue from their interrupts, units in
+*   polling mode are served by Spi_MainFunction_Handling; jobs on different hardware units
+*   proceed in parallel, jobs sharing a unit are served by decreasing priority.
+* Input:
+*   - Sequence: Sequence to transmit.
+* Output:
+*   - E_OK: If the sequence has been queued.
+*   - E_NOT_OK: If the sequence is invalid, already pending, shares a job with a pending sequence
+*     or uses a hardware unit that is not enabled.
+*/
+
+Std_ReturnType Spi_AsyncTransmit(Spi_SequenceType Sequence) {
+    if (Spi_DriverStatus == SPI_UNINIT || Sequence >= SPI_MAX_SEQUENCE) {
+        return E_NOT_OK;
+    }
+
+    const Spi_SequenceConfigType* seqCfg = &Spi_SequenceConfig[Sequence];
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (Spi_SequenceState[Sequence].result == SPI_SEQ_PENDING) {
+        SchM_Exit(state);
+        return E_NOT_OK;
+    }
+    // A job can only be owned by one pending sequence at a time, and needs its unit
+    for (uint8_t i = 0; i < seqCfg->numJobs; i++) {
+        Spi_JobResultType result = Spi_JobResult[seqCfg->jobList[i]];
+        if (result == SPI_JOB_PENDING || result == SPI_JOB_QUEUED ||
+            !Spi_HWUnitConfig[Spi_JobConfig[seqCfg->jobList[i]].hwUnit].enabled) {
+            SchM_Exit(state);
+            return E_NOT_OK;
         }
+    }
 
-        // Wait until data is received
-        while (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_RXNE) == RESET);
+    Spi_SequenceState[Sequence].result = SPI_SEQ_PENDING;
+    Spi_SequenceState[Sequence].remainingJobs = seqCfg->numJobs;
+    uint32_t now = SPI_GET_CYCLES();
+    for (uint8_t i = 0; i < seqCfg->numJobs; i++) {
+        Spi_JobType job = seqCfg->jobList[i];
+        Spi_JobSequence[job] = Sequence;
+        Spi_JobQueuedAt[job] = now;
+        Spi_JobResult[job] = SPI_JOB_QUEUED;
+        Spi_EnqueueJob(job);
+    }
+    Spi_DriverStatus = SPI_BUSY;
+    SchM_Exit(state);
 
-        // Receive data into destination buffer
-        DesDataBufferPtr[i] = SPI_I2S_ReceiveData(SPI1);
+    // Start the idle DMA units and feed the interrupt units, the others wait for the main function
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        if (Spi_HWUnitMode[hw] == SPI_DMA_MODE && Spi_StartNextJob((Spi_HWUnitType)hw)) {
+            Spi_DmaProcessHWUnit((Spi_HWUnitType)hw);
+        } else if (Spi_HWUnitMode[hw] == SPI_INTERRUPT_MODE) {
+            Spi_IrqFillRing((Spi_HWUnitType)hw);
+        }
     }
 
-    // Return success status
     return E_OK;
 }
 
 /*
 * Function: Spi_GetStatus
-* Description: Checks the status of SPI.
+* Description: Returns the status of the SPI driver.
 * Input: None
 * Output:
-*   - E_OK: If SPI is not busy.
-*   - E_NOT_OK: If SPI is busy.
+*   - SPI_UNINIT: If the driver is not initialized.
+*   - SPI_IDLE: If no sequence is pending and no unit has a job.
+*   - SPI_BUSY: If at least one sequence is pending or a unit still has a job.
 */
 
-Std_ReturnType Spi_GetStatus(void) {
-    // Check the status of SPI
-    if (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_BSY) == SET) {
-        return E_NOT_OK; // Return error code if SPI is busy
-    } else {
-        return E_OK; // Return success status if SPI is not busy
+Spi_StatusType Spi_GetStatus(void) {
+    return Spi_DriverStatus;
+}
+
+/*
+* Function: Spi_GetHWUnitStatus
+* Description: Returns the status of one SPI hardware unit.
+* Input:
+*   - HWUnit: Hardware unit to check.
+* Output:
+*   - SPI_UNINIT: If the driver is not initialized, the unit is invalid or not enabled.
+*   - SPI_IDLE: If the unit has no job in progress or queued.
+*   - SPI_BUSY: If the unit has a job in progress, queued or waiting in its interrupt ring.
+*/
+
+Spi_StatusType Spi_GetHWUnitStatus(Spi_HWUnitType HWUnit) {
+    if (Spi_DriverStatus == SPI_UNINIT || HWUnit >= NUM_OF_SPI_HW_UNITS || !Spi_HWUnitConfig[HWUnit].enabled) {
+        return SPI_UNINIT;
     }
+    if (Spi_HWUnitState[HWUnit].activeJob != SPI_JOB_NONE || Spi_HWUnitState[HWUnit].queueCount != 0 ||
+        Spi_IrqRing[HWUnit].head != Spi_IrqRing[HWUnit].tail) {
+        return SPI_BUSY;
+    }
+    return SPI_IDLE;
 }
 
 // Function to get version information
@@ -169,27 +1265,48 @@ void Spi_GetVersionInfo(Std_VersionInfoType* VersionInfo) {
 *   - Sequence: The sequence of data transmission and reception.
 * Output:
 *   - E_OK: If the transmission process is completed successfully.
-*   - E_NOT_OK: If the sequence is invalid.
+*   - E_NOT_OK: If the sequence is invalid, cannot be queued or fails.
 
 */
 Std_ReturnType Spi_SyncTransmit(const Spi_SequenceType Sequence) {
-    // Check the validity of the sequence
-    if (Sequence >= NUM_OF_SEQUENCES) {
+    // Queue the sequence like an asynchronous transmission
+    if (Spi_AsyncTransmit(Sequence) != E_OK) {
         return E_NOT_OK; // Return error code if the sequence is invalid
     }
 
-    // Perform data transmission and reception according to the sequence
-    // Wait until the process is completed
+    // Drive the scheduler until the sequence is completed
+    while (Spi_SequenceState[Sequence].result == SPI_SEQ_PENDING) {
+        Spi_MainFunction_Handling();
+
+        // With only interrupt-driven units left busy, sleep until the next interrupt
+        uint8_t polling = 0;
+        for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+            if (Spi_HWUnitMode[hw] == SPI_POLLING_MODE && Spi_GetHWUnitStatus((Spi_HWUnitType)hw) == SPI_BUSY) {
+                polling = 1;
+            }
+        }
+        if (!polling) {
+            SchM_StateType state;
+            SchM_Enter(state);
+            if (Spi_SequenceState[Sequence].result == SPI_SEQ_PENDING) {
+                SchM_WaitForInterrupt();
+            }
+            SchM_Exit(state);
+        }
+    }
 
     // Return the result
-    return E_OK;
+    return (Spi_SequenceState[Sequence].result == SPI_SEQ_OK) ? E_OK : E_NOT_OK;
 }
 
 
 
 /*
 * Function: Spi_Cancel
-* Description: Cancels data transmission or reception for the specified sequence.
+* Description: Cancels data transmission or reception for the specified sequence. Jobs that are
+*   still queued are dropped; a job already in progress or handed to the interrupt ring of its
+*   unit is completed, the driver staying SPI_BUSY until it ends. No sequence end notification is
+*   raised.
 * Input:
 *   - Sequence: The sequence of data transmission or reception to be cancelled.
 * Output:
@@ -198,18 +1315,39 @@ Std_ReturnType Spi_SyncTransmit(const Spi_SequenceType Sequence) {
 */
 
 Std_ReturnType Spi_Cancel(Spi_SequenceType Sequence) {
-    // Perform cancellation of data transmission or reception for the specified sequence
-    
     // Check the validity of the sequence
-    if (Sequence < NUM_OF_SPI_SEQUENCES) {
-        // Perform necessary actions to cancel data transmission or reception for the sequence
-        
-        // Return success status
-        return E_OK;
-    } else {
+    if (Spi_DriverStatus == SPI_UNINIT || Sequence >= SPI_MAX_SEQUENCE) {
         // Return error code if the sequence is invalid
         return E_NOT_OK;
     }
+
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    if (Spi_SequenceState[Sequence].result == SPI_SEQ_PENDING) {
+        // Remove the jobs of the sequence that have not been started
+        for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+            Spi_HWUnitStateType* unit = &Spi_HWUnitState[hw];
+            uint8_t kept = 0;
+            for (uint8_t i = 0; i < unit->queueCount; i++) {
+                Spi_JobType job = unit->queue[i];
+                if (Spi_JobSequence[job] == Sequence) {
+                    Spi_JobResult[job] = SPI_JOB_FAILED;
+                    Spi_SequenceState[Sequence].remainingJobs--;
+                } else {
+                    unit->queue[kept++] = job;
+                }
+            }
+            unit->queueCount = kept;
+        }
+        Spi_SequenceState[Sequence].result = SPI_SEQ_CANCELED;
+    }
+    SchM_Exit(state);
+
+    Spi_UpdateDriverStatus();
+
+    // Return success status
+    return E_OK;
 }
 
 
@@ -222,16 +1360,38 @@ Std_ReturnType Spi_Cancel(Spi_SequenceType Sequence) {
 *   - Mode: The asynchronous mode to be set (SPI_POLLING_MODE, SPI_INTERRUPT_MODE, or SPI_DMA_MODE).
 * Output:
 *   - E_OK: If the asynchronous mode is set successfully.
-*   - E_NOT_OK: If the hardware unit or mode is invalid.
+*   - E_NOT_OK: If the hardware unit or mode is invalid, the driver is not initialized, the unit is busy,
+*     or SPI_DMA_MODE is requested while another driver owns a DMA stream of the unit.
 */
 
 Std_ReturnType Spi_SetAsyncMode(Spi_HWUnitType HWUnit, Spi_AsyncModeType Mode) {
     // Set asynchronous mode of operation for the specified SPI hardware unit
-    
+
     // Check the validity of the SPI hardware unit and mode
     if (HWUnit < NUM_OF_SPI_HW_UNITS && (Mode == SPI_POLLING_MODE || Mode == SPI_INTERRUPT_MODE || Mode == SPI_DMA_MODE)) {
-        // Perform necessary actions to set asynchronous mode of operation for the SPI hardware unit
- 
+        // The mode can only change between two jobs of an initialized unit
+        if (Spi_GetHWUnitStatus(HWUnit) != SPI_IDLE) {
+            return E_NOT_OK;
+        }
+        // The streams of the unit may be shared with other drivers, SPI3's RX stream with LIN
+        if (Mode == SPI_DMA_MODE && Spi_HWUnitMode[HWUnit] != SPI_DMA_MODE &&
+            Dma_ClaimStreams(Spi_HWUnitHw[HWUnit].dma.rxStream, Spi_HWUnitHw[HWUnit].dma.txStream) != E_OK) {
+            return E_NOT_OK;
+        }
+        if (Spi_HWUnitMode[HWUnit] != Mode) {
+            if (Spi_HWUnitMode[HWUnit] == SPI_DMA_MODE) {
+                Spi_DmaCmd(HWUnit, DISABLE);
+            } else if (Spi_HWUnitMode[HWUnit] == SPI_INTERRUPT_MODE) {
+                Spi_IrqCmd(HWUnit, DISABLE);
+            }
+            if (Mode == SPI_DMA_MODE) {
+                Spi_DmaCmd(HWUnit, ENABLE);
+            } else if (Mode == SPI_INTERRUPT_MODE) {
+                Spi_IrqCmd(HWUnit, ENABLE);
+            }
+        }
+        Spi_HWUnitMode[HWUnit] = Mode;
+
         // Return success status
         return E_OK;
     } else {
@@ -242,17 +1402,102 @@ Std_ReturnType Spi_SetAsyncMode(Spi_HWUnitType HWUnit, Spi_AsyncModeType Mode) {
 
 /*
 * Function: Spi_GetJobResult
-* Description: Checks the state of the SPI to determine the result of the job.
+* Description: Returns the result of the last transmission of a job.
+* Input:
+*   - Job: Job to check.
+* Output:
+*   - SPI_JOB_OK, SPI_JOB_PENDING, SPI_JOB_QUEUED or SPI_JOB_FAILED.
+*   - SPI_JOB_FAILED: If the job is invalid.
+*/
+Spi_JobResultType Spi_GetJobResult(Spi_JobType Job) {
+    if (Job >= SPI_MAX_JOB) {
+        return SPI_JOB_FAILED;
+    }
+    return Spi_JobResult[Job];
+}
+
+/*
+* Function: Spi_GetSequenceResult
+* Description: Returns the result of the last transmission of a sequence.
+* Input:
+*   - Sequence: Sequence to check.
+* Output:
+*   - SPI_SEQ_OK, SPI_SEQ_PENDING, SPI_SEQ_FAILED or SPI_SEQ_CANCELED.
+*   - SPI_SEQ_FAILED: If the sequence is invalid.
+*/
+Spi_SeqResultType Spi_GetSequenceResult(Spi_SequenceType Sequence) {
+    if (Sequence >= SPI_MAX_SEQUENCE) {
+        return SPI_SEQ_FAILED;
+    }
+    return Spi_SequenceState[Sequence].result;
+}
+
+/*
+* Function: Spi_MainFunction_Handling
+* Description: Scheduler of the SPI driver. Advances the jobs of every hardware unit in polling
+*   mode without busy waiting and refills the rings of the units in interrupt mode; to be called
+*   cyclically (or in the idle loop) while sequences are pending. Units in DMA mode progress from
+*   their interrupts.
 * Input: None
+* Output: None
+*/
+void Spi_MainFunction_Handling(void) {
+    if (Spi_DriverStatus != SPI_BUSY) {
+        return;
+    }
+    for (uint8_t hw = 0; hw < NUM_OF_SPI_HW_UNITS; hw++) {
+        if (Spi_HWUnitMode[hw] == SPI_POLLING_MODE) {
+            Spi_ProcessHWUnit((Spi_HWUnitType)hw);
+        } else if (Spi_HWUnitMode[hw] == SPI_INTERRUPT_MODE) {
+            Spi_IrqFillRing((Spi_HWUnitType)hw);
+        }
+    }
+    Spi_UpdateDriverStatus();
+}
+
+/*
+* Function: Spi_GetHWUnitStats
+* Description: Copies the counters of a hardware unit. Latency runs from Spi_AsyncTransmit to the
+*   release of the device; busy time runs from selection to release of the device.
+* Input:
+*   - HWUnit: Hardware unit to read.
+*   - StatsPtr: Pointer to the structure receiving the counters.
 * Output:
-*   - E_OK: If the SPI job is completed successfully.
-*   - E_NOT_OK: If the SPI job is still ongoing.
+*   - E_OK: If the counters have been copied.
+*   - E_NOT_OK: If the driver is not initialized, the unit is invalid or the pointer is NULL.
 */
-Std_ReturnType Spi_GetJobResult(void) {
-    // Check the state of the SPI to determine the result
-    if (SPI_I2S_GetFlagStatus(SPI1, SPI_I2S_FLAG_BSY) == RESET) {
-        return E_OK;  
-    } else {
-        return E_NOT_OK;  
+Std_ReturnType Spi_GetHWUnitStats(Spi_HWUnitType HWUnit, Spi_HWUnitStatsType* StatsPtr) {
+    if (Spi_DriverStatus == SPI_UNINIT || HWUnit >= NUM_OF_SPI_HW_UNITS || StatsPtr == NULL) {
+        return E_NOT_OK;
     }
+
+    SchM_StateType state;
+
+    SchM_Enter(state);
+    *StatsPtr = Spi_HWUnitStats[HWUnit];
+    SchM_Exit(state);
+    return E_OK;
+}
+
+/*
+* Function: Spi_ResetHWUnitStats
+* Description: Clears the counters of a hardware unit.
+* Input:
+*   - HWUnit: Hardware unit to clear.
+* Output:
+*   - E_OK: If the counters have been cleared.
+*   - E_NOT_OK: If the unit is invalid.
+*/
+Std_ReturnType Spi_ResetHWUnitStats(Spi_HWUnitType HWUnit) {
+    if (HWUnit >= NUM_OF_SPI_HW_UNITS) {
+        return E_NOT_OK;
+    }
+
+    SchM_StateType state;
+    const Spi_HWUnitStatsType cleared = { 0 };
+
+    SchM_Enter(state);
+    Spi_HWUnitStats[HWUnit] = cleared;
+    SchM_Exit(state);
+    return E_OK;
 }
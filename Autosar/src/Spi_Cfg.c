@@ -0,0 +1,81 @@
+/*
+* File: Spi_Cfg.c
+* Author: Tran Nhat Thai
+* Date: 29/02/2024
+* Description: Channel, job and sequence configuration of the SPI driver.
+*/
+
+#include "Spi.h"
+#include "Dio_Cfg.h"
+
+/* Bus settings of each hardware unit. SPI1 serves the accelerometer and the EEPROM, SPI2 the
+   gyroscope (mode 3) and the logger fed by the PduR gateway, one DMA transfer per buffer of records,
+   SPI3 the barometer and the external ADC. */
+const Spi_HWUnitConfigType Spi_HWUnitConfig[NUM_OF_SPI_HW_UNITS] = {
+    /* enabled, { direction, mode, dataSize, CPOL, CPHA, nss, prescaler, firstBit, crc }, asyncMode */
+    { 1, { SPI_Direction_2Lines_FullDuplex, SPI_Mode_Master, SPI_DataSize_8b, SPI_CPOL_Low, SPI_CPHA_1Edge,
+           SPI_NSS_Soft, SPI_BaudRatePrescaler_16, SPI_FirstBit_MSB, 7 }, SPI_POLLING_MODE },   /* SPI_HWUnit_0 */
+    { 1, { SPI_Direction_2Lines_FullDuplex, SPI_Mode_Master, SPI_DataSize_8b, SPI_CPOL_High, SPI_CPHA_2Edge,
+           SPI_NSS_Soft, SPI_BaudRatePrescaler_8, SPI_FirstBit_MSB, 7 }, SPI_DMA_MODE },        /* SPI_HWUnit_1 */
+    { 1, { SPI_Direction_2Lines_FullDuplex, SPI_Mode_Master, SPI_DataSize_8b, SPI_CPOL_Low, SPI_CPHA_1Edge,
+           SPI_NSS_Soft, SPI_BaudRatePrescaler_4, SPI_FirstBit_MSB, 7 }, SPI_POLLING_MODE },    /* SPI_HWUnit_2 */
+};
+
+/* Internal buffers of the IB channels */
+static Spi_DataBufferType Spi_AccelCmdTx[1] = { 0xE8 };    /* Read, auto-increment, OUT_X_L */
+static Spi_DataBufferType Spi_AccelCmdRx[1];
+static Spi_DataBufferType Spi_AccelDataRx[6];
+static Spi_DataBufferType Spi_GyroCmdTx[1] = { 0xA8 };     /* Read, OUT_X_L */
+static Spi_DataBufferType Spi_GyroCmdRx[1];
+static Spi_DataBufferType Spi_GyroDataRx[6];
+static Spi_DataBufferType Spi_BaroCmdTx[1] = { 0x00 };     /* ADC read */
+static Spi_DataBufferType Spi_BaroCmdRx[1];
+static Spi_DataBufferType Spi_BaroDataRx[3];
+static Spi_DataBufferType Spi_EepromStatusTx[2] = { 0x05, 0x00 };   /* RDSR */
+static Spi_DataBufferType Spi_EepromStatusRx[2];
+
+const Spi_ChannelConfigType Spi_ChannelConfig[SPI_MAX_CHANNEL] = {
+    /* bufferType, dataSize, length (maximum for EB), defaultData, txBuffer, rxBuffer */
+    { SPI_IB, SPI_DataSize_8b,  1, 0x00, Spi_AccelCmdTx,     Spi_AccelCmdRx },     /* SPI_CHANNEL_ACCEL_CMD */
+    { SPI_IB, SPI_DataSize_8b,  6, 0x00, NULL,               Spi_AccelDataRx },    /* SPI_CHANNEL_ACCEL_DATA */
+    { SPI_IB, SPI_DataSize_8b,  1, 0x00, Spi_GyroCmdTx,      Spi_GyroCmdRx },      /* SPI_CHANNEL_GYRO_CMD */
+    { SPI_IB, SPI_DataSize_8b,  6, 0x00, NULL,               Spi_GyroDataRx },     /* SPI_CHANNEL_GYRO_DATA */
+    { SPI_IB, SPI_DataSize_8b,  1, 0x00, Spi_BaroCmdTx,      Spi_BaroCmdRx },      /* SPI_CHANNEL_BARO_CMD */
+    { SPI_IB, SPI_DataSize_8b,  3, 0x00, NULL,               Spi_BaroDataRx },     /* SPI_CHANNEL_BARO_DATA */
+    { SPI_IB, SPI_DataSize_8b,  2, 0x00, Spi_EepromStatusTx, Spi_EepromStatusRx }, /* SPI_CHANNEL_EEPROM_STATUS */
+    { SPI_EB, SPI_DataSize_16b, SPI_EXT_ADC_MAX_LENGTH, 0x0000, NULL, NULL },      /* SPI_CHANNEL_EXT_ADC */
+    { SPI_EB, SPI_DataSize_8b,  SPI_GATEWAY_MAX_LENGTH, 0x00, NULL, NULL },        /* SPI_CHANNEL_GATEWAY */
+};
+
+static const Spi_ChannelType Spi_AccelReadChannels[] = { SPI_CHANNEL_ACCEL_CMD, SPI_CHANNEL_ACCEL_DATA };
+static const Spi_ChannelType Spi_GyroReadChannels[] = { SPI_CHANNEL_GYRO_CMD, SPI_CHANNEL_GYRO_DATA };
+static const Spi_ChannelType Spi_BaroReadChannels[] = { SPI_CHANNEL_BARO_CMD, SPI_CHANNEL_BARO_DATA };
+static const Spi_ChannelType Spi_EepromStatusChannels[] = { SPI_CHANNEL_EEPROM_STATUS };
+static const Spi_ChannelType Spi_ExtAdcChannels[] = { SPI_CHANNEL_EXT_ADC };
+static const Spi_ChannelType Spi_GatewayChannels[] = { SPI_CHANNEL_GATEWAY };
+
+/* Chip selects are Dio channels, see Dio_Cfg.h */
+const Spi_JobConfigType Spi_JobConfig[SPI_MAX_JOB] = {
+    /* hwUnit, priority, csChannel, csActiveLevel, channelList, numChannels, endNotification */
+    { SPI_HWUnit_0, 2, DIO_CHANNEL_CS_ACCEL,   0, Spi_AccelReadChannels,    2, NULL },   /* SPI_JOB_ACCEL_READ */
+    { SPI_HWUnit_1, 2, DIO_CHANNEL_CS_GYRO,    0, Spi_GyroReadChannels,     2, NULL },   /* SPI_JOB_GYRO_READ */
+    { SPI_HWUnit_2, 1, DIO_CHANNEL_CS_BARO,    0, Spi_BaroReadChannels,     2, NULL },   /* SPI_JOB_BARO_READ */
+    { SPI_HWUnit_0, 0, DIO_CHANNEL_CS_EEPROM,  0, Spi_EepromStatusChannels, 1, NULL },   /* SPI_JOB_EEPROM_STATUS */
+    { SPI_HWUnit_2, 0, DIO_CHANNEL_CS_EXT_ADC, 0, Spi_ExtAdcChannels,       1, NULL },   /* SPI_JOB_EXT_ADC_READ */
+    { SPI_HWUnit_1, 1, DIO_CHANNEL_CS_GATEWAY, 0, Spi_GatewayChannels,      1, NULL },   /* SPI_JOB_GATEWAY_WRITE */
+};
+
+static const Spi_JobType Spi_ImuJobs[] = { SPI_JOB_ACCEL_READ, SPI_JOB_GYRO_READ };
+static const Spi_JobType Spi_BaroJobs[] = { SPI_JOB_BARO_READ };
+static const Spi_JobType Spi_EepromJobs[] = { SPI_JOB_EEPROM_STATUS };
+static const Spi_JobType Spi_ExtAdcJobs[] = { SPI_JOB_EXT_ADC_READ };
+static const Spi_JobType Spi_GatewayJobs[] = { SPI_JOB_GATEWAY_WRITE };
+
+const Spi_SequenceConfigType Spi_SequenceConfig[SPI_MAX_SEQUENCE] = {
+    /* jobList, numJobs, endNotification */
+    { Spi_ImuJobs,    2, NULL },    /* SPI_SEQ_IMU */
+    { Spi_BaroJobs,   1, NULL },    /* SPI_SEQ_BARO */
+    { Spi_EepromJobs, 1, NULL },    /* SPI_SEQ_EEPROM */
+    { Spi_ExtAdcJobs, 1, NULL },    /* SPI_SEQ_EXT_ADC */
+    { Spi_GatewayJobs, 1, PduR_SpiGatewayNotification },   /* SPI_SEQ_GATEWAY */
+};
@@ -5,14 +5,117 @@
 * Description: Main program file for testing SPI and DIO functionality.
 */
 
-#include "DIO.h"
+#include "Dio.h"
 #include "stm32f4xx.h"
 #include "stm32f4xx_gpio.h"
-#include "spi.h"
-#include "stdio.h"
+#include "Spi.h"
+#include "Log.h"
+#include "Can.h"
+#include "Com.h"
+#include "PduR.h"
+#include "CanTp.h"
+#include "Dcm.h"
+#include "Adc.h"
+#include "Gpt.h"
+#include "Pwm.h"
+#include "Icu.h"
+#include "NvM.h"
+#include "Lin.h"
+#include "SchM.h"
 
+// Result buffers of the ADC groups, see Adc_Cfg.h
+static Adc_ValueGroupType sensorsBuffer[ADC_SENSORS_SAMPLES * 3];
+static uint32_t captureWords[ADC_CAPTURE_SAMPLES / 2];    // Word aligned for the 32-bit DMA of CDR
+#define captureBuffer ((Adc_ValueGroupType*)captureWords)
 
- 
+// Logs the range of one half of the capture buffer while the DMA fills the other one
+static void AdcCapture_Process(uint32_t Half) {
+    const Adc_ValueGroupType* samples = captureBuffer + Half * (ADC_CAPTURE_SAMPLES / 2);
+    uint16_t min = 0xFFFF, max = 0;
+
+    for (int i = 0; i < ADC_CAPTURE_SAMPLES / 2; i++) {
+        if (samples[i] < min) min = samples[i];
+        if (samples[i] > max) max = samples[i];
+    }
+    LOG3(LOG_ID_ADC_CAPTURE, Half, min, max);
+}
+
+void AdcCapture_HalfNotification(void) {
+    AdcCapture_Process(0);
+}
+
+void AdcCapture_FullNotification(void) {
+    AdcCapture_Process(1);
+}
+
+// Breathing of the dimmer LED, one row per PWM period, played by DMA
+#define DIMMER_ROWS 1000
+static Pwm_CompareType dimmerWave[DIMMER_ROWS];
+
+// Duty cycles of one phase over an electrical turn, the phases 4 steps apart
+static const uint16_t phaseSteps[12] = {
+    0x4000, 0x6000, 0x776D, 0x8000, 0x776D, 0x6000, 0x4000, 0x2000, 0x0893, 0x0000, 0x0893, 0x2000
+};
+
+// Encoder edges stored by DMA, the notification averages each half while the other one fills
+#define ENCODER_STAMPS 64
+static Icu_ValueType encoderStamps[ENCODER_STAMPS];
+static uint8_t encoderHalf;
+static volatile Icu_ValueType encoderTicks;     // Mean TIM5 ticks between two rising edges
+
+void IcuEncoder_Notification(void) {
+    const Icu_ValueType* stamps = encoderStamps + encoderHalf * (ENCODER_STAMPS / 2);
+    encoderTicks = (stamps[ENCODER_STAMPS / 2 - 1] - stamps[0]) / (ENCODER_STAMPS / 2 - 1);
+    encoderHalf ^= 1;
+}
+
+// End of the jobs queued on the data sectors of the flash
+void FlsJob_EndNotification(uint8_t User) {
+    LOG2(LOG_ID_FLS_JOB_END, User, Fls_GetJobResult(User));
+}
+
+void FlsJob_ErrorNotification(uint8_t User) {
+    LOG2(LOG_ID_FLS_JOB_FAILED, User, Fls_GetJobResult(User));
+}
+
+void FeeJob_EndNotification(void) {
+}
+
+void FeeJob_ErrorNotification(void) {
+    LOG1(LOG_ID_FEE_JOB_FAILED, Fee_GetJobResult());
+}
+
+// RAM blocks of NvM_BlockDescriptor, read at startup
+uint32_t App_BootCount;                 // Resets counted since the first one
+uint8_t App_Calibration[64];
+uint8_t App_Dtc[128];                   // Byte 0: failed SPI sequences, saturated
+
+void NvMJob_MultiBlockNotification(void) {
+}
+
+// Set by GPT_CHANNEL_MAIN_CYCLE and GPT_CHANNEL_COM_CYCLE, the main loop sleeps until one is
+static volatile uint8_t mainCycleDue;
+static volatile uint8_t comCycleDue;
+
+void Gpt_Notification_Led(void) {
+    Dio_FlipChannelInline(DIO_CHANNEL_LED_A);  // PA0
+    Dio_FlipChannelInline(DIO_CHANNEL_LED_B);  // PB0
+}
+
+void Gpt_Notification_MainCycle(void) {
+    mainCycleDue = 1;
+}
+
+void Gpt_Notification_ComCycle(void) {
+    comCycleDue = 1;
+}
+
+// Channels of the GPT driver with the notifications above
+static const Gpt_ChannelConfigType App_GptChannels[GPT_MAX_CHANNEL] = {
+    { GPT_CH_MODE_CONTINUOUS, Gpt_Notification_Led },           /* GPT_CHANNEL_LED */
+    { GPT_CH_MODE_CONTINUOUS, Gpt_Notification_MainCycle },     /* GPT_CHANNEL_MAIN_CYCLE */
+    { GPT_CH_MODE_CONTINUOUS, Gpt_Notification_ComCycle },      /* GPT_CHANNEL_COM_CYCLE */
+};
 
 int main(void)
 {
@@ -21,58 +124,221 @@ int main(void)
     /* Configure PA0 and PB0 as output pins */
     GPIOA->MODER |= GPIO_MODER_MODE0_0;   
     GPIOB->MODER |= GPIO_MODER_MODE0_0; 
+    /* PA2 as USART2 TX (AF7) for the log output */
+    GPIOA->MODER |= GPIO_MODER_MODER2_1;
+    GPIOA->AFR[0] |= (GPIO_AF_USART2 << (2 * 4));
+    /* PD0/PD1 as CAN1 RX/TX and PB5/PB6 as CAN2 RX/TX (AF9); PB12 stays the gyro CS, PB13 SPI2 SCK */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIODEN;
+    GPIOD->MODER |= GPIO_MODER_MODER0_1 | GPIO_MODER_MODER1_1;
+    GPIOD->AFR[0] |= (GPIO_AF_CAN1 << (0 * 4)) | (GPIO_AF_CAN1 << (1 * 4));
+    GPIOB->MODER |= GPIO_MODER_MODER5_1 | GPIO_MODER_MODER6_1;
+    GPIOB->AFR[0] |= (GPIO_AF_CAN2 << (5 * 4)) | (GPIO_AF_CAN2 << (6 * 4));
+    /* PA1 and PC0..PC3 as analog inputs of the ADC groups */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN;
+    GPIOA->MODER |= GPIO_MODER_MODER1;
+    GPIOC->MODER |= GPIO_MODER_MODER0 | GPIO_MODER_MODER1 | GPIO_MODER_MODER2 | GPIO_MODER_MODER3;
+    /* PE9/PE11/PE13 as TIM1 CH1..CH3 (AF1) for the motor bridge, PC6 as TIM3 CH1 (AF2) for the dimmer */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOEEN;
+    GPIOE->MODER |= GPIO_MODER_MODER9_1 | GPIO_MODER_MODER11_1 | GPIO_MODER_MODER13_1;
+    GPIOE->AFR[1] |= (GPIO_AF_TIM1 << ((9 - 8) * 4)) | (GPIO_AF_TIM1 << ((11 - 8) * 4)) | (GPIO_AF_TIM1 << ((13 - 8) * 4));
+    GPIOC->MODER |= GPIO_MODER_MODER6_1;
+    GPIOC->AFR[0] |= (GPIO_AF_TIM3 << (6 * 4));
+    /* PA3 as TIM5 CH4 (AF2) for the encoder, the only TIM5 CH4 pin of the VE (the EEPROM CS is on PC4),
+       PC7 as TIM8 CH2 (AF3) for the PWM input */
+    GPIOA->MODER |= GPIO_MODER_MODER3_1;
+    GPIOA->AFR[0] |= (GPIO_AF_TIM5 << (3 * 4));
+    GPIOC->MODER |= GPIO_MODER_MODER7_1;
+    GPIOC->AFR[0] |= (GPIO_AF_TIM8 << (7 * 4));
+    /* PC12/PD2 as UART5 TX/RX (AF8) for the LIN bus */
+    GPIOC->MODER |= GPIO_MODER_MODER12_1;
+    GPIOC->AFR[1] |= (GPIO_AF_UART5 << ((12 - 8) * 4));
+    GPIOD->MODER |= GPIO_MODER_MODER2_1;
+    GPIOD->AFR[0] |= (GPIO_AF_UART5 << (2 * 4));
+
+    /* Binary log drained to USART2 by DMA, decoded on the host by Test/Log_Decode.c */
+    Log_Init();
+    LOG1(LOG_ID_BOOT, SystemCoreClock);
   
-    // Initialize SPI configuration and other necessary variables
-    Spi_ConfigType spiConfig;
-		Std_ReturnType initStatus = Spi_Init(&spiConfig);
-    // Configure spiConfig appropriately
+    // Initialize SPI1..SPI3 with the per-unit settings of Spi_Cfg.c
+		Std_ReturnType initStatus = Spi_Init(NULL);
+    LOG1(LOG_ID_SPI_INIT, initStatus);
     
-    // Prepare data for transmission
-    uint8_t txData[] = {0x01, 0x02, 0x03};
-    uint8_t rxData[sizeof(txData)]; // Buffer to receive data
+    // Prepare data for transmission, the external ADC channel uses 16-bit frames
+    uint16_t txData[] = {0x0100, 0x0200, 0x0300};
+    uint16_t rxData[3]; // Buffer to receive data
+
+    // Bind the buffers to the EB channel once, every transmission then uses them in place
+    Spi_SetupEB(SPI_CHANNEL_EXT_ADC, (const Spi_DataBufferType*)txData, (Spi_DataBufferType*)rxData, 3);
+
+    // Initialize CAN1 and CAN2 with the settings of Can_Cfg.c and put them on the bus
+    Can_Init(NULL);
+    LOG2(LOG_ID_CAN_START, CAN_CONTROLLER_1, Can_SetControllerMode(CAN_CONTROLLER_1, CAN_T_START));
+    LOG2(LOG_ID_CAN_START, CAN_CONTROLLER_2, Can_SetControllerMode(CAN_CONTROLLER_2, CAN_T_START));
+    // Signals of the frames received and sent on both buses; the samples of the external ADC go
+    // out on CAN1 whenever a transfer changed them
+    Com_Init();
+    // Received frames are routed to COM and to the gateway destinations of PduR_Cfg.h
+    PduR_Init();
+    uint8_t ecuState = 1;
+    uint8_t ecuAlive = 0;
+
+    // The sensors are scanned by ADC1 into a circular buffer, read each cycle without waiting.
+    // ADC_GROUP_CAPTURE uses ADC1 too and is started instead when a waveform is needed.
+    Adc_Init(NULL);
+    Adc_SetupResultBuffer(ADC_GROUP_SENSORS, sensorsBuffer);
+    Adc_SetupResultBuffer(ADC_GROUP_CAPTURE, captureBuffer);
+    Adc_EnableGroupNotification(ADC_GROUP_CAPTURE);
+    Adc_StartGroupConversion(ADC_GROUP_SENSORS);
+
+    // The bridge starts with the phases off; the dimmer breathes from a table without the CPU
+    Pwm_Init(NULL);
+    for (int i = 0; i < DIMMER_ROWS; i++) {
+        uint32_t level = (i < DIMMER_ROWS / 2) ? i : DIMMER_ROWS - i;
+        dimmerWave[i] = Pwm_DutyToCompare(PWM_HWUnit_1, (uint16_t)(level * level * (PWM_DUTY_100 / 500) / 500));
+    }
+    Pwm_StartWaveform(PWM_HWUnit_1, dimmerWave, DIMMER_ROWS);
+    static const Pwm_ChannelType phases[3] = { PWM_CHANNEL_PHASE_U, PWM_CHANNEL_PHASE_V, PWM_CHANNEL_PHASE_W };
+    uint8_t phaseStep = 0;
+
+    // Encoder edges are timestamped by DMA and the PWM input is measured without interrupts
+    Icu_Init(NULL);
+    Icu_EnableNotification(ICU_CHANNEL_ENCODER);
+    Icu_StartTimestamp(ICU_CHANNEL_ENCODER, encoderStamps, ENCODER_STAMPS, ENCODER_STAMPS / 2);
+    Icu_StartSignalMeasurement(ICU_CHANNEL_PWM_IN);
+
+    // Erase and program jobs on sectors 5..7 run in the background of the main loop
+    Fls_Init(NULL);
+
+    // Blocks kept in the emulated EEPROM on these sectors, read before the main loop
+    Fee_Init(NULL);
+    NvM_Init(NULL);
+    NvM_ReadAll();
+    NvM_RequestResultType readAll;
+    do {
+        Fls_MainFunction();
+        Fee_MainFunction();
+        NvM_MainFunction();
+        NvM_GetErrorStatus(0, &readAll);
+    } while (readAll == NVM_REQ_PENDING);
+    NvM_RequestResultType bootResult;
+    NvM_GetErrorStatus(NVM_BLOCK_BOOT_COUNT, &bootResult);
+    App_BootCount = (bootResult == NVM_REQ_OK) ? App_BootCount + 1u : 1u;
+    LOG1(LOG_ID_NVM_BOOT_COUNT, App_BootCount);
+    NvM_WriteBlock(NVM_BLOCK_BOOT_COUNT, NULL);
+    Com_SendSignal(COM_SIG_ECU_BOOT_COUNT, &App_BootCount);
+
+    // The LEDs blink and the main loop runs from the timer wheel instead of delay loops
+    Gpt_Init(App_GptChannels);
+    // Diagnostic messages of the tester, segmented on CAN1; its timeouts and STmin use the timer wheel.
+    // Their services read and write the calibration and download images into sector 5.
+    CanTp_Init(&Dcm_CanTpConfig);
+    Dcm_Init(NULL);
+    // The door and seat nodes are polled by the schedule table on the LIN bus, slot by slot from TIM4.
+    // Its reception shares DMA1 stream 0 with SPI3, which stays out of SPI_DMA_MODE.
+    Std_ReturnType linStatus = Lin_Init(NULL);
+    LOG1(LOG_ID_LIN_INIT, linStatus);
+    Lin_StartSchedule(LIN_CHANNEL_0, LIN_SCHEDULE_NORMAL);
+    Gpt_EnableNotification(GPT_CHANNEL_LED);
+    Gpt_EnableNotification(GPT_CHANNEL_MAIN_CYCLE);
+    Gpt_EnableNotification(GPT_CHANNEL_COM_CYCLE);
+    Gpt_StartTimer(GPT_CHANNEL_LED, GPT_MS(500));
+    Gpt_StartTimer(GPT_CHANNEL_MAIN_CYCLE, GPT_MS(100));
+    Gpt_StartTimer(GPT_CHANNEL_COM_CYCLE, GPT_MS(GPT_COM_CYCLE_MS));
    
     // Main loop for continuous data transmission
     
     
     while(1)
     {
-				/* CODE DIO*/
-        /* Turn on LEDs on both ports */
-        GPIOA->BSRR |= GPIO_BSRR_BS_0;  // Turn on LED on port A (PA0)
-        GPIOB->BSRR |= GPIO_BSRR_BS_0;  // Turn on LED on port B (PB0)
-        /* Delay to keep the LEDs on for a period of time */
-        for(int i = 0; i < 1000000; i++);  // Delay
-        /* Turn off LEDs on both ports */
-        GPIOA->BSRR |= GPIO_BSRR_BR_0;  // Turn off LED on port A (PA0)
-        GPIOB->BSRR |= GPIO_BSRR_BR_0;  // Turn off LED on port B (PB0)
-        /* Delay to keep the LEDs off for a period of time */
-        for(int i = 0; i < 1000000; i++);  // Delay
-			
-			
+        // Sleep until the next cycle; interrupts are served meanwhile
+        SchM_StateType state;
+        SchM_Enter(state);
+        while (!mainCycleDue && !comCycleDue) {
+            SchM_WaitForInterrupt();
+            SchM_Exit(state);
+            SchM_Enter(state);
+        }
+        uint8_t mainCycle = mainCycleDue;
+        mainCycleDue = 0;
+        comCycleDue = 0;
+        SchM_Exit(state);
+
+        // Every GPT_COM_CYCLE_MS: confirmations, received frames and bus-off of the CAN
+        // controllers, before the receive queues can overflow. The frames go through PduR to COM,
+        // the gateways and CanTp, whose flow control answers a block within one cycle. Then the
+        // copies and compares of the flash jobs, the emulated EEPROM, the blocks kept in it and
+        // the download waiting for its jobs.
+        Can_MainFunction_Write();
+        Can_MainFunction_Read();
+        Can_MainFunction_BusOff();
+        Fls_MainFunction();
+        Fee_MainFunction();
+        NvM_MainFunction();
+        Dcm_MainFunction();
+        if (!mainCycle) {
+            continue;
+        }
 			
 				/* CODE SPI*/
 				// Perform data transmission and reception
-        Std_ReturnType txStatus = Spi_SetupEB(&spiConfig, txData, rxData, sizeof(txData));
+        Std_ReturnType txStatus = Spi_SyncTransmit(SPI_SEQ_EXT_ADC);
         if (txStatus != E_OK) {
             // Handle error if transmission fails
-            printf("Error: Data transmission failed! Error code: %d\n", txStatus);
-            // You can add additional error handling code here if needed
+            LOG2(LOG_ID_SPI_TX_FAILED, SPI_SEQ_EXT_ADC, txStatus);
+            // Merged by the write delay of the block in NvM_Cfg.c: one write per 5 s at most
+            if (App_Dtc[0] != 0xFF) {
+                App_Dtc[0]++;
+                NvM_WriteBlock(NVM_BLOCK_DTC, NULL);
+            }
         } else {
-            // Wait for transmission and reception to complete
-            while (Spi_GetJobResult() != E_OK) {
-                // Wait or perform other tasks while waiting
+            // The sequence has completed: process the received data
+            LOG2(LOG_ID_SPI_RX_BLOCK, SPI_SEQ_EXT_ADC, 3);
+            for (int i = 0; i < 3; ++i) {
+                LOG2(LOG_ID_SPI_RX_FRAME, i, rxData[i]);
             }
 
-            // Process the received data if needed
-            printf("Received data: ");
-            for (int i = 0; i < sizeof(rxData); ++i) {
-                printf("%02X ", rxData[i]);
-            }
-            printf("\n");
+            Com_SendSignal(COM_SIG_EXT_ADC_0, &rxData[0]);
+            Com_SendSignal(COM_SIG_EXT_ADC_1, &rxData[1]);
+            Com_SendSignal(COM_SIG_EXT_ADC_2, &rxData[2]);
         }
 
-        // Add delay or perform other operations before transmitting next data
-        for(int i = 0; i < 1000000; i++);  // Delay
+        // Latest round of the sensors
+        Adc_ValueGroupType sensors[3];
+        if (Adc_ReadGroup(ADC_GROUP_SENSORS, sensors) == E_OK) {
+            LOG3(LOG_ID_ADC_SENSORS, sensors[0], sensors[1], sensors[2]);
+            Com_SendSignal(COM_SIG_ECU_VOLTAGE, &sensors[0]);
+        }
+
+        // Encoder speed and the last complete period of the PWM input
+        Icu_DutyCycleType pwmIn;
+        Icu_GetDutyCycleValues(ICU_CHANNEL_PWM_IN, &pwmIn);
+        LOG1(LOG_ID_ICU_ENCODER, encoderTicks);
+        LOG2(LOG_ID_ICU_PWM_IN, pwmIn.PeriodTime, pwmIn.ActiveTime);
+
+        // Next step of the three phases, changed together at the start of one PWM period
+        uint16_t duties[3] = { phaseSteps[phaseStep], phaseSteps[(phaseStep + 4) % 12], phaseSteps[(phaseStep + 8) % 12] };
+        Pwm_SetDutyCycles(phases, duties, 3);
+        phaseStep = (phaseStep + 1) % 12;
+
+        // Door command of the next LIN slot, built from the state of the ECU
+        uint8_t doorCommand[4] = { ecuState, ecuAlive, 0, 0 };
+        Lin_WriteFrame(LIN_FRAME_DOOR_COMMAND, doorCommand);
+
+        // Status of the ECU, then the frames due and those changed this cycle
+        ecuAlive = (ecuAlive + 1) & 0x0F;
+        Com_SendSignal(COM_SIG_ECU_STATE, &ecuState);
+        Com_SendSignal(COM_SIG_ECU_ALIVE, &ecuAlive);
+        Com_MainFunctionTx();
+
+        // Signals received meanwhile
+        uint16_t engineSpeed;
+        uint8_t gear;
+        Com_ReceiveSignal(COM_SIG_ENGINE_SPEED, &engineSpeed);
+        Com_ReceiveSignal(COM_SIG_GEAR_POSITION, &gear);
+        LOG2(LOG_ID_COM_ENGINE, engineSpeed, gear);
+
+        // Send the records of this cycle in the background
+        Log_MainFunction();
     }
 			
 			